@@ -147,3 +147,10 @@ Declare Function MIDIClock_PutSMPTEMTC Lib "MIDIClock.dll" _
 Declare Function MIDIClock_PutMIDIMessage Lib "MIDIClock.dll" _
         (ByVal pMIDIClock As Long, ByRef pMIDIMessage As Byte, ByVal lLen As Long) As Long
 
+' P錻ݎ[}CNb]擾(20261019ǉ)
+' (Currency^Ŏ󂯎ƁAl͌ݎ[}CNb]1/10000ƂȂ)
+Declare Function MIDIClock_GetMonotonicMicrosec Lib "MIDIClock.dll" () As Currency
+
+' w莞[}CNb]ɂeBbN[tick]𐄒肷(20261019ǉ)
+' (llMicrosecMIDIClock_GetMonotonicMicrosec̖߂lƓCurrency^œn)
+Declare Function MIDIClock_GetTickCountAt Lib "MIDIClock.dll" (ByVal pMIDIClock As Long, ByVal llMicrosec As Currency) As Long
@@ -28,10 +28,12 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <windows.h>
 #include <crtdbg.h>
 #include <mmsystem.h>
 #include "MIDIClock.h"
+#include "MIDIClockTime.h" /* 20261019ǉ */
 
 /* ėp}N(ŏAőAݍ) */
 #ifndef MIN
@@ -150,6 +152,8 @@ static void CALLBACK TimeProc (UINT uID, UINT uMsg, DWORD_PTR dwUser, DWORD_PTR
 			break;
 		}
 		pMIDIClock->m_lTickCount = CLIP (0, pMIDIClock->m_lTickCount, 0x7FFFFFFF);		
+		/* XV̋L^(20261019ǉ) */
+		pMIDIClock->m_llUpdateMicrosec = MIDIClock_GetMonotonicMicrosec ();
 	}
 
 	/* MIDI͓[hMIDI^C~ONbNɂX[ȕꍇ */
@@ -331,6 +335,7 @@ long __stdcall MIDIClock_Start (MIDIClock* pMIDIClock) {
 	}
 
 	/* Ԃɐݒ */
+	pMIDIClock->m_llUpdateMicrosec = MIDIClock_GetMonotonicMicrosec (); /* 20261019ǉ */
 	pMIDIClock->m_lRunning = 1;
 
 	/* bN */
@@ -385,6 +390,7 @@ long __stdcall MIDIClock_Reset (MIDIClock* pMIDIClock) {
 	pMIDIClock->m_lTickCount = 0;
 	pMIDIClock->m_lTickCountMod = 0;
 	pMIDIClock->m_lOldTickCount = 0;
+	pMIDIClock->m_llUpdateMicrosec = MIDIClock_GetMonotonicMicrosec (); /* 20261019ǉ */
 	memset (pMIDIClock->m_bySMPTE, 0, sizeof (pMIDIClock->m_bySMPTE));
 
 	/* bN */
@@ -427,6 +433,7 @@ long __stdcall MIDIClock_SetMillisec (MIDIClock* pMIDIClock, long lMillisec) {
 	pMIDIClock->m_lDummyMillisec = lMillisec;
 	pMIDIClock->m_lOldDummyMillisec = lMillisec;
 	pMIDIClock->m_lDummyMillisecMod = 0;
+	pMIDIClock->m_llUpdateMicrosec = MIDIClock_GetMonotonicMicrosec (); /* 20261019ǉ */
 
 	/* bN */
 	pMIDIClock->m_lLocked = 0;
@@ -456,6 +463,7 @@ long __stdcall MIDIClock_SetTickCount (MIDIClock* pMIDIClock, long lTickCount) {
 	pMIDIClock->m_lTickCount = lTickCount;
 	pMIDIClock->m_lOldTickCount = lTickCount;
 	pMIDIClock->m_lTickCountMod = 0;
+	pMIDIClock->m_llUpdateMicrosec = MIDIClock_GetMonotonicMicrosec (); /* 20261019ǉ */
 
 	/* bN */
 	pMIDIClock->m_lLocked = 0;
@@ -738,3 +746,58 @@ long __stdcall MIDIClock_PutMIDIMessage
 
 	return 1;
 }
+
+/* P錻ݎ[}CNb]擾(20261019ǉ) */
+/* MIDIIn_GetMIDIMessageExԂMƓ(QueryPerformanceCounter)łA */
+/* MIDIIOƋʂMIDIClock_QueryMonotonicMicrosec(MIDIClockTime.h)Ŏ擾 */
+int64_t __stdcall MIDIClock_GetMonotonicMicrosec () {
+	return MIDIClock_QueryMonotonicMicrosec ();
+}
+
+/* w莞[}CNb]ɂeBbN[tick]𐄒肷(20261019ǉ) */
+/* ^C}[̌ĂяoԊuׂxŁAMeBbNɊZ邽߂ɗp */
+long __stdcall MIDIClock_GetTickCountAt (MIDIClock* pMIDIClock, int64_t llMicrosec) {
+	int64_t llTickCount;
+	int64_t llDeltaMicrosec;
+	assert (pMIDIClock);
+	if (pMIDIClock == NULL) {
+		return 0;
+	}
+
+	/* bN */
+	while (pMIDIClock->m_lLocked);
+	pMIDIClock->m_lLocked = 1;
+
+	llTickCount = pMIDIClock->m_lTickCount;
+	/* }X^[[hœ쒆̏ꍇ̂݁AŏIXV̍Ԃ */
+	/* (llMicrosecŏIXVȌꍇ͍ɂȂAߋɑk) */
+	if (pMIDIClock->m_lRunning &&
+		pMIDIClock->m_lMIDIInSyncMode == MIDICLOCK_MASTER &&
+		pMIDIClock->m_llUpdateMicrosec != 0) {
+		llDeltaMicrosec = (llMicrosec - pMIDIClock->m_llUpdateMicrosec) *
+			pMIDIClock->m_lSpeed / MIDICLOCK_SPEEDNORMAL;
+		switch (pMIDIClock->m_lTimeMode) {
+		case MIDICLOCK_TPQNBASE:
+			/* m_lTickCountMod[ʕb~\]Pʂ̒[ł */
+			llTickCount += (pMIDIClock->m_lTickCountMod + 
+				llDeltaMicrosec * pMIDIClock->m_lResolution) / pMIDIClock->m_lTempo;
+			break;
+		case MIDICLOCK_SMPTE24BASE:
+			llTickCount += llDeltaMicrosec * pMIDIClock->m_lResolution * 24 / 1000000;
+			break;
+		case MIDICLOCK_SMPTE25BASE:
+			llTickCount += llDeltaMicrosec * pMIDIClock->m_lResolution * 25 / 1000000;
+			break;
+		case MIDICLOCK_SMPTE29BASE:
+			llTickCount += llDeltaMicrosec * pMIDIClock->m_lResolution * 2997 / 100000000;
+			break;
+		case MIDICLOCK_SMPTE30BASE:
+			llTickCount += llDeltaMicrosec * pMIDIClock->m_lResolution * 30 / 1000000;
+			break;
+		}
+	}
+
+	/* bN */
+	pMIDIClock->m_lLocked = 0;
+	return (long)CLIP (0, llTickCount, 0x7FFFFFFF);
+}
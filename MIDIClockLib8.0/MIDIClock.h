@@ -29,6 +29,8 @@
 #if !defined _MIDICLOCK_H_
 #define _MIDICLOCK_H_
 
+#include <stdint.h>
+
 /* C++gp\Ƃ */
 #ifdef __cplusplus
 extern "C" {
@@ -87,6 +89,7 @@ typedef struct tagMIDIClock {
 	unsigned char m_bySMPTE[8]; /* MIDI^CR[hNH[^[t[ێp */
 	volatile long m_lRunning;   /* 1̂Ƃ쒆A0̂Ƃ~ */
 	volatile long m_lLocked;    /* 1̂Ƃoϐ̑֎~A0̂Ƃ */
+	int64_t m_llUpdateMicrosec; /* eBbNJEgŌɍXV[}CNb](20261019ǉ) */
 } MIDIClock;
 
 /* MIDINbNIuWFNg̍폜 */
@@ -159,6 +162,15 @@ long __stdcall MIDIClock_PutSMPTEMTC (MIDIClock* pMIDIClock, unsigned char cSMPT
 long __stdcall MIDIClock_PutMIDIMessage 
 	(MIDIClock* pMIDIClock, unsigned char* pMessage, long lLen);
 
+/* P錻ݎ[}CNb]擾(20261019ǉ) */
+/* MIDIIn_GetMIDIMessageExԂMƓł */
+int64_t __stdcall MIDIClock_GetMonotonicMicrosec ();
+
+/* w莞[}CNb]ɂeBbN[tick]𐄒肷(20261019ǉ) */
+/* llMicrosecMIDIClock_GetMonotonicMicrosecƓ̎ł */
+/* }X^[[hœ쒆̏ꍇ̂ݍŏIXV̍ԂAȊO݂͌̃eBbNԂ */
+long __stdcall MIDIClock_GetTickCountAt (MIDIClock* pMIDIClock, int64_t llMicrosec);
+
 
 #ifdef __cplusplus
 }
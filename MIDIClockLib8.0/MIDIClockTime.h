@@ -0,0 +1,42 @@
+/******************************************************************************/
+/*                                                                            */
+/*  MIDIClockTime.h - P̎擾(pwb_[)   (C)2026        */
+/*                                                                            */
+/******************************************************************************/
+
+/* ̃W[͕ʂCWin32APIgďĂB */
+/* ̃CúAGNU 򓙈ʌOp_(LGPL)ɊÂzzB */
+/* vWFNgz[y[WF"http://openmidiproject.sourceforge.jp/index.html" */
+/* MIDIClock_GetMonotonicMicrosecMIDIIO̎MEo͎ƂȂ悤A */
+/* MIDIClock.cMIDIIO.c̗̃wb_[̊֐Ōݎ擾(20261019ǉ)B */
+/* MIDIIOMIDIClockDLLɈˑȂ悤A֐{̂wb_[ɒuB */
+/* ̃wb_[O<windows.h><stdint.h>CN[hĂƁB */
+
+/* This library is free software; you can redistribute it and/or */
+/* modify it under the terms of the GNU Lesser General Public */
+/* License as published by the Free Software Foundation; either */
+/* version 2.1 of the License, or (at your option) any later version. */
+
+/* This library is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU */
+/* Lesser General Public License for more details. */
+
+/* You should have received a copy of the GNU Lesser General Public */
+/* License along with this library; if not, write to the Free Software */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+#if !defined _MIDICLOCKTIME_H_
+#define _MIDICLOCKTIME_H_
+
+/* P錻ݎ[}CNb]QueryPerformanceCounter擾 */
+static __inline int64_t MIDIClock_QueryMonotonicMicrosec () {
+	LARGE_INTEGER liCount, liFrequency;
+	QueryPerformanceFrequency (&liFrequency);
+	QueryPerformanceCounter (&liCount);
+	/* Žӂ邽߁AbƕbɕĊZ */
+	return (liCount.QuadPart / liFrequency.QuadPart) * 1000000 +
+		(liCount.QuadPart % liFrequency.QuadPart) * 1000000 / liFrequency.QuadPart;
+}
+
+#endif
@@ -0,0 +1,766 @@
+/******************************************************************************/
+/*                                                                            */
+/*  MIDIConv.c - MIDIファイル一括変換ツール(Win32用)       (C)2026 くず       */
+/*                                                                            */
+/******************************************************************************/
+
+/* このモジュールは普通のＣ言語で書かれている。 */
+/* このプログラムは、GNU 劣等一般公衆利用許諾契約書(LGPL)に基づき配布される。 */
+/* プロジェクトホームページ(仮)："http://openmidiproject.sourceforge.jp/index.html" */
+/* 指定したファイル・ディレクトリ・リストファイル内のMIDIデータを、MIDIDataライブラリの */
+/* 読み込み・保存関数を使って1つのプロセス内で複数のスレッドで並行して変換する(20261019追加) */
+
+/* This library is free software; you can redistribute it and/or */
+/* modify it under the terms of the GNU Lesser General Public */
+/* License as published by the Free Software Foundation; either */
+/* version 2.1 of the License, or (at your option) any later version. */
+
+/* This library is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU */
+/* Lesser General Public License for more details. */
+
+/* You should have received a copy of the GNU Lesser General Public */
+/* License along with this library; if not, write to the Free Software */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <windows.h>
+#include "MIDIData.h"
+
+/* 汎用マクロ(挟み込み) */
+#ifndef CLIP
+#define CLIP(A,B,C) ((A)>(B)?(A):((B)>(C)?(C):(B)))
+#endif
+
+/* 形式番号(g_theMIDIConvFormatの添字) */
+#define MIDICONV_SMF 0
+#define MIDICONV_TEXT 1
+#define MIDICONV_MIDICSV 2
+#define MIDICONV_CHERRY 3
+#define MIDICONV_WRK 4
+#define MIDICONV_MABIMML 5
+#define MIDICONV_NUMFORMAT 6
+
+/* 最大スレッド数 */
+#define MIDICONV_MAXTHREADNUM 64
+
+/* 進捗表示の間隔[ミリ秒] */
+#define MIDICONV_PROGRESSINTERVAL 500
+
+/* 形式情報 */
+typedef struct tagMIDIConvFormat {
+	const char* m_pszName;      /* -t・-fで指定する名前 */
+	const char* m_pszSaveExt;   /* 保存時の拡張子(保存できない形式はNULL) */
+	const char* m_pszLoadExt;   /* 読み込み時に認識する拡張子(';'区切り) */
+} MIDIConvFormat;
+
+static const MIDIConvFormat g_theMIDIConvFormat[MIDICONV_NUMFORMAT] = {
+	{"smf",    ".mid", ".mid;.midi;.smf;.kar"},
+	{"text",   ".txt", ".txt"},
+	{"csv",    ".csv", ".csv"},
+	{"cherry", ".chy", ".chy"},
+	{"wrk",    NULL,   ".wrk"},
+	{"mml",    NULL,   ".mml"}
+};
+
+/* 変換する1つのファイル */
+typedef struct tagMIDIConvJob {
+	char* m_pszInFileName;      /* 入力ファイル名 */
+	char* m_pszOutFileName;     /* 出力ファイル名(入力ファイル名と同じブロックに確保) */
+	long m_lInFormat;           /* 入力形式 */
+	int64_t m_llSize;           /* 入力ファイルのサイズ[バイト] */
+	long m_lSkip;               /* 変換しないか(MIDIConv_CheckJobで設定) */
+} MIDIConvJob;
+
+/* ファイル名のハッシュ表に登録する種類(登録値はジョブ番号*2+種類+1、0=空き) */
+#define MIDICONV_INNAME 0
+#define MIDICONV_OUTNAME 1
+
+/* スレッドごとのジョブキュー */
+/* ジョブ番号の区間[m_lHead, m_lTail)を持ち、持ち主は先頭から取り出し、 */
+/* 自分のキューが空になったスレッドは他のキューの末尾から半分を盗む。 */
+typedef struct tagMIDIConvQueue {
+	CRITICAL_SECTION m_theSection;
+	long m_lHead;
+	long m_lTail;
+} MIDIConvQueue;
+
+/* 変換全体の状態 */
+typedef struct tagMIDIConv {
+	MIDIConvJob* m_pJob;        /* ジョブ配列 */
+	long m_lNumJob;             /* ジョブ数 */
+	long m_lMaxJob;             /* ジョブ配列の確保数 */
+	long* m_pNameHash;          /* 入力・出力ファイル名のハッシュ表(MIDIConv_CheckJob中のみ) */
+	long m_lNameHashSize;       /* ファイル名のハッシュ表の大きさ(2のべき乗) */
+	int64_t m_llTotalSize;      /* 全入力ファイルのサイズの合計[バイト] */
+	long m_lInFormat;           /* 入力形式(-1=拡張子から判断) */
+	long m_lOutFormat;          /* 出力形式 */
+	const char* m_pszOutDir;    /* 出力先ディレクトリ(NULL=入力ファイルと同じ場所) */
+	long m_lRecursive;          /* サブディレクトリも検索するか */
+	long m_lQuiet;              /* 進捗を表示しないか */
+	long m_lOverwrite;          /* 入力ファイル以外の既存のファイルを上書きするか */
+	long m_lNumThread;          /* スレッド数 */
+	MIDIConvQueue m_theQueue[MIDICONV_MAXTHREADNUM];
+	volatile LONG m_lDoneNum;   /* 処理済みファイル数(失敗を含む) */
+	volatile LONG m_lFailedNum; /* 失敗したファイル数 */
+	volatile LONGLONG m_llDoneSize; /* 処理済み入力サイズ[バイト] */
+} MIDIConv;
+
+/* スレッドに渡す引数 */
+typedef struct tagMIDIConvWorker {
+	MIDIConv* m_pMIDIConv;
+	long m_lIndex;
+} MIDIConvWorker;
+
+/* 形式名から形式番号を取得(見つからない場合-1) */
+static long MIDIConv_FindFormat (const char* pszName) {
+	long i;
+	for (i = 0; i < MIDICONV_NUMFORMAT; i++) {
+		if (_stricmp (g_theMIDIConvFormat[i].m_pszName, pszName) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/* ファイル名の拡張子から形式番号を取得(認識できない場合-1) */
+static long MIDIConv_GuessFormat (const char* pszFileName) {
+	const char* pszExt = strrchr (pszFileName, '.');
+	const char* p;
+	const char* q;
+	long i;
+	size_t lExtLen;
+	if (pszExt == NULL || strpbrk (pszExt, "\\/") != NULL) {
+		return -1;
+	}
+	lExtLen = strlen (pszExt);
+	for (i = 0; i < MIDICONV_NUMFORMAT; i++) {
+		p = g_theMIDIConvFormat[i].m_pszLoadExt;
+		while (*p) {
+			q = strchr (p, ';');
+			if (q == NULL) {
+				q = p + strlen (p);
+			}
+			if ((size_t)(q - p) == lExtLen && _strnicmp (p, pszExt, lExtLen) == 0) {
+				return i;
+			}
+			p = (*q == ';') ? q + 1 : q;
+		}
+	}
+	return -1;
+}
+
+/* ファイル名の比較用に1文字を正規化する(大文字小文字と区切り文字の違いを無視する) */
+static int MIDIConv_FoldChar (char c) {
+	return c == '/' ? '\\' : tolower ((unsigned char)c);
+}
+
+/* ファイル名のハッシュ値を求める(FNV-1a) */
+static unsigned long MIDIConv_HashFileName (const char* pszFileName) {
+	unsigned long ulHash = 2166136261UL;
+	for (; *pszFileName; pszFileName++) {
+		ulHash = ((ulHash ^ (unsigned long)MIDIConv_FoldChar (*pszFileName)) * 16777619UL) & 0xFFFFFFFFUL;
+	}
+	return ulHash;
+}
+
+/* 2つのファイル名が同じファイルを指すか調べる */
+static long MIDIConv_IsSameFileName (const char* pszFileName1, const char* pszFileName2) {
+	while (*pszFileName1 && MIDIConv_FoldChar (*pszFileName1) == MIDIConv_FoldChar (*pszFileName2)) {
+		pszFileName1++;
+		pszFileName2++;
+	}
+	return *pszFileName1 == *pszFileName2;
+}
+
+/* ハッシュ表の登録値lEntryが指すファイル名を取得する */
+static const char* MIDIConv_GetEntryName (MIDIConv* pMIDIConv, long lEntry) {
+	MIDIConvJob* pJob = &pMIDIConv->m_pJob[(lEntry - 1) >> 1];
+	return ((lEntry - 1) & 1) == MIDICONV_OUTNAME ? pJob->m_pszOutFileName : pJob->m_pszInFileName;
+}
+
+/* 種類lKindのファイル名pszFileNameをハッシュ表から探す。 */
+/* 戻り値：見つかった登録値。見つからない場合は0を返し、*pSlotに登録すべき位置を格納する。 */
+static long MIDIConv_FindName (MIDIConv* pMIDIConv, const char* pszFileName, long lKind, long* pSlot) {
+	long lMask = pMIDIConv->m_lNameHashSize - 1;
+	long i = (long)(MIDIConv_HashFileName (pszFileName) & lMask);
+	long lEntry = 0;
+	while ((lEntry = pMIDIConv->m_pNameHash[i]) != 0) {
+		if (((lEntry - 1) & 1) == lKind &&
+			MIDIConv_IsSameFileName (MIDIConv_GetEntryName (pMIDIConv, lEntry), pszFileName)) {
+			return lEntry;
+		}
+		i = (i + 1) & lMask;
+	}
+	*pSlot = i;
+	return 0;
+}
+
+/* 全ジョブの出力ファイル名を検査し、変換してよいジョブだけを残す。 */
+/* 次のジョブは飛ばし、入力ファイルと出力ファイルが同じ場合以外は失敗として数える。 */
+/* ・出力ファイルがいずれかのジョブの入力ファイルと同じ(入力ファイルを上書きしてしまう) */
+/* ・出力ファイルが先のジョブの出力ファイルと同じ(-o指定時の同名ファイル等) */
+/* ・出力ファイルが既に存在する(-y指定時を除く) */
+/* 入力ファイル名は飛ばすジョブの分も含めて先にすべて登録するので、列挙の順序によらない。 */
+/* 戻り値：正常終了=1、メモリ不足=0。 */
+static long MIDIConv_CheckJob (MIDIConv* pMIDIConv) {
+	MIDIConvJob* pJob = NULL;
+	const char* pszReason = NULL;
+	long lSize = 1024;
+	long lNumJob = 0;
+	long lSlot = 0;
+	long i;
+
+	/* 1ジョブあたり入力・出力の2件を登録し、使用率を1/2以下に保つ */
+	while (lSize < pMIDIConv->m_lNumJob * 4) {
+		lSize *= 2;
+	}
+	pMIDIConv->m_pNameHash = calloc (lSize, sizeof (long));
+	if (pMIDIConv->m_pNameHash == NULL) {
+		return 0;
+	}
+	pMIDIConv->m_lNameHashSize = lSize;
+
+	/* すべての入力ファイル名を登録する */
+	for (i = 0; i < pMIDIConv->m_lNumJob; i++) {
+		pJob = &pMIDIConv->m_pJob[i];
+		if (MIDIConv_FindName (pMIDIConv, pJob->m_pszInFileName, MIDICONV_INNAME, &lSlot) == 0) {
+			pMIDIConv->m_pNameHash[lSlot] = i * 2 + MIDICONV_INNAME + 1;
+		}
+	}
+
+	/* 出力ファイル名を先のジョブから順に検査して登録する */
+	for (i = 0; i < pMIDIConv->m_lNumJob; i++) {
+		pJob = &pMIDIConv->m_pJob[i];
+		pszReason = NULL;
+		if (MIDIConv_IsSameFileName (pJob->m_pszInFileName, pJob->m_pszOutFileName)) {
+			fprintf (stderr, "入力ファイルと出力ファイルが同じなので飛ばします：%s\n", pJob->m_pszInFileName);
+			pJob->m_lSkip = 1;
+			continue;
+		}
+		if (MIDIConv_FindName (pMIDIConv, pJob->m_pszOutFileName, MIDICONV_INNAME, &lSlot)) {
+			pszReason = "出力ファイルが他の入力ファイルと同じなので飛ばします";
+		}
+		else if (MIDIConv_FindName (pMIDIConv, pJob->m_pszOutFileName, MIDICONV_OUTNAME, &lSlot)) {
+			pszReason = "出力ファイル名が重複するので飛ばします";
+		}
+		else if (!pMIDIConv->m_lOverwrite &&
+			GetFileAttributesA (pJob->m_pszOutFileName) != INVALID_FILE_ATTRIBUTES) {
+			pszReason = "出力ファイルが既に存在するので飛ばします(上書きするには-y)";
+		}
+		if (pszReason) {
+			fprintf (stderr, "%s：%s -> %s\n", pszReason, pJob->m_pszInFileName, pJob->m_pszOutFileName);
+			pMIDIConv->m_lFailedNum++;
+			pJob->m_lSkip = 1;
+			continue;
+		}
+		/* lSlotは直前の出力ファイル名の検索で得た空き位置 */
+		pMIDIConv->m_pNameHash[lSlot] = i * 2 + MIDICONV_OUTNAME + 1;
+	}
+
+	/* ハッシュ表はジョブ番号で名前を参照しているので、解放してからジョブを詰める */
+	free (pMIDIConv->m_pNameHash);
+	pMIDIConv->m_pNameHash = NULL;
+	pMIDIConv->m_lNameHashSize = 0;
+	for (i = 0; i < pMIDIConv->m_lNumJob; i++) {
+		pJob = &pMIDIConv->m_pJob[i];
+		if (pJob->m_lSkip) {
+			free (pJob->m_pszInFileName);
+			continue;
+		}
+		pMIDIConv->m_llTotalSize += pJob->m_llSize;
+		pMIDIConv->m_pJob[lNumJob++] = *pJob;
+	}
+	pMIDIConv->m_lNumJob = lNumJob;
+	return 1;
+}
+
+/* ジョブを1つ追加する。戻り値：正常終了=1、異常終了=0。 */
+/* 入力ファイル名は絶対パスにして保持する(出力ファイル名の検査はMIDIConv_CheckJobで行う)。 */
+static long MIDIConv_AddJob (MIDIConv* pMIDIConv, const char* pszInFileName,
+	const char* pszOutDir, long lInFormat, int64_t llSize) {
+	MIDIConvJob* pJob = NULL;
+	const char* pszBaseName = NULL;
+	const char* pszExt = NULL;
+	const char* pszSaveExt = g_theMIDIConvFormat[pMIDIConv->m_lOutFormat].m_pszSaveExt;
+	char* pszOutFileName = NULL;
+	char szFullPath[MAX_PATH];
+	DWORD dwFullLen = 0;
+	size_t lInLen = 0;
+	size_t lDirLen = 0;
+	size_t lBaseLen = 0;
+
+	/* 同じファイルを指す名前の表記を揃える(取得できない場合は指定のまま) */
+	dwFullLen = GetFullPathNameA (pszInFileName, MAX_PATH, szFullPath, NULL);
+	if (dwFullLen > 0 && dwFullLen < MAX_PATH) {
+		pszInFileName = szFullPath;
+	}
+	lInLen = strlen (pszInFileName);
+
+	/* ジョブ配列の拡張 */
+	if (pMIDIConv->m_lNumJob >= pMIDIConv->m_lMaxJob) {
+		long lNewMax = pMIDIConv->m_lMaxJob > 0 ? pMIDIConv->m_lMaxJob * 2 : 256;
+		MIDIConvJob* pNewJob = realloc (pMIDIConv->m_pJob, sizeof (MIDIConvJob) * lNewMax);
+		if (pNewJob == NULL) {
+			return 0;
+		}
+		pMIDIConv->m_pJob = pNewJob;
+		pMIDIConv->m_lMaxJob = lNewMax;
+	}
+	pJob = &pMIDIConv->m_pJob[pMIDIConv->m_lNumJob];
+
+	/* 出力ファイル名＝出力先ディレクトリ＋入力ファイルのベース名＋出力形式の拡張子 */
+	pszBaseName = pszInFileName + lInLen;
+	while (pszBaseName > pszInFileName && *(pszBaseName - 1) != '\\' &&
+		*(pszBaseName - 1) != '/' && *(pszBaseName - 1) != ':') {
+		pszBaseName--;
+	}
+	pszExt = strrchr (pszBaseName, '.');
+	lBaseLen = pszExt ? (size_t)(pszExt - pszBaseName) : strlen (pszBaseName);
+	lDirLen = pszOutDir ? strlen (pszOutDir) + 1 : (size_t)(pszBaseName - pszInFileName);
+
+	pJob->m_pszInFileName = malloc (lInLen + 1 + lDirLen + lBaseLen + strlen (pszSaveExt) + 1);
+	if (pJob->m_pszInFileName == NULL) {
+		return 0;
+	}
+	memcpy (pJob->m_pszInFileName, pszInFileName, lInLen + 1);
+	pszOutFileName = pJob->m_pszInFileName + lInLen + 1;
+	if (pszOutDir) {
+		memcpy (pszOutFileName, pszOutDir, lDirLen - 1);
+		pszOutFileName[lDirLen - 1] = '\\';
+	}
+	else {
+		memcpy (pszOutFileName, pszInFileName, lDirLen);
+	}
+	memcpy (pszOutFileName + lDirLen, pszBaseName, lBaseLen);
+	strcpy (pszOutFileName + lDirLen + lBaseLen, pszSaveExt);
+	pJob->m_pszOutFileName = pszOutFileName;
+	pJob->m_lInFormat = lInFormat;
+	pJob->m_llSize = llSize;
+	pJob->m_lSkip = 0;
+	pMIDIConv->m_lNumJob++;
+	return 1;
+}
+
+/* ディレクトリ内の認識できるファイルをジョブに追加する。 */
+/* 出力先ディレクトリ指定時は、サブディレクトリの構造を出力先にも作る。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+static long MIDIConv_AddDirectory (MIDIConv* pMIDIConv, const char* pszDir, const char* pszOutDir) {
+	HANDLE hFind = INVALID_HANDLE_VALUE;
+	WIN32_FIND_DATAA theFindData;
+	char szPath[MAX_PATH];
+	char szSubOutDir[MAX_PATH];
+	long lFormat = 0;
+	long lRet = 1;
+
+	if (_snprintf_s (szPath, MAX_PATH, _TRUNCATE, "%s\\*", pszDir) < 0) {
+		fprintf (stderr, "パスが長すぎます：%s\n", pszDir);
+		return 0;
+	}
+	hFind = FindFirstFileA (szPath, &theFindData);
+	if (hFind == INVALID_HANDLE_VALUE) {
+		return 1; /* 空のディレクトリ */
+	}
+	do {
+		if (strcmp (theFindData.cFileName, ".") == 0 ||
+			strcmp (theFindData.cFileName, "..") == 0) {
+			continue;
+		}
+		if (_snprintf_s (szPath, MAX_PATH, _TRUNCATE, "%s\\%s", pszDir, theFindData.cFileName) < 0) {
+			fprintf (stderr, "パスが長すぎます：%s\\%s\n", pszDir, theFindData.cFileName);
+			lRet = 0;
+			break;
+		}
+		if (theFindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+			if (!pMIDIConv->m_lRecursive) {
+				continue;
+			}
+			if (pszOutDir) {
+				if (_snprintf_s (szSubOutDir, MAX_PATH, _TRUNCATE, "%s\\%s",
+					pszOutDir, theFindData.cFileName) < 0) {
+					fprintf (stderr, "パスが長すぎます：%s\\%s\n", pszOutDir, theFindData.cFileName);
+					lRet = 0;
+					break;
+				}
+				CreateDirectoryA (szSubOutDir, NULL);
+			}
+			if (!MIDIConv_AddDirectory (pMIDIConv, szPath, pszOutDir ? szSubOutDir : NULL)) {
+				lRet = 0;
+				break;
+			}
+			continue;
+		}
+		/* ディレクトリ内では拡張子で認識できたファイルだけを対象にする */
+		lFormat = MIDIConv_GuessFormat (theFindData.cFileName);
+		if (lFormat < 0 || (pMIDIConv->m_lInFormat >= 0 && lFormat != pMIDIConv->m_lInFormat)) {
+			continue;
+		}
+		if (!MIDIConv_AddJob (pMIDIConv, szPath, pszOutDir, lFormat,
+			((int64_t)theFindData.nFileSizeHigh << 32) | theFindData.nFileSizeLow)) {
+			fprintf (stderr, "メモリが不足しています。\n");
+			lRet = 0;
+			break;
+		}
+	} while (FindNextFileA (hFind, &theFindData));
+	FindClose (hFind);
+	return lRet;
+}
+
+/* コマンドラインで指定されたファイル又はディレクトリをジョブに追加する。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+static long MIDIConv_AddPath (MIDIConv* pMIDIConv, const char* pszPath) {
+	WIN32_FILE_ATTRIBUTE_DATA theAttributeData;
+	long lFormat = 0;
+	if (!GetFileAttributesExA (pszPath, GetFileExInfoStandard, &theAttributeData)) {
+		fprintf (stderr, "ファイルが見つかりません：%s\n", pszPath);
+		return 0;
+	}
+	if (theAttributeData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+		return MIDIConv_AddDirectory (pMIDIConv, pszPath, pMIDIConv->m_pszOutDir);
+	}
+	/* 明示されたファイルは-fの指定を優先し、無ければ拡張子で判断する */
+	lFormat = pMIDIConv->m_lInFormat >= 0 ?
+		pMIDIConv->m_lInFormat : MIDIConv_GuessFormat (pszPath);
+	if (lFormat < 0) {
+		fprintf (stderr, "形式を判断できません(-fで指定してください)：%s\n", pszPath);
+		return 0;
+	}
+	if (!MIDIConv_AddJob (pMIDIConv, pszPath, pMIDIConv->m_pszOutDir, lFormat,
+		((int64_t)theAttributeData.nFileSizeHigh << 32) | theAttributeData.nFileSizeLow)) {
+		fprintf (stderr, "メモリが不足しています。\n");
+		return 0;
+	}
+	return 1;
+}
+
+/* リストファイル(1行に1つのファイル又はディレクトリ)の内容をジョブに追加する。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+static long MIDIConv_AddListFile (MIDIConv* pMIDIConv, const char* pszListFileName) {
+	FILE* pFile = NULL;
+	char szLine[MAX_PATH + 2];
+	size_t lLen = 0;
+	long lRet = 1;
+	fopen_s (&pFile, pszListFileName, "rt");
+	if (pFile == NULL) {
+		fprintf (stderr, "リストファイルを開けません：%s\n", pszListFileName);
+		return 0;
+	}
+	while (fgets (szLine, sizeof (szLine), pFile)) {
+		lLen = strlen (szLine);
+		while (lLen > 0 && (szLine[lLen - 1] == '\n' || szLine[lLen - 1] == '\r' ||
+			szLine[lLen - 1] == ' ' || szLine[lLen - 1] == '\t')) {
+			szLine[--lLen] = '\0';
+		}
+		if (lLen == 0) {
+			continue;
+		}
+		if (!MIDIConv_AddPath (pMIDIConv, szLine)) {
+			lRet = 0;
+		}
+	}
+	fclose (pFile);
+	return lRet;
+}
+
+/* 1つのファイルを変換する。戻り値：正常終了=1、異常終了=0。 */
+static long MIDIConv_ConvertJob
+(MIDIConv* pMIDIConv, MIDIConvJob* pJob, MIDIDataContext* pContext) {
+	MIDIData* pMIDIData = NULL;
+	long lRet = 0;
+	switch (pJob->m_lInFormat) {
+	case MIDICONV_SMF:
+		pMIDIData = MIDIData_LoadFromSMFExA (pJob->m_pszInFileName, pContext);
+		break;
+	case MIDICONV_TEXT:
+		pMIDIData = MIDIData_LoadFromTextA (pJob->m_pszInFileName);
+		break;
+	case MIDICONV_MIDICSV:
+		pMIDIData = MIDIData_LoadFromMIDICSVA (pJob->m_pszInFileName);
+		break;
+	case MIDICONV_CHERRY:
+		pMIDIData = MIDIData_LoadFromCherryA (pJob->m_pszInFileName);
+		break;
+	case MIDICONV_WRK:
+		pMIDIData = MIDIData_LoadFromWRKA (pJob->m_pszInFileName);
+		break;
+	case MIDICONV_MABIMML:
+		pMIDIData = MIDIData_LoadFromMabiMMLA (pJob->m_pszInFileName);
+		break;
+	}
+	if (pMIDIData == NULL) {
+		return 0;
+	}
+	switch (pMIDIConv->m_lOutFormat) {
+	case MIDICONV_SMF:
+		lRet = MIDIData_SaveAsSMFExA (pMIDIData, pJob->m_pszOutFileName, pContext);
+		break;
+	case MIDICONV_TEXT:
+		lRet = MIDIData_SaveAsTextA (pMIDIData, pJob->m_pszOutFileName);
+		break;
+	case MIDICONV_MIDICSV:
+		lRet = MIDIData_SaveAsMIDICSVExA (pMIDIData, pJob->m_pszOutFileName, pContext);
+		break;
+	case MIDICONV_CHERRY:
+		lRet = MIDIData_SaveAsCherryA (pMIDIData, pJob->m_pszOutFileName);
+		break;
+	}
+	MIDIData_Delete (pMIDIData);
+	return lRet;
+}
+
+/* 自分のキューの先頭からジョブ番号を1つ取り出す(空の場合-1) */
+static long MIDIConv_PopJob (MIDIConv* pMIDIConv, long lIndex) {
+	MIDIConvQueue* pQueue = &pMIDIConv->m_theQueue[lIndex];
+	long lJob = -1;
+	EnterCriticalSection (&pQueue->m_theSection);
+	if (pQueue->m_lHead < pQueue->m_lTail) {
+		lJob = pQueue->m_lHead++;
+	}
+	LeaveCriticalSection (&pQueue->m_theSection);
+	return lJob;
+}
+
+/* 他のスレッドのキューの末尾から残りの半分を盗み、その先頭のジョブ番号を返す。 */
+/* 盗んだ残りは自分のキューに入れる。どのキューも空の場合-1を返す。 */
+/* 2つのキューを同時にロックしないので、盗んでいる途中の区間は一瞬どのキューにも */
+/* 見えないが、ジョブが新たに増えることはないので取りこぼしは生じない。 */
+static long MIDIConv_StealJob (MIDIConv* pMIDIConv, long lIndex) {
+	MIDIConvQueue* pVictim = NULL;
+	MIDIConvQueue* pQueue = &pMIDIConv->m_theQueue[lIndex];
+	long lFirst = 0;
+	long lLast = 0;
+	long i;
+	for (i = 1; i < pMIDIConv->m_lNumThread; i++) {
+		pVictim = &pMIDIConv->m_theQueue[(lIndex + i) % pMIDIConv->m_lNumThread];
+		EnterCriticalSection (&pVictim->m_theSection);
+		if (pVictim->m_lHead < pVictim->m_lTail) {
+			lLast = pVictim->m_lTail;
+			lFirst = lLast - (lLast - pVictim->m_lHead + 1) / 2;
+			pVictim->m_lTail = lFirst;
+			LeaveCriticalSection (&pVictim->m_theSection);
+			EnterCriticalSection (&pQueue->m_theSection);
+			pQueue->m_lHead = lFirst + 1;
+			pQueue->m_lTail = lLast;
+			LeaveCriticalSection (&pQueue->m_theSection);
+			return lFirst;
+		}
+		LeaveCriticalSection (&pVictim->m_theSection);
+	}
+	return -1;
+}
+
+/* 変換スレッド */
+static DWORD WINAPI MIDIConv_ThreadProc (void* pParam) {
+	MIDIConvWorker* pWorker = (MIDIConvWorker*)pParam;
+	MIDIConv* pMIDIConv = pWorker->m_pMIDIConv;
+	MIDIConvJob* pJob = NULL;
+	MIDIDataContext* pContext = NULL;
+	long lJob = 0;
+
+	/* 一時バッファ等の確保先はスレッドごとに分ける */
+	pContext = MIDIDataContext_Create ();
+	if (pContext == NULL) {
+		return 1;
+	}
+	while (1) {
+		lJob = MIDIConv_PopJob (pMIDIConv, pWorker->m_lIndex);
+		if (lJob < 0) {
+			lJob = MIDIConv_StealJob (pMIDIConv, pWorker->m_lIndex);
+			if (lJob < 0) {
+				break;
+			}
+		}
+		pJob = &pMIDIConv->m_pJob[lJob];
+		if (!MIDIConv_ConvertJob (pMIDIConv, pJob, pContext)) {
+			fprintf (stderr, "\n変換に失敗しました：%s\n", pJob->m_pszInFileName);
+			InterlockedIncrement (&pMIDIConv->m_lFailedNum);
+		}
+		InterlockedExchangeAdd64 (&pMIDIConv->m_llDoneSize, pJob->m_llSize);
+		InterlockedIncrement (&pMIDIConv->m_lDoneNum);
+	}
+	MIDIDataContext_Delete (pContext);
+	return 0;
+}
+
+/* 進捗と処理速度を表示する */
+static void MIDIConv_PrintProgress (MIDIConv* pMIDIConv, DWORD dwElapsed, const char* pszEnd) {
+	double dSec = dwElapsed > 0 ? dwElapsed / 1000.0 : 0.001;
+	double dMB = (double)pMIDIConv->m_llDoneSize / (1024.0 * 1024.0);
+	double dTotalMB = (double)pMIDIConv->m_llTotalSize / (1024.0 * 1024.0);
+	fprintf (stderr, "\r%ld/%ld ファイル (失敗 %ld)  %.1f/%.1f MB  %.1f 秒  %.1f ファイル/秒  %.2f MB/秒%s",
+		(long)pMIDIConv->m_lDoneNum, pMIDIConv->m_lNumJob, (long)pMIDIConv->m_lFailedNum,
+		dMB, dTotalMB, dSec, pMIDIConv->m_lDoneNum / dSec, dMB / dSec, pszEnd);
+}
+
+/* 使い方の表示 */
+static void MIDIConv_PrintUsage () {
+	fprintf (stderr,
+		"使い方：midiconv -t 出力形式 [-f 入力形式] [-o 出力先] [-j スレッド数] [-r] [-q] [-y]\n"
+		"                 ファイル|ディレクトリ|@リストファイル ...\n"
+		"  -t  出力形式(smf, text, csv, cherry)\n"
+		"  -f  入力形式(smf, text, csv, cherry, wrk, mml)。省略時は拡張子から判断する。\n"
+		"  -o  出力先ディレクトリ。省略時は入力ファイルと同じ場所に出力する。\n"
+		"  -j  スレッド数(1〜%d)。省略時は論理プロセッサ数。\n"
+		"  -r  サブディレクトリも変換する。\n"
+		"  -q  進捗を表示しない。\n"
+		"  -y  既存のファイルを上書きする(入力ファイルは上書きしない)。\n"
+		"  @リストファイルには1行に1つのファイル又はディレクトリを書く。\n",
+		MIDICONV_MAXTHREADNUM);
+}
+
+int main (int argc, char* argv[]) {
+	MIDIConv theMIDIConv;
+	MIDIConvWorker theWorker[MIDICONV_MAXTHREADNUM];
+	HANDLE hThread[MIDICONV_MAXTHREADNUM];
+	SYSTEM_INFO theSystemInfo;
+	char szOutDir[MAX_PATH];
+	DWORD dwFullLen = 0;
+	DWORD dwStartTime = 0;
+	long lPerThread = 0;
+	long lNumStarted = 0;
+	long lRet = 0;
+	long i;
+	int n;
+
+	memset (&theMIDIConv, 0, sizeof (theMIDIConv));
+	theMIDIConv.m_lInFormat = -1;
+	theMIDIConv.m_lOutFormat = -1;
+	GetSystemInfo (&theSystemInfo);
+	theMIDIConv.m_lNumThread = (long)theSystemInfo.dwNumberOfProcessors;
+
+	/* オプションの解析 */
+	for (n = 1; n < argc && argv[n][0] == '-' && argv[n][1] != '\0'; n++) {
+		if (strcmp (argv[n], "-r") == 0) {
+			theMIDIConv.m_lRecursive = 1;
+		}
+		else if (strcmp (argv[n], "-q") == 0) {
+			theMIDIConv.m_lQuiet = 1;
+		}
+		else if (strcmp (argv[n], "-y") == 0) {
+			theMIDIConv.m_lOverwrite = 1;
+		}
+		else if (n + 1 < argc && strcmp (argv[n], "-t") == 0) {
+			theMIDIConv.m_lOutFormat = MIDIConv_FindFormat (argv[++n]);
+			if (theMIDIConv.m_lOutFormat < 0 ||
+				g_theMIDIConvFormat[theMIDIConv.m_lOutFormat].m_pszSaveExt == NULL) {
+				fprintf (stderr, "この形式では保存できません：%s\n", argv[n]);
+				return 2;
+			}
+		}
+		else if (n + 1 < argc && strcmp (argv[n], "-f") == 0) {
+			theMIDIConv.m_lInFormat = MIDIConv_FindFormat (argv[++n]);
+			if (theMIDIConv.m_lInFormat < 0) {
+				fprintf (stderr, "不明な形式です：%s\n", argv[n]);
+				return 2;
+			}
+		}
+		else if (n + 1 < argc && strcmp (argv[n], "-o") == 0) {
+			theMIDIConv.m_pszOutDir = argv[++n];
+		}
+		else if (n + 1 < argc && strcmp (argv[n], "-j") == 0) {
+			theMIDIConv.m_lNumThread = atol (argv[++n]);
+		}
+		else {
+			MIDIConv_PrintUsage ();
+			return 2;
+		}
+	}
+	if (theMIDIConv.m_lOutFormat < 0 || n >= argc) {
+		MIDIConv_PrintUsage ();
+		return 2;
+	}
+	theMIDIConv.m_lNumThread = CLIP (1, theMIDIConv.m_lNumThread, MIDICONV_MAXTHREADNUM);
+	if (theMIDIConv.m_pszOutDir) {
+		CreateDirectoryA (theMIDIConv.m_pszOutDir, NULL);
+		/* 出力ファイル名を入力ファイル名と比較できるよう絶対パスにする */
+		dwFullLen = GetFullPathNameA (theMIDIConv.m_pszOutDir, MAX_PATH, szOutDir, NULL);
+		if (dwFullLen > 0 && dwFullLen < MAX_PATH) {
+			theMIDIConv.m_pszOutDir = szOutDir;
+		}
+	}
+
+	/* 変換するファイルの列挙 */
+	for (; n < argc; n++) {
+		if (argv[n][0] == '@') {
+			if (!MIDIConv_AddListFile (&theMIDIConv, argv[n] + 1)) {
+				goto exit;
+			}
+		}
+		else {
+			if (!MIDIConv_AddPath (&theMIDIConv, argv[n])) {
+				goto exit;
+			}
+		}
+	}
+	/* 入力ファイルや既存のファイルを上書きしてしまうジョブを除く */
+	if (!MIDIConv_CheckJob (&theMIDIConv)) {
+		fprintf (stderr, "メモリが不足しています。\n");
+		goto exit;
+	}
+	if (theMIDIConv.m_lNumJob == 0) {
+		fprintf (stderr, "変換するファイルがありません。\n");
+		goto exit;
+	}
+	if (theMIDIConv.m_lNumThread > theMIDIConv.m_lNumJob) {
+		theMIDIConv.m_lNumThread = theMIDIConv.m_lNumJob;
+	}
+
+	/* ジョブを連続した区間に分けて各スレッドのキューに割り当てる */
+	lPerThread = theMIDIConv.m_lNumJob / theMIDIConv.m_lNumThread;
+	for (i = 0; i < theMIDIConv.m_lNumThread; i++) {
+		InitializeCriticalSection (&theMIDIConv.m_theQueue[i].m_theSection);
+		theMIDIConv.m_theQueue[i].m_lHead = i * lPerThread;
+		theMIDIConv.m_theQueue[i].m_lTail = (i == theMIDIConv.m_lNumThread - 1) ?
+			theMIDIConv.m_lNumJob : (i + 1) * lPerThread;
+	}
+
+	/* 変換スレッドの起動 */
+	dwStartTime = GetTickCount ();
+	for (i = 0; i < theMIDIConv.m_lNumThread; i++) {
+		theWorker[i].m_pMIDIConv = &theMIDIConv;
+		theWorker[i].m_lIndex = i;
+		hThread[i] = CreateThread (NULL, 0, MIDIConv_ThreadProc, &theWorker[i], 0, NULL);
+		if (hThread[i]) {
+			lNumStarted++;
+		}
+	}
+	/* 起動できなかったスレッドの分は他のスレッドが盗んで処理する。 */
+	/* 1つも起動できなかった場合はこのスレッドで全て処理する。 */
+	if (lNumStarted == 0) {
+		MIDIConv_ThreadProc (&theWorker[0]);
+	}
+
+	/* 全スレッドの終了を待ちながら進捗を表示する */
+	for (i = 0; i < theMIDIConv.m_lNumThread; ) {
+		if (hThread[i] == NULL ||
+			WaitForSingleObject (hThread[i], MIDICONV_PROGRESSINTERVAL) != WAIT_TIMEOUT) {
+			if (hThread[i]) {
+				CloseHandle (hThread[i]);
+			}
+			i++;
+			continue;
+		}
+		if (!theMIDIConv.m_lQuiet) {
+			MIDIConv_PrintProgress (&theMIDIConv, GetTickCount () - dwStartTime, "");
+		}
+	}
+	MIDIConv_PrintProgress (&theMIDIConv, GetTickCount () - dwStartTime, "\n");
+
+	for (i = 0; i < theMIDIConv.m_lNumThread; i++) {
+		DeleteCriticalSection (&theMIDIConv.m_theQueue[i].m_theSection);
+	}
+	lRet = (theMIDIConv.m_lFailedNum == 0);
+
+	exit:
+	for (i = 0; i < theMIDIConv.m_lNumJob; i++) {
+		free (theMIDIConv.m_pJob[i].m_pszInFileName);
+	}
+	free (theMIDIConv.m_pJob);
+	free (theMIDIConv.m_pNameHash);
+	return lRet ? 0 : 1;
+}
@@ -112,6 +112,13 @@ Public Const LC_ALL = 0
 ' ̑̃}N
 Public Const MIDIEVENT_MAXLEN = 65536
 
+' ǂݍ݃IvVɊւ}N(20261019ǉ)
+Public Const MIDIDATACONTEXT_STRICT = &H1        ' sȃf[^␳ɓǂݍ݂s
+Public Const MIDIDATACONTEXT_NOAUTOSETTING = &H2 ' ǂݍ݌̏o̓|[g̎ݒȗ
+
+' ۑIvVɊւ}N(20261019ǉ)
+Public Const MIDIDATACONTEXT_PARALLELSAVE = &H1  ' egbN𕡐̃Xbhŕsĕ
+
 ' tH[}bgɊւ}N
 Public Const MIDIDATA_FORMAT0 = 0
 Public Const MIDIDATA_FORMAT1 = 1
@@ -120,6 +127,15 @@ Public Const MIDIDATA_FORMAT2 = 2
 ' gbNɊւ}N
 Public Const MIDIDATA_MAXMIDITRACKNUM = 65535
 
+' LbVʂēǂݍރf[^̌`Ɋւ}N(20261019ǉ)
+Public Const MIDIDATACACHE_SMF = 0                ' X^_[hMIDIt@C(*.mid)
+Public Const MIDIDATACACHE_TEXT = 1               ' eLXgt@C
+Public Const MIDIDATACACHE_BINARY = 2             ' oCit@C
+Public Const MIDIDATACACHE_CHERRY = 3             ' Cherryt@C(*.chy)
+Public Const MIDIDATACACHE_MIDICSV = 4            ' MIDICSVt@C(*.csv)
+Public Const MIDIDATACACHE_WRK = 5                ' Cakewalkt@C(*.wrk)
+Public Const MIDIDATACACHE_MABIMML = 6            ' }rmMMMLt@C(*.mml)
+
 ' e|Ɋւ}N
 ' dvFe|̒Pʂׂ͂[ʕb/4]ƂB
 Public Const MIDIEVENT_MINTEMPO = 1
@@ -184,6 +200,49 @@ Public Const MIDIEVENT_SYSEXCONTINUE = &HF0     ' 
 Declare Function MIDIDataLib_SetDefaultCharCode Lib "MIDIData.dll" _
     (ByVal lCharCode As Long) As Long
 
+' ...Memory֐ԂubN̉(20261019ǉ)
+Declare Sub MIDIDataLib_FreeMemory Lib "MIDIData.dll" _
+    (ByVal pData As Long)
+
+'*********************************************************************/
+'*                                                                   */
+'*@MIDIDataContextNX֐(20261019ǉ)                          */
+'*                                                                   */
+'*********************************************************************/
+
+' Exł̊֐ɂ̓ReLXgnB0nꍇ͊̃ReLXgpB
+
+' ReLXg̍폜
+Declare Sub MIDIDataContext_Delete Lib "MIDIData.dll" _
+    (ByVal pContext As Long)
+
+' ReLXg̐(ݒ͊̃ReLXǧ݂̐ݒp)
+Declare Function MIDIDataContext_Create Lib "MIDIData.dll" () As Long
+
+' ftHgR[h̎擾
+Declare Function MIDIDataContext_GetDefaultCharCode Lib "MIDIData.dll" _
+    (ByVal pContext As Long) As Long
+
+' ftHgR[h̐ݒ
+Declare Function MIDIDataContext_SetDefaultCharCode Lib "MIDIData.dll" _
+    (ByVal pContext As Long, ByVal lCharCode As Long) As Long
+
+' ǂݍ݃IvV̎擾
+Declare Function MIDIDataContext_GetLoadFlags Lib "MIDIData.dll" _
+    (ByVal pContext As Long) As Long
+
+' ǂݍ݃IvV̐ݒ
+Declare Function MIDIDataContext_SetLoadFlags Lib "MIDIData.dll" _
+    (ByVal pContext As Long, ByVal lLoadFlags As Long) As Long
+
+' ۑIvV̎擾
+Declare Function MIDIDataContext_GetSaveFlags Lib "MIDIData.dll" _
+    (ByVal pContext As Long) As Long
+
+' ۑIvV̐ݒ
+Declare Function MIDIDataContext_SetSaveFlags Lib "MIDIData.dll" _
+    (ByVal pContext As Long, ByVal lSaveFlags As Long) As Long
+
 '*********************************************************************/
 '*                                                                   */
 '*@MIDIEventNX֐                                              */
@@ -208,6 +267,10 @@ Declare Function MIDIEvent_GetLastCombinedEvent Lib "MIDIData.dll" _
 Declare Function MIDIEvent_Combine Lib "MIDIData.dll" _
     (ByVal pMIDIEvent As Long) As Long
 
+' m[gICxgƃm[gItCxgw肵Č(20261019ǉ)
+Declare Function MIDIEvent_CombineNoteOnOff Lib "MIDIData.dll" _
+    (ByVal pNoteOnEvent As Long, ByVal pNoteOffEvent As Long) As Long
+
 ' Cxg؂藣
 Declare Function MIDIEvent_Chop Lib "MIDIData.dll" _
     (ByVal pMIDIEvent As Long) As Long
@@ -556,12 +619,23 @@ Declare Function MIDIEvent_GetText Lib "MIDIData.dll" _
     Alias "MIDIEvent_GetTextA" _
     (ByVal pEvent As Long, ByVal strBuf As String, ByVal lLen As Long) As Long
 
+' Cxg̃eLXg擾(ReLXgw)(20261019ǉ)
+Declare Function MIDIEvent_GetTextEx Lib "MIDIData.dll" _
+    Alias "MIDIEvent_GetTextExA" _
+    (ByVal pEvent As Long, ByVal strBuf As String, ByVal lLen As Long, _
+    ByVal pContext As Long) As Long
+
 ' Cxg̃eLXgݒ(eLXgE쌠EgbNECXgDgE
 ' ̎E}[J[EL[|CgEvOEfoCX̂)
 Declare Function MIDIEvent_SetText Lib "MIDIData.dll" _
     Alias "MIDIEvent_SetTextA" _
     (ByVal pEvent As Long, ByVal strText As String) As Long
 
+' Cxg̃eLXgݒ(ReLXgw)(20261019ǉ)
+Declare Function MIDIEvent_SetTextEx Lib "MIDIData.dll" _
+    Alias "MIDIEvent_SetTextExA" _
+    (ByVal pEvent As Long, ByVal strText As String, ByVal pContext As Long) As Long
+
 ' SMPTEItZbg擾(SMPTEItZbgCxĝ)
 Declare Function MIDIEvent_GetSMPTEOffset Lib "MIDIData.dll" _
     (ByVal pEvent As Long, ByRef pMode As Long, ByRef pHour As Long, _
@@ -896,6 +970,10 @@ Declare Function MIDITrack_InsertEventBefore Lib "MIDIData.dll" _
 Declare Function MIDITrack_InsertEvent Lib "MIDIData.dll" _
     (ByVal pMIDITrack As Long, ByVal pEvent As Long) As Long
 
+' gbN̍ŌɃCxgǉ(Cxg͂炩ߐĂ)(20261019ǉ)
+Declare Function MIDITrack_AppendSingleEventForce Lib "MIDIData.dll" _
+    (ByVal pMIDITrack As Long, ByVal pEvent As Long, ByVal pPrevSameKindEvent As Long) As Long
+
 ' gbNɃV[PXԍCxg𐶐đ}
 Declare Function MIDITrack_InsertSequenceNumber Lib "MIDIData.dll" _
     (ByVal pMIDITrack As Long, ByVal lTime As Long, ByVal lNumber As Long) As Long
@@ -1300,6 +1378,17 @@ Declare Function MIDIData_SaveAsSMF Lib "MIDIData.dll" _
     Alias "MIDIData_SaveAsSMFA" _
     (ByVal pMIDIData As Long, ByVal strFileName As String) As Long
 
+' MIDIDataX^_[hMIDIt@C(SMF)ǂݍ݁A
+' VMIDIf[^ւ̃|C^Ԃ(sNULL)(ReLXgw)(20261019ǉ)
+Declare Function MIDIData_LoadFromSMFEx Lib "MIDIData.dll" _
+    Alias "MIDIData_LoadFromSMFExA" _
+    (ByVal strFileName As String, ByVal pContext As Long) As Long
+
+' MIDIf[^X^_[hMIDIt@C(SMF)Ƃĕۑ(ReLXgw)(20261019ǉ)
+Declare Function MIDIData_SaveAsSMFEx Lib "MIDIData.dll" _
+    Alias "MIDIData_SaveAsSMFExA" _
+    (ByVal pMIDIData As Long, ByVal strFileName As String, ByVal pContext As Long) As Long
+
 ' MIDIf[^oCit@Cǂݍ݁A
 ' VMIDIf[^ւ̃|C^Ԃ(sNULL)
 Declare Function MIDIData_LoadFromBinary Lib "MIDIData.dll" _
@@ -1311,6 +1400,17 @@ Declare Function MIDIData_SaveAsBinary Lib "MIDIData.dll" _
     Alias "MIDIData_SaveAsBinaryA" _
     (ByVal pMIDIData As Long, ByVal strFileName As String) As Long
 
+' MIDIf[^XibvVbgt@C(*.mds)ǂݍ݁A(20261019ǉ)
+' VMIDIf[^ւ̃|C^Ԃ(sNULL)
+Declare Function MIDIData_LoadFromSnapshot Lib "MIDIData.dll" _
+    Alias "MIDIData_LoadFromSnapshotA" _
+    (ByVal strFileName As String) As Long
+
+' MIDIf[^XibvVbgt@C(*.mds)֕ۑ(20261019ǉ)
+Declare Function MIDIData_SaveAsSnapshot Lib "MIDIData.dll" _
+    Alias "MIDIData_SaveAsSnapshotA" _
+    (ByVal pMIDIData As Long, ByVal strFileName As String) As Long
+
 ' MIDIf[^Cherryt@C(*.chy)ǂݍ݁A
 ' VMIDIf[^ւ̃|C^Ԃ(sNULL)
 Declare Function MIDIData_LoadFromCherry Lib "MIDIData.dll" _
@@ -1322,6 +1422,32 @@ Declare Function MIDIData_SaveAsCherry Lib "MIDIData.dll" _
     Alias "MIDIData_SaveAsCherryA" _
     (ByVal pMIDIData As Long, ByVal strFileName As String) As Long
 
+' e`̃ubNǂݍ݁A
+' VMIDIf[^ւ̃|C^Ԃ(sNULL)(20261019ǉ)
+Declare Function MIDIData_LoadFromSMFMemory Lib "MIDIData.dll" _
+    (ByRef pData As Any, ByVal lLen As Long) As Long
+Declare Function MIDIData_LoadFromBinaryMemory Lib "MIDIData.dll" _
+    (ByRef pData As Any, ByVal lLen As Long) As Long
+Declare Function MIDIData_LoadFromSnapshotMemory Lib "MIDIData.dll" _
+    (ByRef pData As Any, ByVal lLen As Long) As Long
+Declare Function MIDIData_LoadFromCherryMemory Lib "MIDIData.dll" _
+    (ByRef pData As Any, ByVal lLen As Long) As Long
+Declare Function MIDIData_LoadFromMIDICSVMemory Lib "MIDIData.dll" _
+    (ByRef pData As Any, ByVal lLen As Long) As Long
+
+' e`ŃubN֕ۑ(20261019ǉ)
+' ۑf[^̃|C^pDataAlLenɕԂBMIDIDataLib_FreeMemoryŉ邱ƁB
+Declare Function MIDIData_SaveAsSMFMemory Lib "MIDIData.dll" _
+    (ByVal pMIDIData As Long, ByRef pData As Long, ByRef lLen As Long) As Long
+Declare Function MIDIData_SaveAsBinaryMemory Lib "MIDIData.dll" _
+    (ByVal pMIDIData As Long, ByRef pData As Long, ByRef lLen As Long) As Long
+Declare Function MIDIData_SaveAsSnapshotMemory Lib "MIDIData.dll" _
+    (ByVal pMIDIData As Long, ByRef pData As Long, ByRef lLen As Long) As Long
+Declare Function MIDIData_SaveAsCherryMemory Lib "MIDIData.dll" _
+    (ByVal pMIDIData As Long, ByRef pData As Long, ByRef lLen As Long) As Long
+Declare Function MIDIData_SaveAsMIDICSVMemory Lib "MIDIData.dll" _
+    (ByVal pMIDIData As Long, ByRef pData As Long, ByRef lLen As Long) As Long
+
 ' MIDIDataMIDICSVt@C(*.csv)ǂݍ݁A
 ' VMIDIf[^ւ̃|C^Ԃ(sNULL)
 Declare Function MIDIData_LoadFromMIDICSV Lib "MIDIData.dll" _
@@ -1333,4 +1459,70 @@ Declare Function MIDIData_SaveAsMIDICSV Lib "MIDIData.dll" _
     Alias "MIDIData_SaveAsMIDICSVA" _
     (ByVal pMIDIData As Long, ByVal strFileName As String) As Long
 
+' MIDIf[^MIDICSVt@C(*.csv)Ƃĕۑ(ReLXgw)(20261019ǉ)
+Declare Function MIDIData_SaveAsMIDICSVEx Lib "MIDIData.dll" _
+    Alias "MIDIData_SaveAsMIDICSVExA" _
+    (ByVal pMIDIData As Long, ByVal strFileName As String, ByVal pContext As Long) As Long
+
+
+'*********************************************************************/
+'*                                                                   */
+'*@MIDIDataSnapshotNX֐(20261019ǉ)                         */
+'*                                                                   */
+'*********************************************************************/
+
+' XibvVbg̓e͉͂ʂɎQƂBҏWꍇMIDIDataɕϊB
+
+' XibvVbgt@C(*.mds)ǂݎpŃɃ}bvĊJ(sNULL)
+Declare Function MIDIDataSnapshot_OpenFile Lib "MIDIData.dll" _
+    Alias "MIDIDataSnapshot_OpenFileA" _
+    (ByVal strFileName As String) As Long
+
+' XibvVbg
+Declare Sub MIDIDataSnapshot_Close Lib "MIDIData.dll" _
+    (ByVal pSnapshot As Long)
+
+' XibvVbgSMFtH[}bg擾
+Declare Function MIDIDataSnapshot_GetFormat Lib "MIDIData.dll" _
+    (ByVal pSnapshot As Long) As Long
+
+' XibvVbg̃^Cx[X擾
+Declare Function MIDIDataSnapshot_GetTimeBase Lib "MIDIData.dll" _
+    (ByVal pSnapshot As Long) As Long
+
+' XibvVbg̃gbN擾
+Declare Function MIDIDataSnapshot_GetNumTrack Lib "MIDIData.dll" _
+    (ByVal pSnapshot As Long) As Long
+
+' XibvVbgVMIDIf[^𐶐Ã|C^Ԃ(sNULL)
+Declare Function MIDIDataSnapshot_ToMIDIData Lib "MIDIData.dll" _
+    (ByVal pSnapshot As Long) As Long
+
+
+'*********************************************************************/
+'*                                                                   */
+'*@MIDIDataCacheNX֐(20261019ǉ)                            */
+'*                                                                   */
+'*********************************************************************/
+
+' ǂݍ񂾋ȂXibvVbgƂăLbVfBNgɕۑĂA
+' ẽf[^2ڈȍ~̓ǂݍ݂ł͉͂ȂB
+
+' LbV𐶐ALbVւ̃|C^Ԃ(sNULL)
+' lMaxSize̓LbV̍v̒̏[KB]
+Declare Function MIDIDataCache_Create Lib "MIDIData.dll" _
+    Alias "MIDIDataCache_CreateA" _
+    (ByVal strDirName As String, ByVal lMaxSize As Long) As Long
+
+' LbV폜(LbVfBNg̃t@C͍폜Ȃ)
+Declare Sub MIDIDataCache_Delete Lib "MIDIData.dll" _
+    (ByVal pCache As Long)
+
+' LbVfBNg̃LbVt@CSč폜A폜t@CԂ
+Declare Function MIDIDataCache_Clear Lib "MIDIData.dll" _
+    (ByVal pCache As Long) As Long
 
+' LbVʂăt@Cǂݍ݁AVMIDIf[^ւ̃|C^Ԃ(sNULL)
+Declare Function MIDIDataCache_LoadFromFile Lib "MIDIData.dll" _
+    Alias "MIDIDataCache_LoadFromFileA" _
+    (ByVal pCache As Long, ByVal strFileName As String, ByVal lFormat As Long) As Long
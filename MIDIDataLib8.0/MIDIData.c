@@ -27,6 +27,7 @@
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
@@ -123,19 +124,49 @@ int utf8towcs (wchar_t *dest, const char *source, int maxCount) {
 /*                                                                            */
 /******************************************************************************/
 
-/* MIDIDataライブラリ環境保持用変数 */
-typedef struct {
-	long m_lDefaultCharCode;
-} MIDIDataLib;
+/* 既定のコンテキスト(20261019変更:g_theMIDIDataLibから置き換え) */
+/* コンテキストを指定しない関数(Ex版でない関数及びEx版にNULLを渡した場合)はこれを用いる。 */
+static MIDIDataContext g_theDefaultContext;
 
-MIDIDataLib g_theMIDIDataLib;
+/* コンテキストの取得(NULLの場合は既定のコンテキスト)(20261019追加) */
+static MIDIDataContext* GetContext (MIDIDataContext* pContext) {
+	return pContext ? pContext : &g_theDefaultContext;
+}
 
-/* デフォルト文字コードの設定 */
+/* 作業用メモリの確保(20261019追加) */
+static void* MIDIDataContext_Alloc (MIDIDataContext* pContext, long lSize) {
+	assert (pContext);
+	if (pContext->m_pfnAlloc) {
+		return pContext->m_pfnAlloc (pContext->m_pAllocParam, lSize);
+	}
+	return malloc (lSize);
+}
+
+/* 作業用メモリの解放(20261019追加) */
+static void MIDIDataContext_Free (MIDIDataContext* pContext, void* pBuf) {
+	assert (pContext);
+	if (pBuf == NULL) {
+		return;
+	}
+	if (pContext->m_pfnFree) {
+		pContext->m_pfnFree (pContext->m_pAllocParam, pBuf);
+	}
+	else {
+		free (pBuf);
+	}
+}
+
+/* デフォルト文字コードの設定(既定のコンテキストに設定する) */
 long __stdcall MIDIDataLib_SetDefaultCharCode (long lCharCode) {
-	g_theMIDIDataLib.m_lDefaultCharCode = lCharCode;
+	g_theDefaultContext.m_lDefaultCharCode = lCharCode;
 	return 1;
 }
 
+/* ...Memory関数が返したメモリブロックの解放(20261019追加) */
+void __stdcall MIDIDataLib_FreeMemory (void* pData) {
+	free (pData);
+}
+
 /* ロケールの設定(ANSI)(20140517無効化) */
 char* __stdcall MIDIDataLib_SetLocaleA (int nCategory, const char *pszLocale) {
 /*	g_theMIDIDataLib.m_nCategory = nCategory;
@@ -158,6 +189,76 @@ wchar_t* __stdcall MIDIDataLib_SetLocaleW (int nCategory, const wchar_t* pszLoca
 	return NULL;
 }
 
+/******************************************************************************/
+/*                                                                            */
+/*　MIDIDataContextクラス関数(20261019追加)                                   */
+/*                                                                            */
+/******************************************************************************/
+
+/* コンテキストの削除 */
+void __stdcall MIDIDataContext_Delete (MIDIDataContext* pContext) {
+	if (pContext == NULL || pContext == &g_theDefaultContext) {
+		return;
+	}
+	free (pContext);
+}
+
+/* コンテキストの生成(設定は既定のコンテキストの現在の設定を引き継ぐ) */
+MIDIDataContext* __stdcall MIDIDataContext_Create () {
+	MIDIDataContext* pContext = calloc (1, sizeof (MIDIDataContext));
+	if (pContext == NULL) {
+		return NULL;
+	}
+	memcpy (pContext, &g_theDefaultContext, sizeof (MIDIDataContext));
+	return pContext;
+}
+
+/* デフォルト文字コードの取得 */
+long __stdcall MIDIDataContext_GetDefaultCharCode (MIDIDataContext* pContext) {
+	return GetContext (pContext)->m_lDefaultCharCode;
+}
+
+/* デフォルト文字コードの設定 */
+long __stdcall MIDIDataContext_SetDefaultCharCode (MIDIDataContext* pContext, long lCharCode) {
+	GetContext (pContext)->m_lDefaultCharCode = lCharCode;
+	return 1;
+}
+
+/* 読み込みオプションの取得 */
+long __stdcall MIDIDataContext_GetLoadFlags (MIDIDataContext* pContext) {
+	return GetContext (pContext)->m_lLoadFlags;
+}
+
+/* 読み込みオプションの設定 */
+long __stdcall MIDIDataContext_SetLoadFlags (MIDIDataContext* pContext, long lLoadFlags) {
+	GetContext (pContext)->m_lLoadFlags = lLoadFlags;
+	return 1;
+}
+
+/* 保存オプションの取得(20261019追加) */
+long __stdcall MIDIDataContext_GetSaveFlags (MIDIDataContext* pContext) {
+	return GetContext (pContext)->m_lSaveFlags;
+}
+
+/* 保存オプションの設定(20261019追加) */
+long __stdcall MIDIDataContext_SetSaveFlags (MIDIDataContext* pContext, long lSaveFlags) {
+	GetContext (pContext)->m_lSaveFlags = lSaveFlags;
+	return 1;
+}
+
+/* 作業用メモリの確保・解放関数の設定(両方NULLの場合はmalloc・freeに戻す) */
+long __stdcall MIDIDataContext_SetAllocator (MIDIDataContext* pContext,
+	MIDIDataContextAllocProc pfnAlloc, MIDIDataContextFreeProc pfnFree, void* pParam) {
+	pContext = GetContext (pContext);
+	if ((pfnAlloc == NULL) != (pfnFree == NULL)) {
+		return 0;
+	}
+	pContext->m_pfnAlloc = pfnAlloc;
+	pContext->m_pfnFree = pfnFree;
+	pContext->m_pAllocParam = pParam;
+	return 1;
+}
+
 /* DLLMain */
 static BOOL __stdcall DllMain (HINSTANCE hinstDLL, DWORD fdwReason, LPVOID lpvReserved) {
 	/* DLLが読み込まれたとき */
@@ -609,6 +710,34 @@ long __stdcall MIDIEvent_Combine (MIDIEvent* pEvent) {
 	return 0;
 }
 
+/* ノートオンイベントとノートオフイベントを指定して結合する(20261019追加) */
+/* MIDIEvent_Combineと異なり探索を行わないため、リアルタイム記録時に使用できる */
+long __stdcall MIDIEvent_CombineNoteOnOff (MIDIEvent* pNoteOnEvent, MIDIEvent* pNoteOffEvent) {
+	assert (pNoteOnEvent);
+	assert (pNoteOffEvent);
+	/* 既に結合されてる場合は異常終了 */
+	if (MIDIEvent_IsCombined (pNoteOnEvent) || MIDIEvent_IsCombined (pNoteOffEvent)) {
+		return 0;
+	}
+	/* ノートオンとノートオフの組でない場合は異常終了 */
+	if (!MIDIEvent_IsNoteOn (pNoteOnEvent) || !MIDIEvent_IsNoteOff (pNoteOffEvent)) {
+		return 0;
+	}
+	/* キーとチャンネルが一致しない場合は異常終了 */
+	if (MIDIEvent_GetKey (pNoteOnEvent) != MIDIEvent_GetKey (pNoteOffEvent) ||
+		MIDIEvent_GetChannel (pNoteOnEvent) != MIDIEvent_GetChannel (pNoteOffEvent)) {
+		return 0;
+	}
+	/* ノートオフはノートオンより前には来れない */
+	if (pNoteOffEvent->m_lTime < pNoteOnEvent->m_lTime) {
+		return 0;
+	}
+	/* ノートオフ側を先に設定し、ノートオン側から辿れる時点で整合している状態にする */
+	pNoteOffEvent->m_pPrevCombinedEvent = pNoteOnEvent;
+	pNoteOnEvent->m_pNextCombinedEvent = pNoteOffEvent;
+	return 1;
+}
+
 /* 結合イベントを切り離す */
 long __stdcall MIDIEvent_Chop (MIDIEvent* pEvent) {
 	long lCount = 0;
@@ -769,8 +898,9 @@ MIDIEvent* __stdcall MIDIEvent_Create
 	pEvent->m_lTime = lTime;
 	pEvent->m_lKind = lKind;
 	/* pDataにランニングステータスが含まれていない場合の措置 */
-	if (((0x80 <= lKind && lKind <= 0xEF) && (0 <= *pData && *pData <= 127)) ||
-		((lKind == 0xF0) && (0 <= *pData && *pData <= 127))) {
+	if (pData != NULL && /* 20261019条件式追加 */
+		(((0x80 <= lKind && lKind <= 0xEF) && (0 <= *pData && *pData <= 127)) ||
+		((lKind == 0xF0) && (0 <= *pData && *pData <= 127)))) {
 		lLen ++;
 	}
 	pEvent->m_lLen = lLen;
@@ -2500,495 +2630,598 @@ void* memcpyinv2 (void* pDestData, const void* pSrcData, long lLen) {
 	return pDestData;
 }
 
-/* イベントの文字コードを設定 */
-long __stdcall MIDIEvent_SetCharCode (MIDIEvent* pEvent, long lCharCode) {
-	long lOldCharCode = 0;
-	long lTextLenA = 0;
-	long lTextLenW = 0;
-	long lTextLenUTF8 = 0;
-	long lRet = 0;
-	size_t llRet = 0;
-	errno_t nErrorNo =0;
-	wchar_t wcText[MIDIEVENT_MAXLEN + 1];
-	unsigned char byText[MIDIEVENT_MAXLEN + 1];
-	unsigned char byTextUTF8[MIDIEVENT_MAXLEN + 1];
-	unsigned char byData[MIDIEVENT_MAXLEN + sizeof (wchar_t)];
-	long lDataLen = 0;
-	assert (pEvent);
-	if (pEvent->m_lKind <= 0x00 || pEvent->m_lKind >= 0x1F) {
-		return 0;
-	}
-	memset (wcText, 0, sizeof (wcText));
-	memset (byText, 0, sizeof (byText));
-	memset (byTextUTF8, 0, sizeof (byTextUTF8));
-	memset (byData, 0, sizeof (byData));
-	lOldCharCode = MIDIEvent_GetCharCode (pEvent);
-	if (lOldCharCode == MIDIEVENT_NOCHARCODE &&
-		g_theMIDIDataLib.m_lDefaultCharCode != MIDIEVENT_NOCHARCODE) {
-		lOldCharCode = g_theMIDIDataLib.m_lDefaultCharCode | 0x10000;
-	}
-	if (lOldCharCode == MIDIEVENT_NOCHARCODELATIN && lCharCode == MIDIEVENT_UTF16LE ||
-		lOldCharCode == MIDIEVENT_NOCHARCODELATIN && lCharCode == MIDIEVENT_UTF16BE ||
-		lOldCharCode == MIDIEVENT_NOCHARCODELATIN && lCharCode == MIDIEVENT_UTF8 ||
-		lOldCharCode == MIDIEVENT_LATIN && lCharCode == MIDIEVENT_UTF16LE ||
-		lOldCharCode == MIDIEVENT_LATIN && lCharCode == MIDIEVENT_UTF16BE ||
-		lOldCharCode == MIDIEVENT_LATIN && lCharCode == MIDIEVENT_UTF8 ||
-		lOldCharCode == MIDIEVENT_NOCHARCODEUTF16LE && lCharCode == MIDIEVENT_LATIN ||
-		lOldCharCode == MIDIEVENT_NOCHARCODEUTF16BE && lCharCode == MIDIEVENT_LATIN ||
-		lOldCharCode == MIDIEVENT_NOCHARCODEUTF8 && lCharCode == MIDIEVENT_LATIN ||
-		lOldCharCode == MIDIEVENT_UTF16LE && lCharCode == MIDIEVENT_LATIN ||
-		lOldCharCode == MIDIEVENT_UTF16BE && lCharCode == MIDIEVENT_LATIN ||
-		lOldCharCode == MIDIEVENT_UTF8 && lCharCode == MIDIEVENT_LATIN) {
-		setlocale (LC_CTYPE, ".1252");
-	}
-	else if (lOldCharCode == MIDIEVENT_NOCHARCODEJP && lCharCode == MIDIEVENT_UTF16LE ||
-		lOldCharCode == MIDIEVENT_NOCHARCODEJP && lCharCode == MIDIEVENT_UTF16BE ||
-		lOldCharCode == MIDIEVENT_NOCHARCODEJP && lCharCode == MIDIEVENT_UTF8 ||
-		lOldCharCode == MIDIEVENT_JP && lCharCode == MIDIEVENT_UTF16LE ||
-		lOldCharCode == MIDIEVENT_JP && lCharCode == MIDIEVENT_UTF16BE ||
-		lOldCharCode == MIDIEVENT_JP && lCharCode == MIDIEVENT_UTF8 ||
-		lOldCharCode == MIDIEVENT_NOCHARCODEUTF16LE && lCharCode == MIDIEVENT_JP ||
-		lOldCharCode == MIDIEVENT_NOCHARCODEUTF16BE && lCharCode == MIDIEVENT_JP ||
-		lOldCharCode == MIDIEVENT_NOCHARCODEUTF8 && lCharCode == MIDIEVENT_JP ||
-		lOldCharCode == MIDIEVENT_UTF16LE && lCharCode == MIDIEVENT_JP ||
-		lOldCharCode == MIDIEVENT_UTF16BE && lCharCode == MIDIEVENT_JP ||
-		lOldCharCode == MIDIEVENT_UTF8 && lCharCode == MIDIEVENT_JP) {
-		setlocale (LC_CTYPE, ".932");
-	}
-	else {
-		char szDefaultLocale[16];
-		memset (szDefaultLocale, 0, sizeof (szDefaultLocale));
-		if (g_theMIDIDataLib.m_lDefaultCharCode == 0) {
-			strncpy_s (szDefaultLocale, sizeof (szDefaultLocale), ".ACP", 4);
-		}
-		else {
-			_snprintf_s (szDefaultLocale, sizeof (szDefaultLocale), 15, ".%d", g_theMIDIDataLib.m_lDefaultCharCode);
-		}
-		setlocale (LC_CTYPE, szDefaultLocale);
+/* テキスト変換用の作業バッファの長さ(20261019追加) */
+/* これ以下の長さのテキストはスタック上で変換し、それを超える場合だけヒープに確保する。 */
+#define MIDIEVENT_TEXTBUFLEN 256
+
+/* CP1252の0x80〜0x9Fに対応するUTF16(未定義の位置はそのままの値とする)(20261019追加) */
+static const unsigned short g_wCP1252Table[32] = {
+	0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+	0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+	0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+	0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+};
+
+/* 文字コードからコードページを取得(20261019追加) */
+/* MIDIEVENT_NOCHARCODEの場合はCP_ACP(0)となる。 */
+static long GetCharCodePage (long lCharCode) {
+	return lCharCode & 0xFFFF;
+}
+
+/* ANSI文字列(GetTextA・SetTextAの引数)のコードページを取得(20261019追加) */
+/* 従来setlocaleに渡していたデフォルトロケール(".ACP"又はデフォルト文字コード)に相当する。 */
+static long GetANSICodePage (MIDIDataContext* pContext) {
+	long lCodePage = pContext->m_lDefaultCharCode & 0xFFFF;
+	if (lCodePage == 1200 || lCodePage == 1201) {
+		return CP_ACP;
 	}
-	/* wcTextとbyTextとbyTextUTF8にテキストを設定 */
-	switch (lOldCharCode) {
-	case MIDIEVENT_NOCHARCODEUTF16LE:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		memcpy (wcText, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (wcstombs (byText, wcText, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (wcstoutf8 (byTextUTF8, wcText, MIDIEVENT_MAXLEN));
-		break;
-	case MIDIEVENT_NOCHARCODEUTF16BE:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		memcpyinv2 (wcText, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (wcstombs (byText, wcText, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (wcstoutf8 (byTextUTF8, wcText, MIDIEVENT_MAXLEN));
-		break;
-	case MIDIEVENT_NOCHARCODEUTF8:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		memcpy (byTextUTF8, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (utf8towcs (wcText, byText, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (wcstombs (byText, wcText, MIDIEVENT_MAXLEN)); 
-		break;
+	return lCodePage;
+}
+
+/* データ部の先頭にある文字コード指定(BOM又は{@LATIN}等)のバイト数を取得(20261019追加) */
+static long GetCharCodeHeaderLen (long lCharCode) {
+	switch (lCharCode) {
 	case MIDIEVENT_LATIN:
-		memcpy (byText, pEvent->m_pData + 8, CLIP (0, pEvent->m_lLen - 8, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (mbstowcs (wcText, byText, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (wcstoutf8 (byTextUTF8, wcText, MIDIEVENT_MAXLEN));
-		break;
+		return 8;
 	case MIDIEVENT_JP:
-		memcpy (byText, pEvent->m_pData + 5, CLIP (0, pEvent->m_lLen - 5, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (mbstowcs (wcText, byText, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (wcstoutf8 (byTextUTF8, wcText, MIDIEVENT_MAXLEN));
-		break;
+		return 5;
 	case MIDIEVENT_UTF16LE:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		memcpy (wcText, pEvent->m_pData + 2, CLIP (0, pEvent->m_lLen - 2, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (wcstombs (byText, wcText, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (wcstoutf8 (byTextUTF8, wcText, MIDIEVENT_MAXLEN));
-		break;
 	case MIDIEVENT_UTF16BE:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		memcpyinv2 (wcText, pEvent->m_pData + 2, CLIP (0, pEvent->m_lLen - 2, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (wcstombs (byText, wcText, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (wcstoutf8 (byTextUTF8, wcText, MIDIEVENT_MAXLEN));
-		break;
+		return 2;
 	case MIDIEVENT_UTF8:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		memcpy (byTextUTF8, pEvent->m_pData + 3, CLIP (0, pEvent->m_lLen - 3, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (utf8towcs (wcText, byTextUTF8, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (wcstombs (byText, wcText, MIDIEVENT_MAXLEN)); 
-		break;
-	default:
-		memcpy (byText, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (mbstowcs (wcText, byText, MIDIEVENT_MAXLEN));
-		lRet = size_ttolong (wcstoutf8 (byTextUTF8, wcText, MIDIEVENT_MAXLEN));
-		break;
+		return 3;
 	}
-	lTextLenA = size_ttolong (strlen (byText));
-	lTextLenW = size_ttolong (wcslen (wcText));
-	lTextLenUTF8 = size_ttolong (strlen (byTextUTF8));
-	/* 目的の文字列をbyDataに作成 */
+	return 0;
+}
+
+/* テキストの先頭にある文字コード指定({@UTF-16LE}等)の文字数を取得(20261019追加) */
+static long GetCharCodePrefixLen (long lCharCode) {
 	switch (lCharCode) {
-	case MIDIEVENT_NOCHARCODEUTF16LE:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		memcpy (byData, wcText, CLIP (0, lTextLenW * sizeof (wchar_t), MIDIEVENT_MAXLEN));
-		lDataLen = size_ttolong (wcslen ((wchar_t*)byData) * sizeof (wchar_t));
-		break;
-	case MIDIEVENT_NOCHARCODEUTF16BE:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		memcpyinv2 (byData, wcText, CLIP (0, lTextLenW * sizeof (wchar_t), MIDIEVENT_MAXLEN));
-		lDataLen = size_ttolong (wcslen ((wchar_t*)byData) * sizeof (wchar_t));
-	case MIDIEVENT_NOCHARCODEUTF8:
-		memcpy (byData, byTextUTF8, CLIP (0, lTextLenUTF8, MIDIEVENT_MAXLEN));
-		lDataLen = size_ttolong (strlen (byData));
-		break;
 	case MIDIEVENT_LATIN:
-		memcpy (byData, "{@LATIN}", 8);
-		memcpy (byData + 8, byText, CLIP (0, lTextLenA, MIDIEVENT_MAXLEN - 8));
-		lDataLen = size_ttolong (strlen (byData));
-		break;
+		return 8;
 	case MIDIEVENT_JP:
-		memcpy (byData, "{@JP}", 5);
-		memcpy (byData + 5, byText, CLIP (0, lTextLenA, MIDIEVENT_MAXLEN - 5));
-		lDataLen = size_ttolong (strlen (byData));
-		break;
+		return 5;
 	case MIDIEVENT_UTF16LE:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		byData[0] = 0xFF;
-		byData[1] = 0xFE;
-		memcpy (byData + 2, wcText, CLIP (0, lTextLenW * sizeof (wchar_t), MIDIEVENT_MAXLEN - 2));
-		lDataLen = size_ttolong (wcslen ((wchar_t*)byData) * sizeof (wchar_t));
-		break;
 	case MIDIEVENT_UTF16BE:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		byData[0] = 0xFE;
-		byData[1] = 0xFF;
-		memcpyinv2 (byData + 2, wcText, CLIP (0, lTextLenW * sizeof (wchar_t), MIDIEVENT_MAXLEN - 2));
-		lDataLen = size_ttolong (wcslen ((wchar_t*)byData) * sizeof (wchar_t));
-		break;
+		return 11;
 	case MIDIEVENT_UTF8:
-		byData[0] = 0xEF;
-		byData[1] = 0xBB;
-		byData[2] = 0xBF;
-		memcpy (byData + 3, byTextUTF8, CLIP (0, lTextLenUTF8, MIDIEVENT_MAXLEN - 3));
-		lDataLen = size_ttolong (strlen (byData));
-		break;
-	default:
-		memcpy (byData, byText, CLIP (0, lTextLenA, MIDIEVENT_MAXLEN));
-		lDataLen = size_ttolong (strlen (byData));
-		break;
+		return 8;
 	}
-	return MIDIEvent_SetData (pEvent, byData, lDataLen);
+	return 0;
 }
 
-/* イベントのテキストを取得(ANSI) */
-char* __stdcall MIDIEvent_GetTextA (MIDIEvent* pEvent, char* pBuf, long lLen) {
-	long lCharCode = 0;
-	long lTextLenA = 0;
-	long lTextLenW = 0;
-	errno_t nErrorNo = 0;
-	size_t llRet = 0;
-	char szDefaultLocale[16];
-	unsigned char byText[MIDIEVENT_MAXLEN + 1];
-	wchar_t wcText[MIDIEVENT_MAXLEN + 1];
-	assert (pEvent);
-	assert (pBuf);
-	assert (lLen > 0);
-	if (pEvent->m_lKind <= 0x00 || pEvent->m_lKind >= 0x1F) {
+/* 作業バッファを確保(lSizeバイトがpBufに収まらない場合はヒープに確保する)(20261019追加) */
+static void* AllocTextBuf (void* pBuf, long lBufSize, long lSize) {
+	if (lSize <= lBufSize) {
+		return pBuf;
+	}
+	return malloc (lSize);
+}
+
+/* 作業バッファを解放(20261019追加) */
+static void FreeTextBuf (void* pBuf, void* pTextBuf) {
+	if (pTextBuf != pBuf) {
+		free (pTextBuf);
+	}
+}
+
+/* 指定コードページのバイト列をUTF16に変換し、変換後の文字数を返す(20261019追加) */
+/* 1252・65001(UTF8)・1200(UTF16LE)・1201(UTF16BE)は内蔵の変換表で、その他(932等)は */
+/* コードページを明示してMultiByteToWideCharで変換する。いずれもロケールに依存しない。 */
+/* 変換はヌル文字の手前までとし、pDestに入りきらない分は切り捨てる。 */
+/* pDestがNULLの場合は必要な文字数だけを返す。 */
+static long TextDecode
+(long lCodePage, const unsigned char* pSrc, long lSrcLen, wchar_t* pDest, long lDestLen) {
+	long lLen = 0;
+	long i = 0;
+	const unsigned char* pEnd = NULL;
+	if (pSrc == NULL || lSrcLen <= 0) {
 		return 0;
 	}
-	memset (pBuf, 0, lLen);
-	memset (wcText, 0, sizeof (wcText));
-	memset (byText, 0, sizeof (byText));
-	memset (szDefaultLocale, 0, sizeof (szDefaultLocale));
-	if (g_theMIDIDataLib.m_lDefaultCharCode == 0) {
-		strncpy_s (szDefaultLocale, sizeof (szDefaultLocale), ".ACP", 4);
+	/* UTF16 */
+	if (lCodePage == 1200 || lCodePage == 1201) {
+		for (i = 0; i + 1 < lSrcLen; i += 2) {
+			unsigned short w = (lCodePage == 1200) ?
+				(unsigned short)(pSrc[i] | (pSrc[i + 1] << 8)) :
+				(unsigned short)((pSrc[i] << 8) | pSrc[i + 1]);
+			if (w == 0) {
+				break;
+			}
+			if (pDest) {
+				if (lLen >= lDestLen) {
+					break;
+				}
+				pDest[lLen] = (wchar_t)w;
+			}
+			lLen++;
+		}
+		return lLen;
 	}
-	else {
-		_snprintf_s (szDefaultLocale, sizeof (szDefaultLocale), 15, ".%d", g_theMIDIDataLib.m_lDefaultCharCode);
+	pEnd = memchr (pSrc, 0, lSrcLen);
+	if (pEnd) {
+		lSrcLen = INT_PTRtolong (pEnd - pSrc);
 	}
-	setlocale (LC_CTYPE, szDefaultLocale);
-	lCharCode = MIDIEvent_GetCharCode (pEvent);
-	if (lCharCode == MIDIEVENT_NOCHARCODE &&
-		g_theMIDIDataLib.m_lDefaultCharCode != MIDIEVENT_NOCHARCODE) {
-		lCharCode = g_theMIDIDataLib.m_lDefaultCharCode | 0x10000;
-	}
-	if (pEvent->m_pData && pEvent->m_lLen > 0) {
-		switch (lCharCode) {
-		case MIDIEVENT_NOCHARCODEUTF16LE:
-			/* Windows Only (wchar_t = 2bytes and little endian) */
-			memcpy (wcText, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MIDIEVENT_MAXLEN));
-			wcstombs (pBuf, wcText, MAX (0, lLen - 1));
-			break;
-		case MIDIEVENT_UTF16LE:
-			/* Windows Only (wchar_t = 2bytes and little endian) */
-			strncpy (pBuf, "{@UTF-16LE}", CLIP (0, lLen - 12, 11));
-			memcpy (wcText, pEvent->m_pData + 2, CLIP (0, pEvent->m_lLen - 2, MIDIEVENT_MAXLEN - 2));
-			wcstombs (pBuf + 11, wcText, MAX (0, lLen - 12));
-			break;
-		case MIDIEVENT_NOCHARCODEUTF16BE:
-			/* Windows Only (wchar_t = 2bytes and little endian) */
-			memcpyinv2 (wcText, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MIDIEVENT_MAXLEN));
-			wcstombs (pBuf, wcText, MAX (0, lLen - 1));
-			break;
-		case MIDIEVENT_UTF16BE:
-			/* Windows Only (wchar_t = 2bytes and little endian) */
-			strncpy (pBuf, "{@UTF-16BE}", CLIP (0, lLen - 12, 11));
-			memcpyinv2 (wcText, pEvent->m_pData + 2, CLIP (0, pEvent->m_lLen - 2, MIDIEVENT_MAXLEN - 2));
-			wcstombs (pBuf + 11, wcText, MAX (0, lLen - 12));
-			break;
-		case MIDIEVENT_NOCHARCODEUTF8:
-			/* Windows Only (wchar_t = 2bytes and little endian) */
-			memcpy (byText, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MIDIEVENT_MAXLEN));
-			utf8towcs (wcText, byText, MIDIEVENT_MAXLEN);
-			wcstombs (pBuf, wcText, MAX (0, lLen - 1));
-		case MIDIEVENT_UTF8:
-			/* Windows Only (wchar_t = 2bytes and little endian) */
-			strncpy (pBuf, "{@UTF-8}", CLIP (0, lLen - 9, 8));
-			memcpy (byText, pEvent->m_pData + 3, CLIP (0, pEvent->m_lLen - 3, MIDIEVENT_MAXLEN));
-			utf8towcs (wcText, byText, MIDIEVENT_MAXLEN);
-			wcstombs (pBuf, wcText, MAX (0, lLen - 9));
-			break;
-		default:
-			memcpy (pBuf, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MAX(0, lLen - 1)));
-			break;
+	/* UTF8(不正なバイト列はU+FFFDとする) */
+	if (lCodePage == 65001) {
+		i = 0;
+		while (i < lSrcLen) {
+			unsigned long c = pSrc[i++];
+			long lTrailNum = 0;
+			long j;
+			if (0xC2 <= c && c <= 0xDF) {
+				lTrailNum = 1;
+				c &= 0x1F;
+			}
+			else if (0xE0 <= c && c <= 0xEF) {
+				lTrailNum = 2;
+				c &= 0x0F;
+			}
+			else if (0xF0 <= c && c <= 0xF4) {
+				lTrailNum = 3;
+				c &= 0x07;
+			}
+			else if (c >= 0x80) {
+				c = 0xFFFD;
+			}
+			for (j = 0; j < lTrailNum; j++) {
+				if (i >= lSrcLen || (pSrc[i] & 0xC0) != 0x80) {
+					c = 0xFFFD;
+					break;
+				}
+				c = (c << 6) | (pSrc[i++] & 0x3F);
+			}
+			/* 冗長な表現・サロゲート・範囲外は不正 */
+			if (lTrailNum == 2 && c < 0x800 || lTrailNum == 3 && (c < 0x10000 || c > 0x10FFFF) ||
+				0xD800 <= c && c <= 0xDFFF) {
+				c = 0xFFFD;
+			}
+			if (c >= 0x10000) {
+				if (pDest) {
+					if (lLen + 2 > lDestLen) {
+						break;
+					}
+					pDest[lLen] = (wchar_t)(0xD800 | ((c - 0x10000) >> 10));
+					pDest[lLen + 1] = (wchar_t)(0xDC00 | ((c - 0x10000) & 0x3FF));
+				}
+				lLen += 2;
+			}
+			else {
+				if (pDest) {
+					if (lLen >= lDestLen) {
+						break;
+					}
+					pDest[lLen] = (wchar_t)c;
+				}
+				lLen++;
+			}
 		}
+		return lLen;
 	}
-	return pBuf;
-}
-
-/* イベントのテキストを取得(UNICODE) */
-wchar_t* __stdcall MIDIEvent_GetTextW (MIDIEvent* pEvent, wchar_t* pBuf, long lLen) {
-	long lCharCode = 0;
-	long lTextLenA = 0;
-	long lTextLenW = 0;
-	errno_t nErrorNo = 0;
-	size_t llRet = 0;
-	unsigned char byText[MIDIEVENT_MAXLEN + 1];
-	wchar_t wcText[MIDIEVENT_MAXLEN + 1];
-	char szDefaultLocale[16];
-	assert (pEvent);
-	assert (pBuf);
-	assert (lLen > 0);
-	if (pEvent->m_lKind <= 0x00 || pEvent->m_lKind >= 0x1F) {
-		return NULL;
+	/* 1252 */
+	if (lCodePage == 1252) {
+		if (pDest) {
+			lSrcLen = MIN (lSrcLen, lDestLen);
+			for (i = 0; i < lSrcLen; i++) {
+				pDest[i] = (0x80 <= pSrc[i] && pSrc[i] <= 0x9F) ?
+					(wchar_t)g_wCP1252Table[pSrc[i] - 0x80] : (wchar_t)pSrc[i];
+			}
+		}
+		return lSrcLen;
 	}
-	memset (pBuf, 0, lLen * sizeof (wchar_t)); 
-	memset (byText, 0, sizeof (byText));
-	memset (wcText, 0, sizeof (wcText));
-	memset (szDefaultLocale, 0, sizeof (szDefaultLocale));
-	if (g_theMIDIDataLib.m_lDefaultCharCode == 0) {
-		strncpy_s (szDefaultLocale, sizeof (szDefaultLocale), ".ACP", 4);
+	/* その他のコードページ */
+	if (lSrcLen <= 0) {
+		return 0;
 	}
-	else {
-		_snprintf_s (szDefaultLocale, sizeof (szDefaultLocale), 15, ".%d", g_theMIDIDataLib.m_lDefaultCharCode);
+	lLen = MultiByteToWideChar (lCodePage, 0, (const char*)pSrc, lSrcLen, NULL, 0);
+	if (pDest == NULL || lLen <= 0) {
+		return MAX (0, lLen);
 	}
-	lCharCode = MIDIEvent_GetCharCode (pEvent);
-	if (lCharCode == MIDIEVENT_NOCHARCODE &&
-		g_theMIDIDataLib.m_lDefaultCharCode != MIDIEVENT_NOCHARCODE) {
-		lCharCode = g_theMIDIDataLib.m_lDefaultCharCode | 0x10000;
-	}
-	if (pEvent->m_pData && pEvent->m_lLen > 0) {
-		switch (lCharCode) {
-		case MIDIEVENT_NOCHARCODELATIN:
-			setlocale (LC_CTYPE, ".1252");
-			memcpy (byText, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MIDIEVENT_MAXLEN));
-			mbstowcs (pBuf, byText, MAX (0, lLen - 1));
-			break;
-		case MIDIEVENT_NOCHARCODEJP:
-			setlocale (LC_CTYPE, ".932");
-			memcpy (byText, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MIDIEVENT_MAXLEN));
-			mbstowcs (pBuf, byText, MAX (0, lLen - 1));
-			break;
-		case MIDIEVENT_NOCHARCODEUTF16LE:
-			/* Windows Only (wchar_t = 2bytes and little endian) */
-			memcpy (pBuf, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MAX (0, lLen * (long)sizeof (wchar_t))));
-			break;
-		case MIDIEVENT_NOCHARCODEUTF16BE:
-			/* Windows Only (wchar_t = 2bytes and little endian) */
-			memcpyinv2 (pBuf, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MAX (0, lLen * (long)sizeof (wchar_t))));
-			break;
-		case MIDIEVENT_NOCHARCODEUTF8:
-			/* Windows Only (wchar_t = 2bytes and little endian) */
-			memcpy (byText, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MIDIEVENT_MAXLEN));
-			utf8towcs (pBuf, byText, MAX (0, lLen - 1));
-			break;
-		case MIDIEVENT_LATIN:
-			setlocale (LC_CTYPE, ".1252");
-			memcpy (byText, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MIDIEVENT_MAXLEN));
-			mbstowcs (pBuf, byText, MAX (0, lLen - 1));
-			break;
-		case MIDIEVENT_JP:
-			setlocale (LC_CTYPE, ".932");
-			memcpy (byText, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MIDIEVENT_MAXLEN));
-			mbstowcs (pBuf, byText, MAX (0, lLen - 1));
-			break;
-		case MIDIEVENT_UTF16LE:
-			/* Windows Only (wchar_t = 2bytes and little endian) */
-			wcsncpy (pBuf, L"{@UTF-16LE}", CLIP (0, lLen - 12, 11));
-			memcpy (pBuf + 11, pEvent->m_pData + 2, CLIP (0, pEvent->m_lLen - 2, MAX (0, (lLen - 1) * (long)sizeof (wchar_t))));
-			break;
-		case MIDIEVENT_UTF16BE:
-			/* Windows Only (wchar_t = 2bytes and little endian) */
-			wcsncpy (pBuf, L"{@UTF-16BE}", CLIP (0, lLen - 12, 11));
-			memcpyinv2 (pBuf + 11, pEvent->m_pData + 2, CLIP (0, pEvent->m_lLen - 2, MAX (0, (lLen - 1) * (long)sizeof (wchar_t))));
-			break;
-		case MIDIEVENT_UTF8:
-			/* Windows Only (wchar_t = 2bytes and little endian) */
-			wcsncpy (pBuf, L"{@UTF-8}", CLIP (0, lLen - 9, 8));
-			memcpy (byText, pEvent->m_pData + 3, CLIP (0, pEvent->m_lLen - 3, MIDIEVENT_MAXLEN));
-			utf8towcs (pBuf + 8, byText, MAX (0, lLen - 9));
-			break;
-		default:
-			setlocale (LC_CTYPE, szDefaultLocale);
-			memcpy (byText, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MIDIEVENT_MAXLEN));
-			mbstowcs (pBuf, byText, MAX(0, lLen - 1));
-			break;
+	if (lLen <= lDestLen) {
+		return MultiByteToWideChar (lCodePage, 0, (const char*)pSrc, lSrcLen, pDest, lDestLen);
+	}
+	else {
+		/* 入りきらない場合は一旦全体を変換してから切り詰める */
+		wchar_t* pTemp = malloc (lLen * sizeof (wchar_t));
+		if (pTemp == NULL) {
+			return 0;
 		}
+		MultiByteToWideChar (lCodePage, 0, (const char*)pSrc, lSrcLen, pTemp, lLen);
+		memcpy (pDest, pTemp, MAX (0, lDestLen) * sizeof (wchar_t));
+		free (pTemp);
+		return MAX (0, lDestLen);
 	}
-	return (wchar_t*)pBuf;
 }
 
-
-/* イベントのテキストを設定(ANSI) */
-long __stdcall MIDIEvent_SetTextA (MIDIEvent* pEvent, const char* pszText) {
-	long lOldCharCode = 0;
-	long lCharCode = 0;
-	long lTextCharCode = 0;
-	long lTextLenA = 0;
-	long lTextLenW = 0;
-	errno_t nErrorNo = 0;
-	size_t llRet = 0;
-	unsigned char byData[MIDIEVENT_MAXLEN + sizeof (wchar_t)];
-	long lDataLen = 0;
-	wchar_t wcText[MIDIEVENT_MAXLEN + 1];
-	char szDefaultLocale[16];
-	assert (pEvent);
-	assert (pszText);
-	if (pEvent->m_lKind <= 0x00 || pEvent->m_lKind >= 0x1F) {
+/* UTF16を指定コードページのバイト列に変換し、変換後のバイト数を返す(20261019追加) */
+/* 変換できない文字は'?'(UTF8の場合はU+FFFD)とする。pDestに入りきらない分は切り捨てる。 */
+/* pDestがNULLの場合は必要なバイト数だけを返す。 */
+static long TextEncode
+(long lCodePage, const wchar_t* pSrc, long lSrcLen, unsigned char* pDest, long lDestLen) {
+	long lLen = 0;
+	long i = 0;
+	if (pSrc == NULL || lSrcLen <= 0) {
 		return 0;
 	}
-	memset (byData, 0, sizeof (byData));
-	memset (wcText, 0, sizeof (wcText));
-	memset (szDefaultLocale, 0, sizeof (szDefaultLocale));
-	if (g_theMIDIDataLib.m_lDefaultCharCode == 0) {
-		strncpy_s (szDefaultLocale, sizeof (szDefaultLocale), ".ACP", 4);
-	}
-	else {
-		_snprintf_s (szDefaultLocale, sizeof (szDefaultLocale), 15, ".%d", g_theMIDIDataLib.m_lDefaultCharCode);
-	}
-	lOldCharCode = MIDIEvent_FindCharCode (pEvent);
-	if (lOldCharCode == MIDIEVENT_NOCHARCODE &&
-		g_theMIDIDataLib.m_lDefaultCharCode != MIDIEVENT_NOCHARCODE) {
-		lOldCharCode = g_theMIDIDataLib.m_lDefaultCharCode | 0x10000;
+	/* UTF16 */
+	if (lCodePage == 1200 || lCodePage == 1201) {
+		for (i = 0; i < lSrcLen; i++) {
+			unsigned short w = (unsigned short)pSrc[i];
+			if (pDest) {
+				if (lLen + 2 > lDestLen) {
+					break;
+				}
+				pDest[lLen + (lCodePage == 1200 ? 0 : 1)] = (unsigned char)(w & 0xFF);
+				pDest[lLen + (lCodePage == 1200 ? 1 : 0)] = (unsigned char)(w >> 8);
+			}
+			lLen += 2;
+		}
+		return lLen;
 	}
-	lTextLenA = size_ttolong (strlen (pszText));
-	lTextCharCode = GetTextCharCodeA (pszText, lTextLenA);
-	if (lTextCharCode == MIDIEVENT_NOCHARCODE) {
-		lCharCode = lOldCharCode;
+	/* UTF8 */
+	if (lCodePage == 65001) {
+		for (i = 0; i < lSrcLen; i++) {
+			unsigned long c = (unsigned short)pSrc[i];
+			unsigned char byBuf[4];
+			long lCharLen = 0;
+			if (0xD800 <= c && c <= 0xDBFF && i + 1 < lSrcLen &&
+				0xDC00 <= (unsigned short)pSrc[i + 1] && (unsigned short)pSrc[i + 1] <= 0xDFFF) {
+				c = 0x10000 + ((c - 0xD800) << 10) + ((unsigned short)pSrc[i + 1] - 0xDC00);
+				i++;
+			}
+			else if (0xD800 <= c && c <= 0xDFFF) {
+				c = 0xFFFD;
+			}
+			if (c < 0x80) {
+				byBuf[0] = (unsigned char)c;
+				lCharLen = 1;
+			}
+			else if (c < 0x800) {
+				byBuf[0] = (unsigned char)(0xC0 | (c >> 6));
+				byBuf[1] = (unsigned char)(0x80 | (c & 0x3F));
+				lCharLen = 2;
+			}
+			else if (c < 0x10000) {
+				byBuf[0] = (unsigned char)(0xE0 | (c >> 12));
+				byBuf[1] = (unsigned char)(0x80 | ((c >> 6) & 0x3F));
+				byBuf[2] = (unsigned char)(0x80 | (c & 0x3F));
+				lCharLen = 3;
+			}
+			else {
+				byBuf[0] = (unsigned char)(0xF0 | (c >> 18));
+				byBuf[1] = (unsigned char)(0x80 | ((c >> 12) & 0x3F));
+				byBuf[2] = (unsigned char)(0x80 | ((c >> 6) & 0x3F));
+				byBuf[3] = (unsigned char)(0x80 | (c & 0x3F));
+				lCharLen = 4;
+			}
+			if (pDest) {
+				if (lLen + lCharLen > lDestLen) {
+					break;
+				}
+				memcpy (pDest + lLen, byBuf, lCharLen);
+			}
+			lLen += lCharLen;
+		}
+		return lLen;
+	}
+	/* 1252 */
+	if (lCodePage == 1252) {
+		if (pDest) {
+			lSrcLen = MIN (lSrcLen, lDestLen);
+			for (i = 0; i < lSrcLen; i++) {
+				unsigned short w = (unsigned short)pSrc[i];
+				unsigned char c = '?';
+				if (w < 0x80 || 0xA0 <= w && w <= 0xFF) {
+					c = (unsigned char)w;
+				}
+				else {
+					long j;
+					for (j = 0; j < 32; j++) {
+						if (g_wCP1252Table[j] == w) {
+							c = (unsigned char)(0x80 + j);
+							break;
+						}
+					}
+				}
+				pDest[i] = c;
+			}
+		}
+		return lSrcLen;
+	}
+	/* その他のコードページ */
+	lLen = WideCharToMultiByte (lCodePage, 0, pSrc, lSrcLen, NULL, 0, NULL, NULL);
+	if (pDest == NULL || lLen <= 0) {
+		return MAX (0, lLen);
+	}
+	if (lLen <= lDestLen) {
+		return WideCharToMultiByte (lCodePage, 0, pSrc, lSrcLen, (char*)pDest, lDestLen, NULL, NULL);
 	}
 	else {
-		lCharCode = lTextCharCode;
+		/* 入りきらない場合は一旦全体を変換してから切り詰める */
+		unsigned char* pTemp = malloc (lLen);
+		if (pTemp == NULL) {
+			return 0;
+		}
+		WideCharToMultiByte (lCodePage, 0, pSrc, lSrcLen, (char*)pTemp, lLen, NULL, NULL);
+		memcpy (pDest, pTemp, MAX (0, lDestLen));
+		free (pTemp);
+		return MAX (0, lDestLen);
 	}
+}
+
+/* データ部の先頭に文字コード指定(BOM又は{@LATIN}等)を書き込む(20261019追加) */
+static void WriteCharCodeHeader (long lCharCode, unsigned char* pDest) {
 	switch (lCharCode) {
-	case MIDIEVENT_NOCHARCODEUTF16LE:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		setlocale (LC_CTYPE, szDefaultLocale);
-		mbstowcs (wcText, pszText, MIDIEVENT_MAXLEN); 
-		lTextLenW = size_ttolong (wcslen (wcText));
-		memcpy (byData, wcText, CLIP (0, lTextLenW * sizeof (wchar_t), MIDIEVENT_MAXLEN));
-		lDataLen = size_ttolong (wcslen ((wchar_t*)byData) * sizeof (wchar_t));
-		break;
-	case MIDIEVENT_NOCHARCODEUTF16BE:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		setlocale (LC_CTYPE, szDefaultLocale);
-		mbstowcs (wcText, pszText, MIDIEVENT_MAXLEN); 
-		lTextLenW = size_ttolong (wcslen (wcText));
-		memcpyinv2 (byData, wcText, CLIP (0, lTextLenW * sizeof (wchar_t), MIDIEVENT_MAXLEN));
-		lDataLen = size_ttolong (wcslen ((wchar_t*)byData) * sizeof (wchar_t));
-		break;
-	case MIDIEVENT_NOCHARCODEUTF8: /* 20191230追加 */
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		setlocale (LC_CTYPE, szDefaultLocale);
-		mbstowcs (wcText, pszText, MIDIEVENT_MAXLEN);
-		lTextLenW = size_ttolong (wcslen (wcText));
-		wcstoutf8 (byData, wcText, MIDIEVENT_MAXLEN);
-		lDataLen = size_ttolong (strlen (byData));
-		break;
 	case MIDIEVENT_LATIN:
-		memcpy (byData, pszText, CLIP (0, lTextLenA, MIDIEVENT_MAXLEN));
-		lDataLen = size_ttolong (strlen (byData));
+		memcpy (pDest, "{@LATIN}", 8);
 		break;
 	case MIDIEVENT_JP:
-		memcpy (byData, pszText, CLIP (0, lTextLenA, MIDIEVENT_MAXLEN));
-		lDataLen = size_ttolong (strlen (byData));
+		memcpy (pDest, "{@JP}", 5);
 		break;
 	case MIDIEVENT_UTF16LE:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		setlocale (LC_CTYPE, szDefaultLocale);
-		byData[0] = 0xFF;
-		byData[1] = 0xFE;
-		mbstowcs (wcText, pszText + 11, MIDIEVENT_MAXLEN); /* 20191230修正 */
-		lTextLenW = size_ttolong (wcslen (wcText));
-		memcpy (byData + 2, wcText, CLIP (0, lTextLenW * sizeof (wchar_t), MIDIEVENT_MAXLEN - 2));
-		lDataLen = size_ttolong (wcslen ((wchar_t*)byData) * sizeof (wchar_t));
+		pDest[0] = 0xFF;
+		pDest[1] = 0xFE;
 		break;
 	case MIDIEVENT_UTF16BE:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		setlocale (LC_CTYPE, szDefaultLocale);
-		byData[0] = 0xFE;
-		byData[1] = 0xFF;
-		mbstowcs (wcText, pszText + 11, MIDIEVENT_MAXLEN); /* 20191230修正 */
-		lTextLenW = size_ttolong (wcslen (wcText));
-		memcpyinv2 (byData + 2, wcText, CLIP (0, lTextLenW * sizeof (wchar_t), MIDIEVENT_MAXLEN - 2));
-		lDataLen = size_ttolong (wcslen ((wchar_t*)byData) * sizeof (wchar_t));
+		pDest[0] = 0xFE;
+		pDest[1] = 0xFF;
+		break;
+	case MIDIEVENT_UTF8:
+		pDest[0] = 0xEF;
+		pDest[1] = 0xBB;
+		pDest[2] = 0xBF;
 		break;
-	case MIDIEVENT_UTF8: /* 20191230追加 */
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		setlocale (LC_CTYPE, szDefaultLocale);
-		byData[0] = 0xEF;
-		byData[1] = 0xBB;
-		byData[2] = 0xBF;
-		mbstowcs (&llRet, pszText + 8, MIDIEVENT_MAXLEN);
-		lTextLenW = size_ttolong (wcslen (wcText));
-		wcstoutf8 (byData + 3, wcText, MIDIEVENT_MAXLEN - 3);
-		lDataLen = size_ttolong (strlen (byData));
+	}
+}
+
+/* UTF16のテキストを、文字コード指定付きのデータ部に変換し、そのバイト数を返す(20261019追加) */
+/* pDestがNULLの場合は必要なバイト数だけを返す。 */
+static long EncodeTextData
+(long lCharCode, const wchar_t* pText, long lTextLen, unsigned char* pDest, long lDestLen) {
+	long lHeaderLen = GetCharCodeHeaderLen (lCharCode);
+	long lCodePage = GetCharCodePage (lCharCode);
+	if (pDest) {
+		if (lDestLen < lHeaderLen) {
+			return 0;
+		}
+		WriteCharCodeHeader (lCharCode, pDest);
+		return lHeaderLen + TextEncode
+			(lCodePage, pText, lTextLen, pDest + lHeaderLen, lDestLen - lHeaderLen);
+	}
+	return lHeaderLen + TextEncode (lCodePage, pText, lTextLen, NULL, 0);
+}
+
+/* UTF16のテキストを文字コード指定付きのデータ部に変換してイベントに設定(20261019追加) */
+static long MIDIEvent_SetTextData (MIDIEvent* pEvent, long lCharCode, const wchar_t* pText, long lTextLen) {
+	unsigned char byBuf[MIDIEVENT_TEXTBUFLEN * 3 + 8];
+	unsigned char* pData = NULL;
+	long lDataLen = 0;
+	long lRet = 0;
+	lDataLen = EncodeTextData (lCharCode, pText, lTextLen, NULL, 0);
+	lDataLen = CLIP (0, lDataLen, MIDIEVENT_MAXLEN - 1);
+	pData = AllocTextBuf (byBuf, sizeof (byBuf), MAX (1, lDataLen));
+	if (pData == NULL) {
+		return 0;
+	}
+	lDataLen = EncodeTextData (lCharCode, pText, lTextLen, pData, lDataLen);
+	lRet = MIDIEvent_SetData (pEvent, pData, lDataLen);
+	FreeTextBuf (byBuf, pData);
+	return lRet;
+}
+
+/* イベントの文字コードを設定(20261019変更:setlocaleを用いずに変換する) */
+long __stdcall MIDIEvent_SetCharCode (MIDIEvent* pEvent, long lCharCode) {
+	return MIDIEvent_SetCharCodeEx (pEvent, lCharCode, NULL);
+}
+
+/* イベントの文字コードを設定(コンテキスト指定)(20261019追加) */
+long __stdcall MIDIEvent_SetCharCodeEx (MIDIEvent* pEvent, long lCharCode, MIDIDataContext* pContext) {
+	long lOldCharCode = 0;
+	long lHeaderLen = 0;
+	long lSrcLen = 0;
+	long lTextLen = 0;
+	long lRet = 0;
+	wchar_t wcBuf[MIDIEVENT_TEXTBUFLEN];
+	wchar_t* pText = NULL;
+	assert (pEvent);
+	if (pEvent->m_lKind <= 0x00 || pEvent->m_lKind >= 0x1F) {
+		return 0;
+	}
+	pContext = GetContext (pContext);
+	lOldCharCode = MIDIEvent_GetCharCode (pEvent);
+	if (lOldCharCode == MIDIEVENT_NOCHARCODE &&
+		pContext->m_lDefaultCharCode != MIDIEVENT_NOCHARCODE) {
+		lOldCharCode = pContext->m_lDefaultCharCode | 0x10000;
+	}
+	lHeaderLen = GetCharCodeHeaderLen (lOldCharCode);
+	if (pEvent->m_pData) {
+		lSrcLen = CLIP (0, pEvent->m_lLen - lHeaderLen, MIDIEVENT_MAXLEN);
+	}
+	/* コードページが変わらない場合は、文字コード指定だけを付け替えて本文はそのまま複写する */
+	if (GetCharCodePage (lOldCharCode) == GetCharCodePage (lCharCode)) {
+		unsigned char byBuf[MIDIEVENT_TEXTBUFLEN];
+		unsigned char* pData = NULL;
+		long lNewHeaderLen = GetCharCodeHeaderLen (lCharCode);
+		long lDataLen = CLIP (0, lNewHeaderLen + lSrcLen, MIDIEVENT_MAXLEN - 1);
+		pData = AllocTextBuf (byBuf, sizeof (byBuf), MAX (1, lDataLen));
+		if (pData == NULL) {
+			return 0;
+		}
+		WriteCharCodeHeader (lCharCode, pData);
+		if (lDataLen > lNewHeaderLen) {
+			memcpy (pData + lNewHeaderLen, pEvent->m_pData + lHeaderLen, lDataLen - lNewHeaderLen);
+		}
+		lRet = MIDIEvent_SetData (pEvent, pData, lDataLen);
+		FreeTextBuf (byBuf, pData);
+		return lRet;
+	}
+	/* 元のテキストをUTF16に変換(変換後の文字数は元のバイト数を超えない) */
+	pText = AllocTextBuf (wcBuf, sizeof (wcBuf), MAX (1, lSrcLen) * (long)sizeof (wchar_t));
+	if (pText == NULL) {
+		return 0;
+	}
+	if (lSrcLen > 0) {
+		lTextLen = TextDecode (GetCharCodePage (lOldCharCode),
+			pEvent->m_pData + lHeaderLen, lSrcLen, pText, lSrcLen);
+	}
+	/* 目的の文字コードのデータ部を作成 */
+	lRet = MIDIEvent_SetTextData (pEvent, lCharCode, pText, lTextLen);
+	FreeTextBuf (wcBuf, pText);
+	return lRet;
+}
+
+/* イベントのテキストを取得(ANSI)(20261019変更:setlocaleを用いずに変換する) */
+char* __stdcall MIDIEvent_GetTextA (MIDIEvent* pEvent, char* pBuf, long lLen) {
+	return MIDIEvent_GetTextExA (pEvent, pBuf, lLen, NULL);
+}
+
+/* イベントのテキストを取得(ANSI)(コンテキスト指定)(20261019追加) */
+char* __stdcall MIDIEvent_GetTextExA (MIDIEvent* pEvent, char* pBuf, long lLen, MIDIDataContext* pContext) {
+	long lCharCode = 0;
+	long lHeaderLen = 0;
+	long lPrefixLen = 0;
+	long lSrcLen = 0;
+	long lTextLen = 0;
+	long lTextLenA = 0;
+	wchar_t wcBuf[MIDIEVENT_TEXTBUFLEN];
+	wchar_t* pText = NULL;
+	assert (pEvent);
+	assert (pBuf);
+	assert (lLen > 0);
+	if (pEvent->m_lKind <= 0x00 || pEvent->m_lKind >= 0x1F) {
+		return 0;
+	}
+	pContext = GetContext (pContext);
+	memset (pBuf, 0, lLen);
+	lCharCode = MIDIEvent_GetCharCode (pEvent);
+	if (lCharCode == MIDIEVENT_NOCHARCODE &&
+		pContext->m_lDefaultCharCode != MIDIEVENT_NOCHARCODE) {
+		lCharCode = pContext->m_lDefaultCharCode | 0x10000;
+	}
+	if (pEvent->m_pData == NULL || pEvent->m_lLen <= 0) {
+		return pBuf;
+	}
+	switch (lCharCode) {
+	case MIDIEVENT_NOCHARCODEUTF16LE:
+	case MIDIEVENT_NOCHARCODEUTF16BE:
+	case MIDIEVENT_NOCHARCODEUTF8:
+	case MIDIEVENT_UTF16LE:
+	case MIDIEVENT_UTF16BE:
+	case MIDIEVENT_UTF8:
+		/* 文字コード指定はBOMの代わりに{@UTF-16LE}等の文字列で表す */
+		lHeaderLen = GetCharCodeHeaderLen (lCharCode);
+		lPrefixLen = GetCharCodePrefixLen (lCharCode);
+		if (lPrefixLen > 0 && lLen - 1 >= lPrefixLen) {
+			memcpy (pBuf, lCharCode == MIDIEVENT_UTF16LE ? "{@UTF-16LE}" :
+				lCharCode == MIDIEVENT_UTF16BE ? "{@UTF-16BE}" : "{@UTF-8}", lPrefixLen);
+		}
+		else {
+			lPrefixLen = 0;
+		}
+		lSrcLen = CLIP (0, pEvent->m_lLen - lHeaderLen, MIDIEVENT_MAXLEN);
+		pText = AllocTextBuf (wcBuf, sizeof (wcBuf), MAX (1, lSrcLen) * (long)sizeof (wchar_t));
+		if (pText == NULL) {
+			return pBuf;
+		}
+		lTextLen = TextDecode (GetCharCodePage (lCharCode),
+			pEvent->m_pData + lHeaderLen, lSrcLen, pText, lSrcLen);
+		lTextLenA = TextEncode (GetANSICodePage (pContext), pText, lTextLen,
+			(unsigned char*)pBuf + lPrefixLen, MAX (0, lLen - 1 - lPrefixLen));
+		pBuf[lPrefixLen + lTextLenA] = 0;
+		FreeTextBuf (wcBuf, pText);
 		break;
 	default:
-		memcpy (byData, pszText, CLIP (0, lTextLenA, MIDIEVENT_MAXLEN));
-		lDataLen = size_ttolong (strlen (byData));
+		memcpy (pBuf, pEvent->m_pData, CLIP (0, pEvent->m_lLen, MAX (0, lLen - 1)));
 		break;
 	}
-	return MIDIEvent_SetData (pEvent, byData, lDataLen);
+	return pBuf;
 }
 
-/* イベントのテキストを設定(UNICODE) */
-long __stdcall MIDIEvent_SetTextW (MIDIEvent* pEvent, const wchar_t* pszText) {
+/* イベントのテキストを取得(UNICODE)(20261019変更:setlocaleを用いずに変換する) */
+wchar_t* __stdcall MIDIEvent_GetTextW (MIDIEvent* pEvent, wchar_t* pBuf, long lLen) {
+	return MIDIEvent_GetTextExW (pEvent, pBuf, lLen, NULL);
+}
+
+/* イベントのテキストを取得(UNICODE)(コンテキスト指定)(20261019追加) */
+wchar_t* __stdcall MIDIEvent_GetTextExW (MIDIEvent* pEvent, wchar_t* pBuf, long lLen, MIDIDataContext* pContext) {
 	long lCharCode = 0;
+	long lCodePage = 0;
+	long lHeaderLen = 0;
+	long lPrefixLen = 0;
+	long lTextLen = 0;
+	assert (pEvent);
+	assert (pBuf);
+	assert (lLen > 0);
+	if (pEvent->m_lKind <= 0x00 || pEvent->m_lKind >= 0x1F) {
+		return NULL;
+	}
+	pContext = GetContext (pContext);
+	memset (pBuf, 0, lLen * sizeof (wchar_t));
+	lCharCode = MIDIEvent_GetCharCode (pEvent);
+	if (lCharCode == MIDIEVENT_NOCHARCODE &&
+		pContext->m_lDefaultCharCode != MIDIEVENT_NOCHARCODE) {
+		lCharCode = pContext->m_lDefaultCharCode | 0x10000;
+	}
+	if (pEvent->m_pData == NULL || pEvent->m_lLen <= 0) {
+		return pBuf;
+	}
+	switch (lCharCode) {
+	case MIDIEVENT_UTF16LE:
+	case MIDIEVENT_UTF16BE:
+	case MIDIEVENT_UTF8:
+		/* 文字コード指定はBOMの代わりに{@UTF-16LE}等の文字列で表す */
+		lCodePage = GetCharCodePage (lCharCode);
+		lHeaderLen = GetCharCodeHeaderLen (lCharCode);
+		lPrefixLen = GetCharCodePrefixLen (lCharCode);
+		if (lLen - 1 >= lPrefixLen) {
+			wcsncpy (pBuf, lCharCode == MIDIEVENT_UTF16LE ? L"{@UTF-16LE}" :
+				lCharCode == MIDIEVENT_UTF16BE ? L"{@UTF-16BE}" : L"{@UTF-8}", lPrefixLen);
+		}
+		else {
+			lPrefixLen = 0;
+		}
+		break;
+	default:
+		/* {@LATIN}・{@JP}はデータ部の文字列のまま返す */
+		lCodePage = GetCharCodePage (lCharCode);
+		break;
+	}
+	lTextLen = TextDecode (lCodePage, pEvent->m_pData + lHeaderLen,
+		CLIP (0, pEvent->m_lLen - lHeaderLen, MIDIEVENT_MAXLEN),
+		pBuf + lPrefixLen, MAX (0, lLen - 1 - lPrefixLen));
+	pBuf[lPrefixLen + lTextLen] = 0;
+	return (wchar_t*)pBuf;
+}
+
+
+/* イベントのテキストを設定(ANSI)(20261019変更:setlocaleを用いずに変換する) */
+long __stdcall MIDIEvent_SetTextA (MIDIEvent* pEvent, const char* pszText) {
+	return MIDIEvent_SetTextExA (pEvent, pszText, NULL);
+}
+
+/* イベントのテキストを設定(ANSI)(コンテキスト指定)(20261019追加) */
+long __stdcall MIDIEvent_SetTextExA (MIDIEvent* pEvent, const char* pszText, MIDIDataContext* pContext) {
 	long lOldCharCode = 0;
+	long lCharCode = 0;
 	long lTextCharCode = 0;
-	long lTextLenW = 0;
-	errno_t nErrorNo = 0;
-	size_t llRet = 0;
-	unsigned char byData[MIDIEVENT_MAXLEN + sizeof (wchar_t)];
-	long lDataLen = 0;
-	char szDefaultLocale[16];
+	long lTextLenA = 0;
+	long lPrefixLen = 0;
+	long lTextLen = 0;
+	long lRet = 0;
+	wchar_t wcBuf[MIDIEVENT_TEXTBUFLEN];
+	wchar_t* pText = NULL;
 	assert (pEvent);
 	assert (pszText);
 	if (pEvent->m_lKind <= 0x00 || pEvent->m_lKind >= 0x1F) {
 		return 0;
 	}
-	memset (byData, 0, sizeof (byData));
-	memset (szDefaultLocale, 0, sizeof (szDefaultLocale));
-	if (g_theMIDIDataLib.m_lDefaultCharCode == 0) {
-		strncpy_s (szDefaultLocale, sizeof (szDefaultLocale), ".ACP", 4);
-	}
-	else {
-		_snprintf_s (szDefaultLocale, sizeof (szDefaultLocale), 15, ".%d", g_theMIDIDataLib.m_lDefaultCharCode);
-	}
+	pContext = GetContext (pContext);
 	lOldCharCode = MIDIEvent_FindCharCode (pEvent);
 	if (lOldCharCode == MIDIEVENT_NOCHARCODE &&
-		g_theMIDIDataLib.m_lDefaultCharCode != MIDIEVENT_NOCHARCODE) {
-		lOldCharCode = g_theMIDIDataLib.m_lDefaultCharCode | 0x10000;
+		pContext->m_lDefaultCharCode != MIDIEVENT_NOCHARCODE) {
+		lOldCharCode = pContext->m_lDefaultCharCode | 0x10000;
 	}
-	lTextLenW = size_ttolong (wcslen (pszText));
-	lTextCharCode = GetTextCharCodeW (pszText, lTextLenW);
+	lTextLenA = size_ttolong (strlen (pszText));
+	lTextCharCode = GetTextCharCodeA (pszText, lTextLenA);
 	if (lTextCharCode == MIDIEVENT_NOCHARCODE) {
 		lCharCode = lOldCharCode;
 	}
@@ -2996,70 +3229,65 @@ long __stdcall MIDIEvent_SetTextW (MIDIEvent* pEvent, const wchar_t* pszText) {
 		lCharCode = lTextCharCode;
 	}
 	switch (lCharCode) {
-	case MIDIEVENT_NOCHARCODELATIN:
-		setlocale (LC_CTYPE, ".1252");
-		wcstombs (byData, pszText, MIDIEVENT_MAXLEN);
-		lDataLen = size_ttolong (strlen (byData));
-		break;
-	case MIDIEVENT_NOCHARCODEJP:
-		setlocale (LC_CTYPE, ".932");
-		wcstombs (byData, pszText, MIDIEVENT_MAXLEN);
-		lDataLen = size_ttolong (strlen (byData));
-		break;
 	case MIDIEVENT_NOCHARCODEUTF16LE:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		memcpy (byData, pszText, CLIP (0, lTextLenW * sizeof (wchar_t), MIDIEVENT_MAXLEN));
-		lDataLen = size_ttolong (wcslen ((wchar_t*)byData) * sizeof (wchar_t));
-		break;
 	case MIDIEVENT_NOCHARCODEUTF16BE:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		memcpyinv2 (byData, (const char*)pszText, CLIP (0, lTextLenW * sizeof (wchar_t), MIDIEVENT_MAXLEN));
-		lDataLen = size_ttolong (wcslen ((wchar_t*)byData) * sizeof (wchar_t));
-		break;
-	case MIDIEVENT_NOCHARCODEUTF8: /* 20191230追加 */
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		wcstoutf8 (byData, pszText, MIDIEVENT_MAXLEN);
-		lDataLen = size_ttolong (strlen (byData));
-		break;
-	case MIDIEVENT_LATIN:
-		setlocale (LC_CTYPE, ".1252");
-		wcstombs (byData, pszText, MIDIEVENT_MAXLEN);
-		lDataLen = size_ttolong (strlen (byData));
-		break;
-	case MIDIEVENT_JP:
-		setlocale (LC_CTYPE, ".932");
-		wcstombs (byData, pszText, MIDIEVENT_MAXLEN);
-		lDataLen = size_ttolong (strlen (byData));
-		break;
+	case MIDIEVENT_NOCHARCODEUTF8:
 	case MIDIEVENT_UTF16LE:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		byData[0] = 0xFF;
-		byData[1] = 0xFE;
-		memcpy (byData + 2, (pszText + 11), CLIP (0, lTextLenW * sizeof (wchar_t), MIDIEVENT_MAXLEN - 2));
-		lDataLen = size_ttolong (wcslen ((wchar_t*)byData) * sizeof (wchar_t));
-		break;
 	case MIDIEVENT_UTF16BE:
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		byData[0] = 0xFE;
-		byData[1] = 0xFF;
-		memcpyinv2 (byData + 2, (const char*)(pszText + 11), CLIP (0, lTextLenW * sizeof (wchar_t), MIDIEVENT_MAXLEN - 2));
-		lDataLen = size_ttolong (wcslen ((wchar_t*)byData) * sizeof (wchar_t));
-		break;
-	case MIDIEVENT_UTF8: /* 20191230追加 */
-		/* Windows Only (wchar_t = 2bytes and little endian) */
-		byData[0] = 0xEF;
-		byData[1] = 0xBB;
-		byData[2] = 0xBF;
-		wcstoutf8 (byData + 3, pszText + 8, MIDIEVENT_MAXLEN - 3);
-		lDataLen = size_ttolong (strlen (byData));
-		break;
+	case MIDIEVENT_UTF8:
+		/* ANSI文字列をUTF16を経由して変換する(文字コード指定の文字列はBOMに置き換える) */
+		lPrefixLen = MIN (GetCharCodePrefixLen (lCharCode), lTextLenA);
+		pText = AllocTextBuf (wcBuf, sizeof (wcBuf),
+			MAX (1, lTextLenA - lPrefixLen) * (long)sizeof (wchar_t));
+		if (pText == NULL) {
+			return 0;
+		}
+		lTextLen = TextDecode (GetANSICodePage (pContext), (const unsigned char*)pszText + lPrefixLen,
+			lTextLenA - lPrefixLen, pText, lTextLenA - lPrefixLen);
+		lRet = MIDIEvent_SetTextData (pEvent, lCharCode, pText, lTextLen);
+		FreeTextBuf (wcBuf, pText);
+		return lRet;
 	default:
-		setlocale (LC_CTYPE, szDefaultLocale);
-		wcstombs (byData, pszText, MIDIEVENT_MAXLEN);
-		lDataLen = size_ttolong (strlen (byData));
-		break;
+		/* {@LATIN}・{@JP}又は文字コード指定なしの場合はそのまま設定する */
+		return MIDIEvent_SetData (pEvent, (unsigned char*)pszText,
+			CLIP (0, lTextLenA, MIDIEVENT_MAXLEN - 1));
+	}
+}
+
+/* イベントのテキストを設定(UNICODE)(20261019変更:setlocaleを用いずに変換する) */
+long __stdcall MIDIEvent_SetTextW (MIDIEvent* pEvent, const wchar_t* pszText) {
+	return MIDIEvent_SetTextExW (pEvent, pszText, NULL);
+}
+
+/* イベントのテキストを設定(UNICODE)(コンテキスト指定)(20261019追加) */
+long __stdcall MIDIEvent_SetTextExW (MIDIEvent* pEvent, const wchar_t* pszText, MIDIDataContext* pContext) {
+	long lCharCode = 0;
+	long lOldCharCode = 0;
+	long lTextCharCode = 0;
+	long lTextLenW = 0;
+	long lPrefixLen = 0;
+	assert (pEvent);
+	assert (pszText);
+	if (pEvent->m_lKind <= 0x00 || pEvent->m_lKind >= 0x1F) {
+		return 0;
+	}
+	pContext = GetContext (pContext);
+	lOldCharCode = MIDIEvent_FindCharCode (pEvent);
+	if (lOldCharCode == MIDIEVENT_NOCHARCODE &&
+		pContext->m_lDefaultCharCode != MIDIEVENT_NOCHARCODE) {
+		lOldCharCode = pContext->m_lDefaultCharCode | 0x10000;
+	}
+	lTextLenW = size_ttolong (wcslen (pszText));
+	lTextCharCode = GetTextCharCodeW (pszText, lTextLenW);
+	if (lTextCharCode == MIDIEVENT_NOCHARCODE) {
+		lCharCode = lOldCharCode;
+	}
+	else {
+		lCharCode = lTextCharCode;
 	}
-	return MIDIEvent_SetData (pEvent, byData, lDataLen);
+	/* 文字コード指定の文字列はデータ部の文字コード指定(BOM又は{@LATIN}等)に置き換える */
+	lPrefixLen = MIN (GetCharCodePrefixLen (lCharCode), lTextLenW);
+	return MIDIEvent_SetTextData (pEvent, lCharCode, pszText + lPrefixLen, lTextLenW - lPrefixLen);
 }
 
 /* SMPTEオフセットの取得(SMPTEオフセットイベントのみ) */
@@ -5522,6 +5750,99 @@ long __stdcall MIDITrack_InsertEvent (MIDITrack* pTrack, MIDIEvent* pEvent) {
 	return lRet;
 }
 
+/* トラックの最後にイベントを追加する(イベントはあらかじめ生成しておく)(20261019追加) */
+/* 末尾にEOTがある場合はその直前に追加し、EOTの時刻を補正する。 */
+/* 挿入位置の探索及び同種イベントの探索を行わないため、追加は定数時間で完了する。 */
+/* pPrevSameKindEventにはトラック内の最後の同種イベント(なければNULL)を渡すこと。 */
+/* pEventの時刻が直前のイベントより前の場合、直前のイベントの時刻に補正する。 */
+/* 追加中のトラックを他のスレッドが参照する場合、そのスレッドは先頭から */
+/* 呼び出し側が公開した最後のイベントまでのm_pNextEventのみを辿ってよい。 */
+long __stdcall MIDITrack_AppendSingleEventForce 
+	(MIDITrack* pTrack, MIDIEvent* pEvent, MIDIEvent* pPrevSameKindEvent) {
+	MIDIEvent* pEndofTrack = NULL;
+	MIDIEvent* pPrevEvent = NULL;
+	MIDIData* pMIDIData = NULL;
+	assert (pTrack);
+	assert (pEvent);
+	/* pEventが浮遊状態であることを確認 */
+	if (pEvent->m_pParent != NULL || pEvent->m_pPrevEvent != NULL || pEvent->m_pNextEvent != NULL) {
+		return 0;
+	}
+	/* エンドオブトラックはこの関数では追加できない */
+	if (pEvent->m_lKind == MIDIEVENT_ENDOFTRACK) {
+		return 0;
+	}
+	/* 同種イベントの整合性チェック */
+	if (pPrevSameKindEvent) {
+		if (pPrevSameKindEvent->m_pParent != pTrack ||
+			pPrevSameKindEvent->m_lKind != pEvent->m_lKind ||
+			pPrevSameKindEvent->m_pNextSameKindEvent != NULL) {
+			assert (0);
+			return 0;
+		}
+	}
+	/* フォーマット1のときの場合のイベントの種類整合性チェック */
+	pMIDIData = MIDITrack_GetParent (pTrack);
+	if (pMIDIData) {
+		if (pMIDIData->m_lFormat == MIDIDATA_FORMAT1) {
+			/* 最初のトラックにMIDIチャンネルイベントの挿入防止 */
+			if (pTrack == pMIDIData->m_pFirstTrack) {
+				if (0x80 <= pEvent->m_lKind && pEvent->m_lKind <= 0xEF) {
+					return 0;	
+				}
+			}
+			/* 2番目以降のトラックにテンポ・SMPTEオフセット・拍子記号・調性記号の挿入防止 */
+			else {
+				if (0x50 <= pEvent->m_lKind && pEvent->m_lKind <= 0x5F) {
+					return 0;
+				}
+			}
+		}
+	}
+	/* 追加位置の決定(末尾のEOTの直前、又はトラックの最後) */
+	pPrevEvent = pTrack->m_pLastEvent;
+	if (pPrevEvent) {
+		if (pPrevEvent->m_lKind == MIDIEVENT_ENDOFTRACK) {
+			pEndofTrack = pPrevEvent;
+			pPrevEvent = pEndofTrack->m_pPrevEvent;
+		}
+	}
+	/* 時刻の整合性がとれていない場合、自動的に追加イベントの時刻を補正する */
+	if (pPrevEvent) {
+		if (pEvent->m_lTime < pPrevEvent->m_lTime) {
+			pEvent->m_lTime = pPrevEvent->m_lTime;
+		}
+	}
+	/* 追加イベントのポインタを全て設定してから前後のイベントにつなぐ */
+	pEvent->m_pParent = pTrack;
+	pEvent->m_pPrevEvent = pPrevEvent;
+	pEvent->m_pNextEvent = pEndofTrack;
+	pEvent->m_pPrevSameKindEvent = pPrevSameKindEvent;
+	pEvent->m_pNextSameKindEvent = NULL;
+	/* EOTの直前に追加する場合、EOTの時刻を補正する */
+	if (pEndofTrack) {
+		if (pEndofTrack->m_lTime < pEvent->m_lTime) {
+			pEndofTrack->m_lTime = pEvent->m_lTime;
+		}
+		pEndofTrack->m_pPrevEvent = pEvent;
+	}
+	else {
+		pTrack->m_pLastEvent = pEvent;
+	}
+	if (pPrevEvent) {
+		pPrevEvent->m_pNextEvent = pEvent;
+	}
+	else {
+		pTrack->m_pFirstEvent = pEvent;
+	}
+	if (pPrevSameKindEvent) {
+		pPrevSameKindEvent->m_pNextSameKindEvent = pEvent;
+	}
+	/* 親トラックのイベント数を1多くする */
+	pTrack->m_lNumEvent ++;
+	return 1;
+}
+
 /* トラックにシーケンス番号イベントを生成して挿入 */
 long __stdcall MIDITrack_InsertSequenceNumber (MIDITrack* pTrack, long lTime, long lNum) { 
 	MIDIEvent* pEvent = MIDIEvent_CreateSequenceNumber (lTime, lNum);
@@ -8256,50 +8577,351 @@ long __stdcall MIDIData_Merge (MIDIData* pMIDIData, MIDIData* pMergeData,
 
 /* 保存・読み込み用関数 */
 
-/* ビッグエンディアンをリトルエンディアンに変換する(4バイト) */
-static unsigned long BigToLittle4 (unsigned char* pData) {
-	return (*pData << 24) | (*(pData + 1) << 16) |
-		(*(pData + 2) << 8) | *(pData + 3);
+/* 読み書き先(ファイル又はメモリ)(非公開)(20261019追加) */
+/* 各形式の読み込み・保存関数は、ファイル名版もメモリ版もこれを通じて読み書きする。 */
+/* 関数の引数と戻り値はfread・fwrite・fgets・fprintf・ftell・fseek・feofに合わせてある。 */
+typedef struct tagMIDIDataStream {
+	FILE* m_pFile;                      /* ファイル(メモリの場合NULL) */
+	unsigned char* m_pData;             /* メモリ */
+	long m_lLen;                        /* メモリ上のデータの長さ[バイト] */
+	long m_lSize;                       /* 確保した長さ[バイト](読み込み用の場合0) */
+	long m_lPos;                        /* 現在の位置[バイト] */
+	long m_bTextMode;                   /* テキストモード(メモリ上の改行を\r\nとして扱う) */
+	long m_bEOF;                        /* 終端を越えて読もうとした */
+	long m_bError;                      /* 書き込みに失敗した */
+} MIDIDataStream;
+
+/* ファイルを開いて読み書き先とする(ANSI)(非公開)(20261019追加) */
+static long MIDIDataStream_OpenFileA (MIDIDataStream* pStream, const char* pszFileName, const char* pszMode) {
+	errno_t nErrorNo = 0;
+	memset (pStream, 0, sizeof (MIDIDataStream));
+	nErrorNo = fopen_s (&(pStream->m_pFile), pszFileName, pszMode);
+	return pStream->m_pFile != NULL;
 }
 
-/* ビッグエンディアンをリトルエンディアンに変換する(2バイト) */
-static unsigned short BigToLittle2 (unsigned char* pData) {
-	return (unsigned short)((*pData << 8) | *(pData + 1));
+/* ファイルを開いて読み書き先とする(UNICODE)(非公開)(20261019追加) */
+static long MIDIDataStream_OpenFileW (MIDIDataStream* pStream, const wchar_t* pszFileName, const wchar_t* pszMode) {
+	errno_t nErrorNo = 0;
+	memset (pStream, 0, sizeof (MIDIDataStream));
+	nErrorNo = _wfopen_s (&(pStream->m_pFile), pszFileName, pszMode);
+	return pStream->m_pFile != NULL;
 }
 
-/* リトルエンディアンをビッグエンディアンに変換する(4バイト) */
-static void LittleToBig4 (long l, unsigned char* pData) {
-	*(pData + 0) = (unsigned char)((l & 0xFF000000) >> 24);
-	*(pData + 1) = (unsigned char)((l & 0x00FF0000) >> 16);
-	*(pData + 2) = (unsigned char)((l & 0x0000FF00) >> 8);
-	*(pData + 3) = (unsigned char)(l & 0x000000FF);
+/* メモリブロックを読み込み元とする(メモリブロックは複写しない)(非公開)(20261019追加) */
+static void MIDIDataStream_OpenMemory
+	(MIDIDataStream* pStream, const void* pData, long lLen, long bTextMode) {
+	memset (pStream, 0, sizeof (MIDIDataStream));
+	pStream->m_pData = (unsigned char*)pData;
+	pStream->m_lLen = CLIP (0, lLen, LONG_MAX);
+	pStream->m_bTextMode = bTextMode;
 }
 
-/* リトルエンディアンをビッグエンディアンに変換する(2バイト) */
-static void LittleToBig2 (short s, unsigned char* pData) {
-	*(pData + 0) = (unsigned char)((s & 0x0000FF00) >> 8);
-	*(pData + 1) = (unsigned char)(s & 0x000000FF);
+/* 伸長可能なメモリブロックを書き込み先とする(非公開)(20261019追加) */
+static void MIDIDataStream_CreateMemory (MIDIDataStream* pStream, long bTextMode) {
+	memset (pStream, 0, sizeof (MIDIDataStream));
+	pStream->m_bTextMode = bTextMode;
 }
 
+/* 読み書き先を閉じる(書き込み用メモリブロックは解放する)(非公開)(20261019追加) */
+static void MIDIDataStream_Close (MIDIDataStream* pStream) {
+	if (pStream->m_pFile) {
+		fclose (pStream->m_pFile);
+	}
+	else if (pStream->m_lSize > 0) {
+		free (pStream->m_pData);
+	}
+	memset (pStream, 0, sizeof (MIDIDataStream));
+}
 
-/* 可変長整数値を4バイトlong型整数値に変換し、読み込んだバイト数を返す。 */
-static long VariableToLong (unsigned char* pData, long* pValue) {
-	uint64_t ullValue = 0; // 20221022 64bit化
-	long i = 0;
-	while (1) {
-		if (*(pData + i) & 0x80) { /* 7ビット目が立っている */
-			ullValue = (ullValue << 7) | (*(pData + i) & 0x7F);
-			ullValue = MIN (ullValue, LONG_MAX); //20221022 リミッタ追加
-			i++;
+/* 書き込んだメモリブロックを呼び出し元に渡す(非公開)(20261019追加) */
+/* 渡したメモリブロックはMIDIDataLib_FreeMemoryで解放すること。戻り値：正常終了=1、異常終了=0。 */
+static long MIDIDataStream_DetachMemory (MIDIDataStream* pStream, void** ppData, long* pLen) {
+	assert (pStream->m_pFile == NULL);
+	if (pStream->m_bError) {
+		MIDIDataStream_Close (pStream);
+		return 0;
+	}
+	*ppData = pStream->m_pData;
+	*pLen = pStream->m_lLen;
+	memset (pStream, 0, sizeof (MIDIDataStream));
+	return 1;
+}
+
+/* 書き込み用メモリブロックにlPos+lSizeバイト以上の長さを確保する(非公開)(20261019追加) */
+static long MIDIDataStream_Reserve (MIDIDataStream* pStream, long lSize) {
+	long lNeedSize;
+	long lNewSize;
+	unsigned char* pNewData;
+	if (lSize > LONG_MAX - pStream->m_lPos) {
+		return 0;
+	}
+	lNeedSize = pStream->m_lPos + lSize;
+	if (lNeedSize <= pStream->m_lSize) {
+		return 1;
+	}
+	if (pStream->m_pData != NULL && pStream->m_lSize == 0) {
+		return 0; /* 読み込み用のメモリブロックには書き込めない */
+	}
+	lNewSize = MAX (pStream->m_lSize, 4096);
+	while (lNewSize < lNeedSize) {
+		lNewSize = (lNewSize > LONG_MAX / 2) ? lNeedSize : lNewSize * 2;
+	}
+	pNewData = realloc (pStream->m_pData, lNewSize);
+	if (pNewData == NULL) {
+		return 0;
+	}
+	pStream->m_pData = pNewData;
+	pStream->m_lSize = lNewSize;
+	return 1;
+}
+
+/* fread相当(読み込んだ項目の数を返す)(非公開)(20261019追加) */
+static size_t MIDIDataStream_Read (void* pBuf, size_t lSize, size_t lCount, MIDIDataStream* pStream) {
+	size_t lRest;
+	size_t lCopyCount;
+	if (pStream->m_pFile) {
+		return fread (pBuf, lSize, lCount, pStream->m_pFile);
+	}
+	if (lSize == 0 || lCount == 0) {
+		return 0;
+	}
+	lRest = (size_t)(pStream->m_lLen - MIN (pStream->m_lPos, pStream->m_lLen));
+	lCopyCount = MIN (lCount, lRest / lSize);
+	memcpy (pBuf, pStream->m_pData + pStream->m_lPos, lCopyCount * lSize);
+	pStream->m_lPos += (long)(lCopyCount * lSize);
+	if (lCopyCount < lCount) {
+		/* freadと同様に、満たない項目の端数も読み進める */
+		lRest -= lCopyCount * lSize;
+		memcpy ((unsigned char*)pBuf + lCopyCount * lSize, pStream->m_pData + pStream->m_lPos, lRest);
+		pStream->m_lPos += (long)lRest;
+		pStream->m_bEOF = 1;
+	}
+	return lCopyCount;
+}
+
+/* 次のlLenバイトを複写せずに指すポインタを返し、その分読み進める(非公開)(20261019追加) */
+/* ファイルの場合及び残りがlLenバイトに満たない場合はNULLを返し、読み進めない。 */
+static unsigned char* MIDIDataStream_Map (MIDIDataStream* pStream, long lLen) {
+	unsigned char* p;
+	if (pStream->m_pFile || lLen < 0 || lLen > pStream->m_lLen - pStream->m_lPos) {
+		return NULL;
+	}
+	p = pStream->m_pData + pStream->m_lPos;
+	pStream->m_lPos += lLen;
+	return p;
+}
+
+/* fwrite相当(書き込んだ項目の数を返す)(非公開)(20261019追加) */
+static size_t MIDIDataStream_Write (const void* pBuf, size_t lSize, size_t lCount, MIDIDataStream* pStream) {
+	const unsigned char* p = (const unsigned char*)pBuf;
+	long lLen;
+	long i;
+	if (pStream->m_pFile) {
+		return fwrite (pBuf, lSize, lCount, pStream->m_pFile);
+	}
+	if (lSize == 0 || lCount == 0) {
+		return 0;
+	}
+	if (lCount > (size_t)LONG_MAX / lSize) {
+		pStream->m_bError = 1;
+		return 0;
+	}
+	lLen = (long)(lSize * lCount);
+	/* テキストモードの場合、\nは\r\nとして書き込む */
+	if (pStream->m_bTextMode) {
+		for (i = 0; i < lLen; i++) {
+			if (!MIDIDataStream_Reserve (pStream, 2)) {
+				pStream->m_bError = 1;
+				return i / lSize;
+			}
+			if (p[i] == '\n') {
+				pStream->m_pData[pStream->m_lPos++] = '\r';
+			}
+			pStream->m_pData[pStream->m_lPos++] = p[i];
+			pStream->m_lLen = MAX (pStream->m_lLen, pStream->m_lPos);
 		}
-		else {
-			ullValue = (ullValue << 7) | (*(pData + i) & 0x7F);
-			ullValue = MIN (ullValue, LONG_MAX); //20221022 リミッタ追加
+		return lCount;
+	}
+	if (!MIDIDataStream_Reserve (pStream, lLen)) {
+		pStream->m_bError = 1;
+		return 0;
+	}
+	/* シークで終端より先に進めていた場合は間を0で埋める */
+	if (pStream->m_lPos > pStream->m_lLen) {
+		memset (pStream->m_pData + pStream->m_lLen, 0, pStream->m_lPos - pStream->m_lLen);
+	}
+	memcpy (pStream->m_pData + pStream->m_lPos, pBuf, lLen);
+	pStream->m_lPos += lLen;
+	pStream->m_lLen = MAX (pStream->m_lLen, pStream->m_lPos);
+	return lCount;
+}
+
+/* fgets相当(読み込めなかった場合NULLを返す)(非公開)(20261019追加) */
+static char* MIDIDataStream_GetLine (char* pBuf, int nLen, MIDIDataStream* pStream) {
+	long i = 0;
+	unsigned char c;
+	if (pStream->m_pFile) {
+		return fgets (pBuf, nLen, pStream->m_pFile);
+	}
+	if (nLen <= 0) {
+		return NULL;
+	}
+	while (i < nLen - 1) {
+		if (pStream->m_lPos >= pStream->m_lLen) {
+			pStream->m_bEOF = 1;
 			break;
 		}
+		c = pStream->m_pData[pStream->m_lPos++];
+		/* テキストモードの場合、\r\nは\nとして読み込む */
+		if (c == '\r' && pStream->m_bTextMode &&
+			pStream->m_lPos < pStream->m_lLen && pStream->m_pData[pStream->m_lPos] == '\n') {
+			continue;
+		}
+		pBuf[i++] = (char)c;
+		if (c == '\n') {
+			break;
+		}
+	}
+	if (i == 0) {
+		return NULL;
+	}
+	pBuf[i] = '\0';
+	return pBuf;
+}
+
+/* fprintf相当(書き込んだ文字数を返す。失敗時負の値)(非公開)(20261019追加) */
+static int MIDIDataStream_Printf (MIDIDataStream* pStream, const char* pszFormat, ...) {
+	va_list vaList;
+	va_list vaCopy;
+	char szBuf[256];
+	char* pszBuf = szBuf;
+	int nLen;
+	va_start (vaList, pszFormat);
+	if (pStream->m_pFile) {
+		nLen = vfprintf (pStream->m_pFile, pszFormat, vaList);
+		va_end (vaList);
+		return nLen;
+	}
+	va_copy (vaCopy, vaList);
+	nLen = vsnprintf (szBuf, sizeof (szBuf), pszFormat, vaList);
+	va_end (vaList);
+	if (nLen >= (int)sizeof (szBuf)) {
+		pszBuf = malloc (nLen + 1);
+		if (pszBuf == NULL) {
+			va_end (vaCopy);
+			pStream->m_bError = 1;
+			return -1;
+		}
+		vsnprintf (pszBuf, nLen + 1, pszFormat, vaCopy);
+	}
+	va_end (vaCopy);
+	if (nLen > 0 && MIDIDataStream_Write (pszBuf, 1, nLen, pStream) < (size_t)nLen) {
+		nLen = -1;
+	}
+	if (pszBuf != szBuf) {
+		free (pszBuf);
+	}
+	return nLen;
+}
+
+/* ftell相当(非公開)(20261019追加) */
+static long MIDIDataStream_Tell (MIDIDataStream* pStream) {
+	if (pStream->m_pFile) {
+		return ftell (pStream->m_pFile);
+	}
+	return pStream->m_lPos;
+}
+
+/* fseek相当(戻り値：正常終了=0、異常終了=0以外)(非公開)(20261019追加) */
+static int MIDIDataStream_Seek (MIDIDataStream* pStream, long lOffset, int nOrigin) {
+	long lBase;
+	if (pStream->m_pFile) {
+		return fseek (pStream->m_pFile, lOffset, nOrigin);
+	}
+	lBase = nOrigin == SEEK_END ? pStream->m_lLen : nOrigin == SEEK_CUR ? pStream->m_lPos : 0;
+	if (lOffset < -lBase || lOffset > LONG_MAX - lBase) {
+		return -1;
+	}
+	pStream->m_lPos = lBase + lOffset;
+	pStream->m_bEOF = 0;
+	return 0;
+}
+
+/* feof相当(非公開)(20261019追加) */
+static int MIDIDataStream_EOF (MIDIDataStream* pStream) {
+	if (pStream->m_pFile) {
+		return feof (pStream->m_pFile);
+	}
+	return pStream->m_bEOF;
+}
+
+/* 現在の位置から終端までの長さ[バイト]を返す(不明な場合LONG_MAX)(非公開)(20261019追加) */
+static long MIDIDataStream_GetRest (MIDIDataStream* pStream) {
+	long lPos = 0;
+	long lEnd = 0;
+	if (pStream->m_pFile == NULL) {
+		return pStream->m_lLen - pStream->m_lPos;
+	}
+	lPos = ftell (pStream->m_pFile);
+	if (lPos < 0 || fseek (pStream->m_pFile, 0, SEEK_END) != 0) {
+		return LONG_MAX;
+	}
+	lEnd = ftell (pStream->m_pFile);
+	if (fseek (pStream->m_pFile, lPos, SEEK_SET) != 0 || lEnd < lPos) {
+		return LONG_MAX;
+	}
+	return lEnd - lPos;
+}
+
+/* MIDIData_SaveAsSMFToSinkの書き出し先関数(非公開)(20261019追加) */
+static long __stdcall MIDIDataStream_WriteProc (void* pParam, const void* pData, long lLen) {
+	return size_ttolong (MIDIDataStream_Write (pData, 1, lLen, (MIDIDataStream*)pParam));
+}
+
+/* ビッグエンディアンをリトルエンディアンに変換する(4バイト) */
+static unsigned long BigToLittle4 (unsigned char* pData) {
+	return ((unsigned long)*pData << 24) | ((unsigned long)*(pData + 1) << 16) |
+		((unsigned long)*(pData + 2) << 8) | (unsigned long)*(pData + 3); /* 20261019キャスト追加 */
+}
+
+/* ビッグエンディアンをリトルエンディアンに変換する(2バイト) */
+static unsigned short BigToLittle2 (unsigned char* pData) {
+	return (unsigned short)((*pData << 8) | *(pData + 1));
+}
+
+/* リトルエンディアンをビッグエンディアンに変換する(4バイト) */
+static void LittleToBig4 (long l, unsigned char* pData) {
+	*(pData + 0) = (unsigned char)((l & 0xFF000000) >> 24);
+	*(pData + 1) = (unsigned char)((l & 0x00FF0000) >> 16);
+	*(pData + 2) = (unsigned char)((l & 0x0000FF00) >> 8);
+	*(pData + 3) = (unsigned char)(l & 0x000000FF);
+}
+
+/* リトルエンディアンをビッグエンディアンに変換する(2バイト) */
+static void LittleToBig2 (short s, unsigned char* pData) {
+	*(pData + 0) = (unsigned char)((s & 0x0000FF00) >> 8);
+	*(pData + 1) = (unsigned char)(s & 0x000000FF);
+}
+
+
+/* 可変長整数値を4バイトlong型整数値に変換し、読み込んだバイト数を返す。 */
+/* pEndに達しても可変長整数値が終わらない場合は0を返す(20261019範囲検査追加)。 */
+static long VariableToLong (unsigned char* pData, unsigned char* pEnd, long* pValue) {
+	uint64_t ullValue = 0;
+	long i = 0;
+	/* 1バイトで済む場合(デルタタイムの大半)は検査1回で返す */
+	if (pData < pEnd && *pData < 0x80) {
+		*pValue = *pData;
+		return 1;
+	}
+	for (i = 0; pData + i < pEnd; i++) {
+		ullValue = MIN ((ullValue << 7) | (*(pData + i) & 0x7F), LONG_MAX);
+		if (*(pData + i) < 0x80) {
+			*pValue = (long)ullValue;
+			return i + 1;
+		}
 	}
-	*pValue = (long)MIN (ullValue, LONG_MAX); //20221022 リミッタ追加
-	return i + 1;
+	return 0;
 }
 
 /* 4バイトlong型整数値を可変長整数値に変換し、書き込んだバイト数を返す(最大5バイト)。 */
@@ -8383,49 +9005,92 @@ long __stdcall MIDITrack_AddSingleEventForce (MIDITrack* pTrack, MIDIEvent* pIns
 	return 1;
 }
 
-/* MIDITrackをSMFのメモリブロックから読み込み(非公開) */
-MIDITrack* __stdcall MIDITrack_LoadFromSMF (unsigned char* pTrackData, long lTrackLen) {
+/* MIDITrackをSMFのメモリブロックから読み込み(読み込みオプション指定)(非公開)(20261019追加) */
+/* 可変長整数値・メタイベント及びSysExの長さ・MIDIイベントのデータはすべてチャンクの終端と比較し、 */
+/* チャンクの外は決して読まない。チャンクの途中で途切れたイベントは、厳格な読み込みの場合は失敗とし、 */
+/* そうでない場合はそこまでのイベントだけを読み込む。 */
+MIDITrack* __stdcall MIDITrack_LoadFromSMFEx (unsigned char* pTrackData, long lTrackLen, long lLoadFlags) {
 
 	unsigned char* p = NULL;
+	unsigned char* pEnd = NULL;
 	long lLen = 0;
+	long lRead = 0;
 	long lDeltaTime = 0;
 	int64_t llTickCount = 0;
 	unsigned char byEventKind = 0;
-	unsigned char byMetaKind = 0; 
+	unsigned char byMetaKind = 0;
 	unsigned char byOldEventKind = 0;
 	MIDITrack* pTrack = NULL;
 	MIDIEvent* pEvent = NULL;
 
+	if (pTrackData == NULL || lTrackLen < 0) {
+		return NULL;
+	}
 	p = pTrackData;
+	pEnd = pTrackData + lTrackLen;
 
 	pTrack = MIDITrack_Create ();
 	if (pTrack == NULL) {
 		return NULL;
 	}
 
-	while (p < pTrackData + lTrackLen) {
-		p += VariableToLong (p, &lDeltaTime);
+	while (p < pEnd) {
+		pEvent = NULL;
+		lRead = VariableToLong (p, pEnd, &lDeltaTime);
+		if (lRead == 0 || lRead >= pEnd - p) { /* デルタタイムの後にステータスが無い */
+			break;
+		}
+		p += lRead;
 		llTickCount += lDeltaTime;
 		llTickCount = CLIP (0, llTickCount, LONG_MAX); // 20221022 リミッタ追加
 		byEventKind = *p;
 		/* メタイベントの場合 */
 		if (byEventKind == 0xFF) {
+			if (pEnd - p < 3) { /* 0xFF・種類・長さ(1バイト以上) */
+				break;
+			}
 			p ++; /* イベントタイプ(0xFF)を読み飛ばす */
 			byMetaKind = (*p++);
-			p += VariableToLong (p, &lLen);
-			pEvent = MIDIEvent_Create ((long)llTickCount, byMetaKind, p, lLen);
+			lRead = VariableToLong (p, pEnd, &lLen);
+			if (lRead == 0 || lLen > pEnd - p - lRead) {
+				break;
+			}
+			p += lRead;
+			/* 種類が0x80以上のメタイベントはMIDIイベント等と区別できないので読み飛ばす(20261019追加) */
+			if (byMetaKind >= 0x80) {
+				if (lLoadFlags & MIDIDATACONTEXT_STRICT) {
+					MIDITrack_Delete (pTrack);
+					return NULL;
+				}
+				p += lLen;
+				continue;
+			}
+			/* 長さ0でチャンクの終端に接する場合、MIDIEvent_Createがチャンクの外を見ないようにする */
+			pEvent = MIDIEvent_Create ((long)llTickCount, byMetaKind, p < pEnd ? p : NULL, lLen);
 			p += lLen;
 		}
 		/* システムエクスクルーシブイベントの場合 */
 		else if (byEventKind == 0xF0 || byEventKind == 0xF7) {
+			if (pEnd - p < 2) { /* 0xF0又は0xF7・長さ(1バイト以上) */
+				break;
+			}
 			p ++; /* イベントタイプ(0xF0||0xF7)を読み飛ばす */
-			p += VariableToLong (p, &lLen);
-			pEvent = MIDIEvent_Create ((long)llTickCount, byEventKind, p, lLen);
+			lRead = VariableToLong (p, pEnd, &lLen);
+			if (lRead == 0 || lLen > pEnd - p - lRead) {
+				break;
+			}
+			p += lRead;
+			pEvent = MIDIEvent_Create ((long)llTickCount, byEventKind, p < pEnd ? p : NULL, lLen); /* 同上 */
 			p += lLen;
 		}
 		/* MIDIイベントの場合 */
 		else if (0x00 <= byEventKind && byEventKind <= 0xEF) {
 			if (0x00 <= byEventKind && byEventKind <= 0x7F) { /* ランニングステータス */
+				/* 省略されたステータスが不明な場合(20261019追加) */
+				if (byOldEventKind == 0 && (lLoadFlags & MIDIDATACONTEXT_STRICT)) {
+					MIDITrack_Delete (pTrack);
+					return NULL;
+				}
 				byEventKind = byOldEventKind;
 				lLen = 2;
 			}
@@ -8435,16 +9100,38 @@ MIDITrack* __stdcall MIDITrack_LoadFromSMF (unsigned char* pTrackData, long lTra
 			if (0xC0 <= byEventKind && byEventKind <= 0xDF) {
 				lLen --;
 			}
+			if (lLen > pEnd - p) {
+				break;
+			}
 			pEvent = MIDIEvent_Create ((long)llTickCount, byEventKind, p, lLen);
 			p += lLen;
 			byOldEventKind = byEventKind;
 		}
-		if (pEvent == NULL) {
-			;
+		/* SMFに現れないステータス(0xF1〜0xF6,0xF8〜0xFE)の場合は読み飛ばす(20261019追加) */
+		else {
+			if (lLoadFlags & MIDIDATACONTEXT_STRICT) {
+				MIDITrack_Delete (pTrack);
+				return NULL;
+			}
+			p ++;
+			continue;
+		}
+		if (pEvent == NULL) { /* 20261019処理追加 */
+			MIDITrack_Delete (pTrack);
+			return NULL;
 		}
 		MIDITrack_AddSingleEventForce (pTrack, pEvent); // 20090712追加
 	}
 
+	/* 最後のイベントがチャンクの途中で途切れている場合とEOTで終わらない場合(20261019追加) */
+	if (lLoadFlags & MIDIDATACONTEXT_STRICT) {
+		if (p != pEnd || pTrack->m_pLastEvent == NULL ||
+			!MIDIEvent_IsEndofTrack (pTrack->m_pLastEvent)) {
+			MIDITrack_Delete (pTrack);
+			return NULL;
+		}
+	}
+
 	/* 結合できるイベントは結合する(廃止) */
 	/*forEachEvent (pTrack, pEvent) {
 		MIDIEvent_Combine (pEvent);
@@ -8453,14 +9140,17 @@ MIDITrack* __stdcall MIDITrack_LoadFromSMF (unsigned char* pTrackData, long lTra
 	return pTrack;
 }
 
-/* MIDIDataをスタンダードMIDIファイル(*.mid)から読み込み、 */
-/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(ANSI) */
-/* 戻り値：正常終了=1、異常終了=0。 */
-MIDIData* __stdcall MIDIData_LoadFromSMFA (const char* pszFileName) {
+/* MIDITrackをSMFのメモリブロックから読み込み(非公開) */
+MIDITrack* __stdcall MIDITrack_LoadFromSMF (unsigned char* pTrackData, long lTrackLen) {
+	return MIDITrack_LoadFromSMFEx (pTrackData, lTrackLen, 0);
+}
+
+/* MIDIDataをスタンダードMIDIファイル(*.mid)の読み込み元から読み込み、 */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(非公開)(20261019追加) */
+/* 読み込み元は呼び出し側で閉じること。 */
+static MIDIData* MIDIData_LoadFromSMFStream (MIDIDataStream* pStream, MIDIDataContext* pContext) {
 	MIDIData* pMIDIData = NULL;
 	MIDITrack* pTrack = NULL;
-	FILE* pFile = NULL;
-	errno_t nErrorNo = 0;
 	long lTrackLen = 0;
 	unsigned long lFormat = 0;
 	unsigned long lNumTrack = 0;
@@ -8469,33 +9159,25 @@ MIDIData* __stdcall MIDIData_LoadFromSMFA (const char* pszFileName) {
 	unsigned long lTimeResolution = 0;
 	unsigned long i = 0;
 	unsigned char* pTrackData = NULL;
+	unsigned char* pMappedData = NULL;
 	unsigned char byBuf[256];
 
-	nErrorNo = fopen_s (&pFile, pszFileName, "rb");
-	if (pFile == NULL) {
-		return NULL;
-	}
-	if (fread (byBuf, sizeof(char), 14, pFile) < 14) {
-		fclose (pFile);
+	if (MIDIDataStream_Read (byBuf, sizeof(char), 14, pStream) < 14) {
 		return NULL;
 	}
 	if (memcmp (byBuf, "MThd", 4) != 0) {
-		fclose (pFile);
-		return NULL; 
+		return NULL;
 	}
 	lFormat = (long)BigToLittle2 (byBuf + 8);
 	lNumTrack = (long)BigToLittle2 (byBuf + 10);
 	lTimeBase = (long)BigToLittle2 (byBuf + 12);
 	if (lFormat < 0 || lFormat > 2) {
-		fclose (pFile);
 		return NULL;
 	}
 	if (lNumTrack < 0 || lNumTrack > MIDIDATA_MAXMIDITRACKNUM) {
-		fclose (pFile);
 		return NULL;
 	}
 	if (lTimeBase < 0 || lTimeBase > 65535) {
-		fclose (pFile);
 		return NULL;
 	}
 	if (lTimeBase & 0x00008000) {
@@ -8504,7 +9186,6 @@ MIDIData* __stdcall MIDIData_LoadFromSMFA (const char* pszFileName) {
 			lTimeMode != MIDIDATA_SMPTE25BASE &&
 			lTimeMode != MIDIDATA_SMPTE29BASE &&
 			lTimeMode != MIDIDATA_SMPTE30BASE) {
-			fclose (pFile);
 			return NULL;
 		}
 		lTimeResolution = lTimeBase & 0x00FF;
@@ -8516,21 +9197,19 @@ MIDIData* __stdcall MIDIData_LoadFromSMFA (const char* pszFileName) {
 
 	pMIDIData = MIDIData_Create (lFormat, 0, lTimeMode, lTimeResolution);
 	if (pMIDIData == NULL) {
-		fclose (pFile);
 		return NULL;
 	}
 
-	while (!feof (pFile)) {
+	while (!MIDIDataStream_EOF (pStream)) {
 
-		if (fread (byBuf, sizeof(char), 8, pFile) < 8) {
+		if (MIDIDataStream_Read (byBuf, sizeof(char), 8, pStream) < 8) {
 			break;
 		}
 		if ((memcmp (byBuf, "MTrk", 4) != 0 && i < lNumTrack) &&
 			!(memcmp (byBuf, "XFIH", 4) == 0 && lFormat == 0 && i == 1) &&
 			!(memcmp (byBuf, "XFKM", 4) == 0 && lFormat == 0 && i == 2)) {
 			MIDIData_Delete (pMIDIData);
-			fclose (pFile); /* This is not MIDITrack. */
-			return NULL;
+			return NULL; /* This is not MIDITrack. */
 		}
 		else if ((memcmp (byBuf, "MTrk", 4) != 0 && i >= lNumTrack) &&
 			!(memcmp (byBuf, "XFIH", 4) == 0 && lFormat == 0 && i == 1) &&
@@ -8538,41 +9217,56 @@ MIDIData* __stdcall MIDIData_LoadFromSMFA (const char* pszFileName) {
 			break;
 		}
 		lTrackLen = (long)BigToLittle4 (byBuf + 4);
-		pTrackData = malloc (lTrackLen);
-		if (pTrackData == NULL) {
+		/* 残りのデータより長いトラック長の場合、その長さを確保する前に失敗とする(20261019追加) */
+		if (lTrackLen < 0 || lTrackLen > MIDIDataStream_GetRest (pStream)) {
 			MIDIData_Delete (pMIDIData);
-			fclose (pFile); /* Out of Memory for TrackData. */
 			return NULL;
 		}
-		if (fread (pTrackData, sizeof (char), 
-			lTrackLen, pFile) < (unsigned long)lTrackLen) {
-			MIDIData_Delete (pMIDIData);
-			fclose (pFile); /* There is too few TrackData. */
-			free (pTrackData);
-			return NULL;
+		/* メモリブロックから読み込む場合はトラックデータを複写しない(20261019追加) */
+		pMappedData = MIDIDataStream_Map (pStream, lTrackLen);
+		if (pMappedData) {
+			pTrack = MIDITrack_LoadFromSMFEx (pMappedData, lTrackLen, pContext->m_lLoadFlags);
+		}
+		else {
+			pTrackData = MIDIDataContext_Alloc (pContext, lTrackLen);
+			if (pTrackData == NULL) {
+				MIDIData_Delete (pMIDIData);
+				return NULL; /* Out of Memory for TrackData. */
+			}
+			if (MIDIDataStream_Read (pTrackData, sizeof (char),
+				lTrackLen, pStream) < (unsigned long)lTrackLen) {
+				MIDIData_Delete (pMIDIData);
+				MIDIDataContext_Free (pContext, pTrackData);
+				return NULL; /* There is too few TrackData. */
+			}
+			pTrack = MIDITrack_LoadFromSMFEx (pTrackData, lTrackLen, pContext->m_lLoadFlags);
+			MIDIDataContext_Free (pContext, pTrackData);
+			pTrackData = NULL;
 		}
-
-		pTrack = MIDITrack_LoadFromSMF (pTrackData, lTrackLen);
 		if (pTrack == NULL) {
 			MIDIData_Delete (pMIDIData);
-			fclose (pFile);
 			return NULL;
 		}
-		
+
 		MIDIData_AddTrackForce (pMIDIData, pTrack);
-	
-		free (pTrackData);
-		pTrackData = NULL;
 		i++;
 	}
 
+	/* 厳格な読み込みの場合、MThdに記載のトラック数に満たないファイルは不正とする(20261019追加) */
+	if ((pContext->m_lLoadFlags & MIDIDATACONTEXT_STRICT) && i < lNumTrack) {
+		MIDIData_Delete (pMIDIData);
+		return NULL;
+	}
+
 	pMIDIData->m_lNumTrack = i;
 	assert (pMIDIData->m_lTimeBase == lTimeBase);
 
 	/* 各トラックの出力ポート番号・出力チャンネル・表示モードの自動設定 */
-	MIDIData_UpdateOutputPort (pMIDIData);
-	MIDIData_UpdateOutputChannel (pMIDIData);
-	MIDIData_UpdateViewMode (pMIDIData);
+	if (!(pContext->m_lLoadFlags & MIDIDATACONTEXT_NOAUTOSETTING)) { /* 20261019条件式追加 */
+		MIDIData_UpdateOutputPort (pMIDIData);
+		MIDIData_UpdateOutputChannel (pMIDIData);
+		MIDIData_UpdateViewMode (pMIDIData);
+	}
 
 	/* 各トラックの入力ポート番号・入力チャンネルの設定 */
 	forEachTrack (pMIDIData, pTrack) {
@@ -8581,149 +9275,133 @@ MIDIData* __stdcall MIDIData_LoadFromSMFA (const char* pszFileName) {
 		pTrack->m_lInputChannel = pTrack->m_lOutputChannel;
 		pTrack->m_lOutputOn = 1;
 	}
-	
-	fclose (pFile);
-	pFile = NULL;
 
 	return pMIDIData;
-
 }
 
+/* MIDIDataをスタンダードMIDIファイル(*.mid)から読み込み、 */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(ANSI) */
+/* 戻り値：正常終了=1、異常終了=0。 */
+MIDIData* __stdcall MIDIData_LoadFromSMFA (const char* pszFileName) {
+	return MIDIData_LoadFromSMFExA (pszFileName, NULL);
+}
 
 /* MIDIDataをスタンダードMIDIファイル(*.mid)から読み込み、 */
 /* 新しいMIDIデータへのポインタを返す(失敗時NULL)(UNICODE) */
 /* ファイル名はUNICODEで与えるがファイルの中身は仕様に基づきANSIである。 */
 MIDIData* __stdcall MIDIData_LoadFromSMFW (const wchar_t* pszFileName) {
-	MIDIData* pMIDIData = NULL;
-	MIDITrack* pTrack = NULL;
-	FILE* pFile = NULL;
-	errno_t nErrorNo = 0;
-	long lTrackLen = 0;
-	unsigned long lFormat = 0;
-	unsigned long lNumTrack = 0;
-	unsigned long lTimeBase = 0;
-	unsigned long lTimeMode = 0;
-	unsigned long lTimeResolution = 0;
-	unsigned long i = 0;
-	unsigned char* pTrackData = NULL;
-	unsigned char byBuf[256];
+	return MIDIData_LoadFromSMFExW (pszFileName, NULL);
+}
 
-	nErrorNo = _wfopen_s (&pFile, pszFileName, L"rb");
-	if (pFile == NULL) {
+/* MIDIDataをスタンダードMIDIファイル(*.mid)から読み込み、 */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(コンテキスト指定)(ANSI)(20261019追加) */
+MIDIData* __stdcall MIDIData_LoadFromSMFExA (const char* pszFileName, MIDIDataContext* pContext) {
+	MIDIDataStream theStream;
+	MIDIData* pMIDIData = NULL;
+	if (MIDIDataStream_OpenFileA (&theStream, pszFileName, "rb") == 0) {
 		return NULL;
 	}
-	if (fread (byBuf, sizeof(char), 14, pFile) < 14) {
-		fclose (pFile);
+	pMIDIData = MIDIData_LoadFromSMFStream (&theStream, GetContext (pContext));
+	MIDIDataStream_Close (&theStream);
+	return pMIDIData;
+}
+
+/* MIDIDataをスタンダードMIDIファイル(*.mid)から読み込み、 */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(コンテキスト指定)(UNICODE)(20261019追加) */
+MIDIData* __stdcall MIDIData_LoadFromSMFExW (const wchar_t* pszFileName, MIDIDataContext* pContext) {
+	MIDIDataStream theStream;
+	MIDIData* pMIDIData = NULL;
+	if (MIDIDataStream_OpenFileW (&theStream, pszFileName, L"rb") == 0) {
 		return NULL;
 	}
-	if (memcmp (byBuf, "MThd", 4) != 0) {
-		fclose (pFile);
-		return NULL; 
-	}
-	lFormat = (long)BigToLittle2 (byBuf + 8);
-	lNumTrack = (long)BigToLittle2 (byBuf + 10);
-	lTimeBase = (long)BigToLittle2 (byBuf + 12);
-	if (lFormat < 0 || lFormat > 2) {
-		fclose (pFile);
+	pMIDIData = MIDIData_LoadFromSMFStream (&theStream, GetContext (pContext));
+	MIDIDataStream_Close (&theStream);
+	return pMIDIData;
+}
+
+/* MIDIDataをスタンダードMIDIファイル(*.mid)のメモリブロックから読み込み、 */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(20261019追加) */
+MIDIData* __stdcall MIDIData_LoadFromSMFMemory (const void* pData, long lLen) {
+	return MIDIData_LoadFromSMFMemoryEx (pData, lLen, NULL);
+}
+
+/* MIDIDataをスタンダードMIDIファイル(*.mid)のメモリブロックから読み込み、 */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(コンテキスト指定)(20261019追加) */
+/* トラックデータは複写せずにメモリブロック上で直接解釈する。 */
+MIDIData* __stdcall MIDIData_LoadFromSMFMemoryEx (const void* pData, long lLen, MIDIDataContext* pContext) {
+	MIDIDataStream theStream;
+	/* 引数の検査 */
+	if (pData == NULL || lLen < 0) {
 		return NULL;
 	}
-	if (lNumTrack < 0 || lNumTrack > MIDIDATA_MAXMIDITRACKNUM) {
-		fclose (pFile);
-		return NULL;
+	MIDIDataStream_OpenMemory (&theStream, pData, lLen, 0);
+	return MIDIData_LoadFromSMFStream (&theStream, GetContext (pContext));
+}
+
+/* MIDIEventをSMFとして保存したときの最大長(デルタタイム5+ステータス2+データ長5+データ)(20261019追加) */
+#define MIDIEVENT_SMFMAXHEADERLEN 12
+
+/* MIDIEventをSMFとしてメモリブロック上に保存し、書き込んだバイト数を返す(非公開)(20261019追加) */
+/* pRunningStatusは直前に保存したイベントのステータス(ランニングステータスの判定用)。 */
+static long MIDIEvent_SaveAsSMF (MIDIEvent* pEvent, unsigned char* pBuf, unsigned char* pRunningStatus) {
+	long lDeltaTime;
+	unsigned char* p = pBuf;
+	/* デルタタイム保存 */
+	if (pEvent->m_pPrevEvent) {
+		lDeltaTime = pEvent->m_lTime - pEvent->m_pPrevEvent->m_lTime;
 	}
-	if (lTimeBase < 0 || lTimeBase > 65535) {
-		fclose (pFile);
-		return NULL;
+	/* 20081031:先頭空白は削除しない */
+	else {
+		lDeltaTime = pEvent->m_lTime;
+	}
+	p += LongToVariable (lDeltaTime, p);
+	/* メタイベント */
+	if (0x00 <= pEvent->m_lKind && pEvent->m_lKind < 0x80) {
+		*p++ = 0xFF;
+		*p++ = (unsigned char)(pEvent->m_lKind);
+		p += LongToVariable (pEvent->m_lLen, p);
+		if (pEvent->m_pData && pEvent->m_lLen > 0) { /* 20091024条件式追加 */
+			memcpy (p, pEvent->m_pData, pEvent->m_lLen);
+		}
+		p += pEvent->m_lLen;
+		*pRunningStatus = 0xFF;
+	}
+	/* MIDIチャンネルイベント */
+	else if (0x80 <= pEvent->m_lKind && pEvent->m_lKind <= 0xEF) {
+		/* ランニングステータス使用可能(2バイト目以降保存) */
+		if (*pRunningStatus == *(pEvent->m_pData)) {
+			memcpy (p, pEvent->m_pData + 1, pEvent->m_lLen - 1);
+			p += pEvent->m_lLen - 1;
+		}
+		/* ランニングステータス使用不能(全バイト保存) */
+		else {
+			memcpy (p, pEvent->m_pData, pEvent->m_lLen);
+			p += pEvent->m_lLen;
+		}
+		*pRunningStatus = *(pEvent->m_pData);
 	}
-	if (lTimeBase & 0x00008000) {
-		lTimeMode = 256 - ((lTimeBase & 0x0000FF00) >> 8);
-		if (lTimeMode != MIDIDATA_SMPTE24BASE &&
-			lTimeMode != MIDIDATA_SMPTE25BASE &&
-			lTimeMode != MIDIDATA_SMPTE29BASE &&
-			lTimeMode != MIDIDATA_SMPTE30BASE) {
-			fclose (pFile);
-			return NULL;
+	/* Sysxイベント */
+	else if (pEvent->m_lKind == 0xF0) {
+		*p++ = (unsigned char)0xF0;
+		p += LongToVariable (pEvent->m_lLen - 1, p);
+		if (pEvent->m_pData != NULL && pEvent->m_lLen > 1) { /* 20091024条件式追加 */
+			memcpy (p, pEvent->m_pData + 1, pEvent->m_lLen - 1);
 		}
-		lTimeResolution = lTimeBase & 0x00FF;
+		p += pEvent->m_lLen - 1;
+		*pRunningStatus = 0xF0;
 	}
-	else {
-		lTimeMode = MIDIDATA_TPQNBASE;
-		lTimeResolution = lTimeBase & 0x7FFF;
-	}
-
-	pMIDIData = MIDIData_Create (lFormat, 0, lTimeMode, lTimeResolution);
-	if (pMIDIData == NULL) {
-		fclose (pFile);
-		return NULL;
-	}
-
-	while (!feof (pFile)) {
-
-		if (fread (byBuf, sizeof(char), 8, pFile) < 8) {
-			break;
-		}
-		if ((memcmp (byBuf, "MTrk", 4) != 0 && i < lNumTrack) &&
-			!(memcmp (byBuf, "XFIH", 4) == 0 && lFormat == 0 && i == 1) &&
-			!(memcmp (byBuf, "XFKM", 4) == 0 && lFormat == 0 && i == 2)) {
-			MIDIData_Delete (pMIDIData);
-			fclose (pFile); /* This is not MIDITrack. */
-			return NULL;
-		}
-		else if ((memcmp (byBuf, "MTrk", 4) != 0 && i >= lNumTrack) &&
-			!(memcmp (byBuf, "XFIH", 4) == 0 && lFormat == 0 && i == 1) &&
-			!(memcmp (byBuf, "XFKM", 4) == 0 && lFormat == 0 && i == 2)) {
-			break;
-		}
-		lTrackLen = (long)BigToLittle4 (byBuf + 4);
-		pTrackData = malloc (lTrackLen);
-		if (pTrackData == NULL) {
-			MIDIData_Delete (pMIDIData);
-			fclose (pFile); /* Out of Memory for TrackData. */
-			return NULL;
-		}
-		if (fread (pTrackData, sizeof (char), 
-			lTrackLen, pFile) < (unsigned long)lTrackLen) {
-			MIDIData_Delete (pMIDIData);
-			fclose (pFile); /* There is too few TrackData. */
-			free (pTrackData);
-			return NULL;
-		}
-
-		pTrack = MIDITrack_LoadFromSMF (pTrackData, lTrackLen);
-		if (pTrack == NULL) {
-			MIDIData_Delete (pMIDIData);
-			fclose (pFile);
-			return NULL;
+	/* Sysxイベント(続き) */
+	else if (pEvent->m_lKind == 0xF7) {
+		/* 未デバッグ */
+		*p++ = (unsigned char)0xF7;
+		p += LongToVariable (pEvent->m_lLen, p);
+		if (pEvent->m_pData != NULL && pEvent->m_lLen > 0) { /* 20091024条件式追加 */
+			memcpy (p, pEvent->m_pData, pEvent->m_lLen);
 		}
-		
-		MIDIData_AddTrackForce (pMIDIData, pTrack);
-	
-		free (pTrackData);
-		pTrackData = NULL;
-		i++;
-	}
-
-	pMIDIData->m_lNumTrack = i;
-	assert (pMIDIData->m_lTimeBase == lTimeBase);
-
-	/* 各トラックの出力ポート番号・出力チャンネル・表示モードの自動設定 */
-	MIDIData_UpdateOutputPort (pMIDIData);
-	MIDIData_UpdateOutputChannel (pMIDIData);
-	MIDIData_UpdateViewMode (pMIDIData);
-
-	/* 各トラックの入力ポート番号・入力チャンネルの設定 */
-	forEachTrack (pMIDIData, pTrack) {
-		pTrack->m_lInputOn = 1;
-		pTrack->m_lInputPort = pTrack->m_lOutputPort;
-		pTrack->m_lInputChannel = pTrack->m_lOutputChannel;
-		pTrack->m_lOutputOn = 1;
+		p += pEvent->m_lLen;
+		*pRunningStatus = 0xF7;
 	}
-	
-	fclose (pFile);
-	pFile = NULL;
-
-	return pMIDIData;
-
+	return INT_PTRtolong (p - pBuf);
 }
 
 /* MIDITrackをSMFとしてメモリブロック上に保存したときの長さを推定(非公開) */
@@ -8731,10 +9409,7 @@ long __stdcall MIDITrack_GuessTrackDataLenAsSMF (MIDITrack* pMIDITrack) {
 	long lLen = 0;
 	MIDIEvent* pEvent;
 	forEachEvent (pMIDITrack, pEvent) {
-		lLen += 4;
-		if (MIDIEvent_IsMIDIEvent (pEvent) == 0) {
-			lLen += 5;	
-		}
+		lLen += MIDIEVENT_SMFMAXHEADERLEN; /* 20261019変更 */
 		lLen += pEvent->m_lLen;
 	}
 	return lLen;
@@ -8742,228 +9417,385 @@ long __stdcall MIDITrack_GuessTrackDataLenAsSMF (MIDITrack* pMIDITrack) {
 
 /* MIDITrackをSMFとしてメモリブロック上に保存(非公開) */
 long __stdcall MIDITrack_SaveAsSMF (MIDITrack* pMIDITrack, unsigned char* pBuf) {
-	long lLen, lDeltaTime;
 	unsigned char* p = pBuf;
 	MIDIEvent* pEvent;
 	unsigned char cOldEventType = 0xFF;
 	forEachEvent (pMIDITrack, pEvent) {
-		/* デルタタイム保存 */
-		if (pEvent->m_pPrevEvent) {
-			lDeltaTime = pEvent->m_lTime - pEvent->m_pPrevEvent->m_lTime;
-		}
-		/* 20081031:先頭空白は削除しない */
-		else {
-			lDeltaTime = pEvent->m_lTime;
-		}
-		lLen = LongToVariable (lDeltaTime, p);
-		p += lLen;
-		/* メタイベント */
-		if (0x00 <= pEvent->m_lKind && pEvent->m_lKind < 0x80) {
-			*p++ = 0xFF;
-			*p++ = (unsigned char)(pEvent->m_lKind);
-			p += LongToVariable (pEvent->m_lLen, p);
-			if (pEvent->m_pData && pEvent->m_lLen > 0) { /* 20091024条件式追加 */
-				memcpy (p, pEvent->m_pData, pEvent->m_lLen);
-			}
-			p += pEvent->m_lLen;
-			cOldEventType = 0xFF;
-		}
-		/* MIDIチャンネルイベント */
-		else if (0x80 <= pEvent->m_lKind && pEvent->m_lKind <= 0xEF) {
-			/* ランニングステータス使用可能(2バイト目以降保存) */
-			if (cOldEventType == *(pEvent->m_pData)) {
-				memcpy (p, pEvent->m_pData + 1, pEvent->m_lLen - 1);
-				p += pEvent->m_lLen - 1;
-			}
-			/* ランニングステータス使用不能(全バイト保存) */
-			else {
-				memcpy (p, pEvent->m_pData, pEvent->m_lLen);
-				p += pEvent->m_lLen;
-			}
-			cOldEventType = *(pEvent->m_pData);
-		}
-		/* Sysxイベント */
-		else if (pEvent->m_lKind == 0xF0) {
-			*p++ = (unsigned char)0xF0;
-			p += LongToVariable (pEvent->m_lLen - 1, p);
-			if (pEvent->m_pData != NULL && pEvent->m_lLen > 1) { /* 20091024条件式追加 */
-				memcpy (p, pEvent->m_pData + 1, pEvent->m_lLen - 1);
-			}
-			p += pEvent->m_lLen - 1;
-			cOldEventType = 0xF0;
-		}
-		/* Sysxイベント(続き) */
-		else if (pEvent->m_lKind == 0xF7) {
-			/* 未デバッグ */
-			*p++ = (unsigned char)0xF7;
-			p += LongToVariable (pEvent->m_lLen, p);
-			if (pEvent->m_pData != NULL && pEvent->m_lLen > 0) { /* 20091024条件式追加 */
-				memcpy (p, pEvent->m_pData, pEvent->m_lLen);
-			}
-			p += pEvent->m_lLen;
-			cOldEventType = 0xF7;
-		}
+		p += MIDIEvent_SaveAsSMF (pEvent, p, &cOldEventType); /* 20261019変更 */
 	}
 	return INT_PTRtolong (p - pBuf);
 }
 
-/* MIDIデータをスタンダードMIDIファイル(*.mid)として保存(ANSI) */
-/* 戻り値：正常終了=1、異常終了=0。 */
-long __stdcall MIDIData_SaveAsSMFA (MIDIData* pMIDIData, const char* pszFileName) {
-	unsigned char* pBuf;
-	unsigned char byBuf[256];
-	long i = 0;
-	errno_t nErrorNo = 0;
-	long lLen, lWriteLen;
-	short sNumTrack;
-	MIDITrack* pMIDITrack;
-	FILE* pFile;
-	long lXFVersion = MIDIData_GetXFVersion (pMIDIData);
+/* SMF保存用の伸長可能な作業用バッファ(非公開)(20261019追加) */
+typedef struct tagSMFWriteBuf {
+	unsigned char* m_pBuf;              /* バッファ */
+	long m_lLen;                        /* 書き込んだ長さ[バイト] */
+	long m_lSize;                       /* 確保した長さ[バイト] */
+	MIDIDataContext* m_pContext;        /* 確保・解放に用いるコンテキスト */
+} SMFWriteBuf;
 
-	nErrorNo = fopen_s (&pFile, pszFileName, "wb");
-	if (pFile == NULL) {
+#define SMFWRITEBUF_MINSIZE   4096  /* 作業用バッファの最初の確保長[バイト] */
+#define SMFWRITEBUF_FLUSHSIZE 65536 /* 作業用バッファをまとめて書き出す長さ[バイト] */
+#define MIDIDATA_MAXSAVETHREADNUM 16 /* 並行保存時の最大スレッド数 */
+
+/* 作業用バッファにlSizeバイト以上の空きを確保する(非公開)(20261019追加) */
+/* 足りない場合は倍々に伸長する。戻り値：正常終了=1、異常終了=0。 */
+static long SMFWriteBuf_Reserve (SMFWriteBuf* pWriteBuf, long lSize) {
+	long lNeedSize;
+	long lNewSize;
+	unsigned char* pNewBuf;
+	if (lSize < 0 || lSize > LONG_MAX - pWriteBuf->m_lLen) {
 		return 0;
 	}
-
-	/* MThdヘッダーの保存 */
-	memset (byBuf, 0, 256);
-	strncpy ((char*)byBuf, "MThd", 4);
-	pBuf = byBuf;
-	LittleToBig4 (6, pBuf + 4);
-	LittleToBig2 ((short)(pMIDIData->m_lFormat), pBuf + 8);
-	sNumTrack = pMIDIData->m_lFormat == 0 ? 1 : (short)(pMIDIData->m_lNumTrack);
-	LittleToBig2 (sNumTrack, pBuf + 10);
-	LittleToBig2 ((short)(pMIDIData->m_lTimeBase), pBuf + 12);
-	lWriteLen = size_ttolong (fwrite (byBuf, 1, 14, pFile));
-	if (lWriteLen < 14) {
-		fclose (pFile);
+	lNeedSize = pWriteBuf->m_lLen + lSize;
+	if (lNeedSize <= pWriteBuf->m_lSize) {
+		return 1;
+	}
+	lNewSize = MAX (pWriteBuf->m_lSize, SMFWRITEBUF_MINSIZE);
+	while (lNewSize < lNeedSize) {
+		lNewSize = (lNewSize > LONG_MAX / 2) ? lNeedSize : lNewSize * 2;
+	}
+	pNewBuf = MIDIDataContext_Alloc (pWriteBuf->m_pContext, lNewSize);
+	if (pNewBuf == NULL) {
 		return 0;
 	}
+	if (pWriteBuf->m_lLen > 0) {
+		memcpy (pNewBuf, pWriteBuf->m_pBuf, pWriteBuf->m_lLen);
+	}
+	MIDIDataContext_Free (pWriteBuf->m_pContext, pWriteBuf->m_pBuf);
+	pWriteBuf->m_pBuf = pNewBuf;
+	pWriteBuf->m_lSize = lNewSize;
+	return 1;
+}
 
-	/* 各トラックの保存 */
-	forEachTrack (pMIDIData, pMIDITrack) {
-		lLen = MIDITrack_GuessTrackDataLenAsSMF (pMIDITrack);
-		pBuf = malloc (8 + lLen);
-		if (pBuf == NULL) {
-			fclose (pFile);
-			return 0;
-		}
-		lLen = MIDITrack_SaveAsSMF (pMIDITrack, pBuf + 8);
-		if (lLen <= 0) {
-			free (pBuf);
-			fclose (pFile);
-			return 0;
-		}
-		LittleToBig4 (lLen ,pBuf + 4);
+/* 作業用バッファの内容を書き出し先関数へ書き出して空にする(非公開)(20261019追加) */
+/* 戻り値：正常終了=1、異常終了=0。 */
+static long SMFWriteBuf_Flush (SMFWriteBuf* pWriteBuf, MIDIDataWriteProc pfnWrite, void* pParam) {
+	long lLen = pWriteBuf->m_lLen;
+	if (lLen == 0) {
+		return 1;
+	}
+	pWriteBuf->m_lLen = 0;
+	return pfnWrite (pParam, pWriteBuf->m_pBuf, lLen) == lLen;
+}
 
-		if (pMIDIData->m_lFormat == 0 && lXFVersion != 0 && i == 1) {
-			strncpy ((char*)pBuf, "XFIH", 4); 
-		}
-		else if (pMIDIData->m_lFormat == 0 && lXFVersion != 0 && i == 2) {
-			strncpy ((char*)pBuf, "XFKM", 4); 
-		}
-		else {
-			strncpy ((char*)pBuf, "MTrk", 4); 
-		}
+/* 作業用バッファの解放(非公開)(20261019追加) */
+static void SMFWriteBuf_Free (SMFWriteBuf* pWriteBuf) {
+	MIDIDataContext_Free (pWriteBuf->m_pContext, pWriteBuf->m_pBuf);
+	pWriteBuf->m_pBuf = NULL;
+	pWriteBuf->m_lLen = 0;
+	pWriteBuf->m_lSize = 0;
+}
 
-		lWriteLen = size_ttolong (fwrite (pBuf, 1, 8 + lLen, pFile));
-		if (lWriteLen < 8 + lLen) {
-			free (pBuf);
-			fclose (pFile);
+/* MIDITrackをチャンクとして作業用バッファの末尾に追加する(非公開)(20261019追加) */
+/* 各イベントは最大長分の空きを確保してから直接符号化し、チャンク長は最後に書き込む。 */
+/* イベントのないトラックは従来どおり保存できないものとする。戻り値：正常終了=1、異常終了=0。 */
+static long MIDITrack_WriteSMFChunk (MIDITrack* pMIDITrack, const char* pszChunkType, SMFWriteBuf* pWriteBuf) {
+	long lChunkPos;
+	long lChunkLen;
+	unsigned char cOldEventType = 0xFF;
+	MIDIEvent* pEvent;
+	if (!SMFWriteBuf_Reserve (pWriteBuf, 8)) {
+		return 0;
+	}
+	lChunkPos = pWriteBuf->m_lLen;
+	memcpy (pWriteBuf->m_pBuf + lChunkPos, pszChunkType, 4);
+	pWriteBuf->m_lLen += 8;
+	forEachEvent (pMIDITrack, pEvent) {
+		if (pEvent->m_lLen < 0 || pEvent->m_lLen > LONG_MAX - MIDIEVENT_SMFMAXHEADERLEN) {
 			return 0;
 		}
-		free (pBuf);
-		i++;
+		if (!SMFWriteBuf_Reserve (pWriteBuf, MIDIEVENT_SMFMAXHEADERLEN + pEvent->m_lLen)) {
+			return 0;
+		}
+		pWriteBuf->m_lLen += MIDIEvent_SaveAsSMF
+			(pEvent, pWriteBuf->m_pBuf + pWriteBuf->m_lLen, &cOldEventType);
 	}
-
-	fclose (pFile);
+	lChunkLen = pWriteBuf->m_lLen - lChunkPos - 8;
+	if (lChunkLen <= 0) {
+		return 0;
+	}
+	LittleToBig4 (lChunkLen, pWriteBuf->m_pBuf + lChunkPos + 4);
 	return 1;
 }
 
-/* MIDIデータをスタンダードMIDIファイル(*.mid)として保存(UNICODE) */
-/* ファイル名はUNICODEで与えるがファイルの中身は仕様に基づきANSIである。 */
-/* 戻り値：正常終了=1、異常終了=0。 */
-long __stdcall MIDIData_SaveAsSMFW (MIDIData* pMIDIData, const wchar_t* pszFileName) {
+/* i番目のトラックのチャンクタイプを返す(非公開)(20261019追加) */
+static const char* MIDIData_GetSMFChunkType (MIDIData* pMIDIData, long lXFVersion, long i) {
+	if (pMIDIData->m_lFormat == 0 && lXFVersion != 0 && i == 1) {
+		return "XFIH";
+	}
+	else if (pMIDIData->m_lFormat == 0 && lXFVersion != 0 && i == 2) {
+		return "XFKM";
+	}
+	return "MTrk";
+}
+
+/* MThdヘッダーを作業用バッファに書き込む(非公開)(20261019追加) */
+static long MIDIData_WriteSMFHeader (MIDIData* pMIDIData, SMFWriteBuf* pWriteBuf) {
 	unsigned char* pBuf;
-	unsigned char byBuf[256];
-	long i = 0;
-	errno_t nErrorNo = 0;
-	long lLen, lWriteLen;
 	short sNumTrack;
-	MIDITrack* pMIDITrack;
-	FILE* pFile;
-	long lXFVersion = MIDIData_GetXFVersion (pMIDIData);
-
-	nErrorNo = _wfopen_s (&pFile, pszFileName, L"wb");
-	if (pFile == NULL) {
+	if (!SMFWriteBuf_Reserve (pWriteBuf, 14)) {
 		return 0;
 	}
-
-	/* MThdヘッダーの保存 */
-	memset (byBuf, 0, 256);
-	strncpy ((char*)byBuf, "MThd", 4);
-	pBuf = byBuf;
+	pBuf = pWriteBuf->m_pBuf + pWriteBuf->m_lLen;
+	memcpy (pBuf, "MThd", 4);
 	LittleToBig4 (6, pBuf + 4);
 	LittleToBig2 ((short)(pMIDIData->m_lFormat), pBuf + 8);
 	sNumTrack = pMIDIData->m_lFormat == 0 ? 1 : (short)(pMIDIData->m_lNumTrack);
 	LittleToBig2 (sNumTrack, pBuf + 10);
 	LittleToBig2 ((short)(pMIDIData->m_lTimeBase), pBuf + 12);
-	lWriteLen = size_ttolong (fwrite (byBuf, 1, 14, pFile));
-	if (lWriteLen < 14) {
-		fclose (pFile);
-		return 0;
+	pWriteBuf->m_lLen += 14;
+	return 1;
+}
+
+/* 並行保存で1つのトラックを作業用バッファに書き込む関数(非公開)(20261019追加) */
+/* lTrackIndexは0から数えたトラックの番号、pTrackParamは並行保存の呼び出し元が渡した値。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+typedef long (*MIDIDataWriteTrackProc) 
+	(MIDITrack* pMIDITrack, long lTrackIndex, SMFWriteBuf* pWriteBuf, void* pTrackParam);
+
+/* 並行保存の作業(非公開)(20261019追加) */
+typedef struct tagMIDIDataWriteJob {
+	MIDITrack** m_ppTrack;              /* 各トラック */
+	SMFWriteBuf* m_pWriteBuf;           /* 各トラックの作業用バッファ */
+	MIDIDataWriteTrackProc m_pfnWriteTrack; /* 1つのトラックを書き込む関数 */
+	void* m_pTrackParam;                /* m_pfnWriteTrackに渡す値 */
+	long m_lTrackNum;                   /* トラック数 */
+	volatile long m_lNextTrack;         /* 次に書き込むトラックの番号 */
+	volatile long m_lError;             /* 書き込みに失敗したトラックがある */
+} MIDIDataWriteJob;
+
+/* 並行保存のスレッド関数(残っているトラックを1つずつ取り出して書き込む)(非公開)(20261019追加) */
+static DWORD WINAPI MIDIData_SaveParallelThreadProc (LPVOID pParam) {
+	MIDIDataWriteJob* pJob = (MIDIDataWriteJob*)pParam;
+	long i;
+	while ((i = InterlockedIncrement (&(pJob->m_lNextTrack)) - 1) < pJob->m_lTrackNum) {
+		if (pJob->m_lError) {
+			break;
+		}
+		if (!pJob->m_pfnWriteTrack (pJob->m_ppTrack[i], i, &(pJob->m_pWriteBuf[i]), pJob->m_pTrackParam)) {
+			InterlockedExchange (&(pJob->m_lError), 1);
+		}
 	}
+	return 0;
+}
 
-	/* 各トラックの保存 */
+/* 各トラックを複数のスレッドで並行してpfnWriteTrackで作業用バッファに書き込み、 */
+/* pfnWriteHeaderの内容・各トラック・pfnWriteFooterの内容の順に書き出す(非公開)(20261019追加) */
+/* SMF・MIDICSVの並行保存で共通に使う。pfnWriteFooterはNULLでもよい。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+static long MIDIData_SaveParallel (MIDIData* pMIDIData, long lThreadNum,
+	MIDIDataWriteTrackProc pfnWriteTrack, void* pTrackParam,
+	long (*pfnWriteHeader) (MIDIData*, SMFWriteBuf*), long (*pfnWriteFooter) (MIDIData*, SMFWriteBuf*),
+	MIDIDataWriteProc pfnWrite, void* pParam, MIDIDataContext* pContext) {
+	MIDIDataWriteJob theJob;
+	SMFWriteBuf theHeaderBuf;
+	HANDLE hThread[MIDIDATA_MAXSAVETHREADNUM];
+	MIDITrack* pMIDITrack;
+	long lRet = 0;
+	long i = 0;
+	long j;
+	memset (&theJob, 0, sizeof (MIDIDataWriteJob));
+	memset (&theHeaderBuf, 0, sizeof (SMFWriteBuf));
+	theHeaderBuf.m_pContext = pContext;
+	theJob.m_pfnWriteTrack = pfnWriteTrack;
+	theJob.m_pTrackParam = pTrackParam;
+	theJob.m_lTrackNum = pMIDIData->m_lNumTrack;
+	theJob.m_ppTrack = MIDIDataContext_Alloc (pContext, sizeof (MIDITrack*) * theJob.m_lTrackNum);
+	theJob.m_pWriteBuf = MIDIDataContext_Alloc (pContext, sizeof (SMFWriteBuf) * theJob.m_lTrackNum);
+	if (theJob.m_ppTrack == NULL || theJob.m_pWriteBuf == NULL) {
+		goto exit;
+	}
+	memset (theJob.m_pWriteBuf, 0, sizeof (SMFWriteBuf) * theJob.m_lTrackNum);
 	forEachTrack (pMIDIData, pMIDITrack) {
-		lLen = MIDITrack_GuessTrackDataLenAsSMF (pMIDITrack);
-		pBuf = malloc (8 + lLen);
-		if (pBuf == NULL) {
-			fclose (pFile);
-			return 0;
+		if (i >= theJob.m_lTrackNum) {
+			break;
 		}
-		lLen = MIDITrack_SaveAsSMF (pMIDITrack, pBuf + 8);
-		if (lLen <= 0) {
-			free (pBuf);
-			fclose (pFile);
-			return 0;
+		theJob.m_ppTrack[i] = pMIDITrack;
+		theJob.m_pWriteBuf[i].m_pContext = pContext;
+		i++;
+	}
+	theJob.m_lTrackNum = i;
+
+	/* 呼び出し元のスレッドも書き込みに加わるので、起動するのはlThreadNum-1個 */
+	/* スレッドを起動できなかった場合は、残りのスレッドで書き込む */
+	for (j = 0; j < lThreadNum - 1; j++) {
+		hThread[j] = CreateThread (NULL, 0, MIDIData_SaveParallelThreadProc, &theJob, 0, NULL);
+		if (hThread[j] == NULL) {
+			break;
 		}
-		LittleToBig4 (lLen ,pBuf + 4);
+	}
+	MIDIData_SaveParallelThreadProc (&theJob);
+	while (j > 0) {
+		j--;
+		WaitForSingleObject (hThread[j], INFINITE);
+		CloseHandle (hThread[j]);
+	}
+	if (theJob.m_lError) {
+		goto exit;
+	}
 
-		if (pMIDIData->m_lFormat == 0 && lXFVersion != 0 && i == 1) {
-			strncpy ((char*)pBuf,"XFIH", 4); 
+	/* ヘッダーと各トラックとフッターを順番どおりに書き出す */
+	if (!pfnWriteHeader (pMIDIData, &theHeaderBuf) ||
+		!SMFWriteBuf_Flush (&theHeaderBuf, pfnWrite, pParam)) {
+		goto exit;
+	}
+	for (i = 0; i < theJob.m_lTrackNum; i++) {
+		if (!SMFWriteBuf_Flush (&(theJob.m_pWriteBuf[i]), pfnWrite, pParam)) {
+			goto exit;
 		}
-		else if (pMIDIData->m_lFormat == 0 && lXFVersion != 0 && i == 2) {
-			strncpy ((char*)pBuf, "XFKM", 4); 
+	}
+	if (pfnWriteFooter) {
+		if (!pfnWriteFooter (pMIDIData, &theHeaderBuf) ||
+			!SMFWriteBuf_Flush (&theHeaderBuf, pfnWrite, pParam)) {
+			goto exit;
 		}
-		else {
-			strncpy ((char*)pBuf, "MTrk", 4); 
+	}
+	lRet = 1;
+
+	exit:
+	SMFWriteBuf_Free (&theHeaderBuf);
+	if (theJob.m_pWriteBuf) {
+		for (i = 0; i < theJob.m_lTrackNum; i++) {
+			SMFWriteBuf_Free (&(theJob.m_pWriteBuf[i]));
 		}
+	}
+	MIDIDataContext_Free (pContext, theJob.m_pWriteBuf);
+	MIDIDataContext_Free (pContext, theJob.m_ppTrack);
+	return lRet;
+}
 
-		lWriteLen = size_ttolong (fwrite (pBuf, 1, 8 + lLen, pFile));
-		if (lWriteLen < 8 + lLen) {
-			free (pBuf);
-			fclose (pFile);
-			return 0;
+/* 並行保存で1つのトラックをSMFのトラックチャンクとして書き込む(非公開)(20261019追加) */
+/* pTrackParamは保存するMIDIデータ。 */
+static long MIDIData_WriteSMFTrack 
+	(MIDITrack* pMIDITrack, long lTrackIndex, SMFWriteBuf* pWriteBuf, void* pTrackParam) {
+	MIDIData* pMIDIData = (MIDIData*)pTrackParam;
+	long lXFVersion = 0;
+	/* XFのチャンクタイプはフォーマット0の2・3番目のトラックにのみ使う */
+	if (pMIDIData->m_lFormat == 0 && (lTrackIndex == 1 || lTrackIndex == 2)) {
+		lXFVersion = MIDIData_GetXFVersion (pMIDIData);
+	}
+	return MIDITrack_WriteSMFChunk (pMIDITrack,
+		MIDIData_GetSMFChunkType (pMIDIData, lXFVersion, lTrackIndex), pWriteBuf);
+}
+
+/* MIDIデータをスタンダードMIDIファイル(*.mid)として書き出し先関数へ書き出す(20261019追加) */
+/* 各トラックは伸長可能な作業用バッファへ1回の走査で符号化し、チャンク長は後から書き込む。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsSMFToSink
+	(MIDIData* pMIDIData, MIDIDataWriteProc pfnWrite, void* pParam, MIDIDataContext* pContext) {
+	SMFWriteBuf theWriteBuf;
+	MIDITrack* pMIDITrack;
+	SYSTEM_INFO theSystemInfo;
+	long lThreadNum;
+	long lXFVersion;
+	long lRet = 0;
+	long i = 0;
+	assert (pMIDIData);
+	assert (pfnWrite);
+	pContext = GetContext (pContext);
+
+	/* 並行保存 */
+	if ((pContext->m_lSaveFlags & MIDIDATACONTEXT_PARALLELSAVE) && pMIDIData->m_lNumTrack >= 2) {
+		GetSystemInfo (&theSystemInfo);
+		lThreadNum = CLIP (1, (long)(theSystemInfo.dwNumberOfProcessors), MIDIDATA_MAXSAVETHREADNUM);
+		lThreadNum = MIN (lThreadNum, pMIDIData->m_lNumTrack);
+		if (lThreadNum >= 2) {
+			return MIDIData_SaveParallel (pMIDIData, lThreadNum, MIDIData_WriteSMFTrack, pMIDIData,
+				MIDIData_WriteSMFHeader, NULL, pfnWrite, pParam, pContext);
+		}
+	}
+
+	/* 1つの作業用バッファを使い回し、SMFWRITEBUF_FLUSHSIZEを超えたらまとめて書き出す */
+	memset (&theWriteBuf, 0, sizeof (SMFWriteBuf));
+	theWriteBuf.m_pContext = pContext;
+	if (!MIDIData_WriteSMFHeader (pMIDIData, &theWriteBuf)) {
+		goto exit;
+	}
+	lXFVersion = MIDIData_GetXFVersion (pMIDIData);
+	forEachTrack (pMIDIData, pMIDITrack) {
+		if (!MIDITrack_WriteSMFChunk (pMIDITrack,
+			MIDIData_GetSMFChunkType (pMIDIData, lXFVersion, i), &theWriteBuf)) {
+			goto exit;
+		}
+		if (theWriteBuf.m_lLen >= SMFWRITEBUF_FLUSHSIZE) {
+			if (!SMFWriteBuf_Flush (&theWriteBuf, pfnWrite, pParam)) {
+				goto exit;
+			}
 		}
-		free (pBuf);
 		i++;
 	}
+	if (!SMFWriteBuf_Flush (&theWriteBuf, pfnWrite, pParam)) {
+		goto exit;
+	}
+	lRet = 1;
 
-	fclose (pFile);
-	return 1;
+	exit:
+	SMFWriteBuf_Free (&theWriteBuf);
+	return lRet;
+}
+
+/* MIDIデータをスタンダードMIDIファイル(*.mid)として保存(ANSI) */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsSMFA (MIDIData* pMIDIData, const char* pszFileName) {
+	return MIDIData_SaveAsSMFExA (pMIDIData, pszFileName, NULL);
+}
+
+/* MIDIデータをスタンダードMIDIファイル(*.mid)として保存(UNICODE) */
+/* ファイル名はUNICODEで与えるがファイルの中身は仕様に基づきANSIである。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsSMFW (MIDIData* pMIDIData, const wchar_t* pszFileName) {
+	return MIDIData_SaveAsSMFExW (pMIDIData, pszFileName, NULL);
+}
+
+/* MIDIデータをスタンダードMIDIファイル(*.mid)として保存(コンテキスト指定)(ANSI)(20261019追加) */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsSMFExA
+(MIDIData* pMIDIData, const char* pszFileName, MIDIDataContext* pContext) {
+	MIDIDataStream theStream;
+	long lRet = 0;
+	if (MIDIDataStream_OpenFileA (&theStream, pszFileName, "wb") == 0) {
+		return 0;
+	}
+	lRet = MIDIData_SaveAsSMFToSink (pMIDIData, MIDIDataStream_WriteProc, &theStream, pContext);
+	MIDIDataStream_Close (&theStream);
+	return lRet;
+}
+
+/* MIDIデータをスタンダードMIDIファイル(*.mid)として保存(コンテキスト指定)(UNICODE)(20261019追加) */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsSMFExW
+(MIDIData* pMIDIData, const wchar_t* pszFileName, MIDIDataContext* pContext) {
+	MIDIDataStream theStream;
+	long lRet = 0;
+	if (MIDIDataStream_OpenFileW (&theStream, pszFileName, L"wb") == 0) {
+		return 0;
+	}
+	lRet = MIDIData_SaveAsSMFToSink (pMIDIData, MIDIDataStream_WriteProc, &theStream, pContext);
+	MIDIDataStream_Close (&theStream);
+	return lRet;
 }
 
+/* MIDIデータをスタンダードMIDIファイル(*.mid)としてメモリブロックに保存(20261019追加) */
+/* 保存したデータは*ppDataに、その長さは*pLenに返す。*ppDataはMIDIDataLib_FreeMemoryで解放すること。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsSMFMemory (MIDIData* pMIDIData, void** ppData, long* pLen) {
+	MIDIDataStream theStream;
+	MIDIDataStream_CreateMemory (&theStream, 0);
+	if (MIDIData_SaveAsSMFToSink (pMIDIData, MIDIDataStream_WriteProc, &theStream, NULL) == 0) {
+		MIDIDataStream_Close (&theStream);
+		return 0;
+	}
+	return MIDIDataStream_DetachMemory (&theStream, ppData, pLen);
+}
 
 
 /* MIDIDataをテキストファイル(*.txt)から読み込み、 */
-/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(ANSI) */
-MIDIData* __stdcall MIDIData_LoadFromTextA (const char* pszFileName) {
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(非公開)(20261019追加) */
+static MIDIData* MIDIData_LoadFromTextStream (MIDIDataStream* pStream) {
 	MIDIData* pMIDIData = NULL;
 	MIDITrack* pMIDITrack = NULL;
 	MIDIEvent* pMIDIEvent = NULL;
-	errno_t nErrorNo = 0;
-	FILE* pFile = NULL;
 	long lFormat;
 	long lNumTrack;
 	long lTimeBase;
@@ -8987,15 +9819,10 @@ MIDIData* __stdcall MIDIData_LoadFromTextA (const char* pszFileName) {
 	long j = 0;
 	long k = 0;
 
-	nErrorNo = fopen_s (&pFile, pszFileName, "rt");
-	if (pFile == NULL) {
-		return 0;
-	}
 
 	memset (szTextLine, 0, sizeof (szTextLine));
-	fgets (szTextLine, sizeof (szTextLine) - 1, pFile);
+	MIDIDataStream_GetLine (szTextLine, sizeof (szTextLine) - 1, pStream);
 	if (strncmp (szTextLine, "MDat", 4) == 0) {
-		fclose (pFile);
 		return NULL;
 	}
 #ifdef _MSC_VER
@@ -9006,17 +9833,14 @@ MIDIData* __stdcall MIDIData_LoadFromTextA (const char* pszFileName) {
 	sscanf (szTextLine, "%255s %lX %lX %lX %lX %lX %lX %lX\n",
 		szType, &lFormat, &lNumTrack, &lTimeBase, 
 		&lUser1, &lUser2, &lUser3, &lUserFlag);
-#endif /* _MSC_VER */
+#endif 
 	if (lFormat < 0 || lFormat >= 2) {
-		fclose (pFile);
  		return NULL;
 	}
 	if (lNumTrack < 0 || lNumTrack > MIDIDATA_MAXMIDITRACKNUM) {
-		fclose (pFile);
 		return NULL;
 	}
 	if (lTimeBase < 0 || lTimeBase > 65535) {
-		fclose (pFile);
 		return NULL;
 	}
 	if (lTimeBase & 0x00008000) {
@@ -9032,17 +9856,14 @@ MIDIData* __stdcall MIDIData_LoadFromTextA (const char* pszFileName) {
 		lTimeMode != MIDIDATA_SMPTE25BASE &&
 		lTimeMode != MIDIDATA_SMPTE29BASE &&
 		lTimeMode != MIDIDATA_SMPTE30BASE) {
-		fclose (pFile);
 		return NULL;
 	}
 	if (lTimeResolution <= 0) {
-		fclose (pFile);
 		return NULL;
 	}
 
 	pMIDIData = MIDIData_Create (lFormat, lNumTrack, lTimeMode, lTimeResolution);
 	if (pMIDIData == NULL) {
-		fclose (pFile);
 		return NULL;
 	}
 	pMIDIData->m_lUser1 = lUser1;
@@ -9052,9 +9873,8 @@ MIDIData* __stdcall MIDIData_LoadFromTextA (const char* pszFileName) {
 
 	forEachTrack (pMIDIData, pMIDITrack) {
 		memset (szTextLine, 0, sizeof (szTextLine));
-		fgets (szTextLine, sizeof (szTextLine) - 1, pFile);
+		MIDIDataStream_GetLine (szTextLine, sizeof (szTextLine) - 1, pStream);
 		if (strncmp (szTextLine, "MTrk", 9) != 0) {
-			fclose (pFile);
 			MIDIData_Delete (pMIDIData);
 			return NULL;
 		}
@@ -9076,9 +9896,8 @@ MIDIData* __stdcall MIDIData_LoadFromTextA (const char* pszFileName) {
 		for (j = 0; j < lNumEvent; j++) {
 			char* p = szTextLine;
 			memset (szTextLine, 0, sizeof (szTextLine));
-			fgets (szTextLine, sizeof (szTextLine) - 1, pFile);
+			MIDIDataStream_GetLine (szTextLine, sizeof (szTextLine) - 1, pStream);
 			if (strncmp (szTextLine, "MEvt", 4) != 0) {
-				fclose (pFile);
 				MIDIData_Delete (pMIDIData);
 				return NULL;
 			}
@@ -9093,7 +9912,6 @@ MIDIData* __stdcall MIDIData_LoadFromTextA (const char* pszFileName) {
 			for (k = 0; k < 5; k++) {
 				p = strchr (p, ' ');
 				if (p == NULL) {
-					fclose (pFile);
 					MIDIData_Delete (pMIDIData);
 					return NULL;
 				}
@@ -9105,7 +9923,6 @@ MIDIData* __stdcall MIDIData_LoadFromTextA (const char* pszFileName) {
 				sscanf (p, "%hhX", &ucData[k]);
 				p = strchr (p, ' ');
 				if (p == NULL) {
-					fclose (pFile);
 					MIDIData_Delete (pMIDIData);
 					return NULL;
 				}
@@ -9116,12 +9933,10 @@ MIDIData* __stdcall MIDIData_LoadFromTextA (const char* pszFileName) {
 
 			pMIDIEvent = MIDIEvent_Create (lTime, lKind, ucData, lLen);
 			if (pMIDIEvent == NULL) {
-				fclose (pFile);
 				MIDIData_Delete (pMIDIData);
 				return NULL;
 			}
 			if (MIDITrack_InsertEvent (pMIDITrack, pMIDIEvent) == 0) {
-				fclose (pFile);
 				MIDIData_Delete (pMIDIData);
 				return NULL;
 			}
@@ -9138,7 +9953,7 @@ MIDIData* __stdcall MIDIData_LoadFromTextA (const char* pszFileName) {
 		}
 		/* 結合されたイベントの結合状態復元処理 */
 		forEachEvent (pMIDITrack, pMIDIEvent) {
-			if ((INT_PTR)(pMIDIEvent->m_pPrevCombinedEvent) == -1) {
+			if (INT_PTRtolong ((INT_PTR)(pMIDIEvent->m_pPrevCombinedEvent)) == -1) {
 				pMIDIEvent->m_pPrevCombinedEvent = NULL;
 			}
 			else {
@@ -9151,7 +9966,6 @@ MIDIData* __stdcall MIDIData_LoadFromTextA (const char* pszFileName) {
 					}
 				}
 				if (pTempEvent == NULL) {
-					fclose (pFile);
 					MIDIData_Delete (pMIDIData);
 					return NULL;
 				}
@@ -9169,7 +9983,6 @@ MIDIData* __stdcall MIDIData_LoadFromTextA (const char* pszFileName) {
 					}
 				}
 				if (pTempEvent == NULL) {
-					fclose (pFile);
 					MIDIData_Delete (pMIDIData);
 					return NULL;
 				}
@@ -9180,248 +9993,56 @@ MIDIData* __stdcall MIDIData_LoadFromTextA (const char* pszFileName) {
 	return pMIDIData;
 }
 
+/* MIDIDataをテキストファイル(*.txt)から読み込み、 */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(ANSI) */
+MIDIData* __stdcall MIDIData_LoadFromTextA (const char* pszFileName) {
+	MIDIDataStream theStream;
+	MIDIData* pMIDIData = NULL;
+	if (MIDIDataStream_OpenFileA (&theStream, pszFileName, "rt") == 0) {
+		return NULL;
+	}
+	pMIDIData = MIDIData_LoadFromTextStream (&theStream);
+	MIDIDataStream_Close (&theStream);
+	return pMIDIData;
+}
+
 /* MIDIDataをテキストファイルから読み込み、 */
 /* 新しいMIDIデータへのポインタを返す(失敗時NULL)(UNICODE) */
 /* ファイル名はUNICODEで与えるがファイルの中身は仕様に基づきANSIである。 */
 MIDIData* __stdcall MIDIData_LoadFromTextW (const wchar_t* pszFileName) {
+	MIDIDataStream theStream;
 	MIDIData* pMIDIData = NULL;
-	MIDITrack* pMIDITrack = NULL;
-	MIDIEvent* pMIDIEvent = NULL;
-	errno_t nErrorNo = 0;
-	FILE* pFile = NULL;
-	long lFormat;
-	long lNumTrack;
-	long lTimeBase;
-	long lTimeMode;
-	long lTimeResolution;
-	long lNumEvent;
-	long lIndex;
-	long lTime;
-	long lKind;
-	long lLen;
-	unsigned char ucData[1024];
-	long lPrevCombinedEvent;
-	long lNextCombinedEvent;
-	long lUser1;
-	long lUser2;
-	long lUser3;
-	long lUserFlag;
-	char szType[256];
-	char szTextLine[2048];
-	long i = 0;
-	long j = 0;
-	long k = 0;
-
-	nErrorNo = _wfopen_s (&pFile, pszFileName, L"rt");
-	if (pFile == NULL) {
-		return 0;
-	}
-
-	memset (szTextLine, 0, sizeof (szTextLine));
-	fgets (szTextLine, sizeof (szTextLine) - 1, pFile);
-	if (strncmp (szTextLine, "MDat", 4) == 0) {
-		fclose (pFile);
-		return NULL;
-	}
-#ifdef _MSC_VER
-	sscanf_s (szTextLine, "%s %lX %lX %lX %lX %lX %lX %lX\n",
-		szType, size_ttolong (sizeof (szType)), &lFormat, &lNumTrack, &lTimeBase, 
-		&lUser1, &lUser2, &lUser3, &lUserFlag);
-#else
-	sscanf (szTextLine, "%255s %lX %lX %lX %lX %lX %lX %lX\n",
-		szType, &lFormat, &lNumTrack, &lTimeBase, 
-		&lUser1, &lUser2, &lUser3, &lUserFlag);
-#endif 
-	if (lFormat < 0 || lFormat >= 2) {
-		fclose (pFile);
- 		return NULL;
-	}
-	if (lNumTrack < 0 || lNumTrack > MIDIDATA_MAXMIDITRACKNUM) {
-		fclose (pFile);
-		return NULL;
-	}
-	if (lTimeBase < 0 || lTimeBase > 65535) {
-		fclose (pFile);
-		return NULL;
-	}
-	if (lTimeBase & 0x00008000) {
-		lTimeMode = 256 - ((lTimeBase & 0x0000FF00) >> 8);
-		lTimeResolution = lTimeBase & 0x000000FF;
-	}
-	else {
-		lTimeMode =  MIDIDATA_TPQNBASE;
-		lTimeResolution = lTimeBase & 0x00007FFF;
-	}
-	if (lTimeMode != MIDIDATA_TPQNBASE &&
-		lTimeMode != MIDIDATA_SMPTE24BASE &&
-		lTimeMode != MIDIDATA_SMPTE25BASE &&
-		lTimeMode != MIDIDATA_SMPTE29BASE &&
-		lTimeMode != MIDIDATA_SMPTE30BASE) {
-		fclose (pFile);
-		return NULL;
-	}
-	if (lTimeResolution <= 0) {
-		fclose (pFile);
+	if (MIDIDataStream_OpenFileW (&theStream, pszFileName, L"rt") == 0) {
 		return NULL;
 	}
+	pMIDIData = MIDIData_LoadFromTextStream (&theStream);
+	MIDIDataStream_Close (&theStream);
+	return pMIDIData;
+}
 
-	pMIDIData = MIDIData_Create (lFormat, lNumTrack, lTimeMode, lTimeResolution);
-	if (pMIDIData == NULL) {
-		fclose (pFile);
+/* MIDIDataをテキストファイル(*.txt)から読み込み、 */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(メモリブロック)(20261019追加) */
+MIDIData* __stdcall MIDIData_LoadFromTextMemory (const void* pData, long lLen) {
+	MIDIDataStream theStream;
+	/* 引数の検査 */
+	if (pData == NULL || lLen < 0) {
 		return NULL;
 	}
-	pMIDIData->m_lUser1 = lUser1;
-	pMIDIData->m_lUser2 = lUser2;
-	pMIDIData->m_lUser3 = lUser3;
-	pMIDIData->m_lUserFlag = lUserFlag;
-
-	forEachTrack (pMIDIData, pMIDITrack) {
-		memset (szTextLine, 0, sizeof (szTextLine));
-		fgets (szTextLine, sizeof (szTextLine) - 1, pFile);
-		if (strncmp (szTextLine, "MTrk", 9) != 0) {
-			fclose (pFile);
-			MIDIData_Delete (pMIDIData);
-			return NULL;
-		}
-#ifdef _MSC_VER
-		sscanf_s (szTextLine, "%s %lX %lX %lX %lX %lX %lX\n",
-			szType, size_ttolong (sizeof (szType)), &lIndex, &lNumEvent,
-			&lUser1, &lUser2, &lUser3, &lUserFlag);
-#else
-		sscanf (szTextLine, "%255s %lX %lX %lX %lX %lX %lX\n",
-			szType, &lIndex, &lNumEvent,
-			&lUser1, &lUser2, &lUser3, &lUserFlag);
-#endif 
-		pMIDITrack->m_lTempIndex = lIndex;
-		pMIDITrack->m_lUser1 = lUser1;
-		pMIDITrack->m_lUser2 = lUser2;
-		pMIDITrack->m_lUser3 = lUser3;
-		pMIDITrack->m_lUserFlag = lUserFlag;
-		/* 各MIDIイベントの読み込み */
-		for (j = 0; j < lNumEvent; j++) {
-			char* p = szTextLine;
-			memset (szTextLine, 0, sizeof (szTextLine));
-			fgets (szTextLine, sizeof (szTextLine) - 1, pFile);
-			if (strncmp (szTextLine, "MEvt", 4) != 0) {
-				fclose (pFile);
-				MIDIData_Delete (pMIDIData);
-				return NULL;
-			}
-#ifdef _MSC_VER
-			sscanf_s (szTextLine, "%s %lX %lX %lX %lX",
-				szType, size_ttolong (sizeof (szType)), &lIndex, &lTime, &lKind, &lLen);
-#else
-			sscanf (szTextLine, "%255s %lX %lX %lX %lX",
-				szType, &lIndex, &lTime, &lKind, &lLen);
-#endif 
-			memset (ucData, 0, sizeof (ucData));
-			for (k = 0; k < 5; k++) {
-				p = strchr (p, ' ');
-				if (p == NULL) {
-					fclose (pFile);
-					MIDIData_Delete (pMIDIData);
-					return NULL;
-				}
-				while (*p == ' ') {
-					p++;
-				}
-			}
-			for (k = 0; k < lLen; k++) {
-				sscanf (p, "%hhX", &ucData[k]);
-				p = strchr (p, ' ');
-				if (p == NULL) {
-					fclose (pFile);
-					MIDIData_Delete (pMIDIData);
-					return NULL;
-				}
-				while (*p == ' ') {
-					p++;
-				}
-			}
-
-			pMIDIEvent = MIDIEvent_Create (lTime, lKind, ucData, lLen);
-			if (pMIDIEvent == NULL) {
-				fclose (pFile);
-				MIDIData_Delete (pMIDIData);
-				return NULL;
-			}
-			if (MIDITrack_InsertEvent (pMIDITrack, pMIDIEvent) == 0) {
-				fclose (pFile);
-				MIDIData_Delete (pMIDIData);
-				return NULL;
-			}
-			sscanf_s (p, "%lX %lX %lX %lX %lX %lX\n", 
-				&lPrevCombinedEvent, &lNextCombinedEvent,
-				&lUser1, &lUser2, &lUser3, &lUserFlag);
-			pMIDIEvent->m_lTempIndex = lIndex;
-			pMIDIEvent->m_pPrevCombinedEvent = (MIDIEvent*)(INT_PTR)lPrevCombinedEvent;
-			pMIDIEvent->m_pNextCombinedEvent = (MIDIEvent*)(INT_PTR)lNextCombinedEvent;
-			pMIDIEvent->m_lUser1 = lUser1;
-			pMIDIEvent->m_lUser2 = lUser2;
-			pMIDIEvent->m_lUser3 = lUser3;
-			pMIDIEvent->m_lUserFlag = lUserFlag;
-		}
-		/* 結合されたイベントの結合状態復元処理 */
-		forEachEvent (pMIDITrack, pMIDIEvent) {
-			if (INT_PTRtolong ((INT_PTR)(pMIDIEvent->m_pPrevCombinedEvent)) == -1) {
-				pMIDIEvent->m_pPrevCombinedEvent = NULL;
-			}
-			else {
-				MIDIEvent* pTempEvent;
-				forEachEvent (pMIDITrack, pTempEvent) {
-					if (pTempEvent->m_lTempIndex ==
-						INT_PTRtolong ((INT_PTR)(pMIDIEvent->m_pPrevCombinedEvent))) {
-						pMIDIEvent->m_pPrevCombinedEvent = pTempEvent;
-						break;
-					}
-				}
-				if (pTempEvent == NULL) {
-					fclose (pFile);
-					MIDIData_Delete (pMIDIData);
-					return NULL;
-				}
-			}
-			if (INT_PTRtolong ((INT_PTR)(pMIDIEvent->m_pNextCombinedEvent)) == -1) {
-				pMIDIEvent->m_pNextCombinedEvent = NULL;
-			}
-			else {
-				MIDIEvent* pTempEvent;
-				forEachEvent (pMIDITrack, pTempEvent) {
-					if (pTempEvent->m_lTempIndex ==
-						INT_PTRtolong ((INT_PTR)(pMIDIEvent->m_pNextCombinedEvent))) {
-						pMIDIEvent->m_pNextCombinedEvent = pTempEvent;
-						break;
-					}
-				}
-				if (pTempEvent == NULL) {
-					fclose (pFile);
-					MIDIData_Delete (pMIDIData);
-					return NULL;
-				}
-			}
-		}
-		i++;
-	}
-	return pMIDIData;
+	MIDIDataStream_OpenMemory (&theStream, pData, lLen, 1);
+	return MIDIData_LoadFromTextStream (&theStream);
 }
 
 
-/* MIDIDataをテキストファイル(*.txt)として保存(デバッグ用隠し関数)(ANSI) */
+/* MIDIDataをテキストファイル(*.txt)として保存(デバッグ用隠し関数)(非公開)(20261019追加) */
 /* 戻り値：正常終了=1、異常終了=0。 */
-long __stdcall MIDIData_SaveAsTextA (MIDIData* pMIDIData, const char* pszFileName) {
+static long MIDIData_SaveAsTextStream (MIDIData* pMIDIData, MIDIDataStream* pStream) {
 	MIDITrack* pMIDITrack = NULL;
 	MIDIEvent* pMIDIEvent = NULL;
 	long i = 0;
 	long j = 0;
 	long k = 0;
-	FILE* pFile = NULL;
-	errno_t nErrorNo = 0;
-	nErrorNo = fopen_s (&pFile, pszFileName, "wt");
-	if (pFile == NULL) {
-		return 0;
-	}
 	MIDIData_CountTrack (pMIDIData),
-	fprintf (pFile, "MDat %lX %lX %lX %lX %lX %lX %lX\n",
+	MIDIDataStream_Printf (pStream, "MDat %lX %lX %lX %lX %lX %lX %lX\n",
 		pMIDIData->m_lFormat,
 		pMIDIData->m_lNumTrack,
 		pMIDIData->m_lTimeBase,
@@ -9431,7 +10052,7 @@ long __stdcall MIDIData_SaveAsTextA (MIDIData* pMIDIData, const char* pszFileNam
 		pMIDIData->m_lUserFlag);
 	forEachTrack (pMIDIData, pMIDITrack) {
 		MIDITrack_CountEvent (pMIDITrack),
-		fprintf (pFile, "MTrk %lX %lX %lX %lX %lX %lX\n",
+		MIDIDataStream_Printf (pStream, "MTrk %lX %lX %lX %lX %lX %lX\n",
 			pMIDITrack->m_lTempIndex,
 			pMIDITrack->m_lNumEvent,
 			pMIDITrack->m_lUser1,
@@ -9440,15 +10061,15 @@ long __stdcall MIDIData_SaveAsTextA (MIDIData* pMIDIData, const char* pszFileNam
 			pMIDITrack->m_lUserFlag);
 		j = 0;
 		forEachEvent (pMIDITrack, pMIDIEvent) {
-			fprintf (pFile, "MEvt %lX %lX %lX %lX",
+			MIDIDataStream_Printf (pStream, "MEvt %lX %lX %lX %lX",
 				pMIDIEvent->m_lTempIndex,
 				pMIDIEvent->m_lTime,
 				pMIDIEvent->m_lKind,
 				pMIDIEvent->m_lLen);
 			for (k = 0; k < pMIDIEvent->m_lLen; k++) {
-				fprintf (pFile, " %X", *(pMIDIEvent->m_pData + k));
+				MIDIDataStream_Printf (pStream, " %X", *(pMIDIEvent->m_pData + k));
 			}
-			fprintf (pFile, " %lX %lX %lX %lX %lX %lX\n",
+			MIDIDataStream_Printf (pStream, " %lX %lX %lX %lX %lX %lX\n",
 				pMIDIEvent->m_pPrevCombinedEvent ? pMIDIEvent->m_pPrevCombinedEvent->m_lTempIndex : -1,
 				pMIDIEvent->m_pNextCombinedEvent ? pMIDIEvent->m_pNextCombinedEvent->m_lTempIndex : -1,
 				pMIDIEvent->m_lUser1,
@@ -9459,78 +10080,61 @@ long __stdcall MIDIData_SaveAsTextA (MIDIData* pMIDIData, const char* pszFileNam
 		}
 		i++;
 	}
-	fclose (pFile);
 	return 1;
 }
 
+/* MIDIDataをテキストファイル(*.txt)として保存(デバッグ用隠し関数)(ANSI) */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsTextA (MIDIData* pMIDIData, const char* pszFileName) {
+	MIDIDataStream theStream;
+	long lRet = 0;
+	if (MIDIDataStream_OpenFileA (&theStream, pszFileName, "wt") == 0) {
+		return 0;
+	}
+	lRet = MIDIData_SaveAsTextStream (pMIDIData, &theStream);
+	MIDIDataStream_Close (&theStream);
+	return lRet;
+}
+
 /* MIDIDataをテキストファイル(*.txt)として保存(デバッグ用隠し関数)(UNICODE) */
 /* ファイル名はUNICODEで与えるがファイルの中身は仕様に基づきANSIである。 */
 /* 戻り値：正常終了=1、異常終了=0。 */
 long __stdcall MIDIData_SaveAsTextW (MIDIData* pMIDIData, const wchar_t* pszFileName) {
-	MIDITrack* pMIDITrack = NULL;
-	MIDIEvent* pMIDIEvent = NULL;
-	long i = 0;
-	long j = 0;
-	long k = 0;
-	errno_t nErrorNo = 0;
-	FILE* pFile = NULL;
-	nErrorNo = _wfopen_s (&pFile, pszFileName, L"wt");
-	if (pFile == NULL) {
+	MIDIDataStream theStream;
+	long lRet = 0;
+	if (MIDIDataStream_OpenFileW (&theStream, pszFileName, L"wt") == 0) {
 		return 0;
 	}
-	MIDIData_CountTrack (pMIDIData),
-	fprintf (pFile, "MDat %lX %lX %lX %lX %lX %lX %lX\n",
-		pMIDIData->m_lFormat,
-		pMIDIData->m_lNumTrack,
-		pMIDIData->m_lTimeBase,
-		pMIDIData->m_lUser1,
-		pMIDIData->m_lUser2,
-		pMIDIData->m_lUser3,
-		pMIDIData->m_lUserFlag);
-	forEachTrack (pMIDIData, pMIDITrack) {
-		MIDITrack_CountEvent (pMIDITrack),
-		fprintf (pFile, "MTrk %lX %lX %lX %lX %lX %lX\n",
-			pMIDITrack->m_lTempIndex,
-			pMIDITrack->m_lNumEvent,
-			pMIDITrack->m_lUser1,
-			pMIDITrack->m_lUser2,
-			pMIDITrack->m_lUser3,
-			pMIDITrack->m_lUserFlag);
-		j = 0;
-		forEachEvent (pMIDITrack, pMIDIEvent) {
-			fprintf (pFile, "MEvt %lX %lX %lX %lX",
-				pMIDIEvent->m_lTempIndex,
-				pMIDIEvent->m_lTime,
-				pMIDIEvent->m_lKind,
-				pMIDIEvent->m_lLen);
-			for (k = 0; k < pMIDIEvent->m_lLen; k++) {
-				fprintf (pFile, " %X", *(pMIDIEvent->m_pData + k));
-			}
-			fprintf (pFile, " %lX %lX %lX %lX %lX %lX\n",
-				pMIDIEvent->m_pPrevCombinedEvent ? pMIDIEvent->m_pPrevCombinedEvent->m_lTempIndex : -1,
-				pMIDIEvent->m_pNextCombinedEvent ? pMIDIEvent->m_pNextCombinedEvent->m_lTempIndex : -1,
-				pMIDIEvent->m_lUser1,
-				pMIDIEvent->m_lUser2,
-				pMIDIEvent->m_lUser3,
-				pMIDIEvent->m_lUserFlag);
-			j++;
-		}
-		i++;
+	lRet = MIDIData_SaveAsTextStream (pMIDIData, &theStream);
+	MIDIDataStream_Close (&theStream);
+	return lRet;
+}
+
+/* MIDIDataをテキストファイル(*.txt)として保存(デバッグ用隠し関数)(メモリブロック)(20261019追加) */
+/* 保存したデータは*ppDataに、その長さは*pLenに返す。*ppDataはMIDIDataLib_FreeMemoryで解放すること。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsTextMemory (MIDIData* pMIDIData, void** ppData, long* pLen) {
+	MIDIDataStream theStream;
+	MIDIDataStream_CreateMemory (&theStream, 1);
+	if (MIDIData_SaveAsTextStream (pMIDIData, &theStream) == 0) {
+		MIDIDataStream_Close (&theStream);
+		return 0;
 	}
-	fclose (pFile);
-	return 1;
+	return MIDIDataStream_DetachMemory (&theStream, ppData, pLen);
 }
 
 /* MIDIEventをバイナリファイルから読み込み(隠蔽) */
 /* 新しいMIDIEventへのポインタを返す(失敗時NULL) */
-MIDIEvent* __stdcall MIDIEvent_LoadFromBinary (FILE* pFile) {
+MIDIEvent* __stdcall MIDIEvent_LoadFromBinary (MIDIDataStream* pStream) {
 	long lRet = 0;
 	char szType[4] = {0, 0, 0, 0};
 	long lIndex = 0;
 	long lTime = 0;
 	long lKind = 0;
 	long lLen = 0;
-	unsigned char ucData[16384];
+	unsigned char ucData[4] = {0, 0, 0, 0};
+	unsigned char* pData = ucData;
+	unsigned char* pAllocData = NULL;
 	long lPrevCombinedEvent = 0;
 	long lNextCombinedEvent = 0;
 	long lReserved1 = 0;
@@ -9543,56 +10147,76 @@ MIDIEvent* __stdcall MIDIEvent_LoadFromBinary (FILE* pFile) {
 	long lUserFlag = 0;
 	MIDIEvent* pMIDIEvent = NULL;
 	/* プロパティ読み込み */
-	lRet = size_ttolong (fread (szType, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (szType, 4, 1, pStream));
 	if (lRet < 1 || memcmp (szType, "MEvt", 4) != 0) {
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lIndex, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lIndex, 4, 1, pStream));
 	if (lRet < 1 || lIndex < 0) {
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lTime, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lTime, 4, 1, pStream));
 	if (lRet < 1 || lTime < 0) {
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lKind, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lKind, 4, 1, pStream));
 	if (lRet < 1 || lKind < 0) {
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lLen, 4, 1, pFile));
-	if (lRet < 1 || lLen < 0 || lLen >= sizeof (ucData)) {
+	lRet = size_ttolong (MIDIDataStream_Read (&lLen, 4, 1, pStream));
+	if (lRet < 1 || lLen < 0) {
 		return NULL;
 	}
-	lRet = size_ttolong (fread (ucData, 1, lLen, pFile));
-	if (lRet < lLen) {
-		return NULL;
+	/* データ部はメモリからの場合は複写せずに参照し、ファイルからの場合はヒープに読み込む */
+	/* (16KBのスタック上のバッファを廃止し、16KB以上のデータも読み込めるようにした)(20261019変更) */
+	if (lLen > 0) {
+		pData = MIDIDataStream_Map (pStream, lLen);
+		if (pData == NULL) {
+			pAllocData = malloc (lLen);
+			if (pAllocData == NULL) {
+				return NULL;
+			}
+			pData = pAllocData;
+			lRet = size_ttolong (MIDIDataStream_Read (pData, 1, lLen, pStream));
+			if (lRet < lLen) {
+				free (pAllocData);
+				return NULL;
+			}
+		}
 	}
-	lRet = size_ttolong (fread (&lPrevCombinedEvent, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lPrevCombinedEvent, 4, 1, pStream));
 	if (lRet < 1) {
+		free (pAllocData);
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lNextCombinedEvent, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lNextCombinedEvent, 4, 1, pStream));
 	if (lRet < 1) {
+		free (pAllocData);
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lUser1, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lUser1, 4, 1, pStream));
 	if (lRet < 1) {
+		free (pAllocData);
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lUser2, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lUser2, 4, 1, pStream));
 	if (lRet < 1) {
+		free (pAllocData);
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lUser3, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lUser3, 4, 1, pStream));
 	if (lRet < 1) {
+		free (pAllocData);
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lUserFlag, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lUserFlag, 4, 1, pStream));
 	if (lRet < 1) {
+		free (pAllocData);
 		return NULL;
 	}
 	/* MIDIイベントの生成 */
-	pMIDIEvent = MIDIEvent_Create (lTime, lKind, ucData, lLen);
+	pMIDIEvent = MIDIEvent_Create (lTime, lKind, pData, lLen);
+	free (pAllocData);
 	if (pMIDIEvent == NULL) {
 		return NULL;
 	}
@@ -9610,7 +10234,7 @@ MIDIEvent* __stdcall MIDIEvent_LoadFromBinary (FILE* pFile) {
 
 /* MIDITrackをバイナリファイルから読み込み(隠蔽) */
 /* 新しいMIDITrackへのポインタを返す(失敗時NULL) */
-MIDITrack* __stdcall MIDITrack_LoadFromBinary (FILE* pFile) {
+MIDITrack* __stdcall MIDITrack_LoadFromBinary (MIDIDataStream* pStream) {
 	long lRet = 0;
 	char szType[4] = {0, 0, 0, 0};
 	long lIndex = 0;
@@ -9640,98 +10264,98 @@ MIDITrack* __stdcall MIDITrack_LoadFromBinary (FILE* pFile) {
 	MIDIEvent* pMIDIEvent = NULL;
 	
 	/* プロパティ読み込み・設定 */
-	lRet = size_ttolong (fread (szType, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (szType, 4, 1, pStream));
 	if (lRet < 1 || (memcmp (szType, "MTrk", 4) != 0 && memcmp (szType, "MTr2", 4) != 0)) {
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lIndex, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lIndex, 4, 1, pStream));
 	if (lRet < 1 || lIndex < 0) {
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lNumEvent, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lNumEvent, 4, 1, pStream));
 	if (lRet < 1 || lNumEvent < 0) {
 		return NULL;
 	}
 	/* MIDIDataLib1.4から追加した項目(20081008追加) */
 	if (memcmp (szType, "MTr2", 4) == 0) {
-		lRet = size_ttolong (fread (&lInputOn, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lInputOn, 4, 1, pStream));
 		if (lRet < 1) {
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lInputPort, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lInputPort, 4, 1, pStream));
 		if (lRet < 1) {
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lInputChannel, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lInputChannel, 4, 1, pStream));
 		if (lRet < 1) {
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lOutputOn, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lOutputOn, 4, 1, pStream));
 		if (lRet < 1) {
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lOutputPort, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lOutputPort, 4, 1, pStream));
 		if (lRet < 1) {
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lOutputChannel, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lOutputChannel, 4, 1, pStream));
 		if (lRet < 1) {
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lTimePlus, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lTimePlus, 4, 1, pStream));
 		if (lRet < 1) {
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lKeyPlus, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lKeyPlus, 4, 1, pStream));
 		if (lRet < 1) {
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lVelocityPlus, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lVelocityPlus, 4, 1, pStream));
 		if (lRet < 1) {
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lViewMode, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lViewMode, 4, 1, pStream));
 		if (lRet < 1) {
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lForeColor, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lForeColor, 4, 1, pStream));
 		if (lRet < 1) {
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lBackColor, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lBackColor, 4, 1, pStream));
 		if (lRet < 1) {
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lReserved1, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lReserved1, 4, 1, pStream));
 		if (lRet < 1) {
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lReserved2, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lReserved2, 4, 1, pStream));
 		if (lRet < 1) {
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lReserved3, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lReserved3, 4, 1, pStream));
 		if (lRet < 1) {
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lReserved4, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lReserved4, 4, 1, pStream));
 		if (lRet < 1) {
 			return NULL;
 		}
 	}
-	lRet = size_ttolong (fread (&lUser1, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lUser1, 4, 1, pStream));
 	if (lRet < 1) {
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lUser2, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lUser2, 4, 1, pStream));
 	if (lRet < 1) {
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lUser3, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lUser3, 4, 1, pStream));
 	if (lRet < 1) {
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lUserFlag, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lUserFlag, 4, 1, pStream));
 	if (lRet < 1) {
 		return NULL;
 	}
@@ -9787,7 +10411,7 @@ MIDITrack* __stdcall MIDITrack_LoadFromBinary (FILE* pFile) {
 	/* このトラック内の各MIDIEventについて */
 	for (j = 0; j < lNumEvent; j++) {
 		/* MIDIイベントを1つ読み込み */
-		pMIDIEvent = MIDIEvent_LoadFromBinary (pFile);
+		pMIDIEvent = MIDIEvent_LoadFromBinary (pStream);
 		if (pMIDIEvent == NULL) {
 			return NULL;
 		}
@@ -9835,9 +10459,9 @@ MIDITrack* __stdcall MIDITrack_LoadFromBinary (FILE* pFile) {
 }
 
 
-/* MIDIDataをバイナリファイルから読み込み(ANSI) */
-/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
-MIDIData* __stdcall MIDIData_LoadFromBinaryA (const char* pszFileName) {
+/* MIDIDataをバイナリファイルから読み込み */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(非公開)(20261019追加) */
+static MIDIData* MIDIData_LoadFromBinaryStream (MIDIDataStream* pStream) {
 	long lRet = 0;
 	char szType[4] = {0, 0, 0, 0};
 	long lFormat = 0;
@@ -9854,34 +10478,23 @@ MIDIData* __stdcall MIDIData_LoadFromBinaryA (const char* pszFileName) {
 	long lUser3 = 0;
 	long lUserFlag = 0;
 	MIDIData* pMIDIData = NULL;
-	errno_t nErrorNo = 0;
-	FILE* pFile = NULL;
 	long i = 0;
 
-	/* ファイルを開く */
-	nErrorNo = fopen_s (&pFile, pszFileName, "rb");
-	if (pFile == NULL) {
-		return NULL;
-	}
 	/* MIDIDataについてプロパティ読み込み */
-	lRet = size_ttolong (fread (szType, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (szType, 4, 1, pStream));
 	if (lRet < 1 || (memcmp (szType, "MDat", 4) != 0 && memcmp (szType, "MDa2", 4) != 0)) {
-		fclose (pFile);
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lFormat, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lFormat, 4, 1, pStream));
 	if (lRet < 1 || lFormat < 0 || lFormat > 2) {
-		fclose (pFile);
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lNumTrack, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lNumTrack, 4, 1, pStream));
 	if (lRet < 1 || lNumTrack < 0 || lNumTrack > MIDIDATA_MAXMIDITRACKNUM) {
-		fclose (pFile);
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lTimeBase, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lTimeBase, 4, 1, pStream));
 	if (lRet < 1 || lTimeBase <= 0 || lTimeBase >= 65536) {
-		fclose (pFile);
 		return NULL;
 	}
 	if (lTimeBase & 0x00008000) {
@@ -9890,7 +10503,6 @@ MIDIData* __stdcall MIDIData_LoadFromBinaryA (const char* pszFileName) {
 			lTimeMode != MIDIDATA_SMPTE25BASE &&
 			lTimeMode != MIDIDATA_SMPTE29BASE &&
 			lTimeMode != MIDIDATA_SMPTE30BASE) {
-			fclose (pFile);
 			return NULL;
 		}
 		lTimeResolution = lTimeBase & 0x000000FF;
@@ -9899,55 +10511,46 @@ MIDIData* __stdcall MIDIData_LoadFromBinaryA (const char* pszFileName) {
 		lTimeMode =  MIDIDATA_TPQNBASE;
 		lTimeResolution = lTimeBase & 0x00007FFF;
 	}
-	
+
 	/* MIDIDataLib1.4から追加した項目(20081008追加) */
 	if (memcmp (szType, "MDa2", 4) == 0) {
-		lRet = size_ttolong (fread (&lReserved1, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lReserved1, 4, 1, pStream));
 		if (lRet < 1) {
-			fclose (pFile);
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lReserved2, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lReserved2, 4, 1, pStream));
 		if (lRet < 1) {
-			fclose (pFile);
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lReserved3, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lReserved3, 4, 1, pStream));
 		if (lRet < 1) {
-			fclose (pFile);
 			return NULL;
 		}
-		lRet = size_ttolong (fread (&lReserved4, 4, 1, pFile));
+		lRet = size_ttolong (MIDIDataStream_Read (&lReserved4, 4, 1, pStream));
 		if (lRet < 1) {
-			fclose (pFile);
 			return NULL;
 		}
 	}
-	lRet = size_ttolong (fread (&lUser1, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lUser1, 4, 1, pStream));
 	if (lRet < 1) {
-		fclose (pFile);
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lUser2, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lUser2, 4, 1, pStream));
 	if (lRet < 1) {
-		fclose (pFile);
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lUser3, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lUser3, 4, 1, pStream));
 	if (lRet < 1) {
-		fclose (pFile);
 		return NULL;
 	}
-	lRet = size_ttolong (fread (&lUserFlag, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Read (&lUserFlag, 4, 1, pStream));
 	if (lRet < 1) {
-		fclose (pFile);
 		return NULL;
 	}
 
 	/* MIDIDataの生成及びプロパティ設定 */
 	pMIDIData = MIDIData_Create (lFormat, 0, lTimeMode, lTimeResolution);
 	if (pMIDIData == NULL) {
-		fclose (pFile);
 		return NULL;
 	}
 	/* MIDIDataLib1.4から追加した項目(20081008追加) */
@@ -9972,232 +10575,113 @@ MIDIData* __stdcall MIDIData_LoadFromBinaryA (const char* pszFileName) {
 	/* このファイル内の各MIDITrackについて */
 	for (i = 0; i < lNumTrack; i++) {
 		/* MIDIトラックをひとつ読み込み */
-		MIDITrack* pMIDITrack = MIDITrack_LoadFromBinary (pFile);
+		MIDITrack* pMIDITrack = MIDITrack_LoadFromBinary (pStream);
 		if (pMIDITrack == NULL) {
-			fclose (pFile);
 			MIDIData_Delete (pMIDIData);
 			return NULL;
 		}
 		/* MIDIデータにMIDIトラックを追加 */
 		if (MIDIData_AddTrack (pMIDIData, pMIDITrack) == 0) {
-			fclose (pFile);
 			MIDIData_Delete (pMIDIData);
 			return NULL;
 		}
 	}
-	fclose (pFile);
 	return pMIDIData;
 }
 
-/* MIDIDataをバイナリファイルから読み込み(UNICODE) */
+/* MIDIDataをバイナリファイルから読み込み(ANSI) */
 /* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
-/* ファイル名はUNICODEで与えるがファイルの中身は仕様に基づきANSIである。 */
-MIDIData* __stdcall MIDIData_LoadFromBinaryW (const wchar_t* pszFileName) {
-	long lRet = 0;
-	char szType[4] = {0, 0, 0, 0};
-	long lFormat = 0;
-	long lNumTrack = 0;
-	long lTimeBase = 0;
-	long lTimeMode = 0;
-	long lTimeResolution = 0;
-	long lReserved1 = 0;
-	long lReserved2 = 0;
-	long lReserved3 = 0;
-	long lReserved4 = 0;
-	long lUser1 = 0;
-	long lUser2 = 0;
-	long lUser3 = 0;
-	long lUserFlag = 0;
+MIDIData* __stdcall MIDIData_LoadFromBinaryA (const char* pszFileName) {
+	MIDIDataStream theStream;
 	MIDIData* pMIDIData = NULL;
-	long i = 0;
-	errno_t nErrorNo = 0;
-	FILE* pFile = NULL;
-
-	/* ファイルを開く */
-	nErrorNo = _wfopen_s (&pFile, pszFileName, L"rb");
-	if (pFile == NULL) {
-		return NULL;
-	}
-	/* MIDIDataについてプロパティ読み込み */
-	lRet = size_ttolong (fread (szType, 4, 1, pFile));
-	if (lRet < 1 || (memcmp (szType, "MDat", 4) != 0 && memcmp (szType, "MDa2", 4) != 0)) {
-		fclose (pFile);
-		return NULL;
-	}
-	lRet = size_ttolong (fread (&lFormat, 4, 1, pFile));
-	if (lRet < 1 || lFormat < 0 || lFormat > 2) {
-		fclose (pFile);
-		return NULL;
-	}
-	lRet = size_ttolong (fread (&lNumTrack, 4, 1, pFile));
-	if (lRet < 1 || lNumTrack < 0 || lNumTrack > MIDIDATA_MAXMIDITRACKNUM) {
-		fclose (pFile);
-		return NULL;
-	}
-	lRet = size_ttolong (fread (&lTimeBase, 4, 1, pFile));
-	if (lRet < 1 || lTimeBase <= 0 || lTimeBase >= 65536) {
-		fclose (pFile);
+	if (MIDIDataStream_OpenFileA (&theStream, pszFileName, "rb") == 0) {
 		return NULL;
 	}
-	if (lTimeBase & 0x00008000) {
-		lTimeMode = 256 - ((lTimeBase & 0x0000FF00) >> 8);
-		if (lTimeMode != MIDIDATA_SMPTE24BASE &&
-			lTimeMode != MIDIDATA_SMPTE25BASE &&
-			lTimeMode != MIDIDATA_SMPTE29BASE &&
-			lTimeMode != MIDIDATA_SMPTE30BASE) {
-			fclose (pFile);
-			return NULL;
-		}
-		lTimeResolution = lTimeBase & 0x000000FF;
-	}
-	else {
-		lTimeMode =  MIDIDATA_TPQNBASE;
-		lTimeResolution = lTimeBase & 0x00007FFF;
-	}
+	pMIDIData = MIDIData_LoadFromBinaryStream (&theStream);
+	MIDIDataStream_Close (&theStream);
+	return pMIDIData;
+}
 
-	/* MIDIDataLib1.4から追加した項目(20081008追加) */
-	if (memcmp (szType, "MDa2", 4) == 0) {
-		lRet = size_ttolong (fread (&lReserved1, 4, 1, pFile));
-		if (lRet < 1) {
-			fclose (pFile);
-			return NULL;
-		}
-		lRet = size_ttolong (fread (&lReserved2, 4, 1, pFile));
-		if (lRet < 1) {
-			fclose (pFile);
-			return NULL;
-		}
-		lRet = size_ttolong (fread (&lReserved3, 4, 1, pFile));
-		if (lRet < 1) {
-			fclose (pFile);
-			return NULL;
-		}
-		lRet = size_ttolong (fread (&lReserved4, 4, 1, pFile));
-		if (lRet < 1) {
-			fclose (pFile);
-			return NULL;
-		}
-	}
-	lRet = size_ttolong (fread (&lUser1, 4, 1, pFile));
-	if (lRet < 1) {
-		fclose (pFile);
-		return NULL;
-	}
-	lRet = size_ttolong (fread (&lUser2, 4, 1, pFile));
-	if (lRet < 1) {
-		fclose (pFile);
-		return NULL;
-	}
-	lRet = size_ttolong (fread (&lUser3, 4, 1, pFile));
-	if (lRet < 1) {
-		fclose (pFile);
-		return NULL;
-	}
-	lRet = size_ttolong (fread (&lUserFlag, 4, 1, pFile));
-	if (lRet < 1) {
-		fclose (pFile);
+/* MIDIDataをバイナリファイルから読み込み(UNICODE) */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+/* ファイル名はUNICODEで与えるがファイルの中身は仕様に基づきANSIである。 */
+MIDIData* __stdcall MIDIData_LoadFromBinaryW (const wchar_t* pszFileName) {
+	MIDIDataStream theStream;
+	MIDIData* pMIDIData = NULL;
+	if (MIDIDataStream_OpenFileW (&theStream, pszFileName, L"rb") == 0) {
 		return NULL;
 	}
+	pMIDIData = MIDIData_LoadFromBinaryStream (&theStream);
+	MIDIDataStream_Close (&theStream);
+	return pMIDIData;
+}
 
-	/* MIDIDataの生成及びプロパティ設定 */
-	pMIDIData = MIDIData_Create (lFormat, 0, lTimeMode, lTimeResolution);
-	if (pMIDIData == NULL) {
-		fclose (pFile);
+/* MIDIDataをバイナリファイルから読み込み(メモリブロック)(20261019追加) */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+MIDIData* __stdcall MIDIData_LoadFromBinaryMemory (const void* pData, long lLen) {
+	MIDIDataStream theStream;
+	/* 引数の検査 */
+	if (pData == NULL || lLen < 0) {
 		return NULL;
 	}
-	/* MIDIDataLib1.4から追加した項目(20081008追加) */
-	if (memcmp (szType, "MDa2", 4) == 0) {
-		pMIDIData->m_lReserved1 = lReserved1;
-		pMIDIData->m_lReserved2 = lReserved2;
-		pMIDIData->m_lReserved3 = lReserved3;
-		pMIDIData->m_lReserved4 = lReserved4;
-	}
-	/* MIDIDataLib1.3以前(20081008追加) */
-	else {
-		pMIDIData->m_lReserved1 = 0;
-		pMIDIData->m_lReserved2 = 0;
-		pMIDIData->m_lReserved3 = 0;
-		pMIDIData->m_lReserved4 = 0;
-	}
-	pMIDIData->m_lUser1 = lUser1;
-	pMIDIData->m_lUser2 = lUser2;
-	pMIDIData->m_lUser3 = lUser3;
-	pMIDIData->m_lUserFlag = lUserFlag;
-
-	/* このファイル内の各MIDITrackについて */
-	for (i = 0; i < lNumTrack; i++) {
-		/* MIDIトラックをひとつ読み込み */
-		MIDITrack* pMIDITrack = MIDITrack_LoadFromBinary (pFile);
-		if (pMIDITrack == NULL) {
-			fclose (pFile);
-			MIDIData_Delete (pMIDIData);
-			return NULL;
-		}
-		/* MIDIデータにMIDIトラックを追加 */
-		if (MIDIData_AddTrack (pMIDIData, pMIDITrack) == 0) {
-			fclose (pFile);
-			MIDIData_Delete (pMIDIData);
-			return NULL;
-		}
-	}
-	fclose (pFile);
-	return pMIDIData;
+	MIDIDataStream_OpenMemory (&theStream, pData, lLen, 0);
+	return MIDIData_LoadFromBinaryStream (&theStream);
 }
 
 
 /* MIDIEventをバイナリファイルに保存(隠蔽) */
-long __stdcall MIDIEvent_SaveAsBinary (MIDIEvent* pMIDIEvent, FILE* pFile) {
+long __stdcall MIDIEvent_SaveAsBinary (MIDIEvent* pMIDIEvent, MIDIDataStream* pStream) {
 	long lRet;
 	long lNullIndex = -1;
-	lRet = size_ttolong (fwrite ("MEvt", 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write ("MEvt", 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIEvent->m_lTempIndex), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIEvent->m_lTempIndex), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIEvent->m_lTime), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIEvent->m_lTime), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIEvent->m_lKind), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIEvent->m_lKind), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIEvent->m_lLen), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIEvent->m_lLen), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
 	if (pMIDIEvent->m_pData != NULL && pMIDIEvent->m_lLen > 0) { /* 20091024条件式追加 */
-		lRet = size_ttolong (fwrite (pMIDIEvent->m_pData, 1, pMIDIEvent->m_lLen, pFile));
+		lRet = size_ttolong (MIDIDataStream_Write (pMIDIEvent->m_pData, 1, pMIDIEvent->m_lLen, pStream));
 		if (lRet < pMIDIEvent->m_lLen) {
 			return 0;
 		}
 	}
-	lRet = size_ttolong (fwrite (pMIDIEvent->m_pPrevCombinedEvent ? 
-		&(pMIDIEvent->m_pPrevCombinedEvent->m_lTempIndex) : &lNullIndex, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (pMIDIEvent->m_pPrevCombinedEvent ? 
+		&(pMIDIEvent->m_pPrevCombinedEvent->m_lTempIndex) : &lNullIndex, 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (pMIDIEvent->m_pNextCombinedEvent ? 
-		&(pMIDIEvent->m_pNextCombinedEvent->m_lTempIndex) : &lNullIndex, 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (pMIDIEvent->m_pNextCombinedEvent ? 
+		&(pMIDIEvent->m_pNextCombinedEvent->m_lTempIndex) : &lNullIndex, 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIEvent->m_lUser1), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIEvent->m_lUser1), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIEvent->m_lUser2), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIEvent->m_lUser2), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIEvent->m_lUser3), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIEvent->m_lUser3), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIEvent->m_lUserFlag), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIEvent->m_lUserFlag), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
@@ -10205,105 +10689,105 @@ long __stdcall MIDIEvent_SaveAsBinary (MIDIEvent* pMIDIEvent, FILE* pFile) {
 }
 
 /* MIDITrackをバイナリファイルに保存(隠蔽) */
-long __stdcall MIDITrack_SaveAsBinary (MIDITrack* pMIDITrack, FILE* pFile) {
+long __stdcall MIDITrack_SaveAsBinary (MIDITrack* pMIDITrack, MIDIDataStream* pStream) {
 	long lEventCount = MIDITrack_CountEvent (pMIDITrack);
 	long lRet;
 	MIDIEvent* pMIDIEvent;
-	lRet = size_ttolong (fwrite ("MTr2", 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write ("MTr2", 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lTempIndex), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lTempIndex), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lNumEvent), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lNumEvent), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lInputOn), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lInputOn), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lInputPort), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lInputPort), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lInputChannel), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lInputChannel), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lOutputOn), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lOutputOn), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lOutputPort), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lOutputPort), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lOutputChannel), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lOutputChannel), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lTimePlus), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lTimePlus), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lKeyPlus), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lKeyPlus), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lVelocityPlus), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lVelocityPlus), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lViewMode), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lViewMode), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lForeColor), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lForeColor), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lBackColor), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lBackColor), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lReserved1), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lReserved1), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lReserved2), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lReserved2), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lReserved3), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lReserved3), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lReserved4), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lReserved4), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lUser1), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lUser1), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lUser2), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lUser2), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lUser3), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lUser3), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDITrack->m_lUserFlag), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDITrack->m_lUserFlag), 4, 1, pStream));
 	if (lRet < 1) {
 		return 0;
 	}
 	/* このMIDIトラック内の各イベントについて */
 	forEachEvent (pMIDITrack, pMIDIEvent) {
-		long lRet = MIDIEvent_SaveAsBinary (pMIDIEvent, pFile);
+		long lRet = MIDIEvent_SaveAsBinary (pMIDIEvent, pStream);
 		if (lRet == 0) {
 			return 0;
 		}
@@ -10311,188 +10795,1196 @@ long __stdcall MIDITrack_SaveAsBinary (MIDITrack* pMIDITrack, FILE* pFile) {
 	return 1;
 }
 
-/* MIDIDataをバイナリファイルに保存(ANSI) */
+/* MIDIDataをバイナリファイルに保存(非公開)(20261019追加) */
 /* 戻り値：正常終了=1、異常終了=0。 */
-long __stdcall MIDIData_SaveAsBinaryA (MIDIData* pMIDIData, const char* pszFileName) {
+static long MIDIData_SaveAsBinaryStream (MIDIData* pMIDIData, MIDIDataStream* pStream) {
 	MIDITrack* pMIDITrack = NULL;
 	long lRet = 0;
 	long lTrackCount = 0;
-	errno_t nErrorNo = 0;
-	FILE* pFile = NULL;
-	nErrorNo = fopen_s (&pFile, pszFileName, "wb");
-		return 0;
-	if (pFile == NULL) {
-	}
 	/* MIDIDataについて */
 	lTrackCount = MIDIData_CountTrack (pMIDIData);
-	lRet = size_ttolong (fwrite ("MDa2", 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write ("MDa2", 4, 1, pStream));
 	if (lRet < 1) {
-		fclose (pFile);
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lFormat), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIData->m_lFormat), 4, 1, pStream));
 	if (lRet < 1) {
-		fclose (pFile);
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lNumTrack), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIData->m_lNumTrack), 4, 1, pStream));
 	if (lRet < 1) {
-		fclose (pFile);
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lTimeBase), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIData->m_lTimeBase), 4, 1, pStream));
 	if (lRet < 1) {
-		fclose (pFile);
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lReserved1), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIData->m_lReserved1), 4, 1, pStream));
 	if (lRet < 1) {
-		fclose (pFile);
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lReserved2), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIData->m_lReserved2), 4, 1, pStream));
 	if (lRet < 1) {
-		fclose (pFile);
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lReserved3), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIData->m_lReserved3), 4, 1, pStream));
 	if (lRet < 1) {
-		fclose (pFile);
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lReserved4), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIData->m_lReserved4), 4, 1, pStream));
 	if (lRet < 1) {
-		fclose (pFile);
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lUser1), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIData->m_lUser1), 4, 1, pStream));
 	if (lRet < 1) {
-		fclose (pFile);
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lUser2), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIData->m_lUser2), 4, 1, pStream));
 	if (lRet < 1) {
-		fclose (pFile);
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lUser3), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIData->m_lUser3), 4, 1, pStream));
 	if (lRet < 1) {
-		fclose (pFile);
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lUserFlag), 4, 1, pFile));
+	lRet = size_ttolong (MIDIDataStream_Write (&(pMIDIData->m_lUserFlag), 4, 1, pStream));
 	if (lRet < 1) {
-		fclose (pFile);
 		return 0;
 	}
 	/* このMIDIデータ内の各トラックについて */
 	forEachTrack (pMIDIData, pMIDITrack) {
-		lRet = MIDITrack_SaveAsBinary (pMIDITrack, pFile);
+		lRet = MIDITrack_SaveAsBinary (pMIDITrack, pStream);
 		if (lRet == 0) {
-			fclose (pFile);
 			return 0;
 		}
 	}
-	fclose (pFile);
 	return 1;
 }
 
+/* MIDIDataをバイナリファイルに保存(ANSI) */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsBinaryA (MIDIData* pMIDIData, const char* pszFileName) {
+	MIDIDataStream theStream;
+	long lRet = 0;
+	if (MIDIDataStream_OpenFileA (&theStream, pszFileName, "wb") == 0) {
+		return 0;
+	}
+	lRet = MIDIData_SaveAsBinaryStream (pMIDIData, &theStream);
+	MIDIDataStream_Close (&theStream);
+	return lRet;
+}
+
 /* MIDIDataをバイナリファイルに保存(UNICODE) */
 /* ファイル名はUNICODEで与えるがファイルの中身は仕様に基づきANSIである。 */
 /* 戻り値：正常終了=1、異常終了=0。 */
 long __stdcall MIDIData_SaveAsBinaryW (MIDIData* pMIDIData, const wchar_t* pszFileName) {
-	MIDITrack* pMIDITrack = NULL;
+	MIDIDataStream theStream;
 	long lRet = 0;
-	long lTrackCount = 0;
-	errno_t nErrorNo = 0;
-	FILE* pFile = NULL;
-	nErrorNo = _wfopen_s (&pFile, pszFileName, L"wb");
-	if (pFile == NULL) {
+	if (MIDIDataStream_OpenFileW (&theStream, pszFileName, L"wb") == 0) {
 		return 0;
 	}
-	/* MIDIDataについて */
-	lTrackCount = MIDIData_CountTrack (pMIDIData);
-	lRet = size_ttolong (fwrite ("MDa2", 4, 1, pFile));
-	if (lRet < 1) {
-		fclose (pFile);
+	lRet = MIDIData_SaveAsBinaryStream (pMIDIData, &theStream);
+	MIDIDataStream_Close (&theStream);
+	return lRet;
+}
+
+/* MIDIDataをバイナリファイルに保存(メモリブロック)(20261019追加) */
+/* 保存したデータは*ppDataに、その長さは*pLenに返す。*ppDataはMIDIDataLib_FreeMemoryで解放すること。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsBinaryMemory (MIDIData* pMIDIData, void** ppData, long* pLen) {
+	MIDIDataStream theStream;
+	MIDIDataStream_CreateMemory (&theStream, 0);
+	if (MIDIData_SaveAsBinaryStream (pMIDIData, &theStream) == 0) {
+		MIDIDataStream_Close (&theStream);
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lFormat), 4, 1, pFile));
-	if (lRet < 1) {
-		fclose (pFile);
+	return MIDIDataStream_DetachMemory (&theStream, ppData, pLen);
+}
+
+/* MIDIDataをスナップショット(*.mds)として保存(非公開)(20261019追加) */
+/* 1回目の走査で各トラックのイベント数とデータ領域の長さから全ての位置を決め、 */
+/* 2回目の走査でヘッダー・トラック索引・イベント配列・データ領域の順に書き出す。 */
+/* 結合イベントの参照にはトラック内インデックスを用いるため、m_lTempIndexを書き換える。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+static long MIDIData_SaveAsSnapshotStream (MIDIData* pMIDIData, MIDIDataStream* pStream) {
+	static const unsigned char byZero[MIDIDATASNAPSHOT_ALIGN] = {0};
+	MIDIDataSnapshotHeader theHeader;
+	MIDIDataSnapshotTrack* pSnapshotTrack = NULL;
+	MIDIDataSnapshotEvent theEvent;
+	MIDITrack* pMIDITrack = NULL;
+	MIDIEvent* pMIDIEvent = NULL;
+	long lNumTrack = 0;
+	long lDataOffset = 0;
+	long lPadLen = 0;
+	long lRet = 0;
+	long i = 0;
+	long j = 0;
+	int64_t llOffset = 0;
+	int64_t llDataLen = 0;
+	assert (pMIDIData);
+	assert (sizeof (MIDIDataSnapshotHeader) % MIDIDATASNAPSHOT_ALIGN == 0);
+	assert (sizeof (MIDIDataSnapshotTrack) % MIDIDATASNAPSHOT_ALIGN == 0);
+	lNumTrack = MIDIData_CountTrack (pMIDIData);
+	pSnapshotTrack = calloc (MAX (lNumTrack, 1), sizeof (MIDIDataSnapshotTrack));
+	if (pSnapshotTrack == NULL) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lNumTrack), 4, 1, pFile));
-	if (lRet < 1) {
-		fclose (pFile);
-		return 0;
+	/* 各部分の位置の決定 */
+	llOffset = sizeof (MIDIDataSnapshotHeader) + (int64_t)lNumTrack * sizeof (MIDIDataSnapshotTrack);
+	i = 0;
+	forEachTrack (pMIDIData, pMIDITrack) {
+		j = 0;
+		llDataLen = 0;
+		forEachEvent (pMIDITrack, pMIDIEvent) {
+			pMIDIEvent->m_lTempIndex = j;
+			llDataLen += pMIDIEvent->m_lLen;
+			j++;
+		}
+		pSnapshotTrack[i].m_lNumEvent = j;
+		pSnapshotTrack[i].m_lEventOffset = (long)llOffset;
+		llOffset += (int64_t)j * sizeof (MIDIDataSnapshotEvent);
+		llOffset += (MIDIDATASNAPSHOT_ALIGN - llOffset % MIDIDATASNAPSHOT_ALIGN) % MIDIDATASNAPSHOT_ALIGN;
+		pSnapshotTrack[i].m_lDataOffset = (long)llOffset;
+		pSnapshotTrack[i].m_lDataLen = (long)MIN (llDataLen, LONG_MAX);
+		llOffset += llDataLen;
+		llOffset += (MIDIDATASNAPSHOT_ALIGN - llOffset % MIDIDATASNAPSHOT_ALIGN) % MIDIDATASNAPSHOT_ALIGN;
+		/* 全体が2GBを超える場合は保存できない */
+		if (llOffset > LONG_MAX) {
+			goto exit;
+		}
+		pSnapshotTrack[i].m_lInputOn = pMIDITrack->m_lInputOn;
+		pSnapshotTrack[i].m_lInputPort = pMIDITrack->m_lInputPort;
+		pSnapshotTrack[i].m_lInputChannel = pMIDITrack->m_lInputChannel;
+		pSnapshotTrack[i].m_lOutputOn = pMIDITrack->m_lOutputOn;
+		pSnapshotTrack[i].m_lOutputPort = pMIDITrack->m_lOutputPort;
+		pSnapshotTrack[i].m_lOutputChannel = pMIDITrack->m_lOutputChannel;
+		pSnapshotTrack[i].m_lTimePlus = pMIDITrack->m_lTimePlus;
+		pSnapshotTrack[i].m_lKeyPlus = pMIDITrack->m_lKeyPlus;
+		pSnapshotTrack[i].m_lVelocityPlus = pMIDITrack->m_lVelocityPlus;
+		pSnapshotTrack[i].m_lViewMode = pMIDITrack->m_lViewMode;
+		pSnapshotTrack[i].m_lForeColor = pMIDITrack->m_lForeColor;
+		pSnapshotTrack[i].m_lBackColor = pMIDITrack->m_lBackColor;
+		pSnapshotTrack[i].m_lReserved1 = pMIDITrack->m_lReserved1;
+		pSnapshotTrack[i].m_lReserved2 = pMIDITrack->m_lReserved2;
+		pSnapshotTrack[i].m_lReserved3 = pMIDITrack->m_lReserved3;
+		pSnapshotTrack[i].m_lReserved4 = pMIDITrack->m_lReserved4;
+		pSnapshotTrack[i].m_lUser1 = pMIDITrack->m_lUser1;
+		pSnapshotTrack[i].m_lUser2 = pMIDITrack->m_lUser2;
+		pSnapshotTrack[i].m_lUser3 = pMIDITrack->m_lUser3;
+		pSnapshotTrack[i].m_lUserFlag = pMIDITrack->m_lUserFlag;
+		i++;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lTimeBase), 4, 1, pFile));
-	if (lRet < 1) {
-		fclose (pFile);
-		return 0;
+	/* ヘッダーの書き出し */
+	memset (&theHeader, 0, sizeof (MIDIDataSnapshotHeader));
+	memcpy (theHeader.m_szType, "MDsn", 4);
+	theHeader.m_lVersion = MIDIDATASNAPSHOT_VERSION;
+	theHeader.m_lHeaderSize = sizeof (MIDIDataSnapshotHeader);
+	theHeader.m_lTrackSize = sizeof (MIDIDataSnapshotTrack);
+	theHeader.m_lEventSize = sizeof (MIDIDataSnapshotEvent);
+	theHeader.m_lTotalSize = (long)llOffset;
+	theHeader.m_lFormat = pMIDIData->m_lFormat;
+	theHeader.m_lNumTrack = lNumTrack;
+	theHeader.m_lTimeBase = pMIDIData->m_lTimeBase;
+	theHeader.m_lTrackOffset = sizeof (MIDIDataSnapshotHeader);
+	theHeader.m_lReserved1 = pMIDIData->m_lReserved1;
+	theHeader.m_lReserved2 = pMIDIData->m_lReserved2;
+	theHeader.m_lReserved3 = pMIDIData->m_lReserved3;
+	theHeader.m_lReserved4 = pMIDIData->m_lReserved4;
+	theHeader.m_lUser1 = pMIDIData->m_lUser1;
+	theHeader.m_lUser2 = pMIDIData->m_lUser2;
+	theHeader.m_lUser3 = pMIDIData->m_lUser3;
+	theHeader.m_lUserFlag = pMIDIData->m_lUserFlag;
+	if (MIDIDataStream_Write (&theHeader, sizeof (MIDIDataSnapshotHeader), 1, pStream) < 1) {
+		goto exit;
+	}
+	/* トラック索引の書き出し */
+	if (lNumTrack > 0 && MIDIDataStream_Write
+		(pSnapshotTrack, sizeof (MIDIDataSnapshotTrack), lNumTrack, pStream) < (size_t)lNumTrack) {
+		goto exit;
+	}
+	/* 各トラックのイベント配列とデータ領域の書き出し */
+	i = 0;
+	forEachTrack (pMIDIData, pMIDITrack) {
+		lDataOffset = 0;
+		memset (&theEvent, 0, sizeof (MIDIDataSnapshotEvent));
+		forEachEvent (pMIDITrack, pMIDIEvent) {
+			theEvent.m_lTime = pMIDIEvent->m_lTime;
+			theEvent.m_lKind = pMIDIEvent->m_lKind;
+			theEvent.m_lLen = pMIDIEvent->m_lLen;
+			theEvent.m_lDataOffset = lDataOffset;
+			theEvent.m_lPrevCombinedEvent = pMIDIEvent->m_pPrevCombinedEvent ?
+				pMIDIEvent->m_pPrevCombinedEvent->m_lTempIndex : -1;
+			theEvent.m_lNextCombinedEvent = pMIDIEvent->m_pNextCombinedEvent ?
+				pMIDIEvent->m_pNextCombinedEvent->m_lTempIndex : -1;
+			theEvent.m_lUser1 = pMIDIEvent->m_lUser1;
+			theEvent.m_lUser2 = pMIDIEvent->m_lUser2;
+			theEvent.m_lUser3 = pMIDIEvent->m_lUser3;
+			theEvent.m_lUserFlag = pMIDIEvent->m_lUserFlag;
+			if (MIDIDataStream_Write (&theEvent, sizeof (MIDIDataSnapshotEvent), 1, pStream) < 1) {
+				goto exit;
+			}
+			lDataOffset += pMIDIEvent->m_lLen;
+		}
+		lPadLen = pSnapshotTrack[i].m_lDataOffset - pSnapshotTrack[i].m_lEventOffset -
+			pSnapshotTrack[i].m_lNumEvent * (long)sizeof (MIDIDataSnapshotEvent);
+		if (MIDIDataStream_Write (byZero, 1, lPadLen, pStream) < (size_t)lPadLen) {
+			goto exit;
+		}
+		forEachEvent (pMIDITrack, pMIDIEvent) {
+			if (pMIDIEvent->m_lLen > 0 && MIDIDataStream_Write 
+				(pMIDIEvent->m_pData, 1, pMIDIEvent->m_lLen, pStream) < (size_t)pMIDIEvent->m_lLen) {
+				goto exit;
+			}
+		}
+		lPadLen = (MIDIDATASNAPSHOT_ALIGN - lDataOffset % MIDIDATASNAPSHOT_ALIGN) % MIDIDATASNAPSHOT_ALIGN;
+		if (MIDIDataStream_Write (byZero, 1, lPadLen, pStream) < (size_t)lPadLen) {
+			goto exit;
+		}
+		i++;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lReserved1), 4, 1, pFile));
-	if (lRet < 1) {
-		fclose (pFile);
+	lRet = 1;
+	exit:
+	free (pSnapshotTrack);
+	return lRet;
+}
+
+/* MIDIDataをスナップショットファイル(*.mds)に保存(ANSI)(20261019追加) */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsSnapshotA (MIDIData* pMIDIData, const char* pszFileName) {
+	MIDIDataStream theStream;
+	long lRet = 0;
+	if (MIDIDataStream_OpenFileA (&theStream, pszFileName, "wb") == 0) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lReserved2), 4, 1, pFile));
-	if (lRet < 1) {
-		fclose (pFile);
+	lRet = MIDIData_SaveAsSnapshotStream (pMIDIData, &theStream);
+	MIDIDataStream_Close (&theStream);
+	return lRet;
+}
+
+/* MIDIDataをスナップショットファイル(*.mds)に保存(UNICODE)(20261019追加) */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsSnapshotW (MIDIData* pMIDIData, const wchar_t* pszFileName) {
+	MIDIDataStream theStream;
+	long lRet = 0;
+	if (MIDIDataStream_OpenFileW (&theStream, pszFileName, L"wb") == 0) {
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lReserved3), 4, 1, pFile));
-	if (lRet < 1) {
-		fclose (pFile);
+	lRet = MIDIData_SaveAsSnapshotStream (pMIDIData, &theStream);
+	MIDIDataStream_Close (&theStream);
+	return lRet;
+}
+
+/* MIDIDataをスナップショットとしてメモリブロックに保存(20261019追加) */
+/* *ppDataはMIDIDataLib_FreeMemoryで解放すること。戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsSnapshotMemory (MIDIData* pMIDIData, void** ppData, long* pLen) {
+	MIDIDataStream theStream;
+	MIDIDataStream_CreateMemory (&theStream, 0);
+	if (MIDIData_SaveAsSnapshotStream (pMIDIData, &theStream) == 0) {
+		MIDIDataStream_Close (&theStream);
 		return 0;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lReserved4), 4, 1, pFile));
-	if (lRet < 1) {
-		fclose (pFile);
-		return 0;
+	return MIDIDataStream_DetachMemory (&theStream, ppData, pLen);
+}
+
+/* 位置lOffsetから長さlLenの範囲がスナップショット内に収まり、 */
+/* MIDIDATASNAPSHOT_ALIGNバイト境界に置かれているか(非公開)(20261019追加) */
+static long MIDIDataSnapshot_IsValidRange (long lOffset, long lLen, long lTotalSize) {
+	return lOffset >= 0 && lLen >= 0 && lOffset <= lTotalSize && lLen <= lTotalSize - lOffset &&
+		lOffset % MIDIDATASNAPSHOT_ALIGN == 0;
+}
+
+/* メモリ上のスナップショットを開く(20261019追加) */
+/* ヘッダーとトラック索引の範囲のみを検査し、イベント配列は解析しない。 */
+/* pDataはスナップショットを閉じるまで解放・変更しないこと。失敗時NULLを返す。 */
+MIDIDataSnapshot* __stdcall MIDIDataSnapshot_OpenMemory (const void* pData, long lLen) {
+	MIDIDataSnapshot* pSnapshot = NULL;
+	const MIDIDataSnapshotHeader* pHeader = (const MIDIDataSnapshotHeader*)pData;
+	const MIDIDataSnapshotTrack* pTrack = NULL;
+	long i = 0;
+	/* ヘッダーの検査 */
+	if (pData == NULL || lLen < (long)sizeof (MIDIDataSnapshotHeader) ||
+		(INT_PTR)pData % sizeof (long) != 0) {
+		return NULL;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lUser1), 4, 1, pFile));
-	if (lRet < 1) {
-		fclose (pFile);
-		return 0;
+	if (memcmp (pHeader->m_szType, "MDsn", 4) != 0 ||
+		pHeader->m_lVersion != MIDIDATASNAPSHOT_VERSION ||
+		pHeader->m_lHeaderSize != sizeof (MIDIDataSnapshotHeader) ||
+		pHeader->m_lTrackSize != sizeof (MIDIDataSnapshotTrack) ||
+		pHeader->m_lEventSize != sizeof (MIDIDataSnapshotEvent)) {
+		return NULL;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lUser2), 4, 1, pFile));
-	if (lRet < 1) {
-		fclose (pFile);
-		return 0;
+	if (pHeader->m_lTotalSize < (long)sizeof (MIDIDataSnapshotHeader) || pHeader->m_lTotalSize > lLen) {
+		return NULL;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lUser3), 4, 1, pFile));
-	if (lRet < 1) {
-		fclose (pFile);
-		return 0;
+	if (pHeader->m_lFormat < 0 || pHeader->m_lFormat > 2) {
+		return NULL;
 	}
-	lRet = size_ttolong (fwrite (&(pMIDIData->m_lUserFlag), 4, 1, pFile));
-	if (lRet < 1) {
-		fclose (pFile);
-		return 0;
+	if (pHeader->m_lNumTrack < 0 || pHeader->m_lNumTrack > MIDIDATA_MAXMIDITRACKNUM) {
+		return NULL;
 	}
-	/* このMIDIデータ内の各トラックについて */
-	forEachTrack (pMIDIData, pMIDITrack) {
-		lRet = MIDITrack_SaveAsBinary (pMIDITrack, pFile);
-		if (lRet == 0) {
-			fclose (pFile);
-			return 0;
+	if (pHeader->m_lTimeBase < 0 || pHeader->m_lTimeBase > 65535) {
+		return NULL;
+	}
+	/* トラック索引の検査 */
+	if (!MIDIDataSnapshot_IsValidRange (pHeader->m_lTrackOffset, 
+		pHeader->m_lNumTrack * (long)sizeof (MIDIDataSnapshotTrack), pHeader->m_lTotalSize)) {
+		return NULL;
+	}
+	pTrack = (const MIDIDataSnapshotTrack*)((const unsigned char*)pData + pHeader->m_lTrackOffset);
+	for (i = 0; i < pHeader->m_lNumTrack; i++) {
+		if (pTrack[i].m_lNumEvent < 0 ||
+			pTrack[i].m_lNumEvent > LONG_MAX / (long)sizeof (MIDIDataSnapshotEvent)) {
+			return NULL;
+		}
+		if (!MIDIDataSnapshot_IsValidRange (pTrack[i].m_lEventOffset, 
+			pTrack[i].m_lNumEvent * (long)sizeof (MIDIDataSnapshotEvent), pHeader->m_lTotalSize)) {
+			return NULL;
+		}
+		if (!MIDIDataSnapshot_IsValidRange (pTrack[i].m_lDataOffset, 
+			pTrack[i].m_lDataLen, pHeader->m_lTotalSize)) {
+			return NULL;
 		}
 	}
-	fclose (pFile);
-	return 1;
+	pSnapshot = calloc (1, sizeof (MIDIDataSnapshot));
+	if (pSnapshot == NULL) {
+		return NULL;
+	}
+	pSnapshot->m_pData = (const unsigned char*)pData;
+	pSnapshot->m_lLen = pHeader->m_lTotalSize;
+	pSnapshot->m_pHeader = pHeader;
+	pSnapshot->m_pTrack = pTrack;
+	return pSnapshot;
+}
+
+/* 開いたファイル全体を読み取り専用でメモリにマップする(非公開)(20261019追加) */
+/* 成功した場合はビューの先頭を返し、*phMappingと*pLenを設定する。 */
+/* 失敗した場合(空のファイル及び2GB以上のファイルを含む)はhFileを閉じてNULLを返す。 */
+static const void* MIDIData_MapFile (HANDLE hFile, HANDLE* phMapping, long* pLen) {
+	HANDLE hMapping = NULL;
+	void* pView = NULL;
+	DWORD dwSizeHigh = 0;
+	DWORD dwSize = 0;
+	if (hFile == INVALID_HANDLE_VALUE) {
+		return NULL;
+	}
+	dwSize = GetFileSize (hFile, &dwSizeHigh);
+	if (dwSize == INVALID_FILE_SIZE || dwSizeHigh != 0 || dwSize > LONG_MAX || dwSize == 0) {
+		CloseHandle (hFile);
+		return NULL;
+	}
+	hMapping = CreateFileMappingA (hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (hMapping == NULL) {
+		CloseHandle (hFile);
+		return NULL;
+	}
+	pView = MapViewOfFile (hMapping, FILE_MAP_READ, 0, 0, 0);
+	if (pView == NULL) {
+		CloseHandle (hMapping);
+		CloseHandle (hFile);
+		return NULL;
+	}
+	*phMapping = hMapping;
+	*pLen = (long)dwSize;
+	return pView;
 }
 
+/* MIDIData_MapFileでマップしたファイルを閉じる(非公開)(20261019追加) */
+static void MIDIData_UnmapFile (const void* pView, HANDLE hMapping, HANDLE hFile) {
+	UnmapViewOfFile (pView);
+	CloseHandle (hMapping);
+	CloseHandle (hFile);
+}
 
-/* MIDITrackをCherry形式のメモリブロックから読み込み(非公開) */
-/* 新しいMIDIトラックへのポインタを返す(失敗時NULL) */
-MIDITrack* __stdcall MIDITrack_LoadFromCherry (long lTrackIndex, unsigned char*pTrackData, long lTrackLen) {
-	MIDITrack* pMIDITrack = NULL;
-	unsigned char* p = pTrackData;
-	long lOutputPort = 0;
-	long lOutputChannel = 0;
-	char szTempTrackName[256];
+/* マップしたファイルのビューをスナップショットとして開く(非公開)(20261019追加) */
+/* 失敗した場合はハンドルを閉じてNULLを返す。 */
+static MIDIDataSnapshot* MIDIDataSnapshot_OpenMapping (HANDLE hFile) {
+	MIDIDataSnapshot* pSnapshot = NULL;
+	HANDLE hMapping = NULL;
+	const void* pView = NULL;
+	long lLen = 0;
+	pView = MIDIData_MapFile (hFile, &hMapping, &lLen);
+	if (pView == NULL) {
+		return NULL;
+	}
+	pSnapshot = MIDIDataSnapshot_OpenMemory (pView, lLen);
+	if (pSnapshot == NULL) {
+		MIDIData_UnmapFile (pView, hMapping, hFile);
+		return NULL;
+	}
+	pSnapshot->m_hFile = hFile;
+	pSnapshot->m_hMapping = hMapping;
+	return pSnapshot;
+}
+
+/* スナップショットファイル(*.mds)を読み取り専用でメモリにマップして開く(ANSI)(20261019追加) */
+/* 失敗時NULLを返す。 */
+MIDIDataSnapshot* __stdcall MIDIDataSnapshot_OpenFileA (const char* pszFileName) {
+	return MIDIDataSnapshot_OpenMapping (CreateFileA (pszFileName, GENERIC_READ, 
+		FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL));
+}
+
+/* スナップショットファイル(*.mds)を読み取り専用でメモリにマップして開く(UNICODE)(20261019追加) */
+/* 失敗時NULLを返す。 */
+MIDIDataSnapshot* __stdcall MIDIDataSnapshot_OpenFileW (const wchar_t* pszFileName) {
+	return MIDIDataSnapshot_OpenMapping (CreateFileW (pszFileName, GENERIC_READ, 
+		FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL));
+}
+
+/* スナップショットを閉じる(20261019追加) */
+void __stdcall MIDIDataSnapshot_Close (MIDIDataSnapshot* pSnapshot) {
+	if (pSnapshot == NULL) {
+		return;
+	}
+	if (pSnapshot->m_hMapping) {
+		MIDIData_UnmapFile (pSnapshot->m_pData, pSnapshot->m_hMapping, pSnapshot->m_hFile);
+	}
+	free (pSnapshot);
+}
+
+/* スナップショットのSMFフォーマットを取得(20261019追加) */
+long __stdcall MIDIDataSnapshot_GetFormat (MIDIDataSnapshot* pSnapshot) {
+	assert (pSnapshot);
+	return pSnapshot->m_pHeader->m_lFormat;
+}
+
+/* スナップショットのタイムベースを取得(20261019追加) */
+long __stdcall MIDIDataSnapshot_GetTimeBase (MIDIDataSnapshot* pSnapshot) {
+	assert (pSnapshot);
+	return pSnapshot->m_pHeader->m_lTimeBase;
+}
+
+/* スナップショットのトラック数を取得(20261019追加) */
+long __stdcall MIDIDataSnapshot_GetNumTrack (MIDIDataSnapshot* pSnapshot) {
+	assert (pSnapshot);
+	return pSnapshot->m_pHeader->m_lNumTrack;
+}
+
+/* スナップショットのトラック索引の項目を取得(範囲外の場合NULL)(20261019追加) */
+const MIDIDataSnapshotTrack* __stdcall MIDIDataSnapshot_GetTrack
+	(MIDIDataSnapshot* pSnapshot, long lTrackIndex) {
+	assert (pSnapshot);
+	if (lTrackIndex < 0 || lTrackIndex >= pSnapshot->m_pHeader->m_lNumTrack) {
+		return NULL;
+	}
+	return &(pSnapshot->m_pTrack[lTrackIndex]);
+}
+
+/* スナップショットのイベント配列の項目を取得(範囲外の場合NULL)(20261019追加) */
+const MIDIDataSnapshotEvent* __stdcall MIDIDataSnapshot_GetEvent
+	(MIDIDataSnapshot* pSnapshot, long lTrackIndex, long lEventIndex) {
+	const MIDIDataSnapshotTrack* pTrack = MIDIDataSnapshot_GetTrack (pSnapshot, lTrackIndex);
+	if (pTrack == NULL || lEventIndex < 0 || lEventIndex >= pTrack->m_lNumEvent) {
+		return NULL;
+	}
+	return (const MIDIDataSnapshotEvent*)(pSnapshot->m_pData + pTrack->m_lEventOffset) + lEventIndex;
+}
+
+/* スナップショットのイベントのデータを取得(20261019追加) */
+/* 範囲外の場合及びデータがトラックのデータ領域をはみ出している場合NULLを返す。 */
+const unsigned char* __stdcall MIDIDataSnapshot_GetEventData
+	(MIDIDataSnapshot* pSnapshot, long lTrackIndex, long lEventIndex) {
+	const MIDIDataSnapshotTrack* pTrack = MIDIDataSnapshot_GetTrack (pSnapshot, lTrackIndex);
+	const MIDIDataSnapshotEvent* pEvent = 
+		MIDIDataSnapshot_GetEvent (pSnapshot, lTrackIndex, lEventIndex);
+	if (pEvent == NULL) {
+		return NULL;
+	}
+	if (pEvent->m_lDataOffset < 0 || pEvent->m_lLen < 0 || 
+		pEvent->m_lDataOffset > pTrack->m_lDataLen ||
+		pEvent->m_lLen > pTrack->m_lDataLen - pEvent->m_lDataOffset) {
+		return NULL;
+	}
+	return pSnapshot->m_pData + pTrack->m_lDataOffset + pEvent->m_lDataOffset;
+}
+
+/* スナップショットのトラックから新しいMIDIトラックを生成する(非公開)(20261019追加) */
+/* 各イベントは末尾に順に連結し、同種イベントは種類ごとの最後のイベントを覚えて */
+/* 連結するため、トラックの生成はイベント数に比例する時間で完了する。失敗時NULLを返す。 */
+static MIDITrack* MIDIDataSnapshot_ToMIDITrack (MIDIDataSnapshot* pSnapshot, long lTrackIndex) {
+	const MIDIDataSnapshotTrack* pSnapshotTrack = &(pSnapshot->m_pTrack[lTrackIndex]);
+	const MIDIDataSnapshotEvent* pSnapshotEvent = NULL;
+	const unsigned char* pData = NULL;
+	MIDITrack* pMIDITrack = NULL;
+	MIDIEvent* pMIDIEvent = NULL;
+	MIDIEvent** ppMIDIEvent = NULL;
+	MIDIEvent* pLastSameKindEvent[256];
+	long lNumEvent = pSnapshotTrack->m_lNumEvent;
+	long lPrev = 0;
+	long lNext = 0;
+	long lCount = 0;
+	long j = 0;
+	pMIDITrack = MIDITrack_Create ();
+	if (pMIDITrack == NULL) {
+		return NULL;
+	}
+	ppMIDIEvent = malloc (MAX (lNumEvent, 1) * sizeof (MIDIEvent*));
+	if (ppMIDIEvent == NULL) {
+		MIDITrack_Delete (pMIDITrack);
+		return NULL;
+	}
+	memset (pLastSameKindEvent, 0, sizeof (pLastSameKindEvent));
+	/* イベントの生成と連結 */
+	for (j = 0; j < lNumEvent; j++) {
+		pSnapshotEvent = MIDIDataSnapshot_GetEvent (pSnapshot, lTrackIndex, j);
+		pData = MIDIDataSnapshot_GetEventData (pSnapshot, lTrackIndex, j);
+		if (pData == NULL) {
+			goto error;
+		}
+		/* MIDIチャンネルイベントとシステムエクスクルーシブイベントは */
+		/* ステータスバイトを含まなければならない */
+		if (((0x80 <= pSnapshotEvent->m_lKind && pSnapshotEvent->m_lKind <= 0xEF) ||
+			pSnapshotEvent->m_lKind == 0xF0) &&
+			(pSnapshotEvent->m_lLen < 1 || (*pData & 0x80) == 0)) {
+			goto error;
+		}
+		pMIDIEvent = MIDIEvent_Create (pSnapshotEvent->m_lTime, pSnapshotEvent->m_lKind,
+			pSnapshotEvent->m_lLen > 0 ? (unsigned char*)pData : NULL, pSnapshotEvent->m_lLen);
+		if (pMIDIEvent == NULL) {
+			goto error;
+		}
+		pMIDIEvent->m_lUser1 = pSnapshotEvent->m_lUser1;
+		pMIDIEvent->m_lUser2 = pSnapshotEvent->m_lUser2;
+		pMIDIEvent->m_lUser3 = pSnapshotEvent->m_lUser3;
+		pMIDIEvent->m_lUserFlag = pSnapshotEvent->m_lUserFlag;
+		pMIDIEvent->m_pParent = pMIDITrack;
+		pMIDIEvent->m_pPrevEvent = pMIDITrack->m_pLastEvent;
+		if (pMIDITrack->m_pLastEvent) {
+			pMIDITrack->m_pLastEvent->m_pNextEvent = pMIDIEvent;
+		}
+		else {
+			pMIDITrack->m_pFirstEvent = pMIDIEvent;
+		}
+		pMIDITrack->m_pLastEvent = pMIDIEvent;
+		pMIDIEvent->m_pPrevSameKindEvent = pLastSameKindEvent[pMIDIEvent->m_lKind];
+		if (pMIDIEvent->m_pPrevSameKindEvent) {
+			pMIDIEvent->m_pPrevSameKindEvent->m_pNextSameKindEvent = pMIDIEvent;
+		}
+		pLastSameKindEvent[pMIDIEvent->m_lKind] = pMIDIEvent;
+		pMIDITrack->m_lNumEvent++;
+		ppMIDIEvent[j] = pMIDIEvent;
+	}
+	/* 結合イベントの連結 */
+	/* 前後の参照が互いに一致しない場合は、削除時に二重解放となるため読み込みを失敗させる */
+	for (j = 0; j < lNumEvent; j++) {
+		pSnapshotEvent = MIDIDataSnapshot_GetEvent (pSnapshot, lTrackIndex, j);
+		lPrev = pSnapshotEvent->m_lPrevCombinedEvent;
+		lNext = pSnapshotEvent->m_lNextCombinedEvent;
+		if (lPrev != -1) {
+			if (lPrev < 0 || lPrev >= lNumEvent || lPrev == j || MIDIDataSnapshot_GetEvent
+				(pSnapshot, lTrackIndex, lPrev)->m_lNextCombinedEvent != j) {
+				goto error;
+			}
+			ppMIDIEvent[j]->m_pPrevCombinedEvent = ppMIDIEvent[lPrev];
+		}
+		if (lNext != -1) {
+			if (lNext < 0 || lNext >= lNumEvent || lNext == j || MIDIDataSnapshot_GetEvent
+				(pSnapshot, lTrackIndex, lNext)->m_lPrevCombinedEvent != j) {
+				goto error;
+			}
+			ppMIDIEvent[j]->m_pNextCombinedEvent = ppMIDIEvent[lNext];
+		}
+	}
+	/* 先頭を持たない(循環する)結合イベントがないことの確認 */
+	lCount = 0;
+	for (j = 0; j < lNumEvent; j++) {
+		if (ppMIDIEvent[j]->m_pPrevCombinedEvent == NULL) {
+			for (pMIDIEvent = ppMIDIEvent[j]; pMIDIEvent; pMIDIEvent = pMIDIEvent->m_pNextCombinedEvent) {
+				lCount++;
+			}
+		}
+	}
+	if (lCount != lNumEvent) {
+		goto error;
+	}
+	free (ppMIDIEvent);
+	/* トラックの属性の設定 */
+	pMIDITrack->m_lInputOn = pSnapshotTrack->m_lInputOn;
+	pMIDITrack->m_lInputPort = pSnapshotTrack->m_lInputPort;
+	pMIDITrack->m_lInputChannel = pSnapshotTrack->m_lInputChannel;
+	pMIDITrack->m_lOutputOn = pSnapshotTrack->m_lOutputOn;
+	pMIDITrack->m_lOutputPort = pSnapshotTrack->m_lOutputPort;
+	pMIDITrack->m_lOutputChannel = pSnapshotTrack->m_lOutputChannel;
+	pMIDITrack->m_lTimePlus = pSnapshotTrack->m_lTimePlus;
+	pMIDITrack->m_lKeyPlus = pSnapshotTrack->m_lKeyPlus;
+	pMIDITrack->m_lVelocityPlus = pSnapshotTrack->m_lVelocityPlus;
+	pMIDITrack->m_lViewMode = pSnapshotTrack->m_lViewMode;
+	pMIDITrack->m_lForeColor = pSnapshotTrack->m_lForeColor;
+	pMIDITrack->m_lBackColor = pSnapshotTrack->m_lBackColor;
+	pMIDITrack->m_lReserved1 = pSnapshotTrack->m_lReserved1;
+	pMIDITrack->m_lReserved2 = pSnapshotTrack->m_lReserved2;
+	pMIDITrack->m_lReserved3 = pSnapshotTrack->m_lReserved3;
+	pMIDITrack->m_lReserved4 = pSnapshotTrack->m_lReserved4;
+	pMIDITrack->m_lUser1 = pSnapshotTrack->m_lUser1;
+	pMIDITrack->m_lUser2 = pSnapshotTrack->m_lUser2;
+	pMIDITrack->m_lUser3 = pSnapshotTrack->m_lUser3;
+	pMIDITrack->m_lUserFlag = pSnapshotTrack->m_lUserFlag;
+	return pMIDITrack;
+	error:
+	free (ppMIDIEvent);
+	/* 結合を解いてから削除する */
+	forEachEvent (pMIDITrack, pMIDIEvent) {
+		pMIDIEvent->m_pPrevCombinedEvent = NULL;
+		pMIDIEvent->m_pNextCombinedEvent = NULL;
+	}
+	MIDITrack_Delete (pMIDITrack);
+	return NULL;
+}
+
+/* スナップショットから新しいMIDIデータを生成し、そのポインタを返す(失敗時NULL)(20261019追加) */
+MIDIData* __stdcall MIDIDataSnapshot_ToMIDIData (MIDIDataSnapshot* pSnapshot) {
+	const MIDIDataSnapshotHeader* pHeader = NULL;
+	MIDIData* pMIDIData = NULL;
+	MIDITrack* pMIDITrack = NULL;
+	long lTimeBase = 0;
+	long lTimeMode = 0;
+	long lTimeResolution = 0;
+	long i = 0;
+	assert (pSnapshot);
+	pHeader = pSnapshot->m_pHeader;
+	lTimeBase = pHeader->m_lTimeBase;
+	if (lTimeBase & 0x00008000) {
+		lTimeMode = 256 - ((lTimeBase & 0x0000FF00) >> 8);
+		if (lTimeMode != MIDIDATA_SMPTE24BASE &&
+			lTimeMode != MIDIDATA_SMPTE25BASE &&
+			lTimeMode != MIDIDATA_SMPTE29BASE &&
+			lTimeMode != MIDIDATA_SMPTE30BASE) {
+			return NULL;
+		}
+		lTimeResolution = lTimeBase & 0x00FF;
+	}
+	else {
+		lTimeMode = MIDIDATA_TPQNBASE;
+		lTimeResolution = lTimeBase & 0x7FFF;
+	}
+	pMIDIData = MIDIData_Create (pHeader->m_lFormat, 0, lTimeMode, lTimeResolution);
+	if (pMIDIData == NULL) {
+		return NULL;
+	}
+	pMIDIData->m_lReserved1 = pHeader->m_lReserved1;
+	pMIDIData->m_lReserved2 = pHeader->m_lReserved2;
+	pMIDIData->m_lReserved3 = pHeader->m_lReserved3;
+	pMIDIData->m_lReserved4 = pHeader->m_lReserved4;
+	pMIDIData->m_lUser1 = pHeader->m_lUser1;
+	pMIDIData->m_lUser2 = pHeader->m_lUser2;
+	pMIDIData->m_lUser3 = pHeader->m_lUser3;
+	pMIDIData->m_lUserFlag = pHeader->m_lUserFlag;
+	for (i = 0; i < pHeader->m_lNumTrack; i++) {
+		pMIDITrack = MIDIDataSnapshot_ToMIDITrack (pSnapshot, i);
+		if (pMIDITrack == NULL) {
+			MIDIData_Delete (pMIDIData);
+			return NULL;
+		}
+		MIDIData_AddTrackForce (pMIDIData, pMIDITrack);
+	}
+	return pMIDIData;
+}
+
+/* MIDIDataをスナップショットファイル(*.mds)から読み込み、(ANSI)(20261019追加) */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+MIDIData* __stdcall MIDIData_LoadFromSnapshotA (const char* pszFileName) {
+	MIDIData* pMIDIData = NULL;
+	MIDIDataSnapshot* pSnapshot = MIDIDataSnapshot_OpenFileA (pszFileName);
+	if (pSnapshot == NULL) {
+		return NULL;
+	}
+	pMIDIData = MIDIDataSnapshot_ToMIDIData (pSnapshot);
+	MIDIDataSnapshot_Close (pSnapshot);
+	return pMIDIData;
+}
+
+/* MIDIDataをスナップショットファイル(*.mds)から読み込み、(UNICODE)(20261019追加) */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+MIDIData* __stdcall MIDIData_LoadFromSnapshotW (const wchar_t* pszFileName) {
+	MIDIData* pMIDIData = NULL;
+	MIDIDataSnapshot* pSnapshot = MIDIDataSnapshot_OpenFileW (pszFileName);
+	if (pSnapshot == NULL) {
+		return NULL;
+	}
+	pMIDIData = MIDIDataSnapshot_ToMIDIData (pSnapshot);
+	MIDIDataSnapshot_Close (pSnapshot);
+	return pMIDIData;
+}
+
+/* MIDIDataをスナップショットのメモリブロックから読み込み、(20261019追加) */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+MIDIData* __stdcall MIDIData_LoadFromSnapshotMemory (const void* pData, long lLen) {
+	MIDIData* pMIDIData = NULL;
+	MIDIDataSnapshot* pSnapshot = MIDIDataSnapshot_OpenMemory (pData, lLen);
+	if (pSnapshot == NULL) {
+		return NULL;
+	}
+	pMIDIData = MIDIDataSnapshot_ToMIDIData (pSnapshot);
+	MIDIDataSnapshot_Close (pSnapshot);
+	return pMIDIData;
+}
+
+/* MIDIDataCache関数(20261019追加) */
+
+/* キャッシュファイルの一覧の項目(非公開)(20261019追加) */
+typedef struct tagMIDIDataCacheEntry {
+	wchar_t m_szFileName[64];           /* キャッシュディレクトリ内のファイル名 */
+	uint64_t m_ullTime;                 /* 最終更新時刻(最後に使われた時刻) */
+	int64_t m_llSize;                   /* ファイルの長さ[バイト] */
+} MIDIDataCacheEntry;
+
+/* 最終更新時刻からこの時間[100ナノ秒]以上経った一時ファイル(*.tmp)は、書き込み中に */
+/* 異常終了したプロセスが残したものとみなす(非公開)(20261019追加) */
+#define MIDIDATACACHE_STALETMPTIME (5ULL * 60 * 10000000)
+
+/* 64ビット値Xを左にBビット回転する(非公開)(20261019追加) */
+#define MIDIDATACACHE_ROTL64(X,B) (((X) << (B)) | ((X) >> (64 - (B))))
+
+/* xxHash64の定数(非公開)(20261019追加) */
+#define MIDIDATACACHE_PRIME64_1 0x9E3779B185EBCA87ULL
+#define MIDIDATACACHE_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define MIDIDATACACHE_PRIME64_3 0x165667B19E3779F9ULL
+#define MIDIDATACACHE_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define MIDIDATACACHE_PRIME64_5 0x27D4EB2F165667C5ULL
+
+/* リトルエンディアンの8バイト・4バイトを読む(非公開)(20261019追加) */
+static uint64_t MIDIDataCache_Read64 (const unsigned char* p) {
+	return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) |
+		((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+static uint64_t MIDIDataCache_Read32 (const unsigned char* p) {
+	return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24);
+}
+
+/* xxHash64の1ラウンド(非公開)(20261019追加) */
+static uint64_t MIDIDataCache_Round (uint64_t ullAcc, uint64_t ullInput) {
+	ullAcc += ullInput * MIDIDATACACHE_PRIME64_2;
+	ullAcc = MIDIDATACACHE_ROTL64 (ullAcc, 31);
+	return ullAcc * MIDIDATACACHE_PRIME64_1;
+}
+
+/* xxHash64のアキュムレータの合流(非公開)(20261019追加) */
+static uint64_t MIDIDataCache_Merge (uint64_t ullAcc, uint64_t ullVal) {
+	ullAcc ^= MIDIDataCache_Round (0, ullVal);
+	return ullAcc * MIDIDATACACHE_PRIME64_1 + MIDIDATACACHE_PRIME64_4;
+}
+
+/* メモリブロックの内容のハッシュ値(xxHash64、シード0)を計算する(非公開)(20261019追加) */
+static uint64_t MIDIDataCache_Hash (const unsigned char* pData, long lLen) {
+	const unsigned char* p = pData;
+	const unsigned char* pEnd = pData + lLen;
+	uint64_t ullHash = 0;
+	uint64_t v1, v2, v3, v4;
+	if (lLen >= 32) {
+		v1 = MIDIDATACACHE_PRIME64_1 + MIDIDATACACHE_PRIME64_2;
+		v2 = MIDIDATACACHE_PRIME64_2;
+		v3 = 0;
+		v4 = 0 - MIDIDATACACHE_PRIME64_1;
+		while (p + 32 <= pEnd) {
+			v1 = MIDIDataCache_Round (v1, MIDIDataCache_Read64 (p));
+			v2 = MIDIDataCache_Round (v2, MIDIDataCache_Read64 (p + 8));
+			v3 = MIDIDataCache_Round (v3, MIDIDataCache_Read64 (p + 16));
+			v4 = MIDIDataCache_Round (v4, MIDIDataCache_Read64 (p + 24));
+			p += 32;
+		}
+		ullHash = MIDIDATACACHE_ROTL64 (v1, 1) + MIDIDATACACHE_ROTL64 (v2, 7) +
+			MIDIDATACACHE_ROTL64 (v3, 12) + MIDIDATACACHE_ROTL64 (v4, 18);
+		ullHash = MIDIDataCache_Merge (ullHash, v1);
+		ullHash = MIDIDataCache_Merge (ullHash, v2);
+		ullHash = MIDIDataCache_Merge (ullHash, v3);
+		ullHash = MIDIDataCache_Merge (ullHash, v4);
+	}
+	else {
+		ullHash = MIDIDATACACHE_PRIME64_5;
+	}
+	ullHash += (uint64_t)lLen;
+	while (p + 8 <= pEnd) {
+		ullHash ^= MIDIDataCache_Round (0, MIDIDataCache_Read64 (p));
+		ullHash = MIDIDATACACHE_ROTL64 (ullHash, 27) * MIDIDATACACHE_PRIME64_1 + MIDIDATACACHE_PRIME64_4;
+		p += 8;
+	}
+	if (p + 4 <= pEnd) {
+		ullHash ^= MIDIDataCache_Read32 (p) * MIDIDATACACHE_PRIME64_1;
+		ullHash = MIDIDATACACHE_ROTL64 (ullHash, 23) * MIDIDATACACHE_PRIME64_2 + MIDIDATACACHE_PRIME64_3;
+		p += 4;
+	}
+	while (p < pEnd) {
+		ullHash ^= (*p) * MIDIDATACACHE_PRIME64_5;
+		ullHash = MIDIDATACACHE_ROTL64 (ullHash, 11) * MIDIDATACACHE_PRIME64_1;
+		p++;
+	}
+	ullHash ^= ullHash >> 33;
+	ullHash *= MIDIDATACACHE_PRIME64_2;
+	ullHash ^= ullHash >> 29;
+	ullHash *= MIDIDATACACHE_PRIME64_3;
+	ullHash ^= ullHash >> 32;
+	return ullHash;
+}
+
+/* 文字列の末尾に値をlDigit桁の16進数で書き込み、書き込んだ末尾を返す(非公開)(20261019追加) */
+static wchar_t* MIDIDataCache_AppendHex (wchar_t* p, uint64_t ullValue, long lDigit) {
+	static const wchar_t szHex[] = L"0123456789ABCDEF";
+	long i;
+	for (i = lDigit - 1; i >= 0; i--) {
+		p[i] = szHex[ullValue & 0x0F];
+		ullValue >>= 4;
+	}
+	p[lDigit] = L'\0';
+	return p + lDigit;
+}
+
+/* キャッシュディレクトリ内のファイルのフルパスを作る(非公開)(20261019追加) */
+/* pszPathはMIDIDATACACHE_MAXPATH+64文字必要。 */
+static void MIDIDataCache_MakePath (MIDIDataCache* pCache, const wchar_t* pszName, wchar_t* pszPath) {
+	long lDirLen = size_ttolong (wcslen (pCache->m_szDirName));
+	memcpy (pszPath, pCache->m_szDirName, lDirLen * sizeof (wchar_t));
+	pszPath[lDirLen] = L'\\';
+	wcsncpy (pszPath + lDirLen + 1, pszName, 63);
+	pszPath[lDirLen + 64] = L'\0';
+}
+
+/* キャッシュファイルのフルパスを作る(非公開)(20261019追加) */
+/* ファイル名は「ハッシュ値-長さ-形式.mds」。ulThreadIDが0以外の場合は書き込み用の一時ファイル */
+/* 「ハッシュ値-長さ-形式-ulProcessID-ulThreadID.tmp」とする(スレッドIDは別のプロセスと重なり */
+/* うるため、プロセスIDと組み合わせる)。pszFileNameはMIDIDATACACHE_MAXPATH+64文字必要。 */
+static void MIDIDataCache_MakeFileName (MIDIDataCache* pCache, uint64_t ullHash, 
+	long lLen, long lFormat, unsigned long ulProcessID, unsigned long ulThreadID, wchar_t* pszFileName) {
+	wchar_t* p = pszFileName;
+	long lDirLen = size_ttolong (wcslen (pCache->m_szDirName));
+	memcpy (p, pCache->m_szDirName, lDirLen * sizeof (wchar_t));
+	p += lDirLen;
+	*p++ = L'\\';
+	p = MIDIDataCache_AppendHex (p, ullHash, 16);
+	*p++ = L'-';
+	p = MIDIDataCache_AppendHex (p, (uint64_t)lLen, 8);
+	*p++ = L'-';
+	p = MIDIDataCache_AppendHex (p, (uint64_t)lFormat, 2);
+	if (ulThreadID) {
+		*p++ = L'-';
+		p = MIDIDataCache_AppendHex (p, (uint64_t)ulProcessID, 8);
+		*p++ = L'-';
+		p = MIDIDataCache_AppendHex (p, (uint64_t)ulThreadID, 8);
+		wcscpy (p, L".tmp");
+	}
+	else {
+		wcscpy (p, L".mds");
+	}
+}
+
+/* キャッシュファイルの最終更新時刻を現在時刻にする(非公開)(20261019追加) */
+/* 最終更新時刻を最後に使われた時刻とみなし、古いものから削除する。 */
+static void MIDIDataCache_Touch (const wchar_t* pszFileName) {
+	FILETIME theFileTime;
+	HANDLE hFile = CreateFileW (pszFileName, FILE_WRITE_ATTRIBUTES, 
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) {
+		return;
+	}
+	GetSystemTimeAsFileTime (&theFileTime);
+	SetFileTime (hFile, NULL, NULL, &theFileTime);
+	CloseHandle (hFile);
+}
+
+/* キャッシュファイルの一覧を作る(非公開)(20261019追加) */
+/* 異常終了したプロセスが残した一時ファイル(最終更新時刻からMIDIDATACACHE_STALETMPTIME以上 */
+/* 経ったもの)も一覧に含め、キャッシュファイルと同様に削除の対象とする。書き込み中の一時ファイルは含めない。 */
+/* *ppEntryはfreeで解放すること。戻り値：ファイル数(失敗時-1)。*pTotalSizeに合計の長さを返す。 */
+static long MIDIDataCache_ListEntry (MIDIDataCache* pCache, MIDIDataCacheEntry** ppEntry, int64_t* pTotalSize) {
+	static const wchar_t* pszPattern[2] = {L"*.mds", L"*.tmp"};
+	wchar_t szPattern[MIDIDATACACHE_MAXPATH + 64];
+	WIN32_FIND_DATAW theFindData;
+	FILETIME theFileTime;
+	HANDLE hFind = NULL;
+	MIDIDataCacheEntry* pEntry = NULL;
+	MIDIDataCacheEntry* pNewEntry = NULL;
+	uint64_t ullNow = 0;
+	uint64_t ullTime = 0;
+	long lNumEntry = 0;
+	long lMaxEntry = 0;
+	long j = 0;
+	*ppEntry = NULL;
+	*pTotalSize = 0;
+	GetSystemTimeAsFileTime (&theFileTime);
+	ullNow = ((uint64_t)theFileTime.dwHighDateTime << 32) | theFileTime.dwLowDateTime;
+	for (j = 0; j < 2; j++) {
+		MIDIDataCache_MakePath (pCache, pszPattern[j], szPattern);
+		hFind = FindFirstFileW (szPattern, &theFindData);
+		if (hFind == INVALID_HANDLE_VALUE) {
+			continue;
+		}
+		do {
+			if ((theFindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ||
+				wcslen (theFindData.cFileName) >= 64) {
+				continue;
+			}
+			ullTime = ((uint64_t)theFindData.ftLastWriteTime.dwHighDateTime << 32) |
+				theFindData.ftLastWriteTime.dwLowDateTime;
+			/* 書き込み中かもしれない新しい一時ファイルは除く */
+			if (j == 1 && (ullTime > ullNow || ullNow - ullTime < MIDIDATACACHE_STALETMPTIME)) {
+				continue;
+			}
+			if (lNumEntry >= lMaxEntry) {
+				lMaxEntry = MAX (lMaxEntry * 2, 256);
+				pNewEntry = realloc (pEntry, lMaxEntry * sizeof (MIDIDataCacheEntry));
+				if (pNewEntry == NULL) {
+					free (pEntry);
+					FindClose (hFind);
+					return -1;
+				}
+				pEntry = pNewEntry;
+			}
+			wcscpy (pEntry[lNumEntry].m_szFileName, theFindData.cFileName);
+			pEntry[lNumEntry].m_ullTime = ullTime;
+			pEntry[lNumEntry].m_llSize = ((int64_t)theFindData.nFileSizeHigh << 32) | theFindData.nFileSizeLow;
+			*pTotalSize += pEntry[lNumEntry].m_llSize;
+			lNumEntry++;
+		} while (FindNextFileW (hFind, &theFindData));
+		FindClose (hFind);
+	}
+	*ppEntry = pEntry;
+	return lNumEntry;
+}
+
+/* キャッシュファイルの一覧の項目を最終更新時刻の古い順に並べるための比較関数(非公開)(20261019追加) */
+static int MIDIDataCache_CompareEntry (const void* p1, const void* p2) {
+	const MIDIDataCacheEntry* pEntry1 = (const MIDIDataCacheEntry*)p1;
+	const MIDIDataCacheEntry* pEntry2 = (const MIDIDataCacheEntry*)p2;
+	return pEntry1->m_ullTime < pEntry2->m_ullTime ? -1 : pEntry1->m_ullTime > pEntry2->m_ullTime ? 1 : 0;
+}
+
+/* キャッシュの合計の長さが上限を超えていれば、最後に使われた時刻が古いものから */
+/* 上限の9割以下になるまで削除する(非公開)(20261019追加) */
+/* 他のプロセスが同じディレクトリを使っている場合に備え、合計の長さは一覧から数え直す。 */
+static void MIDIDataCache_Evict (MIDIDataCache* pCache) {
+	wchar_t szFileName[MIDIDATACACHE_MAXPATH + 64];
+	MIDIDataCacheEntry* pEntry = NULL;
+	int64_t llTotalSize = 0;
+	int64_t llMaxSize = (int64_t)pCache->m_lMaxSize * 1024;
+	long lNumEntry = 0;
+	long i = 0;
+	if (pCache->m_llTotalSize <= llMaxSize) {
+		return;
+	}
+	lNumEntry = MIDIDataCache_ListEntry (pCache, &pEntry, &llTotalSize);
+	if (lNumEntry < 0) {
+		return;
+	}
+	if (llTotalSize > llMaxSize) {
+		qsort (pEntry, lNumEntry, sizeof (MIDIDataCacheEntry), MIDIDataCache_CompareEntry);
+		for (i = 0; i < lNumEntry && llTotalSize > llMaxSize / 10 * 9; i++) {
+			MIDIDataCache_MakePath (pCache, pEntry[i].m_szFileName, szFileName);
+			/* 他のスレッドやプロセスがマップ中のファイルは削除できないので残す */
+			if (DeleteFileW (szFileName)) {
+				llTotalSize -= pEntry[i].m_llSize;
+			}
+		}
+	}
+	pCache->m_llTotalSize = llTotalSize;
+	free (pEntry);
+}
+
+/* キャッシュを生成し、キャッシュへのポインタを返す(失敗時NULL)(UNICODE)(20261019追加) */
+/* pszDirName:キャッシュディレクトリ名(なければ作成する) */
+/* lMaxSize:キャッシュの合計の長さの上限[KB] */
+MIDIDataCache* __stdcall MIDIDataCache_CreateW (const wchar_t* pszDirName, long lMaxSize) {
+	MIDIDataCache* pCache = NULL;
+	MIDIDataCacheEntry* pEntry = NULL;
+	int64_t llTotalSize = 0;
+	DWORD dwAttributes = 0;
+	long lDirLen = 0;
+	if (pszDirName == NULL || lMaxSize < 0) {
+		return NULL;
+	}
+	lDirLen = size_ttolong (wcslen (pszDirName));
+	if (lDirLen <= 0 || lDirLen >= MIDIDATACACHE_MAXPATH) {
+		return NULL;
+	}
+	pCache = calloc (1, sizeof (MIDIDataCache));
+	if (pCache == NULL) {
+		return NULL;
+	}
+	wcscpy (pCache->m_szDirName, pszDirName);
+	/* 末尾の区切り文字を除く */
+	while (lDirLen > 1 && (pCache->m_szDirName[lDirLen - 1] == L'\\' || pCache->m_szDirName[lDirLen - 1] == L'/')) {
+		pCache->m_szDirName[--lDirLen] = L'\0';
+	}
+	CreateDirectoryW (pCache->m_szDirName, NULL);
+	dwAttributes = GetFileAttributesW (pCache->m_szDirName);
+	if (dwAttributes == INVALID_FILE_ATTRIBUTES || !(dwAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+		free (pCache);
+		return NULL;
+	}
+	pCache->m_lMaxSize = lMaxSize;
+	if (MIDIDataCache_ListEntry (pCache, &pEntry, &llTotalSize) >= 0) {
+		pCache->m_llTotalSize = llTotalSize;
+		free (pEntry);
+	}
+	MIDIDataCache_Evict (pCache);
+	return pCache;
+}
+
+/* キャッシュを生成し、キャッシュへのポインタを返す(失敗時NULL)(ANSI)(20261019追加) */
+MIDIDataCache* __stdcall MIDIDataCache_CreateA (const char* pszDirName, long lMaxSize) {
+	wchar_t szDirName[MIDIDATACACHE_MAXPATH];
+	if (pszDirName == NULL) {
+		return NULL;
+	}
+	if (MultiByteToWideChar (CP_ACP, 0, pszDirName, -1, szDirName, MIDIDATACACHE_MAXPATH) == 0) {
+		return NULL;
+	}
+	return MIDIDataCache_CreateW (szDirName, lMaxSize);
+}
+
+/* キャッシュを削除する(キャッシュディレクトリ内のファイルは削除しない)(20261019追加) */
+void __stdcall MIDIDataCache_Delete (MIDIDataCache* pCache) {
+	free (pCache);
+}
+
+/* キャッシュディレクトリ内のキャッシュファイルを全て削除する(20261019追加) */
+/* 異常終了したプロセスが残した古い一時ファイルも削除する。戻り値：削除したファイル数。 */
+long __stdcall MIDIDataCache_Clear (MIDIDataCache* pCache) {
+	wchar_t szFileName[MIDIDATACACHE_MAXPATH + 64];
+	MIDIDataCacheEntry* pEntry = NULL;
+	int64_t llTotalSize = 0;
+	long lNumEntry = 0;
+	long lCount = 0;
+	long i = 0;
+	assert (pCache);
+	lNumEntry = MIDIDataCache_ListEntry (pCache, &pEntry, &llTotalSize);
+	for (i = 0; i < lNumEntry; i++) {
+		MIDIDataCache_MakePath (pCache, pEntry[i].m_szFileName, szFileName);
+		if (DeleteFileW (szFileName)) {
+			llTotalSize -= pEntry[i].m_llSize;
+			lCount++;
+		}
+	}
+	free (pEntry);
+	pCache->m_llTotalSize = MAX (llTotalSize, 0);
+	return lCount;
+}
+
+/* 形式を指定してメモリブロックから読み込む(非公開)(20261019追加) */
+static MIDIData* MIDIDataCache_Parse (const void* pData, long lLen, long lFormat) {
+	switch (lFormat) {
+	case MIDIDATACACHE_SMF:
+		return MIDIData_LoadFromSMFMemory (pData, lLen);
+	case MIDIDATACACHE_TEXT:
+		return MIDIData_LoadFromTextMemory (pData, lLen);
+	case MIDIDATACACHE_BINARY:
+		return MIDIData_LoadFromBinaryMemory (pData, lLen);
+	case MIDIDATACACHE_CHERRY:
+		return MIDIData_LoadFromCherryMemory (pData, lLen);
+	case MIDIDATACACHE_MIDICSV:
+		return MIDIData_LoadFromMIDICSVMemory (pData, lLen);
+	case MIDIDATACACHE_WRK:
+		return MIDIData_LoadFromWRKMemory (pData, lLen);
+	case MIDIDATACACHE_MABIMML:
+		return MIDIData_LoadFromMabiMMLMemory (pData, lLen);
+	}
+	return NULL;
+}
+
+/* キャッシュを通じてメモリブロックから読み込み、(20261019追加) */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+/* lFormatはMIDIDATACACHE_SMF等。同じ内容・同じ形式のデータを以前に読み込んでいれば、 */
+/* 解析を省いてキャッシュファイル(スナップショット)から読み込む。 */
+/* 読み込みに成功したが、キャッシュファイルの書き込みに失敗した場合も、MIDIデータを返す。 */
+MIDIData* __stdcall MIDIDataCache_LoadFromMemory 
+	(MIDIDataCache* pCache, const void* pData, long lLen, long lFormat) {
+	wchar_t szFileName[MIDIDATACACHE_MAXPATH + 64];
+	wchar_t szTempFileName[MIDIDATACACHE_MAXPATH + 64];
+	MIDIData* pMIDIData = NULL;
+	void* pSnapshotData = NULL;
+	long lSnapshotLen = 0;
+	uint64_t ullHash = 0;
+	FILE* pFile = NULL;
+	errno_t nErrorNo = 0;
+	long lWriteLen = 0;
+	assert (pCache);
+	if (pData == NULL || lLen <= 0 || lFormat < MIDIDATACACHE_SMF || lFormat > MIDIDATACACHE_MABIMML) {
+		return NULL;
+	}
+	ullHash = MIDIDataCache_Hash ((const unsigned char*)pData, lLen);
+	MIDIDataCache_MakeFileName (pCache, ullHash, lLen, lFormat, 0, 0, szFileName);
+	/* キャッシュにある場合(壊れている場合及び版が違う場合は読み込み直す) */
+	pMIDIData = MIDIData_LoadFromSnapshotW (szFileName);
+	if (pMIDIData) {
+		MIDIDataCache_Touch (szFileName);
+		pCache->m_lHitCount++;
+		return pMIDIData;
+	}
+	/* キャッシュにない場合 */
+	pCache->m_lMissCount++;
+	pMIDIData = MIDIDataCache_Parse (pData, lLen, lFormat);
+	if (pMIDIData == NULL) {
+		return NULL;
+	}
+	if (MIDIData_SaveAsSnapshotMemory (pMIDIData, &pSnapshotData, &lSnapshotLen) == 0) {
+		return pMIDIData;
+	}
+	/* 書き込み途中のファイルを他のスレッドやプロセスが読まないよう、一時ファイルに書いてから改名する */
+	MIDIDataCache_MakeFileName (pCache, ullHash, lLen, lFormat, 
+		GetCurrentProcessId (), GetCurrentThreadId (), szTempFileName);
+	nErrorNo = _wfopen_s (&pFile, szTempFileName, L"wb");
+	if (pFile) {
+		lWriteLen = size_ttolong (fwrite (pSnapshotData, 1, lSnapshotLen, pFile));
+		if (fclose (pFile) == 0 && lWriteLen == lSnapshotLen &&
+			MoveFileExW (szTempFileName, szFileName, MOVEFILE_REPLACE_EXISTING)) {
+			pCache->m_llTotalSize += lSnapshotLen;
+		}
+		else {
+			DeleteFileW (szTempFileName);
+		}
+	}
+	MIDIDataLib_FreeMemory (pSnapshotData);
+	MIDIDataCache_Evict (pCache);
+	return pMIDIData;
+}
+
+/* キャッシュを通じてファイルから読み込み、(UNICODE)(20261019追加) */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+/* ファイルは読み取り専用でメモリにマップし、その内容のハッシュ値をキーとする。 */
+MIDIData* __stdcall MIDIDataCache_LoadFromFileW 
+	(MIDIDataCache* pCache, const wchar_t* pszFileName, long lFormat) {
+	MIDIData* pMIDIData = NULL;
+	HANDLE hFile = NULL;
+	HANDLE hMapping = NULL;
+	const void* pView = NULL;
+	long lLen = 0;
+	hFile = CreateFileW (pszFileName, GENERIC_READ, 
+		FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	pView = MIDIData_MapFile (hFile, &hMapping, &lLen);
+	if (pView == NULL) {
+		return NULL;
+	}
+	pMIDIData = MIDIDataCache_LoadFromMemory (pCache, pView, lLen, lFormat);
+	MIDIData_UnmapFile (pView, hMapping, hFile);
+	return pMIDIData;
+}
+
+/* キャッシュを通じてファイルから読み込み、(ANSI)(20261019追加) */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+MIDIData* __stdcall MIDIDataCache_LoadFromFileA 
+	(MIDIDataCache* pCache, const char* pszFileName, long lFormat) {
+	MIDIData* pMIDIData = NULL;
+	HANDLE hFile = NULL;
+	HANDLE hMapping = NULL;
+	const void* pView = NULL;
+	long lLen = 0;
+	hFile = CreateFileA (pszFileName, GENERIC_READ, 
+		FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	pView = MIDIData_MapFile (hFile, &hMapping, &lLen);
+	if (pView == NULL) {
+		return NULL;
+	}
+	pMIDIData = MIDIDataCache_LoadFromMemory (pCache, pView, lLen, lFormat);
+	MIDIData_UnmapFile (pView, hMapping, hFile);
+	return pMIDIData;
+}
+
+
+/* MIDITrackをCherry形式のメモリブロックから読み込み(非公開) */
+/* 新しいMIDIトラックへのポインタを返す(失敗時NULL) */
+MIDITrack* __stdcall MIDITrack_LoadFromCherry (long lTrackIndex, unsigned char*pTrackData, long lTrackLen) {
+	MIDITrack* pMIDITrack = NULL;
+	unsigned char* p = pTrackData;
+	long lOutputPort = 0;
+	long lOutputChannel = 0;
+	char szTempTrackName[256];
 	memset (szTempTrackName, 0, sizeof (szTempTrackName));
 
 	/* 新規MIDIトラックの生成 */
@@ -10887,13 +12379,11 @@ MIDITrack* __stdcall MIDITrack_LoadFromCherry (long lTrackIndex, unsigned char*p
 	return pMIDITrack;
 }
 
-/* MIDIDataをCherryシーケンスファイル(*.chy)から読み込み(ANSI) */
-/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
-MIDIData* __stdcall MIDIData_LoadFromCherryA (const char* pszFileName) {
+/* MIDIDataをCherryシーケンスファイル(*.chy)から読み込み */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(非公開)(20261019追加) */
+static MIDIData* MIDIData_LoadFromCherryStream (MIDIDataStream* pStream) {
 	MIDIData* pMIDIData = NULL;
 	MIDITrack* pMIDITrack = NULL;
-	FILE* pFile = NULL;
-	errno_t nErrorNo = 0;
 	long lRet = 0;
 	long lTrackLen = 0;
 	long lTrackIndex = 0;
@@ -10923,21 +12413,14 @@ MIDIData* __stdcall MIDIData_LoadFromCherryA (const char* pszFileName) {
 	pMIDIData->m_lUser2 = 0;
 	pMIDIData->m_lUser3 = 0;
 
-	nErrorNo = fopen_s (&pFile, pszFileName, "rb");
-	if (pFile == NULL) {
-		free (pMIDIData);
-		return NULL;
-	}
-	if (fread (byBuf, sizeof(char), 256, pFile) < 256) {
+	if (MIDIDataStream_Read (byBuf, sizeof(char), 256, pStream) < 256) {
 		free (pMIDIData);
-		fclose (pFile);
 		return NULL;
 	}
 
 	/* 識別ID読み込み */
 	if (memcmp (byBuf, "CHRY0101", 8) != 0) {
 		free (pMIDIData);
-		fclose (pFile);
 		return NULL; 
 	}
 	pMIDIData->m_lFormat = 1;
@@ -10946,7 +12429,6 @@ MIDIData* __stdcall MIDIData_LoadFromCherryA (const char* pszFileName) {
 	pMIDIData->m_lTimeBase = (long)(*(unsigned short*)(byBuf + 8));
 	if (pMIDIData->m_lTimeBase < 1 || pMIDIData->m_lTimeBase > MIDIDATA_MAXTPQNRESOLUTION) {
 		free (pMIDIData);
-		fclose (pFile);
 		return NULL;
 	}
 	
@@ -10954,35 +12436,30 @@ MIDIData* __stdcall MIDIData_LoadFromCherryA (const char* pszFileName) {
 	lTempNumTrack = (long)(*(unsigned short*)(byBuf + 10));
 	if (lTempNumTrack <= 0 || lTempNumTrack > MIDIDATA_MAXMIDITRACKNUM) {
 		free (pMIDIData);
-		fclose (pFile);
 		return NULL;
 	}
 
 	/* タイトル読み込み */
-	if (fread (szTempTitle, sizeof(char), 128, pFile) < 128) {
+	if (MIDIDataStream_Read (szTempTitle, sizeof(char), 128, pStream) < 128) {
 		free (pMIDIData);
-		fclose (pFile);
 		return NULL;
 	}
 
 	/* 著作権読み込み */
-	if (fread (szTempCopyright, sizeof(char), 128, pFile) < 128) {
+	if (MIDIDataStream_Read (szTempCopyright, sizeof(char), 128, pStream) < 128) {
 		free (pMIDIData);
-		fclose (pFile);
 		return NULL;
 	}
 
 	/* 拡張データ先頭アドレス配列読み込み */
-	if (fread (lTempExtendedDataAddress, sizeof(long), 64, pFile) < 64) {
+	if (MIDIDataStream_Read (lTempExtendedDataAddress, sizeof(long), 64, pStream) < 64) {
 		free (pMIDIData);
-		fclose (pFile);
 		return NULL;
 	}
 
 	/* トラック先頭アドレス配列読み込み */
-	if (fread (lTempTrackAddress, sizeof(long), lTempNumTrack, pFile) < (unsigned long)lTempNumTrack) {
+	if (MIDIDataStream_Read (lTempTrackAddress, sizeof(long), lTempNumTrack, pStream) < (unsigned long)lTempNumTrack) {
 		free (pMIDIData);
-		fclose (pFile);
 		return NULL;
 	}
 
@@ -10990,16 +12467,14 @@ MIDIData* __stdcall MIDIData_LoadFromCherryA (const char* pszFileName) {
 	for (lTrackIndex = 0; lTrackIndex < lTempNumTrack; lTrackIndex++) {
 
 		/* トラックの長さ[バイト]取得 */
-		if (fread (&lTrackLen, sizeof (long), 1, pFile) < 1) {
+		if (MIDIDataStream_Read (&lTrackLen, sizeof (long), 1, pStream) < 1) {
 			free (pTrackData);
 			free (pMIDIData);
-			fclose (pFile);
 			return NULL;
 		}
 		if (lTrackLen < 128 || lTrackLen >= 16777216) {
 			free (pTrackData);
 			free (pMIDIData);
-			fclose (pFile);
 			return NULL;
 		}
 
@@ -11008,15 +12483,13 @@ MIDIData* __stdcall MIDIData_LoadFromCherryA (const char* pszFileName) {
 		if (pTrackData == NULL) {
 			free (pTrackData);
 			free (pMIDIData);
-			fclose (pFile);
 			return NULL;
 		}
 		
 		/* 1トラック読み込み */
-		if (fread (pTrackData, sizeof (char), lTrackLen - 4, pFile) < (unsigned long)lTrackLen - 4) {
+		if (MIDIDataStream_Read (pTrackData, sizeof (char), lTrackLen - 4, pStream) < (unsigned long)lTrackLen - 4) {
 			free (pTrackData);
 			free (pMIDIData);
-			fclose (pFile);
 			return NULL;
 		}
 
@@ -11025,7 +12498,6 @@ MIDIData* __stdcall MIDIData_LoadFromCherryA (const char* pszFileName) {
 		if (pMIDITrack == NULL) {
 			free (pTrackData);
 			free (pMIDIData);
-			fclose (pFile);
 			return NULL;
 		}
 		
@@ -11034,7 +12506,6 @@ MIDIData* __stdcall MIDIData_LoadFromCherryA (const char* pszFileName) {
 		if (lRet == 0) {
 			free (pTrackData);
 			free (pMIDIData);
-			fclose (pFile);
 		}
 	
 		free (pTrackData);
@@ -11045,12 +12516,11 @@ MIDIData* __stdcall MIDIData_LoadFromCherryA (const char* pszFileName) {
 	pMIDITrack = pMIDIData->m_pFirstTrack;
 	assert (pMIDITrack);
 	/* 調性拍子マーカーデータ(ある場合のみ) */
-           	if (!feof (pFile) && lTempExtendedDataAddress[0] != 0x00000000) {
+           	if (!MIDIDataStream_EOF (pStream) && lTempExtendedDataAddress[0] != 0x00000000) {
 		long lExtendedLen = 0;
 		long lTimeKeySignatureIndex = 0;
-		if (fread (&lExtendedLen, sizeof (long), 1, pFile) < 1) {
+		if (MIDIDataStream_Read (&lExtendedLen, sizeof (long), 1, pStream) < 1) {
 			free (pMIDIData);
-			fclose (pFile);
 			return NULL;
 		}
 		/* 1回につき80バイト */
@@ -11068,9 +12538,8 @@ MIDIData* __stdcall MIDIData_LoadFromCherryA (const char* pszFileName) {
 			long lmi = 0;
 			long j;
 			memset (byBuf, 0, sizeof (byBuf));
-			if (fread (byBuf, sizeof (char), 80, pFile) < 80) {
+			if (MIDIDataStream_Read (byBuf, sizeof (char), 80, pStream) < 80) {
 				free (pMIDIData);
-				fclose (pFile);
 				return NULL;
 			}
 			lMeasure = (long)(*(unsigned short*)(byBuf));
@@ -11097,231 +12566,49 @@ MIDIData* __stdcall MIDIData_LoadFromCherryA (const char* pszFileName) {
 		}
 	}
 
-	fclose (pFile);
-
 	MIDIData_SetTitleA (pMIDIData, szTempTitle);
 	MIDIData_SetCopyrightA (pMIDIData, szTempCopyright);
 	
 	return pMIDIData;
 }
 
+/* MIDIDataをCherryシーケンスファイル(*.chy)から読み込み(ANSI) */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+MIDIData* __stdcall MIDIData_LoadFromCherryA (const char* pszFileName) {
+	MIDIDataStream theStream;
+	MIDIData* pMIDIData = NULL;
+	if (MIDIDataStream_OpenFileA (&theStream, pszFileName, "rb") == 0) {
+		return NULL;
+	}
+	pMIDIData = MIDIData_LoadFromCherryStream (&theStream);
+	MIDIDataStream_Close (&theStream);
+	return pMIDIData;
+}
+
 /* MIDIDataをCherryシーケンスファイル(*.chy)から読み込み(UNICODE) */
 /* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
 /* ファイル名はUNICODEで与えるがファイルの中身は仕様に基づきANSIである。 */
 MIDIData* __stdcall MIDIData_LoadFromCherryW (const wchar_t* pszFileName) {
+	MIDIDataStream theStream;
 	MIDIData* pMIDIData = NULL;
-	MIDITrack* pMIDITrack = NULL;
-	FILE* pFile = NULL;
-	errno_t nErrorNo = 0;
-	long lRet = 0;
-	long lTrackLen = 0;
-	long lTrackIndex = 0;
-	unsigned char* pTrackData = NULL;
-	unsigned char byBuf[256];
-	char szTempTitle[256];
-	char szTempCopyright[256];
-	long lTempNumTrack = 0;
-	long lTempExtendedDataAddress[64];
-	long lTempTrackAddress[256];
-	memset (szTempTitle, 0, sizeof (szTempTitle));
-	memset (szTempCopyright, 0, sizeof (szTempCopyright));
-	memset (lTempExtendedDataAddress, 0, sizeof (long) * 64);
-	memset (lTempTrackAddress, 0, sizeof (long) * 256);
-
-	pMIDIData = malloc (sizeof (MIDIData));
-	memset (pMIDIData, 0, sizeof (MIDIData));
-	if (pMIDIData == NULL) {
-		return NULL;
-	}
-	pMIDIData->m_pFirstTrack = NULL;
-	pMIDIData->m_pLastTrack = NULL;
-	pMIDIData->m_pNextSeq = NULL;
-	pMIDIData->m_pPrevSeq = NULL;
-	pMIDIData->m_pParent = NULL;
-	pMIDIData->m_lUser1 = 0;
-	pMIDIData->m_lUser2 = 0;
-	pMIDIData->m_lUser3 = 0;
-
-	nErrorNo = _wfopen_s (&pFile, pszFileName, L"rb");
-	if (pFile == NULL) {
-		free (pMIDIData);
-		return NULL;
-	}
-	if (fread (byBuf, sizeof(char), 256, pFile) < 256) {
-		free (pMIDIData);
-		fclose (pFile);
-		return NULL;
-	}
-
-	/* 識別ID読み込み */
-	if (memcmp (byBuf, "CHRY0101", 8) != 0) {
-		free (pMIDIData);
-		fclose (pFile);
-		return NULL; 
-	}
-	pMIDIData->m_lFormat = 1;
-
-	/* タイムベース読み込み(TPQNベース固定、1～32767) */
-	pMIDIData->m_lTimeBase = (long)(*(unsigned short*)(byBuf + 8));
-	if (pMIDIData->m_lTimeBase < 1 || pMIDIData->m_lTimeBase > MIDIDATA_MAXTPQNRESOLUTION) {
-		free (pMIDIData);
-		fclose (pFile);
-		return NULL;
-	}
-	
-	/* トラック数読み込み */
-	lTempNumTrack = (long)(*(unsigned short*)(byBuf + 10));
-	if (lTempNumTrack <= 0 || lTempNumTrack > MIDIDATA_MAXMIDITRACKNUM) {
-		free (pMIDIData);
-		fclose (pFile);
-		return NULL;
-	}
-
-	/* タイトル読み込み */
-	if (fread (szTempTitle, sizeof(char), 128, pFile) < 128) {
-		free (pMIDIData);
-		fclose (pFile);
-		return NULL;
-	}
-
-	/* 著作権読み込み */
-	if (fread (szTempCopyright, sizeof(char), 128, pFile) < 128) {
-		free (pMIDIData);
-		fclose (pFile);
-		return NULL;
-	}
-
-	/* 拡張データ先頭アドレス配列読み込み */
-	if (fread (lTempExtendedDataAddress, sizeof(long), 64, pFile) < 64) {
-		free (pMIDIData);
-		fclose (pFile);
+	if (MIDIDataStream_OpenFileW (&theStream, pszFileName, L"rb") == 0) {
 		return NULL;
 	}
+	pMIDIData = MIDIData_LoadFromCherryStream (&theStream);
+	MIDIDataStream_Close (&theStream);
+	return pMIDIData;
+}
 
-	/* トラック先頭アドレス配列読み込み */
-	if (fread (lTempTrackAddress, sizeof(long), lTempNumTrack, pFile) < (unsigned long)lTempNumTrack) {
-		free (pMIDIData);
-		fclose (pFile);
+/* MIDIDataをCherryシーケンスファイル(*.chy)から読み込み(メモリブロック)(20261019追加) */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+MIDIData* __stdcall MIDIData_LoadFromCherryMemory (const void* pData, long lLen) {
+	MIDIDataStream theStream;
+	/* 引数の検査 */
+	if (pData == NULL || lLen < 0) {
 		return NULL;
 	}
-
-	/* 各トラック読み込み */
-	for (lTrackIndex = 0; lTrackIndex < lTempNumTrack; lTrackIndex++) {
-
-		/* トラックの長さ[バイト]取得 */
-		if (fread (&lTrackLen, sizeof (long), 1, pFile) < 1) {
-			free (pTrackData);
-			free (pMIDIData);
-			fclose (pFile);
-			return NULL;
-		}
-		if (lTrackLen < 128 || lTrackLen >= 16777216) {
-			free (pTrackData);
-			free (pMIDIData);
-			fclose (pFile);
-			return NULL;
-		}
-
-		/* 1トラック用のメモリ割り当て */
-		pTrackData = malloc (lTrackLen - 4);
-		if (pTrackData == NULL) {
-			free (pTrackData);
-			free (pMIDIData);
-			fclose (pFile);
-			return NULL;
-		}
-		
-		/* 1トラック読み込み */
-		if (fread (pTrackData, sizeof (char), lTrackLen - 4, pFile) < (unsigned long)lTrackLen - 4) {
-			free (pTrackData);
-			free (pMIDIData);
-			fclose (pFile);
-			return NULL;
-		}
-
-		/* トラック内のデータ読み込み関数を呼び出し */
-		pMIDITrack = MIDITrack_LoadFromCherry (lTrackIndex, pTrackData, lTrackLen);
-		if (pMIDITrack == NULL) {
-			free (pTrackData);
-			free (pMIDIData);
-			fclose (pFile);
-			return NULL;
-		}
-		
-		/* 新しく作られたトラックを追加 */
-		lRet = MIDIData_AddTrackForce (pMIDIData, pMIDITrack);
-		if (lRet == 0) {
-			free (pTrackData);
-			free (pMIDIData);
-			fclose (pFile);
-		}
-	
-		free (pTrackData);
-		pTrackData = NULL;
-	}
-
-	/* 拡張データ */
-	pMIDITrack = pMIDIData->m_pFirstTrack;
-	assert (pMIDITrack);
-	/* 調性拍子マーカーデータ(ある場合のみ) */
-           	if (!feof (pFile) && lTempExtendedDataAddress[0] != 0x00000000) {
-		long lExtendedLen = 0;
-		long lTimeKeySignatureIndex = 0;
-		if (fread (&lExtendedLen, sizeof (long), 1, pFile) < 1) {
-			free (pMIDIData);
-			fclose (pFile);
-			return NULL;
-		}
-		/* 1回につき80バイト */
-		for (lTimeKeySignatureIndex = 0; 
-			lTimeKeySignatureIndex < lExtendedLen / 80; 
-			lTimeKeySignatureIndex++) {
-			long lMeasure = 0;
-			long lTime = 0;
-			long lnn = 0;
-			long lddTemp = 0;
-			long ldd = 2;
-			long lcc = 24;
-			long lbb = 8;
-			long lsf = 0;
-			long lmi = 0;
-			long j;
-			memset (byBuf, 0, sizeof (byBuf));
-			if (fread (byBuf, sizeof (char), 80, pFile) < 80) {
-				free (pMIDIData);
-				fclose (pFile);
-				return NULL;
-			}
-			lMeasure = (long)(*(unsigned short*)(byBuf));
-			lnn = (long)(*(unsigned char*)(byBuf + 2));
-			lddTemp = (long)(*(unsigned char*)(byBuf + 3));
-			for (j = 0; j < 7; j++) {
-				if (lddTemp == (1 << j)) {
-					ldd = j;
-					break;
-				}
-			}
- 			lsf = (long)(*(unsigned char*)(byBuf + 4));
-			if (lsf >= 9) {
-				lsf = 8 - lsf;
-			}
-			byBuf[79] = 0;
-			MIDIData_MakeTime (pMIDIData, lMeasure, 0, 0, &lTime);
-			/* マーカー挿入 */
-			MIDITrack_InsertMarkerA (pMIDITrack, lTime, (char*)(&byBuf[16]));
-			/* 調性記号挿入 */
-			MIDITrack_InsertKeySignature (pMIDITrack, lTime, lsf, lmi);
-			/* 拍子記号挿入 */
-			MIDITrack_InsertTimeSignature (pMIDITrack, lTime, lnn, ldd, lcc, lbb);
-		}
-	}
-
-	fclose (pFile);
-
-	MIDIData_SetTitleA (pMIDIData, szTempTitle);
-	MIDIData_SetCopyrightA (pMIDIData, szTempCopyright);
-	
-	return pMIDIData;
+	MIDIDataStream_OpenMemory (&theStream, pData, lLen, 0);
+	return MIDIData_LoadFromCherryStream (&theStream);
 }
 
 
@@ -12339,13 +13626,10 @@ long __stdcall MIDITrack_IsSystemSetupTrack (MIDITrack* pMIDITrack) {
 	return 1;
 }
 
-/* MIDIデータをCherryシーケンスファイル(*.chy)に保存(ANSI) */
+/* MIDIデータをCherryシーケンスファイル(*.chy)に保存(非公開)(20261019追加) */
 /* 戻り値：正常終了=1、異常終了=0。 */
-long __stdcall MIDIData_SaveAsCherryA (MIDIData* pMIDIData, const char* pszFileName) {
-
+static long MIDIData_SaveAsCherryStream (MIDIData* pMIDIData, MIDIDataStream* pStream) {
 	MIDITrack* pMIDITrack = NULL;
-	FILE* pFile = NULL;
-	errno_t nErrorNo = 0;
 	long lGuessTrackLen = 0;
 	long lTrackLen = 0;
 	long lTrackLen4 = 0;
@@ -12392,38 +13676,30 @@ long __stdcall MIDIData_SaveAsCherryA (MIDIData* pMIDIData, const char* pszFileN
 	}
 
 	/* ファイルオープン */
-	nErrorNo = fopen_s (&pFile, pszFileName, "wb");
-	if (pFile == NULL) {
-		return 0;
-	}
 
 	/* ヘッダー(256byte) */
 	memset (&byBuf[0], 0, sizeof (byBuf));
 	strcpy_s ((char*)(&byBuf[0]), sizeof (byBuf), "CHRY0101");
 	memcpy (&byBuf[8], &usTimeResolution, 2);
 	memcpy (&byBuf[10], &usNumTrack, 2);
-	if (fwrite (byBuf, 1, 256, pFile) < 256) {
-		fclose (pFile);
+	if (MIDIDataStream_Write (byBuf, 1, 256, pStream) < 256) {
 		return 0;
 	}
 	/* 曲名と著作権(128+128=256byte) */
 	memset (&byBuf[0], 0, sizeof (byBuf));
 	MIDIData_GetTitleA (pMIDIData, (char*)(&byBuf[0]), 127);
 	MIDIData_GetCopyrightA (pMIDIData, (char*)(&byBuf[128]), 127);
-	if (fwrite (byBuf, 1, 256, pFile) < 256) {
-		fclose (pFile);
+	if (MIDIDataStream_Write (byBuf, 1, 256, pStream) < 256) {
 		return 0;
 	}
 	/* 拡張データの先頭アドレス(4*64=256byte) */
 	memset (lTempExtendedDataAddress, 0, sizeof (long) * 64);
-	if (fwrite (lTempExtendedDataAddress, sizeof (long), 64, pFile) < 64) {
-		fclose (pFile);
+	if (MIDIDataStream_Write (lTempExtendedDataAddress, sizeof (long), 64, pStream) < 64) {
 		return 0;
 	}
 	/* トラックの先頭アドレス(4*usNumTrack byte) */
 	memset (lTempTrackAddress, 0, sizeof (long) * 65536);
-	if (fwrite (lTempTrackAddress, sizeof (long), usNumTrack, pFile) < usNumTrack) {
-		fclose (pFile);
+	if (MIDIDataStream_Write (lTempTrackAddress, sizeof (long), usNumTrack, pStream) < usNumTrack) {
 		return 0;
 	}
 
@@ -12432,11 +13708,10 @@ long __stdcall MIDIData_SaveAsCherryA (MIDIData* pMIDIData, const char* pszFileN
 		long i;
 		MIDITrack* pMIDITrack = MIDIData_GetFirstTrack (pMIDIData);
 		/* テンポ専用トラック */
-		lTempTrackAddress[lTrackIndex] = ftell (pFile);
+		lTempTrackAddress[lTrackIndex] = MIDIDataStream_Tell (pStream);
 		lGuessTrackLen = MIDITrack_GuessTrackDataLenAsCherry (pMIDITrack);
 		pTrackData = malloc (lGuessTrackLen);
 		if (pTrackData == NULL) {
-			fclose (pFile);
 			return 0;
 		}
 		memset (pTrackData, 0, lGuessTrackLen);
@@ -12444,44 +13719,39 @@ long __stdcall MIDIData_SaveAsCherryA (MIDIData* pMIDIData, const char* pszFileN
 		assert (124 <= lTrackLen && lTrackLen < lGuessTrackLen);
 		lTrackLen4 = lTrackLen + 4;
 		/* トラック長さ(4byte) */
-		if (fwrite (&lTrackLen4, sizeof (long), 1, pFile) < 1) {
+		if (MIDIDataStream_Write (&lTrackLen4, sizeof (long), 1, pStream) < 1) {
 			free (pTrackData);
-			fclose (pFile);
 			return 0;
 		}
 		/* トラックデータ(lTrackLenbyte) */
-		if (fwrite (pTrackData, 1, lTrackLen, pFile) < (unsigned long)lTrackLen) {
+		if (MIDIDataStream_Write (pTrackData, 1, lTrackLen, pStream) < (unsigned long)lTrackLen) {
 			free (pTrackData);
-			fclose (pFile);
 			return 0;
 		}
 		lTrackIndex++;
 		/* システムセットアップ用トラック */
-		lTempTrackAddress[lTrackIndex] = ftell (pFile);
+		lTempTrackAddress[lTrackIndex] = MIDIDataStream_Tell (pStream);
 		memset (pTrackData, 0, lGuessTrackLen);
-		lTrackLen = MIDITrack_SaveAsCherry2 (pMIDITrack, pTrackData, lGuessTrackLen);
+		lTrackLen = MIDITrack_SaveAsCherry1 (pMIDITrack, pTrackData, lGuessTrackLen);
 		assert (124 <= lTrackLen && lTrackLen < lGuessTrackLen);
 		lTrackLen4 = lTrackLen + 4;
 		/* トラック長さ(4byte) */
-		if (fwrite (&lTrackLen4, sizeof (long), 1, pFile) < 1) {
+		if (MIDIDataStream_Write (&lTrackLen4, sizeof (long), 1, pStream) < 1) {
 			free (pTrackData);
-			fclose (pFile);
 			return 0;
 		}
 		/* トラックデータ(lTrackLenbyte) */
-		if (fwrite (pTrackData, 1, lTrackLen, pFile) < (unsigned long)lTrackLen) {
+		if (MIDIDataStream_Write (pTrackData, 1, lTrackLen, pStream) < (unsigned long)lTrackLen) {
 			free (pTrackData);
-			fclose (pFile);
 			return 0;
 		}
 		lTrackIndex++;
 		/* チャンネル1～16用トラック */		
 		for (i = 0; i < 16; i++) {
-			lTempTrackAddress[lTrackIndex] = ftell (pFile);
+			lTempTrackAddress[lTrackIndex] = MIDIDataStream_Tell (pStream);
 			lGuessTrackLen = MIDITrack_GuessTrackDataLenAsCherry (pMIDITrack);
 			pTrackData = malloc (lGuessTrackLen);
 			if (pTrackData == NULL) {
-				fclose (pFile);
 				return 0;
 			}
 			memset (pTrackData, 0, lGuessTrackLen);
@@ -12489,15 +13759,13 @@ long __stdcall MIDIData_SaveAsCherryA (MIDIData* pMIDIData, const char* pszFileN
 			assert (124 <= lTrackLen && lTrackLen < lGuessTrackLen);
 			lTrackLen4 = lTrackLen + 4;
 			/* トラック長さ(4byte) */
-			if (fwrite (&lTrackLen4, sizeof (long), 1, pFile) < 1) {
+			if (MIDIDataStream_Write (&lTrackLen4, sizeof (long), 1, pStream) < 1) {
 				free (pTrackData);
-				fclose (pFile);
 				return 0;
 			}
 			/* トラックデータ(lTrackLenbyte) */
-			if (fwrite (pTrackData, 1, lTrackLen, pFile) < (unsigned long)lTrackLen) {
+			if (MIDIDataStream_Write (pTrackData, 1, lTrackLen, pStream) < (unsigned long)lTrackLen) {
 				free (pTrackData);
-				fclose (pFile);
 				return 0;
 			}
 			pTrackData = NULL;
@@ -12514,11 +13782,10 @@ long __stdcall MIDIData_SaveAsCherryA (MIDIData* pMIDIData, const char* pszFileN
 			/* トラック0(コンダクタートラック) */
 			if (pMIDITrack->m_lTempIndex == 0) {
 				/* トラック0のテンポ部のみ保存 */
-				lTempTrackAddress[lTrackIndex] = ftell (pFile);
+				lTempTrackAddress[lTrackIndex] = MIDIDataStream_Tell (pStream);
 				lGuessTrackLen = MIDITrack_GuessTrackDataLenAsCherry (pMIDITrack);
 				pTrackData = malloc (lGuessTrackLen);
 				if (pTrackData == NULL) {
-					fclose (pFile);
 					return 0;
 				}
 				memset (pTrackData, 0, lGuessTrackLen);
@@ -12526,26 +13793,23 @@ long __stdcall MIDIData_SaveAsCherryA (MIDIData* pMIDIData, const char* pszFileN
 				assert (124 <= lTrackLen && lTrackLen < lGuessTrackLen);
 				lTrackLen4 = lTrackLen + 4;
 				/* トラック長さ(4byte) */
-				if (fwrite (&lTrackLen4, sizeof (long), 1, pFile) < 1) {
+				if (MIDIDataStream_Write (&lTrackLen4, sizeof (long), 1, pStream) < 1) {
 					free (pTrackData);
-					fclose (pFile);
 					return 0;
 				}
 				/* トラックデータ(lTrackLenbyte) */
-				if (fwrite (pTrackData, 1, lTrackLen, pFile) < (unsigned long)lTrackLen) {
+				if (MIDIDataStream_Write (pTrackData, 1, lTrackLen, pStream) < (unsigned long)lTrackLen) {
 					free (pTrackData);
-					fclose (pFile);
 					return 0;
 				}
 				lTrackIndex++;
 				/* システムセットアップ専用トラックがない場合 */
 				if (lHasSystemSetupTrack == 0) {
 					/* トラック0からシステムセットアップを生成し追加トラックとして保存 */
-					lTempTrackAddress[lTrackIndex] = ftell (pFile);
+					lTempTrackAddress[lTrackIndex] = MIDIDataStream_Tell (pStream);
 					lGuessTrackLen = MIDITrack_GuessTrackDataLenAsCherry (pMIDITrack);
 					pTrackData = malloc (lGuessTrackLen);
 					if (pTrackData == NULL) {
-						fclose (pFile);
 						return 0;
 					}
 					memset (pTrackData, 0, lGuessTrackLen);
@@ -12553,15 +13817,13 @@ long __stdcall MIDIData_SaveAsCherryA (MIDIData* pMIDIData, const char* pszFileN
 					assert (124 <= lTrackLen && lTrackLen < lGuessTrackLen);
 					lTrackLen4 = lTrackLen + 4;
 					/* トラック長さ(4byte) */
-					if (fwrite (&lTrackLen4, sizeof (long), 1, pFile) < 1) {
+					if (MIDIDataStream_Write (&lTrackLen4, sizeof (long), 1, pStream) < 1) {
 						free (pTrackData);
-						fclose (pFile);
 						return 0;
 					}
 					/* トラックデータ(lTrackLenbyte) */
-					if (fwrite (pTrackData, 1, lTrackLen, pFile) < (unsigned long)lTrackLen) {
+					if (MIDIDataStream_Write (pTrackData, 1, lTrackLen, pStream) < (unsigned long)lTrackLen) {
 						free (pTrackData);
-						fclose (pFile);
 						return 0;
 					}
 					free (pTrackData);
@@ -12571,11 +13833,10 @@ long __stdcall MIDIData_SaveAsCherryA (MIDIData* pMIDIData, const char* pszFileN
 			}
 			/* トラック1以降(システムセットアップトラック又は通常トラック) */
 			else {
-				lTempTrackAddress[lTrackIndex] = ftell (pFile);
+				lTempTrackAddress[lTrackIndex] = MIDIDataStream_Tell (pStream);
 				lGuessTrackLen = MIDITrack_GuessTrackDataLenAsCherry (pMIDITrack);
 				pTrackData = malloc (lGuessTrackLen);
 				if (pTrackData == NULL) {
-					fclose (pFile);
 					return 0;
 				}
 				memset (pTrackData, 0, lGuessTrackLen);
@@ -12583,15 +13844,13 @@ long __stdcall MIDIData_SaveAsCherryA (MIDIData* pMIDIData, const char* pszFileN
 				assert (124 <= lTrackLen && lTrackLen < lGuessTrackLen);
 				lTrackLen4 = lTrackLen + 4;
 				/* トラック長さ(4byte) */
-				if (fwrite (&lTrackLen4, sizeof (long), 1, pFile) < 1) {
+				if (MIDIDataStream_Write (&lTrackLen4, sizeof (long), 1, pStream) < 1) {
 					free (pTrackData);
-					fclose (pFile);
 					return 0;
 				}
 				/* トラックデータ(lTrackLenbyte) */
-				if (fwrite (pTrackData, 1, lTrackLen, pFile) < (unsigned long)lTrackLen) {
+				if (MIDIDataStream_Write (pTrackData, 1, lTrackLen, pStream) < (unsigned long)lTrackLen) {
 					free (pTrackData);
-					fclose (pFile);
 					return 0;
 				}
 				free (pTrackData);
@@ -12605,26 +13864,23 @@ long __stdcall MIDIData_SaveAsCherryA (MIDIData* pMIDIData, const char* pszFileN
 	/* 拍子調性 */
 	if (pMIDIData->m_pFirstTrack) {
 		pMIDITrack = pMIDIData->m_pFirstTrack;
-		lTempExtendedDataAddress[0] = ftell (pFile);
+		lTempExtendedDataAddress[0] = MIDIDataStream_Tell (pStream);
 		lGuessTrackLen = MIDITrack_GuessTrackDataLenAsCherry (pMIDITrack);
 		pTrackData = malloc (lGuessTrackLen);
 		if (pTrackData == NULL) {
-			fclose (pFile);
 			return 0;
 		}
 		memset (pTrackData, 0, lGuessTrackLen);
 		lTrackLen = MIDITrack_SaveAsCherry3 (pMIDITrack, pTrackData, lGuessTrackLen);
 		assert (0 <= lTrackLen && lTrackLen < lGuessTrackLen);
 		/* 拍子調性データの長さ(4byte) */
-		if (fwrite (&lTrackLen, sizeof (long), 1, pFile) < 1) {
+		if (MIDIDataStream_Write (&lTrackLen, sizeof (long), 1, pStream) < 1) {
 			free (pTrackData);
-			fclose (pFile);
 			return 0;
 		}
 		/* 拍子調性データ(lTrackLenbyte) */
-		if (fwrite (pTrackData, 1, lTrackLen, pFile) < (unsigned long)lTrackLen) {
+		if (MIDIDataStream_Write (pTrackData, 1, lTrackLen, pStream) < (unsigned long)lTrackLen) {
 			free (pTrackData);
-			fclose (pFile);
 			return 0;
 		}
 		free (pTrackData);
@@ -12632,24 +13888,20 @@ long __stdcall MIDIData_SaveAsCherryA (MIDIData* pMIDIData, const char* pszFileN
 	}
 
 	/* 拡張データ先頭アドレスの書き込み */
-	fseek (pFile, 512, SEEK_SET);
-	if (fwrite (lTempExtendedDataAddress, sizeof (long), 64, pFile) < 64) {
-		fclose (pFile);
+	MIDIDataStream_Seek (pStream, 512, SEEK_SET);
+	if (MIDIDataStream_Write (lTempExtendedDataAddress, sizeof (long), 64, pStream) < 64) {
 		return 0;
 	}
 
 	/* トラック先頭アドレスの再書き込み */
-	fseek (pFile, 768, SEEK_SET);
-	if (fwrite (lTempTrackAddress, sizeof (long), usNumTrack, pFile) < usNumTrack) {
-		fclose (pFile);
+	MIDIDataStream_Seek (pStream, 768, SEEK_SET);
+	if (MIDIDataStream_Write (lTempTrackAddress, sizeof (long), usNumTrack, pStream) < usNumTrack) {
 		return 0;
 	}
 
 	free (pTrackData);
 	pTrackData = NULL;
-
-	fclose (pFile);
-	pFile = NULL;
+	pStream = NULL;
 
 	forEachTrack (pMIDIData, pMIDITrack) {
 		pMIDITrack->m_lInputOn = 1;
@@ -12661,326 +13913,44 @@ long __stdcall MIDIData_SaveAsCherryA (MIDIData* pMIDIData, const char* pszFileN
 	return 1;
 }
 
+/* MIDIデータをCherryシーケンスファイル(*.chy)に保存(ANSI) */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsCherryA (MIDIData* pMIDIData, const char* pszFileName) {
+	MIDIDataStream theStream;
+	long lRet = 0;
+	if (MIDIDataStream_OpenFileA (&theStream, pszFileName, "wb") == 0) {
+		return 0;
+	}
+	lRet = MIDIData_SaveAsCherryStream (pMIDIData, &theStream);
+	MIDIDataStream_Close (&theStream);
+	return lRet;
+}
+
 /* MIDIデータをCherryシーケンスファイル(*.chy)に保存(UNICODE) */
 /* ファイル名はUNICODEで与えるがファイルの中身は仕様に基づきANSIである。 */
 /* 戻り値：正常終了=1、異常終了=0。 */
 long __stdcall MIDIData_SaveAsCherryW (MIDIData* pMIDIData, const wchar_t* pszFileName) {
-	MIDITrack* pMIDITrack = NULL;
-	FILE* pFile = NULL;
-	errno_t nErrorNo = 0;
-	long lGuessTrackLen = 0;
-	long lTrackLen = 0;
-	long lTrackLen4 = 0;
-	long lTrackIndex = 0;
-	unsigned short usFormat = (unsigned short)MIDIData_GetFormat (pMIDIData);
-	unsigned short usTimeMode = (unsigned short)MIDIData_GetTimeMode (pMIDIData);
-	unsigned short usTimeResolution = (unsigned short)MIDIData_GetTimeResolution (pMIDIData);
-	unsigned short usNumTrack = (usFormat == 0 ? 18 : (unsigned short)MIDIData_CountTrack (pMIDIData));
-	unsigned char* pTrackData = NULL;
-	unsigned char byBuf[256];
-	char szTempTitle[256];
-	char szTempCopyright[256];
-	long lHasSystemSetupTrack = 0;
-	long lTempExtendedDataAddress[64];
-	long lTempTrackAddress[65536];
-	memset (szTempTitle, 0, sizeof (szTempTitle));
-	memset (szTempCopyright, 0, sizeof (szTempCopyright));
-	memset (lTempExtendedDataAddress, 0, sizeof (long) * 64);
-	memset (lTempTrackAddress, 0, sizeof (long) * 65536);
-
-	/* 最終的な保存トラック数の計算 */
-	if (usFormat == 0) {
-		usNumTrack = 18;
-	}
-	else {
-		usNumTrack = (unsigned short)CLIP (0, MIDIData_CountTrack (pMIDIData), MIDIDATA_MAXMIDITRACKNUM);
-		if (usNumTrack >= 2) {
-			MIDITrack* pSecondTrack = pMIDIData->m_pFirstTrack->m_pNextTrack;
-			/* システムセットアップ専用トラックがない場合、 */
-			/* システムセットアップ専用トラックを追加保存するので+1 */
-			if (MIDITrack_IsSystemSetupTrack (pSecondTrack) == 0) {
-				usNumTrack++;
-			}
-			/* システムセットアップ専用トラックがある場合 */
-			else {
-				lHasSystemSetupTrack = 1;
-			}
-		}
-		/* システムセットアップ専用トラックがない場合、 */
-		/* システムセットアップ専用トラックを追加保存するので+1 */
-		else {
-			usNumTrack++;
-		}
-	}
-
-	/* ファイルオープン */
-	nErrorNo = _wfopen_s (&pFile, pszFileName, L"wb");
-	if (pFile == NULL) {
+	MIDIDataStream theStream;
+	long lRet = 0;
+	if (MIDIDataStream_OpenFileW (&theStream, pszFileName, L"wb") == 0) {
 		return 0;
 	}
+	lRet = MIDIData_SaveAsCherryStream (pMIDIData, &theStream);
+	MIDIDataStream_Close (&theStream);
+	return lRet;
+}
 
-	/* ヘッダー(256byte) */
-	memset (&byBuf[0], 0, sizeof (byBuf));
-	strcpy_s ((char*)(&byBuf[0]), sizeof (byBuf), "CHRY0101");
-	memcpy (&byBuf[8], &usTimeResolution, 2);
-	memcpy (&byBuf[10], &usNumTrack, 2);
-	if (fwrite (byBuf, 1, 256, pFile) < 256) {
-		fclose (pFile);
-		return 0;
-	}
-	/* 曲名と著作権(128+128=256byte) */
-	memset (&byBuf[0], 0, sizeof (byBuf));
-	MIDIData_GetTitleA (pMIDIData, (char*)(&byBuf[0]), 127);
-	MIDIData_GetCopyrightA (pMIDIData, (char*)(&byBuf[128]), 127);
-	if (fwrite (byBuf, 1, 256, pFile) < 256) {
-		fclose (pFile);
+/* MIDIデータをCherryシーケンスファイル(*.chy)に保存(メモリブロック)(20261019追加) */
+/* 保存したデータは*ppDataに、その長さは*pLenに返す。*ppDataはMIDIDataLib_FreeMemoryで解放すること。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsCherryMemory (MIDIData* pMIDIData, void** ppData, long* pLen) {
+	MIDIDataStream theStream;
+	MIDIDataStream_CreateMemory (&theStream, 0);
+	if (MIDIData_SaveAsCherryStream (pMIDIData, &theStream) == 0) {
+		MIDIDataStream_Close (&theStream);
 		return 0;
 	}
-	/* 拡張データの先頭アドレス(4*64=256byte) */
-	memset (lTempExtendedDataAddress, 0, sizeof (long) * 64);
-	if (fwrite (lTempExtendedDataAddress, sizeof (long), 64, pFile) < 64) {
-		fclose (pFile);
-		return 0;
-	}
-	/* トラックの先頭アドレス(4*usNumTrack byte) */
-	memset (lTempTrackAddress, 0, sizeof (long) * 65536);
-	if (fwrite (lTempTrackAddress, sizeof (long), usNumTrack, pFile) < usNumTrack) {
-		fclose (pFile);
-		return 0;
-	}
-
-	/* フォーマット0の場合 */
-	if (usFormat == 0) {
-		long i;
-		MIDITrack* pMIDITrack = MIDIData_GetFirstTrack (pMIDIData);
-		/* テンポ専用トラック */
-		lTempTrackAddress[lTrackIndex] = ftell (pFile);
-		lGuessTrackLen = MIDITrack_GuessTrackDataLenAsCherry (pMIDITrack);
-		pTrackData = malloc (lGuessTrackLen);
-		if (pTrackData == NULL) {
-			fclose (pFile);
-			return 0;
-		}
-		memset (pTrackData, 0, lGuessTrackLen);
-		lTrackLen = MIDITrack_SaveAsCherry0 (pMIDITrack, pTrackData, lGuessTrackLen);
-		assert (124 <= lTrackLen && lTrackLen < lGuessTrackLen);
-		lTrackLen4 = lTrackLen + 4;
-		/* トラック長さ(4byte) */
-		if (fwrite (&lTrackLen4, sizeof (long), 1, pFile) < 1) {
-			free (pTrackData);
-			fclose (pFile);
-			return 0;
-		}
-		/* トラックデータ(lTrackLenbyte) */
-		if (fwrite (pTrackData, 1, lTrackLen, pFile) < (unsigned long)lTrackLen) {
-			free (pTrackData);
-			fclose (pFile);
-			return 0;
-		}
-		lTrackIndex++;
-		/* システムセットアップ用トラック */
-		lTempTrackAddress[lTrackIndex] = ftell (pFile);
-		memset (pTrackData, 0, lGuessTrackLen);
-		lTrackLen = MIDITrack_SaveAsCherry1 (pMIDITrack, pTrackData, lGuessTrackLen);
-		assert (124 <= lTrackLen && lTrackLen < lGuessTrackLen);
-		lTrackLen4 = lTrackLen + 4;
-		/* トラック長さ(4byte) */
-		if (fwrite (&lTrackLen4, sizeof (long), 1, pFile) < 1) {
-			free (pTrackData);
-			fclose (pFile);
-			return 0;
-		}
-		/* トラックデータ(lTrackLenbyte) */
-		if (fwrite (pTrackData, 1, lTrackLen, pFile) < (unsigned long)lTrackLen) {
-			free (pTrackData);
-			fclose (pFile);
-			return 0;
-		}
-		lTrackIndex++;
-		/* チャンネル1～16用トラック */		
-		for (i = 0; i < 16; i++) {
-			lTempTrackAddress[lTrackIndex] = ftell (pFile);
-			lGuessTrackLen = MIDITrack_GuessTrackDataLenAsCherry (pMIDITrack);
-			pTrackData = malloc (lGuessTrackLen);
-			if (pTrackData == NULL) {
-				fclose (pFile);
-				return 0;
-			}
-			memset (pTrackData, 0, lGuessTrackLen);
-			lTrackLen = MIDITrack_SaveAsCherryChannel (pMIDITrack, i, pTrackData, lGuessTrackLen);
-			assert (124 <= lTrackLen && lTrackLen < lGuessTrackLen);
-			lTrackLen4 = lTrackLen + 4;
-			/* トラック長さ(4byte) */
-			if (fwrite (&lTrackLen4, sizeof (long), 1, pFile) < 1) {
-				free (pTrackData);
-				fclose (pFile);
-				return 0;
-			}
-			/* トラックデータ(lTrackLenbyte) */
-			if (fwrite (pTrackData, 1, lTrackLen, pFile) < (unsigned long)lTrackLen) {
-				free (pTrackData);
-				fclose (pFile);
-				return 0;
-			}
-			pTrackData = NULL;
-			free (pTrackData);
-			lTrackIndex++;
-		}
-	}
-	
-	/* フォーマット1,2の場合 */
-	else {
-		/* 各トラックの保存 */
-		lTrackIndex = 0;
-		forEachTrack (pMIDIData, pMIDITrack) {
-			/* トラック0(コンダクタートラック) */
-			if (pMIDITrack->m_lTempIndex == 0) {
-				/* トラック0のテンポ部のみ保存 */
-				lTempTrackAddress[lTrackIndex] = ftell (pFile);
-				lGuessTrackLen = MIDITrack_GuessTrackDataLenAsCherry (pMIDITrack);
-				pTrackData = malloc (lGuessTrackLen);
-				if (pTrackData == NULL) {
-					fclose (pFile);
-					return 0;
-				}
-				memset (pTrackData, 0, lGuessTrackLen);
-				lTrackLen = MIDITrack_SaveAsCherry0 (pMIDITrack, pTrackData, lGuessTrackLen);
-				assert (124 <= lTrackLen && lTrackLen < lGuessTrackLen);
-				lTrackLen4 = lTrackLen + 4;
-				/* トラック長さ(4byte) */
-				if (fwrite (&lTrackLen4, sizeof (long), 1, pFile) < 1) {
-					free (pTrackData);
-					fclose (pFile);
-					return 0;
-				}
-				/* トラックデータ(lTrackLenbyte) */
-				if (fwrite (pTrackData, 1, lTrackLen, pFile) < (unsigned long)lTrackLen) {
-					free (pTrackData);
-					fclose (pFile);
-					return 0;
-				}
-				lTrackIndex++;
-				/* システムセットアップ専用トラックがない場合 */
-				if (lHasSystemSetupTrack == 0) {
-					/* トラック0からシステムセットアップを生成し追加トラックとして保存 */
-					lTempTrackAddress[lTrackIndex] = ftell (pFile);
-					lGuessTrackLen = MIDITrack_GuessTrackDataLenAsCherry (pMIDITrack);
-					pTrackData = malloc (lGuessTrackLen);
-					if (pTrackData == NULL) {
-						fclose (pFile);
-						return 0;
-					}
-					memset (pTrackData, 0, lGuessTrackLen);
-					lTrackLen = MIDITrack_SaveAsCherry1 (pMIDITrack, pTrackData, lGuessTrackLen);
-					assert (124 <= lTrackLen && lTrackLen < lGuessTrackLen);
-					lTrackLen4 = lTrackLen + 4;
-					/* トラック長さ(4byte) */
-					if (fwrite (&lTrackLen4, sizeof (long), 1, pFile) < 1) {
-						free (pTrackData);
-						fclose (pFile);
-						return 0;
-					}
-					/* トラックデータ(lTrackLenbyte) */
-					if (fwrite (pTrackData, 1, lTrackLen, pFile) < (unsigned long)lTrackLen) {
-						free (pTrackData);
-						fclose (pFile);
-						return 0;
-					}
-					free (pTrackData);
-					pTrackData = NULL;
-					lTrackIndex++;
-				}
-			}
-			/* トラック1以降(システムセットアップトラック又は通常トラック) */
-			else {
-				lTempTrackAddress[lTrackIndex] = ftell (pFile);
-				lGuessTrackLen = MIDITrack_GuessTrackDataLenAsCherry (pMIDITrack);
-				pTrackData = malloc (lGuessTrackLen);
-				if (pTrackData == NULL) {
-					fclose (pFile);
-					return 0;
-				}
-				memset (pTrackData, 0, lGuessTrackLen);
-				lTrackLen = MIDITrack_SaveAsCherry2 (pMIDITrack, pTrackData, lGuessTrackLen);
-				assert (124 <= lTrackLen && lTrackLen < lGuessTrackLen);
-				lTrackLen4 = lTrackLen + 4;
-				/* トラック長さ(4byte) */
-				if (fwrite (&lTrackLen4, sizeof (long), 1, pFile) < 1) {
-					free (pTrackData);
-					fclose (pFile);
-					return 0;
-				}
-				/* トラックデータ(lTrackLenbyte) */
-				if (fwrite (pTrackData, 1, lTrackLen, pFile) < (unsigned long)lTrackLen) {
-					free (pTrackData);
-					fclose (pFile);
-					return 0;
-				}
-				free (pTrackData);
-				pTrackData = NULL;
-				lTrackIndex++;
-			}
-		}
-	}
-
-	/* 拡張データ */
-	/* 拍子調性 */
-	if (pMIDIData->m_pFirstTrack) {
-		pMIDITrack = pMIDIData->m_pFirstTrack;
-		lTempExtendedDataAddress[0] = ftell (pFile);
-		lGuessTrackLen = MIDITrack_GuessTrackDataLenAsCherry (pMIDITrack);
-		pTrackData = malloc (lGuessTrackLen);
-		if (pTrackData == NULL) {
-			fclose (pFile);
-			return 0;
-		}
-		memset (pTrackData, 0, lGuessTrackLen);
-		lTrackLen = MIDITrack_SaveAsCherry3 (pMIDITrack, pTrackData, lGuessTrackLen);
-		assert (0 <= lTrackLen && lTrackLen < lGuessTrackLen);
-		/* 拍子調性データの長さ(4byte) */
-		if (fwrite (&lTrackLen, sizeof (long), 1, pFile) < 1) {
-			free (pTrackData);
-			fclose (pFile);
-			return 0;
-		}
-		/* 拍子調性データ(lTrackLenbyte) */
-		if (fwrite (pTrackData, 1, lTrackLen, pFile) < (unsigned long)lTrackLen) {
-			free (pTrackData);
-			fclose (pFile);
-			return 0;
-		}
-		free (pTrackData);
-		pTrackData = NULL;
-	}
-
-	/* 拡張データ先頭アドレスの書き込み */
-	fseek (pFile, 512, SEEK_SET);
-	if (fwrite (lTempExtendedDataAddress, sizeof (long), 64, pFile) < 64) {
-		fclose (pFile);
-		return 0;
-	}
-
-	/* トラック先頭アドレスの再書き込み */
-	fseek (pFile, 768, SEEK_SET);
-	if (fwrite (lTempTrackAddress, sizeof (long), usNumTrack, pFile) < usNumTrack) {
-		fclose (pFile);
-		return 0;
-	}
-
-	free (pTrackData);
-	pTrackData = NULL;
-
-	fclose (pFile);
-	pFile = NULL;
-
-	forEachTrack (pMIDIData, pMIDITrack) {
-		pMIDITrack->m_lInputOn = 1;
-		pMIDITrack->m_lInputPort = pMIDITrack->m_lOutputPort;
-		pMIDITrack->m_lInputChannel = pMIDITrack->m_lOutputChannel;
-		pMIDITrack->m_lOutputOn = 1;
-	}
-
-	return 1;
+	return MIDIDataStream_DetachMemory (&theStream, ppData, pLen);
 }
 
 
@@ -13067,569 +14037,328 @@ static char* strncpy_ex02 (char* pText1, char* pText2, size_t lLen1, size_t lLen
 		else {
 			break;
 		}
-	}
-	return pText1;
-}
-
-/* MIDIデータをMIDICSVファイル(*.csv)から読み込み(ANSI) */
-/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
-MIDIData* __stdcall MIDIData_LoadFromMIDICSVA (const char* pszFileName) {
-	FILE* pFile = NULL;
-	errno_t nErrorNo = 0;
-	char szTextLine[2048];
-	long lTextLineLen = 0;
-	MIDIData* pMIDIData = NULL;
-	MIDITrack* pMIDITrack = NULL;
-	long lFormat = 0;
-	long lNumTrack = 1;
-	long lTimeBase = 1;
-
-	/* ファイルを開く */
-	nErrorNo = fopen_s (&pFile, pszFileName, "rb"); /* 20120108 単体の\nを扱うためrtをrbに変更 */
-	if (pFile == NULL) {
-		return NULL;
-	}
-
-	/* ファイル終端まで1行ずつ読み込む */
-	while (!feof (pFile)) {
-		char* pTrackIndex = NULL;
-		char* pTime = NULL;
-		char* pEventKind = NULL;
-		long lTrackIndex = 0;
-		long lTime = 0;
-		long lKind = 0;
-		/* 1行読み取り */
-		memset (szTextLine, 0, sizeof (szTextLine));
-		fgets (szTextLine, sizeof (szTextLine) - 1, pFile);
-		/* コメント行の読み飛ばし */
-		if (szTextLine[0] == '#' || szTextLine[0] == ';') {
-			continue;
-		}
-		/* 改行コードの除去(20120108追加) */
-		lTextLineLen = size_ttolong (strlen (szTextLine));
-		if (lTextLineLen > 2 &&
-			*(szTextLine + lTextLineLen - 2) == '\r' &&
-			*(szTextLine + lTextLineLen - 1) == '\n') {
-			*(szTextLine + lTextLineLen - 2) = '\0';
-			*(szTextLine + lTextLineLen - 1) = '\0';
-		}
-		else if (lTextLineLen > 1 &&
-			*(szTextLine + lTextLineLen - 1) == '\r') {
-			*(szTextLine + lTextLineLen - 1) = '\0';
-		}
-		else if (lTextLineLen > 1 &&
-			*(szTextLine + lTextLineLen - 1) == '\n') {
-			*(szTextLine + lTextLineLen - 1) = '\0';
-		}
-		/* トラック番号、タイム、イベントの種類の読み取り */
-		pTrackIndex = szTextLine;
-		pTime = getnexttoken_01 (pTrackIndex);
-		pEventKind = getnexttoken_01 (pTime);
-		lTrackIndex = atol (szTextLine);
-		lTime = atol (pTime);
-
-		/* MIDIデータヘッダ情報行 */
-		if (lTrackIndex == 0 && lTime == 0 && _strnicmp (pEventKind, "Header", 6) == 0) {
-			long lTimeMode = MIDIDATA_TPQNBASE;
-			long lTimeResolution = 120;
-			char* pFormat = getnexttoken_01 (pEventKind);
-			char* pNumTrack = getnexttoken_01 (pFormat);
-			char* pTimeBase = getnexttoken_01 (pNumTrack);
-			lFormat = atol (pFormat);
-			lNumTrack = atol (pNumTrack);
-			lTimeBase = atol (pTimeBase);
-			if (lFormat < 0 || lFormat > 2) {
-				fclose (pFile);
-				return NULL;
-			}
-			if (lNumTrack < 1 || lNumTrack >= 65536) {
-				fclose (pFile);
-				return NULL;
-			}
-			if (lTimeBase < 1 || lTimeBase >= 65536) {
-				fclose (pFile);
-				return NULL;
-			}
-			if (lTimeBase & 0x8000) {
-				lTimeMode = (256 - ((lTimeBase & 0xFF00) >> 8));
-				if (lTimeMode != MIDIDATA_SMPTE24BASE &&
-					lTimeMode != MIDIDATA_SMPTE25BASE &&
-					lTimeMode != MIDIDATA_SMPTE29BASE &&
-					lTimeMode != MIDIDATA_SMPTE30BASE) {
-					fclose (pFile);
-					return NULL;
-				}
-				lTimeResolution = lTimeBase & 0xFF;
-			}
-			else {
-				lTimeMode = MIDIDATA_TPQNBASE;
-				lTimeResolution = lTimeBase & 0x7FFF;
-			}
-			/* 二重にMIDIデータを作ろうとした場合、直ちに読み込み中断 */
-			if (pMIDIData != NULL) {
-				break;
-			}
-			/* MIDIデータの作成(SMPTEベースはサポートしない) */
-			pMIDIData = MIDIData_Create (lFormat, lNumTrack, lTimeMode, lTimeResolution);
-			if (pMIDIData == NULL) {
-				return NULL;
-			}
-		}
-
-		/* スタートオブトラック */
-		if (lTime == 0 && _strnicmp (pEventKind, "Start_track", 11) == 0) {
-			/* 二重にMIDIデータを作ろうとした場合、直ちに読み込み中断 */
-			if (pMIDITrack != NULL) {
-				break;
-			}
-			/* このセクションのMIDIトラックの取得 */
-			if (pMIDIData && 1 <= lTrackIndex && lTrackIndex <= lNumTrack) {
-				pMIDITrack = MIDIData_GetTrack (pMIDIData, lTrackIndex - 1);
-			}
-		}
-
-		/* エンドオブトラック */
-		if (_strnicmp (pEventKind, "End_track", 9) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				MIDITrack_InsertEndofTrack (pMIDITrack, lTime);
-			}
-			pMIDITrack = NULL;
-		}
-
-		/* シーケンス番号 */
-		if (_strnicmp (pEventKind, "Sequence_number", 15) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pNumber = getnexttoken_01 (pEventKind);
-				long lNumber = CLIP (0, atol (pNumber), 65535);
-				MIDITrack_InsertSequenceNumber (pMIDITrack, lTime, lNumber);
-			}
-		}
-
-		/* テキスト */
-		if (_strnicmp (pEventKind, "Text_t", 6) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pText = getnexttoken_01 (pEventKind);
-				char szText[1024];
-				memset (szText, 0, sizeof (szText));
-				strncpy_ex02 (szText, pText, sizeof (szText) - 1, strlen (pText));
-				MIDITrack_InsertTextEventA (pMIDITrack, lTime, szText);
-			}
-		}
-		
-		/* 著作権 */
-		if (_strnicmp (pEventKind, "Copyright_t", 11) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pText = getnexttoken_01 (pEventKind);
-				char szText[1024];
-				memset (szText, 0, sizeof (szText));
-				strncpy_ex02 (szText, pText, sizeof (szText) - 1, strlen (pText));
-				MIDITrack_InsertCopyrightNoticeA (pMIDITrack, lTime, szText);
-			}
-		}
-
-		/* トラック名／シーケンス名 */
-		if (_strnicmp (pEventKind, "Title_t", 7) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pText = getnexttoken_01 (pEventKind);
-				char szText[1024];
-				memset (szText, 0, sizeof (szText));
-				strncpy_ex02 (szText, pText, sizeof (szText) - 1, strlen (pText));
-				MIDITrack_InsertTrackNameA (pMIDITrack, lTime, szText);
-			}
-		}
-
-		/* インストゥルメント名 */
-		if (_strnicmp (pEventKind, "Instrument_name_t", 17) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pText = getnexttoken_01 (pEventKind);
-				char szText[1024];
-				memset (szText, 0, sizeof (szText));
-				strncpy_ex02 (szText, pText, sizeof (szText) - 1, strlen (pText));
-				MIDITrack_InsertInstrumentNameA (pMIDITrack, lTime, szText);
-			}
-		}
-
-		/* 歌詞 */
-		if (_strnicmp (pEventKind, "Lyric_t", 7) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pText = getnexttoken_01 (pEventKind);
-				char szText[1024];
-				memset (szText, 0, sizeof (szText));
-				strncpy_ex02 (szText, pText, sizeof (szText) - 1, strlen (pText));
-				MIDITrack_InsertLyricA (pMIDITrack, lTime, szText);
-			}
-		}
-
-		/* マーカー */
-		if (_strnicmp (pEventKind, "Marker_t", 8) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pText = getnexttoken_01 (pEventKind);
-				char szText[1024];
-				memset (szText, 0, sizeof (szText));
-				strncpy_ex02 (szText, pText, sizeof (szText) - 1, strlen (pText));
-				MIDITrack_InsertMarkerA (pMIDITrack, lTime, szText);
-			}
-		}
-
-		/* キューポイント */
-		if (_strnicmp (pEventKind, "Cue_point_t", 11) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pText = getnexttoken_01 (pEventKind);
-				char szText[1024];
-				memset (szText, 0, sizeof (szText));
-				strncpy_ex02 (szText, pText, sizeof (szText) - 1, strlen (pText));
-				MIDITrack_InsertCuePointA (pMIDITrack, lTime, szText);
-			}
-		}
-
-		/* プログラム名(処理なし) */
-
-		/* デバイス名(処理なし) */
-
-		/* ポートプリフィックス */
-		if (_strnicmp (pEventKind, "MIDI_port", 9) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pNumber = getnexttoken_01 (pEventKind);
-				long lNumber = CLIP (0, atol (pNumber), 255);
-				MIDITrack_InsertPortPrefix (pMIDITrack, lTime, lNumber);
-			}
-		}
-
-		/* チャンネルプリフィックス */
-		if (_strnicmp (pEventKind, "Channel_prefix", 14) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pNumber = getnexttoken_01 (pEventKind);
-				long lNumber = CLIP (0, atol (pNumber), 15);
-				MIDITrack_InsertChannelPrefix (pMIDITrack, lTime, lNumber);
-			}
-		}
-
-
-		/* テンポ */
-		if (_strnicmp (pEventKind, "Tempo", 5) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pTempo = getnexttoken_01 (pEventKind);
-				long lTempo = CLIP (1, atol (pTempo), 60000000);
-				MIDITrack_InsertTempo (pMIDITrack, lTime, lTempo);
-			}
-		}
-
-		/* SMPTEオフセット */
-		if (_strnicmp (pEventKind, "SMPTE_offset", 12) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pHour = getnexttoken_01 (pEventKind);
-				char* pMinute = getnexttoken_01 (pHour);
-				char* pSecond = getnexttoken_01 (pMinute);
-				char* pFrame = getnexttoken_01 (pSecond);
-				char* pSubFrame = getnexttoken_01 (pFrame);
-				long lRate = CLIP (0, (atol (pHour) & 0x60) >> 5, 3);
-				long lHour = CLIP (0, atol (pHour) & 0x1F, 23);
-				long lMinute = CLIP (0, atol (pMinute), 59);
-				long lSecond = CLIP (0, atol (pSecond), 59);
-				long lFrame = CLIP (0, atol (pFrame), 29);
-				long lSubFrame = CLIP (0, atol (pSubFrame), 99);
-				MIDITrack_InsertSMPTEOffset (pMIDITrack, lTime, lRate, lHour, lMinute, lSecond, lFrame, lSubFrame);
-			}
-		}
-
-		/* 拍子記号 */
-		if (_strnicmp (pEventKind, "Time_signature", 14) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pN = getnexttoken_01 (pEventKind);
-				char* pD = getnexttoken_01 (pN);
-				char* pC = getnexttoken_01 (pD);
-				char* pB = getnexttoken_01 (pC);
-				long lN = CLIP (1, atol (pN), 127);
-				long lD = CLIP (1, atol (pD), 8);
-				long lC = CLIP (1, atol (pC), 127); /* 常に24が正解 */
-				long lB = CLIP (1, atol (pB), 127); /* 常に8が正解 */
-				MIDITrack_InsertTimeSignature (pMIDITrack, lTime, lN, lD, lC, lB);
-			}
-		}
-
-		/* 調性記号 */
-		if (_strnicmp (pEventKind, "Key_signature", 13) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pTone = getnexttoken_01 (pEventKind);
-				char* pMinor = getnexttoken_01 (pTone);
-				long lTone = CLIP (-7, atol (pTone), 7);
-				long lMinor = _strnicmp (pMinor, "\"minor\"", 7) == 0 ? 1 : 0;
-				MIDITrack_InsertKeySignature (pMIDITrack, lTime, lTone, lMinor);
-			}
-		}
-
-		/* シーケンサー独自のイベント */
-		if (_strnicmp (pEventKind, "Sequencer_specific", 18) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				long k = 0;
-				unsigned char ucData[1024];
-				char* pLen = getnexttoken_01 (pEventKind);
-				char* pData = getnexttoken_01 (pLen);
-				long lLen = CLIP (0, atol (pLen), sizeof (ucData));
-				memset (ucData, 0, sizeof (ucData));
-				while (*pData != '\r' && *pData != '\n' && *pData != '\0' && k < lLen) { 
-					ucData[k++] = (unsigned char)atoi (pData);
-					pData = getnexttoken_01 (pData);
-				}
-				MIDITrack_InsertSequencerSpecific (pMIDITrack, lTime, ucData, lLen);
-			}
-		}
-
-		/* 未定義のメタイベント */
-		if (_strnicmp (pEventKind, "Unknown_meta_event", 18) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				long k = 0;
-				unsigned char ucData[1024];
-				char* pKind = getnexttoken_01 (pEventKind);
-				char* pLen = getnexttoken_01 (pKind);
-				char* pData = getnexttoken_01 (pLen);
-				long lKind = atol (pKind);
-				if (0x00 <= lKind && lKind <= 0x7F) {
-					MIDIEvent* pMIDIEvent = NULL;
-					long lLen = CLIP (0, atol (pLen), sizeof (ucData));
-					memset (ucData, 0, sizeof (ucData));
-					while (*pData != '\r' && *pData != '\n' && *pData != '\0' && k < lLen) { 
-						ucData[k++] = (unsigned char)atoi (pData);
-						pData = getnexttoken_01 (pData);
-					}
-					pMIDIEvent = MIDIEvent_Create (lTime, lKind, ucData, lLen);
-					if (pMIDIEvent) {
-						MIDITrack_InsertEvent (pMIDITrack, pMIDIEvent);
-					}
-				}
-			}
-		}
-
-		/* ノートオフ */
-		if (_strnicmp (pEventKind, "Note_off_c", 10) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pChannel = getnexttoken_01 (pEventKind);
-				char* pKey = getnexttoken_01 (pChannel);
-				char* pVelocity = getnexttoken_01 (pKey);
-				long lChannel = CLIP (0, atol (pChannel), 15);
-				long lKey = CLIP (0, atol (pKey), 127);
-				long lVelocity = CLIP (0, atol (pVelocity), 127);
-				MIDITrack_InsertNoteOff (pMIDITrack, lTime, lChannel, lKey, lVelocity);
-			}
-		}
+	}
+	return pText1;
+}
 
-		/* ノートオン */
-		if (_strnicmp (pEventKind, "Note_on_c", 9) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pChannel = getnexttoken_01 (pEventKind);
-				char* pKey = getnexttoken_01 (pChannel);
-				char* pVelocity = getnexttoken_01 (pKey);
-				long lChannel = CLIP (0, atol (pChannel), 15);
-				long lKey = CLIP (0, atol (pKey), 127);
-				long lVelocity = CLIP (0, atol (pVelocity), 127);
-				MIDITrack_InsertNoteOn (pMIDITrack, lTime, lChannel, lKey, lVelocity);
-			}
+/* MIDICSVの行読み取り器(非公開)(20261019追加) */
+/* 読み込み先から大きなブロック単位で読み込み、バッファ上の各行をその場で切り出す。 */
+/* 1行の長さに上限はない(1行がバッファに収まらない場合はバッファを拡張する)。 */
+typedef struct tagMIDICSVLineReader {
+	MIDIDataStream* m_pStream;          /* 読み込み先 */
+	char* m_pBuf;                       /* バッファ */
+	long m_lSize;                       /* バッファの確保した長さ[バイト] */
+	long m_lLen;                        /* バッファ上のデータの長さ[バイト] */
+	long m_lPos;                        /* 次の行の先頭位置[バイト] */
+	long m_bEOF;                        /* 読み込み先の終端に達した */
+	long m_bError;                      /* メモリ不足により読み込みを中断した */
+} MIDICSVLineReader;
+
+#define MIDICSVLINEREADER_BLOCKSIZE 1048576
+
+/* 次の1行を取得する(非公開)(20261019追加) */
+/* 行末の改行コード(\n,\r\n)は除去して'\0'で終端する。バッファ上の行はそのまま書き換えてよい。 */
+/* 戻り値：行の先頭へのポインタ。ファイル終端又はメモリ不足の場合NULL(メモリ不足の場合は */
+/* m_bErrorを1にするので、ファイル終端と区別すること)。 */
+static char* MIDICSVLineReader_GetLine (MIDICSVLineReader* pReader) {
+	char* pLine = NULL;
+	char* pLineEnd = NULL;
+	long lRest = 0;
+	size_t lReadLen = 0;
+	while (1) {
+		lRest = pReader->m_lLen - pReader->m_lPos;
+		pLine = pReader->m_pBuf + pReader->m_lPos;
+		pLineEnd = lRest > 0 ? memchr (pLine, '\n', lRest) : NULL;
+		/* 改行が見つかった、又は終端に達していて最後の行が残っている */
+		if (pLineEnd == NULL && pReader->m_bEOF && lRest > 0) {
+			pLineEnd = pReader->m_pBuf + pReader->m_lLen;
+		}
+		if (pLineEnd) {
+			pReader->m_lPos = (long)(pLineEnd - pReader->m_pBuf) + 1;
+			*pLineEnd = '\0';
+			if (pLineEnd > pLine && *(pLineEnd - 1) == '\r') {
+				*(pLineEnd - 1) = '\0';
+			}
+			return pLine;
+		}
+		if (pReader->m_bEOF) {
+			return NULL;
 		}
-
-		/* キーアフタータッチ */
-		if (_strnicmp (pEventKind, "Poly_aftertouch_c", 17) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pChannel = getnexttoken_01 (pEventKind);
-				char* pKey = getnexttoken_01 (pChannel);
-				char* pValue = getnexttoken_01 (pKey);
-				long lChannel = CLIP (0, atol (pChannel), 15);
-				long lKey = CLIP (0, atol (pKey), 127);
-				long lValue = CLIP (0, atol (pValue), 127);
-				MIDITrack_InsertKeyAftertouch (pMIDITrack, lTime, lChannel, lKey, lValue);
+		/* 読み残しをバッファの先頭に寄せ、足りなければバッファを拡張する */
+		if (pReader->m_lPos > 0) {
+			memmove (pReader->m_pBuf, pLine, lRest);
+			pReader->m_lLen = lRest;
+			pReader->m_lPos = 0;
+		}
+		if (pReader->m_lSize - pReader->m_lLen < MIDICSVLINEREADER_BLOCKSIZE + 1) {
+			long lNewSize = pReader->m_lSize == 0 ?
+				MIDICSVLINEREADER_BLOCKSIZE + 1 : pReader->m_lSize * 2;
+			char* pNewBuf = NULL;
+			if (pReader->m_lSize > (LONG_MAX - 1) / 2) {
+				pReader->m_bError = 1;
+				return NULL;
 			}
-		}
-
-		/* コントロールチェンジ */
-		if (_strnicmp (pEventKind, "Control_c", 9) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pChannel = getnexttoken_01 (pEventKind);
-				char* pNumber = getnexttoken_01 (pChannel);
-				char* pValue = getnexttoken_01 (pNumber);
-				long lChannel = CLIP (0, atol (pChannel), 15);
-				long lNumber = CLIP (0, atol (pNumber), 127);
-				long lValue = CLIP (0, atol (pValue), 127);
-				MIDITrack_InsertControlChange (pMIDITrack, lTime, lChannel, lNumber, lValue);
+			pNewBuf = realloc (pReader->m_pBuf, lNewSize);
+			if (pNewBuf == NULL) {
+				pReader->m_bError = 1;
+				return NULL;
 			}
+			pReader->m_pBuf = pNewBuf;
+			pReader->m_lSize = lNewSize;
 		}
-
-		/* プログラムチェンジ */
-		if (_strnicmp (pEventKind, "Program_c", 9) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pChannel = getnexttoken_01 (pEventKind);
-				char* pNumber = getnexttoken_01 (pChannel);
-				long lChannel = CLIP (0, atol (pChannel), 15);
-				long lNumber = CLIP (0, atol (pNumber), 127);
-				MIDITrack_InsertProgramChange (pMIDITrack, lTime, lChannel, lNumber);
-			}
+		/* 最後の1バイトは終端の'\0'のために空けておく */
+		lReadLen = MIDIDataStream_Read (pReader->m_pBuf + pReader->m_lLen, 1,
+			pReader->m_lSize - pReader->m_lLen - 1, pReader->m_pStream);
+		pReader->m_lLen += (long)lReadLen;
+		if (lReadLen == 0) {
+			pReader->m_bEOF = 1;
 		}
+	}
+}
 
-		/* チャンネルアフタータッチ */
-		if (_strnicmp (pEventKind, "Channel_aftertouch_c", 20) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pChannel = getnexttoken_01 (pEventKind);
-				char* pValue = getnexttoken_01 (pChannel);
-				long lChannel = CLIP (0, atol (pChannel), 15);
-				long lValue = CLIP (0, atol (pValue), 127);
-				MIDITrack_InsertChannelAftertouch (pMIDITrack, lTime, lChannel, lValue);
-			}
-		}
+/* MIDICSVのトラック追加器(非公開)(20261019追加) */
+/* 追加先のトラックと、そのトラック内の種類別の最後のイベントを保持する。 */
+typedef struct tagMIDICSVTrackWriter {
+	MIDITrack* m_pTrack;                /* 追加先のトラック(なければNULL) */
+	MIDIEvent* m_pLastSameKindEvent[256]; /* 種類別の最後のイベント */
+} MIDICSVTrackWriter;
 
-		/* ピッチベンド */
-		if (_strnicmp (pEventKind, "Pitch_bend_c", 12) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pChannel = getnexttoken_01 (pEventKind);
-				char* pValue = getnexttoken_01 (pChannel);
-				long lChannel = CLIP (0, atol (pChannel), 15);
-				long lValue = CLIP (0, atol (pValue), 16363);
-				MIDITrack_InsertPitchBend (pMIDITrack, lTime, lChannel, lValue);
-			}
+/* 追加先のトラックを設定する(非公開)(20261019追加) */
+static void MIDICSVTrackWriter_SetTrack (MIDICSVTrackWriter* pWriter, MIDITrack* pTrack) {
+	MIDIEvent* pEvent = NULL;
+	pWriter->m_pTrack = pTrack;
+	memset (pWriter->m_pLastSameKindEvent, 0, sizeof (pWriter->m_pLastSameKindEvent));
+	/* 既にイベントがある場合(同じトラックが2回現れた場合)は種類別の最後のイベントを求めておく */
+	if (pTrack) {
+		forEachEvent (pTrack, pEvent) {
+			pWriter->m_pLastSameKindEvent[pEvent->m_lKind & 0xFF] = pEvent;
 		}
+	}
+}
 
-		/* システムエクスクルーシヴ */
-		if (_strnicmp (pEventKind, "System_exclusive", 16) == 0 &&
-			_strnicmp (pEventKind, "System_exclusive_packet", 23) != 0) {
-			if (pMIDIData && pMIDITrack) {
-				long k = 1;
-				unsigned char ucData[1024];
-				char* pLen = getnexttoken_01 (pEventKind);
-				char* pData = getnexttoken_01 (pLen);
-				long lLen = CLIP (0, atol (pLen), sizeof (ucData));
-				memset (ucData, 0, sizeof (ucData));
-				ucData[0] = 0xF0;
-				while (*pData != '\r' && *pData != '\n' && *pData != '\0' && k < lLen + 1) { 
-					ucData[k++] = (unsigned char)atoi (pData);
-					pData = getnexttoken_01 (pData);
-				}
-				MIDITrack_InsertSysExEvent (pMIDITrack, lTime, ucData, lLen + 1);
-			}
+/* イベントをトラックに挿入する(非公開)(20261019追加) */
+/* 挿入位置はMIDITrack_InsertEventと同じであるが、末尾に挿入する場合は */
+/* 挿入位置及び同種イベントの探索を省き、定数時間で追加する。 */
+/* 挿入できなかった場合、pEventは削除する。戻り値：正常終了=1、異常終了=0。 */
+static long MIDICSVTrackWriter_AddEvent (MIDICSVTrackWriter* pWriter, MIDIEvent* pEvent) {
+	MIDITrack* pTrack = pWriter->m_pTrack;
+	MIDIEvent* pLastEvent = pTrack->m_pLastEvent;
+	long lKind = pEvent->m_lKind & 0xFF;
+	long bAppend = 0;
+	long lRet = 0;
+	/* 末尾に挿入してよいか(MIDITrack_InsertEventの後方からの探索が最初の1回で終わる場合) */
+	if (pEvent->m_lKind != MIDIEVENT_ENDOFTRACK) {
+		if (pLastEvent == NULL) {
+			bAppend = 1;
 		}
-
-		/* システムエクスクルーシヴ(続き) */
-		if (_strnicmp (pEventKind, "System_exclusive_packet", 23) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				long k = 0;
-				unsigned char ucData[1024];
-				char* pLen = getnexttoken_01 (pEventKind);
-				char* pData = getnexttoken_01 (pLen);
-				long lLen = CLIP (0, atol (pLen), sizeof (ucData));
-				memset (ucData, 0, sizeof (ucData));
-				while (*pData != '\r' && *pData != '\n' && *pData != '\0' && k < lLen) { 
-					ucData[k++] = (unsigned char)atoi (pData);
-					pData = getnexttoken_01 (pData);
-				}
-				MIDITrack_InsertSysExEvent (pMIDITrack, lTime, ucData, lLen);
-			}
+		else if (pLastEvent->m_lKind == MIDIEVENT_ENDOFTRACK) {
+			bAppend = 0;
+		}
+		else if (pLastEvent->m_lTime < pEvent->m_lTime) {
+			bAppend = 1;
+		}
+		/* 同時刻の場合、ノートオフは同時刻のノートオフ以外のイベントより前に挿入される */
+		else if (pLastEvent->m_lTime == pEvent->m_lTime) {
+			bAppend = !MIDIEvent_IsNoteOff (pEvent) || MIDIEvent_IsNoteOff (pLastEvent);
 		}
 	}
+	if (bAppend) {
+		lRet = MIDITrack_AppendSingleEventForce
+			(pTrack, pEvent, pWriter->m_pLastSameKindEvent[lKind]);
+	}
+	else {
+		lRet = MIDITrack_InsertEvent (pTrack, pEvent);
+	}
+	if (lRet == 0) {
+		MIDIEvent_Delete (pEvent);
+		return 0;
+	}
+	if (pEvent->m_pNextSameKindEvent == NULL) {
+		pWriter->m_pLastSameKindEvent[lKind] = pEvent;
+	}
+	return 1;
+}
 
-	/* ファイルを閉じる */
-	fclose (pFile);
-
-	/* エンドオブトラックを付け忘れているトラックは自動的に付加する */
-	if (pMIDIData) {
-		forEachTrack (pMIDIData, pMIDITrack) {
-			MIDIEvent* pLastEvent = MIDITrack_GetLastEvent (pMIDITrack);
-			if (!MIDIEvent_IsEndofTrack (pLastEvent)) {
-				MIDITrack_InsertEndofTrack (pMIDITrack, pLastEvent->m_lTime);
-			}
+/* テキストベースのイベントを生成してトラックに挿入する(非公開)(20261019追加) */
+/* MIDITrack_InsertTextBasedEventExAと同様に、文字コードは直近の同種イベントに基づく。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+static long MIDICSVTrackWriter_AddTextEvent
+(MIDICSVTrackWriter* pWriter, long lTime, long lKind, const char* pszText) {
+	MIDIEvent* pEvent = MIDIEvent_CreateTextBasedEventExA (lTime, lKind, MIDIEVENT_NOCHARCODE, "");
+	if (pEvent == NULL) {
+		return 0;
+	}
+	if (MIDICSVTrackWriter_AddEvent (pWriter, pEvent) == 0) {
+		return 0;
+	}
+	if (MIDIEvent_SetTextA (pEvent, pszText) == 0) {
+		if (pWriter->m_pLastSameKindEvent[lKind & 0xFF] == pEvent) {
+			pWriter->m_pLastSameKindEvent[lKind & 0xFF] = pEvent->m_pPrevSameKindEvent;
 		}
+		MIDITrack_RemoveEvent (pWriter->m_pTrack, pEvent);
+		MIDIEvent_Delete (pEvent);
+		return 0;
 	}
+	return 1;
+}
 
-	/* 各トラックの出力ポート番号・出力チャンネル・表示モードの自動設定 */
-	MIDIData_UpdateOutputPort (pMIDIData);
-	MIDIData_UpdateOutputChannel (pMIDIData);
-	MIDIData_UpdateViewMode (pMIDIData);
+/* MIDICSVのイベントの種類 */
+#define MIDICSV_UNKNOWN                0
+#define MIDICSV_HEADER                 1
+#define MIDICSV_STARTTRACK             2
+#define MIDICSV_ENDTRACK               3
+#define MIDICSV_SEQUENCENUMBER         4
+#define MIDICSV_TEXTEVENT              5
+#define MIDICSV_COPYRIGHTNOTICE        6
+#define MIDICSV_TRACKNAME              7
+#define MIDICSV_INSTRUMENTNAME         8
+#define MIDICSV_LYRIC                  9
+#define MIDICSV_MARKER                 10
+#define MIDICSV_CUEPOINT               11
+#define MIDICSV_PORTPREFIX             12
+#define MIDICSV_CHANNELPREFIX          13
+#define MIDICSV_TEMPO                  14
+#define MIDICSV_SMPTEOFFSET            15
+#define MIDICSV_TIMESIGNATURE          16
+#define MIDICSV_KEYSIGNATURE           17
+#define MIDICSV_SEQUENCERSPECIFIC      18
+#define MIDICSV_UNKNOWNMETAEVENT       19
+#define MIDICSV_NOTEOFF                20
+#define MIDICSV_NOTEON                 21
+#define MIDICSV_KEYAFTERTOUCH          22
+#define MIDICSV_CONTROLCHANGE          23
+#define MIDICSV_PROGRAMCHANGE          24
+#define MIDICSV_CHANNELAFTERTOUCH      25
+#define MIDICSV_PITCHBEND              26
+#define MIDICSV_SYSEXEVENT             27
+#define MIDICSV_SYSEXPACKET            28
+
+/* MIDICSVのイベントの種類名の表(非公開)(20261019追加) */
+/* 種類名は前方一致・大文字小文字の区別なしで照合する。 */
+/* "System_exclusive_packet"は"System_exclusive"より先に照合すること。 */
+static const struct {
+	const char* m_pszName;
+	long m_lLen;
+	long m_lKind;
+} g_theMIDICSVKindTable[] = {
+	{"Note_on_c", 9, MIDICSV_NOTEON},
+	{"Note_off_c", 10, MIDICSV_NOTEOFF},
+	{"Control_c", 9, MIDICSV_CONTROLCHANGE},
+	{"Pitch_bend_c", 12, MIDICSV_PITCHBEND},
+	{"Program_c", 9, MIDICSV_PROGRAMCHANGE},
+	{"Poly_aftertouch_c", 17, MIDICSV_KEYAFTERTOUCH},
+	{"Channel_aftertouch_c", 20, MIDICSV_CHANNELAFTERTOUCH},
+	{"Header", 6, MIDICSV_HEADER},
+	{"Start_track", 11, MIDICSV_STARTTRACK},
+	{"End_track", 9, MIDICSV_ENDTRACK},
+	{"Sequence_number", 15, MIDICSV_SEQUENCENUMBER},
+	{"Text_t", 6, MIDICSV_TEXTEVENT},
+	{"Copyright_t", 11, MIDICSV_COPYRIGHTNOTICE},
+	{"Title_t", 7, MIDICSV_TRACKNAME},
+	{"Instrument_name_t", 17, MIDICSV_INSTRUMENTNAME},
+	{"Lyric_t", 7, MIDICSV_LYRIC},
+	{"Marker_t", 8, MIDICSV_MARKER},
+	{"Cue_point_t", 11, MIDICSV_CUEPOINT},
+	{"MIDI_port", 9, MIDICSV_PORTPREFIX},
+	{"Channel_prefix", 14, MIDICSV_CHANNELPREFIX},
+	{"Tempo", 5, MIDICSV_TEMPO},
+	{"SMPTE_offset", 12, MIDICSV_SMPTEOFFSET},
+	{"Time_signature", 14, MIDICSV_TIMESIGNATURE},
+	{"Key_signature", 13, MIDICSV_KEYSIGNATURE},
+	{"Sequencer_specific", 18, MIDICSV_SEQUENCERSPECIFIC},
+	{"Unknown_meta_event", 18, MIDICSV_UNKNOWNMETAEVENT},
+	{"System_exclusive_packet", 23, MIDICSV_SYSEXPACKET},
+	{"System_exclusive", 16, MIDICSV_SYSEXEVENT},
+};
 
-	/* 各トラックの入力ポート番号・入力チャンネルの設定 */
-	forEachTrack (pMIDIData, pMIDITrack) {
-		pMIDITrack->m_lInputOn = 1;
-		pMIDITrack->m_lInputPort = pMIDITrack->m_lOutputPort;
-		pMIDITrack->m_lInputChannel = pMIDITrack->m_lOutputChannel;
-		pMIDITrack->m_lOutputOn = 1;
+/* MIDICSVのイベントの種類名からイベントの種類を求める(非公開)(20261019追加) */
+static long MIDICSV_GetKind (const char* pEventKind) {
+	long i;
+	char c = (char)(*pEventKind | 0x20);
+	for (i = 0; i < (long)(sizeof (g_theMIDICSVKindTable) / sizeof (g_theMIDICSVKindTable[0])); i++) {
+		/* 先頭の1文字で大半の候補を除外する */
+		if ((g_theMIDICSVKindTable[i].m_pszName[0] | 0x20) == c &&
+			_strnicmp (pEventKind, g_theMIDICSVKindTable[i].m_pszName,
+			g_theMIDICSVKindTable[i].m_lLen) == 0) {
+			return g_theMIDICSVKindTable[i].m_lKind;
+		}
 	}
+	return MIDICSV_UNKNOWN;
+}
 
-	return pMIDIData;
+/* MIDICSVのデータバイト列(カンマ区切りの数値)を読み取る(非公開)(20261019追加) */
+/* 戻り値：読み取ったバイト数。 */
+static long MIDICSV_GetDataBytes (char* pData, unsigned char* pBuf, long lLen) {
+	long k = 0;
+	while (*pData != '\r' && *pData != '\n' && *pData != '\0' && k < lLen) {
+		pBuf[k++] = (unsigned char)atoi (pData);
+		pData = getnexttoken_01 (pData);
+	}
+	return k;
 }
 
-/* MIDIデータをMIDICSVファイル(*.csv)から読み込み(UNICODE) */
-/* ファイル名はUNICODEで与えるがファイルの中身は仕様に基づきANSIである。 */
-/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
-MIDIData* __stdcall MIDIData_LoadFromMIDICSVW (const wchar_t* pszFileName) {
-	FILE* pFile = NULL;
-	errno_t nErrorNo = 0;
-	char szTextLine[2048];
-	long lTextLineLen = 0;
+/* MIDIデータをMIDICSVファイル(*.csv)から読み込み */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(非公開)(20261019追加) */
+/* 20261019 ブロック単位の読み込み・トラック表・末尾への定数時間追加により高速化 */
+static MIDIData* MIDIData_LoadFromMIDICSVStream (MIDIDataStream* pStream) {
+	char* pTextLine = NULL;
 	MIDIData* pMIDIData = NULL;
 	MIDITrack* pMIDITrack = NULL;
+	MIDITrack** ppTrackTable = NULL;
+	MIDICSVLineReader theReader;
+	MIDICSVTrackWriter* pWriter = NULL;
 	long lFormat = 0;
 	long lNumTrack = 1;
 	long lTimeBase = 1;
+	long lTrack = 0;
+	long bError = 0;
 
-	/* ファイルを開く */
-	nErrorNo = _wfopen_s (&pFile, pszFileName, L"rb"); /* 20120108 単体の\nを扱うためrtをrbに変更 */
-	if (pFile == NULL) {
+	memset (&theReader, 0, sizeof (theReader));
+	theReader.m_pStream = pStream;
+	pWriter = calloc (1, sizeof (MIDICSVTrackWriter));
+	if (pWriter == NULL) {
 		return NULL;
 	}
 
 	/* ファイル終端まで1行ずつ読み込む */
-	while (!feof (pFile)) {
-		char* pTrackIndex = NULL;
+	while ((pTextLine = MIDICSVLineReader_GetLine (&theReader)) != NULL) {
 		char* pTime = NULL;
 		char* pEventKind = NULL;
 		long lTrackIndex = 0;
 		long lTime = 0;
 		long lKind = 0;
-		/* 1行読み取り */
-		memset (szTextLine, 0, sizeof (szTextLine));
-		fgets (szTextLine, sizeof (szTextLine) - 1, pFile);
 		/* コメント行の読み飛ばし */
-		if (szTextLine[0] == '#' || szTextLine[0] == ';') {
+		if (pTextLine[0] == '#' || pTextLine[0] == ';') {
 			continue;
 		}
-		/* 改行コードの除去(20120108追加) */
-		lTextLineLen = size_ttolong (strlen (szTextLine));
-		if (lTextLineLen > 2 &&
-			*(szTextLine + lTextLineLen - 2) == '\r' &&
-			*(szTextLine + lTextLineLen - 1) == '\n') {
-			*(szTextLine + lTextLineLen - 2) = '\0';
-			*(szTextLine + lTextLineLen - 1) = '\0';
-		}
-		else if (lTextLineLen > 1 &&
-			*(szTextLine + lTextLineLen - 1) == '\r') {
-			*(szTextLine + lTextLineLen - 1) = '\0';
-		}
-		else if (lTextLineLen > 1 &&
-			*(szTextLine + lTextLineLen - 1) == '\n') {
-			*(szTextLine + lTextLineLen - 1) = '\0';
-		}
 		/* トラック番号、タイム、イベントの種類の読み取り */
-		pTrackIndex = szTextLine;
-		pTime = getnexttoken_01 (pTrackIndex);
+		pTime = getnexttoken_01 (pTextLine);
 		pEventKind = getnexttoken_01 (pTime);
-		lTrackIndex = atol (szTextLine);
+		lTrackIndex = atol (pTextLine);
 		lTime = atol (pTime);
+		lKind = MIDICSV_GetKind (pEventKind);
 
 		/* MIDIデータヘッダ情報行 */
-		if (lTrackIndex == 0 && lTime == 0 && _strnicmp (pEventKind, "Header", 6) == 0) {
+		if (lKind == MIDICSV_HEADER) {
 			long lTimeMode = MIDIDATA_TPQNBASE;
 			long lTimeResolution = 120;
-			char* pFormat = getnexttoken_01 (pEventKind);
-			char* pNumTrack = getnexttoken_01 (pFormat);
-			char* pTimeBase = getnexttoken_01 (pNumTrack);
+			char* pFormat = NULL;
+			char* pNumTrack = NULL;
+			char* pTimeBase = NULL;
+			if (lTrackIndex != 0 || lTime != 0) {
+				continue;
+			}
+			pFormat = getnexttoken_01 (pEventKind);
+			pNumTrack = getnexttoken_01 (pFormat);
+			pTimeBase = getnexttoken_01 (pNumTrack);
 			lFormat = atol (pFormat);
 			lNumTrack = atol (pNumTrack);
 			lTimeBase = atol (pTimeBase);
-			if (lFormat < 0 || lFormat > 2) {
-				fclose (pFile);
-				return NULL;
-			}
-			if (lNumTrack < 1 || lNumTrack >= 65536) {
-				fclose (pFile);
-				return NULL;
-			}
-			if (lTimeBase < 1 || lTimeBase >= 65536) {
-				fclose (pFile);
-				return NULL;
+			if (lFormat < 0 || lFormat > 2 ||
+				lNumTrack < 1 || lNumTrack >= 65536 ||
+				lTimeBase < 1 || lTimeBase >= 65536) {
+				bError = 1;
+				break;
 			}
 			if (lTimeBase & 0x8000) {
 				lTimeMode = (256 - ((lTimeBase & 0xFF00) >> 8));
@@ -13637,8 +14366,8 @@ MIDIData* __stdcall MIDIData_LoadFromMIDICSVW (const wchar_t* pszFileName) {
 					lTimeMode != MIDIDATA_SMPTE25BASE &&
 					lTimeMode != MIDIDATA_SMPTE29BASE &&
 					lTimeMode != MIDIDATA_SMPTE30BASE) {
-					fclose (pFile);
-					return NULL;
+					bError = 1;
+					break;
 				}
 				lTimeResolution = lTimeBase & 0xFF;
 			}
@@ -13653,114 +14382,84 @@ MIDIData* __stdcall MIDIData_LoadFromMIDICSVW (const wchar_t* pszFileName) {
 			/* MIDIデータの作成(SMPTEベースはサポートしない) */
 			pMIDIData = MIDIData_Create (lFormat, lNumTrack, lTimeMode, lTimeResolution);
 			if (pMIDIData == NULL) {
-				return NULL;
+				bError = 1;
+				break;
+			}
+			/* トラック番号からトラックを直接引けるよう、トラック表を作成 */
+			ppTrackTable = malloc (sizeof (MIDITrack*) * lNumTrack);
+			if (ppTrackTable == NULL) {
+				bError = 1;
+				break;
+			}
+			lTrack = 0;
+			forEachTrack (pMIDIData, pMIDITrack) {
+				ppTrackTable[lTrack++] = pMIDITrack;
 			}
+			pMIDITrack = NULL;
+			continue;
 		}
 
 		/* スタートオブトラック */
-		if (lTime == 0 && _strnicmp (pEventKind, "Start_track", 11) == 0) {
+		if (lKind == MIDICSV_STARTTRACK) {
+			if (lTime != 0) {
+				continue;
+			}
 			/* 二重にMIDIデータを作ろうとした場合、直ちに読み込み中断 */
 			if (pMIDITrack != NULL) {
 				break;
 			}
 			/* このセクションのMIDIトラックの取得 */
 			if (pMIDIData && 1 <= lTrackIndex && lTrackIndex <= lNumTrack) {
-				pMIDITrack = MIDIData_GetTrack (pMIDIData, lTrackIndex - 1);
-			}
-		}
-
-		/* エンドオブトラック */
-		if (_strnicmp (pEventKind, "End_track", 9) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				MIDITrack_InsertEndofTrack (pMIDITrack, lTime);
-			}
-			pMIDITrack = NULL;
-		}
-
-		/* シーケンス番号 */
-		if (_strnicmp (pEventKind, "Sequence_number", 15) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pNumber = getnexttoken_01 (pEventKind);
-				long lNumber = CLIP (0, atol (pNumber), 65535);
-				MIDITrack_InsertSequenceNumber (pMIDITrack, lTime, lNumber);
-			}
-		}
-
-		/* テキスト */
-		if (_strnicmp (pEventKind, "Text_t", 6) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pText = getnexttoken_01 (pEventKind);
-				char szText[1024];
-				memset (szText, 0, sizeof (szText));
-				strncpy_ex02 (szText, pText, sizeof (szText) - 1, strlen (pText));
-				MIDITrack_InsertTextEventA (pMIDITrack, lTime, szText);
-			}
-		}
-		
-		/* 著作権 */
-		if (_strnicmp (pEventKind, "Copyright_t", 11) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pText = getnexttoken_01 (pEventKind);
-				char szText[1024];
-				memset (szText, 0, sizeof (szText));
-				strncpy_ex02 (szText, pText, sizeof (szText) - 1, strlen (pText));
-				MIDITrack_InsertCopyrightNoticeA (pMIDITrack, lTime, szText);
+				pMIDITrack = ppTrackTable[lTrackIndex - 1];
+				MIDICSVTrackWriter_SetTrack (pWriter, pMIDITrack);
 			}
+			continue;
 		}
 
-		/* トラック名／シーケンス名 */
-		if (_strnicmp (pEventKind, "Title_t", 7) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pText = getnexttoken_01 (pEventKind);
-				char szText[1024];
-				memset (szText, 0, sizeof (szText));
-				strncpy_ex02 (szText, pText, sizeof (szText) - 1, strlen (pText));
-				MIDITrack_InsertTrackNameA (pMIDITrack, lTime, szText);
-			}
+		/* 以下はトラック内のイベント */
+		if (pMIDIData == NULL || pMIDITrack == NULL) {
+			continue;
 		}
 
-		/* インストゥルメント名 */
-		if (_strnicmp (pEventKind, "Instrument_name_t", 17) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pText = getnexttoken_01 (pEventKind);
-				char szText[1024];
-				memset (szText, 0, sizeof (szText));
-				strncpy_ex02 (szText, pText, sizeof (szText) - 1, strlen (pText));
-				MIDITrack_InsertInstrumentNameA (pMIDITrack, lTime, szText);
-			}
-		}
+		switch (lKind) {
 
-		/* 歌詞 */
-		if (_strnicmp (pEventKind, "Lyric_t", 7) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pText = getnexttoken_01 (pEventKind);
-				char szText[1024];
-				memset (szText, 0, sizeof (szText));
-				strncpy_ex02 (szText, pText, sizeof (szText) - 1, strlen (pText));
-				MIDITrack_InsertLyricA (pMIDITrack, lTime, szText);
+		/* エンドオブトラック */
+		case MIDICSV_ENDTRACK: {
+			MIDIEvent* pEvent = MIDIEvent_CreateEndofTrack (lTime);
+			if (pEvent) {
+				MIDICSVTrackWriter_AddEvent (pWriter, pEvent);
 			}
+			pMIDITrack = NULL;
+			MIDICSVTrackWriter_SetTrack (pWriter, NULL);
+			break;
 		}
 
-		/* マーカー */
-		if (_strnicmp (pEventKind, "Marker_t", 8) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pText = getnexttoken_01 (pEventKind);
-				char szText[1024];
-				memset (szText, 0, sizeof (szText));
-				strncpy_ex02 (szText, pText, sizeof (szText) - 1, strlen (pText));
-				MIDITrack_InsertMarkerA (pMIDITrack, lTime, szText);
+		/* シーケンス番号 */
+		case MIDICSV_SEQUENCENUMBER: {
+			char* pNumber = getnexttoken_01 (pEventKind);
+			long lNumber = CLIP (0, atol (pNumber), 65535);
+			MIDIEvent* pEvent = MIDIEvent_CreateSequenceNumber (lTime, lNumber);
+			if (pEvent) {
+				MIDICSVTrackWriter_AddEvent (pWriter, pEvent);
 			}
+			break;
 		}
 
-		/* キューポイント */
-		if (_strnicmp (pEventKind, "Cue_point_t", 11) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pText = getnexttoken_01 (pEventKind);
-				char szText[1024];
-				memset (szText, 0, sizeof (szText));
-				strncpy_ex02 (szText, pText, sizeof (szText) - 1, strlen (pText));
-				MIDITrack_InsertCuePointA (pMIDITrack, lTime, szText);
-			}
+		/* テキスト・著作権・トラック名／シーケンス名・インストゥルメント名・歌詞・マーカー・キューポイント */
+		case MIDICSV_TEXTEVENT:
+		case MIDICSV_COPYRIGHTNOTICE:
+		case MIDICSV_TRACKNAME:
+		case MIDICSV_INSTRUMENTNAME:
+		case MIDICSV_LYRIC:
+		case MIDICSV_MARKER:
+		case MIDICSV_CUEPOINT: {
+			char* pText = getnexttoken_01 (pEventKind);
+			char szText[1024];
+			long lMetaKind = lKind - MIDICSV_TEXTEVENT + MIDIEVENT_TEXTEVENT;
+			memset (szText, 0, sizeof (szText));
+			strncpy_ex02 (szText, pText, sizeof (szText) - 1, strlen (pText));
+			MIDICSVTrackWriter_AddTextEvent (pWriter, lTime, lMetaKind, szText);
+			break;
 		}
 
 		/* プログラム名(処理なし) */
@@ -13768,251 +14467,257 @@ MIDIData* __stdcall MIDIData_LoadFromMIDICSVW (const wchar_t* pszFileName) {
 		/* デバイス名(処理なし) */
 
 		/* ポートプリフィックス */
-		if (_strnicmp (pEventKind, "MIDI_port", 9) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pNumber = getnexttoken_01 (pEventKind);
-				long lNumber = CLIP (0, atol (pNumber), 255);
-				MIDITrack_InsertPortPrefix (pMIDITrack, lTime, lNumber);
+		case MIDICSV_PORTPREFIX: {
+			char* pNumber = getnexttoken_01 (pEventKind);
+			long lNumber = CLIP (0, atol (pNumber), 255);
+			MIDIEvent* pEvent = MIDIEvent_CreatePortPrefix (lTime, lNumber);
+			if (pEvent) {
+				MIDICSVTrackWriter_AddEvent (pWriter, pEvent);
 			}
+			break;
 		}
 
 		/* チャンネルプリフィックス */
-		if (_strnicmp (pEventKind, "Channel_prefix", 14) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pNumber = getnexttoken_01 (pEventKind);
-				long lNumber = CLIP (0, atol (pNumber), 15);
-				MIDITrack_InsertChannelPrefix (pMIDITrack, lTime, lNumber);
+		case MIDICSV_CHANNELPREFIX: {
+			char* pNumber = getnexttoken_01 (pEventKind);
+			long lNumber = CLIP (0, atol (pNumber), 15);
+			MIDIEvent* pEvent = MIDIEvent_CreateChannelPrefix (lTime, lNumber);
+			if (pEvent) {
+				MIDICSVTrackWriter_AddEvent (pWriter, pEvent);
 			}
+			break;
 		}
 
-
 		/* テンポ */
-		if (_strnicmp (pEventKind, "Tempo", 5) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pTempo = getnexttoken_01 (pEventKind);
-				long lTempo = CLIP (1, atol (pTempo), 60000000);
-				MIDITrack_InsertTempo (pMIDITrack, lTime, lTempo);
+		case MIDICSV_TEMPO: {
+			char* pTempo = getnexttoken_01 (pEventKind);
+			long lTempo = CLIP (1, atol (pTempo), 60000000);
+			MIDIEvent* pEvent = MIDIEvent_CreateTempo (lTime, lTempo);
+			if (pEvent) {
+				MIDICSVTrackWriter_AddEvent (pWriter, pEvent);
 			}
+			break;
 		}
 
 		/* SMPTEオフセット */
-		if (_strnicmp (pEventKind, "SMPTE_offset", 12) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pHour = getnexttoken_01 (pEventKind);
-				char* pMinute = getnexttoken_01 (pHour);
-				char* pSecond = getnexttoken_01 (pMinute);
-				char* pFrame = getnexttoken_01 (pSecond);
-				char* pSubFrame = getnexttoken_01 (pFrame);
-				long lRate = CLIP (0, (atol (pHour) & 0x60) >> 5, 3);
-				long lHour = CLIP (0, atol (pHour) & 0x1F, 23);
-				long lMinute = CLIP (0, atol (pMinute), 59);
-				long lSecond = CLIP (0, atol (pSecond), 59);
-				long lFrame = CLIP (0, atol (pFrame), 29);
-				long lSubFrame = CLIP (0, atol (pSubFrame), 99);
-				MIDITrack_InsertSMPTEOffset (pMIDITrack, lTime, lRate, lHour, lMinute, lSecond, lFrame, lSubFrame);
+		case MIDICSV_SMPTEOFFSET: {
+			char* pHour = getnexttoken_01 (pEventKind);
+			char* pMinute = getnexttoken_01 (pHour);
+			char* pSecond = getnexttoken_01 (pMinute);
+			char* pFrame = getnexttoken_01 (pSecond);
+			char* pSubFrame = getnexttoken_01 (pFrame);
+			long lRate = CLIP (0, (atol (pHour) & 0x60) >> 5, 3);
+			long lHour = CLIP (0, atol (pHour) & 0x1F, 23);
+			long lMinute = CLIP (0, atol (pMinute), 59);
+			long lSecond = CLIP (0, atol (pSecond), 59);
+			long lFrame = CLIP (0, atol (pFrame), 29);
+			long lSubFrame = CLIP (0, atol (pSubFrame), 99);
+			MIDIEvent* pEvent = MIDIEvent_CreateSMPTEOffset
+				(lTime, lRate, lHour, lMinute, lSecond, lFrame, lSubFrame);
+			if (pEvent) {
+				MIDICSVTrackWriter_AddEvent (pWriter, pEvent);
 			}
+			break;
 		}
 
 		/* 拍子記号 */
-		if (_strnicmp (pEventKind, "Time_signature", 14) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pN = getnexttoken_01 (pEventKind);
-				char* pD = getnexttoken_01 (pN);
-				char* pC = getnexttoken_01 (pD);
-				char* pB = getnexttoken_01 (pC);
-				long lN = CLIP (1, atol (pN), 127);
-				long lD = CLIP (1, atol (pD), 8);
-				long lC = CLIP (1, atol (pC), 127); /* 常に24が正解 */
-				long lB = CLIP (1, atol (pB), 127); /* 常に8が正解 */
-				MIDITrack_InsertTimeSignature (pMIDITrack, lTime, lN, lD, lC, lB);
+		case MIDICSV_TIMESIGNATURE: {
+			char* pN = getnexttoken_01 (pEventKind);
+			char* pD = getnexttoken_01 (pN);
+			char* pC = getnexttoken_01 (pD);
+			char* pB = getnexttoken_01 (pC);
+			long lN = CLIP (1, atol (pN), 127);
+			long lD = CLIP (1, atol (pD), 8);
+			long lC = CLIP (1, atol (pC), 127); /* 常に24が正解 */
+			long lB = CLIP (1, atol (pB), 127); /* 常に8が正解 */
+			MIDIEvent* pEvent = MIDIEvent_CreateTimeSignature (lTime, lN, lD, lC, lB);
+			if (pEvent) {
+				MIDICSVTrackWriter_AddEvent (pWriter, pEvent);
 			}
+			break;
 		}
 
 		/* 調性記号 */
-		if (_strnicmp (pEventKind, "Key_signature", 13) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pTone = getnexttoken_01 (pEventKind);
-				char* pMinor = getnexttoken_01 (pTone);
-				long lTone = CLIP (-7, atol (pTone), 7);
-				long lMinor = _strnicmp (pMinor, "\"minor\"", 7) == 0 ? 1 : 0;
-				MIDITrack_InsertKeySignature (pMIDITrack, lTime, lTone, lMinor);
+		case MIDICSV_KEYSIGNATURE: {
+			char* pTone = getnexttoken_01 (pEventKind);
+			char* pMinor = getnexttoken_01 (pTone);
+			long lTone = CLIP (-7, atol (pTone), 7);
+			long lMinor = _strnicmp (pMinor, "\"minor\"", 7) == 0 ? 1 : 0;
+			MIDIEvent* pEvent = MIDIEvent_CreateKeySignature (lTime, lTone, lMinor);
+			if (pEvent) {
+				MIDICSVTrackWriter_AddEvent (pWriter, pEvent);
 			}
+			break;
 		}
 
 		/* シーケンサー独自のイベント */
-		if (_strnicmp (pEventKind, "Sequencer_specific", 18) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				long k = 0;
-				unsigned char ucData[1024];
-				char* pLen = getnexttoken_01 (pEventKind);
-				char* pData = getnexttoken_01 (pLen);
-				long lLen = CLIP (0, atol (pLen), sizeof (ucData));
-				memset (ucData, 0, sizeof (ucData));
-				while (*pData != '\r' && *pData != '\n' && *pData != '\0' && k < lLen) { 
-					ucData[k++] = (unsigned char)atoi (pData);
-					pData = getnexttoken_01 (pData);
-				}
-				MIDITrack_InsertSequencerSpecific (pMIDITrack, lTime, ucData, lLen);
+		case MIDICSV_SEQUENCERSPECIFIC: {
+			unsigned char ucData[1024];
+			char* pLen = getnexttoken_01 (pEventKind);
+			char* pData = getnexttoken_01 (pLen);
+			long lLen = CLIP (0, atol (pLen), sizeof (ucData));
+			MIDIEvent* pEvent = NULL;
+			memset (ucData, 0, sizeof (ucData));
+			MIDICSV_GetDataBytes (pData, ucData, lLen);
+			pEvent = MIDIEvent_CreateSequencerSpecific (lTime, (char*)ucData, lLen);
+			if (pEvent) {
+				MIDICSVTrackWriter_AddEvent (pWriter, pEvent);
 			}
+			break;
 		}
 
 		/* 未定義のメタイベント */
-		if (_strnicmp (pEventKind, "Unknown_meta_event", 18) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				long k = 0;
-				unsigned char ucData[1024];
-				char* pKind = getnexttoken_01 (pEventKind);
-				char* pLen = getnexttoken_01 (pKind);
-				char* pData = getnexttoken_01 (pLen);
-				long lKind = atol (pKind);
-				if (0x00 <= lKind && lKind <= 0x7F) {
-					MIDIEvent* pMIDIEvent = NULL;
-					long lLen = CLIP (0, atol (pLen), sizeof (ucData));
-					memset (ucData, 0, sizeof (ucData));
-					while (*pData != '\r' && *pData != '\n' && *pData != '\0' && k < lLen) { 
-						ucData[k++] = (unsigned char)atoi (pData);
-						pData = getnexttoken_01 (pData);
-					}
-					pMIDIEvent = MIDIEvent_Create (lTime, lKind, ucData, lLen);
-					if (pMIDIEvent) {
-						MIDITrack_InsertEvent (pMIDITrack, pMIDIEvent);
-					}
+		case MIDICSV_UNKNOWNMETAEVENT: {
+			unsigned char ucData[1024];
+			char* pMetaKind = getnexttoken_01 (pEventKind);
+			char* pLen = getnexttoken_01 (pMetaKind);
+			char* pData = getnexttoken_01 (pLen);
+			long lMetaKind = atol (pMetaKind);
+			if (0x00 <= lMetaKind && lMetaKind <= 0x7F) {
+				MIDIEvent* pEvent = NULL;
+				long lLen = CLIP (0, atol (pLen), sizeof (ucData));
+				memset (ucData, 0, sizeof (ucData));
+				MIDICSV_GetDataBytes (pData, ucData, lLen);
+				pEvent = MIDIEvent_Create (lTime, lMetaKind, ucData, lLen);
+				if (pEvent) {
+					MIDICSVTrackWriter_AddEvent (pWriter, pEvent);
 				}
 			}
+			break;
 		}
 
-		/* ノートオフ */
-		if (_strnicmp (pEventKind, "Note_off_c", 10) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pChannel = getnexttoken_01 (pEventKind);
-				char* pKey = getnexttoken_01 (pChannel);
-				char* pVelocity = getnexttoken_01 (pKey);
-				long lChannel = CLIP (0, atol (pChannel), 15);
-				long lKey = CLIP (0, atol (pKey), 127);
-				long lVelocity = CLIP (0, atol (pVelocity), 127);
-				MIDITrack_InsertNoteOff (pMIDITrack, lTime, lChannel, lKey, lVelocity);
-			}
-		}
-
-		/* ノートオン */
-		if (_strnicmp (pEventKind, "Note_on_c", 9) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pChannel = getnexttoken_01 (pEventKind);
-				char* pKey = getnexttoken_01 (pChannel);
-				char* pVelocity = getnexttoken_01 (pKey);
-				long lChannel = CLIP (0, atol (pChannel), 15);
-				long lKey = CLIP (0, atol (pKey), 127);
-				long lVelocity = CLIP (0, atol (pVelocity), 127);
-				MIDITrack_InsertNoteOn (pMIDITrack, lTime, lChannel, lKey, lVelocity);
-			}
-		}
-
-		/* キーアフタータッチ */
-		if (_strnicmp (pEventKind, "Poly_aftertouch_c", 17) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pChannel = getnexttoken_01 (pEventKind);
-				char* pKey = getnexttoken_01 (pChannel);
-				char* pValue = getnexttoken_01 (pKey);
-				long lChannel = CLIP (0, atol (pChannel), 15);
-				long lKey = CLIP (0, atol (pKey), 127);
-				long lValue = CLIP (0, atol (pValue), 127);
-				MIDITrack_InsertKeyAftertouch (pMIDITrack, lTime, lChannel, lKey, lValue);
+		/* ノートオフ・ノートオン・キーアフタータッチ・コントロールチェンジ */
+		case MIDICSV_NOTEOFF:
+		case MIDICSV_NOTEON:
+		case MIDICSV_KEYAFTERTOUCH:
+		case MIDICSV_CONTROLCHANGE: {
+			char* pChannel = getnexttoken_01 (pEventKind);
+			char* pNumber = getnexttoken_01 (pChannel);
+			char* pValue = getnexttoken_01 (pNumber);
+			long lChannel = CLIP (0, atol (pChannel), 15);
+			long lNumber = CLIP (0, atol (pNumber), 127);
+			long lValue = CLIP (0, atol (pValue), 127);
+			MIDIEvent* pEvent = NULL;
+			switch (lKind) {
+			case MIDICSV_NOTEOFF:
+				pEvent = MIDIEvent_CreateNoteOff (lTime, lChannel, lNumber, lValue);
+				break;
+			case MIDICSV_NOTEON:
+				pEvent = MIDIEvent_CreateNoteOn (lTime, lChannel, lNumber, lValue);
+				break;
+			case MIDICSV_KEYAFTERTOUCH:
+				pEvent = MIDIEvent_CreateKeyAftertouch (lTime, lChannel, lNumber, lValue);
+				break;
+			default:
+				pEvent = MIDIEvent_CreateControlChange (lTime, lChannel, lNumber, lValue);
+				break;
 			}
-		}
-
-		/* コントロールチェンジ */
-		if (_strnicmp (pEventKind, "Control_c", 9) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pChannel = getnexttoken_01 (pEventKind);
-				char* pNumber = getnexttoken_01 (pChannel);
-				char* pValue = getnexttoken_01 (pNumber);
-				long lChannel = CLIP (0, atol (pChannel), 15);
-				long lNumber = CLIP (0, atol (pNumber), 127);
-				long lValue = CLIP (0, atol (pValue), 127);
-				MIDITrack_InsertControlChange (pMIDITrack, lTime, lChannel, lNumber, lValue);
+			if (pEvent) {
+				MIDICSVTrackWriter_AddEvent (pWriter, pEvent);
 			}
+			break;
 		}
 
 		/* プログラムチェンジ */
-		if (_strnicmp (pEventKind, "Program_c", 9) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pChannel = getnexttoken_01 (pEventKind);
-				char* pNumber = getnexttoken_01 (pChannel);
-				long lChannel = CLIP (0, atol (pChannel), 15);
-				long lNumber = CLIP (0, atol (pNumber), 127);
-				MIDITrack_InsertProgramChange (pMIDITrack, lTime, lChannel, lNumber);
+		case MIDICSV_PROGRAMCHANGE: {
+			char* pChannel = getnexttoken_01 (pEventKind);
+			char* pNumber = getnexttoken_01 (pChannel);
+			long lChannel = CLIP (0, atol (pChannel), 15);
+			long lNumber = CLIP (0, atol (pNumber), 127);
+			MIDIEvent* pEvent = MIDIEvent_CreateProgramChange (lTime, lChannel, lNumber);
+			if (pEvent) {
+				MIDICSVTrackWriter_AddEvent (pWriter, pEvent);
 			}
+			break;
 		}
 
 		/* チャンネルアフタータッチ */
-		if (_strnicmp (pEventKind, "Channel_aftertouch_c", 20) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pChannel = getnexttoken_01 (pEventKind);
-				char* pValue = getnexttoken_01 (pChannel);
-				long lChannel = CLIP (0, atol (pChannel), 15);
-				long lValue = CLIP (0, atol (pValue), 127);
-				MIDITrack_InsertChannelAftertouch (pMIDITrack, lTime, lChannel, lValue);
+		case MIDICSV_CHANNELAFTERTOUCH: {
+			char* pChannel = getnexttoken_01 (pEventKind);
+			char* pValue = getnexttoken_01 (pChannel);
+			long lChannel = CLIP (0, atol (pChannel), 15);
+			long lValue = CLIP (0, atol (pValue), 127);
+			MIDIEvent* pEvent = MIDIEvent_CreateChannelAftertouch (lTime, lChannel, lValue);
+			if (pEvent) {
+				MIDICSVTrackWriter_AddEvent (pWriter, pEvent);
 			}
+			break;
 		}
 
 		/* ピッチベンド */
-		if (_strnicmp (pEventKind, "Pitch_bend_c", 12) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				char* pChannel = getnexttoken_01 (pEventKind);
-				char* pValue = getnexttoken_01 (pChannel);
-				long lChannel = CLIP (0, atol (pChannel), 15);
-				long lValue = CLIP (0, atol (pValue), 16363);
-				MIDITrack_InsertPitchBend (pMIDITrack, lTime, lChannel, lValue);
+		case MIDICSV_PITCHBEND: {
+			char* pChannel = getnexttoken_01 (pEventKind);
+			char* pValue = getnexttoken_01 (pChannel);
+			long lChannel = CLIP (0, atol (pChannel), 15);
+			long lValue = CLIP (0, atol (pValue), 16363);
+			MIDIEvent* pEvent = MIDIEvent_CreatePitchBend (lTime, lChannel, lValue);
+			if (pEvent) {
+				MIDICSVTrackWriter_AddEvent (pWriter, pEvent);
 			}
+			break;
 		}
 
 		/* システムエクスクルーシヴ */
-		if (_strnicmp (pEventKind, "System_exclusive", 16) == 0 &&
-			_strnicmp (pEventKind, "System_exclusive_packet", 23) != 0) {
-			if (pMIDIData && pMIDITrack) {
-				long k = 1;
-				unsigned char ucData[1024];
-				char* pLen = getnexttoken_01 (pEventKind);
-				char* pData = getnexttoken_01 (pLen);
-				long lLen = CLIP (0, atol (pLen), sizeof (ucData));
-				memset (ucData, 0, sizeof (ucData));
-				ucData[0] = 0xF0;
-				while (*pData != '\r' && *pData != '\n' && *pData != '\0' && k < lLen + 1) { 
-					ucData[k++] = (unsigned char)atoi (pData);
-					pData = getnexttoken_01 (pData);
-				}
-				MIDITrack_InsertSysExEvent (pMIDITrack, lTime, ucData, lLen + 1);
+		case MIDICSV_SYSEXEVENT: {
+			unsigned char ucData[1025];
+			char* pLen = getnexttoken_01 (pEventKind);
+			char* pData = getnexttoken_01 (pLen);
+			long lLen = CLIP (0, atol (pLen), 1024);
+			MIDIEvent* pEvent = NULL;
+			memset (ucData, 0, sizeof (ucData));
+			ucData[0] = 0xF0;
+			MIDICSV_GetDataBytes (pData, ucData + 1, lLen);
+			pEvent = MIDIEvent_CreateSysExEvent (lTime, ucData, lLen + 1);
+			if (pEvent) {
+				MIDICSVTrackWriter_AddEvent (pWriter, pEvent);
 			}
+			break;
 		}
 
 		/* システムエクスクルーシヴ(続き) */
-		if (_strnicmp (pEventKind, "System_exclusive_packet", 23) == 0) {
-			if (pMIDIData && pMIDITrack) {
-				long k = 0;
-				unsigned char ucData[1024];
-				char* pLen = getnexttoken_01 (pEventKind);
-				char* pData = getnexttoken_01 (pLen);
-				long lLen = CLIP (0, atol (pLen), sizeof (ucData));
-				memset (ucData, 0, sizeof (ucData));
-				while (*pData != '\r' && *pData != '\n' && *pData != '\0' && k < lLen) { 
-					ucData[k++] = (unsigned char)atoi (pData);
-					pData = getnexttoken_01 (pData);
-				}
-				MIDITrack_InsertSysExEvent (pMIDITrack, lTime, ucData, lLen);
+		case MIDICSV_SYSEXPACKET: {
+			unsigned char ucData[1024];
+			char* pLen = getnexttoken_01 (pEventKind);
+			char* pData = getnexttoken_01 (pLen);
+			long lLen = CLIP (0, atol (pLen), sizeof (ucData));
+			MIDIEvent* pEvent = NULL;
+			memset (ucData, 0, sizeof (ucData));
+			MIDICSV_GetDataBytes (pData, ucData, lLen);
+			pEvent = MIDIEvent_CreateSysExEvent (lTime, ucData, lLen);
+			if (pEvent) {
+				MIDICSVTrackWriter_AddEvent (pWriter, pEvent);
 			}
+			break;
+		}
 		}
 	}
 
-	/* ファイルを閉じる */
-	fclose (pFile);
+	/* 行の途中でメモリ不足になった場合、そこまでの内容で読み込みを成功させない */
+	if (theReader.m_bError) {
+		bError = 1;
+	}
+	free (theReader.m_pBuf);
+	free (ppTrackTable);
+	free (pWriter);
+
+	if (bError) {
+		if (pMIDIData) {
+			MIDIData_Delete (pMIDIData);
+		}
+		return NULL;
+	}
+	if (pMIDIData == NULL) {
+		return NULL;
+	}
 
 	/* エンドオブトラックを付け忘れているトラックは自動的に付加する */
-	if (pMIDIData) {
-		forEachTrack (pMIDIData, pMIDITrack) {
-			MIDIEvent* pLastEvent = MIDITrack_GetLastEvent (pMIDITrack);
-			if (!MIDIEvent_IsEndofTrack (pLastEvent)) {
-				MIDITrack_InsertEndofTrack (pMIDITrack, pLastEvent->m_lTime);
-			}
+	forEachTrack (pMIDIData, pMIDITrack) {
+		MIDIEvent* pLastEvent = MIDITrack_GetLastEvent (pMIDITrack);
+		if (pLastEvent == NULL) {
+			MIDITrack_InsertEndofTrack (pMIDITrack, 0);
+		}
+		else if (!MIDIEvent_IsEndofTrack (pLastEvent)) {
+			MIDITrack_InsertEndofTrack (pMIDITrack, pLastEvent->m_lTime);
 		}
 	}
 
@@ -14032,338 +14737,489 @@ MIDIData* __stdcall MIDIData_LoadFromMIDICSVW (const wchar_t* pszFileName) {
 	return pMIDIData;
 }
 
+/* MIDIデータをMIDICSVファイル(*.csv)から読み込み(ANSI) */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+MIDIData* __stdcall MIDIData_LoadFromMIDICSVA (const char* pszFileName) {
+	MIDIDataStream theStream;
+	MIDIData* pMIDIData = NULL;
+	if (MIDIDataStream_OpenFileA (&theStream, pszFileName, "rb") == 0) {
+		return NULL;
+	}
+	pMIDIData = MIDIData_LoadFromMIDICSVStream (&theStream);
+	MIDIDataStream_Close (&theStream);
+	return pMIDIData;
+}
+
+/* MIDIデータをMIDICSVファイル(*.csv)から読み込み(UNICODE) */
+/* ファイル名はUNICODEで与えるがファイルの中身は仕様に基づきANSIである。 */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+MIDIData* __stdcall MIDIData_LoadFromMIDICSVW (const wchar_t* pszFileName) {
+	MIDIDataStream theStream;
+	MIDIData* pMIDIData = NULL;
+	if (MIDIDataStream_OpenFileW (&theStream, pszFileName, L"rb") == 0) {
+		return NULL;
+	}
+	pMIDIData = MIDIData_LoadFromMIDICSVStream (&theStream);
+	MIDIDataStream_Close (&theStream);
+	return pMIDIData;
+}
+
+/* MIDIデータをMIDICSVファイル(*.csv)から読み込み(メモリブロック)(20261019追加) */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+MIDIData* __stdcall MIDIData_LoadFromMIDICSVMemory (const void* pData, long lLen) {
+	MIDIDataStream theStream;
+	/* 引数の検査 */
+	if (pData == NULL || lLen < 0) {
+		return NULL;
+	}
+	MIDIDataStream_OpenMemory (&theStream, pData, lLen, 0);
+	return MIDIData_LoadFromMIDICSVStream (&theStream);
+}
 
-/* strncpyの特殊版01(コード入り文字列をコード無し文字列に変換)(隠蔽) */
-/* 20140515修正 */
-static char* strncpy_ex01 (char* pText1, char* pText2, long lLen1, long lLen2) {
-	char* p1 = pText1;
-	char* p2 = pText2;
-	while (1) {
-		/* 0x22'\"'→ダブルクォーテーション表現"""" */
-		if (p1 - pText1 < lLen1 - 1 && 
-			p2 - pText2 < lLen2 && *p2 == '\"') {
-			*p1++ = '\"';
-			*p1++ = '\"';
-			p2++;
+
+/* MIDICSV保存用の整数書き込み(10進数)(非公開)(20261019追加) */
+/* pから書き込み、書き込んだ文字列の直後の位置を返す(終端の'\0'は書き込まない)。 */
+static char* MIDICSV_PutLong (char* p, long lValue) {
+	char szBuf[24];
+	char* q = szBuf + sizeof (szBuf);
+	unsigned long ulValue = lValue < 0 ? 0UL - (unsigned long)lValue : (unsigned long)lValue;
+	do {
+		*--q = (char)('0' + ulValue % 10);
+		ulValue /= 10;
+	} while (ulValue);
+	if (lValue < 0) {
+		*--q = '-';
+	}
+	while (q < szBuf + sizeof (szBuf)) {
+		*p++ = *q++;
+	}
+	return p;
+}
+
+/* MIDICSV保存用の文字列書き込み(非公開)(20261019追加) */
+/* pから書き込み、書き込んだ文字列の直後の位置を返す(終端の'\0'は書き込まない)。 */
+static char* MIDICSV_PutText (char* p, const char* pszText) {
+	size_t lLen = strlen (pszText);
+	memcpy (p, pszText, lLen);
+	return p + lLen;
+}
+
+/* MIDICSV保存用のデータバイト列書き込み(", 値"の繰り返し)(非公開)(20261019追加) */
+/* 1バイトあたり最大5文字を書き込む。 */
+static char* MIDICSV_PutDataBytes (char* p, const unsigned char* pData, long lLen) {
+	long k;
+	for (k = 0; k < lLen; k++) {
+		*p++ = ',';
+		*p++ = ' ';
+		if (pData[k] >= 100) {
+			*p++ = (char)('0' + pData[k] / 100);
 		}
-		/* 0x5C'\\'→バックスラッシュ表現"\\" */
-		else if (p1 - pText1 < lLen1 - 1 && 
-			p2 - pText2 < lLen2 && *p2 == 0x5C) {
-			*p1++ = 0x5C;
-			*p1++ = 0x5C;
-			p2++;
+		if (pData[k] >= 10) {
+			*p++ = (char)('0' + pData[k] / 10 % 10);
 		}
-		/* Latin-1で表現できない文字→\3桁8進表記"\xxx" */
-		else if (p1 - pText1 < lLen1 - 4 && p2 - pText2 < lLen2 &&
-			(0x00 <= (unsigned char)*p2 && (unsigned char)*p2 <= 0x1F || 
-			0x7F <= (unsigned char)*p2 && (unsigned char)*p2 <= 0xA0)) {
-			*p1++ = 0x5C;
-			*p1++ = ((unsigned char)*p2 / 64) + '0';
-			*p1++ = (((unsigned char)*p2 / 8) % 8) + '0';
-			*p1++ = ((unsigned char)*p2 % 8) + '0';
-			p2++;
+		*p++ = (char)('0' + pData[k] % 10);
+	}
+	return p;
+}
+
+/* MIDICSV保存用の文字列のエスケープ(コード入り文字列をコード無し文字列に変換)(非公開)(20261019追加) */
+/* 0x22'\"'は""、0x5C'\\'は\\、Latin-1で表現できない文字は\3桁8進表記に変換する。 */
+/* 変換不要な文字の並びはまとめて複写する。1バイトあたり最大4文字を書き込む。 */
+static char* MIDICSV_PutEscapedText (char* p, const unsigned char* pData, long lLen) {
+	const unsigned char* pEnd = pData + lLen;
+	const unsigned char* pRun;
+	unsigned char c;
+	while (pData < pEnd) {
+		/* 変換不要な文字の並び */
+		pRun = pData;
+		while (pData < pEnd) {
+			c = *pData;
+			if (c == '\"' || c == 0x5C || c <= 0x1F || (0x7F <= c && c <= 0xA0)) {
+				break;
+			}
+			pData++;
 		}
-		/* 1バイト文字(単純コピー) */
-		else if (p1 - pText1 < lLen1 && p2 - pText2 < lLen2) {
-			*p1++ = *p2++;
+		memcpy (p, pRun, pData - pRun);
+		p += pData - pRun;
+		if (pData >= pEnd) {
+			break;
+		}
+		/* 変換が必要な文字 */
+		c = *pData++;
+		if (c == '\"' || c == 0x5C) {
+			*p++ = (char)c;
+			*p++ = (char)c;
 		}
 		else {
-			break;
+			*p++ = 0x5C;
+			*p++ = (char)((c / 64) + '0');
+			*p++ = (char)(((c / 8) % 8) + '0');
+			*p++ = (char)((c % 8) + '0');
 		}
 	}
-	return pText1;
+	return p;
 }
 
-/* MIDICSV形式でイベントを1つファイルに保存する(隠蔽) */
-static long MIDIEvent_SaveAsMIDICSV (MIDIEvent* pMIDIEvent, long lTrackIndex, FILE* pFile) {
-	long lWriteLen = 0;
-	long lTime = pMIDIEvent->m_lTime;
-	long k = 0;
+#define MIDICSV_MAXLINEHEADERLEN 128 /* 1行のうち可変長データ以外の部分の最大長[バイト] */
+
+/* MIDICSV形式でイベントを1行作業用バッファの末尾に追加する(非公開)(20261019変更) */
+/* 20261019 printf系の関数を使わずに直接書き込むよう変更し、テキストの1023文字の制限を撤廃 */
+/* エンドオブトラックは書き込まない。戻り値：正常終了=1、異常終了=0。 */
+static long MIDIEvent_WriteMIDICSV (MIDIEvent* pMIDIEvent, long lTrackIndex, SMFWriteBuf* pWriteBuf) {
+	char* pBuf;
+	char* p;
+	const char* pszName = NULL;
+	unsigned char* pData = pMIDIEvent->m_pData;
+	long lLen = pMIDIEvent->m_lLen;
+	long lKind = pMIDIEvent->m_lKind;
+	if (pMIDIEvent->m_lKind == MIDIEVENT_ENDOFTRACK) {
+		return 1;
+	}
+	if (!MIDIEvent_IsMetaEvent (pMIDIEvent) && !MIDIEvent_IsMIDIEvent (pMIDIEvent) &&
+		pMIDIEvent->m_lKind != MIDIEVENT_SYSEXSTART &&
+		pMIDIEvent->m_lKind != MIDIEVENT_SYSEXCONTINUE) {
+		return 1;
+	}
+	if (lLen < 0 || lLen > (LONG_MAX - MIDICSV_MAXLINEHEADERLEN) / 5) {
+		return 0;
+	}
+	if (!SMFWriteBuf_Reserve (pWriteBuf, MIDICSV_MAXLINEHEADERLEN + lLen * 5)) {
+		return 0;
+	}
+	pBuf = (char*)(pWriteBuf->m_pBuf + pWriteBuf->m_lLen);
+	p = pBuf;
+	/* トラック番号、タイム */
+	p = MIDICSV_PutLong (p, lTrackIndex + 1);
+	*p++ = ',';
+	*p++ = ' ';
+	p = MIDICSV_PutLong (p, pMIDIEvent->m_lTime);
+	*p++ = ',';
+	*p++ = ' ';
 	if (MIDIEvent_IsMetaEvent (pMIDIEvent)) {
-		char szText[1024];
-		memset (szText, 0, sizeof (szText));
-		switch (pMIDIEvent->m_lKind) {
+		/* データのないメタイベントは長さ0とみなす */
+		if (pData == NULL) {
+			lLen = 0;
+		}
+		/* 長さの足りないSMPTEオフセット・拍子記号・調性記号は、決まった長さを読まずに */
+		/* 不明なメタイベントとしてそのまま書き込む */
+		if ((lKind == MIDIEVENT_SMPTEOFFSET && lLen < 5) ||
+			(lKind == MIDIEVENT_TIMESIGNATURE && lLen < 4) ||
+			(lKind == MIDIEVENT_KEYSIGNATURE && lLen < 2)) {
+			lKind = -1;
+		}
+		switch (lKind) {
 		case MIDIEVENT_SEQUENCENUMBER:
-			lWriteLen = fprintf (pFile, "%ld, %ld, Sequence_number, %ld\n", 
-				lTrackIndex + 1, lTime,	MIDIEvent_GetNumber (pMIDIEvent));
+			p = MIDICSV_PutText (p, "Sequence_number, ");
+			p = MIDICSV_PutLong (p, MIDIEvent_GetNumber (pMIDIEvent));
 			break;
 		case MIDIEVENT_TEXTEVENT:
-			strncpy_ex01 (szText, pMIDIEvent->m_pData, sizeof (szText) - 1, pMIDIEvent->m_lLen);
-			lWriteLen = fprintf (pFile, "%ld, %ld, Text_t, \"%s\"\n", 
-				lTrackIndex + 1, lTime, szText);
+			pszName = "Text_t, \"";
 			break;
 		case MIDIEVENT_COPYRIGHTNOTICE:
-			strncpy_ex01 (szText, pMIDIEvent->m_pData, sizeof (szText) - 1, pMIDIEvent->m_lLen);
-			lWriteLen = fprintf (pFile, "%ld, %ld, Copyright_t, \"%s\"\n", 
-				lTrackIndex + 1, lTime, szText);
+			pszName = "Copyright_t, \"";
 			break;
 		case MIDIEVENT_TRACKNAME:
-			strncpy_ex01 (szText, pMIDIEvent->m_pData, sizeof (szText) - 1, pMIDIEvent->m_lLen);
-			lWriteLen = fprintf (pFile, "%ld, %ld, Title_t, \"%s\"\n", 
-				lTrackIndex + 1, lTime, szText);
+			pszName = "Title_t, \"";
 			break;
 		case MIDIEVENT_INSTRUMENTNAME:
-			strncpy_ex01 (szText, pMIDIEvent->m_pData, sizeof (szText) - 1, pMIDIEvent->m_lLen);
-			lWriteLen = fprintf (pFile, "%ld, %ld, Instrument_name_t, \"%s\"\n", 
-				lTrackIndex + 1, lTime, szText);
+			pszName = "Instrument_name_t, \"";
 			break;
 		case MIDIEVENT_LYRIC:
-			strncpy_ex01 (szText, pMIDIEvent->m_pData, sizeof (szText) - 1, pMIDIEvent->m_lLen);
-			lWriteLen = fprintf (pFile, "%ld, %ld, Lyric_t, \"%s\"\n", 
-				lTrackIndex + 1, lTime, szText);
+			pszName = "Lyric_t, \"";
 			break;
 		case MIDIEVENT_MARKER:
-			strncpy_ex01 (szText, pMIDIEvent->m_pData, sizeof (szText) - 1, pMIDIEvent->m_lLen);
-			lWriteLen = fprintf (pFile, "%ld, %ld, Marker_t, \"%s\"\n", 
-				lTrackIndex + 1, lTime, szText);
+			pszName = "Marker_t, \"";
 			break;
 		case MIDIEVENT_CUEPOINT:
-			strncpy_ex01 (szText, pMIDIEvent->m_pData, sizeof (szText) - 1, pMIDIEvent->m_lLen);
-			lWriteLen = fprintf (pFile, "%ld, %ld, Cue_point_t, \"%s\"\n", 
-				lTrackIndex + 1, lTime, szText);
+			pszName = "Cue_point_t, \"";
 			break;
 		/*case MIDIEVENT_PROGRAMNAME: */
 		/*	break; */
 		/*case MIDIEVENT_DEVICENAME: */
 		/*	break; */
 		case MIDIEVENT_CHANNELPREFIX:
-			lWriteLen = fprintf (pFile, "%ld, %ld, Channel_prefix, %ld\n", 
-				lTrackIndex + 1, lTime,	MIDIEvent_GetNumber (pMIDIEvent));
+			p = MIDICSV_PutText (p, "Channel_prefix, ");
+			p = MIDICSV_PutLong (p, MIDIEvent_GetNumber (pMIDIEvent));
 			break;
 		case MIDIEVENT_PORTPREFIX:
-			lWriteLen = fprintf (pFile, "%ld, %ld, MIDI_port, %ld\n", 
-				lTrackIndex + 1, lTime, MIDIEvent_GetNumber (pMIDIEvent));
-			break;
-		case MIDIEVENT_ENDOFTRACK:
+			p = MIDICSV_PutText (p, "MIDI_port, ");
+			p = MIDICSV_PutLong (p, MIDIEvent_GetNumber (pMIDIEvent));
 			break;
 		case MIDIEVENT_TEMPO:
-			lWriteLen = fprintf (pFile, "%ld, %ld, Tempo, %ld\n", 
-				lTrackIndex + 1, lTime,	MIDIEvent_GetTempo (pMIDIEvent));
+			p = MIDICSV_PutText (p, "Tempo, ");
+			p = MIDICSV_PutLong (p, MIDIEvent_GetTempo (pMIDIEvent));
 			break;
 		case MIDIEVENT_SMPTEOFFSET:
-			lWriteLen = fprintf (pFile, "%ld, %ld, SMPTE_offset, %ld, %ld, %ld, %ld, %ld\n", 
-				lTrackIndex + 1, lTime,
-				pMIDIEvent->m_pData[0], pMIDIEvent->m_pData[1], 
-				pMIDIEvent->m_pData[2], pMIDIEvent->m_pData[3],
-				pMIDIEvent->m_pData[4]);
+			p = MIDICSV_PutText (p, "SMPTE_offset");
+			p = MIDICSV_PutDataBytes (p, pData, 5);
 			break;
 		case MIDIEVENT_TIMESIGNATURE:
-			lWriteLen = fprintf (pFile, "%ld, %ld, Time_signature, %ld, %ld, %ld, %ld\n", 
-				lTrackIndex + 1, lTime,
-				pMIDIEvent->m_pData[0], pMIDIEvent->m_pData[1], 
-				pMIDIEvent->m_pData[2], pMIDIEvent->m_pData[3]);
+			p = MIDICSV_PutText (p, "Time_signature");
+			p = MIDICSV_PutDataBytes (p, pData, 4);
 			break;
 		case MIDIEVENT_KEYSIGNATURE:
-			lWriteLen = fprintf (pFile, "%ld, %ld, Key_signature, %ld, \"%s\"\n", 
-				lTrackIndex + 1, lTime,
-				CLIP (-7, (char)pMIDIEvent->m_pData[0], 7),
-				pMIDIEvent->m_pData[1] ? "minor" : "major");
+			p = MIDICSV_PutText (p, "Key_signature, ");
+			p = MIDICSV_PutLong (p, CLIP (-7, (signed char)pData[0], 7));
+			p = MIDICSV_PutText (p, pData[1] ? ", \"minor\"" : ", \"major\"");
 			break;
 		case MIDIEVENT_SEQUENCERSPECIFIC:
-			lWriteLen = fprintf (pFile, "%ld, %ld, Sequencer_specific, %ld",
-				lTrackIndex + 1, lTime, pMIDIEvent->m_lLen);
-			for (k = 0; k < pMIDIEvent->m_lLen; k++) {
-				lWriteLen = fprintf (pFile, ", %ld", pMIDIEvent->m_pData[k]);
-			}
-			lWriteLen = fprintf (pFile, "\n");
+			p = MIDICSV_PutText (p, "Sequencer_specific, ");
+			p = MIDICSV_PutLong (p, lLen);
+			p = MIDICSV_PutDataBytes (p, pData, lLen);
 			break;
 		default:
-			lWriteLen = fprintf (pFile, "%ld, %ld, Unknown_meta_event, %ld, %ld",
-				lTrackIndex + 1, lTime, pMIDIEvent->m_lKind, pMIDIEvent->m_lLen);
-			for (k = 0; k < pMIDIEvent->m_lLen; k++) {
-				lWriteLen = fprintf (pFile, ", %ld", pMIDIEvent->m_pData[k]);
-			}
-			lWriteLen = fprintf (pFile, "\n");
+			p = MIDICSV_PutText (p, "Unknown_meta_event, ");
+			p = MIDICSV_PutLong (p, pMIDIEvent->m_lKind);
+			*p++ = ',';
+			*p++ = ' ';
+			p = MIDICSV_PutLong (p, lLen);
+			p = MIDICSV_PutDataBytes (p, pData, lLen);
 			break;
 		}
+		/* テキスト系イベント */
+		if (pszName) {
+			p = MIDICSV_PutText (p, pszName);
+			p = MIDICSV_PutEscapedText (p, pData, lLen);
+			*p++ = '\"';
+		}
 	}
 	else if (MIDIEvent_IsMIDIEvent (pMIDIEvent)) {
 		switch (pMIDIEvent->m_lKind & 0xF0) {
 		case MIDIEVENT_NOTEOFF:
-			lWriteLen = fprintf (pFile, "%ld, %ld, Note_off_c, %ld, %ld, %ld\n", 
-				lTrackIndex + 1, lTime, pMIDIEvent->m_pData[0] & 0x0F,
-				pMIDIEvent->m_pData[1], pMIDIEvent->m_pData[2]);
+			p = MIDICSV_PutText (p, "Note_off_c, ");
 			break;
 		case MIDIEVENT_NOTEON:
-			lWriteLen = fprintf (pFile, "%ld, %ld, Note_on_c, %ld, %ld, %ld\n", 
-				lTrackIndex + 1, lTime, pMIDIEvent->m_pData[0] & 0x0F,
-				pMIDIEvent->m_pData[1], pMIDIEvent->m_pData[2]);
+			p = MIDICSV_PutText (p, "Note_on_c, ");
 			break;
 		case MIDIEVENT_KEYAFTERTOUCH:
-			lWriteLen = fprintf (pFile, "%ld, %ld, Poly_aftertouch_c, %ld, %ld, %ld\n", 
-				lTrackIndex + 1, lTime, pMIDIEvent->m_pData[0] & 0x0F,
-				pMIDIEvent->m_pData[1], pMIDIEvent->m_pData[2]);
+			p = MIDICSV_PutText (p, "Poly_aftertouch_c, ");
 			break;
 		case MIDIEVENT_CONTROLCHANGE:
-			lWriteLen = fprintf (pFile, "%ld, %ld, Control_c, %ld, %ld, %ld\n", 
-				lTrackIndex + 1, lTime, pMIDIEvent->m_pData[0] & 0x0F,
-				pMIDIEvent->m_pData[1], pMIDIEvent->m_pData[2]);
+			p = MIDICSV_PutText (p, "Control_c, ");
 			break;
 		case MIDIEVENT_PROGRAMCHANGE:
-			lWriteLen = fprintf (pFile, "%ld, %ld, Program_c, %ld, %ld\n", 
-				lTrackIndex + 1, lTime, pMIDIEvent->m_pData[0] & 0x0F,
-				pMIDIEvent->m_pData[1]); /* 20210710修正 */
+			p = MIDICSV_PutText (p, "Program_c, ");
 			break;
 		case MIDIEVENT_CHANNELAFTERTOUCH:
-			lWriteLen = fprintf (pFile, "%ld, %ld, Channel_aftertouch_c, %ld, %ld\n", 
-				lTrackIndex + 1, lTime, pMIDIEvent->m_pData[0] & 0x0F,
-				pMIDIEvent->m_pData[1]); /* 20210710修正 */
+			p = MIDICSV_PutText (p, "Channel_aftertouch_c, ");
 			break;
 		case MIDIEVENT_PITCHBEND:
-			lWriteLen = fprintf (pFile, "%ld, %ld, Pitch_bend_c, %ld, %ld\n", 
-				lTrackIndex + 1, lTime, pMIDIEvent->m_pData[0] & 0x0F,
-				pMIDIEvent->m_pData[2] * 128 + pMIDIEvent->m_pData[1]);
+			p = MIDICSV_PutText (p, "Pitch_bend_c, ");
 			break;
 		}
-	}
-	else if (MIDIEvent_IsSysExEvent (pMIDIEvent)) {
-		switch (pMIDIEvent->m_lKind) {
-		case MIDIEVENT_SYSEXSTART:
-			lWriteLen = fprintf (pFile, "%ld, %ld, System_exclusive, %ld",
-				lTrackIndex + 1, lTime, pMIDIEvent->m_lLen - 1);
-			for (k = 1; k < pMIDIEvent->m_lLen; k++) {
-				lWriteLen = fprintf (pFile, ", %ld", pMIDIEvent->m_pData[k]);
-			}
-			lWriteLen = fprintf (pFile, "\n");
+		p = MIDICSV_PutLong (p, pData[0] & 0x0F);
+		switch (pMIDIEvent->m_lKind & 0xF0) {
+		case MIDIEVENT_PROGRAMCHANGE:
+		case MIDIEVENT_CHANNELAFTERTOUCH:
+			p = MIDICSV_PutDataBytes (p, pData + 1, 1); /* 20210710修正 */
 			break;
-		case MIDIEVENT_SYSEXCONTINUE:
-			lWriteLen = fprintf (pFile, "%ld, %ld, System_exclusive_packet, %ld",
-				lTrackIndex + 1, lTime, pMIDIEvent->m_lLen);
-			for (k = 0; k < pMIDIEvent->m_lLen; k++) {
-				lWriteLen = fprintf (pFile, ", %ld", pMIDIEvent->m_pData[k]);
-			}
-			lWriteLen = fprintf (pFile, "\n");
+		case MIDIEVENT_PITCHBEND:
+			*p++ = ',';
+			*p++ = ' ';
+			p = MIDICSV_PutLong (p, pData[2] * 128 + pData[1]);
+			break;
+		default:
+			p = MIDICSV_PutDataBytes (p, pData + 1, 2);
 			break;
 		}
 	}
-	return lWriteLen;
+	else if (pMIDIEvent->m_lKind == MIDIEVENT_SYSEXSTART) {
+		p = MIDICSV_PutText (p, "System_exclusive, ");
+		p = MIDICSV_PutLong (p, lLen - 1);
+		p = MIDICSV_PutDataBytes (p, pData + 1, lLen - 1);
+	}
+	else {
+		p = MIDICSV_PutText (p, "System_exclusive_packet, ");
+		p = MIDICSV_PutLong (p, lLen);
+		p = MIDICSV_PutDataBytes (p, pData, lLen);
+	}
+	*p++ = '\n';
+	pWriteBuf->m_lLen += (long)(p - pBuf);
+	return 1;
 }
 
-/* MIDIデータをMIDICSVファイル(*.csv)として保存(ANSI) */
+/* MIDITrackをMIDICSV形式でStart_track行からEnd_track行まで作業用バッファの末尾に追加する(非公開)(20261019追加) */
+/* pfnWriteを指定した場合、作業用バッファがSMFWRITEBUF_FLUSHSIZEを超えるごとに書き出す。 */
 /* 戻り値：正常終了=1、異常終了=0。 */
-long __stdcall MIDIData_SaveAsMIDICSVA (MIDIData* pMIDIData, const char* pszFileName) {
-	long lWriteLen = 0;
-	MIDITrack* pMIDITrack = NULL;
+static long MIDITrack_WriteMIDICSV (MIDITrack* pMIDITrack, long lTrackIndex,
+	SMFWriteBuf* pWriteBuf, MIDIDataWriteProc pfnWrite, void* pParam) {
 	MIDIEvent* pMIDIEvent = NULL;
-	FILE* pFile = NULL;
-	errno_t nErrorNo = 0;
-	long i = 0;
-	long lXFVersion = MIDIData_GetXFVersion (pMIDIData);
+	long lLastTime = 0;
+	char* p;
+	if (pMIDITrack->m_pLastEvent) {
+		lLastTime = pMIDITrack->m_pLastEvent->m_lTime;
+	}
+	/* トラックヘッダーの保存 */
+	if (!SMFWriteBuf_Reserve (pWriteBuf, MIDICSV_MAXLINEHEADERLEN)) {
+		return 0;
+	}
+	p = (char*)(pWriteBuf->m_pBuf + pWriteBuf->m_lLen);
+	p = MIDICSV_PutLong (p, lTrackIndex + 1);
+	p = MIDICSV_PutText (p, ", 0, Start_track\n");
+	pWriteBuf->m_lLen = (long)((unsigned char*)p - pWriteBuf->m_pBuf);
+	/* 各イベントの保存(EndofTrackを除く) */
+	forEachEvent (pMIDITrack, pMIDIEvent) {
+		if (!MIDIEvent_WriteMIDICSV (pMIDIEvent, lTrackIndex, pWriteBuf)) {
+			return 0;
+		}
+		if (pfnWrite && pWriteBuf->m_lLen >= SMFWRITEBUF_FLUSHSIZE) {
+			if (!SMFWriteBuf_Flush (pWriteBuf, pfnWrite, pParam)) {
+				return 0;
+			}
+		}
+	}
+	/* トラックフッターの保存 */
+	if (!SMFWriteBuf_Reserve (pWriteBuf, MIDICSV_MAXLINEHEADERLEN)) {
+		return 0;
+	}
+	p = (char*)(pWriteBuf->m_pBuf + pWriteBuf->m_lLen);
+	p = MIDICSV_PutLong (p, lTrackIndex + 1);
+	*p++ = ',';
+	*p++ = ' ';
+	p = MIDICSV_PutLong (p, lLastTime);
+	p = MIDICSV_PutText (p, ", End_track\n");
+	pWriteBuf->m_lLen = (long)((unsigned char*)p - pWriteBuf->m_pBuf);
+	return 1;
+}
 
-	/* ファイルを開く */
-	nErrorNo = fopen_s (&pFile, pszFileName, "wb"); /* 20120108 単体の\nを扱うためwtをwbに変更 */
-	if (pFile == NULL) {
+/* MIDICSVのヘッダー行を作業用バッファに書き込む(非公開)(20261019追加) */
+static long MIDIData_WriteMIDICSVHeader (MIDIData* pMIDIData, SMFWriteBuf* pWriteBuf) {
+	char* p;
+	if (!SMFWriteBuf_Reserve (pWriteBuf, MIDICSV_MAXLINEHEADERLEN)) {
 		return 0;
 	}
+	p = (char*)(pWriteBuf->m_pBuf + pWriteBuf->m_lLen);
+	p = MIDICSV_PutText (p, "0, 0, Header, ");
+	p = MIDICSV_PutLong (p, (unsigned short)(pMIDIData->m_lFormat));
+	*p++ = ',';
+	*p++ = ' ';
+	p = MIDICSV_PutLong (p, (unsigned short)(pMIDIData->m_lNumTrack));
+	*p++ = ',';
+	*p++ = ' ';
+	p = MIDICSV_PutLong (p, (short)(pMIDIData->m_lTimeBase));
+	*p++ = '\n';
+	pWriteBuf->m_lLen = (long)((unsigned char*)p - pWriteBuf->m_pBuf);
+	return 1;
+}
 
-	/* ヘッダーの保存 */
-	lWriteLen = fprintf (pFile, "0, 0, Header, %d, %d, %d\n",
-		(unsigned short)(pMIDIData->m_lFormat),
-		(unsigned short)(pMIDIData->m_lNumTrack),
-		(short)(pMIDIData->m_lTimeBase));
-	if (lWriteLen == 0) {
-		fclose (pFile);
+/* MIDICSVのフッター行を作業用バッファに書き込む(非公開)(20261019追加) */
+static long MIDIData_WriteMIDICSVFooter (MIDIData* pMIDIData, SMFWriteBuf* pWriteBuf) {
+	static const char szFooter[] = "0, 0, End_of_file\n";
+	if (!SMFWriteBuf_Reserve (pWriteBuf, sizeof (szFooter) - 1)) {
 		return 0;
 	}
+	memcpy (pWriteBuf->m_pBuf + pWriteBuf->m_lLen, szFooter, sizeof (szFooter) - 1);
+	pWriteBuf->m_lLen += sizeof (szFooter) - 1;
+	return 1;
+}
 
-	/* 各トラックの保存 */
-	i = 0;
-	forEachTrack (pMIDIData, pMIDITrack) {
-		long lLastTime = 0;
-		if (pMIDITrack->m_pLastEvent) {
-			lLastTime = pMIDITrack->m_pLastEvent->m_lTime;
-		}
-		/* トラックヘッダーの保存 */
-		lWriteLen = fprintf (pFile, "%ld, 0, Start_track\n", i + 1);
-		if (lWriteLen == 0) {
-			fclose (pFile);
-			return 0;
-		}
-		/* 各イベントの保存(EndofTrackを除く) */
-		forEachEvent (pMIDITrack, pMIDIEvent) {
-			lWriteLen = MIDIEvent_SaveAsMIDICSV (pMIDIEvent, i, pFile);
+/* 並行保存で1つのトラックをMIDICSV形式で書き込む(非公開)(20261019追加) */
+static long MIDIData_WriteMIDICSVTrack 
+	(MIDITrack* pMIDITrack, long lTrackIndex, SMFWriteBuf* pWriteBuf, void* pTrackParam) {
+	return MIDITrack_WriteMIDICSV (pMIDITrack, lTrackIndex, pWriteBuf, NULL, NULL);
+}
+
+/* MIDIデータをMIDICSV形式で書き出し先関数へ書き出す(20261019追加) */
+/* 整数・文字列はprintf系の関数を使わずに伸長可能な作業用バッファへ直接書き込み、まとめて書き出す。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsMIDICSVToSink
+	(MIDIData* pMIDIData, MIDIDataWriteProc pfnWrite, void* pParam, MIDIDataContext* pContext) {
+	SMFWriteBuf theWriteBuf;
+	MIDITrack* pMIDITrack;
+	SYSTEM_INFO theSystemInfo;
+	long lThreadNum;
+	long lRet = 0;
+	long i = 0;
+	assert (pMIDIData);
+	assert (pfnWrite);
+	pContext = GetContext (pContext);
+
+	/* 並行保存 */
+	if ((pContext->m_lSaveFlags & MIDIDATACONTEXT_PARALLELSAVE) && pMIDIData->m_lNumTrack >= 2) {
+		GetSystemInfo (&theSystemInfo);
+		lThreadNum = CLIP (1, (long)(theSystemInfo.dwNumberOfProcessors), MIDIDATA_MAXSAVETHREADNUM);
+		lThreadNum = MIN (lThreadNum, pMIDIData->m_lNumTrack);
+		if (lThreadNum >= 2) {
+			return MIDIData_SaveParallel (pMIDIData, lThreadNum, MIDIData_WriteMIDICSVTrack, NULL,
+				MIDIData_WriteMIDICSVHeader, MIDIData_WriteMIDICSVFooter, pfnWrite, pParam, pContext);
 		}
-		/* トラックフッターの保存 */
-		lWriteLen = fprintf (pFile, "%ld, %ld, End_track\n", i + 1, lLastTime);
-		if (lWriteLen == 0) {
-			fclose (pFile);
-			return 0;
+	}
+
+	/* 1つの作業用バッファを使い回し、SMFWRITEBUF_FLUSHSIZEを超えたらまとめて書き出す */
+	memset (&theWriteBuf, 0, sizeof (SMFWriteBuf));
+	theWriteBuf.m_pContext = pContext;
+	if (!MIDIData_WriteMIDICSVHeader (pMIDIData, &theWriteBuf)) {
+		goto exit;
+	}
+	forEachTrack (pMIDIData, pMIDITrack) {
+		if (!MIDITrack_WriteMIDICSV (pMIDITrack, i, &theWriteBuf, pfnWrite, pParam)) {
+			goto exit;
 		}
 		i++;
 	}
-
-	/* フッターの保存 */
-	lWriteLen = fprintf (pFile, "0, 0, End_of_file\n");
-	if (lWriteLen == 0) {
-		fclose (pFile);
-		return 0;
+	if (!MIDIData_WriteMIDICSVFooter (pMIDIData, &theWriteBuf) ||
+		!SMFWriteBuf_Flush (&theWriteBuf, pfnWrite, pParam)) {
+		goto exit;
 	}
-	fclose (pFile);
-	return 1;
+	lRet = 1;
+
+	exit:
+	SMFWriteBuf_Free (&theWriteBuf);
+	return lRet;
+}
+
+/* MIDIデータをMIDICSVファイル(*.csv)として保存(ANSI) */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsMIDICSVA (MIDIData* pMIDIData, const char* pszFileName) {
+	return MIDIData_SaveAsMIDICSVExA (pMIDIData, pszFileName, NULL);
 }
 
 /* MIDIデータをMIDICSVファイル(*.csv)として保存(UNICODE) */
 /* ファイル名はUNICODEで与えるがファイルの中身は仕様に基づきANSIである。 */
 /* 戻り値：正常終了=1、異常終了=0。 */
 long __stdcall MIDIData_SaveAsMIDICSVW (MIDIData* pMIDIData, const wchar_t* pszFileName) {
-	long lWriteLen = 0;
-	MIDITrack* pMIDITrack = NULL;
-	MIDIEvent* pMIDIEvent = NULL;
-	FILE* pFile = NULL;
-	errno_t nErrorNo = 0;
-	long i = 0;
-	long lXFVersion = MIDIData_GetXFVersion (pMIDIData);
+	return MIDIData_SaveAsMIDICSVExW (pMIDIData, pszFileName, NULL);
+}
 
-	/* ファイルを開く */
-	nErrorNo = _wfopen_s (&pFile, pszFileName, L"wb"); /* 20120108 単体の\nを扱うためwtをwbに変更 */
-	if (pFile == NULL) {
+/* MIDIデータをMIDICSVファイル(*.csv)として保存(コンテキスト指定)(ANSI)(20261019追加) */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsMIDICSVExA
+(MIDIData* pMIDIData, const char* pszFileName, MIDIDataContext* pContext) {
+	MIDIDataStream theStream;
+	long lRet = 0;
+	if (MIDIDataStream_OpenFileA (&theStream, pszFileName, "wb") == 0) {
 		return 0;
 	}
+	lRet = MIDIData_SaveAsMIDICSVToSink (pMIDIData, MIDIDataStream_WriteProc, &theStream, pContext);
+	MIDIDataStream_Close (&theStream);
+	return lRet;
+}
 
-	/* ヘッダーの保存 */
-	lWriteLen = fprintf (pFile, "0, 0, Header, %d, %d, %d\n",
-		(unsigned short)(pMIDIData->m_lFormat),
-		(unsigned short)(pMIDIData->m_lNumTrack),
-		(short)(pMIDIData->m_lTimeBase));
-	if (lWriteLen == 0) {
-		fclose (pFile);
+/* MIDIデータをMIDICSVファイル(*.csv)として保存(コンテキスト指定)(UNICODE)(20261019追加) */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsMIDICSVExW
+(MIDIData* pMIDIData, const wchar_t* pszFileName, MIDIDataContext* pContext) {
+	MIDIDataStream theStream;
+	long lRet = 0;
+	if (MIDIDataStream_OpenFileW (&theStream, pszFileName, L"wb") == 0) {
 		return 0;
 	}
+	lRet = MIDIData_SaveAsMIDICSVToSink (pMIDIData, MIDIDataStream_WriteProc, &theStream, pContext);
+	MIDIDataStream_Close (&theStream);
+	return lRet;
+}
 
-	/* 各トラックの保存 */
-	i = 0;
-	forEachTrack (pMIDIData, pMIDITrack) {
-		long lLastTime = 0;
-		if (pMIDITrack->m_pLastEvent) {
-			lLastTime = pMIDITrack->m_pLastEvent->m_lTime;
-		}
-		/* トラックヘッダーの保存 */
-		lWriteLen = fprintf (pFile, "%ld, 0, Start_track\n", i + 1);
-		if (lWriteLen == 0) {
-			fclose (pFile);
-			return 0;
-		}
-		/* 各イベントの保存(EndofTrackを除く) */
-		forEachEvent (pMIDITrack, pMIDIEvent) {
-			lWriteLen = MIDIEvent_SaveAsMIDICSV (pMIDIEvent, i, pFile);
-		}
-		/* トラックフッターの保存 */
-		lWriteLen = fprintf (pFile, "%ld, %ld, End_track\n", i + 1, lLastTime);
-		if (lWriteLen == 0) {
-			fclose (pFile);
-			return 0;
-		}
-		i++;
-	}
-
-	/* フッターの保存 */
-	lWriteLen = fprintf (pFile, "0, 0, End_of_file\n");
-	if (lWriteLen == 0) {
-		fclose (pFile);
+/* MIDIデータをMIDICSVファイル(*.csv)として保存(メモリブロック)(20261019追加) */
+/* 保存したデータは*ppDataに、その長さは*pLenに返す。*ppDataはMIDIDataLib_FreeMemoryで解放すること。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsMIDICSVMemory (MIDIData* pMIDIData, void** ppData, long* pLen) {
+	MIDIDataStream theStream;
+	MIDIDataStream_CreateMemory (&theStream, 0);
+	if (MIDIData_SaveAsMIDICSVToSink (pMIDIData, MIDIDataStream_WriteProc, &theStream, NULL) == 0) {
+		MIDIDataStream_Close (&theStream);
 		return 0;
 	}
-	fclose (pFile);
-	return 1;
+	return MIDIDataStream_DetachMemory (&theStream, ppData, pLen);
 }
 
 
@@ -15142,31 +15998,22 @@ long MIDIData_PostReadWRK (MIDIData* pMIDIData) {
 	return 1;
 }
 
-/* MIDIデータを旧Cakewalkシーケンスファイル(*.wrk)から読み込み(ANSI) */
-/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
-MIDIData* __stdcall MIDIData_LoadFromWRKA (const char* pszFileName) {
-	FILE* pFile = NULL;
-	errno_t nErrorNo = 0;
+/* MIDIデータを旧Cakewalkシーケンスファイル(*.wrk)から読み込み */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(非公開)(20261019追加) */
+static MIDIData* MIDIData_LoadFromWRKStream (MIDIDataStream* pStream) {
 	BYTE byData[2048];
 	MIDIData* pMIDIData = NULL;
 	BYTE byChunkType = 0;
 	long lChunkLen = 0;
 	BYTE* pChunkData = NULL;
 
-	/* ファイルを開く */
-	nErrorNo = fopen_s (&pFile, pszFileName, "rb");
-	if (pFile == NULL) {
-		return NULL;
-	}
 
 	/* 11バイト読み込み */
-	if (fread (byData, 1, 11, pFile) < 11) {
-		fclose (pFile);
+	if (MIDIDataStream_Read (byData, 1, 11, pStream) < 11) {
 		return NULL;
 	}
 
 	if (strncmp (byData, "CAKEWALK", 8) != 0) {
-		fclose (pFile);
 		return NULL;
 	}
 
@@ -15174,29 +16021,25 @@ MIDIData* __stdcall MIDIData_LoadFromWRKA (const char* pszFileName) {
 
 	pMIDIData = MIDIData_Create (1, 1, MIDIDATA_TPQNBASE, 120);
 	if (pMIDIData == NULL) {
-		fclose (pFile);
 		return NULL;
 	}
 
 	while (1) {
-		if (fread (&byChunkType, 1, 1, pFile) < 1) {
-			fclose (pFile);
+		if (MIDIDataStream_Read (&byChunkType, 1, 1, pStream) < 1) {
 			break;
 		}
 		if (byChunkType == 255) { /* EndofChunk */
 			break;
 		}
-		if (fread (&lChunkLen, 4, 1, pFile) < 1) {
-			fclose (pFile);
+		if (MIDIDataStream_Read (&lChunkLen, 4, 1, pStream) < 1) {
 			break;
 		}
 		pChunkData = malloc (lChunkLen);
 		if (pChunkData == NULL) {
-			fclose (pFile);
 			break;
 		}
 		memset (pChunkData, 0, lChunkLen);
-		if (fread (pChunkData, 1, lChunkLen, pFile) < lChunkLen) {
+		if (MIDIDataStream_Read (pChunkData, 1, lChunkLen, pStream) < lChunkLen) {
 			free (pChunkData);
 			pChunkData = NULL;
 			break;
@@ -15209,82 +16052,47 @@ MIDIData* __stdcall MIDIData_LoadFromWRKA (const char* pszFileName) {
 		free (pChunkData);
 		pChunkData = NULL;
 	}
-	fclose (pFile);
 	MIDIData_PostReadWRK (pMIDIData);
 	return pMIDIData;
 }
 
-/* MIDIデータを旧Cakewalkシーケンスファイル(*.wrk)から読み込み(UNICODE) */
-/* ファイル名はUNICODEで与えるがファイルの中身は仕様に基づきANSIである。 */
+/* MIDIデータを旧Cakewalkシーケンスファイル(*.wrk)から読み込み(ANSI) */
 /* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
-MIDIData* __stdcall MIDIData_LoadFromWRKW (const wchar_t* pszFileName) {
-	FILE* pFile = NULL;
-	errno_t nErrorNo = 0;
-	BYTE byData[2048];
+MIDIData* __stdcall MIDIData_LoadFromWRKA (const char* pszFileName) {
+	MIDIDataStream theStream;
 	MIDIData* pMIDIData = NULL;
-	BYTE byChunkType = 0;
-	long lChunkLen = 0;
-	BYTE* pChunkData = NULL;
-
-	/* ファイルを開く */
-	nErrorNo = _wfopen_s (&pFile, pszFileName, L"rb");
-	if (pFile == NULL) {
-		return NULL;
-	}
-
-	/* 11バイト読み込み */
-	if (fread (byData, 1, 11, pFile) < 11) {
-		fclose (pFile);
+	if (MIDIDataStream_OpenFileA (&theStream, pszFileName, "rb") == 0) {
 		return NULL;
 	}
+	pMIDIData = MIDIData_LoadFromWRKStream (&theStream);
+	MIDIDataStream_Close (&theStream);
+	return pMIDIData;
+}
 
-	if (strncmp (byData, "CAKEWALK", 8) != 0) {
-		fclose (pFile);
+/* MIDIデータを旧Cakewalkシーケンスファイル(*.wrk)から読み込み(UNICODE) */
+/* ファイル名はUNICODEで与えるがファイルの中身は仕様に基づきANSIである。 */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+MIDIData* __stdcall MIDIData_LoadFromWRKW (const wchar_t* pszFileName) {
+	MIDIDataStream theStream;
+	MIDIData* pMIDIData = NULL;
+	if (MIDIDataStream_OpenFileW (&theStream, pszFileName, L"rb") == 0) {
 		return NULL;
 	}
+	pMIDIData = MIDIData_LoadFromWRKStream (&theStream);
+	MIDIDataStream_Close (&theStream);
+	return pMIDIData;
+}
 
-	_RPTF2 (_CRT_WARN, "CAKEWALK%d.%d Recognized.\n", byData[10], byData[9]);
-
-	pMIDIData = MIDIData_Create (1, 1, MIDIDATA_TPQNBASE, 120);
-	if (pMIDIData == NULL) {
-		fclose (pFile);
+/* MIDIデータを旧Cakewalkシーケンスファイル(*.wrk)から読み込み(メモリブロック)(20261019追加) */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+MIDIData* __stdcall MIDIData_LoadFromWRKMemory (const void* pData, long lLen) {
+	MIDIDataStream theStream;
+	/* 引数の検査 */
+	if (pData == NULL || lLen < 0) {
 		return NULL;
 	}
-
-	while (1) {
-		if (fread (&byChunkType, 1, 1, pFile) < 1) {
-			fclose (pFile);
-			break;
-		}
-		if (byChunkType == 255) { /* EndofChunk */
-			break;
-		}
-		if (fread (&lChunkLen, 4, 1, pFile) < 1) {
-			fclose (pFile);
-			break;
-		}
-		pChunkData = malloc (lChunkLen);
-		if (pChunkData == NULL) {
-			fclose (pFile);
-			break;
-		}
-		memset (pChunkData, 0, lChunkLen);
-		if (fread (pChunkData, 1, lChunkLen, pFile) < lChunkLen) {
-			free (pChunkData);
-			pChunkData = NULL;
-			break;
-		}
-		if (MIDIData_ReadWRKChunk (pMIDIData, (long)byChunkType, pChunkData, lChunkLen) == 0) {
-			free (pChunkData);
-			pChunkData = NULL;
-			break;
-		}
-		free (pChunkData);
-		pChunkData = NULL;
-	}
-	fclose (pFile);
-	MIDIData_PostReadWRK (pMIDIData);
-	return pMIDIData;
+	MIDIDataStream_OpenMemory (&theStream, pData, lLen, 0);
+	return MIDIData_LoadFromWRKStream (&theStream);
 }
 
 
@@ -15603,57 +16411,46 @@ long MIDIData_PostReadMabiMML (MIDIData* pMIDIData) {
 	return 1;
 }
 
-/* MIDIデータをMabinogiMML(*.mmml)から読み込み(ANSI) */
-/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
-MIDIData* __stdcall MIDIData_LoadFromMabiMMLA (const char* pszFileName) {
-	FILE* pFile = NULL;
-	errno_t nErrorNo = 0;
+/* MIDIデータをMabinogiMML(*.mmml)から読み込み */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(非公開)(20261019追加) */
+static MIDIData* MIDIData_LoadFromMabiMMLStream (MIDIDataStream* pStream) {
 	BYTE byData[2048];
 	MIDIData* pMIDIData = NULL;
 	long lTextLen = 0;
 	BYTE* pszText = NULL;
 
-	/* ファイルを開く */
-	nErrorNo = fopen_s (&pFile, pszFileName, "rb");
-	if (pFile == NULL) {
-		return NULL;
-	}
 
 	/* 4バイト読み込み */
-	if (fread (byData, 1, 4, pFile) < 4) {
-		fclose (pFile);
+	if (MIDIDataStream_Read (byData, 1, 4, pStream) < 4) {
 		return NULL;
 	}
 
 	/* MML@の読み込み(なくても可) */
 	if (strncmp (byData, "MML@", 4) != 0) {
 		_RPTF0 (_CRT_WARN, "MML@ Omitted.\n");
-		fseek (pFile, 0L, SEEK_END);
-		lTextLen = ftell (pFile);
-		fseek (pFile, 0L, SEEK_SET);
+		MIDIDataStream_Seek (pStream, 0L, SEEK_END);
+		lTextLen = MIDIDataStream_Tell (pStream);
+		MIDIDataStream_Seek (pStream, 0L, SEEK_SET);
 	}
 	else {
 		_RPTF0 (_CRT_WARN, "MML@ Recognized.\n");
-		fseek (pFile, 0L, SEEK_END);
-		lTextLen = ftell (pFile) - 4;
-		fseek (pFile, 4L, SEEK_SET);
+		MIDIDataStream_Seek (pStream, 0L, SEEK_END);
+		lTextLen = MIDIDataStream_Tell (pStream) - 4;
+		MIDIDataStream_Seek (pStream, 4L, SEEK_SET);
 	}
 	
 	pMIDIData = MIDIData_Create (1, 2, MIDIDATA_TPQNBASE, 96);
 	if (pMIDIData == NULL) {
-		fclose (pFile);
 		return NULL;
 	}
 
 	pszText = malloc (lTextLen + 1);
 	if (pszText == NULL) {
 		MIDIData_Delete (pMIDIData);
-		fclose (pFile);
 		return NULL;
 	}
 	memset (pszText, 0, lTextLen + 1);
-	fread (pszText, 1, lTextLen, pFile);
-	fclose (pFile);
+	MIDIDataStream_Read (pszText, 1, lTextLen, pStream);
 
 	MIDIData_ReadMabiMMLA (pMIDIData, pszText);
 
@@ -15666,61 +16463,38 @@ MIDIData* __stdcall MIDIData_LoadFromMabiMMLA (const char* pszFileName) {
 
 /* MIDIデータをMabinogiMML(*.mmml)から読み込み(ANSI) */
 /* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
-MIDIData* __stdcall MIDIData_LoadFromMabiMMLW (const wchar_t* pszFileName) {
-	FILE* pFile = NULL;
-	errno_t nErrorNo = 0;
-	BYTE byData[2048];
+MIDIData* __stdcall MIDIData_LoadFromMabiMMLA (const char* pszFileName) {
+	MIDIDataStream theStream;
 	MIDIData* pMIDIData = NULL;
-	long lTextLen = 0;
-	BYTE* pszText = NULL;
-
-	/* ファイルを開く */
-	nErrorNo = _wfopen_s (&pFile, pszFileName, L"rb");
-	if (pFile == NULL) {
-		return NULL;
-	}
-
-	/* 4バイト読み込み */
-	if (fread (byData, 1, 4, pFile) < 4) {
-		fclose (pFile);
+	if (MIDIDataStream_OpenFileA (&theStream, pszFileName, "rb") == 0) {
 		return NULL;
 	}
+	pMIDIData = MIDIData_LoadFromMabiMMLStream (&theStream);
+	MIDIDataStream_Close (&theStream);
+	return pMIDIData;
+}
 
-	/* MML@の読み込み(なくても可) */
-	if (strncmp (byData, "MML@", 4) != 0) {
-		_RPTF0 (_CRT_WARN, "MML@ Omitted.\n");
-		fseek (pFile, 0L, SEEK_END);
-		lTextLen = ftell (pFile);
-		fseek (pFile, 0L, SEEK_SET);
-	}
-	else {
-		_RPTF0 (_CRT_WARN, "MML@ Recognized.\n");
-		fseek (pFile, 0L, SEEK_END);
-		lTextLen = ftell (pFile) - 4;
-		fseek (pFile, 4L, SEEK_SET);
-	}
-	
-	pMIDIData = MIDIData_Create (1, 2, MIDIDATA_TPQNBASE, 96);
-	if (pMIDIData == NULL) {
-		fclose (pFile);
+/* MIDIデータをMabinogiMML(*.mmml)から読み込み(ANSI) */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+MIDIData* __stdcall MIDIData_LoadFromMabiMMLW (const wchar_t* pszFileName) {
+	MIDIDataStream theStream;
+	MIDIData* pMIDIData = NULL;
+	if (MIDIDataStream_OpenFileW (&theStream, pszFileName, L"rb") == 0) {
 		return NULL;
 	}
+	pMIDIData = MIDIData_LoadFromMabiMMLStream (&theStream);
+	MIDIDataStream_Close (&theStream);
+	return pMIDIData;
+}
 
-	pszText = malloc (lTextLen + 1);
-	if (pszText == NULL) {
-		MIDIData_Delete (pMIDIData);
-		fclose (pFile);
+/* MIDIデータをMabinogiMML(*.mmml)から読み込み(メモリブロック)(20261019追加) */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+MIDIData* __stdcall MIDIData_LoadFromMabiMMLMemory (const void* pData, long lLen) {
+	MIDIDataStream theStream;
+	/* 引数の検査 */
+	if (pData == NULL || lLen < 0) {
 		return NULL;
 	}
-	memset (pszText, 0, lTextLen + 1);
-	fread (pszText, 1, lTextLen, pFile);
-	fclose (pFile);
-
-	MIDIData_ReadMabiMMLA (pMIDIData, pszText);
-
-	free (pszText);
-
-	MIDIData_PostReadMabiMML (pMIDIData);
-
-	return pMIDIData;
+	MIDIDataStream_OpenMemory (&theStream, pData, lLen, 0);
+	return MIDIData_LoadFromMabiMMLStream (&theStream);
 }
@@ -28,6 +28,9 @@
 #ifndef _MIDIData_H_
 #define _MIDIData_H_
 
+/* int64_tの定義(20261019追加) */
+#include <stdint.h>
+
 /* C++からも使用可能とする */
 #ifdef __cplusplus
 extern "C" {
@@ -134,9 +137,131 @@ typedef struct tagMIDIData {
 	void* m_pUser4;                     /* ユーザー用自由領域4(未使用) */
 } MIDIData;
 
+/* 作業用メモリの確保・解放関数の型(20261019追加) */
+typedef void* (__stdcall *MIDIDataContextAllocProc) (void* pParam, long lSize);
+typedef void (__stdcall *MIDIDataContextFreeProc) (void* pParam, void* pBuf);
+
+/* MIDIDataContext構造体(20261019追加) */
+/* 文字コードの変換・読み込み・保存の設定を保持する。スレッドごとに別のコンテキストを */
+/* 用いれば、他のスレッドの設定に影響されずに並行して読み込み・保存・変換ができる。 */
+typedef struct tagMIDIDataContext {
+	long m_lDefaultCharCode;            /* デフォルト文字コード(MIDIEVENT_NOCHARCODE=システム既定) */
+	long m_lLoadFlags;                  /* 読み込みオプション(MIDIDATACONTEXT_STRICT等の組み合わせ) */
+	MIDIDataContextAllocProc m_pfnAlloc; /* 作業用メモリの確保関数(NULL=malloc) */
+	MIDIDataContextFreeProc m_pfnFree;  /* 作業用メモリの解放関数(NULL=free) */
+	void* m_pAllocParam;                /* 確保・解放関数に渡す値 */
+	long m_lSaveFlags;                  /* 保存オプション(MIDIDATACONTEXT_PARALLELSAVE等の組み合わせ) */
+} MIDIDataContext;
+
+/* SMFの書き出し先関数の型(20261019追加) */
+/* pDataからlLenバイトを書き出し、書き出したバイト数を返す(lLen未満を返すと保存は失敗する) */
+typedef long (__stdcall *MIDIDataWriteProc) (void* pParam, const void* pData, long lLen);
+
+/* キャッシュディレクトリ名の最大長(20261019追加) */
+#define MIDIDATACACHE_MAXPATH 260
+
+/* MIDIデータスナップショット(*.mds)のヘッダー(20261019追加) */
+/* スナップショットはヘッダー・トラック索引・各トラックのイベント配列とデータ領域を */
+/* 連続して並べた形式で、ポインタを含まない。位置は全てスナップショットの先頭からの */
+/* バイト数で表し、各部分はMIDIDATASNAPSHOT_ALIGNバイト境界に置く。そのため、 */
+/* ファイルをメモリにマップしたまま解析せずに読み取り専用で参照できる。 */
+typedef struct tagMIDIDataSnapshotHeader {
+	char m_szType[4];                   /* 種類("MDsn") */
+	long m_lVersion;                    /* 版(MIDIDATASNAPSHOT_VERSION) */
+	long m_lHeaderSize;                 /* ヘッダーの長さ[バイト] */
+	long m_lTrackSize;                  /* トラック索引の1項目の長さ[バイト] */
+	long m_lEventSize;                  /* イベント配列の1項目の長さ[バイト] */
+	long m_lTotalSize;                  /* スナップショット全体の長さ[バイト] */
+	long m_lFormat;                     /* SMFフォーマット(0/1/2) */
+	long m_lNumTrack;                   /* トラック数 */
+	long m_lTimeBase;                   /* タイムベース */
+	long m_lTrackOffset;                /* トラック索引の位置[バイト] */
+	long m_lReserved1;                  /* MIDIDataの予約領域1 */
+	long m_lReserved2;                  /* MIDIDataの予約領域2 */
+	long m_lReserved3;                  /* MIDIDataの予約領域3 */
+	long m_lReserved4;                  /* MIDIDataの予約領域4 */
+	long m_lUser1;                      /* MIDIDataのユーザー用自由領域1 */
+	long m_lUser2;                      /* MIDIDataのユーザー用自由領域2 */
+	long m_lUser3;                      /* MIDIDataのユーザー用自由領域3 */
+	long m_lUserFlag;                   /* MIDIDataのユーザー用自由領域4 */
+} MIDIDataSnapshotHeader;
+
+/* MIDIデータスナップショットのトラック索引の項目(20261019追加) */
+typedef struct tagMIDIDataSnapshotTrack {
+	long m_lNumEvent;                   /* イベント数 */
+	long m_lEventOffset;                /* イベント配列の位置[バイト] */
+	long m_lDataOffset;                 /* データ領域の位置[バイト] */
+	long m_lDataLen;                    /* データ領域の長さ[バイト] */
+	long m_lInputOn;                    /* 以下MIDITrackの同名のメンバと同じ */
+	long m_lInputPort;
+	long m_lInputChannel;
+	long m_lOutputOn;
+	long m_lOutputPort;
+	long m_lOutputChannel;
+	long m_lTimePlus;
+	long m_lKeyPlus;
+	long m_lVelocityPlus;
+	long m_lViewMode;
+	long m_lForeColor;
+	long m_lBackColor;
+	long m_lReserved1;
+	long m_lReserved2;
+	long m_lReserved3;
+	long m_lReserved4;
+	long m_lUser1;
+	long m_lUser2;
+	long m_lUser3;
+	long m_lUserFlag;
+} MIDIDataSnapshotTrack;
+
+/* MIDIデータスナップショットのイベント配列の項目(20261019追加) */
+typedef struct tagMIDIDataSnapshotEvent {
+	long m_lTime;                       /* 絶対時刻[tick] */
+	long m_lKind;                       /* イベントの種類(0x00～0xFF) */
+	long m_lLen;                        /* データの長さ[バイト] */
+	long m_lDataOffset;                 /* データの位置(トラックのデータ領域の先頭から)[バイト] */
+	long m_lPrevCombinedEvent;          /* 前の結合イベントのトラック内インデックス(なければ-1) */
+	long m_lNextCombinedEvent;          /* 次の結合イベントのトラック内インデックス(なければ-1) */
+	long m_lUser1;                      /* 以下MIDIEventの同名のメンバと同じ */
+	long m_lUser2;
+	long m_lUser3;
+	long m_lUserFlag;
+} MIDIDataSnapshotEvent;
+
+/* 開いたMIDIデータスナップショット(20261019追加) */
+/* MIDIDataSnapshot_Open～で開き、MIDIDataSnapshot_Closeで閉じる。 */
+typedef struct tagMIDIDataSnapshot {
+	const unsigned char* m_pData;       /* スナップショットの先頭 */
+	long m_lLen;                        /* スナップショットの長さ[バイト] */
+	const MIDIDataSnapshotHeader* m_pHeader; /* ヘッダー */
+	const MIDIDataSnapshotTrack* m_pTrack; /* トラック索引の先頭 */
+	void* m_hFile;                      /* マップしたファイルのハンドル(メモリの場合NULL) */
+	void* m_hMapping;                   /* ファイルマッピングのハンドル(メモリの場合NULL) */
+} MIDIDataSnapshot;
+
+/* MIDIDataCache構造体(20261019追加) */
+/* 読み込んだ曲をスナップショットとしてキャッシュディレクトリに保存しておき、同じ内容の */
+/* データの2回目以降の読み込みでは解析を省く。キーは元のデータの内容のハッシュ値である。 */
+/* 1つのキャッシュを複数のスレッドから同時に使わないこと(スレッドごとに生成したキャッシュ */
+/* 同士、又は他のプロセスとは、同じキャッシュディレクトリを共有してよい)。 */
+typedef struct tagMIDIDataCache {
+	wchar_t m_szDirName[MIDIDATACACHE_MAXPATH]; /* キャッシュディレクトリ名 */
+	long m_lMaxSize;                    /* キャッシュの合計の長さの上限[KB] */
+	long m_lHitCount;                   /* キャッシュから読み込んだ回数 */
+	long m_lMissCount;                  /* 元のデータを解析した回数 */
+	int64_t m_llTotalSize;              /* キャッシュの合計の長さ(概算)[バイト] */
+} MIDIDataCache;
+
 /* その他のマクロ */
 #define MIDIEVENT_MAXLEN       65536
 
+/* 読み込みオプションに関するマクロ(20261019追加) */
+#define MIDIDATACONTEXT_STRICT        0x00000001 /* 不正なデータを補正せずに読み込みを失敗させる */
+#define MIDIDATACONTEXT_NOAUTOSETTING 0x00000002 /* 読み込み後の出力ポート・出力チャンネル・表示モードの自動設定を省略 */
+
+/* 保存オプションに関するマクロ(20261019追加) */
+#define MIDIDATACONTEXT_PARALLELSAVE  0x00000001 /* 各トラックを複数のスレッドで並行して符号化する */
+
 /* フォーマットに関するマクロ */
 #define MIDIDATA_FORMAT0       0x00 /* フォーマット0 */
 #define MIDIDATA_FORMAT1       0x01 /* フォーマット1 */
@@ -151,6 +276,19 @@ typedef struct tagMIDIData {
 /* トラック数に関するマクロ */
 #define MIDIDATA_MAXMIDITRACKNUM 65535
 
+/* スナップショットに関するマクロ(20261019追加) */
+#define MIDIDATASNAPSHOT_VERSION 1 /* 現在の版 */
+#define MIDIDATASNAPSHOT_ALIGN   8 /* 各部分の配置境界[バイト] */
+
+/* キャッシュを通じて読み込むデータの形式に関するマクロ(20261019追加) */
+#define MIDIDATACACHE_SMF      0 /* スタンダードMIDIファイル(*.mid) */
+#define MIDIDATACACHE_TEXT     1 /* テキストファイル */
+#define MIDIDATACACHE_BINARY   2 /* バイナリファイル */
+#define MIDIDATACACHE_CHERRY   3 /* Cherryファイル(*.chy) */
+#define MIDIDATACACHE_MIDICSV  4 /* MIDICSVファイル(*.csv) */
+#define MIDIDATACACHE_WRK      5 /* Cakewalkファイル(*.wrk) */
+#define MIDIDATACACHE_MABIMML  6 /* マビノギMMLファイル(*.mml) */
+
 /* タイムモードに関するマクロ */
 #define MIDIDATA_TPQNBASE      0  /* TPQNベース */
 #define MIDIDATA_SMPTE24BASE   24 /* 24フレーム/秒 */
@@ -270,6 +408,9 @@ for((pEvent)=(pTrack)->m_pLastEvent;(pEvent);(pEvent)=(pEvent)->m_pPrevEvent)
 /* デフォルト文字コードの設定 */
 long __stdcall MIDIDataLib_SetDefaultCharCode (long lCharCode);
 
+/* ...Memory関数が返したメモリブロックの解放(20261019追加) */
+void __stdcall MIDIDataLib_FreeMemory (void* pData);
+
 /* ロケールの設定(20140517無効化) */
 char* __stdcall MIDIDataLib_SetLocaleA (int nCategory, const char *pszLocale);
 wchar_t* __stdcall MIDIDataLib_SetLocaleW (int nCategory, const wchar_t* pszLocale);
@@ -279,6 +420,47 @@ wchar_t* __stdcall MIDIDataLib_SetLocaleW (int nCategory, const wchar_t* pszLoca
 #define MIDIDataLib_SetLocale MIDIDataLib_SetLocaleA
 #endif
 
+/******************************************************************************/
+/*                                                                            */
+/*　MIDIDataContextクラス関数(20261019追加)                                   */
+/*                                                                            */
+/******************************************************************************/
+
+/* Ex版の関数にはコンテキストを渡す。NULLを渡した場合は既定のコンテキスト */
+/* (MIDIDataLib_SetDefaultCharCodeで設定するもの)を用いる。 */
+/* 作業用メモリの確保・解放関数は、読み込み・保存中の一時バッファにのみ用いる。 */
+/* (MIDIEvent・MIDITrack・MIDIDataの本体は常にmalloc・freeで確保・解放する) */
+
+/* コンテキストの削除 */
+void __stdcall MIDIDataContext_Delete (MIDIDataContext* pContext);
+
+/* コンテキストの生成(設定は既定のコンテキストの現在の設定を引き継ぐ) */
+MIDIDataContext* __stdcall MIDIDataContext_Create ();
+
+/* デフォルト文字コードの取得 */
+long __stdcall MIDIDataContext_GetDefaultCharCode (MIDIDataContext* pContext);
+
+/* デフォルト文字コードの設定 */
+long __stdcall MIDIDataContext_SetDefaultCharCode (MIDIDataContext* pContext, long lCharCode);
+
+/* 読み込みオプションの取得 */
+long __stdcall MIDIDataContext_GetLoadFlags (MIDIDataContext* pContext);
+
+/* 読み込みオプションの設定 */
+long __stdcall MIDIDataContext_SetLoadFlags (MIDIDataContext* pContext, long lLoadFlags);
+
+/* 保存オプションの取得(20261019追加) */
+long __stdcall MIDIDataContext_GetSaveFlags (MIDIDataContext* pContext);
+
+/* 保存オプションの設定(20261019追加) */
+/* MIDIDATACONTEXT_PARALLELSAVEを指定した場合、作業用メモリの確保・解放関数は */
+/* 複数のスレッドから同時に呼ばれることがある。 */
+long __stdcall MIDIDataContext_SetSaveFlags (MIDIDataContext* pContext, long lSaveFlags);
+
+/* 作業用メモリの確保・解放関数の設定(両方NULLの場合はmalloc・freeに戻す) */
+long __stdcall MIDIDataContext_SetAllocator (MIDIDataContext* pContext,
+	MIDIDataContextAllocProc pfnAlloc, MIDIDataContextFreeProc pfnFree, void* pParam);
+
 /******************************************************************************/
 /*                                                                            */
 /*　MIDIEventクラス関数                                                       */
@@ -298,6 +480,9 @@ MIDIEvent* __stdcall MIDIEvent_GetLastCombinedEvent (MIDIEvent* pEvent);
 /* 単体イベントを結合する */
 long __stdcall MIDIEvent_Combine (MIDIEvent* pEvent);
 
+/* ノートオンイベントとノートオフイベントを指定して結合する(20261019追加) */
+long __stdcall MIDIEvent_CombineNoteOnOff (MIDIEvent* pNoteOnEvent, MIDIEvent* pNoteOffEvent);
+
 /* 結合イベントを切り離す */
 long __stdcall MIDIEvent_Chop (MIDIEvent* pEvent);
 
@@ -769,6 +954,8 @@ long __stdcall MIDIEvent_GetCharCode (MIDIEvent* pMIDIEvent);
 /* イベントの文字コードを設定(テキスト・著作権・トラック名・インストゥルメント名・ */
 /* 歌詞・マーカー・キューポイント・プログラム名・デバイス名のみ) */
 long __stdcall MIDIEvent_SetCharCode (MIDIEvent* pMIDIEvent, long lCharCode);
+long __stdcall MIDIEvent_SetCharCodeEx
+	(MIDIEvent* pMIDIEvent, long lCharCode, MIDIDataContext* pContext); /* 20261019追加 */
 
 /* イベントのテキストを取得(テキスト・著作権・トラック名・インストゥルメント名・ */
 /* 歌詞・マーカー・キューポイント・プログラム名・デバイス名のみ) */
@@ -779,6 +966,15 @@ wchar_t* __stdcall MIDIEvent_GetTextW (MIDIEvent* pEvent, wchar_t* pBuf, long lL
 #else
 #define MIDIEvent_GetText MIDIEvent_GetTextA
 #endif
+char* __stdcall MIDIEvent_GetTextExA
+	(MIDIEvent* pEvent, char* pBuf, long lLen, MIDIDataContext* pContext); /* 20261019追加 */
+wchar_t* __stdcall MIDIEvent_GetTextExW
+	(MIDIEvent* pEvent, wchar_t* pBuf, long lLen, MIDIDataContext* pContext); /* 20261019追加 */
+#ifdef UNICODE
+#define MIDIEvent_GetTextEx MIDIEvent_GetTextExW
+#else
+#define MIDIEvent_GetTextEx MIDIEvent_GetTextExA
+#endif
 
 /* イベントのテキストを設定(テキスト・著作権・トラック名・インストゥルメント名・ */
 /* 歌詞・マーカー・キューポイント・プログラム名・デバイス名のみ) */
@@ -789,6 +985,15 @@ long __stdcall MIDIEvent_SetTextW (MIDIEvent* pEvent, const wchar_t* pszText);
 #else
 #define MIDIEvent_SetText MIDIEvent_SetTextA
 #endif
+long __stdcall MIDIEvent_SetTextExA
+	(MIDIEvent* pEvent, const char* pszText, MIDIDataContext* pContext); /* 20261019追加 */
+long __stdcall MIDIEvent_SetTextExW
+	(MIDIEvent* pEvent, const wchar_t* pszText, MIDIDataContext* pContext); /* 20261019追加 */
+#ifdef UNICODE
+#define MIDIEvent_SetTextEx MIDIEvent_SetTextExW
+#else
+#define MIDIEvent_SetTextEx MIDIEvent_SetTextExA
+#endif
 
 /* SMPTEオフセットの取得(SMPTEオフセットイベントのみ) */
 long __stdcall MIDIEvent_GetSMPTEOffset 
@@ -1094,6 +1299,11 @@ long __stdcall MIDITrack_InsertEventBefore
 /* トラックにイベントを挿入(イベントはあらかじめ生成しておく) */
 long __stdcall MIDITrack_InsertEvent (MIDITrack* pMIDITrack, MIDIEvent* pEvent);
 
+/* トラックの最後にイベントを追加する(イベントはあらかじめ生成しておく)(20261019追加) */
+/* pPrevSameKindEventにはトラック内の最後の同種イベント(なければNULL)を渡す */
+long __stdcall MIDITrack_AppendSingleEventForce 
+(MIDITrack* pMIDITrack, MIDIEvent* pEvent, MIDIEvent* pPrevSameKindEvent);
+
 /* トラックにシーケンス番号イベントを生成して挿入 */
 long __stdcall MIDITrack_InsertSequenceNumber
 (MIDITrack* pMIDITrack, long lTime, long lNum);
@@ -1648,6 +1858,21 @@ MIDIData* __stdcall MIDIData_LoadFromSMFW (const wchar_t* pszFileName);
 #define MIDIData_LoadFromSMF MIDIData_LoadFromSMFA
 #endif
 
+/* MIDIDataをスタンダードMIDIファイル(SMF)から読み込み、*/
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL)(コンテキスト指定)(20261019追加) */
+MIDIData* __stdcall MIDIData_LoadFromSMFExA (const char* pszFileName, MIDIDataContext* pContext);
+MIDIData* __stdcall MIDIData_LoadFromSMFExW (const wchar_t* pszFileName, MIDIDataContext* pContext);
+#ifdef UNICODE
+#define MIDIData_LoadFromSMFEx MIDIData_LoadFromSMFExW
+#else
+#define MIDIData_LoadFromSMFEx MIDIData_LoadFromSMFExA
+#endif
+
+/* MIDIDataをスタンダードMIDIファイル(*.mid)のメモリブロックから読み込み(20261019追加) */
+/* トラックデータは複写せずにメモリブロック上で直接解釈する。 */
+MIDIData* __stdcall MIDIData_LoadFromSMFMemory (const void* pData, long lLen);
+MIDIData* __stdcall MIDIData_LoadFromSMFMemoryEx (const void* pData, long lLen, MIDIDataContext* pContext);
+
 /* MIDIデータをスタンダードMIDIファイル(SMF)として保存 */
 long __stdcall MIDIData_SaveAsSMFA (MIDIData* pMIDIData, const char* pszFileName);
 long __stdcall MIDIData_SaveAsSMFW (MIDIData* pMIDIData, const wchar_t* pszFileName);
@@ -1657,6 +1882,27 @@ long __stdcall MIDIData_SaveAsSMFW (MIDIData* pMIDIData, const wchar_t* pszFileN
 #define MIDIData_SaveAsSMF MIDIData_SaveAsSMFA
 #endif
 
+/* MIDIデータをスタンダードMIDIファイル(SMF)として保存(コンテキスト指定)(20261019追加) */
+long __stdcall MIDIData_SaveAsSMFExA
+	(MIDIData* pMIDIData, const char* pszFileName, MIDIDataContext* pContext);
+long __stdcall MIDIData_SaveAsSMFExW
+	(MIDIData* pMIDIData, const wchar_t* pszFileName, MIDIDataContext* pContext);
+#ifdef UNICODE
+#define MIDIData_SaveAsSMFEx MIDIData_SaveAsSMFExW
+#else
+#define MIDIData_SaveAsSMFEx MIDIData_SaveAsSMFExA
+#endif
+
+/* MIDIデータをスタンダードMIDIファイル(*.mid)としてメモリブロックに保存(20261019追加) */
+/* *ppDataはMIDIDataLib_FreeMemoryで解放すること。 */
+long __stdcall MIDIData_SaveAsSMFMemory (MIDIData* pMIDIData, void** ppData, long* pLen);
+
+/* MIDIデータをスタンダードMIDIファイル(*.mid)として書き出し先関数へ書き出す(20261019追加) */
+/* 各トラックは伸長可能な作業用バッファへ1回の走査で符号化し、チャンク長は後から書き込む。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsSMFToSink
+	(MIDIData* pMIDIData, MIDIDataWriteProc pfnWrite, void* pParam, MIDIDataContext* pContext);
+
 /* MIDIDataをテキストファイルから読み込み、 */
 /* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
 MIDIData* __stdcall MIDIData_LoadFromTextA (const char* pszFileName);
@@ -1667,6 +1913,9 @@ MIDIData* __stdcall MIDIData_LoadFromTextW (const wchar_t* pszFileName);
 #define MIDIData_LoadFromText MIDIData_LoadFromTextA
 #endif
 
+/* メモリブロックから読み込む版(20261019追加) */
+MIDIData* __stdcall MIDIData_LoadFromTextMemory (const void* pData, long lLen);
+
 /* MIDIDataをテキストファイルとして保存 */
 long __stdcall MIDIData_SaveAsTextA (MIDIData* pMIDIData, const char* pszFileName);
 long __stdcall MIDIData_SaveAsTextW (MIDIData* pMIDIData, const wchar_t* pszFileName);
@@ -1676,6 +1925,9 @@ long __stdcall MIDIData_SaveAsTextW (MIDIData* pMIDIData, const wchar_t* pszFile
 #define MIDIData_SaveAsText MIDIData_SaveAsTextA
 #endif
 
+/* メモリブロックに保存する版(*ppDataはMIDIDataLib_FreeMemoryで解放すること)(20261019追加) */
+long __stdcall MIDIData_SaveAsTextMemory (MIDIData* pMIDIData, void** ppData, long* pLen);
+
 /* MIDIDataをバイナリファイルから読み込み、*/
 /* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
 MIDIData* __stdcall MIDIData_LoadFromBinaryA (const char* pszFileName);
@@ -1686,6 +1938,9 @@ MIDIData* __stdcall MIDIData_LoadFromBinaryW (const wchar_t* pszFileName);
 #define MIDIData_LoadFromBinary MIDIData_LoadFromBinaryA
 #endif
 
+/* メモリブロックから読み込む版(20261019追加) */
+MIDIData* __stdcall MIDIData_LoadFromBinaryMemory (const void* pData, long lLen);
+
 /* MIDIDataをバイナリファイルに保存 */
 long __stdcall MIDIData_SaveAsBinaryA (MIDIData* pMIDIData, const char* pszFileName);
 long __stdcall MIDIData_SaveAsBinaryW (MIDIData* pMIDIData, const wchar_t* pszFileName);
@@ -1695,6 +1950,34 @@ long __stdcall MIDIData_SaveAsBinaryW (MIDIData* pMIDIData, const wchar_t* pszFi
 #define MIDIData_SaveAsBinary MIDIData_SaveAsBinaryA
 #endif
 
+/* メモリブロックに保存する版(*ppDataはMIDIDataLib_FreeMemoryで解放すること)(20261019追加) */
+long __stdcall MIDIData_SaveAsBinaryMemory (MIDIData* pMIDIData, void** ppData, long* pLen);
+
+/* MIDIDataをスナップショットファイル(*.mds)から読み込み、(20261019追加) */
+/* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
+MIDIData* __stdcall MIDIData_LoadFromSnapshotA (const char* pszFileName);
+MIDIData* __stdcall MIDIData_LoadFromSnapshotW (const wchar_t* pszFileName);
+#ifdef UNICODE
+#define MIDIData_LoadFromSnapshot MIDIData_LoadFromSnapshotW
+#else
+#define MIDIData_LoadFromSnapshot MIDIData_LoadFromSnapshotA
+#endif
+
+/* メモリブロックから読み込む版(20261019追加) */
+MIDIData* __stdcall MIDIData_LoadFromSnapshotMemory (const void* pData, long lLen);
+
+/* MIDIDataをスナップショットファイル(*.mds)に保存(20261019追加) */
+long __stdcall MIDIData_SaveAsSnapshotA (MIDIData* pMIDIData, const char* pszFileName);
+long __stdcall MIDIData_SaveAsSnapshotW (MIDIData* pMIDIData, const wchar_t* pszFileName);
+#ifdef UNICODE
+#define MIDIData_SaveAsSnapshot MIDIData_SaveAsSnapshotW
+#else
+#define MIDIData_SaveAsSnapshot MIDIData_SaveAsSnapshotA
+#endif
+
+/* メモリブロックに保存する版(*ppDataはMIDIDataLib_FreeMemoryで解放すること)(20261019追加) */
+long __stdcall MIDIData_SaveAsSnapshotMemory (MIDIData* pMIDIData, void** ppData, long* pLen);
+
 /* MIDIDataをCherrryファイル(*.chy)から読み込み、 */
 /* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
 MIDIData* __stdcall MIDIData_LoadFromCherryA (const char* pszFileName);
@@ -1705,6 +1988,9 @@ MIDIData* __stdcall MIDIData_LoadFromCherryW (const wchar_t* pszFileName);
 #define MIDIData_LoadFromCherry MIDIData_LoadFromCherryA
 #endif
 
+/* メモリブロックから読み込む版(20261019追加) */
+MIDIData* __stdcall MIDIData_LoadFromCherryMemory (const void* pData, long lLen);
+
 /* MIDIデータをCherryファイル(*.chy)に保存 */
 long __stdcall MIDIData_SaveAsCherryA (MIDIData* pMIDIData, const char* pszFileName);
 long __stdcall MIDIData_SaveAsCherryW (MIDIData* pMIDIData, const wchar_t* pszFileName);
@@ -1714,6 +2000,9 @@ long __stdcall MIDIData_SaveAsCherryW (MIDIData* pMIDIData, const wchar_t* pszFi
 #define MIDIData_SaveAsCherry MIDIData_SaveAsCherryA
 #endif
 
+/* メモリブロックに保存する版(*ppDataはMIDIDataLib_FreeMemoryで解放すること)(20261019追加) */
+long __stdcall MIDIData_SaveAsCherryMemory (MIDIData* pMIDIData, void** ppData, long* pLen);
+
 /* MIDIデータをMIDICSVファイル(*.csv)から読み込み */
 /* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
 MIDIData* __stdcall MIDIData_LoadFromMIDICSVA (const char* pszFileName);
@@ -1724,6 +2013,9 @@ MIDIData* __stdcall MIDIData_LoadFromMIDICSVW (const wchar_t* pszFileName);
 #define MIDIData_LoadFromMIDICSV MIDIData_LoadFromMIDICSVA
 #endif
 
+/* メモリブロックから読み込む版(20261019追加) */
+MIDIData* __stdcall MIDIData_LoadFromMIDICSVMemory (const void* pData, long lLen);
+
 /* MIDIデータをMIDICSVファイル(*.csv)として保存 */
 long __stdcall MIDIData_SaveAsMIDICSVA (MIDIData* pMIDIData, const char* pszFileName);
 long __stdcall MIDIData_SaveAsMIDICSVW (MIDIData* pMIDIData, const wchar_t* pszFileName);
@@ -1733,6 +2025,28 @@ long __stdcall MIDIData_SaveAsMIDICSVW (MIDIData* pMIDIData, const wchar_t* pszF
 #define MIDIData_SaveAsMIDICSV MIDIData_SaveAsMIDICSVA
 #endif
 
+/* メモリブロックに保存する版(*ppDataはMIDIDataLib_FreeMemoryで解放すること)(20261019追加) */
+long __stdcall MIDIData_SaveAsMIDICSVMemory (MIDIData* pMIDIData, void** ppData, long* pLen);
+
+/* MIDIデータをMIDICSVファイル(*.csv)として保存(コンテキスト指定)(20261019追加) */
+/* pContextの保存オプションにMIDIDATACONTEXT_PARALLELSAVEを指定した場合、 */
+/* 各トラックを複数のスレッドで並行して書式化し、順番どおりに連結して書き出す。 */
+long __stdcall MIDIData_SaveAsMIDICSVExA
+	(MIDIData* pMIDIData, const char* pszFileName, MIDIDataContext* pContext);
+long __stdcall MIDIData_SaveAsMIDICSVExW
+	(MIDIData* pMIDIData, const wchar_t* pszFileName, MIDIDataContext* pContext);
+#ifdef UNICODE
+#define MIDIData_SaveAsMIDICSVEx MIDIData_SaveAsMIDICSVExW
+#else
+#define MIDIData_SaveAsMIDICSVEx MIDIData_SaveAsMIDICSVExA
+#endif
+
+/* MIDIデータをMIDICSV形式で書き出し先関数へ書き出す(20261019追加) */
+/* 整数・文字列はprintf系の関数を使わずに作業用バッファへ直接書き込み、まとめて書き出す。 */
+/* 戻り値：正常終了=1、異常終了=0。 */
+long __stdcall MIDIData_SaveAsMIDICSVToSink
+	(MIDIData* pMIDIData, MIDIDataWriteProc pfnWrite, void* pParam, MIDIDataContext* pContext);
+
 /* MIDIデータを旧Cakewalkシーケンスファイル(*.wrk)から読み込み */
 /* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
 MIDIData* __stdcall MIDIData_LoadFromWRKA (const char* pszFileName);
@@ -1743,6 +2057,9 @@ MIDIData* __stdcall MIDIData_LoadFromWRKW (const wchar_t* pszFileName);
 #define MIDIData_LoadFromWRK MIDIData_LoadFromWRKA
 #endif
 
+/* メモリブロックから読み込む版(20261019追加) */
+MIDIData* __stdcall MIDIData_LoadFromWRKMemory (const void* pData, long lLen);
+
 /* MIDIデータをマビノギMMLファイル(*.mml)から読み込み */
 /* 新しいMIDIデータへのポインタを返す(失敗時NULL) */
 MIDIData* __stdcall MIDIData_LoadFromMabiMMLA (const char* pszFileName);
@@ -1753,6 +2070,104 @@ MIDIData* __stdcall MIDIData_LoadFromMabiMMLW (const wchar_t* pszFileName);
 #define MIDIData_LoadFromMabiMML MIDIData_LoadFromMabiMMLA
 #endif
 
+/* メモリブロックから読み込む版(20261019追加) */
+MIDIData* __stdcall MIDIData_LoadFromMabiMMLMemory (const void* pData, long lLen);
+
+
+/******************************************************************************/
+/*                                                                            */
+/*　MIDIDataSnapshotクラス関数(20261019追加)                                  */
+/*                                                                            */
+/******************************************************************************/
+
+/* スナップショットを開いている間、スナップショットの内容は解析も複写もせずに参照する。 */
+/* 開く際にはヘッダーとトラック索引の範囲のみを検査し、各イベントのデータの範囲は */
+/* 取得時に検査する。MIDIDataとして編集する場合はMIDIDataSnapshot_ToMIDIDataで変換する。 */
+
+/* メモリ上のスナップショットを開く(失敗時NULL) */
+/* pDataはスナップショットを閉じるまで解放・変更しないこと。 */
+MIDIDataSnapshot* __stdcall MIDIDataSnapshot_OpenMemory (const void* pData, long lLen);
+
+/* スナップショットファイル(*.mds)を読み取り専用でメモリにマップして開く(失敗時NULL) */
+MIDIDataSnapshot* __stdcall MIDIDataSnapshot_OpenFileA (const char* pszFileName);
+MIDIDataSnapshot* __stdcall MIDIDataSnapshot_OpenFileW (const wchar_t* pszFileName);
+#ifdef UNICODE
+#define MIDIDataSnapshot_OpenFile MIDIDataSnapshot_OpenFileW
+#else
+#define MIDIDataSnapshot_OpenFile MIDIDataSnapshot_OpenFileA
+#endif
+
+/* スナップショットを閉じる */
+void __stdcall MIDIDataSnapshot_Close (MIDIDataSnapshot* pSnapshot);
+
+/* スナップショットのSMFフォーマットを取得 */
+long __stdcall MIDIDataSnapshot_GetFormat (MIDIDataSnapshot* pSnapshot);
+
+/* スナップショットのタイムベースを取得 */
+long __stdcall MIDIDataSnapshot_GetTimeBase (MIDIDataSnapshot* pSnapshot);
+
+/* スナップショットのトラック数を取得 */
+long __stdcall MIDIDataSnapshot_GetNumTrack (MIDIDataSnapshot* pSnapshot);
+
+/* スナップショットのトラック索引の項目を取得(範囲外の場合NULL) */
+const MIDIDataSnapshotTrack* __stdcall MIDIDataSnapshot_GetTrack
+	(MIDIDataSnapshot* pSnapshot, long lTrackIndex);
+
+/* スナップショットのイベント配列の項目を取得(範囲外の場合NULL) */
+const MIDIDataSnapshotEvent* __stdcall MIDIDataSnapshot_GetEvent
+	(MIDIDataSnapshot* pSnapshot, long lTrackIndex, long lEventIndex);
+
+/* スナップショットのイベントのデータを取得(範囲外の場合及びデータが不正な場合NULL) */
+/* データの長さはMIDIDataSnapshot_GetEventで得た項目のm_lLenである。 */
+const unsigned char* __stdcall MIDIDataSnapshot_GetEventData
+	(MIDIDataSnapshot* pSnapshot, long lTrackIndex, long lEventIndex);
+
+/* スナップショットから新しいMIDIデータを生成し、そのポインタを返す(失敗時NULL) */
+MIDIData* __stdcall MIDIDataSnapshot_ToMIDIData (MIDIDataSnapshot* pSnapshot);
+
+
+
+/******************************************************************************/
+/*                                                                            */
+/*　MIDIDataCacheクラス関数(20261019追加)                                     */
+/*                                                                            */
+/******************************************************************************/
+
+/* キャッシュを生成し、キャッシュへのポインタを返す(失敗時NULL) */
+/* pszDirName:キャッシュディレクトリ名(なければ作成する) */
+/* lMaxSize:キャッシュの合計の長さの上限[KB](超えた場合は最後に使われた時刻が古いものから削除) */
+MIDIDataCache* __stdcall MIDIDataCache_CreateA (const char* pszDirName, long lMaxSize);
+MIDIDataCache* __stdcall MIDIDataCache_CreateW (const wchar_t* pszDirName, long lMaxSize);
+#ifdef UNICODE
+#define MIDIDataCache_Create MIDIDataCache_CreateW
+#else
+#define MIDIDataCache_Create MIDIDataCache_CreateA
+#endif
+
+/* キャッシュを削除する(キャッシュディレクトリ内のファイルは削除しない) */
+void __stdcall MIDIDataCache_Delete (MIDIDataCache* pCache);
+
+/* キャッシュディレクトリ内のキャッシュファイルを全て削除し、削除したファイル数を返す */
+/* (書き込み中に異常終了したプロセスが残した5分以上前の一時ファイル(*.tmp)も削除する) */
+long __stdcall MIDIDataCache_Clear (MIDIDataCache* pCache);
+
+/* キャッシュを通じてファイルから読み込み、新しいMIDIデータへのポインタを返す(失敗時NULL) */
+/* lFormatはMIDIDATACACHE_SMF等。同じ内容・同じ形式のデータを以前に読み込んでいれば、 */
+/* 解析を省いてキャッシュファイル(スナップショット)から読み込む。 */
+MIDIData* __stdcall MIDIDataCache_LoadFromFileA 
+	(MIDIDataCache* pCache, const char* pszFileName, long lFormat);
+MIDIData* __stdcall MIDIDataCache_LoadFromFileW 
+	(MIDIDataCache* pCache, const wchar_t* pszFileName, long lFormat);
+#ifdef UNICODE
+#define MIDIDataCache_LoadFromFile MIDIDataCache_LoadFromFileW
+#else
+#define MIDIDataCache_LoadFromFile MIDIDataCache_LoadFromFileA
+#endif
+
+/* メモリブロックから読み込む版 */
+MIDIData* __stdcall MIDIDataCache_LoadFromMemory 
+	(MIDIDataCache* pCache, const void* pData, long lLen, long lFormat);
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,6 +32,40 @@ Public Const MIDIIO_SYSXBUF = 256
 Public Const MIDIIO_NONE = ""
 Public Const MIDIIO_DEFAULT = "default"
 Public Const MIDIIO_MIDIMAPPER = "MIDI Mapper"
+Public Const MIDIIO_NULL = "Null"
+Public Const MIDIIO_LOOPBACK = "Loopback"
+Public Const MIDIIO_LOOPBACKNUM = 16
+Public Const MIDIIO_SHARED = "Shared"
+Public Const MIDIIO_SHAREDMAXNAMELEN = 200
+Public Const MIDIIO_SHAREDBUFSIZE = 65536
+Public Const MIDIIO_MSGRECORDDATASIZE = 8
+
+' MIDIMsgRecord\(MIDIIn_GetMIDIMessagesŎgp)(20261019ǉ)
+Type MIDIMsgRecord
+    m_cyMicrosec As Currency            ' M[}CNb](l1/10000ƂȂ)
+    m_lLen As Long                      ' MIDIbZ[W̒[oCg]
+    m_lSysxOffset As Long               ' SYSXobt@̊i[ʒu(m_byDataɊi[ꍇ-1)
+    m_byData(0 To 7) As Byte            ' 8oCgȉMIDIbZ[W
+End Type
+
+Public Const MIDIIO_LATENCYBUCKETNUM = 32
+
+' MIDIIOStats\(MIDIIO_GetStatsŎgp)(20261019ǉ)
+' Currency^̒l1/10000ƂȂ
+Type MIDIIOStats
+    m_lMode As Long                     ' 0=́A1=o
+    m_lBufSize As Long                  ' ̓obt@̑傫[oCg]SYSXMobt@̐
+    m_cyMessageNum As Currency          ' M͑MMIDIbZ[W̐
+    m_cyByteNum As Currency             ' M͑MoCg
+    m_lSysxWaitCount As Long            ' SYSXMobt@󂭂̂҂
+    m_lSysxDropCount As Long            ' SYSX𑗐MłɎ̂Ă񐔖͎MG[ƂȂSYSX̐
+    m_lSysxDoneCount As Long            ' MSYSX̐
+    m_lOverflowCount As Long            ' ̓obt@tŎ̂ĂMIDIbZ[W̐
+    m_lMaxFillLen As Long               ' ̓obt@̍őgpʖ͑MSYSXMobt@̍ő吔
+    m_lReserved As Long
+    m_cyMaxLatency As Currency          ' őǂݏox[}CNb]
+    m_lLatencyCount(0 To 31) As Long    ' ǂݏox̃qXgO
+End Type
 
 
 ' MIDIo̓foCX̐𒲂ׂ
@@ -61,6 +95,11 @@ Declare Function MIDIOut_Reset Lib "MIDIIO.dll" _
 Declare Function MIDIOut_PutMIDIMessage Lib "MIDIIO.dll" _
     (ByVal pMIDIOut As Long, ByRef pMIDIMessage As Byte, ByVal lLen As Long) As Long
 
+' MIDIo̓foCX3oCgȉMIDIbZ[W܂Ƃ߂ďo͂(20261019ǉ)
+' ebZ[WmidiOutShortMsgƓ`Ƃ
+Declare Function MIDIOut_PutShortMessages Lib "MIDIIO.dll" _
+    (ByVal pMIDIOut As Long, ByRef pMessage As Long, ByVal lNum As Long) As Long
+
 ' MIDIo̓foCX1oCgo͂
 Declare Function MIDIOut_PutByte Lib "MIDIIO.dll" _
     (ByVal pMIDIOut As Long, ByVal bByte As Byte) As Long
@@ -73,6 +112,44 @@ Declare Function MIDIOut_PutBytes Lib "MIDIIO.dll" _
 Declare Function MIDIOut_GetThisDeviceName Lib "MIDIIO.dll" Alias "MIDIOut_GetThisDeviceNameA" _
     (ByVal pMIDIOut As Long, ByVal pszDeviceName As String, ByVal lLen As Long) As Long
 
+' SYSXMobt@̐1̑傫ݒ肷
+Declare Function MIDIOut_SetSysxBuffer Lib "MIDIIO.dll" _
+    (ByVal pMIDIOut As Long, ByVal lNumBuffer As Long, ByVal lBufferSize As Long) As Long
+
+' SYSXMobt@󂭂̂҂ő厞[~b]ݒ肷
+Declare Function MIDIOut_SetSysxTimeout Lib "MIDIIO.dll" _
+    (ByVal pMIDIOut As Long, ByVal lTimeout As Long) As Long
+
+' MSYSXMobt@̐擾
+Declare Function MIDIOut_GetSysxPendingNum Lib "MIDIIO.dll" _
+    (ByVal pMIDIOut As Long) As Long
+
+' SYSXMobt@󂭂̂҂񐔂擾
+Declare Function MIDIOut_GetSysxWaitCount Lib "MIDIIO.dll" _
+    (ByVal pMIDIOut As Long) As Long
+
+' SYSX𑗐MłɎ̂Ă񐔂擾
+Declare Function MIDIOut_GetSysxDropCount Lib "MIDIIO.dll" _
+    (ByVal pMIDIOut As Long) As Long
+
+' MIDIo̓foCX̏o̓L[MIDIbZ[Wo^(20261019ǉ)
+' o͎[}CNb]Currency^œn(l1/10000Ƃ)
+Declare Function MIDIOut_EnqueueMIDIMessage Lib "MIDIIO.dll" _
+    (ByVal pMIDIOut As Long, ByVal cyDeadline As Currency, _
+    ByRef pMIDIMessage As Byte, ByVal lLen As Long) As Long
+
+' MIDIo̓foCX̏o̓L[̖o͂MIDIbZ[WׂĎ̂Ă(20261019ǉ)
+Declare Function MIDIOut_ClearQueue Lib "MIDIIO.dll" _
+    (ByVal pMIDIOut As Long) As Long
+
+' MIDIo̓foCX̏o̓L[̖o͂MIDIbZ[W̐擾(20261019ǉ)
+Declare Function MIDIOut_GetQueuedNum Lib "MIDIIO.dll" _
+    (ByVal pMIDIOut As Long) As Long
+
+' MIDIo̓foCX̏o̓L[ŏo͎1~bȏxꂽ񐔂擾(20261019ǉ)
+Declare Function MIDIOut_GetQueueLateCount Lib "MIDIIO.dll" _
+    (ByVal pMIDIOut As Long) As Long
+
 
 
 ' MIDI̓foCX̐𒲂ׂ
@@ -102,6 +179,17 @@ Declare Function MIDIIn_Reset Lib "MIDIIO.dll" _
 Declare Function MIDIIn_GetMIDIMessage Lib "MIDIIO.dll" _
     (ByVal pMIDIIn As Long, ByRef pMIDIMessage As Byte, ByVal lLen As Long) As Long
 
+' MIDI̓foCX1bZ[W͂A̎M[}CNb]擾(20261019ǉ)
+' (Currency^Ŏ󂯎ƁAl͎M[}CNb]1/10000ƂȂ)
+Declare Function MIDIIn_GetMIDIMessageEx Lib "MIDIIO.dll" _
+    (ByVal pMIDIIn As Long, ByRef pMIDIMessage As Byte, ByVal lLen As Long, _
+    ByRef cyMicrosec As Currency) As Long
+
+' MIDI̓foCX͍ς݂MIDIbZ[W܂Ƃ߂ē͂(20261019ǉ)
+Declare Function MIDIIn_GetMIDIMessages Lib "MIDIIO.dll" _
+    (ByVal pMIDIIn As Long, ByRef pRecord As MIDIMsgRecord, ByVal lMaxNum As Long, _
+    ByRef pSysxBuf As Byte, ByVal lSysxBufLen As Long) As Long
+
 ' MIDI̓foCX1oCg͂
 Declare Function MIDIIn_GetByte Lib "MIDIIO.dll" _
     (ByVal pMIDIIn As Long, ByRef pByte As Byte) As Long
@@ -110,7 +198,35 @@ Declare Function MIDIIn_GetByte Lib "MIDIIO.dll" _
 Declare Function MIDIIn_GetBytes Lib "MIDIIO.dll" _
     (ByVal pMIDIIn As Long, ByRef pData As Byte, ByVal lLen As Long) As Long
 
+' MIDI̓foCXɃf[^͂܂ő҂(20261019ǉ)
+' lTimeout͍ő҂[}CNb](-1=)
+Declare Function MIDIIn_Wait Lib "MIDIIO.dll" _
+    (ByVal pMIDIIn As Long, ByVal lTimeout As Long) As Long
+
+' ͑҂p̃Cxgnh擾(20261019ǉ)
+Declare Function MIDIIn_GetWaitHandle Lib "MIDIIO.dll" _
+    (ByVal pMIDIIn As Long) As Long
+
+' ̓obt@tŎ̂ĂMIDIbZ[W̐擾
+Declare Function MIDIIn_GetOverflowCount Lib "MIDIIO.dll" _
+    (ByVal pMIDIIn As Long) As Long
+
 ' MIDI̓foCX̖O擾(20120415ǉ)
 Declare Function MIDIIn_GetThisDeviceName Lib "MIDIIO.dll" Alias "MIDIIn_GetThisDeviceNameA" _
     (ByVal pMIDIIn As Long, ByVal pszDeviceName As String, ByVal lLen As Long) As Long
 
+' MIDIo͖MIDI͂̓v擾(20261019ǉ)
+Declare Function MIDIIO_GetStats Lib "MIDIIO.dll" _
+    (ByVal pMIDI As Long, ByRef tagStats As MIDIIOStats) As Long
+
+' oCg̐擪1MIDIbZ[W؂o(20261019ǉ)
+' ؂obZ[WpDatalOffsetoCgڂlMessageLenoCgA߂l͏oCg
+Declare Function MIDIStream_Split Lib "MIDIIO.dll" _
+    (ByRef pData As Byte, ByVal lLen As Long, ByRef cRunningStatus As Byte, _
+    ByRef lOffset As Long, ByRef lMessageLen As Long) As Long
+
+' Xe[^XoCgMIDIbZ[W̒߂(20261019ǉ)
+' f[^oCg̏ꍇySYSX(&HF0)̏ꍇ0Ԃ
+Declare Function MIDIStream_GetMessageLen Lib "MIDIIO.dll" _
+    (ByVal cStatus As Byte) As Long
+
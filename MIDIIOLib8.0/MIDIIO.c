@@ -25,11 +25,14 @@
 /* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
 
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
 #include <tchar.h>
 #include <windows.h>
 #include <crtdbg.h>
 #include <mmsystem.h>
 #include "MIDIIO.h"
+#include "MIDIClockTime.h" /* 20261019追加 */
 
 #ifndef _MSC_VER
 #define strcpy_s(str1, str1len, str2) do{strncpy(str1,str2,str1len); ((char*)str1)[str1len-1]='\0';}while(0)
@@ -92,19 +95,49 @@ static BOOL WINAPI DllMain (HINSTANCE hinstDLL, DWORD fdwReason, LPVOID lpvReser
 
 /* MIDI入出力両用関数 *********************************************************/
 
-/* バッファに対して簡易クリティカルセクションを張る */
-static void MIDIIO_LockBuf (MIDI* pMIDI) {
-	_ASSERT (pMIDI);
-	while (pMIDI->m_bBufLocked) {
-		Sleep (1);
-	}
-	pMIDI->m_bBufLocked = 1;
+/* 獲得(acquire)セマンティクスでlongを読み込む(20261019追加) */
+static long MIDIIO_LoadAcquire (volatile long* pValue) {
+	long lValue = *pValue;
+	MemoryBarrier ();
+	return lValue;
 }
 
-/* バッファに対して簡易クリティカルセクションを抜ける */
-static void MIDIIO_UnLockBuf (MIDI* pMIDI) {
-	_ASSERT (pMIDI);
-	pMIDI->m_bBufLocked = 0;
+/* 解放(release)セマンティクスでlongを書き込む(20261019追加) */
+static void MIDIIO_StoreRelease (volatile long* pValue, long lValue) {
+	MemoryBarrier ();
+	*pValue = lValue;
+}
+
+/* ステータスバイトごとのMIDIメッセージの長さ(20261019追加) */
+/* (0x00〜0x7Fはデータバイト、0xF0は可変長のため0とする。未定義の0xF4,0xF5,0xF7は1とする) */
+static const unsigned char g_byMIDIIOStatusLen[256] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x00〜0x0F */
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x10〜0x1F */
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x20〜0x2F */
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x30〜0x3F */
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x40〜0x4F */
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x50〜0x5F */
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x60〜0x6F */
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x70〜0x7F */
+	3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, /* 0x80〜0x8F ノートオフ */
+	3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, /* 0x90〜0x9F ノートオン */
+	3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, /* 0xA0〜0xAF キーアフタータッチ */
+	3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, /* 0xB0〜0xBF コントロールチェンジ */
+	2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, /* 0xC0〜0xCF プログラムチェンジ */
+	2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, /* 0xD0〜0xDF チャンネルアフタータッチ */
+	3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, /* 0xE0〜0xEF ピッチベンド */
+	0, 2, 3, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1  /* 0xF0〜0xFF システムメッセージ */
+};
+
+/* ステータスバイトから3バイト以下のMIDIメッセージの長さを求める(20261019追加) */
+/* (ステータスバイトでない場合、SYSX(0xF0)・エンドオブエクスクルーシヴ(0xF7)の場合、 */
+/* 未定義のシステムコモンメッセージ(0xF4・0xF5)の場合は0を返す) */
+static long MIDIIO_GetShortMessageLen (unsigned long ulMsg) {
+	unsigned char cStatus = (unsigned char)(ulMsg & 0x000000FF);
+	if (cStatus == 0xF4 || cStatus == 0xF5 || cStatus == 0xF7) {
+		return 0;
+	}
+	return g_byMIDIIOStatusLen[cStatus];
 }
 
 /* メモリブロックをテキスト表現する */
@@ -123,6 +156,431 @@ static void MIDIIO_Bin2Txt
 	}
 }
 
+/* MIDI入出力バックエンド関数テーブル(隠蔽)(20261019追加) */
+/* MIDI構造体のm_pBackendがこれを指し、各関数はデバイスの種類ごとに実装される。 */
+typedef struct tagMIDIIOBackend {
+	/* デバイスを開く(lIDはwinmmではデバイス番号、ループバックではポート番号) */
+	long (*m_pfnOpen) (MIDI* pMIDI, long lID);
+	/* デバイスを閉じる(MIDI構造体自体の解放は呼び出し側で行う) */
+	long (*m_pfnClose) (MIDI* pMIDI);
+	/* デバイスをリセットする */
+	long (*m_pfnReset) (MIDI* pMIDI);
+	/* 3バイト以下のMIDIメッセージを出力する(出力専用) */
+	long (*m_pfnPutShortMessage) (MIDI* pMIDI, unsigned long ulMsg, long lLen);
+	/* システムエクスクルーシヴメッセージを出力する(出力専用) */
+	long (*m_pfnPutLongMessage) (MIDI* pMIDI, unsigned char* pMessage, long lLen);
+	/* 3バイト以下のMIDIメッセージをまとめて出力する(出力専用、NULLの場合は1つずつ出力する)(20261019追加) */
+	long (*m_pfnPutShortMessages) (MIDI* pMIDI, const uint32_t* pMessage, long lNum);
+} MIDIIOBackend;
+
+#define MIDIIO_BACKEND(MIDI) ((const MIDIIOBackend*)((MIDI)->m_pBackend))
+
+/* 入力バッファは単一書き込み・単一読み込み(SPSC)のリングバッファである(20261019変更)。 */
+/* m_lWritePositionは書き込み側(コールバック又はループバック出力)のみが、 */
+/* m_lReadPositionは読み込み側(MIDIIn_Get系関数)のみが更新するので、ロックは不要である。 */
+/* m_lBufSizeは2のべき乗でなければならず、常に1バイトを空けて満杯と空を区別する。 */
+
+/* 受信時刻は入力バッファと同じ大きさのm_pTimeBufに、メッセージ先頭バイトと同じ位置へ格納する(20261019追加)。 */
+
+/* 現在時刻[マイクロ秒]はMIDIClock_GetMonotonicMicrosecと同じ基準となるよう、 */
+/* MIDIClockTime.hのMIDIClock_QueryMonotonicMicrosecで取得する(20261019変更)。 */
+
+/* 受信データを入力バッファに書き込む(正常終了時1、空きが足りない場合は捨てて0を返す) */
+/* llMicrosecは受信時刻[マイクロ秒](20261019追加) */
+static long MIDIIO_WriteBuf (MIDI* pMIDIIn, unsigned char* pData, long lLen, int64_t llMicrosec) {
+	long lMask = pMIDIIn->m_lBufSize - 1;
+	long lWritePosition = pMIDIIn->m_lWritePosition;
+	long lReadPosition = MIDIIO_LoadAcquire (&(pMIDIIn->m_lReadPosition));
+	long lFreeLen = (lReadPosition - lWritePosition - 1) & lMask;
+	long lFirstLen;
+	long lFillLen;
+	/* メッセージの途中で切れないよう、入りきらない場合はメッセージごと捨てる */
+	if (lLen > lFreeLen) {
+		pMIDIIn->m_lOverflowCount++;
+		return 0;
+	}
+	if (lLen <= 0) {
+		return 1;
+	}
+	/* 受信時刻はデータより先に書き、書き込み位置と共に公開する */
+	pMIDIIn->m_pTimeBuf[lWritePosition] = llMicrosec;
+	lFirstLen = MIN (lLen, pMIDIIn->m_lBufSize - lWritePosition);
+	memcpy (pMIDIIn->m_pBuf + lWritePosition, pData, lFirstLen);
+	memcpy (pMIDIIn->m_pBuf, pData + lFirstLen, lLen - lFirstLen);
+	MIDIIO_StoreRelease (&(pMIDIIn->m_lWritePosition), (lWritePosition + lLen) & lMask);
+	/* 受信統計の更新(書き込み側のみが更新する)(20261019追加) */
+	pMIDIIn->m_llMessageNum++;
+	pMIDIIn->m_llByteNum += lLen;
+	lFillLen = (lWritePosition + lLen - lReadPosition) & lMask;
+	if (lFillLen > pMIDIIn->m_lMaxFillLen) {
+		pMIDIIn->m_lMaxFillLen = lFillLen;
+	}
+	/* 入力バッファが空から空でなくなった場合は待機中の読み込み側を起こす(20261019追加) */
+	/* (書き込み位置の公開後に読み込み位置を読み直すことで、起こし損ないを防ぐ) */
+	MemoryBarrier ();
+	if (pMIDIIn->m_lReadPosition == lWritePosition) {
+		SetEvent ((HANDLE)(pMIDIIn->m_hInputEvent));
+	}
+	return 1;
+}
+
+/* 受信時刻から読み出しまでの遅延を統計に加える(読み込み側)(20261019追加) */
+/* 遅延が2^(k-1)以上2^k未満[マイクロ秒]ならばk番目の区間に数える */
+static void MIDIIO_AddLatency (MIDI* pMIDIIn, int64_t llLatency) {
+	long k = 0;
+	if (llLatency > pMIDIIn->m_llMaxLatency) {
+		pMIDIIn->m_llMaxLatency = llLatency;
+	}
+	while (llLatency > 0 && k < MIDIIO_LATENCYBUCKETNUM - 1) {
+		llLatency >>= 1;
+		k++;
+	}
+	pMIDIIn->m_lLatencyCount[k]++;
+}
+
+/* 入力バッファ内の未読データのバイト数を取得する(読み込み側) */
+static long MIDIIO_GetReadableLen (MIDI* pMIDIIn) {
+	long lWritePosition = MIDIIO_LoadAcquire (&(pMIDIIn->m_lWritePosition));
+	return (lWritePosition - pMIDIIn->m_lReadPosition) & (pMIDIIn->m_lBufSize - 1);
+}
+
+/* 入力バッファのlPositionからlCopyLenバイトをコピーする。読み込み位置は進めない(読み込み側)(20261019追加) */
+static void MIDIIO_PeekBuf (MIDI* pMIDIIn, long lPosition, unsigned char* pData, long lCopyLen) {
+	long lFirstLen = MIN (lCopyLen, pMIDIIn->m_lBufSize - lPosition);
+	memcpy (pData, pMIDIIn->m_pBuf + lPosition, lFirstLen);
+	memcpy (pData + lFirstLen, pMIDIIn->m_pBuf, lCopyLen - lFirstLen);
+}
+
+/* 入力バッファから先頭lCopyLenバイトを取り出し、読み込み位置をlSkipLenバイト進める(読み込み側) */
+static void MIDIIO_ReadBuf (MIDI* pMIDIIn, unsigned char* pData, long lCopyLen, long lSkipLen) {
+	long lReadPosition = pMIDIIn->m_lReadPosition;
+	MIDIIO_PeekBuf (pMIDIIn, lReadPosition, pData, lCopyLen);
+	MIDIIO_StoreRelease (&(pMIDIIn->m_lReadPosition), 
+		(lReadPosition + lSkipLen) & (pMIDIIn->m_lBufSize - 1));
+}
+
+/* ヌルバックエンド：デバイスを開く(隠蔽) */
+static long MIDIIO_NullOpen (MIDI* pMIDI, long lID) {
+	pMIDI->m_bStarting = 1;
+	return 1;
+}
+
+/* ヌルバックエンド：デバイスを閉じる(隠蔽) */
+static long MIDIIO_NullClose (MIDI* pMIDI) {
+	pMIDI->m_bStarting = 0;
+	return 1;
+}
+
+/* ヌルバックエンド：デバイスをリセットする(隠蔽) */
+static long MIDIIO_NullReset (MIDI* pMIDI) {
+	return 1;
+}
+
+/* ループバックポート(隠蔽)(20261019追加) */
+/* 出力側はロックを取らずに入力側の入力バッファへ直接書き込む。 */
+/* m_lBusyは出力側が書き込み中であることを示し、入力側はクローズ時に */
+/* m_pMIDIInをNULLにした後、m_lBusyが0になるまで待ってから解放する。 */
+typedef struct tagMIDIIOLoopbackPort {
+	MIDI* volatile m_pMIDIOut;
+	MIDI* volatile m_pMIDIIn;
+	volatile LONG m_lBusy;
+} MIDIIOLoopbackPort;
+
+static MIDIIOLoopbackPort g_theMIDIIOLoopbackPort[MIDIIO_LOOPBACKNUM];
+
+/* デバイス名がループバックポート名ならばポート番号(0〜)を、そうでなければ-1を返す(ANSI) */
+static long MIDIIO_GetLoopbackPortA (const char* pszDeviceName) {
+	long lPrefixLen = sizeof (MIDIIO_LOOPBACK) - 1;
+	long lPort = 0;
+	const char* p = pszDeviceName + lPrefixLen;
+	if (strncmp (pszDeviceName, MIDIIO_LOOPBACK, lPrefixLen) != 0 || *p != ' ') {
+		return -1;
+	}
+	for (p++; '0' <= *p && *p <= '9'; p++) {
+		lPort = lPort * 10 + (*p - '0');
+		if (lPort > MIDIIO_LOOPBACKNUM) {
+			return -1;
+		}
+	}
+	if (*p != 0 || lPort < 1) {
+		return -1;
+	}
+	return lPort - 1;
+}
+
+/* デバイス名がループバックポート名ならばポート番号(0〜)を、そうでなければ-1を返す(UNICODE) */
+static long MIDIIO_GetLoopbackPortW (const wchar_t* pszDeviceName) {
+	long lPrefixLen = WSIZEOF (L"Loopback") - 1;
+	long lPort = 0;
+	const wchar_t* p = pszDeviceName + lPrefixLen;
+	if (wcsncmp (pszDeviceName, L"Loopback", lPrefixLen) != 0 || *p != L' ') {
+		return -1;
+	}
+	for (p++; L'0' <= *p && *p <= L'9'; p++) {
+		lPort = lPort * 10 + (*p - L'0');
+		if (lPort > MIDIIO_LOOPBACKNUM) {
+			return -1;
+		}
+	}
+	if (*p != 0 || lPort < 1) {
+		return -1;
+	}
+	return lPort - 1;
+}
+
+/* ループバックポートを開いているMIDI入力の入力バッファへデータを書き込む */
+static long MIDIIO_PutLoopback (MIDIIOLoopbackPort* pPort, unsigned char* pData, long lLen) {
+	MIDI* pMIDIIn;
+	InterlockedIncrement (&(pPort->m_lBusy));
+	pMIDIIn = pPort->m_pMIDIIn;
+	/* 入力側が開かれていない場合は捨てる */
+	if (pMIDIIn != NULL && pMIDIIn->m_bStarting) {
+		if (MIDIIO_WriteBuf (pMIDIIn, pData, lLen, MIDIClock_QueryMonotonicMicrosec ()) == 0) {
+			_RPTF0 (_CRT_WARN, "警告：MIDIIO_PutLoopback内で入力バッファが一杯のためデータを捨てました。\r\n");
+		}
+	}
+	InterlockedDecrement (&(pPort->m_lBusy));
+	return lLen;
+}
+
+/* 共有メモリポート(隠蔽)(20261019追加) */
+/* "Shared 名前"を開いたMIDI出力とMIDI入力は、別のプロセスであっても、名前付きファイル */
+/* マッピング上の単一書き込み・単一読み込みのリングバッファを共有する。リングバッファには */
+/* (長さ4バイト、送信時刻[マイクロ秒]8バイト、MIDIメッセージ)の記録を詰めて書き込む。 */
+/* 送信時刻はQueryPerformanceCounterに基づくため、同じマシン上のプロセス間で共通である。 */
+/* 起こし合いには名前付きの自動リセットイベントを用い、入力側の受信スレッドが */
+/* 記録をMIDI入力の入力バッファへ移す。 */
+#define MIDIIO_SHAREDMAGIC 0x5344494D /* 'MIDS' */
+#define MIDIIO_SHAREDHEADERSIZE 12 /* 記録の長さと送信時刻の部分の大きさ */
+#define MIDIIO_SHAREDPREFIX L"Local\\MIDIIO.Shared."
+#define MIDIIO_SHAREDEVENTSUFFIX L".Event"
+
+/* 共有メモリ上の配置(両プロセスで同じでなければならない) */
+typedef struct tagMIDIIOSharedPort {
+	volatile LONG m_lMagic; /* MIDIIO_SHAREDMAGIC */
+	volatile LONG m_lBufSize; /* リングバッファの大きさ(MIDIIO_SHAREDBUFSIZE) */
+	volatile long m_lWritePosition; /* 出力側のみが更新する */
+	volatile long m_lReadPosition; /* 入力側のみが更新する */
+	volatile LONG m_lOutOpened; /* 出力側を開いているプロセスのID(0=開いていない)(20261019変更) */
+	volatile LONG m_lInOpened; /* 入力側を開いているプロセスのID(0=開いていない)(20261019変更) */
+	volatile LONG m_lOverflowCount; /* リングバッファが一杯で捨てた記録の数 */
+	volatile LONG m_lReserved;
+	unsigned char m_byBuf[MIDIIO_SHAREDBUFSIZE]; /* リングバッファ */
+} MIDIIOSharedPort;
+
+/* 共有メモリポートを開いたプロセス側のデータ(MIDI構造体のm_pBackendDataが指す) */
+typedef struct tagMIDIIOSharedData {
+	HANDLE m_hMapping; /* ファイルマッピング */
+	HANDLE m_hEvent; /* 入力側を起こすイベント */
+	MIDIIOSharedPort* m_pPort; /* マップした共有メモリ */
+	HANDLE m_hThread; /* 受信スレッド(入力側のみ) */
+	volatile long m_bExit; /* 受信スレッドの終了要求 */
+	unsigned char* m_pMessage; /* 受信スレッドの作業用バッファ(入力側のみ) */
+} MIDIIOSharedData;
+
+/* デバイス名が"Shared 名前"ならば1を、そうでなければ0を返す(ANSI) */
+static long MIDIIO_IsSharedNameA (const char* pszDeviceName) {
+	long lPrefixLen = sizeof (MIDIIO_SHARED) - 1;
+	return strncmp (pszDeviceName, MIDIIO_SHARED, lPrefixLen) == 0 &&
+		pszDeviceName[lPrefixLen] == ' ' && pszDeviceName[lPrefixLen + 1] != 0;
+}
+
+/* デバイス名が"Shared 名前"ならば1を、そうでなければ0を返す(UNICODE) */
+static long MIDIIO_IsSharedNameW (const wchar_t* pszDeviceName) {
+	long lPrefixLen = WSIZEOF (L"Shared") - 1;
+	return wcsncmp (pszDeviceName, L"Shared", lPrefixLen) == 0 &&
+		pszDeviceName[lPrefixLen] == L' ' && pszDeviceName[lPrefixLen + 1] != 0;
+}
+
+/* 共有メモリポートを開く(作成又は既存のものに接続する) */
+/* bUnicodeが0の場合はm_pDeviceNameをchar*として、1の場合はwchar_t*として扱う */
+static MIDIIOSharedData* MIDIIO_OpenSharedPort (MIDI* pMIDI, long bUnicode) {
+	wchar_t szName[WSIZEOF (MIDIIO_SHAREDPREFIX) + MIDIIO_SHAREDMAXNAMELEN + WSIZEOF (MIDIIO_SHAREDEVENTSUFFIX)];
+	long lPrefixLen = WSIZEOF (MIDIIO_SHAREDPREFIX) - 1;
+	long lNameLen;
+	MIDIIOSharedData* pSharedData;
+	/* "Shared "の後ろの部分をオブジェクト名とする */
+	memcpy (szName, MIDIIO_SHAREDPREFIX, lPrefixLen * sizeof (wchar_t));
+	if (bUnicode) {
+		const wchar_t* pszName = (const wchar_t*)(pMIDI->m_pDeviceName) + WSIZEOF (L"Shared ") - 1;
+		lNameLen = size_ttolong (wcslen (pszName));
+		if (lNameLen > MIDIIO_SHAREDMAXNAMELEN) {
+			_RPTF0 (_CRT_WARN, "エラー：MIDIIO_OpenSharedPort内で共有メモリポート名が長すぎます。\r\n");
+			return NULL;
+		}
+		memcpy (szName + lPrefixLen, pszName, lNameLen * sizeof (wchar_t));
+	}
+	else {
+		const char* pszName = (const char*)(pMIDI->m_pDeviceName) + sizeof (MIDIIO_SHARED " ") - 1;
+		lNameLen = MultiByteToWideChar (CP_ACP, 0, pszName, -1, szName + lPrefixLen, MIDIIO_SHAREDMAXNAMELEN + 1);
+		if (lNameLen == 0) {
+			_RPTF0 (_CRT_WARN, "エラー：MIDIIO_OpenSharedPort内で共有メモリポート名が長すぎます。\r\n");
+			return NULL;
+		}
+		lNameLen--;
+	}
+	szName[lPrefixLen + lNameLen] = 0;
+	pSharedData = (MIDIIOSharedData*)calloc (1, sizeof (MIDIIOSharedData));
+	if (pSharedData == NULL) {
+		_RPTF0 (_CRT_WARN, "エラー：MIDIIO_OpenSharedPort内でcallocがNULLを返しました。\r\n");
+		return NULL;
+	}
+	/* ページファイルを背後に持つファイルマッピング(初期内容は0) */
+	pSharedData->m_hMapping = CreateFileMappingW (INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+		0, sizeof (MIDIIOSharedPort), szName);
+	if (pSharedData->m_hMapping == NULL) {
+		free (pSharedData);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIIO_OpenSharedPort内でCreateFileMappingWがNULLを返しました。\r\n");
+		return NULL;
+	}
+	pSharedData->m_pPort = (MIDIIOSharedPort*)MapViewOfFile (pSharedData->m_hMapping,
+		FILE_MAP_ALL_ACCESS, 0, 0, sizeof (MIDIIOSharedPort));
+	if (pSharedData->m_pPort == NULL) {
+		CloseHandle (pSharedData->m_hMapping);
+		free (pSharedData);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIIO_OpenSharedPort内でMapViewOfFileがNULLを返しました。\r\n");
+		return NULL;
+	}
+	/* 先に開いた側が初期化する。配置の異なる版のMIDIIOが作ったものには接続しない */
+	InterlockedCompareExchange (&(pSharedData->m_pPort->m_lMagic), MIDIIO_SHAREDMAGIC, 0);
+	InterlockedCompareExchange (&(pSharedData->m_pPort->m_lBufSize), MIDIIO_SHAREDBUFSIZE, 0);
+	if (pSharedData->m_pPort->m_lMagic != MIDIIO_SHAREDMAGIC ||
+		pSharedData->m_pPort->m_lBufSize != MIDIIO_SHAREDBUFSIZE) {
+		UnmapViewOfFile (pSharedData->m_pPort);
+		CloseHandle (pSharedData->m_hMapping);
+		free (pSharedData);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIIO_OpenSharedPort内で共有メモリの形式が異なります。\r\n");
+		return NULL;
+	}
+	memcpy (szName + lPrefixLen + lNameLen, MIDIIO_SHAREDEVENTSUFFIX, sizeof (MIDIIO_SHAREDEVENTSUFFIX));
+	pSharedData->m_hEvent = CreateEventW (NULL, FALSE, FALSE, szName);
+	if (pSharedData->m_hEvent == NULL) {
+		UnmapViewOfFile (pSharedData->m_pPort);
+		CloseHandle (pSharedData->m_hMapping);
+		free (pSharedData);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIIO_OpenSharedPort内でCreateEventWがNULLを返しました。\r\n");
+		return NULL;
+	}
+	return pSharedData;
+}
+
+/* 共有メモリポートを閉じる(最後に閉じたプロセスで共有メモリは消える) */
+static void MIDIIO_CloseSharedPort (MIDIIOSharedData* pSharedData) {
+	CloseHandle (pSharedData->m_hEvent);
+	UnmapViewOfFile (pSharedData->m_pPort);
+	CloseHandle (pSharedData->m_hMapping);
+	free (pSharedData);
+}
+/* 共有メモリポートの出力側又は入力側(*pOpened)をこのプロセスが開いたものとして登録する(20261019追加) */
+/* 登録したプロセスが閉じずに異常終了した場合は登録が残るので、そのプロセスが既に終了して */
+/* いることを確かめてから引き継ぐ。戻り値：登録した=1、使用中=0 */
+static long MIDIIO_AcquireShared (volatile LONG* pOpened) {
+	LONG lProcessID = (LONG)GetCurrentProcessId ();
+	LONG lOwner;
+	HANDLE hProcess;
+	DWORD dwRet;
+	while (1) {
+		lOwner = InterlockedCompareExchange (pOpened, lProcessID, 0);
+		if (lOwner == 0) {
+			return 1;
+		}
+		if (lOwner == lProcessID) {
+			return 0;
+		}
+		/* 登録したプロセスがまだ動いていれば使用中 */
+		/* (開けない場合は、既に存在しない場合を除いて動いているものとみなす) */
+		hProcess = OpenProcess (SYNCHRONIZE, FALSE, (DWORD)lOwner);
+		if (hProcess) {
+			dwRet = WaitForSingleObject (hProcess, 0);
+			CloseHandle (hProcess);
+			if (dwRet != WAIT_OBJECT_0) {
+				return 0;
+			}
+		}
+		else if (GetLastError () != ERROR_INVALID_PARAMETER) {
+			return 0;
+		}
+		/* 終了したプロセスの登録を引き継ぐ(他のプロセスが先に引き継いだ場合はやり直す) */
+		if (InterlockedCompareExchange (pOpened, lProcessID, lOwner) == lOwner) {
+			_RPTF1 (_CRT_WARN, "警告：MIDIIO_AcquireShared内で終了したプロセス(%d)の登録を引き継ぎました。\r\n", lOwner);
+			return 1;
+		}
+	}
+}
+
+/* 共有メモリポートの出力側又は入力側(*pOpened)のこのプロセスの登録を消す(20261019追加) */
+/* (他のプロセスが引き継いだ後であれば何もしない) */
+static void MIDIIO_ReleaseShared (volatile LONG* pOpened) {
+	InterlockedCompareExchange (pOpened, 0, (LONG)GetCurrentProcessId ());
+}
+
+/* 共有メモリポートのlPositionへデータを書き込み、次の位置を返す(書き込み側) */
+/* (lPositionは共有メモリから読んだ値であるため、念のため範囲内に丸める)(20261019変更) */
+static long MIDIIO_CopyToShared (MIDIIOSharedPort* pPort, long lPosition, const void* pData, long lLen) {
+	long lFirstLen;
+	lPosition &= (MIDIIO_SHAREDBUFSIZE - 1);
+	lFirstLen = MIN (lLen, MIDIIO_SHAREDBUFSIZE - lPosition);
+	memcpy (pPort->m_byBuf + lPosition, pData, lFirstLen);
+	memcpy (pPort->m_byBuf, (const unsigned char*)pData + lFirstLen, lLen - lFirstLen);
+	return (lPosition + lLen) & (MIDIIO_SHAREDBUFSIZE - 1);
+}
+
+/* 共有メモリポートのlPositionからデータを読み込み、次の位置を返す(読み込み側) */
+/* (lPositionは共有メモリから読んだ値であるため、念のため範囲内に丸める)(20261019変更) */
+static long MIDIIO_CopyFromShared (MIDIIOSharedPort* pPort, long lPosition, void* pData, long lLen) {
+	long lFirstLen;
+	lPosition &= (MIDIIO_SHAREDBUFSIZE - 1);
+	lFirstLen = MIN (lLen, MIDIIO_SHAREDBUFSIZE - lPosition);
+	memcpy (pData, pPort->m_byBuf + lPosition, lFirstLen);
+	memcpy ((unsigned char*)pData + lFirstLen, pPort->m_byBuf, lLen - lFirstLen);
+	return (lPosition + lLen) & (MIDIIO_SHAREDBUFSIZE - 1);
+}
+
+/* 共有メモリポートに記録を1つ書き込む。公開はまだ行わない(書き込み側) */
+/* 新しい書き込み位置を返す。空きが足りない場合は記録を捨てて元の書き込み位置を返す */
+static long MIDIIO_AppendShared (MIDIIOSharedPort* pPort, long lWritePosition, long lReadPosition,
+	const unsigned char* pMessage, long lLen, int64_t llMicrosec) {
+	long lFreeLen = (lReadPosition - lWritePosition - 1) & (MIDIIO_SHAREDBUFSIZE - 1);
+	int32_t lRecordLen = lLen;
+	if (MIDIIO_SHAREDHEADERSIZE + lLen > lFreeLen) {
+		InterlockedIncrement (&(pPort->m_lOverflowCount));
+		return lWritePosition;
+	}
+	lWritePosition = MIDIIO_CopyToShared (pPort, lWritePosition, &lRecordLen, 4);
+	lWritePosition = MIDIIO_CopyToShared (pPort, lWritePosition, &llMicrosec, 8);
+	return MIDIIO_CopyToShared (pPort, lWritePosition, pMessage, lLen);
+}
+
+/* 書き込んだ記録を公開し、入力側が待機中であれば起こす(書き込み側) */
+/* (書き込み位置の公開後に読み込み位置を読み直すことで、起こし損ないを防ぐ) */
+static void MIDIIO_PublishShared (MIDIIOSharedData* pSharedData, long lOldWritePosition, long lWritePosition) {
+	MIDIIOSharedPort* pPort = pSharedData->m_pPort;
+	if (lWritePosition == lOldWritePosition) {
+		return;
+	}
+	MIDIIO_StoreRelease (&(pPort->m_lWritePosition), lWritePosition);
+	MemoryBarrier ();
+	if (pPort->m_lReadPosition == lOldWritePosition) {
+		SetEvent (pSharedData->m_hEvent);
+	}
+}
+
+/* 共有メモリポートにMIDIメッセージを1つ書き込んで公開する(書き込み側) */
+static long MIDIIO_PutShared (MIDIIOSharedData* pSharedData, unsigned char* pMessage, long lLen) {
+	MIDIIOSharedPort* pPort = pSharedData->m_pPort;
+	long lWritePosition, lReadPosition;
+	/* 入力側が開かれていない場合は捨てる */
+	if (pPort->m_lInOpened == 0) {
+		return lLen;
+	}
+	/* 共有メモリ上の位置は他プロセスから書き換えられうるため、読んだ直後に範囲内に丸める(20261019変更) */
+	lWritePosition = pPort->m_lWritePosition & (MIDIIO_SHAREDBUFSIZE - 1);
+	lReadPosition = MIDIIO_LoadAcquire (&(pPort->m_lReadPosition)) & (MIDIIO_SHAREDBUFSIZE - 1);
+	MIDIIO_PublishShared (pSharedData, lWritePosition, MIDIIO_AppendShared 
+		(pPort, lWritePosition, lReadPosition, pMessage, lLen, MIDIClock_QueryMonotonicMicrosec ()));
+	return lLen;
+}
+
 /******************************************************************************/
 /*                                                                            */
 /*  MIDIOutクラス関数群                                                       */
@@ -142,38 +600,18 @@ static void MIDIOut_OnMOMClose
 }
 
 /* SYSXの送信が終了したときに呼び出される。(隠蔽) */
+/* 送信完了したSYSX送信バッファの不準備と回収は送信側のスレッドで行うので、 */
+/* ここでは送信側で待っているスレッドを起こすだけとする(20261019変更)。 */
 static void MIDIOut_OnMOMDone 
 (HMIDIOUT hMIDIOut, DWORD_PTR dwInstance, DWORD_PTR dwParam1, DWORD_PTR dwParam2) {
-	MIDIHDR* pMIDIHdr = (MIDIHDR*)(dwParam1);
 	MIDIOut* pMIDIOut = (MIDIOut*)(dwInstance);
-	int i;
-	int nRet;
 	if (pMIDIOut == NULL) {
 		return;
 	}
-	/* 何番目のSYSXヘッダーが送信完了したか検出する */
-	for (i = 0; i < MIDIIO_SYSXNUM; i++) {
-		if (pMIDIOut->m_pSysxHeader[i] == pMIDIHdr) {
-			break;
-		}
-	}
-	if (i >= MIDIIO_SYSXNUM) {
-		_RPTF0 (_CRT_WARN, "警告：MIDIOut_OnMOMDone内で出所不明なSysxデータを検出しました。\r\n");
-		return;
-	}
-	/* 使用済みSYSXヘッダーの不準備(20070106) */
-	nRet = midiOutUnprepareHeader 
-		(pMIDIOut->m_pDeviceHandle, ((MIDIHDR*)(pMIDIOut->m_pSysxHeader[i])), sizeof(MIDIHDR));
-	if (nRet != MMSYSERR_NOERROR) {
-		_RPTF1 (_CRT_WARN, "エラー：MIDIOut_OnMOMDone内でmidiOutUnprepareHeaderが%dを返しました。\r\n", nRet);
+	InterlockedIncrement (&(pMIDIOut->m_lSysxDoneCount));
+	if (pMIDIOut->m_hSysxEvent != NULL) {
+		SetEvent ((HANDLE)(pMIDIOut->m_hSysxEvent));
 	}
-	/* 使用済みSYSXヘッダーの解放(20070520) */
-	HeapFree (GetProcessHeap (), 0, ((MIDIHDR*)(pMIDIOut->m_pSysxHeader[i]))->lpData);
-	HeapFree (GetProcessHeap (), 0, (MIDIHDR*)(pMIDIOut->m_pSysxHeader[i]));
-	pMIDIOut->m_pSysxHeader[i] = NULL;
-	
-	/* TODO 本来コールバック関数内でシステムコールは禁止であるが、 */
-	/* 上記midiOutUnprepareHeaderとHeapFreeに限り、今のところ問題は発生していない。 */
 }
 
 /* MIDI出力デバイスからメッセージを受け取るコールバック関数。(隠蔽) */
@@ -198,6 +636,605 @@ static void CALLBACK MidiOutProc (HMIDIOUT hMIDIOut, UINT wMsg,
 	}
 }
 
+/* winmmバックエンド：SYSX送信バッファを確保し、空の状態にする(隠蔽)(20261019追加) */
+static long MIDIOut_WinMMAllocSysx (MIDI* pMIDIOut, long lNumBuffer, long lBufferSize) {
+	MIDIHDR* pMIDIHdr;
+	long i;
+	pMIDIHdr = (MIDIHDR*)HeapAlloc (GetProcessHeap (), HEAP_ZERO_MEMORY, 
+		lNumBuffer * (sizeof (MIDIHDR) + lBufferSize));
+	if (pMIDIHdr == NULL) {
+		_RPTF0 (_CRT_WARN, "エラー：MIDIOut_WinMMAllocSysx内でHeapAllocがNULLを返しました。\r\n");
+		return 0;
+	}
+	/* データ領域はMIDIHDRの配列の直後に置く */
+	for (i = 0; i < lNumBuffer; i++) {
+		(pMIDIHdr + i)->lpData = (char*)(pMIDIHdr + lNumBuffer) + i * lBufferSize;
+	}
+	pMIDIOut->m_pSysxPool = pMIDIHdr;
+	pMIDIOut->m_lSysxPoolNum = lNumBuffer;
+	pMIDIOut->m_lSysxPoolSize = lBufferSize;
+	pMIDIOut->m_ulSysxHead = 0;
+	pMIDIOut->m_ulSysxTail = 0;
+	return 1;
+}
+
+/* winmmバックエンド：送信完了したSYSX送信バッファを古い順に回収する(隠蔽)(20261019追加) */
+static void MIDIOut_WinMMReclaimSysx (MIDI* pMIDIOut) {
+	MIDIHDR* pMIDIHdr;
+	int nRet;
+	while (pMIDIOut->m_ulSysxTail != pMIDIOut->m_ulSysxHead) {
+		pMIDIHdr = (MIDIHDR*)(pMIDIOut->m_pSysxPool) + 
+			pMIDIOut->m_ulSysxTail % pMIDIOut->m_lSysxPoolNum;
+		if ((*((volatile DWORD*)&(pMIDIHdr->dwFlags)) & MHDR_DONE) == 0) {
+			break;
+		}
+		/* 使用済みSYSXヘッダーの不準備 */
+		/* 不準備に失敗したバッファはドライバーが使用中とみなし、回収しない */
+		nRet = midiOutUnprepareHeader (pMIDIOut->m_pDeviceHandle, pMIDIHdr, sizeof (MIDIHDR));
+		if (nRet != MMSYSERR_NOERROR) {
+			_RPTF1 (_CRT_WARN, "エラー：MIDIOut_WinMMReclaimSysx内でmidiOutUnprepareHeaderが%dを返しました。\r\n", nRet);
+			break;
+		}
+		pMIDIOut->m_ulSysxTail++;
+	}
+}
+
+/* winmmバックエンド：送信中のSYSX送信バッファがすべて回収されるまで待つ(隠蔽)(20261019追加) */
+/* (100回試行し、すべて回収(不準備)できた場合1を返す) */
+static long MIDIOut_WinMMFlushSysx (MIDI* pMIDIOut) {
+	int t;
+	for (t = 0; t < 100; t++) {
+		MIDIOut_WinMMReclaimSysx (pMIDIOut);
+		if (pMIDIOut->m_ulSysxTail == pMIDIOut->m_ulSysxHead) {
+			return 1;
+		}
+		Sleep (10);
+	}
+	return 0;
+}
+
+/* winmmバックエンド：MIDI出力デバイスを開く(隠蔽) */
+static long MIDIOut_WinMMOpen (MIDI* pMIDIOut, long lID) {
+	int nRet;
+	/* SYSX送信バッファの確保(20261019) */
+	pMIDIOut->m_hSysxEvent = CreateEvent (NULL, FALSE, FALSE, NULL);
+	if (pMIDIOut->m_hSysxEvent == NULL) {
+		_RPTF0 (_CRT_WARN, "エラー：MIDIOut_WinMMOpen内でCreateEventがNULLを返しました。\r\n");
+		return 0;
+	}
+	if (MIDIOut_WinMMAllocSysx (pMIDIOut, MIDIIO_SYSXOUTNUM, MIDIIO_MAXSYSXSIZE) == 0) {
+		CloseHandle ((HANDLE)(pMIDIOut->m_hSysxEvent));
+		pMIDIOut->m_hSysxEvent = NULL;
+		return 0;
+	}
+	nRet = midiOutOpen ((HMIDIOUT*)&(pMIDIOut->m_pDeviceHandle), lID, 
+		(DWORD_PTR)MidiOutProc, (DWORD_PTR)pMIDIOut, CALLBACK_FUNCTION);
+	if (nRet != MMSYSERR_NOERROR) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIOut_WinMMOpen内でmidiOutOpenが%dを返しました。\r\n", nRet);
+		HeapFree (GetProcessHeap (), 0, pMIDIOut->m_pSysxPool);
+		pMIDIOut->m_pSysxPool = NULL;
+		CloseHandle ((HANDLE)(pMIDIOut->m_hSysxEvent));
+		pMIDIOut->m_hSysxEvent = NULL;
+		return 0;
+	}
+	return 1;
+}
+
+/* winmmバックエンド：MIDI出力デバイスを閉じる(隠蔽) */
+static long MIDIOut_WinMMClose (MIDI* pMIDIOut) {
+	int nRet;
+	/* MIDI出力リセット(送信中のSYSX送信バッファはすべてMOM_DONEで返される) */
+	midiOutReset (pMIDIOut->m_pDeviceHandle);
+	/* すべてのSYSX送信バッファの回収を待つ(100回試行) */
+	/* 回収できない場合はドライバーがまだバッファを使っているので、デバイスを閉じず */
+	/* SYSX送信バッファも解放せずに失敗とする(20261019変更) */
+	if (MIDIOut_WinMMFlushSysx (pMIDIOut) == 0) {
+		_RPTF0 (_CRT_WARN, "エラー：MIDIOut_WinMMClose内でMOM_DONEがコールバックされていないバッファがあります。\r\n");
+		return 0;
+	}
+	/* MIDI出力デバイスを閉じる */
+	/* 閉じられなかった場合はデバイスが開いたままなので、SYSX送信バッファとイベントは */
+	/* 解放せずに保持する(MIDIOut_Closeは再度呼び出せる)(20261019) */
+	nRet = midiOutClose (pMIDIOut->m_pDeviceHandle);
+	if (nRet != MMSYSERR_NOERROR) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIOut_WinMMClose内でmidiOutCloseが%dを返しました。\r\n", nRet);
+		return 0;
+	}
+	/* SYSX送信バッファの解放 */
+	HeapFree (GetProcessHeap (), 0, pMIDIOut->m_pSysxPool);
+	pMIDIOut->m_pSysxPool = NULL;
+	pMIDIOut->m_lSysxPoolNum = 0;
+	CloseHandle ((HANDLE)(pMIDIOut->m_hSysxEvent));
+	pMIDIOut->m_hSysxEvent = NULL;
+	return 1;
+}
+
+/* winmmバックエンド：MIDI出力デバイスをリセットする(隠蔽) */
+static long MIDIOut_WinMMReset (MIDI* pMIDIOut) {
+	int nRet = midiOutReset (pMIDIOut->m_pDeviceHandle);
+	if (nRet != MMSYSERR_NOERROR) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIOut_WinMMReset内でmidiOutResetが%dを返しました。\r\n", nRet);
+		return 0;
+	}
+	return 1;
+}
+
+/* winmmバックエンド：3バイト以下のMIDIメッセージを出力する(隠蔽) */
+static long MIDIOut_WinMMPutShortMessage (MIDI* pMIDIOut, unsigned long ulMsg, long lLen) {
+	midiOutShortMsg (pMIDIOut->m_pDeviceHandle, ulMsg);
+	return lLen;
+}
+
+/* winmmバックエンド：システムエクスクルーシヴメッセージを出力する(隠蔽) */
+/* SYSX送信バッファがすべて送信中の場合は、m_lSysxTimeoutミリ秒まで空くのを待つ(20261019変更)。 */
+static long MIDIOut_WinMMPutLongMessage (MIDI* pMIDIOut, unsigned char* pMessage, long lLen) {
+	MIDIHDR* pMIDIHdr;
+	DWORD dwStartTime;
+	DWORD dwElapsed;
+	int nRet;
+	if (lLen > pMIDIOut->m_lSysxPoolSize) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIOut_WinMMPutLongMessage内でSYSX送信バッファより長いSysx(%dバイト)を検出しました。\r\n", lLen);
+		pMIDIOut->m_lSysxDropCount++;
+		return 0;
+	}
+	/* 送信完了したSYSX送信バッファを回収し、空きがなければ待つ */
+	MIDIOut_WinMMReclaimSysx (pMIDIOut);
+	if (pMIDIOut->m_ulSysxHead - pMIDIOut->m_ulSysxTail >= (unsigned long)(pMIDIOut->m_lSysxPoolNum)) {
+		if (pMIDIOut->m_lSysxTimeout != 0) {
+			pMIDIOut->m_lSysxWaitCount++;
+		}
+		dwStartTime = GetTickCount ();
+		while (pMIDIOut->m_ulSysxHead - pMIDIOut->m_ulSysxTail >= (unsigned long)(pMIDIOut->m_lSysxPoolNum)) {
+			dwElapsed = GetTickCount () - dwStartTime;
+			if (pMIDIOut->m_lSysxTimeout >= 0 && dwElapsed >= (DWORD)(pMIDIOut->m_lSysxTimeout)) {
+				_RPTF0 (_CRT_WARN, "エラー：MIDIOut_WinMMPutLongMessageで使用可能なSYSX送信バッファがもはやありません。\r\n");
+				pMIDIOut->m_lSysxDropCount++;
+				return 0;
+			}
+			/* MOM_DONEの通知を待つ(取りこぼしに備えて最大10ミリ秒ごとに確認する) */
+			WaitForSingleObject ((HANDLE)(pMIDIOut->m_hSysxEvent), 
+				pMIDIOut->m_lSysxTimeout < 0 ? 10 : MIN (10, pMIDIOut->m_lSysxTimeout - dwElapsed));
+			MIDIOut_WinMMReclaimSysx (pMIDIOut);
+		}
+	}
+	/* SYSX送信バッファにMIDIメッセージをコピー */
+	pMIDIHdr = (MIDIHDR*)(pMIDIOut->m_pSysxPool) + 
+		pMIDIOut->m_ulSysxHead % pMIDIOut->m_lSysxPoolNum;
+	memcpy (pMIDIHdr->lpData, pMessage, lLen);
+	pMIDIHdr->dwBufferLength = lLen;
+	pMIDIHdr->dwBytesRecorded = lLen;
+	pMIDIHdr->dwFlags = 0;
+	/* midiOutPrepareHeader */
+	nRet = midiOutPrepareHeader (pMIDIOut->m_pDeviceHandle, pMIDIHdr, sizeof (MIDIHDR));
+	if (nRet != MMSYSERR_NOERROR) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIOut_WinMMPutLongMessage内でmidiOutPrepareHeaderが%dを返しました。\r\n", nRet);
+		pMIDIOut->m_lSysxDropCount++;
+		return 0;
+	}
+	/* midiOutLongMsg...この関数実行直後かやや後にMOM_DONEがコールバックされる */
+	nRet = midiOutLongMsg (pMIDIOut->m_pDeviceHandle, pMIDIHdr, sizeof(MIDIHDR));
+	if (nRet != MMSYSERR_NOERROR) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIOut_WinMMPutLongMessage内でmidiOutLongMsgが%dを返しました。\r\n", nRet);
+		midiOutUnprepareHeader (pMIDIOut->m_pDeviceHandle, pMIDIHdr, sizeof (MIDIHDR));
+		pMIDIOut->m_lSysxDropCount++;
+		return 0;
+	}
+	pMIDIOut->m_ulSysxHead++;
+	/* 送信中のSYSX送信バッファの最大数を記録する(20261019追加) */
+	if ((long)(pMIDIOut->m_ulSysxHead - pMIDIOut->m_ulSysxTail) > pMIDIOut->m_lMaxFillLen) {
+		pMIDIOut->m_lMaxFillLen = (long)(pMIDIOut->m_ulSysxHead - pMIDIOut->m_ulSysxTail);
+	}
+	return lLen;
+}
+
+/* ループバックバックエンド：MIDI出力を開く(隠蔽) */
+static long MIDIOut_LoopbackOpen (MIDI* pMIDIOut, long lID) {
+	MIDIIOLoopbackPort* pPort = &g_theMIDIIOLoopbackPort[lID];
+	/* 1つのループバックポートを同時に開けるMIDI出力は1つまで */
+	if (InterlockedCompareExchangePointer 
+		((PVOID volatile*)&(pPort->m_pMIDIOut), pMIDIOut, NULL) != NULL) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIOut_LoopbackOpen内でループバックポート%dは既に使用中です。\r\n", lID + 1);
+		return 0;
+	}
+	pMIDIOut->m_pBackendData = pPort;
+	return 1;
+}
+
+/* ループバックバックエンド：MIDI出力を閉じる(隠蔽) */
+static long MIDIOut_LoopbackClose (MIDI* pMIDIOut) {
+	MIDIIOLoopbackPort* pPort = (MIDIIOLoopbackPort*)(pMIDIOut->m_pBackendData);
+	InterlockedExchangePointer ((PVOID volatile*)&(pPort->m_pMIDIOut), NULL);
+	pMIDIOut->m_pBackendData = NULL;
+	return 1;
+}
+
+/* ループバックバックエンド：全チャンネルにオールノートオフを送る(隠蔽) */
+static long MIDIOut_LoopbackReset (MIDI* pMIDIOut) {
+	unsigned char byMsg[3] = {0xB0, 0x7B, 0x00};
+	for (; byMsg[0] <= 0xBF; byMsg[0]++) {
+		MIDIIO_PutLoopback ((MIDIIOLoopbackPort*)(pMIDIOut->m_pBackendData), byMsg, 3);
+	}
+	return 1;
+}
+
+/* ループバックバックエンド：3バイト以下のMIDIメッセージを出力する(隠蔽) */
+static long MIDIOut_LoopbackPutShortMessage (MIDI* pMIDIOut, unsigned long ulMsg, long lLen) {
+	unsigned char cData[3];
+	cData[0] = (unsigned char)(ulMsg & 0x000000FF);
+	cData[1] = (unsigned char)((ulMsg & 0x0000FF00) >> 8);
+	cData[2] = (unsigned char)((ulMsg & 0x00FF0000) >> 16);
+	return MIDIIO_PutLoopback ((MIDIIOLoopbackPort*)(pMIDIOut->m_pBackendData), cData, lLen);
+}
+
+/* ループバックバックエンド：3バイト以下のMIDIメッセージをまとめて出力する(隠蔽)(20261019追加) */
+/* (入力側の確認と受信時刻の取得は1回だけ行い、すべて同時刻に受信したものとする) */
+static long MIDIOut_LoopbackPutShortMessages (MIDI* pMIDIOut, const uint32_t* pMessage, long lNum) {
+	MIDIIOLoopbackPort* pPort = (MIDIIOLoopbackPort*)(pMIDIOut->m_pBackendData);
+	MIDI* pMIDIIn;
+	unsigned char cData[3];
+	int64_t llMicrosec;
+	long i, lLen;
+	long lRet = 0;
+	InterlockedIncrement (&(pPort->m_lBusy));
+	pMIDIIn = pPort->m_pMIDIIn;
+	/* 入力側が開かれていない場合は捨てる */
+	if (pMIDIIn != NULL && pMIDIIn->m_bStarting) {
+		llMicrosec = MIDIClock_QueryMonotonicMicrosec ();
+		for (i = 0; i < lNum; i++) {
+			lLen = MIDIIO_GetShortMessageLen (pMessage[i]);
+			if (lLen == 0) {
+				continue;
+			}
+			cData[0] = (unsigned char)(pMessage[i] & 0x000000FF);
+			cData[1] = (unsigned char)((pMessage[i] & 0x0000FF00) >> 8);
+			cData[2] = (unsigned char)((pMessage[i] & 0x00FF0000) >> 16);
+			/* 入力バッファが一杯で捨てたメッセージは数えない */
+			if (MIDIIO_WriteBuf (pMIDIIn, cData, lLen, llMicrosec) == 0) {
+				_RPTF0 (_CRT_WARN, "警告：MIDIOut_LoopbackPutShortMessages内で入力バッファが一杯のためデータを捨てました。\r\n");
+				continue;
+			}
+			lRet++;
+		}
+	}
+	else {
+		lRet = lNum;
+	}
+	InterlockedDecrement (&(pPort->m_lBusy));
+	return lRet;
+}
+
+/* ループバックバックエンド：システムエクスクルーシヴメッセージを出力する(隠蔽) */
+/* MIDIIO_MAXSYSXSIZEより長いSysxは切り詰めずに捨てる(20261019変更) */
+static long MIDIOut_LoopbackPutLongMessage (MIDI* pMIDIOut, unsigned char* pMessage, long lLen) {
+	if (lLen > MIDIIO_MAXSYSXSIZE) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIOut_LoopbackPutLongMessage内で長すぎるSysx(%dバイト)を検出しました。\r\n", lLen);
+		pMIDIOut->m_lSysxDropCount++;
+		return 0;
+	}
+	return MIDIIO_PutLoopback ((MIDIIOLoopbackPort*)(pMIDIOut->m_pBackendData), pMessage, lLen);
+}
+
+/* 共有メモリバックエンド：MIDI出力を開く(隠蔽)(20261019追加) */
+/* (lIDはデバイス名の文字型で、0=ANSI、1=UNICODE) */
+static long MIDIOut_SharedOpen (MIDI* pMIDIOut, long lID) {
+	MIDIIOSharedData* pSharedData = MIDIIO_OpenSharedPort (pMIDIOut, lID);
+	if (pSharedData == NULL) {
+		return 0;
+	}
+	/* 1つの共有メモリポートを同時に開けるMIDI出力は1つまで */
+	if (MIDIIO_AcquireShared (&(pSharedData->m_pPort->m_lOutOpened)) == 0) {
+		MIDIIO_CloseSharedPort (pSharedData);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIOut_SharedOpen内で共有メモリポートは既に使用中です。\r\n");
+		return 0;
+	}
+	pMIDIOut->m_pBackendData = pSharedData;
+	return 1;
+}
+
+/* 共有メモリバックエンド：MIDI出力を閉じる(隠蔽)(20261019追加) */
+static long MIDIOut_SharedClose (MIDI* pMIDIOut) {
+	MIDIIOSharedData* pSharedData = (MIDIIOSharedData*)(pMIDIOut->m_pBackendData);
+	MIDIIO_ReleaseShared (&(pSharedData->m_pPort->m_lOutOpened));
+	MIDIIO_CloseSharedPort (pSharedData);
+	pMIDIOut->m_pBackendData = NULL;
+	return 1;
+}
+
+/* 共有メモリバックエンド：全チャンネルにオールノートオフを送る(隠蔽)(20261019追加) */
+static long MIDIOut_SharedReset (MIDI* pMIDIOut) {
+	unsigned char byMsg[3] = {0xB0, 0x7B, 0x00};
+	for (; byMsg[0] <= 0xBF; byMsg[0]++) {
+		MIDIIO_PutShared ((MIDIIOSharedData*)(pMIDIOut->m_pBackendData), byMsg, 3);
+	}
+	return 1;
+}
+
+/* 共有メモリバックエンド：3バイト以下のMIDIメッセージを出力する(隠蔽)(20261019追加) */
+static long MIDIOut_SharedPutShortMessage (MIDI* pMIDIOut, unsigned long ulMsg, long lLen) {
+	unsigned char cData[3];
+	cData[0] = (unsigned char)(ulMsg & 0x000000FF);
+	cData[1] = (unsigned char)((ulMsg & 0x0000FF00) >> 8);
+	cData[2] = (unsigned char)((ulMsg & 0x00FF0000) >> 16);
+	return MIDIIO_PutShared ((MIDIIOSharedData*)(pMIDIOut->m_pBackendData), cData, lLen);
+}
+
+/* 共有メモリバックエンド：3バイト以下のMIDIメッセージをまとめて出力する(隠蔽)(20261019追加) */
+/* (すべて書き込んでから1回だけ公開し、入力側を起こすのも1回だけとする) */
+static long MIDIOut_SharedPutShortMessages (MIDI* pMIDIOut, const uint32_t* pMessage, long lNum) {
+	MIDIIOSharedData* pSharedData = (MIDIIOSharedData*)(pMIDIOut->m_pBackendData);
+	MIDIIOSharedPort* pPort = pSharedData->m_pPort;
+	unsigned char cData[3];
+	int64_t llMicrosec;
+	long lOldWritePosition, lWritePosition, lNewWritePosition, lReadPosition;
+	long i, lLen;
+	long lRet = 0;
+	/* 入力側が開かれていない場合は捨てる */
+	if (pPort->m_lInOpened == 0) {
+		return lNum;
+	}
+	/* 共有メモリ上の位置は他プロセスから書き換えられうるため、読んだ直後に範囲内に丸める(20261019変更) */
+	lOldWritePosition = lWritePosition = pPort->m_lWritePosition & (MIDIIO_SHAREDBUFSIZE - 1);
+	lReadPosition = MIDIIO_LoadAcquire (&(pPort->m_lReadPosition)) & (MIDIIO_SHAREDBUFSIZE - 1);
+	llMicrosec = MIDIClock_QueryMonotonicMicrosec ();
+	for (i = 0; i < lNum; i++) {
+		lLen = MIDIIO_GetShortMessageLen (pMessage[i]);
+		if (lLen == 0) {
+			continue;
+		}
+		cData[0] = (unsigned char)(pMessage[i] & 0x000000FF);
+		cData[1] = (unsigned char)((pMessage[i] & 0x0000FF00) >> 8);
+		cData[2] = (unsigned char)((pMessage[i] & 0x00FF0000) >> 16);
+		lNewWritePosition = MIDIIO_AppendShared (pPort, lWritePosition, lReadPosition, cData, lLen, llMicrosec);
+		/* 空きが足りずに捨てた記録は数えない(20261019変更) */
+		if (lNewWritePosition != lWritePosition) {
+			lWritePosition = lNewWritePosition;
+			lRet++;
+		}
+	}
+	MIDIIO_PublishShared (pSharedData, lOldWritePosition, lWritePosition);
+	return lRet;
+}
+
+/* 共有メモリバックエンド：システムエクスクルーシヴメッセージを出力する(隠蔽)(20261019追加) */
+/* MIDIIO_MAXSYSXSIZEより長いSysxは切り詰めずに捨てる */
+static long MIDIOut_SharedPutLongMessage (MIDI* pMIDIOut, unsigned char* pMessage, long lLen) {
+	if (lLen > MIDIIO_MAXSYSXSIZE) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIOut_SharedPutLongMessage内で長すぎるSysx(%dバイト)を検出しました。\r\n", lLen);
+		pMIDIOut->m_lSysxDropCount++;
+		return 0;
+	}
+	return MIDIIO_PutShared ((MIDIIOSharedData*)(pMIDIOut->m_pBackendData), pMessage, lLen);
+}
+
+/* ヌルバックエンド：3バイト以下のMIDIメッセージを捨てる(隠蔽) */
+static long MIDIOut_NullPutShortMessage (MIDI* pMIDIOut, unsigned long ulMsg, long lLen) {
+	return lLen;
+}
+
+/* ヌルバックエンド：システムエクスクルーシヴメッセージを捨てる(隠蔽) */
+static long MIDIOut_NullPutLongMessage (MIDI* pMIDIOut, unsigned char* pMessage, long lLen) {
+	return lLen;
+}
+
+/* ヌルバックエンド：3バイト以下のMIDIメッセージをまとめて捨てる(隠蔽)(20261019追加) */
+static long MIDIOut_NullPutShortMessages (MIDI* pMIDIOut, const uint32_t* pMessage, long lNum) {
+	long i;
+	long lRet = 0;
+	for (i = 0; i < lNum; i++) {
+		if (MIDIIO_GetShortMessageLen (pMessage[i]) > 0) {
+			lRet++;
+		}
+	}
+	return lRet;
+}
+
+/* MIDI出力バックエンド関数テーブル(隠蔽)(20261019追加) */
+static const MIDIIOBackend g_theMIDIOutWinMMBackend = {
+	MIDIOut_WinMMOpen, MIDIOut_WinMMClose, MIDIOut_WinMMReset,
+	MIDIOut_WinMMPutShortMessage, MIDIOut_WinMMPutLongMessage, NULL
+};
+static const MIDIIOBackend g_theMIDIOutLoopbackBackend = {
+	MIDIOut_LoopbackOpen, MIDIOut_LoopbackClose, MIDIOut_LoopbackReset,
+	MIDIOut_LoopbackPutShortMessage, MIDIOut_LoopbackPutLongMessage,
+	MIDIOut_LoopbackPutShortMessages
+};
+static const MIDIIOBackend g_theMIDIOutSharedBackend = {
+	MIDIOut_SharedOpen, MIDIOut_SharedClose, MIDIOut_SharedReset,
+	MIDIOut_SharedPutShortMessage, MIDIOut_SharedPutLongMessage,
+	MIDIOut_SharedPutShortMessages
+};
+static const MIDIIOBackend g_theMIDIOutNullBackend = {
+	MIDIIO_NullOpen, MIDIIO_NullClose, MIDIIO_NullReset,
+	MIDIOut_NullPutShortMessage, MIDIOut_NullPutLongMessage,
+	MIDIOut_NullPutShortMessages
+};
+
+
+/* 送信統計を更新する(送信側)(隠蔽)(20261019追加) */
+/* lLenはバックエンドの出力関数の戻り値であり、0(失敗)の場合は数えない */
+static void MIDIOut_AddSentStats (MIDI* pMIDIOut, long lNum, long lLen) {
+	if (lLen > 0) {
+		pMIDIOut->m_llMessageNum += lNum;
+		pMIDIOut->m_llByteNum += lLen;
+	}
+}
+
+
+/* 時刻指定出力キュー(20261019追加) ******************************************/
+
+/* 呼び出し側が(出力時刻, MIDIメッセージ)を先行して登録し、専用スレッドが時刻に出力する。 */
+/* キューは登録側(MIDIOut_Enqueue系関数)と出力スレッドの単一書き込み・単一読み込みの */
+/* リングバッファであり、出力時刻は登録順に単調増加していなければならない。 */
+/* (前の項目より早い時刻を指定した場合は、前の項目の出力直後に出力される) */
+
+/* 出力キューの項目 */
+typedef struct tagMIDIOutQueueItem {
+	int64_t m_llDeadline; /* 出力時刻[マイクロ秒] */
+	long  m_lLen; /* MIDIメッセージの長さ[バイト] */
+	unsigned long m_ulMsg; /* 3バイト以下のMIDIメッセージ */
+	unsigned char* m_pSysx; /* SYSXの場合、mallocで確保したデータ(それ以外はNULL) */
+} MIDIOutQueueItem;
+
+/* 出力キュー */
+typedef struct tagMIDIOutQueue {
+	MIDIOutQueueItem* m_pItem; /* 項目の配列 */
+	long  m_lSize; /* 項目の数(2のべき乗) */
+	volatile long m_lReadPosition; /* 出力スレッドのみが更新する */
+	volatile long m_lWritePosition; /* 登録側のみが更新する */
+	volatile long m_bExit; /* 出力スレッドの終了要求 */
+	volatile long m_bClear; /* 未出力の項目の破棄要求(出力スレッドが0に戻す) */
+	volatile long m_lClearPosition; /* 破棄要求時の書き込み位置(ここまでを破棄する) */
+	void* m_hEvent; /* 出力スレッドを起こすイベント */
+	void* m_hClearEvent; /* 破棄要求の完了を通知するイベント */
+	void* m_hThread; /* 出力スレッド */
+	long  m_lLateCount; /* 出力時刻より1ミリ秒以上遅れて出力した回数 */
+} MIDIOutQueue;
+
+/* 出力キューの項目を出力する(出力スレッド)(隠蔽) */
+static void MIDIOut_PutQueueItem (MIDI* pMIDIOut, MIDIOutQueueItem* pItem, long bDiscard) {
+	if (pItem->m_pSysx) {
+		if (!bDiscard) {
+			MIDIOut_AddSentStats (pMIDIOut, 1, MIDIIO_BACKEND (pMIDIOut)->m_pfnPutLongMessage 
+				(pMIDIOut, pItem->m_pSysx, pItem->m_lLen));
+		}
+		free (pItem->m_pSysx);
+		pItem->m_pSysx = NULL;
+	}
+	else if (!bDiscard) {
+		MIDIOut_AddSentStats (pMIDIOut, 1, MIDIIO_BACKEND (pMIDIOut)->m_pfnPutShortMessage 
+			(pMIDIOut, pItem->m_ulMsg, pItem->m_lLen));
+	}
+}
+
+/* 出力スレッド(隠蔽) */
+static DWORD WINAPI MIDIOut_QueueThreadProc (LPVOID pParam) {
+	MIDI* pMIDIOut = (MIDI*)pParam;
+	MIDIOutQueue* pQueue = (MIDIOutQueue*)(pMIDIOut->m_pQueue);
+	long lMask = pQueue->m_lSize - 1;
+	long lReadPosition, lWritePosition;
+	MIDIOutQueueItem* pItem;
+	int64_t llRemain;
+	timeBeginPeriod (1);
+	while (!pQueue->m_bExit) {
+		lReadPosition = pQueue->m_lReadPosition;
+		lWritePosition = MIDIIO_LoadAcquire (&(pQueue->m_lWritePosition));
+		/* 破棄要求があれば、要求時までに登録された未出力の項目を捨てる */
+		/* (要求が時間切れ後に処理される場合でも、その後に登録された項目は捨てない。 */
+		/* 要求時の位置を既に出力し終えている場合は何も捨てない)(20261019変更) */
+		if (MIDIIO_LoadAcquire (&(pQueue->m_bClear))) {
+			long lClearPosition = pQueue->m_lClearPosition;
+			if (((lClearPosition - lReadPosition) & lMask) <= ((lWritePosition - lReadPosition) & lMask)) {
+				for (; lReadPosition != lClearPosition; lReadPosition = (lReadPosition + 1) & lMask) {
+					MIDIOut_PutQueueItem (pMIDIOut, pQueue->m_pItem + lReadPosition, 1);
+				}
+			}
+			MIDIIO_StoreRelease (&(pQueue->m_lReadPosition), lReadPosition);
+			MIDIIO_StoreRelease (&(pQueue->m_bClear), 0);
+			SetEvent ((HANDLE)(pQueue->m_hClearEvent));
+			continue;
+		}
+		/* キューが空であれば登録されるまで眠る */
+		if (lReadPosition == lWritePosition) {
+			WaitForSingleObject ((HANDLE)(pQueue->m_hEvent), INFINITE);
+			continue;
+		}
+		pItem = pQueue->m_pItem + lReadPosition;
+		llRemain = pItem->m_llDeadline - MIDIClock_QueryMonotonicMicrosec ();
+		/* 出力時刻まで2ミリ秒以上あれば、1ミリ秒手前まで眠る(新しい登録や破棄要求でも起きる) */
+		if (llRemain >= 2000) {
+			WaitForSingleObject ((HANDLE)(pQueue->m_hEvent), (DWORD)(llRemain / 1000 - 1));
+			continue;
+		}
+		/* 1ミリ秒以上あれば1ミリ秒だけ眠る(timeBeginPeriod (1)により概ね1ミリ秒で起きる) */
+		else if (llRemain >= 1000) {
+			WaitForSingleObject ((HANDLE)(pQueue->m_hEvent), 1);
+			continue;
+		}
+		/* 残り1ミリ秒未満はスリープの精度が足りないため、出力時刻まで回って待つ */
+		/* (回る時間は最大1ミリ秒に限られる)(20261019変更) */
+		else if (llRemain > 0) {
+			while (MIDIClock_QueryMonotonicMicrosec () < pItem->m_llDeadline) {
+				YieldProcessor ();
+			}
+		}
+		if (llRemain <= -1000) {
+			pQueue->m_lLateCount++;
+		}
+		MIDIOut_PutQueueItem (pMIDIOut, pItem, 0);
+		MIDIIO_StoreRelease (&(pQueue->m_lReadPosition), (lReadPosition + 1) & lMask);
+	}
+	timeEndPeriod (1);
+	return 0;
+}
+
+/* 出力キューと出力スレッドを作成する(隠蔽) */
+static long MIDIOut_CreateQueue (MIDI* pMIDIOut, long lSize) {
+	MIDIOutQueue* pQueue;
+	_ASSERT ((lSize & (lSize - 1)) == 0);
+	pQueue = (MIDIOutQueue*)calloc (1, sizeof (MIDIOutQueue));
+	if (pQueue == NULL) {
+		_RPTF0 (_CRT_WARN, "エラー：MIDIOut_CreateQueue内でcallocがNULLを返しました。\r\n");
+		return 0;
+	}
+	pQueue->m_pItem = (MIDIOutQueueItem*)calloc (lSize, sizeof (MIDIOutQueueItem));
+	if (pQueue->m_pItem == NULL) {
+		free (pQueue);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIOut_CreateQueue内でcallocがNULLを返しました。\r\n");
+		return 0;
+	}
+	pQueue->m_lSize = lSize;
+	pQueue->m_hEvent = CreateEvent (NULL, FALSE, FALSE, NULL);
+	if (pQueue->m_hEvent == NULL) {
+		free (pQueue->m_pItem);
+		free (pQueue);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIOut_CreateQueue内でCreateEventがNULLを返しました。\r\n");
+		return 0;
+	}
+	pQueue->m_hClearEvent = CreateEvent (NULL, FALSE, FALSE, NULL);
+	if (pQueue->m_hClearEvent == NULL) {
+		CloseHandle ((HANDLE)(pQueue->m_hEvent));
+		free (pQueue->m_pItem);
+		free (pQueue);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIOut_CreateQueue内でCreateEventがNULLを返しました。\r\n");
+		return 0;
+	}
+	pMIDIOut->m_pQueue = pQueue;
+	pQueue->m_hThread = CreateThread (NULL, 0, MIDIOut_QueueThreadProc, pMIDIOut, 0, NULL);
+	if (pQueue->m_hThread == NULL) {
+		pMIDIOut->m_pQueue = NULL;
+		CloseHandle ((HANDLE)(pQueue->m_hClearEvent));
+		CloseHandle ((HANDLE)(pQueue->m_hEvent));
+		free (pQueue->m_pItem);
+		free (pQueue);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIOut_CreateQueue内でCreateThreadがNULLを返しました。\r\n");
+		return 0;
+	}
+	SetThreadPriority ((HANDLE)(pQueue->m_hThread), THREAD_PRIORITY_TIME_CRITICAL);
+	return 1;
+}
+
+/* 出力スレッドを停止し、出力キューを削除する(未出力の項目は捨てる)(隠蔽) */
+static void MIDIOut_DeleteQueue (MIDI* pMIDIOut) {
+	MIDIOutQueue* pQueue = (MIDIOutQueue*)(pMIDIOut->m_pQueue);
+	long lMask;
+	if (pQueue == NULL) {
+		return;
+	}
+	MIDIIO_StoreRelease (&(pQueue->m_bExit), 1);
+	SetEvent ((HANDLE)(pQueue->m_hEvent));
+	WaitForSingleObject ((HANDLE)(pQueue->m_hThread), INFINITE);
+	CloseHandle ((HANDLE)(pQueue->m_hThread));
+	CloseHandle ((HANDLE)(pQueue->m_hClearEvent));
+	CloseHandle ((HANDLE)(pQueue->m_hEvent));
+	lMask = pQueue->m_lSize - 1;
+	for (; pQueue->m_lReadPosition != pQueue->m_lWritePosition; 
+		pQueue->m_lReadPosition = (pQueue->m_lReadPosition + 1) & lMask) {
+		MIDIOut_PutQueueItem (pMIDIOut, pQueue->m_pItem + pQueue->m_lReadPosition, 1);
+	}
+	free (pQueue->m_pItem);
+	free (pQueue);
+	pMIDIOut->m_pQueue = NULL;
+}
 
 /* MIDI出力デバイスの数を調べる */
 long __stdcall MIDIOut_GetDeviceNum () {
@@ -240,6 +1277,7 @@ long __stdcall MIDIOut_GetDeviceNameW (long lID, wchar_t* pszDeviceName, long lL
 /* MIDI出力デバイスを開く(ANSI) */
 MIDIOut* __stdcall MIDIOut_OpenA (const char* pszDeviceName) {
 	MIDIOUTCAPSA tagMIDIOutCaps;
+	const MIDIIOBackend* pBackend = &g_theMIDIOutWinMMBackend;
 	MIDI* pMIDIOut;
 	long lDeviceNameLen;
 	int nNumDevices, i, nRet;
@@ -254,6 +1292,20 @@ MIDIOut* __stdcall MIDIOut_OpenA (const char* pszDeviceName) {
 		strcmp (pszDeviceName, MIDIIO_NONEJ) == 0) {
 		return NULL;
 	}
+	/* デバイス名が"Null"である場合は何も出力しない仮想デバイスとする(20261019追加) */
+	else if (strcmp (pszDeviceName, MIDIIO_NULL) == 0) {
+		pBackend = &g_theMIDIOutNullBackend;
+		i = 0;
+	}
+	/* デバイス名が"Loopback n"である場合は同名のMIDI入力へ折り返す(20261019追加) */
+	else if ((i = MIDIIO_GetLoopbackPortA (pszDeviceName)) >= 0) {
+		pBackend = &g_theMIDIOutLoopbackBackend;
+	}
+	/* デバイス名が"Shared 名前"である場合は共有メモリを介して別プロセスへ出力する(20261019追加) */
+	else if (MIDIIO_IsSharedNameA (pszDeviceName)) {
+		pBackend = &g_theMIDIOutSharedBackend;
+		i = 0;
+	}
 	/* デバイス名が"default"か"デフォルト"か"MIDI Mapper"か"MIDI マッパー"である場合は */
 	/* 強制的にMIDIマッパー(-1)とする。 */
 	else if (strcmp (pszDeviceName, MIDIIO_DEFAULT) == 0 ||
@@ -287,30 +1339,29 @@ MIDIOut* __stdcall MIDIOut_OpenA (const char* pszDeviceName) {
 	lDeviceNameLen = size_ttolong (strlen (pszDeviceName) + 1);
 	pMIDIOut->m_pDeviceName = calloc (lDeviceNameLen, sizeof (char));
 	if (pMIDIOut->m_pDeviceName == NULL) {
+		free (pMIDIOut);
 		_RPTF0 (_CRT_WARN, "エラー：MIDIOut_OpenA内でcallocがNULLを返しました。\r\n");
 		return NULL;
 	}
 	strncpy_s ((char*)(pMIDIOut->m_pDeviceName), lDeviceNameLen, pszDeviceName, lDeviceNameLen - 1);
 	pMIDIOut->m_lMode = MIDIIO_MODEOUT;
+	pMIDIOut->m_pBackend = pBackend;
+	pMIDIOut->m_lSysxTimeout = MIDIIO_SYSXTIMEOUT;
 	/* MIDI出力デバイスのオープン */
-	nRet = midiOutOpen ((HMIDIOUT*)&(pMIDIOut->m_pDeviceHandle), i, 
-		(DWORD_PTR)MidiOutProc, (DWORD_PTR)pMIDIOut, CALLBACK_FUNCTION);
-	if (nRet != 0) {
-		free (pMIDIOut->m_pBuf);
+	nRet = pBackend->m_pfnOpen (pMIDIOut, i);
+	if (nRet == 0) {
+		free (pMIDIOut->m_pDeviceName);
 		free (pMIDIOut);
-		_RPTF1 (_CRT_WARN, "エラー：MIDIOut_OpenA内でmidiOutOpenが%dを返しました。\r\n", nRet);
+		_RPTF1 (_CRT_WARN, "エラー：MIDIOut_OpenA内でMIDI出力デバイスを開けませんでした。-%s\r\n", pszDeviceName);
 		return NULL;
 	}
-	/* SYSXヘッダーの領域設定(20070520) */
-	for (i = 0; i < MIDIIO_SYSXNUM; i++) {
-		pMIDIOut->m_pSysxHeader[i] = NULL;
-	}
 	return pMIDIOut;
 }
 
 /* MIDI出力デバイスを開く(UNICODE) */
 MIDIOut* __stdcall MIDIOut_OpenW (const wchar_t* pszDeviceName) {
 	MIDIOUTCAPSW tagMIDIOutCaps;
+	const MIDIIOBackend* pBackend = &g_theMIDIOutWinMMBackend;
 	MIDI* pMIDIOut;
 	long lDeviceNameLen;
 	int nNumDevices, i, nRet;
@@ -325,6 +1376,20 @@ MIDIOut* __stdcall MIDIOut_OpenW (const wchar_t* pszDeviceName) {
 		wcscmp (pszDeviceName, L"(なし)") == 0) {
 		return NULL;
 	}
+	/* デバイス名が"Null"である場合は何も出力しない仮想デバイスとする(20261019追加) */
+	else if (wcscmp (pszDeviceName, L"Null") == 0) {
+		pBackend = &g_theMIDIOutNullBackend;
+		i = 0;
+	}
+	/* デバイス名が"Loopback n"である場合は同名のMIDI入力へ折り返す(20261019追加) */
+	else if ((i = MIDIIO_GetLoopbackPortW (pszDeviceName)) >= 0) {
+		pBackend = &g_theMIDIOutLoopbackBackend;
+	}
+	/* デバイス名が"Shared 名前"である場合は共有メモリを介して別プロセスへ出力する(20261019追加) */
+	else if (MIDIIO_IsSharedNameW (pszDeviceName)) {
+		pBackend = &g_theMIDIOutSharedBackend;
+		i = 1;
+	}
 	/* デバイス名が"default"か"デフォルト"か"MIDI Mapper"か"MIDI マッパー"である場合は */
 	/* 強制的にMIDIマッパー(-1)とする。 */
 	else if (wcscmp (pszDeviceName, L"Default") == 0 ||
@@ -358,57 +1423,37 @@ MIDIOut* __stdcall MIDIOut_OpenW (const wchar_t* pszDeviceName) {
 	lDeviceNameLen = size_ttolong (wcslen (pszDeviceName) + 1);
 	pMIDIOut->m_pDeviceName = calloc (lDeviceNameLen, sizeof (wchar_t));
 	if (pMIDIOut->m_pDeviceName == NULL) {
+		free (pMIDIOut);
 		_RPTF0 (_CRT_WARN, "エラー：MIDIOut_OpenW内でcallocがNULLを返しました。\r\n");
 		return NULL;
 	}
 	wcsncpy_s ((wchar_t*)(pMIDIOut->m_pDeviceName), lDeviceNameLen, pszDeviceName, lDeviceNameLen - 1);
 	pMIDIOut->m_lMode = MIDIIO_MODEOUT;
+	pMIDIOut->m_pBackend = pBackend;
+	pMIDIOut->m_lSysxTimeout = MIDIIO_SYSXTIMEOUT;
 	/* MIDI出力デバイスのオープン */
-	nRet = midiOutOpen ((HMIDIOUT*)&(pMIDIOut->m_pDeviceHandle), i, 
-		(DWORD_PTR)MidiOutProc, (DWORD_PTR)pMIDIOut, CALLBACK_FUNCTION);
-	if (nRet != 0) {
-		free (pMIDIOut->m_pBuf);
+	nRet = pBackend->m_pfnOpen (pMIDIOut, i);
+	if (nRet == 0) {
+		free (pMIDIOut->m_pDeviceName);
 		free (pMIDIOut);
-		_RPTF1 (_CRT_WARN, "エラー：MIDIOut_OpenW内でmidiOutOpenが%dを返しました。\r\n", nRet);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIOut_OpenW内でMIDI出力デバイスを開けませんでした。\r\n");
 		return NULL;
 	}
-	/* SYSXヘッダーの領域設定(20070520) */
-	for (i = 0; i < MIDIIO_SYSXNUM; i++) {
-		pMIDIOut->m_pSysxHeader[i] = NULL;
-	}
 	return pMIDIOut;
 }
 
 
 /* MIDI出力デバイスを閉じる */
 long __stdcall MIDIOut_Close (MIDIOut* pMIDIOut) {
-	int nRet;
-	int i, t;
 	if (pMIDIOut == NULL) {
 		return 1;
 	}
 	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
-	/* MIDI出力リセット */
-	midiOutReset (pMIDIOut->m_pDeviceHandle);
-	/* すべてのSYSXヘッダーに対してMOM_DONEを待つ(100回試行) */
-	for (t = 0; t < 100; t++) {
-		for (i = 0; i < MIDIIO_SYSXNUM; i++) {
-			if (pMIDIOut->m_pSysxHeader[i] != NULL) {
-				break;
-			}
-		}
-		if (i >= MIDIIO_SYSXNUM) {
-			break;
-		}
-		Sleep (10);
-	}
-	if (t == 100) {
-		_RPTF0 (_CRT_WARN, "警告：MIDIOut_Close内でMOM_DONEがコールバックされていないバッファがあります。\r\n");
-	}
+	/* 出力スレッドを停止する(20261019追加) */
+	MIDIOut_DeleteQueue (pMIDIOut);
 	/* MIDI出力デバイスを閉じる */
-	nRet = midiOutClose (pMIDIOut->m_pDeviceHandle);
-	if (nRet != MMSYSERR_NOERROR) {
-		_RPTF1 (_CRT_WARN, "エラー：MIDIOut_Close内でmidiOutCloseが%dを返しました。\r\n", nRet);
+	if (MIDIIO_BACKEND (pMIDIOut)->m_pfnClose (pMIDIOut) == 0) {
+		_RPTF0 (_CRT_WARN, "エラー：MIDIOut_Close内でMIDI出力デバイスを閉じられませんでした。\r\n");
 		return 0;
 	}
 	/* このオブジェクトの解放 */
@@ -450,75 +1495,33 @@ MIDIOut* __stdcall MIDIOut_ReopenW (MIDIOut* pMIDIOut, const wchar_t* pszDeviceN
 
 /* MIDI出力デバイスをリセットする */
 long __stdcall MIDIOut_Reset (MIDIOut* pMIDIOut) {
-	int nRet = 0;
 	_ASSERT (pMIDIOut);
 	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
-	nRet = midiOutReset (pMIDIOut->m_pDeviceHandle);
-	if (nRet != MMSYSERR_NOERROR) {
-		_RPTF1 (_CRT_WARN, "エラー：MIDIOut_Reset内でmidiOutResetが%dを返しました。\r\n", nRet);
-		return 0;
+	return MIDIIO_BACKEND (pMIDIOut)->m_pfnReset (pMIDIOut);
+}
+
+/* 1メッセージとして出力できるSysxの最大長[バイト]を取得する(隠蔽)(20261019追加) */
+/* winmmバックエンドはMIDIOut_SetSysxBufferで設定したSYSX送信バッファ1つの大きさ、 */
+/* その他のバックエンドはMIDIIO_MAXSYSXSIZEとする */
+static long MIDIOut_GetMaxSysxLen (MIDI* pMIDIOut) {
+	if (MIDIIO_BACKEND (pMIDIOut) == &g_theMIDIOutWinMMBackend && pMIDIOut->m_lSysxPoolSize > 0) {
+		return pMIDIOut->m_lSysxPoolSize;
 	}
-	return 1;
+	return MIDIIO_MAXSYSXSIZE;
 }
 
 /* MIDI出力デバイスにMIDIメッセージを1つ出力する */
 long __stdcall MIDIOut_PutMIDIMessage (MIDIOut* pMIDIOut, unsigned char* pMessage, long lLen) {
+	long lRet;
 	_ASSERT (pMIDIOut);
 	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
 	_ASSERT (pMessage);
-	_ASSERT (1 <= lLen && lLen <= MIDIIO_MAXSYSXSIZE);
+	_ASSERT (1 <= lLen && lLen <= MIDIOut_GetMaxSysxLen (pMIDIOut));
 	/* システムエクスクルーシヴメッセージ */
 	if (lLen >= 1 && *pMessage == 0xF0) {
-		int nRet;
-		int i;
-		/* 空いているSysxHeaderを探す。 */
-		for (i = 0; i < MIDIIO_SYSXNUM; i++) {
-			if (pMIDIOut->m_pSysxHeader[i] == NULL) {
-				break;
-			}
-		}
-		if (i >= MIDIIO_SYSXNUM) {
-			_RPTF0 (_CRT_WARN, "エラー：MIDIOut_PutMIDIMessageで使用可能なSYSXヘッダーがもはやありません。\r\n");
-			return 0;
-		}
-		/* SysxHeaderのバッファ確保 */
-
-		pMIDIOut->m_pSysxHeader[i] =
-			(MIDIHDR*)HeapAlloc(GetProcessHeap (), HEAP_ZERO_MEMORY, sizeof (MIDIHDR));
-		if ((MIDIHDR*)(pMIDIOut->m_pSysxHeader[i]) == NULL) {
-			_RPTF0 (_CRT_WARN, "エラー：MIDIOut_PutMIDIMessageでHeapAllocがNULLを返しました。\r\n");
-			return 0;
-		}
-		((MIDIHDR*)(pMIDIOut->m_pSysxHeader[i]))->lpData = 
-			(char*)HeapAlloc (GetProcessHeap (), HEAP_NO_SERIALIZE, MIN (lLen, MIDIIO_MAXSYSXSIZE));
-		if (((MIDIHDR*)(pMIDIOut->m_pSysxHeader[i]))->lpData == NULL) {
-			_RPTF0 (_CRT_WARN, "エラー：MIDIOut_PutMIDIMessageでHeapAllocがNULLを返しました。\r\n");
-			return 0;
-		}
-		/* SYSXヘッダー内部のデータ用領域にMIDIメッセージをコピー */
-		((MIDIHDR*)(pMIDIOut->m_pSysxHeader[i]))->dwBufferLength = MIN (lLen, MIDIIO_MAXSYSXSIZE);
-		memcpy (((MIDIHDR*)(pMIDIOut->m_pSysxHeader[i]))->lpData, pMessage, MIN (lLen, MIDIIO_MAXSYSXSIZE));
-		((MIDIHDR*)(pMIDIOut->m_pSysxHeader[i]))->dwBytesRecorded = MIN (lLen, MIDIIO_MAXSYSXSIZE);
-		/* midiOutPrepareHeader */
-		nRet = midiOutPrepareHeader 
-			(pMIDIOut->m_pDeviceHandle, ((MIDIHDR*)(pMIDIOut->m_pSysxHeader[i])), sizeof (MIDIHDR));
-		if (nRet != MMSYSERR_NOERROR) {
-			_RPTF1 (_CRT_WARN, "エラー：MIDIOut_PutMIDIMessage内でmidiOutPrepareHeaderが%dを返しました。\r\n", nRet);
-			return 0;
-		}
-		/* midiOutLongMsg...この関数実行直後かやや後にMOM_DONEがコールバックされる */
-		nRet = midiOutLongMsg 
-			(pMIDIOut->m_pDeviceHandle, ((MIDIHDR*)(pMIDIOut->m_pSysxHeader[i])), sizeof(MIDIHDR));
-		if (nRet != MMSYSERR_NOERROR) {
-			_RPTF1 (_CRT_WARN, "エラー：MIDIOut_PutMIDIMessage内でmidiOutLongMsgが%dを返しました。\r\n", nRet);
-			nRet = midiOutUnprepareHeader 
-				(pMIDIOut->m_pDeviceHandle, ((MIDIHDR*)(pMIDIOut->m_pSysxHeader[i])), sizeof (MIDIHDR));
-			HeapFree (GetProcessHeap (), 0, ((MIDIHDR*)(pMIDIOut->m_pSysxHeader[i]))->lpData);
-			HeapFree (GetProcessHeap (), 0, ((MIDIHDR*)(pMIDIOut->m_pSysxHeader[i])));
-			pMIDIOut->m_pSysxHeader[i] = NULL;
-			return 0;
-		}
-		return lLen;
+		lRet = MIDIIO_BACKEND (pMIDIOut)->m_pfnPutLongMessage (pMIDIOut, pMessage, lLen);
+		MIDIOut_AddSentStats (pMIDIOut, 1, lRet);
+		return lRet;
 	}
 	/* 通常のMIDIメッセージ又はシステムリアルタイムメッセージ又はシステムコモンメッセージ */
 	else if (1 <= lLen && lLen <= 3) {
@@ -534,8 +1537,9 @@ long __stdcall MIDIOut_PutMIDIMessage (MIDIOut* pMIDIOut, unsigned char* pMessag
 			lMsg = *(pMessage) + (*(pMessage + 1) << 8) + (*(pMessage + 2) << 16);
 			break;
 		}
-		midiOutShortMsg (pMIDIOut->m_pDeviceHandle, lMsg);
-		return lLen;
+		lRet = MIDIIO_BACKEND (pMIDIOut)->m_pfnPutShortMessage (pMIDIOut, lMsg, lLen);
+		MIDIOut_AddSentStats (pMIDIOut, 1, lRet);
+		return lRet;
 	}
 	/* 異常なMIDIメッセージ */
 	else {
@@ -544,109 +1548,307 @@ long __stdcall MIDIOut_PutMIDIMessage (MIDIOut* pMIDIOut, unsigned char* pMessag
 	}
 }
 
+/* MIDI出力デバイスに3バイト以下のMIDIメッセージをまとめて出力する(20261019追加) */
+/* 各メッセージはmidiOutShortMsgと同じ形式(下位バイトからステータス・データ1・データ2)とする。 */
+/* ステータスバイトのないメッセージ及びSYSXは出力しない。戻り値は出力したメッセージの数。 */
+long __stdcall MIDIOut_PutShortMessages (MIDIOut* pMIDIOut, const uint32_t* pMessage, long lNum) {
+	const MIDIIOBackend* pBackend;
+	long i, lLen;
+	long lRet = 0;
+	long lByteNum = 0;
+	_ASSERT (pMIDIOut);
+	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
+	_ASSERT (pMessage || lNum == 0);
+	pBackend = MIDIIO_BACKEND (pMIDIOut);
+	/* まとめて出力できるバックエンドにはそのまま渡す */
+	if (pBackend->m_pfnPutShortMessages) {
+		lRet = pBackend->m_pfnPutShortMessages (pMIDIOut, pMessage, lNum);
+		if (lRet > 0) {
+			for (i = 0; i < lNum; i++) {
+				lByteNum += MIDIIO_GetShortMessageLen (pMessage[i]);
+			}
+			MIDIOut_AddSentStats (pMIDIOut, lRet, lByteNum);
+		}
+		return lRet;
+	}
+	for (i = 0; i < lNum; i++) {
+		lLen = MIDIIO_GetShortMessageLen (pMessage[i]);
+		if (lLen == 0) {
+			_RPTF1 (_CRT_WARN, "警告：MIDIOut_PutShortMessages内で異常なMIDIメッセージ(0x%08X)を無視しました。\r\n", pMessage[i]);
+			continue;
+		}
+		if (pBackend->m_pfnPutShortMessage (pMIDIOut, pMessage[i], lLen)) {
+			lByteNum += lLen;
+			lRet++;
+		}
+	}
+	MIDIOut_AddSentStats (pMIDIOut, lRet, lByteNum);
+	return lRet;
+}
+
 /* MIDI出力デバイスに1バイト出力する */
 long __stdcall MIDIOut_PutByte (MIDIOut* pMIDIOut, unsigned char c) {
 	_ASSERT (pMIDIOut);
 	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
-	midiOutShortMsg (pMIDIOut->m_pDeviceHandle, (unsigned long)c);
+	MIDIOut_AddSentStats (pMIDIOut, 1, 
+		MIDIIO_BACKEND (pMIDIOut)->m_pfnPutShortMessage (pMIDIOut, (unsigned long)c, 1));
 	return 1;
 }
 
 /* MIDI出力デバイスに任意長のデータを出力する */
+/* (MIDIStream_Splitでメッセージに分割して出力する)(20261019変更) */
 long __stdcall MIDIOut_PutBytes (MIDIOut* pMIDIOut, unsigned char* pData, long lLen) {
 	unsigned char cRunningStatus = 0;
+	unsigned char cPrevRunningStatus;
 	long lRet = 0;
-	long lLen2 = 0;
-	unsigned char* p1 = pData;
+	long lPosition = 0;
+	long lSplitLen, lOffset, lMessageLen, lChunkLen, lSentLen;
+	unsigned char* p1;
 	_ASSERT (pMIDIOut);
 	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
 	if (pMIDIOut == NULL) {
 		return 0;
 	}
-	if (pMIDIOut->m_lMode != MIDIIO_MODEOUT) {
+	if (pMIDIOut->m_lMode != MIDIIO_MODEOUT) {
+		return 0;
+	}
+	while (lPosition < lLen) {
+		cPrevRunningStatus = cRunningStatus;
+		lSplitLen = MIDIStream_Split 
+			(pData + lPosition, lLen - lPosition, &cRunningStatus, &lOffset, &lMessageLen);
+		if (lOffset > 0) {
+			_RPTF0 (_CRT_WARN, "エラー：MIDIOut_PutBytes内で異常なMIDIメッセージを検出しました。\r\n");
+		}
+		p1 = pData + lPosition + lOffset;
+		lPosition += lSplitLen;
+		if (lMessageLen == 0) {
+			continue;
+		}
+		/* システムエクスクルーシヴメッセージ(又はその続き)は、送信できる大きさに分けて送る */
+		if (*p1 == 0xF0 || *p1 < 0x80 && cPrevRunningStatus == 0xF0) {
+			while (lMessageLen > 0) {
+				lChunkLen = MIN (lMessageLen, MIDIOut_GetMaxSysxLen (pMIDIOut));
+				lSentLen = MIDIIO_BACKEND (pMIDIOut)->m_pfnPutLongMessage (pMIDIOut, p1, lChunkLen);
+				MIDIOut_AddSentStats (pMIDIOut, 1, lSentLen);
+				lRet += lSentLen;
+				p1 += lChunkLen;
+				lMessageLen -= lChunkLen;
+			}
+		}
+		/* 通常のMIDIメッセージ(ランニングステータスの場合はデータバイトのみ) */
+		else {
+			lRet += MIDIOut_PutMIDIMessage (pMIDIOut, p1, lMessageLen);
+		}
+	}
+	return lRet;
+}
+
+/* このMIDI入力デバイスの名前を取得する(ANSI)(20120415追加) */
+long __stdcall MIDIOut_GetThisDeviceNameA (MIDIOut* pMIDIOut, char* pszDeviceName, long lLen) {
+	long lLen2;
+	_ASSERT (pMIDIOut);
+	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
+	memset (pszDeviceName, 0, lLen);
+	lLen2 = size_ttolong (strlen (pMIDIOut->m_pDeviceName));
+	strncpy_s (pszDeviceName, lLen, pMIDIOut->m_pDeviceName, CLIP (0, lLen2, lLen - 1));
+	return CLIP (0, lLen2, lLen - 1);
+}
+
+/* このMIDI入力デバイスの名前を取得する(UNICODE)(20120415追加) */
+long __stdcall MIDIOut_GetThisDeviceNameW (MIDIOut* pMIDIOut, wchar_t* pszDeviceName, long lLen) {
+	long lLen2;
+	_ASSERT (pMIDIOut);
+	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
+	memset (pszDeviceName, 0, lLen * sizeof (wchar_t));
+	lLen2 = size_ttolong (wcslen (pMIDIOut->m_pDeviceName));
+	wcsncpy_s (pszDeviceName, lLen, pMIDIOut->m_pDeviceName, CLIP (0, lLen2, lLen - 1));
+	return CLIP (0, lLen2, lLen - 1);
+}
+
+/* SYSX送信バッファの数と1つあたりの大きさを設定する(20261019追加) */
+long __stdcall MIDIOut_SetSysxBuffer (MIDIOut* pMIDIOut, long lNumBuffer, long lBufferSize) {
+	void* pOldSysxPool;
+	long lOldNumBuffer, lOldBufferSize;
+	_ASSERT (pMIDIOut);
+	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
+	if (lNumBuffer < 1 || lNumBuffer > MIDIIO_SYSXOUTMAXNUM) {
+		return 0;
+	}
+	if (lBufferSize < 2 || lBufferSize > MIDIIO_SYSXOUTMAXSIZE) {
+		return 0;
+	}
+	/* winmm以外のバックエンドはSYSX送信バッファを持たない */
+	if (MIDIIO_BACKEND (pMIDIOut) != &g_theMIDIOutWinMMBackend) {
+		return 1;
+	}
+	/* 送信中のSYSX送信バッファがなくなってから確保し直す */
+	/* 回収(不準備)できないバッファがある場合は古いバッファを解放せずに失敗とする */
+	if (MIDIOut_WinMMFlushSysx (pMIDIOut) == 0) {
+		_RPTF0 (_CRT_WARN, "エラー：MIDIOut_SetSysxBuffer内で送信中のSYSX送信バッファが回収できません。\r\n");
+		return 0;
+	}
+	pOldSysxPool = pMIDIOut->m_pSysxPool;
+	lOldNumBuffer = pMIDIOut->m_lSysxPoolNum;
+	lOldBufferSize = pMIDIOut->m_lSysxPoolSize;
+	if (MIDIOut_WinMMAllocSysx (pMIDIOut, lNumBuffer, lBufferSize) == 0) {
+		pMIDIOut->m_pSysxPool = pOldSysxPool;
+		pMIDIOut->m_lSysxPoolNum = lOldNumBuffer;
+		pMIDIOut->m_lSysxPoolSize = lOldBufferSize;
+		return 0;
+	}
+	HeapFree (GetProcessHeap (), 0, pOldSysxPool);
+	return 1;
+}
+
+/* SYSX送信バッファが空くのを待つ最大時間[ミリ秒]を設定する(20261019追加) */
+long __stdcall MIDIOut_SetSysxTimeout (MIDIOut* pMIDIOut, long lTimeout) {
+	_ASSERT (pMIDIOut);
+	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
+	pMIDIOut->m_lSysxTimeout = (lTimeout < 0 ? -1 : lTimeout);
+	return 1;
+}
+
+/* 送信中のSYSX送信バッファの数を取得する(20261019追加) */
+long __stdcall MIDIOut_GetSysxPendingNum (MIDIOut* pMIDIOut) {
+	_ASSERT (pMIDIOut);
+	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
+	if (MIDIIO_BACKEND (pMIDIOut) != &g_theMIDIOutWinMMBackend) {
+		return 0;
+	}
+	MIDIOut_WinMMReclaimSysx (pMIDIOut);
+	return (long)(pMIDIOut->m_ulSysxHead - pMIDIOut->m_ulSysxTail);
+}
+
+/* SYSX送信バッファが空くのを待った回数を取得する(20261019追加) */
+long __stdcall MIDIOut_GetSysxWaitCount (MIDIOut* pMIDIOut) {
+	_ASSERT (pMIDIOut);
+	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
+	return pMIDIOut->m_lSysxWaitCount;
+}
+
+/* SYSXを送信できずに捨てた回数を取得する(20261019追加) */
+long __stdcall MIDIOut_GetSysxDropCount (MIDIOut* pMIDIOut) {
+	_ASSERT (pMIDIOut);
+	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
+	return pMIDIOut->m_lSysxDropCount;
+}
+
+/* MIDI出力デバイスの出力キューにMIDIメッセージを登録する(20261019追加) */
+/* llDeadlineは出力時刻[マイクロ秒](MIDIClock_GetMonotonicMicrosecと同じ基準)であり、 */
+/* 登録順に単調増加していなければならない。過去の時刻を指定した場合は直ちに出力する。 */
+/* 最初の呼び出しで出力キューと出力スレッドを作成する。キューが一杯の場合は0を返す。 */
+/* キューを使用している間は、このMIDI出力へ他の関数で直接出力しないこと。 */
+long __stdcall MIDIOut_EnqueueMIDIMessage 
+(MIDIOut* pMIDIOut, int64_t llDeadline, unsigned char* pMessage, long lLen) {
+	MIDIOutQueue* pQueue;
+	MIDIOutQueueItem* pItem;
+	long lMask, lWritePosition, lReadPosition;
+	_ASSERT (pMIDIOut);
+	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
+	_ASSERT (pMessage);
+	if (lLen < 1 || lLen > MIDIOut_GetMaxSysxLen (pMIDIOut)) {
+		_RPTF0 (_CRT_WARN, "エラー：MIDIOut_EnqueueMIDIMessage内で異常なMIDIメッセージが検出されました。\r\n");
+		return 0;
+	}
+	if (*pMessage != 0xF0 && lLen > 3) {
+		_RPTF0 (_CRT_WARN, "エラー：MIDIOut_EnqueueMIDIMessage内で異常なMIDIメッセージが検出されました。\r\n");
+		return 0;
+	}
+	if (pMIDIOut->m_pQueue == NULL) {
+		if (MIDIOut_CreateQueue (pMIDIOut, MIDIIO_QUEUESIZE) == 0) {
+			return 0;
+		}
+	}
+	pQueue = (MIDIOutQueue*)(pMIDIOut->m_pQueue);
+	lMask = pQueue->m_lSize - 1;
+	lWritePosition = pQueue->m_lWritePosition;
+	lReadPosition = MIDIIO_LoadAcquire (&(pQueue->m_lReadPosition));
+	if (((lWritePosition + 1) & lMask) == lReadPosition) {
+		_RPTF0 (_CRT_WARN, "警告：MIDIOut_EnqueueMIDIMessage内で出力キューが一杯です。\r\n");
 		return 0;
 	}
-	while (p1 < pData + lLen) {
-		if (*p1 < 0x80) {
-			if (0x80 <= cRunningStatus && cRunningStatus <= 0xBF ||
-				0xE0 <= cRunningStatus && cRunningStatus <= 0xEF) { 
-				lLen2 = MIN (2, INT_PTRtolong (pData + lLen - p1));
-				lRet += MIDIOut_PutMIDIMessage (pMIDIOut, p1, lLen2);
-				p1 += lLen2;
-			}
-			else if (0xC0 <= cRunningStatus && cRunningStatus <= 0xDF) {
-				lLen2 = MIN (1, INT_PTRtolong (pData + lLen - p1));
-				lRet += MIDIOut_PutMIDIMessage (pMIDIOut, p1, lLen2);
-				p1 += lLen2;
-			}
-			else if (cRunningStatus == 0xF0) {
-				char* p2 = p1;
-				lLen2 = 0;
-				cRunningStatus = 0xF0;
-				while (*p2++ != 0xF7 && lLen2 < MIDIIO_MAXSYSXSIZE) {
-					lLen2++;
-				}	
-				lRet += MIDIOut_PutMIDIMessage (pMIDIOut, p1, (lLen2 + 1));
-				p1 += (lLen2 + 1);
-			}
-			else {
-				while (*p1 < 0x80 || p1 < pData + lLen) {
-					p1++;	
-				}
-				lLen2 = 0;
-				_RPTF0 (_CRT_WARN, "エラー：MIDIOut_PutBytes内で異常なMIDIメッセージを検出しました。\r\n");
-			}
+	pItem = pQueue->m_pItem + lWritePosition;
+	pItem->m_llDeadline = llDeadline;
+	pItem->m_lLen = lLen;
+	pItem->m_ulMsg = 0;
+	pItem->m_pSysx = NULL;
+	/* システムエクスクルーシヴメッセージ */
+	if (*pMessage == 0xF0) {
+		pItem->m_pSysx = malloc (lLen);
+		if (pItem->m_pSysx == NULL) {
+			_RPTF0 (_CRT_WARN, "エラー：MIDIOut_EnqueueMIDIMessage内でmallocがNULLを返しました。\r\n");
+			return 0;
 		}
-		else if (*p1 == 0xF0) {
-			char* p2 = p1;
-			lLen2 = 0;
-			cRunningStatus = 0xF0;
-			while (*p2++ != 0xF7 && lLen2 < MIDIIO_MAXSYSXSIZE) {
-				lLen2++;
-			}
-			lRet += MIDIOut_PutMIDIMessage (pMIDIOut, p1, (lLen2 + 1));
-			p1 += (lLen2 + 1);
+		memcpy (pItem->m_pSysx, pMessage, lLen);
+	}
+	/* 通常のMIDIメッセージ又はシステムリアルタイムメッセージ又はシステムコモンメッセージ */
+	else {
+		long i;
+		for (i = 0; i < lLen; i++) {
+			pItem->m_ulMsg |= (unsigned long)(*(pMessage + i)) << (8 * i);
 		}
-		else {
-			if (0x80 <= *p1 && *p1 <= 0xBF ||
-				0xE0 <= *p1 && *p1 <= 0xEF || *p1 == 0xF2) {
-				lLen2 = MIN (3, INT_PTRtolong (pData + lLen - p1));
-			}
-			else if (0xC0 <= *p1 && *p1 <= 0xDF ||
-				0xF1 == *p1 || *p1 == 0xF3) {
-				lLen2 = MIN (2, INT_PTRtolong (pData + lLen - p1));
-			}
-			else if (0xF4 <= *p1 && *p1 <= 0xFF) {
-				lLen2 = MIN (1, INT_PTRtolong (pData + lLen - p1));
-			}
-			lRet += MIDIOut_PutMIDIMessage (pMIDIOut, p1, lLen2);
-			cRunningStatus = *p1;
-			p1 += lLen2;
+	}
+	MIDIIO_StoreRelease (&(pQueue->m_lWritePosition), (lWritePosition + 1) & lMask);
+	/* キューが空だった場合は出力スレッドを起こす(先頭以外の登録では起こす必要がない) */
+	MemoryBarrier ();
+	if (pQueue->m_lReadPosition == lWritePosition) {
+		SetEvent ((HANDLE)(pQueue->m_hEvent));
+	}
+	return lLen;
+}
+
+/* MIDI出力デバイスの出力キューの未出力のMIDIメッセージをすべて捨てる(20261019追加) */
+/* 出力スレッドが破棄を終えるまで待つので、戻った後は直接出力してもよい。 */
+/* MIDIIO_CLEARQUEUETIMEOUTミリ秒待っても終わらない場合は0を返す(20261019変更)。 */
+/* その場合も破棄するのはこの関数を呼ぶ前に登録した項目だけで、後から登録した項目は出力される。 */
+long __stdcall MIDIOut_ClearQueue (MIDIOut* pMIDIOut) {
+	MIDIOutQueue* pQueue;
+	DWORD dwStartTime;
+	DWORD dwElapsed;
+	_ASSERT (pMIDIOut);
+	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
+	pQueue = (MIDIOutQueue*)(pMIDIOut->m_pQueue);
+	if (pQueue == NULL) {
+		return 1;
+	}
+	/* 前回時間切れとなった破棄要求の完了通知が残っていれば消しておく */
+	ResetEvent ((HANDLE)(pQueue->m_hClearEvent));
+	pQueue->m_lClearPosition = pQueue->m_lWritePosition;
+	MIDIIO_StoreRelease (&(pQueue->m_bClear), 1);
+	SetEvent ((HANDLE)(pQueue->m_hEvent));
+	dwStartTime = GetTickCount ();
+	while (MIDIIO_LoadAcquire (&(pQueue->m_bClear))) {
+		dwElapsed = GetTickCount () - dwStartTime;
+		if (dwElapsed >= MIDIIO_CLEARQUEUETIMEOUT) {
+			_RPTF0 (_CRT_WARN, "エラー：MIDIOut_ClearQueue内で出力スレッドが破棄を終えませんでした。\r\n");
+			return 0;
 		}
+		WaitForSingleObject ((HANDLE)(pQueue->m_hClearEvent), MIDIIO_CLEARQUEUETIMEOUT - dwElapsed);
 	}
-	return lRet;
+	return 1;
 }
 
-/* このMIDI入力デバイスの名前を取得する(ANSI)(20120415追加) */
-long __stdcall MIDIOut_GetThisDeviceNameA (MIDIOut* pMIDIOut, char* pszDeviceName, long lLen) {
-	long lLen2;
+/* MIDI出力デバイスの出力キューの未出力のMIDIメッセージの数を取得する(20261019追加) */
+long __stdcall MIDIOut_GetQueuedNum (MIDIOut* pMIDIOut) {
+	MIDIOutQueue* pQueue;
 	_ASSERT (pMIDIOut);
 	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
-	memset (pszDeviceName, 0, lLen);
-	lLen2 = size_ttolong (strlen (pMIDIOut->m_pDeviceName));
-	strncpy_s (pszDeviceName, lLen, pMIDIOut->m_pDeviceName, CLIP (0, lLen2, lLen - 1));
-	return CLIP (0, lLen2, lLen - 1);
+	pQueue = (MIDIOutQueue*)(pMIDIOut->m_pQueue);
+	if (pQueue == NULL) {
+		return 0;
+	}
+	return (MIDIIO_LoadAcquire (&(pQueue->m_lWritePosition)) - 
+		MIDIIO_LoadAcquire (&(pQueue->m_lReadPosition))) & (pQueue->m_lSize - 1);
 }
 
-/* このMIDI入力デバイスの名前を取得する(UNICODE)(20120415追加) */
-long __stdcall MIDIOut_GetThisDeviceNameW (MIDIOut* pMIDIOut, wchar_t* pszDeviceName, long lLen) {
-	long lLen2;
+/* MIDI出力デバイスの出力キューで出力時刻より1ミリ秒以上遅れた回数を取得する(20261019追加) */
+long __stdcall MIDIOut_GetQueueLateCount (MIDIOut* pMIDIOut) {
 	_ASSERT (pMIDIOut);
 	_ASSERT (pMIDIOut->m_lMode == MIDIIO_MODEOUT);
-	memset (pszDeviceName, 0, lLen * sizeof (wchar_t));
-	lLen2 = size_ttolong (wcslen (pMIDIOut->m_pDeviceName));
-	wcsncpy_s (pszDeviceName, lLen, pMIDIOut->m_pDeviceName, CLIP (0, lLen2, lLen - 1));
-	return CLIP (0, lLen2, lLen - 1);
+	if (pMIDIOut->m_pQueue == NULL) {
+		return 0;
+	}
+	return ((MIDIOutQueue*)(pMIDIOut->m_pQueue))->m_lLateCount;
 }
 
 /******************************************************************************/
@@ -700,19 +1902,10 @@ static void MIDIIn_OnMIMData
 		_RPTF0 (_CRT_WARN, "警告：MIDIIn_OnMIMData内で不明な種類のMIDIメッセージを検出しました。\r\n");
 	}
 
-	if (pMIDIIn->m_lWritePosition + lLen < pMIDIIn->m_lBufSize) {
-		memcpy (pMIDIIn->m_pBuf + pMIDIIn->m_lWritePosition, &cData[0], lLen);
-		pMIDIIn->m_lWritePosition += lLen;
-	}
-	else if (lLen < pMIDIIn->m_lBufSize) {
-		memcpy (pMIDIIn->m_pBuf + pMIDIIn->m_lWritePosition, &cData[0], 
-			pMIDIIn->m_lBufSize - pMIDIIn->m_lWritePosition);
-		memcpy (pMIDIIn->m_pBuf, &cData[pMIDIIn->m_lBufSize - pMIDIIn->m_lWritePosition],
-			lLen - (pMIDIIn->m_lBufSize - pMIDIIn->m_lWritePosition));
-		pMIDIIn->m_lWritePosition = lLen - (pMIDIIn->m_lBufSize - pMIDIIn->m_lWritePosition);
-	}
-	else {
-		_RPTF0 (_CRT_WARN, "警告：MIDIIn_OnMIMData内でバッファサイズより長いデータを検出しました。\r\n");
+	/* dwParam2はmidiInStartからの経過時間[ミリ秒]であり、ドライバーが受信した時刻を表す */
+	if (MIDIIO_WriteBuf (pMIDIIn, &cData[0], lLen, 
+		pMIDIIn->m_llStartMicrosec + (int64_t)dwParam2 * 1000) == 0) {
+		_RPTF0 (_CRT_WARN, "警告：MIDIIn_OnMIMData内で入力バッファが一杯のためデータを捨てました。\r\n");
 	}
 	/* TODO 本来コールバック関数内でシステムコールは禁止であるが、 */
 	/* 上記memcpyに限り、今のところ問題は発生していない。 */
@@ -737,7 +1930,6 @@ static void MIDIIn_OnMIMLongData
 		_RPTF0 (_CRT_WARN, "警告：MIDIIn_OnMIMLongData内で出所不明なSysxデータを検出しました。\r\n");
 	}
 	/* 入力データをバッファへコピー */
-	MIDIIO_LockBuf (pMIDIIn);
 #ifdef _DEBUG
 	{
 		char szMsg[16384];
@@ -745,21 +1937,10 @@ static void MIDIIn_OnMIMLongData
 		_RPTF1 (_CRT_WARN, "情報：MIDIIn_OnMIMLongData内でSysxを受信しました。{%s}\r\n", szMsg);
 	}
 #endif
-	if (pMIDIIn->m_lWritePosition + lLen < pMIDIIn->m_lBufSize) {
-		memcpy (pMIDIIn->m_pBuf + pMIDIIn->m_lWritePosition, pData, lLen);
-		pMIDIIn->m_lWritePosition += lLen;
-	}
-	else if (lLen < pMIDIIn->m_lBufSize) {
-		memcpy (pMIDIIn->m_pBuf + pMIDIIn->m_lWritePosition, pData, 
-			pMIDIIn->m_lBufSize - pMIDIIn->m_lWritePosition);
-		memcpy (pMIDIIn->m_pBuf, pData + pMIDIIn->m_lBufSize - pMIDIIn->m_lWritePosition,
-			lLen - (pMIDIIn->m_lBufSize - pMIDIIn->m_lWritePosition));
-		pMIDIIn->m_lWritePosition = lLen - (pMIDIIn->m_lBufSize - pMIDIIn->m_lWritePosition);
-	}
-	else {
-		_RPTF0 (_CRT_WARN, "警告：MIDIIn_OnMIMLongData内でバッファサイズより長いSysxデータを検出しました。\r\n");
+	if (MIDIIO_WriteBuf (pMIDIIn, pData, lLen, 
+		pMIDIIn->m_llStartMicrosec + (int64_t)dwParam2 * 1000) == 0) {
+		_RPTF0 (_CRT_WARN, "警告：MIDIIn_OnMIMLongData内で入力バッファが一杯のためSysxデータを捨てました。\r\n");
 	}
-	MIDIIO_UnLockBuf (pMIDIIn);
 
 	/* midiInStart中はmidiInUnprepareHeaderできない */
 	
@@ -785,9 +1966,28 @@ static void MIDIIn_OnMIMLongData
 
 }
 
+/* 不完全なSYSXを受信したときに呼び出される(20261019追加) */
+/* 受信エラーとして数え、返されたSYSXヘッダーを再登録する(登録しないとSYSXヘッダーが枯渇する) */
 static void MIDIIn_OnMIMLongError 
 (HMIDIIN hMIDIIn, DWORD_PTR dwInstance, DWORD_PTR dwParam1, DWORD_PTR dwParam2) {
-
+	MIDI* pMIDIIn = (MIDI*)dwInstance;
+	MIDIHDR* pMIDIHeader = (MIDIHDR*)dwParam1;
+	unsigned long nRet;
+	pMIDIIn->m_lSysxDropCount++;
+	/* すでに入力停止している場合はreturn */
+	if (pMIDIIn->m_bStarting == 0) {
+		return;
+	}
+	nRet = midiInPrepareHeader (hMIDIIn, pMIDIHeader, sizeof (MIDIHDR));
+	if (nRet != MMSYSERR_NOERROR) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OnMIMLongError内でmidiInPrepareHeaderが%dを返しました。\r\n", nRet);
+		return;
+	}
+	nRet = midiInAddBuffer (hMIDIIn, pMIDIHeader, sizeof (MIDIHDR));
+	if (nRet != MMSYSERR_NOERROR) {
+		midiInUnprepareHeader (hMIDIIn, pMIDIHeader, sizeof (MIDIHDR));
+		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OnMIMLongError内でmidiInAddBufferが%dを返しました。\r\n", nRet);
+	}
 }
 
 static void MIDIIn_OnMIMError
@@ -832,6 +2032,284 @@ static void CALLBACK MidiInProc (HMIDIIN hMIDIIn, UINT wMsg,
 	}
 }
 
+/* winmmバックエンド：MIDI入力デバイスを開き、入力を開始する(隠蔽) */
+static long MIDIIn_WinMMOpen (MIDI* pMIDIIn, long lID) {
+	int i, nRet;
+	/* MIDI入力デバイスのオープン */
+	nRet = midiInOpen ((HMIDIIN*)&(pMIDIIn->m_pDeviceHandle), lID, 
+		(DWORD_PTR)MidiInProc, (DWORD_PTR)(pMIDIIn), CALLBACK_FUNCTION);
+	if (nRet != MMSYSERR_NOERROR) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_WinMMOpen内でmidiInOpenが%dを返しました。\r\n", nRet);
+		return 0;
+	}
+	/* SYSXヘッダーをの領域を確保する */
+	for (i = 0; i < MIDIIO_SYSXNUM; i++) {
+		pMIDIIn->m_pSysxHeader[i] = (MIDIHDR*)HeapAlloc (GetProcessHeap (),
+			HEAP_ZERO_MEMORY, sizeof (MIDIHDR));
+		if (pMIDIIn->m_pSysxHeader[i] == NULL) {
+			_RPTF0 (_CRT_WARN, "エラー：MIDIIn_WinMMOpen内でHeapAllocがNULLを返しました。\r\n");
+			goto error;
+		}
+		((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData = 
+			(char*)HeapAlloc (GetProcessHeap (), HEAP_NO_SERIALIZE, MIDIIO_MAXSYSXSIZE);
+		if (((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData == NULL) {
+			_RPTF0 (_CRT_WARN, "エラー：MIDIIn_WinMMOpen内でHeapAllocがNULLを返しました。\r\n");
+			goto error;
+		}
+		((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->dwBufferLength = MIDIIO_MAXSYSXSIZE;
+	}
+	/* SYSXヘッダーをすべて待機状態にする(スタート前処理) */
+	for (i = 0; i < MIDIIO_SYSXNUM; i++) {
+		nRet = midiInPrepareHeader (pMIDIIn->m_pDeviceHandle, pMIDIIn->m_pSysxHeader[i], sizeof (MIDIHDR));
+		if (nRet != MMSYSERR_NOERROR) {
+			_RPTF1 (_CRT_WARN, "エラー：MIDIIn_WinMMOpen内でmidiInPrepareHeaderが%dを返しました。\r\n", nRet);
+			goto error;
+		}
+		nRet = midiInAddBuffer (pMIDIIn->m_pDeviceHandle, 
+			(MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]), sizeof (MIDIHDR));
+		if (nRet != MMSYSERR_NOERROR) {
+			_RPTF1 (_CRT_WARN, "エラー：MIDIIn_WinMMOpen内でmidiInAddBufferが%dを返しました。\r\n", nRet);
+			goto error;
+		}
+	}
+	/* 入力の開始(スタート)。受信時刻の基準としてスタート直前の時刻を記憶する */
+	pMIDIIn->m_bStarting = 1;
+	pMIDIIn->m_llStartMicrosec = MIDIClock_QueryMonotonicMicrosec ();
+	nRet = midiInStart (pMIDIIn->m_pDeviceHandle);
+	if (nRet != MMSYSERR_NOERROR) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_WinMMOpen内でmidiInStartが%dを返しました。\r\n", nRet);
+		goto error;
+	}
+	return 1;
+	
+	error:
+	pMIDIIn->m_bStarting = 0;
+	midiInReset (pMIDIIn->m_pDeviceHandle);
+	for (i = 0; i < MIDIIO_SYSXNUM; i++) {
+		if (pMIDIIn->m_pSysxHeader[i] != NULL) {
+			midiInUnprepareHeader (pMIDIIn->m_pDeviceHandle, (MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]), sizeof (MIDIHDR));
+			HeapFree (GetProcessHeap (), 0, ((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData);
+			HeapFree (GetProcessHeap (), 0, (MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]));
+			pMIDIIn->m_pSysxHeader[i] = NULL;
+		}
+	}
+	midiInClose (pMIDIIn->m_pDeviceHandle);
+	return 0;
+}
+
+/* winmmバックエンド：入力を停止し、MIDI入力デバイスを閉じる(隠蔽) */
+static long MIDIIn_WinMMClose (MIDI* pMIDIIn) {
+	int nRet = 0;
+	int i, t;
+	/* 入力の停止 */
+	nRet = midiInStop  (pMIDIIn->m_pDeviceHandle);
+	if (nRet != MMSYSERR_NOERROR) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_WinMMClose内でmidiInStopが%dを返しました。\r\n", nRet);
+		return 0;
+	}
+	pMIDIIn->m_bStarting = 0;
+	/* MIDI入力のリセット(ここで未入力のSYSXバッファはコールバックに返されMHDR_DONEフラグがセットされる */
+	nRet = midiInReset (pMIDIIn->m_pDeviceHandle);
+	if (nRet != MMSYSERR_NOERROR) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_WinMMClose内でmidiInResetが%dを返しました。\r\n", nRet);
+		return 0;
+	}
+	/* すべてのSYSXヘッダーに対してMIM_LONGDATAを待つ(100回試行) */
+	for (t = 0; t < 100; t++) {
+		for (i = 0; i < MIDIIO_SYSXNUM; i++) {
+			if ((((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->dwFlags & MHDR_DONE) == 0) {
+				break;
+			}
+		}
+		if (i >= MIDIIO_SYSXNUM) {
+			break;
+		}
+		Sleep (10);
+	}
+	if (t == 100) {
+		_RPTF0 (_CRT_WARN, "警告：MIDIIn_WinMMClose内でMIM_LONGDATAがコールバックされていないバッファがあります。\r\n");
+	}
+	/* SYSXヘッダーの不準備(ストップ後処理) */
+	for (i = 0; i < MIDIIO_SYSXNUM; i++) {
+		nRet = midiInUnprepareHeader (pMIDIIn->m_pDeviceHandle, pMIDIIn->m_pSysxHeader[i], sizeof(MIDIHDR));
+		if (nRet != MMSYSERR_NOERROR) {
+			_RPTF1 (_CRT_WARN, "エラー：MIDIIn_WinMMClose内でmidiInUnprepareHeaderが%dを返しました。\r\n", nRet);
+			return 0;
+		}
+	}
+	/* SYSXヘッダーの解放(クローズ前処理) */
+	for (i = 0; i < MIDIIO_SYSXNUM; i++) {
+		HeapFree (GetProcessHeap(), 0, ((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData);
+		((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData = NULL;
+		HeapFree (GetProcessHeap(), 0, (MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]));
+		pMIDIIn->m_pSysxHeader[i] = NULL;
+	}
+	/* MIDI入力デバイスを閉じる */
+	nRet = midiInClose (pMIDIIn->m_pDeviceHandle);
+	if (nRet != MMSYSERR_NOERROR) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_WinMMClose内でmidiInCloseが%dを返しました。\r\n", nRet);
+		return 0;
+	}
+	return 1;
+}
+
+/* winmmバックエンド：MIDI入力デバイスをリセットする(隠蔽) */
+static long MIDIIn_WinMMReset (MIDI* pMIDIIn) {
+	int nRet = midiInReset (pMIDIIn->m_pDeviceHandle);
+	if (nRet != MMSYSERR_NOERROR) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_WinMMReset内でmidiInResetが%dを返しました。\r\n", nRet);
+		return 0;
+	}
+	return 1;
+}
+
+/* ループバックバックエンド：MIDI入力を開く(隠蔽) */
+static long MIDIIn_LoopbackOpen (MIDI* pMIDIIn, long lID) {
+	MIDIIOLoopbackPort* pPort = &g_theMIDIIOLoopbackPort[lID];
+	pMIDIIn->m_pBackendData = pPort;
+	pMIDIIn->m_bStarting = 1;
+	/* 1つのループバックポートを同時に開けるMIDI入力は1つまで */
+	if (InterlockedCompareExchangePointer 
+		((PVOID volatile*)&(pPort->m_pMIDIIn), pMIDIIn, NULL) != NULL) {
+		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_LoopbackOpen内でループバックポート%dは既に使用中です。\r\n", lID + 1);
+		pMIDIIn->m_pBackendData = NULL;
+		pMIDIIn->m_bStarting = 0;
+		return 0;
+	}
+	return 1;
+}
+
+/* ループバックバックエンド：MIDI入力を閉じる(隠蔽) */
+static long MIDIIn_LoopbackClose (MIDI* pMIDIIn) {
+	MIDIIOLoopbackPort* pPort = (MIDIIOLoopbackPort*)(pMIDIIn->m_pBackendData);
+	pMIDIIn->m_bStarting = 0;
+	InterlockedExchangePointer ((PVOID volatile*)&(pPort->m_pMIDIIn), NULL);
+	/* 出力側が書き込み中であれば終わるまで待つ */
+	while (pPort->m_lBusy > 0) {
+		Sleep (0);
+	}
+	pMIDIIn->m_pBackendData = NULL;
+	return 1;
+}
+
+/* 共有メモリバックエンド：受信スレッド(隠蔽)(20261019追加) */
+/* 共有メモリ上の記録を、送信時刻を受信時刻としてMIDI入力の入力バッファへ移す */
+static DWORD WINAPI MIDIIn_SharedThreadProc (LPVOID pParam) {
+	MIDI* pMIDIIn = (MIDI*)pParam;
+	MIDIIOSharedData* pSharedData = (MIDIIOSharedData*)(pMIDIIn->m_pBackendData);
+	MIDIIOSharedPort* pPort = pSharedData->m_pPort;
+	long lReadPosition, lWritePosition, lAvailLen;
+	int32_t lLen;
+	int64_t llMicrosec;
+	while (!pSharedData->m_bExit) {
+		/* 共有メモリ上の位置は他プロセスから書き換えられうるため、読んだ直後に範囲内に丸める(20261019変更) */
+		lReadPosition = pPort->m_lReadPosition & (MIDIIO_SHAREDBUFSIZE - 1);
+		lWritePosition = MIDIIO_LoadAcquire (&(pPort->m_lWritePosition)) & (MIDIIO_SHAREDBUFSIZE - 1);
+		/* 空であれば出力側に起こされるまで眠る */
+		if (lReadPosition == lWritePosition) {
+			WaitForSingleObject (pSharedData->m_hEvent, INFINITE);
+			continue;
+		}
+		/* 記録の長さや公開済みの量は他プロセスから書き換えられうるため、読む前に公開済みの量を */
+		/* 超えないことを確かめる。壊れた記録や途中までしか公開されていない記録があれば、 */
+		/* 公開済みの分をすべて捨てて同期を取り直す(20261019変更) */
+		lAvailLen = (lWritePosition - lReadPosition) & (MIDIIO_SHAREDBUFSIZE - 1);
+		while (lAvailLen > 0) {
+			if (lAvailLen < MIDIIO_SHAREDHEADERSIZE) {
+				_RPTF0 (_CRT_WARN, "警告：MIDIIn_SharedThreadProc内で不正な記録を捨てました。\r\n");
+				lReadPosition = lWritePosition;
+				break;
+			}
+			lReadPosition = MIDIIO_CopyFromShared (pPort, lReadPosition, &lLen, 4);
+			lReadPosition = MIDIIO_CopyFromShared (pPort, lReadPosition, &llMicrosec, 8);
+			lAvailLen -= MIDIIO_SHAREDHEADERSIZE;
+			if (lLen < 0 || lLen > lAvailLen) {
+				_RPTF0 (_CRT_WARN, "警告：MIDIIn_SharedThreadProc内で不正な記録を捨てました。\r\n");
+				lReadPosition = lWritePosition;
+				break;
+			}
+			lReadPosition = MIDIIO_CopyFromShared (pPort, lReadPosition, pSharedData->m_pMessage, lLen);
+			lAvailLen -= lLen;
+			if (MIDIIO_WriteBuf (pMIDIIn, pSharedData->m_pMessage, lLen, llMicrosec) == 0) {
+				_RPTF0 (_CRT_WARN, "警告：MIDIIn_SharedThreadProc内で入力バッファが一杯のためデータを捨てました。\r\n");
+			}
+		}
+		/* 読み込み位置の公開後に書き込み位置を読み直す(起こし損ないの防止) */
+		MIDIIO_StoreRelease (&(pPort->m_lReadPosition), lReadPosition);
+		MemoryBarrier ();
+	}
+	return 0;
+}
+
+/* 共有メモリバックエンド：MIDI入力を開く(隠蔽)(20261019追加) */
+/* (lIDはデバイス名の文字型で、0=ANSI、1=UNICODE) */
+static long MIDIIn_SharedOpen (MIDI* pMIDIIn, long lID) {
+	MIDIIOSharedData* pSharedData = MIDIIO_OpenSharedPort (pMIDIIn, lID);
+	if (pSharedData == NULL) {
+		return 0;
+	}
+	pSharedData->m_pMessage = (unsigned char*)malloc (MIDIIO_SHAREDBUFSIZE);
+	if (pSharedData->m_pMessage == NULL) {
+		MIDIIO_CloseSharedPort (pSharedData);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIIn_SharedOpen内でmallocがNULLを返しました。\r\n");
+		return 0;
+	}
+	/* 1つの共有メモリポートを同時に開けるMIDI入力は1つまで */
+	if (MIDIIO_AcquireShared (&(pSharedData->m_pPort->m_lInOpened)) == 0) {
+		free (pSharedData->m_pMessage);
+		MIDIIO_CloseSharedPort (pSharedData);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIIn_SharedOpen内で共有メモリポートは既に使用中です。\r\n");
+		return 0;
+	}
+	/* 以前の入力側が読み残した記録は捨てる */
+	MIDIIO_StoreRelease (&(pSharedData->m_pPort->m_lReadPosition), 
+		MIDIIO_LoadAcquire (&(pSharedData->m_pPort->m_lWritePosition)));
+	pMIDIIn->m_pBackendData = pSharedData;
+	pMIDIIn->m_bStarting = 1;
+	pSharedData->m_hThread = CreateThread (NULL, 0, MIDIIn_SharedThreadProc, pMIDIIn, 0, NULL);
+	if (pSharedData->m_hThread == NULL) {
+		pMIDIIn->m_bStarting = 0;
+		pMIDIIn->m_pBackendData = NULL;
+		MIDIIO_ReleaseShared (&(pSharedData->m_pPort->m_lInOpened));
+		free (pSharedData->m_pMessage);
+		MIDIIO_CloseSharedPort (pSharedData);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIIn_SharedOpen内でCreateThreadがNULLを返しました。\r\n");
+		return 0;
+	}
+	SetThreadPriority (pSharedData->m_hThread, THREAD_PRIORITY_HIGHEST);
+	return 1;
+}
+
+/* 共有メモリバックエンド：MIDI入力を閉じる(隠蔽)(20261019追加) */
+static long MIDIIn_SharedClose (MIDI* pMIDIIn) {
+	MIDIIOSharedData* pSharedData = (MIDIIOSharedData*)(pMIDIIn->m_pBackendData);
+	pMIDIIn->m_bStarting = 0;
+	/* 受信スレッドを止めてから共有メモリポートを手放す */
+	MIDIIO_StoreRelease (&(pSharedData->m_bExit), 1);
+	SetEvent (pSharedData->m_hEvent);
+	WaitForSingleObject (pSharedData->m_hThread, INFINITE);
+	CloseHandle (pSharedData->m_hThread);
+	MIDIIO_ReleaseShared (&(pSharedData->m_pPort->m_lInOpened));
+	free (pSharedData->m_pMessage);
+	MIDIIO_CloseSharedPort (pSharedData);
+	pMIDIIn->m_pBackendData = NULL;
+	return 1;
+}
+
+/* MIDI入力バックエンド関数テーブル(隠蔽)(20261019追加) */
+static const MIDIIOBackend g_theMIDIInWinMMBackend = {
+	MIDIIn_WinMMOpen, MIDIIn_WinMMClose, MIDIIn_WinMMReset, NULL, NULL, NULL
+};
+static const MIDIIOBackend g_theMIDIInLoopbackBackend = {
+	MIDIIn_LoopbackOpen, MIDIIn_LoopbackClose, MIDIIO_NullReset, NULL, NULL, NULL
+};
+static const MIDIIOBackend g_theMIDIInSharedBackend = {
+	MIDIIn_SharedOpen, MIDIIn_SharedClose, MIDIIO_NullReset, NULL, NULL, NULL
+};
+static const MIDIIOBackend g_theMIDIInNullBackend = {
+	MIDIIO_NullOpen, MIDIIO_NullClose, MIDIIO_NullReset, NULL, NULL, NULL
+};
+
 /* MIDI入力デバイスの数を調べる */
 long __stdcall MIDIIn_GetDeviceNum () {
 	return midiInGetNumDevs ();
@@ -873,8 +2351,8 @@ long __stdcall MIDIIn_GetDeviceNameW (long lID, wchar_t* pszDeviceName, long lLe
 /* MIDI入力デバイスを開く(ANSI) */
 MIDIIn* __stdcall MIDIIn_OpenA (const char* pszDeviceName) {
 	MIDIINCAPSA tagMIDIInCaps;
+	const MIDIIOBackend* pBackend = &g_theMIDIInWinMMBackend;
 	MIDI* pMIDIIn = NULL;
-	MIDIHDR* pMIDIHdr = NULL;
 	long lDeviceNameLen;
 	int nNumDevices, i, nRet;
 	if (pszDeviceName == NULL) {
@@ -888,17 +2366,33 @@ MIDIIn* __stdcall MIDIIn_OpenA (const char* pszDeviceName) {
 		strcmp (pszDeviceName, MIDIIO_NONEJ) == 0) {
 		return NULL;
 	}
-	/* デバイス名を解析し何番目のMIDI出力デバイスか判定 */
-	nNumDevices = midiInGetNumDevs ();
-	for (i = 0; i < nNumDevices; i++) {
-		memset (&tagMIDIInCaps, 0, sizeof (MIDIINCAPSA));
-		nRet = midiInGetDevCapsA (i, &tagMIDIInCaps, sizeof(MIDIINCAPSA));
-		if (strncmp (pszDeviceName, tagMIDIInCaps.szPname, 32) == 0)
-			break;
+	/* デバイス名が"Null"である場合は何も入力しない仮想デバイスとする(20261019追加) */
+	else if (strcmp (pszDeviceName, MIDIIO_NULL) == 0) {
+		pBackend = &g_theMIDIInNullBackend;
+		i = 0;
 	}
-	if (i >= nNumDevices) {
-		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OpenA内でMIDI入力デバイスが見つかりません。-%s\r\n", pszDeviceName);
-		return NULL;
+	/* デバイス名が"Loopback n"である場合は同名のMIDI出力からの折り返しを受ける(20261019追加) */
+	else if ((i = MIDIIO_GetLoopbackPortA (pszDeviceName)) >= 0) {
+		pBackend = &g_theMIDIInLoopbackBackend;
+	}
+	/* デバイス名が"Shared 名前"である場合は共有メモリを介して別プロセスから入力する(20261019追加) */
+	else if (MIDIIO_IsSharedNameA (pszDeviceName)) {
+		pBackend = &g_theMIDIInSharedBackend;
+		i = 0;
+	}
+	/* デバイス名を解析し何番目のMIDI出力デバイスか判定 */
+	else {
+		nNumDevices = midiInGetNumDevs ();
+		for (i = 0; i < nNumDevices; i++) {
+			memset (&tagMIDIInCaps, 0, sizeof (MIDIINCAPSA));
+			nRet = midiInGetDevCapsA (i, &tagMIDIInCaps, sizeof(MIDIINCAPSA));
+			if (strncmp (pszDeviceName, tagMIDIInCaps.szPname, 32) == 0)
+				break;
+		}
+		if (i >= nNumDevices) {
+			_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OpenA内でMIDI入力デバイスが見つかりません。-%s\r\n", pszDeviceName);
+			return NULL;
+		}
 	}
 	/* MIDIIn構造体の確保 */
 	pMIDIIn = calloc (1, sizeof (MIDI));
@@ -909,90 +2403,48 @@ MIDIIn* __stdcall MIDIIn_OpenA (const char* pszDeviceName) {
 	lDeviceNameLen = size_ttolong (strlen (pszDeviceName) + 1);
 	pMIDIIn->m_pDeviceName = calloc (lDeviceNameLen, sizeof (char));
 	if (pMIDIIn->m_pDeviceName == NULL) {
-		_RPTF0 (_CRT_WARN, "エラー：MIDIIn_OpenA内でcallocがNULLを返しました。\r\n");
-		return NULL;
-	}
-	strncpy_s ((char*)(pMIDIIn->m_pDeviceName), lDeviceNameLen, pszDeviceName, lDeviceNameLen - 1);
-	pMIDIIn->m_lMode = MIDIIO_MODEIN;
-
-	MIDIIO_LockBuf (pMIDIIn);
-	pMIDIIn->m_pBuf = malloc (MIDIIO_BUFSIZE);
-	if (pMIDIIn->m_pBuf == NULL) {
 		free (pMIDIIn);
-		_RPTF0 (_CRT_WARN, "エラー：MIDIIn_OpenA内でmallocがNULLを返しました。\r\n");
-		return NULL;
-	}
-	pMIDIIn->m_lBufSize = MIDIIO_BUFSIZE;
-	MIDIIO_UnLockBuf (pMIDIIn);
-	/* MIDI入力デバイスのオープン */
-	nRet = midiInOpen ((HMIDIIN*)&(pMIDIIn->m_pDeviceHandle), i, 
-		(DWORD_PTR)MidiInProc, (DWORD_PTR)(pMIDIIn), CALLBACK_FUNCTION);
-	if (nRet != MMSYSERR_NOERROR) {
-		free (pMIDIIn->m_pBuf);
-		free (pMIDIIn);
-		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OpenA内でmidiInOpenが%dを返しました。\r\n", nRet);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIIn_OpenA内でcallocがNULLを返しました。\r\n");
 		return NULL;
 	}
-	/* SYSXヘッダーをの領域を確保する */
-	for (i = 0; i < MIDIIO_SYSXNUM; i++) {
-		pMIDIIn->m_pSysxHeader[i] = (MIDIHDR*)HeapAlloc (GetProcessHeap (),
-			HEAP_ZERO_MEMORY, sizeof (MIDIHDR));
-		if (pMIDIIn->m_pSysxHeader[i] == NULL) {
-			free (pMIDIIn->m_pBuf);
-			free (pMIDIIn);
-			_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OpenA内でHeapAllocが%dを返しました。\r\n", nRet);
-			return NULL;
-		}
-
-		((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData = 
-			(char*)HeapAlloc (GetProcessHeap (), HEAP_NO_SERIALIZE, MIDIIO_MAXSYSXSIZE);
-		if (((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData == NULL) {
-			free (pMIDIIn->m_pBuf);
-			free (pMIDIIn);
-			_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OpenA内でHeapAllocが%dを返しました。\r\n", nRet);
-			return NULL;
-		}
-		((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->dwBufferLength = MIDIIO_MAXSYSXSIZE;
-	}
-	/* SYSXヘッダーをすべて待機状態にする(スタート前処理) */
-	for (i = 0; i < MIDIIO_SYSXNUM; i++) {
-		nRet = midiInPrepareHeader (pMIDIIn->m_pDeviceHandle, pMIDIIn->m_pSysxHeader[i], sizeof (MIDIHDR));
-		if (nRet != MMSYSERR_NOERROR) {
-			HeapFree (GetProcessHeap (), 0, ((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData);
-			HeapFree (GetProcessHeap (), 0, (MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]));		
-			free (pMIDIIn->m_pBuf);
-			free (pMIDIIn);
-			_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OpenA内でmidiInPrepareHeaderが%dを返しました。\r\n", nRet);
-			return NULL;
-		}
+	strncpy_s ((char*)(pMIDIIn->m_pDeviceName), lDeviceNameLen, pszDeviceName, lDeviceNameLen - 1);
+	pMIDIIn->m_lMode = MIDIIO_MODEIN;
 
-		nRet = midiInAddBuffer (pMIDIIn->m_pDeviceHandle, 
-			(MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]), sizeof (MIDIHDR));
-		if (nRet != MMSYSERR_NOERROR) {
-			midiInUnprepareHeader (pMIDIIn->m_pDeviceHandle, (MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]), sizeof (MIDIHDR));
-			HeapFree (GetProcessHeap (), 0, ((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData);
-			HeapFree (GetProcessHeap (), 0, (MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]));		
-			free (pMIDIIn->m_pBuf);
-			free (pMIDIIn);
-			_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OpenA内でmidiInAddBufferが%dを返しました。\r\n", nRet);
-			return NULL;
-		}
+	/* 入力バッファ(リングバッファ)の確保 */
+	_ASSERT ((MIDIIO_BUFSIZE & (MIDIIO_BUFSIZE - 1)) == 0);
+	pMIDIIn->m_pBuf = malloc (MIDIIO_BUFSIZE);
+	pMIDIIn->m_pTimeBuf = malloc (MIDIIO_BUFSIZE * sizeof (int64_t));
+	if (pMIDIIn->m_pBuf == NULL || pMIDIIn->m_pTimeBuf == NULL) {
+		free (pMIDIIn->m_pTimeBuf);
+		free (pMIDIIn->m_pBuf);
+		free (pMIDIIn->m_pDeviceName);
+		free (pMIDIIn);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIIn_OpenA内でmallocがNULLを返しました。\r\n");
+		return NULL;
 	}
-	/* 入力の開始(スタート) */
-	nRet = midiInStart (pMIDIIn->m_pDeviceHandle);
-	if (nRet != MMSYSERR_NOERROR) {
-		for (i = 0; i < MIDIIO_SYSXNUM; i++) {
-			midiInUnprepareHeader (pMIDIIn->m_pDeviceHandle, (MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]), sizeof (MIDIHDR));
-			HeapFree (GetProcessHeap (), 0, ((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData);
-			HeapFree (GetProcessHeap (), 0, (MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]));	
-		}
+	pMIDIIn->m_lBufSize = MIDIIO_BUFSIZE;
+	/* 入力待ち用イベントの作成(自動リセット)(20261019追加) */
+	pMIDIIn->m_hInputEvent = CreateEvent (NULL, FALSE, FALSE, NULL);
+	if (pMIDIIn->m_hInputEvent == NULL) {
+		free (pMIDIIn->m_pTimeBuf);
 		free (pMIDIIn->m_pBuf);
+		free (pMIDIIn->m_pDeviceName);
 		free (pMIDIIn);
-		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OpenA内でmidiInStartが%dを返しました。\r\n", nRet);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIIn_OpenA内でCreateEventがNULLを返しました。\r\n");
+		return NULL;
+	}
+	pMIDIIn->m_pBackend = pBackend;
+	/* MIDI入力デバイスのオープンと入力の開始(スタート) */
+	nRet = pBackend->m_pfnOpen (pMIDIIn, i);
+	if (nRet == 0) {
+		CloseHandle ((HANDLE)(pMIDIIn->m_hInputEvent));
+		free (pMIDIIn->m_pTimeBuf);
+		free (pMIDIIn->m_pBuf);
+		free (pMIDIIn->m_pDeviceName);
+		free (pMIDIIn);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIIn_OpenA内でMIDI入力デバイスを開けませんでした。\r\n");
 		return NULL;
 	}
-	pMIDIIn->m_bStarting = 1;
-
 	return pMIDIIn;
 }
 
@@ -1000,8 +2452,8 @@ MIDIIn* __stdcall MIDIIn_OpenA (const char* pszDeviceName) {
 /* MIDI入力デバイスを開く(UNICODE) */
 MIDIIn* __stdcall MIDIIn_OpenW (const wchar_t* pszDeviceName) {
 	MIDIINCAPSW tagMIDIInCaps;
+	const MIDIIOBackend* pBackend = &g_theMIDIInWinMMBackend;
 	MIDI* pMIDIIn = NULL;
-	MIDIHDR* pMIDIHdr = NULL;
 	long lDeviceNameLen;
 	int nNumDevices, i, nRet;
 	if (pszDeviceName == NULL) {
@@ -1015,17 +2467,33 @@ MIDIIn* __stdcall MIDIIn_OpenW (const wchar_t* pszDeviceName) {
 		wcscmp (pszDeviceName, L"(なし)") == 0) {
 		return NULL;
 	}
-	/* デバイス名を解析し何番目のMIDI出力デバイスか判定 */
-	nNumDevices = midiInGetNumDevs ();
-	for (i = 0; i < nNumDevices; i++) {
-		memset (&tagMIDIInCaps, 0, sizeof (MIDIINCAPSW));
-		nRet = midiInGetDevCapsW (i, &tagMIDIInCaps, sizeof(MIDIINCAPSW));
-		if (wcsncmp (pszDeviceName, tagMIDIInCaps.szPname, 32) == 0)
-			break;
+	/* デバイス名が"Null"である場合は何も入力しない仮想デバイスとする(20261019追加) */
+	else if (wcscmp (pszDeviceName, L"Null") == 0) {
+		pBackend = &g_theMIDIInNullBackend;
+		i = 0;
 	}
-	if (i >= nNumDevices) {
-		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OpenW内でMIDI入力デバイスが見つかりません。-%s\r\n", pszDeviceName);
-		return NULL;
+	/* デバイス名が"Loopback n"である場合は同名のMIDI出力からの折り返しを受ける(20261019追加) */
+	else if ((i = MIDIIO_GetLoopbackPortW (pszDeviceName)) >= 0) {
+		pBackend = &g_theMIDIInLoopbackBackend;
+	}
+	/* デバイス名が"Shared 名前"である場合は共有メモリを介して別プロセスから入力する(20261019追加) */
+	else if (MIDIIO_IsSharedNameW (pszDeviceName)) {
+		pBackend = &g_theMIDIInSharedBackend;
+		i = 1;
+	}
+	/* デバイス名を解析し何番目のMIDI出力デバイスか判定 */
+	else {
+		nNumDevices = midiInGetNumDevs ();
+		for (i = 0; i < nNumDevices; i++) {
+			memset (&tagMIDIInCaps, 0, sizeof (MIDIINCAPSW));
+			nRet = midiInGetDevCapsW (i, &tagMIDIInCaps, sizeof(MIDIINCAPSW));
+			if (wcsncmp (pszDeviceName, tagMIDIInCaps.szPname, 32) == 0)
+				break;
+		}
+		if (i >= nNumDevices) {
+			_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OpenW内でMIDI入力デバイスが見つかりません。-%s\r\n", pszDeviceName);
+			return NULL;
+		}
 	}
 	/* MIDIIn構造体の確保 */
 	pMIDIIn = calloc (1, sizeof (MIDI));
@@ -1036,159 +2504,73 @@ MIDIIn* __stdcall MIDIIn_OpenW (const wchar_t* pszDeviceName) {
 	lDeviceNameLen = size_ttolong (wcslen (pszDeviceName) + 1);
 	pMIDIIn->m_pDeviceName = calloc (lDeviceNameLen, sizeof (wchar_t));
 	if (pMIDIIn->m_pDeviceName == NULL) {
+		free (pMIDIIn);
 		_RPTF0 (_CRT_WARN, "エラー：MIDIIn_OpenW内でcallocがNULLを返しました。\r\n");
 		return NULL;
 	}
 	wcsncpy_s ((wchar_t*)(pMIDIIn->m_pDeviceName), lDeviceNameLen, pszDeviceName, lDeviceNameLen - 1);
 	pMIDIIn->m_lMode = MIDIIO_MODEIN;
 
-	MIDIIO_LockBuf (pMIDIIn);
+	/* 入力バッファ(リングバッファ)の確保 */
+	_ASSERT ((MIDIIO_BUFSIZE & (MIDIIO_BUFSIZE - 1)) == 0);
 	pMIDIIn->m_pBuf = malloc (MIDIIO_BUFSIZE);
-	if (pMIDIIn->m_pBuf == NULL) {
+	pMIDIIn->m_pTimeBuf = malloc (MIDIIO_BUFSIZE * sizeof (int64_t));
+	if (pMIDIIn->m_pBuf == NULL || pMIDIIn->m_pTimeBuf == NULL) {
+		free (pMIDIIn->m_pTimeBuf);
+		free (pMIDIIn->m_pBuf);
+		free (pMIDIIn->m_pDeviceName);
 		free (pMIDIIn);
 		_RPTF0 (_CRT_WARN, "エラー：MIDIIn_OpenW内でmallocがNULLを返しました。\r\n");
 		return NULL;
 	}
 	pMIDIIn->m_lBufSize = MIDIIO_BUFSIZE;
-	MIDIIO_UnLockBuf (pMIDIIn);
-	/* MIDI入力デバイスのオープン */
-	nRet = midiInOpen ((HMIDIIN*)&(pMIDIIn->m_pDeviceHandle), i, 
-		(DWORD_PTR)MidiInProc, (DWORD_PTR)(pMIDIIn), CALLBACK_FUNCTION);
-	if (nRet != MMSYSERR_NOERROR) {
+	/* 入力待ち用イベントの作成(自動リセット)(20261019追加) */
+	pMIDIIn->m_hInputEvent = CreateEvent (NULL, FALSE, FALSE, NULL);
+	if (pMIDIIn->m_hInputEvent == NULL) {
+		free (pMIDIIn->m_pTimeBuf);
 		free (pMIDIIn->m_pBuf);
+		free (pMIDIIn->m_pDeviceName);
 		free (pMIDIIn);
-		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OpenW内でmidiInOpenが%dを返しました。\r\n", nRet);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIIn_OpenW内でCreateEventがNULLを返しました。\r\n");
 		return NULL;
 	}
-	/* SYSXヘッダーをの領域を確保する */
-	for (i = 0; i < MIDIIO_SYSXNUM; i++) {
-		pMIDIIn->m_pSysxHeader[i] = (MIDIHDR*)HeapAlloc (GetProcessHeap (),
-			HEAP_ZERO_MEMORY, sizeof (MIDIHDR));
-		if (pMIDIIn->m_pSysxHeader[i] == NULL) {
-			free (pMIDIIn->m_pBuf);
-			free (pMIDIIn);
-			_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OpenW内でHeapAllocが%dを返しました。\r\n", nRet);
-			return NULL;
-		}
-
-		((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData = 
-			(char*)HeapAlloc (GetProcessHeap (), HEAP_NO_SERIALIZE, MIDIIO_MAXSYSXSIZE);
-		if (((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData == NULL) {
-			free (pMIDIIn->m_pBuf);
-			free (pMIDIIn);
-			_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OpenW内でHeapAllocが%dを返しました。\r\n", nRet);
-			return NULL;
-		}
-		((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->dwBufferLength = MIDIIO_MAXSYSXSIZE;
-	}
-	/* SYSXヘッダーをすべて待機状態にする(スタート前処理) */
-	for (i = 0; i < MIDIIO_SYSXNUM; i++) {
-		nRet = midiInPrepareHeader (pMIDIIn->m_pDeviceHandle, pMIDIIn->m_pSysxHeader[i], sizeof (MIDIHDR));
-		if (nRet != MMSYSERR_NOERROR) {
-			HeapFree (GetProcessHeap (), 0, ((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData);
-			HeapFree (GetProcessHeap (), 0, (MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]));		
-			free (pMIDIIn->m_pBuf);
-			free (pMIDIIn);
-			_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OpenW内でmidiInPrepareHeaderが%dを返しました。\r\n", nRet);
-			return NULL;
-		}
-
-		nRet = midiInAddBuffer (pMIDIIn->m_pDeviceHandle, 
-			(MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]), sizeof (MIDIHDR));
-		if (nRet != MMSYSERR_NOERROR) {
-			midiInUnprepareHeader (pMIDIIn->m_pDeviceHandle, (MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]), sizeof (MIDIHDR));
-			HeapFree (GetProcessHeap (), 0, ((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData);
-			HeapFree (GetProcessHeap (), 0, (MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]));		
-			free (pMIDIIn->m_pBuf);
-			free (pMIDIIn);
-			_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OpenW内でmidiInAddBufferが%dを返しました。\r\n", nRet);
-			return NULL;
-		}
-	}
-	/* 入力の開始(スタート) */
-	nRet = midiInStart (pMIDIIn->m_pDeviceHandle);
-	if (nRet != MMSYSERR_NOERROR) {
-		for (i = 0; i < MIDIIO_SYSXNUM; i++) {
-			midiInUnprepareHeader (pMIDIIn->m_pDeviceHandle, (MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]), sizeof (MIDIHDR));
-			HeapFree (GetProcessHeap (), 0, ((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData);
-			HeapFree (GetProcessHeap (), 0, (MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]));	
-		}
+	pMIDIIn->m_pBackend = pBackend;
+	/* MIDI入力デバイスのオープンと入力の開始(スタート) */
+	nRet = pBackend->m_pfnOpen (pMIDIIn, i);
+	if (nRet == 0) {
+		CloseHandle ((HANDLE)(pMIDIIn->m_hInputEvent));
+		free (pMIDIIn->m_pTimeBuf);
 		free (pMIDIIn->m_pBuf);
+		free (pMIDIIn->m_pDeviceName);
 		free (pMIDIIn);
-		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_OpenW内でmidiInStartが%dを返しました。\r\n", nRet);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIIn_OpenW内でMIDI入力デバイスを開けませんでした。\r\n");
 		return NULL;
 	}
-	pMIDIIn->m_bStarting = 1;
-
 	return pMIDIIn;
 }
 
 
 /* MIDI入力デバイスを閉じる。 */
 long __stdcall MIDIIn_Close (MIDIIn* pMIDIIn) {
-	int nRet = 0;
-	int i, t;
 	if (pMIDIIn == NULL) {
 		return 1;
 	}
 	_ASSERT (pMIDIIn->m_lMode == MIDIIO_MODEIN);
-	/* 入力の停止 */
-	nRet = midiInStop  (pMIDIIn->m_pDeviceHandle);
-	if (nRet != MMSYSERR_NOERROR) {
-		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_Close内でmidiInStopが%dを返しました。\r\n", nRet);
-		return 0;
-	}
-	pMIDIIn->m_bStarting = 0;
-	/* MIDI入力のリセット(ここで未入力のSYSXバッファはコールバックに返されMHDR_DONEフラグがセットされる */
-	nRet = midiInReset (pMIDIIn->m_pDeviceHandle);
-	if (nRet != MMSYSERR_NOERROR) {
-		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_Close内でmidiInResetが%dを返しました。\r\n", nRet);
-		return 0;
-	}
-	/* すべてのSYSXヘッダーに対してMIM_LONGDATAを待つ(100回試行) */
-	for (t = 0; t < 100; t++) {
-		for (i = 0; i < MIDIIO_SYSXNUM; i++) {
-			if ((((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->dwFlags & MHDR_DONE) == 0) {
-				break;
-			}
-		}
-		if (i >= MIDIIO_SYSXNUM) {
-			break;
-		}
-		Sleep (10);
-	}
-	if (t == 100) {
-		_RPTF0 (_CRT_WARN, "警告：MIDIIn_Close内でMIM_LONGDATAがコールバックされていないバッファがあります。\r\n");
-	}
-	/* SYSXヘッダーの不準備(ストップ後処理) */
-	for (i = 0; i < MIDIIO_SYSXNUM; i++) {
-		nRet = midiInUnprepareHeader (pMIDIIn->m_pDeviceHandle, pMIDIIn->m_pSysxHeader[i], sizeof(MIDIHDR));
-		if (nRet != MMSYSERR_NOERROR) {
-			_RPTF1 (_CRT_WARN, "エラー：MIDIIn_Close内でmidiInUnprepareHeaderが%dを返しました。\r\n", nRet);
-			return 0;
-		}
-	}
-	/* SYSXヘッダーの解放(クローズ前処理) */
-	for (i = 0; i < MIDIIO_SYSXNUM; i++) {
-		HeapFree (GetProcessHeap(), 0, ((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData);
-		((MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]))->lpData = NULL;
-		HeapFree (GetProcessHeap(), 0, (MIDIHDR*)(pMIDIIn->m_pSysxHeader[i]));
-		pMIDIIn->m_pSysxHeader[i] = NULL;
-	}
-	/* MIDI入力デバイスを閉じる */
-	nRet = midiInClose (pMIDIIn->m_pDeviceHandle);
-	if (nRet != MMSYSERR_NOERROR) {
-		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_Close内でmidiInCloseが%dを返しました。\r\n", nRet);
+	/* 入力を停止し、MIDI入力デバイスを閉じる */
+	if (MIDIIO_BACKEND (pMIDIIn)->m_pfnClose (pMIDIIn) == 0) {
+		_RPTF0 (_CRT_WARN, "エラー：MIDIIn_Close内でMIDI入力デバイスを閉じられませんでした。\r\n");
 		return 0;
 	}
-	/* MIDI入力構造体の解放 */
-	MIDIIO_LockBuf (pMIDIIn);
+	/* MIDI入力構造体の解放(書き込み側は既に停止している) */
 	free (pMIDIIn->m_pBuf);
 	pMIDIIn->m_pBuf = NULL;
+	free (pMIDIIn->m_pTimeBuf);
+	pMIDIIn->m_pTimeBuf = NULL;
 	pMIDIIn->m_lBufSize = 0;
+	CloseHandle ((HANDLE)(pMIDIIn->m_hInputEvent));
+	pMIDIIn->m_hInputEvent = NULL;
 	free (pMIDIIn->m_pDeviceName);
 	pMIDIIn->m_pDeviceName = NULL;
-	MIDIIO_UnLockBuf (pMIDIIn);
 	free (pMIDIIn);
 	return 1;
 }
@@ -1226,168 +2608,238 @@ MIDIIn* __stdcall MIDIIn_ReopenW (MIDIIn* pMIDIIn, const wchar_t* pszDeviceName)
 
 /* MIDI入力デバイスをリセットする。 */
 long __stdcall MIDIIn_Reset (MIDIIn* pMIDIIn) {
-	int nRet = 0;
 	_ASSERT (pMIDIIn);
 	_ASSERT (pMIDIIn->m_lMode == MIDIIO_MODEIN);
-	nRet = midiInReset (pMIDIIn->m_pDeviceHandle);
-	if (nRet == MMSYSERR_NOERROR) {
-		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_Reset内でmidiInResetが%dを返しました。\r\n", nRet);
-		return 0;
-	}
-	return 1;
+	return MIDIIO_BACKEND (pMIDIIn)->m_pfnReset (pMIDIIn);
 }
 
 /* MIDI入力デバイスからMIDIメッセージを1つ入力する */
+/* (入力バッファが空の場合は待たずに0を返す) */
 long __stdcall MIDIIn_GetMIDIMessage (MIDIIn* pMIDIIn, unsigned char* pMessage, long lLen) {
+	return MIDIIn_GetMIDIMessageEx (pMIDIIn, pMessage, lLen, NULL);
+}
+
+/* 入力バッファのlPositionから始まるMIDIメッセージの長さを調べる(読み込み側)(隠蔽)(20261019追加) */
+/* lReadableLenはlPositionから先の未読データのバイト数(1以上)であり、戻り値はこれを超えない。 */
+/* ランニングステータスを更新するため、メッセージの先頭から順に呼び出すこと。 */
+static long MIDIIn_GetMessageLen (MIDI* pMIDIIn, long lPosition, long lReadableLen) {
 	unsigned char cType;
-	long lMessageLen, lCopyLen;
-	unsigned char* p;
-	_ASSERT (pMIDIIn);
-	_ASSERT (pMIDIIn->m_lMode == MIDIIO_MODEIN);
-	_ASSERT (pMessage);
-	/* 取り込むデータがバッファ上にある */
-	if (pMIDIIn->m_lReadPosition != pMIDIIn->m_lWritePosition) {
-		cType = *(pMIDIIn->m_pBuf + pMIDIIn->m_lReadPosition);
-		/* ノート・チャンネルアフター・コントロール・ピッチベンド */	
-		if (0x80 <= cType && cType <= 0xBF ||
-			0xE0 <= cType && cType <= 0xEF) {
-			pMIDIIn->m_byRunningStatus = cType; // 20090627追加
-			lMessageLen = 3;
-		}
-		/* プログラム・キーアフタータッチ */
-		else if (0xC0 <= cType && cType <= 0xDF) {
-			pMIDIIn->m_byRunningStatus = cType; // 20090627追加
-			lMessageLen = 2;
-		}
-		/* システムリアルタイムメッセージ */
-		else if (0xF8 <= cType && cType <= 0xFF) {
-			lMessageLen = 1;
-		}
-		/* システムエクスクルーシヴメッセージ */
-		else if (cType == 0xF0) { // 20090627修正
-			lMessageLen = 0;
-			p = pMIDIIn->m_pBuf + pMIDIIn->m_lReadPosition;
-			do {
-				p++;
-				lMessageLen++;
-				if (p >= pMIDIIn->m_pBuf + pMIDIIn->m_lBufSize) {
-					p = pMIDIIn->m_pBuf;
-				}
-			} while (*p <= 0x7F);
+	long lMessageLen;
+	long lMask = pMIDIIn->m_lBufSize - 1;
+	cType = *(pMIDIIn->m_pBuf + lPosition);
+	/* ノート・チャンネルアフター・コントロール・ピッチベンド */	
+	if (0x80 <= cType && cType <= 0xBF ||
+		0xE0 <= cType && cType <= 0xEF) {
+		pMIDIIn->m_byRunningStatus = cType; // 20090627追加
+		lMessageLen = 3;
+	}
+	/* プログラム・キーアフタータッチ */
+	else if (0xC0 <= cType && cType <= 0xDF) {
+		pMIDIIn->m_byRunningStatus = cType; // 20090627追加
+		lMessageLen = 2;
+	}
+	/* システムリアルタイムメッセージ */
+	else if (0xF8 <= cType && cType <= 0xFF) {
+		lMessageLen = 1;
+	}
+	/* システムエクスクルーシヴメッセージ */
+	else if (cType == 0xF0) { // 20090627修正
+		/* 終端(0x80以上のバイト)まで数える。未読データの範囲外は見ない(20261019修正) */
+		lMessageLen = 1;
+		while (lMessageLen < lReadableLen &&
+			*(pMIDIIn->m_pBuf + ((lPosition + lMessageLen) & lMask)) <= 0x7F) {
 			lMessageLen++;
 		}
-		/* MIDIタイムコードクォーターフレーム・ソングセレクト */
-		else if (cType == 0xF1 || cType == 0xF3) { // 20090627追加
-			lMessageLen = 2;
-		}
-		/* ソングポジションセレクタ */
-		else if (cType == 0xF2) { // 20090627追加
-			lMessageLen = 3;
-		}
-		/* チューンリクエスト */
-		else if (cType == 0xF6) { // 20090627追加
-			lMessageLen = 1;
-		}
-		/* 定義されていないシステムコモンメッセージ */
-		else if ((cType & 0xF0) == 0xF0) { // 20090627追加
-			_RPTF1 (_CRT_WARN, "エラー：MIDIIn_GetMIDIMessage内で定義されていない"
-				"MIDIメッセージを検出しました(%d)。\r\n", cType);
+		lMessageLen++;
+	}
+	/* MIDIタイムコードクォーターフレーム・ソングセレクト */
+	else if (cType == 0xF1 || cType == 0xF3) { // 20090627追加
+		lMessageLen = 2;
+	}
+	/* ソングポジションセレクタ */
+	else if (cType == 0xF2) { // 20090627追加
+		lMessageLen = 3;
+	}
+	/* チューンリクエスト */
+	else if (cType == 0xF6) { // 20090627追加
+		lMessageLen = 1;
+	}
+	/* 定義されていないシステムコモンメッセージ */
+	else if ((cType & 0xF0) == 0xF0) { // 20090627追加
+		_RPTF1 (_CRT_WARN, "エラー：MIDIIn_GetMessageLen内で定義されていない"
+			"MIDIメッセージを検出しました(%d)。\r\n", cType);
+		lMessageLen = 1;
+	}
+	/* ランニングステータスが省略されている場合(0x00<=cType<=0x7F) */
+	else {
+		if ((pMIDIIn->m_byRunningStatus & 0xF0) == 0xC0 || // 20090627追加
+			(pMIDIIn->m_byRunningStatus & 0xF0) == 0xD0) {
 			lMessageLen = 1;
 		}
-		/* ランニングステータスが省略されている場合(0x00<=cType<=0x7F) */
 		else {
-			if ((pMIDIIn->m_byRunningStatus & 0xF0) == 0xC0 || // 20090627追加
-				(pMIDIIn->m_byRunningStatus & 0xF0) == 0xD0) {
-				lMessageLen = 1;
-			}
-			else {
-				lMessageLen = 2;
-			}
+			lMessageLen = 2;
 		}
-		lCopyLen = MIN (lMessageLen, lLen);
-		MIDIIO_LockBuf (pMIDIIn);
-		if (pMIDIIn->m_lReadPosition + lMessageLen < pMIDIIn->m_lBufSize) {
-			memcpy (pMessage, pMIDIIn->m_pBuf + pMIDIIn->m_lReadPosition, lCopyLen);
-			pMIDIIn->m_lReadPosition += lMessageLen;
+	}
+	return MIN (lMessageLen, lReadableLen);
+}
+
+/* MIDI入力デバイスからMIDIメッセージを1つ入力し、その受信時刻[マイクロ秒]を取得する(20261019追加) */
+/* (入力バッファが空の場合は待たずに0を返す。pMicrosecはNULLでもよい) */
+long __stdcall MIDIIn_GetMIDIMessageEx 
+(MIDIIn* pMIDIIn, unsigned char* pMessage, long lLen, int64_t* pMicrosec) {
+	long lMessageLen, lCopyLen, lReadableLen;
+	int64_t llMicrosec;
+	_ASSERT (pMIDIIn);
+	_ASSERT (pMIDIIn->m_lMode == MIDIIO_MODEIN);
+	_ASSERT (pMessage);
+	lReadableLen = MIDIIO_GetReadableLen (pMIDIIn);
+	/* 取り込むデータがバッファ上にない */
+	if (lReadableLen == 0) {
+		return 0;
+	}
+	/* 取り込むデータがバッファ上にある */
+	lMessageLen = MIDIIn_GetMessageLen (pMIDIIn, pMIDIIn->m_lReadPosition, lReadableLen);
+	lCopyLen = MIN (lMessageLen, lLen);
+	/* 受信時刻はメッセージ先頭の位置に格納されている */
+	/* (GetByte等で途中から読んだ場合は、そのメッセージの受信時刻とは限らない) */
+	llMicrosec = pMIDIIn->m_pTimeBuf[pMIDIIn->m_lReadPosition];
+	if (pMicrosec) {
+		*pMicrosec = llMicrosec;
+	}
+	MIDIIO_AddLatency (pMIDIIn, MIDIClock_QueryMonotonicMicrosec () - llMicrosec);
+	MIDIIO_ReadBuf (pMIDIIn, pMessage, lCopyLen, lMessageLen);
+	return lCopyLen;
+}
+
+/* MIDI入力デバイスから入力済みのMIDIメッセージをまとめて入力する(20261019追加) */
+/* (最大lMaxNum個。入力バッファが空の場合は待たずに0を返す。戻り値は入力したメッセージの数) */
+/* 長さがMIDIIO_MSGRECORDDATASIZEを超えるメッセージ(SYSX)はpSysxBufへ詰めて格納する。 */
+/* pSysxBufに入りきらないSYSXに達した場合はそこで止め、残りは次回以降に入力する。 */
+/* (lSysxBufLenより長いSYSXはMIDIIn_GetMIDIMessage(Ex)で入力すること) */
+long __stdcall MIDIIn_GetMIDIMessages 
+(MIDIIn* pMIDIIn, MIDIMsgRecord* pRecord, long lMaxNum, unsigned char* pSysxBuf, long lSysxBufLen) {
+	long lReadPosition, lReadableLen, lMessageLen;
+	long lSysxOffset = 0;
+	long lNum = 0;
+	unsigned char byRunningStatus;
+	int64_t llNow;
+	_ASSERT (pMIDIIn);
+	_ASSERT (pMIDIIn->m_lMode == MIDIIO_MODEIN);
+	_ASSERT (pRecord);
+	if (pSysxBuf == NULL) {
+		lSysxBufLen = 0;
+	}
+	/* 書き込み位置の取得と読み込み位置の更新はそれぞれ1回だけ行う */
+	lReadableLen = MIDIIO_GetReadableLen (pMIDIIn);
+	lReadPosition = pMIDIIn->m_lReadPosition;
+	llNow = MIDIClock_QueryMonotonicMicrosec ();
+	while (lNum < lMaxNum && lReadableLen > 0) {
+		MIDIMsgRecord* pThisRecord = pRecord + lNum;
+		byRunningStatus = pMIDIIn->m_byRunningStatus;
+		lMessageLen = MIDIIn_GetMessageLen (pMIDIIn, lReadPosition, lReadableLen);
+		if (lMessageLen <= MIDIIO_MSGRECORDDATASIZE) {
+			MIDIIO_PeekBuf (pMIDIIn, lReadPosition, pThisRecord->m_byData, lMessageLen);
+			pThisRecord->m_lSysxOffset = -1;
 		}
 		else {
-			memcpy (pMessage, pMIDIIn->m_pBuf + pMIDIIn->m_lReadPosition, 
-				pMIDIIn->m_lBufSize - pMIDIIn->m_lReadPosition); 
-			memcpy (pMessage + (pMIDIIn->m_lBufSize - pMIDIIn->m_lReadPosition),
-				pMIDIIn->m_pBuf,
-				lCopyLen - (pMIDIIn->m_lBufSize - pMIDIIn->m_lReadPosition));
-			pMIDIIn->m_lReadPosition = lMessageLen - 
-				(pMIDIIn->m_lBufSize - pMIDIIn->m_lReadPosition);
+			/* SYSXバッファに入りきらない場合はこのメッセージを読まずに終了 */
+			if (lMessageLen > lSysxBufLen - lSysxOffset) {
+				pMIDIIn->m_byRunningStatus = byRunningStatus;
+				break;
+			}
+			MIDIIO_PeekBuf (pMIDIIn, lReadPosition, pSysxBuf + lSysxOffset, lMessageLen);
+			pThisRecord->m_lSysxOffset = lSysxOffset;
+			lSysxOffset += lMessageLen;
 		}
-		MIDIIO_UnLockBuf (pMIDIIn);
-		return lCopyLen;
+		pThisRecord->m_llMicrosec = pMIDIIn->m_pTimeBuf[lReadPosition];
+		pThisRecord->m_lLen = lMessageLen;
+		MIDIIO_AddLatency (pMIDIIn, llNow - pThisRecord->m_llMicrosec);
+		lReadPosition = (lReadPosition + lMessageLen) & (pMIDIIn->m_lBufSize - 1);
+		lReadableLen -= lMessageLen;
+		lNum++;
 	}
-	/* 取り込むデータがバッファ上にない */
-	else {
-		return 0;
+	if (lNum > 0) {
+		MIDIIO_StoreRelease (&(pMIDIIn->m_lReadPosition), lReadPosition);
 	}
+	return lNum;
 }
 
 /* MIDI入力デバイスから1バイト入力する */
 long __stdcall MIDIIn_GetByte (MIDIIn* pMIDIIn, unsigned char* p) {
-	long lRet;
 	_ASSERT (pMIDIIn);
 	_ASSERT (pMIDIIn->m_lMode == MIDIIO_MODEIN);
 	_ASSERT (p);
-	MIDIIO_LockBuf (pMIDIIn);
-	if (pMIDIIn->m_lReadPosition != pMIDIIn->m_lWritePosition) {
-		*p = *(pMIDIIn->m_pBuf + pMIDIIn->m_lReadPosition);
-		pMIDIIn->m_lReadPosition++;
-		if (pMIDIIn->m_lReadPosition >= pMIDIIn->m_lBufSize) {
-			pMIDIIn->m_lReadPosition = 0;
-		}
-		lRet = 1;
-	}
-	else {
-		lRet = 0;
+	if (MIDIIO_GetReadableLen (pMIDIIn) == 0) {
+		return 0;
 	}
-	MIDIIO_UnLockBuf (pMIDIIn);
-	return lRet;
+	MIDIIO_ReadBuf (pMIDIIn, p, 1, 1);
+	return 1;
 }
 
 /* MIDI入力デバイスから任意長のデータを入力する */
 long __stdcall MIDIIn_GetBytes (MIDIIn* pMIDIIn, unsigned char* pData, long lLen) {
-	unsigned char cType;
-	long lLen2, lCopyLen;
+	long lCopyLen;
 	_ASSERT (pMIDIIn);
 	_ASSERT (pMIDIIn->m_lMode == MIDIIO_MODEIN);
 	_ASSERT (pData);
+	lCopyLen = MIN (lLen, MIDIIO_GetReadableLen (pMIDIIn));
+	/* 取り込むデータがバッファ上にない */
+	if (lCopyLen <= 0) {
+		return 0;
+	}
 	/* 取り込むデータがバッファ上にある */
-	if (pMIDIIn->m_lReadPosition != pMIDIIn->m_lWritePosition) {
-		cType = *(pMIDIIn->m_pBuf + pMIDIIn->m_lReadPosition);
-		lLen2 = pMIDIIn->m_lWritePosition - pMIDIIn->m_lReadPosition;
-		if (lLen2 < 0) {
-			lLen2 += MIDIIO_BUFSIZE;
-		}
-		lCopyLen = MIN (lLen, lLen2);
-		MIDIIO_LockBuf (pMIDIIn);
-		if (pMIDIIn->m_lReadPosition + lCopyLen < pMIDIIn->m_lBufSize) {
-			memcpy (pData, pMIDIIn->m_pBuf + pMIDIIn->m_lReadPosition, lCopyLen);
-			pMIDIIn->m_lReadPosition += lCopyLen;
+	MIDIIO_ReadBuf (pMIDIIn, pData, lCopyLen, lCopyLen);
+	return lCopyLen;
+}
+
+/* MIDI入力デバイスにデータが入力されるまで待つ(20261019追加) */
+/* lTimeoutは最大待ち時間[マイクロ秒](-1=無限)。データがあれば1を、時間切れの場合は0を返す。 */
+/* (待ち時間の精度はミリ秒単位である) */
+long __stdcall MIDIIn_Wait (MIDIIn* pMIDIIn, long lTimeout) {
+	int64_t llDeadline = 0;
+	int64_t llRemain;
+	DWORD dwMillisec;
+	_ASSERT (pMIDIIn);
+	_ASSERT (pMIDIIn->m_lMode == MIDIIO_MODEIN);
+	if (lTimeout >= 0) {
+		llDeadline = MIDIClock_QueryMonotonicMicrosec () + lTimeout;
+	}
+	while (1) {
+		/* 読み込み位置の更新後に書き込み位置を読み直す(MIDIIO_WriteBufと対) */
+		MemoryBarrier ();
+		if (MIDIIO_GetReadableLen (pMIDIIn) > 0) {
+			return 1;
+		}
+		if (lTimeout < 0) {
+			dwMillisec = INFINITE;
 		}
 		else {
-			memcpy (pData, pMIDIIn->m_pBuf + pMIDIIn->m_lReadPosition, 
-				pMIDIIn->m_lBufSize - pMIDIIn->m_lReadPosition); 
-			memcpy (pData + (pMIDIIn->m_lBufSize - pMIDIIn->m_lReadPosition),
-				pMIDIIn->m_pBuf,
-				lCopyLen - (pMIDIIn->m_lBufSize - pMIDIIn->m_lReadPosition));
-			pMIDIIn->m_lReadPosition = lCopyLen - 
-				(pMIDIIn->m_lBufSize - pMIDIIn->m_lReadPosition);
+			llRemain = llDeadline - MIDIClock_QueryMonotonicMicrosec ();
+			if (llRemain <= 0) {
+				return 0;
+			}
+			dwMillisec = (DWORD)((llRemain + 999) / 1000);
 		}
-		MIDIIO_UnLockBuf (pMIDIIn);
-		return lCopyLen;
-	}
-	/* 取り込むデータがバッファ上にない */
-	else {
-		return 0;
+		WaitForSingleObject ((HANDLE)(pMIDIIn->m_hInputEvent), dwMillisec);
 	}
 }
 
+/* 入力待ち用のイベントハンドルを取得する(20261019追加) */
+/* 入力バッファが空から空でなくなったときにシグナル状態となる(自動リセット)。 */
+/* WaitForMultipleObjects等で待つ場合は、待つ前に入力バッファを空になるまで読むこと。 */
+void* __stdcall MIDIIn_GetWaitHandle (MIDIIn* pMIDIIn) {
+	_ASSERT (pMIDIIn);
+	_ASSERT (pMIDIIn->m_lMode == MIDIIO_MODEIN);
+	return pMIDIIn->m_hInputEvent;
+}
+
+/* 入力バッファが一杯で捨てたMIDIメッセージの数を取得する(20261019追加) */
+long __stdcall MIDIIn_GetOverflowCount (MIDIIn* pMIDIIn) {
+	_ASSERT (pMIDIIn);
+	_ASSERT (pMIDIIn->m_lMode == MIDIIO_MODEIN);
+	return pMIDIIn->m_lOverflowCount;
+}
+
 /* このMIDI入力デバイスの名前を取得する(ANSI)(20120415追加) */
 long __stdcall MIDIIn_GetThisDeviceNameA (MIDIIn* pMIDIIn, char* pszDeviceName, long lLen) {
 	long lLen2;
@@ -1409,3 +2861,136 @@ long __stdcall MIDIIn_GetThisDeviceNameW (MIDIIn* pMIDIIn, wchar_t* pszDeviceNam
 	wcsncpy_s (pszDeviceName, lLen, pMIDIIn->m_pDeviceName, CLIP (0, lLen2, lLen - 1));
 	return CLIP (0, lLen2, lLen - 1);
 }
+
+/******************************************************************************/
+/*                                                                            */
+/*  MIDIIO共通関数群(20261019追加)                                            */
+/*                                                                            */
+/******************************************************************************/
+
+/* MIDI出力又はMIDI入力の統計を取得する */
+long __stdcall MIDIIO_GetStats (MIDI* pMIDI, MIDIIOStats* pStats) {
+	long k;
+	_ASSERT (pMIDI);
+	_ASSERT (pStats);
+	memset (pStats, 0, sizeof (MIDIIOStats));
+	pStats->m_lMode = pMIDI->m_lMode;
+	pStats->m_llMessageNum = pMIDI->m_llMessageNum;
+	pStats->m_llByteNum = pMIDI->m_llByteNum;
+	pStats->m_lSysxDropCount = pMIDI->m_lSysxDropCount;
+	pStats->m_lMaxFillLen = pMIDI->m_lMaxFillLen;
+	if (pMIDI->m_lMode == MIDIIO_MODEOUT) {
+		pStats->m_lBufSize = pMIDI->m_lSysxPoolNum;
+		pStats->m_lSysxWaitCount = pMIDI->m_lSysxWaitCount;
+		pStats->m_lSysxDoneCount = pMIDI->m_lSysxDoneCount;
+	}
+	else {
+		pStats->m_lBufSize = pMIDI->m_lBufSize;
+		pStats->m_lOverflowCount = pMIDI->m_lOverflowCount;
+		pStats->m_llMaxLatency = pMIDI->m_llMaxLatency;
+		for (k = 0; k < MIDIIO_LATENCYBUCKETNUM; k++) {
+			pStats->m_lLatencyCount[k] = pMIDI->m_lLatencyCount[k];
+		}
+	}
+	return 1;
+}
+
+
+/******************************************************************************/
+/*                                                                            */
+/*  MIDIStream関数群(20261019追加)                                            */
+/*                                                                            */
+/******************************************************************************/
+
+/* バイト列の先頭から1つのMIDIメッセージを切り出す */
+/* *pRunningStatusは呼び出しをまたいで保持するランニングステータス(最初は0を渡す)。 */
+/* 切り出したメッセージはpData+*pOffsetから*pMessageLenバイトであり、戻り値は消費したバイト数。 */
+/* ランニングステータスのない不正なデータバイトは次のステータスバイトまで読み飛ばし、*pOffsetに数える。 */
+/* バイト列の末尾で途切れたメッセージはその長さのまま返す。終端(0xF7)のないSYSXの場合は */
+/* *pRunningStatusを0xF0とし、次のバイト列の先頭のデータバイトをSYSXの続きとして切り出す。 */
+/* ランニングステータスで省略されたメッセージはデータバイトのみを切り出す。 */
+long __stdcall MIDIStream_Split 
+(const unsigned char* pData, long lLen, unsigned char* pRunningStatus, long* pOffset, long* pMessageLen) {
+	const unsigned char* pEnd;
+	unsigned char cType;
+	long lOffset = 0;
+	long lMessageLen = 0;
+	long lExpectLen;
+	_ASSERT (pData || lLen <= 0);
+	_ASSERT (pRunningStatus);
+	_ASSERT (pOffset);
+	_ASSERT (pMessageLen);
+	*pOffset = 0;
+	*pMessageLen = 0;
+	if (lLen <= 0) {
+		return 0;
+	}
+	/* データバイトで始まる場合 */
+	if (pData[0] < 0x80) {
+		/* システムエクスクルーシヴメッセージの続き */
+		if (*pRunningStatus == 0xF0) {
+			pEnd = (const unsigned char*)memchr (pData, 0xF7, lLen);
+			if (pEnd) {
+				*pRunningStatus = 0;
+				*pMessageLen = INT_PTRtolong (pEnd - pData) + 1;
+			}
+			else {
+				*pMessageLen = lLen;
+			}
+			return *pMessageLen;
+		}
+		/* ランニングステータス(ステータスバイトが省略されている) */
+		if (*pRunningStatus != 0) {
+			lExpectLen = g_byMIDIIOStatusLen[*pRunningStatus] - 1;
+			while (lMessageLen < lExpectLen && lMessageLen < lLen && pData[lMessageLen] < 0x80) {
+				lMessageLen++;
+			}
+			*pMessageLen = lMessageLen;
+			return lMessageLen;
+		}
+		/* ランニングステータスがない場合は次のステータスバイトまで読み飛ばす */
+		while (lOffset < lLen && pData[lOffset] < 0x80) {
+			lOffset++;
+		}
+		*pOffset = lOffset;
+		if (lOffset >= lLen) {
+			return lLen;
+		}
+	}
+	cType = pData[lOffset];
+	/* システムエクスクルーシヴメッセージ */
+	if (cType == 0xF0) {
+		pEnd = (const unsigned char*)memchr (pData + lOffset + 1, 0xF7, lLen - lOffset - 1);
+		if (pEnd) {
+			*pRunningStatus = 0;
+			lMessageLen = INT_PTRtolong (pEnd - (pData + lOffset)) + 1;
+		}
+		else {
+			*pRunningStatus = 0xF0;
+			lMessageLen = lLen - lOffset;
+		}
+	}
+	/* システムリアルタイムメッセージ(ランニングステータスは変えない) */
+	else if (cType >= 0xF8) {
+		lMessageLen = 1;
+	}
+	/* チャンネルメッセージ・システムコモンメッセージ */
+	/* (途中にステータスバイトがあればそこで打ち切る) */
+	else {
+		lExpectLen = g_byMIDIIOStatusLen[cType];
+		lMessageLen = 1;
+		while (lMessageLen < lExpectLen && lOffset + lMessageLen < lLen &&
+			pData[lOffset + lMessageLen] < 0x80) {
+			lMessageLen++;
+		}
+		*pRunningStatus = (cType < 0xF0 ? cType : 0);
+	}
+	*pMessageLen = lMessageLen;
+	return lOffset + lMessageLen;
+}
+
+/* ステータスバイトからMIDIメッセージの長さを求める */
+/* (データバイトの場合及び長さの決まらないSYSX(0xF0)の場合は0を返す) */
+long __stdcall MIDIStream_GetMessageLen (unsigned char cStatus) {
+	return g_byMIDIIOStatusLen[cStatus];
+}
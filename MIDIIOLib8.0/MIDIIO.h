@@ -27,14 +27,24 @@
 #if !defined _MIDIIO_H_
 #define _MIDIIO_H_
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-#define MIDIIO_BUFSIZE 16384
+#define MIDIIO_BUFSIZE 16384 /* 入力バッファの大きさ(2のべき乗であること) */
 #define MIDIIO_SYSXNUM 4
 #define MIDIIO_MAXSYSXSIZE 4096 /* 20220303追加 */
 #define MIDIIO_SYSXSIZE 4096
+#define MIDIIO_SYSXOUTNUM 64 /* SYSX送信バッファの既定の数(20261019追加) */
+#define MIDIIO_SYSXOUTMAXNUM 4096 /* SYSX送信バッファの数の上限(20261019追加) */
+#define MIDIIO_SYSXOUTMAXSIZE 1048576 /* SYSX送信バッファの大きさの上限(20261019追加) */
+#define MIDIIO_SYSXTIMEOUT 1000 /* SYSX送信バッファが空くのを待つ既定の時間[ミリ秒](20261019追加) */
+#define MIDIIO_QUEUESIZE 4096 /* 時刻指定出力キューの項目数(2のべき乗であること)(20261019追加) */
+#define MIDIIO_CLEARQUEUETIMEOUT 1000 /* 出力キューの破棄の完了を待つ最大の時間[ミリ秒](20261019追加) */
+#define MIDIIO_MSGRECORDDATASIZE 8 /* MIDIMsgRecordに直接格納できるMIDIメッセージの長さ(20261019追加) */
+#define MIDIIO_LATENCYBUCKETNUM 32 /* 読み出し遅延のヒストグラムの区間の数(20261019追加) */
 #define MIDIIO_MODEIN  0x0000
 #define MIDIIO_MODEOUT 0x0001
 
@@ -47,6 +57,20 @@ extern "C" {
 #define MIDIIO_MIDIMAPPER "MIDI Mapper"
 #define MIDIIO_MIDIMAPPERJ "MIDI マッパー"
 
+/* 仮想デバイス名(20261019追加) */
+/* "Null"は何も出力せず、何も入力しない。 */
+/* "Loopback 1"〜"Loopback 16"は同じ名前のMIDI出力とMIDI入力を対にし、 */
+/* MIDI出力に出力したデータをそのままMIDI入力から入力できる。 */
+/* "Shared 名前"は同じ名前のMIDI出力とMIDI入力を名前付き共有メモリで対にし、 */
+/* 別のプロセス間でも受け渡しができる。受信時刻には送信時刻が入る。 */
+/* 開いたまま異常終了したプロセスの出力・入力は、次に開くプロセスが引き継ぐ。 */
+#define MIDIIO_NULL "Null"
+#define MIDIIO_LOOPBACK "Loopback"
+#define MIDIIO_LOOPBACKNUM 16
+#define MIDIIO_SHARED "Shared"
+#define MIDIIO_SHAREDMAXNAMELEN 200 /* "Shared "の後ろの名前の最大長[文字] */
+#define MIDIIO_SHAREDBUFSIZE 65536 /* 共有メモリ上のリングバッファの大きさ(2のべき乗であること) */
+
 
 
 #ifdef UNICODE 
@@ -74,12 +98,62 @@ typedef struct tagMIDI {
 	long  m_bStarting;
 	unsigned char* m_pBuf;
 	long  m_lBufSize;
-	long  m_lReadPosition;
-	long  m_lWritePosition;
-	long  m_bBufLocked;
+	volatile long m_lReadPosition; /* 20261019volatile化 */
+	volatile long m_lWritePosition; /* 20261019volatile化 */
+	long  m_bBufLocked; /* 20261019以降未使用 */
 	unsigned char m_byRunningStatus;
+	const void* m_pBackend; /* バックエンド関数テーブル(20261019追加) */
+	void* m_pBackendData; /* バックエンド固有のデータ(20261019追加) */
+	void* m_pSysxPool; /* SYSX送信バッファ(MIDIHDRの配列とデータ領域)(20261019追加) */
+	long  m_lSysxPoolNum; /* SYSX送信バッファの数(20261019追加) */
+	long  m_lSysxPoolSize; /* SYSX送信バッファ1つあたりの大きさ[バイト](20261019追加) */
+	unsigned long m_ulSysxHead; /* 次に送信するSYSX送信バッファの通し番号(20261019追加) */
+	unsigned long m_ulSysxTail; /* 送信完了を待つ最も古いSYSX送信バッファの通し番号(20261019追加) */
+	long  m_lSysxTimeout; /* SYSX送信バッファが空くのを待つ最大時間[ミリ秒](-1=無限)(20261019追加) */
+	void* m_hSysxEvent; /* SYSXの送信完了を通知するイベント(20261019追加) */
+	long  m_lSysxWaitCount; /* SYSX送信バッファが空くのを待った回数(20261019追加) */
+	long  m_lSysxDropCount; /* SYSXを送信できずに捨てた回数(20261019追加) */
+	long  m_lOverflowCount; /* 入力バッファが一杯で捨てたMIDIメッセージの数(20261019追加) */
+	int64_t* m_pTimeBuf; /* 入力バッファの各メッセージの受信時刻[マイクロ秒](20261019追加) */
+	int64_t m_llStartMicrosec; /* 入力を開始した時刻[マイクロ秒](20261019追加) */
+	void* m_hInputEvent; /* 入力バッファが空でなくなったことを通知するイベント(20261019追加) */
+	void* m_pQueue; /* 時刻指定出力キュー(未使用の場合はNULL)(20261019追加) */
+	int64_t m_llMessageNum; /* 送信又は受信したMIDIメッセージの数(20261019追加) */
+	int64_t m_llByteNum; /* 送信又は受信したバイト数(20261019追加) */
+	long  m_lSysxDoneCount; /* 送信完了したSYSXの数(20261019追加) */
+	long  m_lMaxFillLen; /* 入力バッファの最大使用量又は送信中のSYSX送信バッファの最大数(20261019追加) */
+	int64_t m_llMaxLatency; /* 受信時刻から読み出しまでの最大遅延[マイクロ秒](20261019追加) */
+	long  m_lLatencyCount[MIDIIO_LATENCYBUCKETNUM]; /* 読み出し遅延のヒストグラム(20261019追加) */
 } MIDI;
 
+/* MIDIIO_GetStatsで取得する入出力の統計(20261019追加) */
+/* 読み出し遅延は、入力バッファに書き込まれた受信時刻からMIDIIn_GetMIDIMessage(Ex)又は */
+/* MIDIIn_GetMIDIMessagesで読み出されるまでの時間である。ヒストグラムのk番目(k≧1)の区間は */
+/* 遅延が2^(k-1)マイクロ秒以上2^kマイクロ秒未満、0番目は1マイクロ秒未満のメッセージの数とし、 */
+/* 最後の区間にはそれ以上の遅延をすべて数える。 */
+typedef struct tagMIDIIOStats {
+	long  m_lMode; /* MIDIIO_MODEIN又はMIDIIO_MODEOUT */
+	long  m_lBufSize; /* 入力バッファの大きさ[バイト](入力)又はSYSX送信バッファの数(出力) */
+	int64_t m_llMessageNum; /* 受信(入力)又は送信(出力)したMIDIメッセージの数 */
+	int64_t m_llByteNum; /* 受信(入力)又は送信(出力)したバイト数 */
+	long  m_lSysxWaitCount; /* SYSX送信バッファが空くのを待った回数(出力のみ) */
+	long  m_lSysxDropCount; /* SYSXを送信できずに捨てた回数又は受信エラーとなったSYSXの数 */
+	long  m_lSysxDoneCount; /* 送信完了したSYSXの数(出力のみ) */
+	long  m_lOverflowCount; /* 入力バッファが一杯で捨てたMIDIメッセージの数(入力のみ) */
+	long  m_lMaxFillLen; /* 入力バッファの最大使用量[バイト](入力)又は送信中のSYSX送信バッファの最大数(出力) */
+	long  m_lReserved;
+	int64_t m_llMaxLatency; /* 最大読み出し遅延[マイクロ秒](入力のみ) */
+	long  m_lLatencyCount[MIDIIO_LATENCYBUCKETNUM]; /* 読み出し遅延のヒストグラム(入力のみ) */
+} MIDIIOStats;
+
+/* MIDIIn_GetMIDIMessagesで入力したMIDIメッセージ1つ分の記録(20261019追加) */
+typedef struct tagMIDIMsgRecord {
+	int64_t m_llMicrosec; /* 受信時刻[マイクロ秒](winmmの入力デバイスは1ミリ秒単位) */
+	long  m_lLen; /* MIDIメッセージの長さ[バイト] */
+	long  m_lSysxOffset; /* SYSXバッファ内の格納位置(m_byDataに格納した場合は-1) */
+	unsigned char m_byData[MIDIIO_MSGRECORDDATASIZE]; /* 長さがMIDIIO_MSGRECORDDATASIZE以下のMIDIメッセージ */
+} MIDIMsgRecord;
+
 /* DLLMain */
 //BOOL WINAPI DllMain (HINSTANCE hinstDLL, DWORD fdwReason, LPVOID lpvReserved);
 
@@ -113,6 +187,8 @@ MIDIOut* __stdcall MIDIOut_OpenW (const wchar_t* pszDeviceName);
 #endif
 
 /* MIDI出力デバイスを閉じる */
+/* 送信中のSYSXが回収できない等で閉じられなかった場合は0を返し、 */
+/* pMIDIDeviceは有効なまま残る(再度閉じることができる)(20261019追加) */
 long __stdcall MIDIOut_Close (MIDIOut* pMIDIDevice);
 
 /* MIDI出力デバイスを再び開く */
@@ -130,6 +206,11 @@ long __stdcall MIDIOut_Reset (MIDIOut* pMIDIDevice);
 /* MIDI出力デバイスに1メッセージ出力する */
 long __stdcall MIDIOut_PutMIDIMessage (MIDIOut* pMIDI, unsigned char* pMessage, long lLen);
 
+/* MIDI出力デバイスに3バイト以下のMIDIメッセージをまとめて出力する(20261019追加) */
+/* 各メッセージはmidiOutShortMsgと同じ形式(下位バイトからステータス・データ1・データ2)とする */
+/* 不正なステータス(データバイト・0xF0・0xF4・0xF5・0xF7)のメッセージは無視し、出力できたメッセージの数を返す */
+long __stdcall MIDIOut_PutShortMessages (MIDIOut* pMIDIOut, const uint32_t* pMessage, long lNum);
+
 /* MIDI出力デバイスに1バイトを出力する */
 long __stdcall MIDIOut_PutByte (MIDIOut* pMIDI, unsigned char cByte);
 
@@ -145,6 +226,42 @@ long __stdcall MIDIOut_GetThisDeviceNameW (MIDIOut* pMIDIOut, wchar_t* pszDevice
 #define MIDIOut_GetThisDeviceName MIDIOut_GetThisDeviceNameA
 #endif
 
+/* SYSX送信バッファの数と1つあたりの大きさ[バイト]を設定する(20261019追加) */
+/* (送信中のSYSXがすべて送信完了してから確保し直す。既定値は64個×4096バイト) */
+/* 1つあたりの大きさはMIDIOut_PutMIDIMessage・MIDIOut_EnqueueMIDIMessageで出力できる */
+/* Sysxの最大長となり、MIDIOut_PutBytesもこの大きさごとに区切って出力する */
+long __stdcall MIDIOut_SetSysxBuffer (MIDIOut* pMIDIOut, long lNumBuffer, long lBufferSize);
+
+/* SYSX送信バッファが空くのを待つ最大時間[ミリ秒]を設定する(20261019追加) */
+/* (0=待たずに捨てる、-1=無限に待つ。既定値は1000ミリ秒) */
+long __stdcall MIDIOut_SetSysxTimeout (MIDIOut* pMIDIOut, long lTimeout);
+
+/* 送信中のSYSX送信バッファの数を取得する(20261019追加) */
+long __stdcall MIDIOut_GetSysxPendingNum (MIDIOut* pMIDIOut);
+
+/* SYSX送信バッファが空くのを待った回数を取得する(20261019追加) */
+long __stdcall MIDIOut_GetSysxWaitCount (MIDIOut* pMIDIOut);
+
+/* SYSXを送信できずに捨てた回数を取得する(20261019追加) */
+long __stdcall MIDIOut_GetSysxDropCount (MIDIOut* pMIDIOut);
+
+/* MIDI出力デバイスの出力キューにMIDIメッセージを登録する(20261019追加) */
+/* llDeadlineは出力時刻[マイクロ秒](MIDIClock_GetMonotonicMicrosecと同じ基準)であり、 */
+/* 登録順に単調増加していなければならない */
+long __stdcall MIDIOut_EnqueueMIDIMessage 
+	(MIDIOut* pMIDIOut, int64_t llDeadline, unsigned char* pMessage, long lLen);
+
+/* MIDI出力デバイスの出力キューの未出力のMIDIメッセージをすべて捨てる(20261019追加) */
+/* 出力スレッドが破棄を終えるまで待ち、MIDIIO_CLEARQUEUETIMEOUTミリ秒以内に終わらなければ0を返す */
+/* (0を返した場合も、後で破棄されるのはこの関数を呼ぶ前に登録したメッセージだけである) */
+long __stdcall MIDIOut_ClearQueue (MIDIOut* pMIDIOut);
+
+/* MIDI出力デバイスの出力キューの未出力のMIDIメッセージの数を取得する(20261019追加) */
+long __stdcall MIDIOut_GetQueuedNum (MIDIOut* pMIDIOut);
+
+/* MIDI出力デバイスの出力キューで出力時刻より1ミリ秒以上遅れた回数を取得する(20261019追加) */
+long __stdcall MIDIOut_GetQueueLateCount (MIDIOut* pMIDIOut);
+
 /******************************************************************************/
 /*                                                                            */
 /*  MIDIInクラス関数群                                                        */
@@ -192,12 +309,34 @@ long __stdcall MIDIIn_Reset (MIDIIn* pMIDIDevice);
 /* MIDI入力デバイスから1メッセージ入力する */
 long __stdcall MIDIIn_GetMIDIMessage (MIDIIn* pMIDIIn, unsigned char* pMessage, long lLen);
 
+/* MIDI入力デバイスから1メッセージ入力し、その受信時刻[マイクロ秒]を取得する(20261019追加) */
+/* 受信時刻はMIDIClock_GetMonotonicMicrosecと同じ基準の単調増加時刻である */
+/* ただしwinmmの入力デバイスの受信時刻は、winmmが通知する入力開始からのミリ秒に基づくため */
+/* 分解能は1ミリ秒である(ループバック・共有メモリの入力は受信時にマイクロ秒単位で取得する) */
+long __stdcall MIDIIn_GetMIDIMessageEx 
+	(MIDIIn* pMIDIIn, unsigned char* pMessage, long lLen, int64_t* pMicrosec);
+
+/* MIDI入力デバイスから入力済みのMIDIメッセージをまとめて入力する(20261019追加) */
+/* SYSXはpSysxBufへ詰めて格納し、MIDIMsgRecordにはその位置を記録する */
+long __stdcall MIDIIn_GetMIDIMessages 
+	(MIDIIn* pMIDIIn, MIDIMsgRecord* pRecord, long lMaxNum, unsigned char* pSysxBuf, long lSysxBufLen);
+
 /* MIDI入力デバイスから1バイト入力する */
 long __stdcall MIDIIn_GetByte (MIDIIn* pMIDIIn, unsigned char* pByte);
 
 /* MIDI入力デバイスから任意長のバイナリデータを入力する */
 long __stdcall MIDIIn_GetBytes (MIDIIn* pMIDIIn, unsigned char* pBuf, long lLen);
 
+/* MIDI入力デバイスにデータが入力されるまで待つ(20261019追加) */
+/* lTimeoutは最大待ち時間[マイクロ秒](-1=無限)。データがあれば1を、時間切れの場合は0を返す。 */
+long __stdcall MIDIIn_Wait (MIDIIn* pMIDIIn, long lTimeout);
+
+/* 入力待ち用のイベントハンドル(HANDLE)を取得する(20261019追加) */
+void* __stdcall MIDIIn_GetWaitHandle (MIDIIn* pMIDIIn);
+
+/* 入力バッファが一杯で捨てたMIDIメッセージの数を取得する(20261019追加) */
+long __stdcall MIDIIn_GetOverflowCount (MIDIIn* pMIDIIn);
+
 /* このMIDI入力デバイスの名前を取得する(20120415追加) */
 long __stdcall MIDIIn_GetThisDeviceNameA (MIDIIn* pMIDIIn, char* pszDeviceName, long lLen);
 long __stdcall MIDIIn_GetThisDeviceNameW (MIDIIn* pMIDIIn, wchar_t* pszDeviceName, long lLen);
@@ -208,6 +347,34 @@ long __stdcall MIDIIn_GetThisDeviceNameW (MIDIIn* pMIDIIn, wchar_t* pszDeviceNam
 #endif
 
 
+/******************************************************************************/
+/*                                                                            */
+/*  MIDIIO共通関数群(20261019追加)                                            */
+/*                                                                            */
+/******************************************************************************/
+
+/* MIDI出力又はMIDI入力の統計を取得する */
+/* 各値は別のスレッドが更新中のことがあるため、厳密に同時点の値とは限らない。 */
+long __stdcall MIDIIO_GetStats (MIDI* pMIDI, MIDIIOStats* pStats);
+
+
+/******************************************************************************/
+/*                                                                            */
+/*  MIDIStream関数群(20261019追加)                                            */
+/*                                                                            */
+/******************************************************************************/
+
+/* バイト列の先頭から1つのMIDIメッセージを切り出す */
+/* *pRunningStatusは呼び出しをまたいで保持するランニングステータス(最初は0を渡す)。 */
+/* 切り出したメッセージはpData+*pOffsetから*pMessageLenバイトであり、戻り値は消費したバイト数。 */
+long __stdcall MIDIStream_Split (const unsigned char* pData, long lLen, 
+	unsigned char* pRunningStatus, long* pOffset, long* pMessageLen);
+
+/* ステータスバイトからMIDIメッセージの長さを求める */
+/* (データバイトの場合及び長さの決まらないSYSX(0xF0)の場合は0を返す) */
+long __stdcall MIDIStream_GetMessageLen (unsigned char cStatus);
+
+
 #ifdef __cplusplus
 }
 #endif
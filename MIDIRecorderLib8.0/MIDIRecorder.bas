@@ -0,0 +1,58 @@
+'******************************************************************************
+'*                                                                            *
+'*@MIDIRecorder.bas - MIDIRecorderW[(VB4,5,6p)   (C)2026        *
+'*                                                                            *
+'******************************************************************************
+
+' MIDI̓IuWFNgMMIDIbZ[WAMIDINbN
+' eBbNɊZȂMIDIgbN֒ڋL^(20261019ǉ)
+' ̃CúAGNU 򓙈ʌOp_(LGPL)ɊÂzz܂B
+' vWFNgz[y[WF"http://openmidiproject.sourceforge.jp/index.html"
+
+'This library is free software; you can redistribute it and/or
+'modify it under the terms of the GNU Lesser General Public
+'License as published by the Free Software Foundation; either
+'version 2.1 of the License, or (at your option) any later version.
+
+'This library is distributed in the hope that it will be useful,
+'but WITHOUT ANY WARRANTY; without even the implied warranty of
+'MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+'Lesser General Public License for more details.
+
+'You should have received a copy of the GNU Lesser General Public
+'License along with this library; if not, write to the Free Software
+'Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+Option Explicit
+
+' MIDIR[_[IuWFNg̍폜(L^̏ꍇ͒~)
+Declare Sub MIDIRecorder_Delete Lib "MIDIRecorder.dll" _
+    (ByVal pMIDIRecorder As Long)
+
+' MIDIR[_[IuWFNg̐
+Declare Function MIDIRecorder_Create Lib "MIDIRecorder.dll" _
+    (ByVal pMIDIIn As Long, ByVal pMIDIClock As Long, ByVal pMIDITrack As Long) As Long
+
+' L^Jn(L^XbhN)
+Declare Function MIDIRecorder_Start Lib "MIDIRecorder.dll" _
+    (ByVal pMIDIRecorder As Long) As Long
+
+' L^~(L^Xbh̏I҂)
+Declare Function MIDIRecorder_Stop Lib "MIDIRecorder.dll" _
+    (ByVal pMIDIRecorder As Long) As Long
+
+' L^ׂ
+Declare Function MIDIRecorder_IsRecording Lib "MIDIRecorder.dll" _
+    (ByVal pMIDIRecorder As Long) As Long
+
+' Jς݂̍Ō̃Cxg擾(܂L^ĂȂꍇ0)
+Declare Function MIDIRecorder_GetLastEvent Lib "MIDIRecorder.dll" _
+    (ByVal pMIDIRecorder As Long) As Long
+
+' L^Cxg̐擾
+Declare Function MIDIRecorder_GetRecordedNum Lib "MIDIRecorder.dll" _
+    (ByVal pMIDIRecorder As Long) As Long
+
+' gbNɒǉłɎ̂ĂMIDIbZ[W̐擾
+Declare Function MIDIRecorder_GetDroppedNum Lib "MIDIRecorder.dll" _
+    (ByVal pMIDIRecorder As Long) As Long
@@ -0,0 +1,295 @@
+/******************************************************************************/
+/*                                                                            */
+/*  MIDIRecorder.c - MIDI記録用モジュール(Win32用)         (C)2026 くず       */
+/*                                                                            */
+/******************************************************************************/
+
+/* このモジュールは普通のＣ言語で書かれている。 */
+/* このライブラリは、GNU 劣等一般公衆利用許諾契約書(LGPL)に基づき配布される。 */
+/* プロジェクトホームページ(仮)："http://openmidiproject.sourceforge.jp/index.html" */
+/* MIDI入力オブジェクトから受信したMIDIメッセージを、MIDIクロックで */
+/* ティックに換算しながらMIDIトラックへ直接記録する(20261019追加) */
+
+/* This library is free software; you can redistribute it and/or */
+/* modify it under the terms of the GNU Lesser General Public */
+/* License as published by the Free Software Foundation; either */
+/* version 2.1 of the License, or (at your option) any later version. */
+
+/* This library is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU */
+/* Lesser General Public License for more details. */
+
+/* You should have received a copy of the GNU Lesser General Public */
+/* License along with this library; if not, write to the Free Software */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <windows.h>
+#include <crtdbg.h>
+#include "MIDIRecorder.h"
+
+/* 受信待ちの最大時間[マイクロ秒](終了要求の確認間隔) */
+#define MIDIRECORDER_WAITTIMEOUT 100000
+
+/* イベントをトラックの最後に追加する(記録スレッド)(隠蔽) */
+/* (同種イベントは表から与えるため探索しない)。失敗した場合はイベントを削除して0を返す */
+static long MIDIRecorder_AppendEvent (MIDIRecorder* pMIDIRecorder, MIDIEvent* pEvent) {
+	long lKind = pEvent->m_lKind;
+	if (MIDITrack_AppendSingleEventForce (pMIDIRecorder->m_pMIDITrack,
+		pEvent, pMIDIRecorder->m_pLastSameKindEvent[lKind]) == 0) {
+		MIDIEvent_Delete (pEvent);
+		pMIDIRecorder->m_lDroppedNum++;
+		return 0;
+	}
+	pMIDIRecorder->m_pLastSameKindEvent[lKind] = pEvent;
+	return 1;
+}
+
+/* 1つのMIDIメッセージを記録する(記録スレッド)(隠蔽) */
+/* 最後に追加したイベントを返す。記録しなかった場合はNULLを返す。 */
+static MIDIEvent* MIDIRecorder_RecordMessage
+(MIDIRecorder* pMIDIRecorder, unsigned char* pMessage, long lLen, int64_t llMicrosec) {
+	MIDIEvent* pEvent;
+	MIDIEvent* pNoteOffEvent;
+	MIDIEvent* pLastEvent = NULL;
+	MIDIEvent** ppNoteOnEvent = NULL;
+	long lKind;
+	long lTime;
+	if (lLen <= 0) {
+		return NULL;
+	}
+	/* ランニングステータスの処理 */
+	if (pMessage[0] < 0x80) {
+		if (pMIDIRecorder->m_byRunningStatus == 0) {
+			pMIDIRecorder->m_lDroppedNum++;
+			return NULL;
+		}
+		lKind = pMIDIRecorder->m_byRunningStatus;
+	}
+	else if (pMessage[0] < 0xF0) {
+		lKind = pMessage[0];
+		pMIDIRecorder->m_byRunningStatus = pMessage[0];
+	}
+	/* システムエクスクルーシヴはランニングステータスを解除する */
+	else if (pMessage[0] == 0xF0) {
+		lKind = MIDIEVENT_SYSEXSTART;
+		pMIDIRecorder->m_byRunningStatus = 0;
+	}
+	/* システムコモンメッセージはランニングステータスを解除し、記録しない */
+	else if (pMessage[0] <= 0xF7) {
+		pMIDIRecorder->m_byRunningStatus = 0;
+		return NULL;
+	}
+	/* システムリアルタイムメッセージは記録しない */
+	else {
+		return NULL;
+	}
+	/* 受信時刻をティックに換算してイベントを作成する */
+	lTime = MIDIClock_GetTickCountAt (pMIDIRecorder->m_pMIDIClock, llMicrosec);
+	pEvent = MIDIEvent_Create (lTime, lKind, pMessage, lLen);
+	if (pEvent == NULL) {
+		pMIDIRecorder->m_lDroppedNum++;
+		return NULL;
+	}
+	lKind = pEvent->m_lKind;
+	if (MIDIEvent_IsNoteOn (pEvent) || MIDIEvent_IsNoteOff (pEvent)) {
+		ppNoteOnEvent = &(pMIDIRecorder->m_pNoteOnEvent[lKind & 0x0F][pEvent->m_pData[1] & 0x7F]);
+	}
+	/* 同じキーが鳴っている間に再びノートオンを受信した場合は、先のノートオンを */
+	/* ここで終わらせるノートオフを補って結合してから、新しいノートオンを追加する(20261019追加) */
+	if (MIDIEvent_IsNoteOn (pEvent) && *ppNoteOnEvent) {
+		pNoteOffEvent = MIDIEvent_CreateNoteOff (lTime, lKind & 0x0F, pEvent->m_pData[1], 0);
+		if (pNoteOffEvent && MIDIRecorder_AppendEvent (pMIDIRecorder, pNoteOffEvent)) {
+			MIDIEvent_CombineNoteOnOff (*ppNoteOnEvent, pNoteOffEvent);
+			pLastEvent = pNoteOffEvent;
+		}
+		*ppNoteOnEvent = NULL;
+	}
+	if (MIDIRecorder_AppendEvent (pMIDIRecorder, pEvent) == 0) {
+		return pLastEvent;
+	}
+	pMIDIRecorder->m_lRecordedNum++;
+	/* ノートオンは対応するノートオフを待つ */
+	if (MIDIEvent_IsNoteOn (pEvent)) {
+		*ppNoteOnEvent = pEvent;
+	}
+	/* ノートオフは未結合のノートオンと結合する */
+	else if (MIDIEvent_IsNoteOff (pEvent) && *ppNoteOnEvent) {
+		MIDIEvent_CombineNoteOnOff (*ppNoteOnEvent, pEvent);
+		*ppNoteOnEvent = NULL;
+	}
+	return pEvent;
+}
+
+/* 記録スレッド(隠蔽) */
+static DWORD WINAPI MIDIRecorder_ThreadProc (LPVOID pParam) {
+	MIDIRecorder* pMIDIRecorder = (MIDIRecorder*)pParam;
+	MIDIMsgRecord* pRecord;
+	MIDIEvent* pEvent;
+	MIDIEvent* pLastEvent;
+	long lNum, i;
+	while (!pMIDIRecorder->m_bExit) {
+		if (MIDIIn_Wait (pMIDIRecorder->m_pMIDIIn, MIDIRECORDER_WAITTIMEOUT) == 0) {
+			continue;
+		}
+		lNum = MIDIIn_GetMIDIMessages (pMIDIRecorder->m_pMIDIIn, pMIDIRecorder->m_pMsgRecord,
+			MIDIRECORDER_MSGNUM, pMIDIRecorder->m_pSysxBuf, MIDIRECORDER_SYSXBUFSIZE);
+		pLastEvent = NULL;
+		for (i = 0; i < lNum; i++) {
+			pRecord = pMIDIRecorder->m_pMsgRecord + i;
+			pEvent = MIDIRecorder_RecordMessage (pMIDIRecorder,
+				pRecord->m_lSysxOffset >= 0 ?
+				pMIDIRecorder->m_pSysxBuf + pRecord->m_lSysxOffset : pRecord->m_byData,
+				pRecord->m_lLen, pRecord->m_llMicrosec);
+			if (pEvent) {
+				pLastEvent = pEvent;
+			}
+		}
+		/* 取り出した分をまとめて公開する(イベントとリンクの書き込みを先に完了させる) */
+		if (pLastEvent) {
+			MemoryBarrier ();
+			pMIDIRecorder->m_pPublishedEvent = pLastEvent;
+		}
+	}
+	return 0;
+}
+
+/* MIDIレコーダーオブジェクトの削除(記録中の場合は停止する) */
+void __stdcall MIDIRecorder_Delete (MIDIRecorder* pMIDIRecorder) {
+	if (pMIDIRecorder == NULL) {
+		return;
+	}
+	MIDIRecorder_Stop (pMIDIRecorder);
+	free (pMIDIRecorder->m_pMsgRecord);
+	free (pMIDIRecorder->m_pSysxBuf);
+	free (pMIDIRecorder);
+}
+
+/* MIDIレコーダーオブジェクトの生成 */
+MIDIRecorder* __stdcall MIDIRecorder_Create
+(MIDIIn* pMIDIIn, MIDIClock* pMIDIClock, MIDITrack* pMIDITrack) {
+	MIDIRecorder* pMIDIRecorder;
+	_ASSERT (pMIDIIn);
+	_ASSERT (pMIDIClock);
+	_ASSERT (pMIDITrack);
+	if (pMIDIIn == NULL || pMIDIClock == NULL || pMIDITrack == NULL) {
+		return NULL;
+	}
+	if (pMIDIIn->m_lMode != MIDIIO_MODEIN) {
+		return NULL;
+	}
+	pMIDIRecorder = (MIDIRecorder*)calloc (1, sizeof (MIDIRecorder));
+	if (pMIDIRecorder == NULL) {
+		_RPTF0 (_CRT_WARN, "エラー：MIDIRecorder_Create内でcallocがNULLを返しました。\r\n");
+		return NULL;
+	}
+	pMIDIRecorder->m_pMsgRecord =
+		(MIDIMsgRecord*)calloc (MIDIRECORDER_MSGNUM, sizeof (MIDIMsgRecord));
+	pMIDIRecorder->m_pSysxBuf = (unsigned char*)malloc (MIDIRECORDER_SYSXBUFSIZE);
+	if (pMIDIRecorder->m_pMsgRecord == NULL || pMIDIRecorder->m_pSysxBuf == NULL) {
+		MIDIRecorder_Delete (pMIDIRecorder);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIRecorder_Create内でメモリ確保に失敗しました。\r\n");
+		return NULL;
+	}
+	pMIDIRecorder->m_pMIDIIn = pMIDIIn;
+	pMIDIRecorder->m_pMIDIClock = pMIDIClock;
+	pMIDIRecorder->m_pMIDITrack = pMIDITrack;
+	return pMIDIRecorder;
+}
+
+/* 記録を開始する(記録スレッドを起動する) */
+long __stdcall MIDIRecorder_Start (MIDIRecorder* pMIDIRecorder) {
+	MIDIEvent* pEvent;
+	_ASSERT (pMIDIRecorder);
+	if (pMIDIRecorder == NULL) {
+		return 0;
+	}
+	/* 既に記録中 */
+	if (pMIDIRecorder->m_hThread) {
+		return 1;
+	}
+	/* 停止中にトラックが編集されている可能性があるため、表を作り直す */
+	/* (この走査は開始時に1回だけ行う) */
+	memset (pMIDIRecorder->m_pLastSameKindEvent, 0, sizeof (pMIDIRecorder->m_pLastSameKindEvent));
+	memset (pMIDIRecorder->m_pNoteOnEvent, 0, sizeof (pMIDIRecorder->m_pNoteOnEvent));
+	pMIDIRecorder->m_pPublishedEvent = NULL;
+	pEvent = pMIDIRecorder->m_pMIDITrack->m_pFirstEvent;
+	while (pEvent) {
+		if (!MIDIEvent_IsEndofTrack (pEvent)) {
+			pMIDIRecorder->m_pLastSameKindEvent[pEvent->m_lKind & 0xFF] = pEvent;
+			pMIDIRecorder->m_pPublishedEvent = pEvent;
+		}
+		pEvent = pEvent->m_pNextEvent;
+	}
+	pMIDIRecorder->m_byRunningStatus = 0;
+	pMIDIRecorder->m_bExit = 0;
+	pMIDIRecorder->m_hThread = CreateThread (NULL, 0, MIDIRecorder_ThreadProc, pMIDIRecorder, 0, NULL);
+	if (pMIDIRecorder->m_hThread == NULL) {
+		_RPTF0 (_CRT_WARN, "エラー：MIDIRecorder_Start内でCreateThreadがNULLを返しました。\r\n");
+		return 0;
+	}
+	SetThreadPriority ((HANDLE)(pMIDIRecorder->m_hThread), THREAD_PRIORITY_ABOVE_NORMAL);
+	return 1;
+}
+
+/* 記録を停止する(記録スレッドの終了を待つ) */
+long __stdcall MIDIRecorder_Stop (MIDIRecorder* pMIDIRecorder) {
+	_ASSERT (pMIDIRecorder);
+	if (pMIDIRecorder == NULL) {
+		return 0;
+	}
+	if (pMIDIRecorder->m_hThread == NULL) {
+		return 1;
+	}
+	MemoryBarrier ();
+	pMIDIRecorder->m_bExit = 1;
+	/* 受信待ちの記録スレッドを起こす */
+	SetEvent ((HANDLE)MIDIIn_GetWaitHandle (pMIDIRecorder->m_pMIDIIn));
+	WaitForSingleObject ((HANDLE)(pMIDIRecorder->m_hThread), INFINITE);
+	CloseHandle ((HANDLE)(pMIDIRecorder->m_hThread));
+	pMIDIRecorder->m_hThread = NULL;
+	return 1;
+}
+
+/* 記録中か調べる */
+long __stdcall MIDIRecorder_IsRecording (MIDIRecorder* pMIDIRecorder) {
+	_ASSERT (pMIDIRecorder);
+	if (pMIDIRecorder == NULL) {
+		return 0;
+	}
+	return pMIDIRecorder->m_hThread ? 1 : 0;
+}
+
+/* 公開済みの最後のイベントを取得する(まだ記録していない場合NULL) */
+/* トラックの先頭からこのイベントまでは、記録中でもロックせずに辿ってよい */
+MIDIEvent* __stdcall MIDIRecorder_GetLastEvent (MIDIRecorder* pMIDIRecorder) {
+	MIDIEvent* pEvent;
+	_ASSERT (pMIDIRecorder);
+	if (pMIDIRecorder == NULL) {
+		return NULL;
+	}
+	pEvent = pMIDIRecorder->m_pPublishedEvent;
+	MemoryBarrier ();
+	return pEvent;
+}
+
+/* 記録したイベントの数を取得する */
+long __stdcall MIDIRecorder_GetRecordedNum (MIDIRecorder* pMIDIRecorder) {
+	_ASSERT (pMIDIRecorder);
+	if (pMIDIRecorder == NULL) {
+		return 0;
+	}
+	return pMIDIRecorder->m_lRecordedNum;
+}
+
+/* トラックに追加できずに捨てたMIDIメッセージの数を取得する */
+long __stdcall MIDIRecorder_GetDroppedNum (MIDIRecorder* pMIDIRecorder) {
+	_ASSERT (pMIDIRecorder);
+	if (pMIDIRecorder == NULL) {
+		return 0;
+	}
+	return pMIDIRecorder->m_lDroppedNum;
+}
@@ -0,0 +1,99 @@
+/******************************************************************************/
+/*                                                                            */
+/*  MIDIRecorder.h - MIDIRecorderヘッダーファイル          (C)2026 くず       */
+/*                                                                            */
+/******************************************************************************/
+
+/* このモジュールは普通のＣ言語で書かれている。 */
+/* このライブラリは、GNU 劣等一般公衆利用許諾契約書(LGPL)に基づき配布される。 */
+/* プロジェクトホームページ(仮)："http://openmidiproject.sourceforge.jp/index.html" */
+/* MIDI入力オブジェクトから受信したMIDIメッセージを、MIDIクロックで */
+/* ティックに換算しながらMIDIトラックへ直接記録する(20261019追加) */
+
+/* This library is free software; you can redistribute it and/or */
+/* modify it under the terms of the GNU Lesser General Public */
+/* License as published by the Free Software Foundation; either */
+/* version 2.1 of the License, or (at your option) any later version. */
+
+/* This library is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU */
+/* Lesser General Public License for more details. */
+
+/* You should have received a copy of the GNU Lesser General Public */
+/* License along with this library; if not, write to the Free Software */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+#if !defined _MIDIRECORDER_H_
+#define _MIDIRECORDER_H_
+
+#include "MIDIIO.h"
+#include "MIDIClock.h"
+#include "MIDIData.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MIDIRECORDER_MSGNUM 256 /* 記録スレッドが一度に取り出すMIDIメッセージの最大数 */
+#define MIDIRECORDER_SYSXBUFSIZE MIDIIO_BUFSIZE /* 記録スレッドのSYSX取り出し用バッファの大きさ */
+
+/* 記録は専用の記録スレッドが行う。記録スレッドはMIDIIn_Waitで受信を待ち、 */
+/* MIDIIn_GetMIDIMessagesでまとめて取り出したMIDIメッセージを、受信時刻から */
+/* MIDIClock_GetTickCountAtで求めたティックでMIDITrack_AppendSingleEventForceにより */
+/* トラックの最後に追加する。同種イベントとノートオンの探索は表引きで行うため、 */
+/* 1イベントあたりの記録は定数時間で完了する。 */
+/* 記録中のトラックを他のスレッドから参照する場合は、ロックせずに、トラックの先頭から */
+/* MIDIRecorder_GetLastEventが返すイベントまでをm_pNextEventで辿ること。 */
+/* (それより後ろのイベントとトラックのイベント数・EOTは記録スレッドが更新中である。 */
+/* また、記録済みのノートオンのm_pNextCombinedEventは、ノートオフの受信時に設定される。 */
+/* ノートオフより先に同じキーのノートオンを再び受信した場合は、その時刻のノートオフを補って結合する) */
+
+/* MIDIRecorder構造体 */
+typedef struct tagMIDIRecorder {
+	MIDIIn* m_pMIDIIn;       /* 入力元のMIDI入力オブジェクト */
+	MIDIClock* m_pMIDIClock; /* ティック換算に用いるMIDIクロック */
+	MIDITrack* m_pMIDITrack; /* 記録先のMIDIトラック */
+	MIDIEvent* m_pLastSameKindEvent[256]; /* 種類ごとのトラック内の最後のイベント */
+	MIDIEvent* m_pNoteOnEvent[16][128];   /* チャンネル・キーごとの未結合のノートオン */
+	MIDIMsgRecord* m_pMsgRecord;  /* 取り出し用バッファ(MIDIRECORDER_MSGNUM個) */
+	unsigned char* m_pSysxBuf;    /* SYSX取り出し用バッファ(MIDIRECORDER_SYSXBUFSIZE) */
+	unsigned char m_byRunningStatus; /* 記録スレッドのランニングステータス */
+	MIDIEvent* volatile m_pPublishedEvent; /* 公開済みの最後のイベント */
+	volatile long m_lRecordedNum; /* 記録したイベントの数 */
+	volatile long m_lDroppedNum;  /* トラックに追加できずに捨てたMIDIメッセージの数 */
+	volatile long m_bExit;   /* 記録スレッドの終了要求 */
+	void* m_hThread;         /* 記録スレッド(停止中はNULL) */
+} MIDIRecorder;
+
+/* MIDIレコーダーオブジェクトの削除(記録中の場合は停止する) */
+void __stdcall MIDIRecorder_Delete (MIDIRecorder* pMIDIRecorder);
+
+/* MIDIレコーダーオブジェクトの生成 */
+/* 各オブジェクトはMIDIレコーダーオブジェクトより後に削除すること */
+MIDIRecorder* __stdcall MIDIRecorder_Create
+	(MIDIIn* pMIDIIn, MIDIClock* pMIDIClock, MIDITrack* pMIDITrack);
+
+/* 記録を開始する(記録スレッドを起動する) */
+long __stdcall MIDIRecorder_Start (MIDIRecorder* pMIDIRecorder);
+
+/* 記録を停止する(記録スレッドの終了を待つ) */
+long __stdcall MIDIRecorder_Stop (MIDIRecorder* pMIDIRecorder);
+
+/* 記録中か調べる */
+long __stdcall MIDIRecorder_IsRecording (MIDIRecorder* pMIDIRecorder);
+
+/* 公開済みの最後のイベントを取得する(まだ記録していない場合NULL) */
+MIDIEvent* __stdcall MIDIRecorder_GetLastEvent (MIDIRecorder* pMIDIRecorder);
+
+/* 記録したイベントの数を取得する */
+long __stdcall MIDIRecorder_GetRecordedNum (MIDIRecorder* pMIDIRecorder);
+
+/* トラックに追加できずに捨てたMIDIメッセージの数を取得する */
+long __stdcall MIDIRecorder_GetDroppedNum (MIDIRecorder* pMIDIRecorder);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -648,4 +648,51 @@ Declare Function MIDIStatus_Load Lib "MIDIStatus.dll" Alias "MIDIStatus_LoadA" _
 
 
 
+'******************************************************************************
+'*                                                                            *
+'* MIDIStatusSet֐Q                                                        *
+'*                                                                            *
+'******************************************************************************
+
+' MIDIStatusSetIuWFNg폜B
+Declare Sub MIDIStatusSet_Delete Lib "MIDIStatus.dll" _
+    (ByVal pMIDIStatusSet As Long)
+
+' MIDIStatusSetIuWFNg𐶐B
+Declare Function MIDIStatusSet_Create Lib "MIDIStatus.dll" _
+    (ByVal lModuleMode As Long, ByVal lNumMIDIPart As Long, ByVal lNumMIDIDrumSetup As Long) As Long
+
+' w|[gMIDIStatusւ̃|C^擾(gp̃|[g0)
+Declare Function MIDIStatusSet_GetMIDIStatus Lib "MIDIStatus.dll" _
+    (ByVal pMIDIStatusSet As Long, ByVal lPort As Long) As Long
+
+' w|[gMIDIStatusւ̃|C^擾(gp̃|[g͐)
+Declare Function MIDIStatusSet_GetMIDIStatusForce Lib "MIDIStatus.dll" _
+    (ByVal pMIDIStatusSet As Long, ByVal lPort As Long) As Long
+
+' ς݂MIDIStatus̐擾
+Declare Function MIDIStatusSet_GetNumMIDIStatus Lib "MIDIStatus.dll" _
+    (ByVal pMIDIStatusSet As Long) As Long
+
+' W[[hݒ肵Aς݂̑S|[g̃p[^ftHglɖ߂B
+Declare Function MIDIStatusSet_SetModuleMode Lib "MIDIStatus.dll" _
+    (ByVal pMIDIStatusSet As Long, ByVal lModuleMode As Long) As Long
+
+' ς݂̑S|[gZbg
+Declare Function MIDIStatusSet_PutReset Lib "MIDIStatus.dll" _
+    (ByVal pMIDIStatusSet As Long) As Long
+
+' w|[gMIDIbZ[W^邱Ƃɂp[^ύXB
+Declare Function MIDIStatusSet_PutMIDIMessage Lib "MIDIStatus.dll" _
+    (ByVal pMIDIStatusSet As Long, ByVal lPort As Long, ByRef pMIDIMessage As Byte, ByVal lLen As Long) As Long
+
+' MIDIStatusSet̓eʂMIDIStatusSet֕ʂB
+Declare Function MIDIStatusSet_Copy Lib "MIDIStatus.dll" _
+    (ByVal pDstSet As Long, ByVal pSrcSet As Long) As Long
+
+' MIDIStatusSet̕(XibvVbg)𐶐B
+Declare Function MIDIStatusSet_Duplicate Lib "MIDIStatus.dll" _
+    (ByVal pSrcSet As Long) As Long
+
+
 
@@ -23,6 +23,7 @@
 /* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
 
 #include <assert.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -329,6 +330,203 @@ long Sum (unsigned char* pData, long lLen) {
 	return lRet;
 }
 
+/* SysExAhX}bv(OB) */
+
+/* i[̎ */
+#define MIDISTATUS_SYSXFIELD_PARTLONG  1 /* MIDIPartlong^o(m_lIndex̓ItZbg) */
+#define MIDISTATUS_SYSXFIELD_PARTCC    2 /* MIDIPart::m_cControlChange[m_lIndex] */
+#define MIDISTATUS_SYSXFIELD_PARTSCALE 3 /* MIDIPart::m_lScaleOctaveTuning[m_lIndex] */
+
+/* NRPN𓯎ɍXVȂꍇm_cNRPN̒l */
+#define MIDISTATUS_SYSXNONRPN 0xFF
+
+/* AhX}bṽL[([J[IDAfIDAAhXʁAAhX) */
+/* AhXʂ̓p[gԍƂĈ߁AL[ɂ͊܂߂ȂB */
+#define MIDISTATUS_SYSXKEY(MAN,MODEL,ADDRH,ADDRL) \
+	(((unsigned long)(MAN) << 24) | ((unsigned long)(MODEL) << 16) | \
+	((unsigned long)(ADDRH) << 8) | (unsigned long)(ADDRL))
+
+/* AhX}bṽGg */
+typedef struct tagMIDIStatusSysxMap {
+	unsigned long m_ulKey;  /* MIDISTATUS_SYSXKEYōL[(z͂̏ɕׂ邱) */
+	unsigned char m_cMin;   /* f[^̍ŏl */
+	unsigned char m_cMax;   /* f[^̍ől */
+	unsigned char m_cField; /* i[̎(MIDISTATUS_SYSXFIELD_*) */
+	unsigned char m_cNRPN;  /* ɍXVNRPN#(1*128+n)nAMIDISTATUS_SYSXNONRPN */
+	long m_lIndex;          /* i[̃ItZbg͔zCfbNX */
+} MIDIStatusSysxMap;
+
+#define PARTLONG(MEMBER) MIDISTATUS_SYSXFIELD_PARTLONG, MIDISTATUS_SYSXNONRPN, (long)offsetof (MIDIPart, MEMBER)
+#define PARTCC(NUM) MIDISTATUS_SYSXFIELD_PARTCC, MIDISTATUS_SYSXNONRPN, (NUM)
+#define PARTCCNRPN(NUM,NRPN) MIDISTATUS_SYSXFIELD_PARTCC, (NRPN), (NUM)
+#define PARTSCALE(KEY) MIDISTATUS_SYSXFIELD_PARTSCALE, MIDISTATUS_SYSXNONRPN, (KEY)
+
+/* 1oCg̃f[^p[gʃp[^̃AhX}bv */
+/* VW[p[^ɑΉꍇ́AL[̏ۂĂɒǉB */
+static const MIDIStatusSysxMap g_theMIDIStatusSysxMap[] = {
+	/* GS PART PARAMETER {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0xll, 0xvv, 0xcs, 0xF7} */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x02), 0x00, 0x10, PARTLONG (m_lReceiveChannel)},      /* Rx.CHANNEL */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x15), 0x00, 0x0F, PARTLONG (m_lPartMode)},            /* USE FOR RHYTHM PART */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x16), 0x28, 0x58, PARTLONG (m_lChannelCoarseTuning)}, /* PITCH KEY SHIFT */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x19), 0x00, 0x7F, PARTCC (7)},                        /* PART LEVEL (=CC#7) */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x1A), 0x00, 0x7F, PARTLONG (m_lVelocitySenseDepth)},  /* VELOCITY SENSE DEPTH */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x1B), 0x00, 0x7F, PARTLONG (m_lVelocitySenseOffset)}, /* VELOCITY SENSE OFFSET */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x1C), 0x00, 0x7F, PARTCC (10)},                       /* PART PANPOT (=CC#10) */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x1D), 0x00, 0x7F, PARTLONG (m_lKeyboardRangeLow)},    /* KEYBOARD RANGE LOW */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x1E), 0x00, 0x7F, PARTLONG (m_lKeyboardRangeHigh)},   /* KEYBOARD RANGE HIGH */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x21), 0x00, 0x7F, PARTCC (93)},                       /* CHORUS SEND LEVEL (=CC#93) */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x22), 0x00, 0x7F, PARTCC (91)},                       /* REVERB SEND LEVEL (=CC#91) */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x2C), 0x00, 0x7F, PARTCC (94)},                       /* DELAY SEND LEVEL (=CC#94) */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x30), 0x00, 0x7F, PARTCCNRPN (76, 8)},                /* Vibrato Rate (=NRPN#8=CC#76) */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x31), 0x00, 0x7F, PARTCCNRPN (77, 9)},                /* Vibrato Depth (=NRPN#9=CC#77) */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x32), 0x00, 0x7F, PARTCCNRPN (74, 32)},               /* Cutoff Freq (=NRPN#32=CC#74) */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x33), 0x00, 0x7F, PARTCCNRPN (71, 33)},               /* Resonance (=NRPN#33=CC#71) */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x34), 0x00, 0x7F, PARTCCNRPN (73, 99)},               /* Attack Time (=NRPN#99=CC#73) */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x35), 0x00, 0x7F, PARTCCNRPN (75, 100)},              /* Decay Time (=NRPN#100=CC#75) */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x36), 0x00, 0x7F, PARTCCNRPN (72, 102)},              /* Release Time (=NRPN#102=CC#72) */
+	{MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, 0x37), 0x00, 0x7F, PARTCCNRPN (78, 10)},               /* Vibrato Delay (=NRPN#10=CC#78) */
+	/* XG MULTI PART {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0xll, 0xvv, 0xF7} */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x01), 0x00, 0x7F, PARTCC (0)},                        /* BANK SELECT MSB (=CC#0) */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x02), 0x00, 0x7F, PARTCC (32)},                       /* BANK SELECT LSB (=CC#32) */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x03), 0x00, 0x7F, PARTLONG (m_lProgramChange)},       /* PROGRAM NUMBER (=PC) */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x04), 0x00, 0x10, PARTLONG (m_lReceiveChannel)},      /* Rcv CHANNEL */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x07), 0x00, 0x10, PARTLONG (m_lPartMode)},            /* PART MODE */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x08), 0x28, 0x58, PARTLONG (m_lChannelCoarseTuning)}, /* NOTE SHIFT */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x0B), 0x00, 0x7F, PARTCC (7)},                        /* VOLUME (=CC#7) */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x0C), 0x00, 0x7F, PARTLONG (m_lVelocitySenseDepth)},  /* VELOCITY SENSE DEPTH */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x0D), 0x00, 0x7F, PARTLONG (m_lVelocitySenseOffset)}, /* VELOCITY SENSE OFFSET */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x0E), 0x00, 0x7F, PARTCC (10)},                       /* PAN (=CC#10) */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x0F), 0x00, 0x7F, PARTLONG (m_lKeyboardRangeLow)},    /* NOTE LIMIT LOW */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x10), 0x00, 0x7F, PARTLONG (m_lKeyboardRangeHigh)},   /* NOTE LIMIT HIGH */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x12), 0x00, 0x7F, PARTCC (93)},                       /* CHORUS SEND (=CC#93) */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x13), 0x00, 0x7F, PARTCC (91)},                       /* REVERB SEND (=CC#91) */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x14), 0x00, 0x7F, PARTCC (94)},                       /* VARIATION SEND (=CC#94) */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x15), 0x00, 0x7F, PARTCCNRPN (76, 8)},                /* VIBRATO RATE (=NRPN#8=CC#76) */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x16), 0x00, 0x7F, PARTCCNRPN (77, 9)},                /* VIBRATO DEPTH (=NRPN#9=CC#77) */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x17), 0x00, 0x7F, PARTCCNRPN (78, 10)},               /* VIBRATO DELAY (=NRPN#10=CC#78) */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x18), 0x00, 0x7F, PARTCCNRPN (74, 32)},               /* FILTER CUTOFF FREQ (=NRPN#32=CC#74) */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x19), 0x00, 0x7F, PARTCCNRPN (71, 33)},               /* FILTER RESONANCE (=NRPN#33=CC#71) */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x1A), 0x00, 0x7F, PARTCCNRPN (73, 99)},               /* EG ATTACK TIME (=NRPN#99=CC#73) */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x1B), 0x00, 0x7F, PARTCCNRPN (75, 100)},              /* EG DECAY TIME (=NRPN#100=CC#75) */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x1C), 0x00, 0x7F, PARTCCNRPN (72, 102)},              /* EG RELEASE TIME (=NRPN#102=CC#72) */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x41), 0x00, 0x7F, PARTSCALE (0)},                     /* SCALE TUNING C */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x42), 0x00, 0x7F, PARTSCALE (1)},                     /* SCALE TUNING C# */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x43), 0x00, 0x7F, PARTSCALE (2)},                     /* SCALE TUNING D */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x44), 0x00, 0x7F, PARTSCALE (3)},                     /* SCALE TUNING D# */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x45), 0x00, 0x7F, PARTSCALE (4)},                     /* SCALE TUNING E */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x46), 0x00, 0x7F, PARTSCALE (5)},                     /* SCALE TUNING F */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x47), 0x00, 0x7F, PARTSCALE (6)},                     /* SCALE TUNING F# */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x48), 0x00, 0x7F, PARTSCALE (7)},                     /* SCALE TUNING G */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x49), 0x00, 0x7F, PARTSCALE (8)},                     /* SCALE TUNING G# */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x4A), 0x00, 0x7F, PARTSCALE (9)},                     /* SCALE TUNING A */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x4B), 0x00, 0x7F, PARTSCALE (10)},                    /* SCALE TUNING A# */
+	{MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, 0x4C), 0x00, 0x7F, PARTSCALE (11)}                     /* SCALE TUNING B */
+};
+
+#undef PARTLONG
+#undef PARTCC
+#undef PARTCCNRPN
+#undef PARTSCALE
+
+/* AhX}bvL[ɈvGg񕪒T(ȂNULL) */
+static const MIDIStatusSysxMap* MIDIStatus_FindSysxMap (unsigned long ulKey) {
+	long lLow = 0;
+	long lHigh = sizeof (g_theMIDIStatusSysxMap) / sizeof (g_theMIDIStatusSysxMap[0]) - 1;
+	while (lLow <= lHigh) {
+		long lMid = (lLow + lHigh) / 2;
+		unsigned long ulMidKey = g_theMIDIStatusSysxMap[lMid].m_ulKey;
+		if (ulMidKey == ulKey) {
+			return &g_theMIDIStatusSysxMap[lMid];
+		}
+		else if (ulMidKey < ulKey) {
+			lLow = lMid + 1;
+		}
+		else {
+			lHigh = lMid - 1;
+		}
+	}
+	return NULL;
+}
+
+/* AhX}bvɓo^ꂽp[gʃp[^SysEx(OB) */
+/* ꍇ̓bZ[W̒A}bvɊYȂꍇ0ԂB */
+static long MIDIStatus_PutSysxByMap (MIDIStatus* pMIDIStatus, unsigned char* pMIDIMessage, long lLen) {
+	const MIDIStatusSysxMap* pMap = NULL;
+	MIDIPart* pMIDIPart = NULL;
+	unsigned char cVal = 0;
+	long lPart = -1;
+	long lRet = 0;
+	assert (pMIDIStatus);
+	assert (pMIDIMessage);
+	/* GS PART PARAMETER {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0xll, 0xvv, 0xcs, 0xF7} */
+	if (lLen >= 11 &&
+		*(pMIDIMessage + 1) == 0x41 &&
+		*(pMIDIMessage + 3) == 0x42 &&
+		*(pMIDIMessage + 4) == 0x12 &&
+		*(pMIDIMessage + 5) == 0x40 &&
+		(*(pMIDIMessage + 6) & 0xF0) == 0x10) {
+		pMap = MIDIStatus_FindSysxMap (MIDISTATUS_SYSXKEY (0x41, 0x42, 0x40, *(pMIDIMessage + 7)));
+		if (pMap == NULL ||
+			*(pMIDIMessage + 9) != 128 - (Sum (pMIDIMessage + 5, 4) % 128) ||
+			*(pMIDIMessage + 10) != 0xF7) {
+			return 0;
+		}
+		/* 0x10=PART10A0x11`0x19=PART01`PART09A0x1A`0x1F=PART11`PART16 */
+		if (*(pMIDIMessage + 6) == 0x10) {
+			lPart = 9;
+		}
+		else if (*(pMIDIMessage + 6) <= 0x19) {
+			lPart = *(pMIDIMessage + 6) - 0x11;
+		}
+		else {
+			lPart = *(pMIDIMessage + 6) - 0x10;
+		}
+		cVal = *(pMIDIMessage + 8);
+		lRet = 11;
+	}
+	/* XG MULTI PART {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0xll, 0xvv, 0xF7} */
+	else if (lLen >= 9 &&
+		*(pMIDIMessage + 1) == 0x43 &&
+		(*(pMIDIMessage + 2) & 0xF0) == 0x10 &&
+		*(pMIDIMessage + 3) == 0x4C &&
+		*(pMIDIMessage + 4) == 0x08) {
+		pMap = MIDIStatus_FindSysxMap (MIDISTATUS_SYSXKEY (0x43, 0x4C, 0x08, *(pMIDIMessage + 6)));
+		if (pMap == NULL || *(pMIDIMessage + 8) != 0xF7) {
+			return 0;
+		}
+		lPart = *(pMIDIMessage + 5) & 0x0F;
+		cVal = *(pMIDIMessage + 7);
+		lRet = 9;
+	}
+	else {
+		return 0;
+	}
+	if (lPart < 0 || lPart >= pMIDIStatus->m_lNumMIDIPart) {
+		return 0;
+	}
+	if (cVal < pMap->m_cMin || cVal > pMap->m_cMax) {
+		return 0;
+	}
+	pMIDIPart = MIDIStatus_GetMIDIPart (pMIDIStatus, lPart);
+	switch (pMap->m_cField) {
+	case MIDISTATUS_SYSXFIELD_PARTLONG:
+		*((long*)((unsigned char*)pMIDIPart + pMap->m_lIndex)) = cVal;
+		break;
+	case MIDISTATUS_SYSXFIELD_PARTCC:
+		pMIDIPart->m_cControlChange[pMap->m_lIndex] = cVal;
+		break;
+	case MIDISTATUS_SYSXFIELD_PARTSCALE:
+		pMIDIPart->m_lScaleOctaveTuning[pMap->m_lIndex] = cVal;
+		break;
+	}
+#ifdef MIDISTATUS_REMAINNRPN
+	if (pMap->m_cNRPN != MIDISTATUS_SYSXNONRPN) {
+		pMIDIPart->m_cNRPNMSB[1][pMap->m_cNRPN] = cVal;
+	}
+#endif
+	return lRet;
+}
+
 /******************************************************************************/
 /*                                                                            */
 /* MIDIPart֐Q                                                             */
@@ -2845,6 +3043,11 @@ long __stdcall MIDIStatus_PutMIDIMessage (MIDIStatus* pMIDIStatus, unsigned char
 
 	/* VXeGNXN[VbZ[W */
 	else if (cStatus == 0xF0 && lLen >= 2) {
+		/* AhX}bvɓo^ꂽp[gʃp[^̓}bv璼ڏ */
+		long lRet = MIDIStatus_PutSysxByMap (pMIDIStatus, pMIDIMessage, lLen);
+		if (lRet > 0) {
+			return lRet;
+		}
 		/* jo[TmA^CVXeGNXN[VubZ[W {0xF0, 0x7E, 0xid, ... , 0xF7} */
 		if (*(pMIDIMessage + 1) == 0x7E && lLen >= 4) {
 			unsigned char uID = *(pMIDIMessage + 2);
@@ -3345,101 +3548,13 @@ long __stdcall MIDIStatus_PutMIDIMessage (MIDIStatus* pMIDIStatus, unsigned char
 							else {
 								i = *(pMIDIMessage + 6) - 0x10;
 							}
-							if (0 < i && i < pMIDIStatus->m_lNumMIDIPart) {
+							if (0 <= i && i < pMIDIStatus->m_lNumMIDIPart) {
 								pMIDIPart = MIDIStatus_GetMIDIPart (pMIDIStatus, i);
 							}
 							else {
 								break;
 							}
 							switch (*(pMIDIMessage + 7)) { /* AhXoCg */
-							case 0x02: /* Rx.CHANNEL {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x02, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x10 &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_lReceiveChannel = *(pMIDIMessage + 8);
-									return 11;
-								}
-								break;
-							case 0x15: /* USE FOR RHYTHM PART {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x15, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x0F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_lPartMode = *(pMIDIMessage + 8);
-									return 11;
-								}
-								break;		
-							case 0x16: /* PITCH KEY SHIFT {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x16, 0xvv, 0xcs, 0xF7} */
-								if (0x28 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x58 &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_lChannelCoarseTuning = *(pMIDIMessage + 8);
-									return 11;
-								}
-								break;
-							case 0x19: /* PART LEVEL (=CC#7) {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x19, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_cControlChange[7] = *(pMIDIMessage + 8);
-									return 11;
-								}
-								break;
-							case 0x1A: /* VELOCITY SENSE DEPTH {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x1A, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_lVelocitySenseDepth = *(pMIDIMessage + 8);
-									return 11;
-								}
-								break;
-							case 0x1B: /* VELOCITY SENSE OFFSET {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x1B, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_lVelocitySenseOffset = *(pMIDIMessage + 8);
-									return 11;
-								}
-								break;
-							case 0x1C: /* PART PANPOT (CC=#10) {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x1C, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_cControlChange[10] = *(pMIDIMessage + 8);
-									return 11;
-								}
-								break;
-							case 0x1D: /* KEYBOARD RANGE LOW {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x1D, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_lKeyboardRangeLow = *(pMIDIMessage + 8);
-									return 11;
-								}
-								break;
-							case 0x1E: /* KEYBOARD RANGE HIGH {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x1E, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_lKeyboardRangeHigh = *(pMIDIMessage + 8);
-									return 11;
-								}
-								break;
-							case 0x21: /* CHORUS SEND LEVEL (=CC#93) {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x21, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_cControlChange[93] = *(pMIDIMessage + 8);
-									return 11;
-								}
-								break;
-							case 0x22: /* REVERB SEND LEVEL (=CC#91) {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x22, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_cControlChange[91] = *(pMIDIMessage + 8);
-									return 11;
-								}
-								break;
 							case 0x2A: /* PITCH FINE TUNE {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x2A, 0xvv, 0xww, 0xcs, 0xF7} */
 								if (lLen >= 12) {
 									if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
@@ -3456,102 +3571,6 @@ long __stdcall MIDIStatus_PutMIDIMessage (MIDIStatus* pMIDIStatus, unsigned char
 									}
 								}
 								break;
-							case 0x2C: /* DELAY SEND LEVEL (=CC#94) {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x2C, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_cControlChange[94] = *(pMIDIMessage + 8);
-									return 11;
-								}
-								break;
-							case 0x30: /* Vibrato Rate (=NRPN#8=CC#76) {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x30, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_cControlChange[76] = *(pMIDIMessage + 8);
-#ifdef MIDISTATUS_REMAINNRPN
-									pMIDIPart->m_cNRPNMSB[1][8] = *(pMIDIMessage + 8);
-#endif
-									return 11;
-								}
-								break;
-							case 0x31: /* Vibrato Depth (=NRPN#9=CC#77) {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x31, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_cControlChange[77] = *(pMIDIMessage + 8);
-#ifdef MIDISTATUS_REMAINNRPN
-									pMIDIPart->m_cNRPNMSB[1][9] = *(pMIDIMessage + 8);
-#endif
-									return 11;
-								}
-								break;
-							case 0x32: /* Cutoff Freq (=NRPN#32=CC#74) {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x32, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_cControlChange[74] = *(pMIDIMessage + 8);
-#ifdef MIDISTATUS_REMAINNRPN
-									pMIDIPart->m_cNRPNMSB[1][32] = *(pMIDIMessage + 8);
-#endif
-									return 11;
-								}
-								break;
-							case 0x33: /* Resonance (=NRPN#33=CC#71) {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x33, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_cControlChange[71] = *(pMIDIMessage + 8);
-#ifdef MIDISTATUS_REMAINNRPN
-									pMIDIPart->m_cNRPNMSB[1][33] = *(pMIDIMessage + 8);
-#endif
-									return 11;
-								}
-								break;
-							case 0x34: /* Attack Time (=NRPN#99=CC#73) {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x34, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_cControlChange[73] = *(pMIDIMessage + 8);
-#ifdef MIDISTATUS_REMAINNRPN
-									pMIDIPart->m_cNRPNMSB[1][99] = *(pMIDIMessage + 8);
-#endif
-									return 11;
-								}
-								break;
-							case 0x35: /* Decay Time (=NRPN#100=CC#75) {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x35, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_cControlChange[75] = *(pMIDIMessage + 8);
-#ifdef MIDISTATUS_REMAINNRPN
-									pMIDIPart->m_cNRPNMSB[1][100] = *(pMIDIMessage + 8);
-#endif
-									return 11;
-								}
-								break;
-							case 0x36: /* Release Time (=NRPN#102=CC#72) {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x36, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_cControlChange[72] = *(pMIDIMessage + 8);
-#ifdef MIDISTATUS_REMAINNRPN
-									pMIDIPart->m_cNRPNMSB[1][102] = *(pMIDIMessage + 8);
-#endif
-									return 11;
-								}
-								break;
-							case 0x37: /* Vibrato Delay (=NRPN#10=CC#78) {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x37, 0xvv, 0xcs, 0xF7} */
-								if (0x00 <= *(pMIDIMessage + 8) && *(pMIDIMessage + 8) <= 0x7F &&
-									*(pMIDIMessage + 9) == 128 - (Sum (pMIDIMessage + 5, 4) % 128) &&
-									*(pMIDIMessage + 10) == 0xF7) {
-									pMIDIPart->m_cControlChange[78] = *(pMIDIMessage + 8);
-#ifdef MIDISTATUS_REMAINNRPN
-									pMIDIPart->m_cNRPNMSB[1][10] = *(pMIDIMessage + 8);
-#endif
-									return 11;
-								}
-								break;
 							case 0x40: /* Scale Tuning {0xF0, 0x41, 0xid, 0x42, 0x12, 0x40, 0x1X, 0x40, ...(12byte)... , 0xcs, 0xF7} */
 								if (lLen >= 22) {
 									for (j = 8; j <= 19; j++) {
@@ -3587,7 +3606,6 @@ long __stdcall MIDIStatus_PutMIDIMessage (MIDIStatus* pMIDIStatus, unsigned char
 				}
 				/* XGVXeGNXN[VubZ[W */
 				else if (*(pMIDIMessage + 3) == 0x4C && lLen >= 7) {
-					MIDIPart* pMIDIPart = NULL;
 					switch (*(pMIDIMessage + 4)) { /* AhXoCg */
 					case 0x00: /* XG SYSTEM {0xF0, 0x43, 0x1d, 0x4C, 0x00, ... , 0xF7} */
 						switch (*(pMIDIMessage + 5)) { /* AhXoCg */
@@ -3892,269 +3910,6 @@ long __stdcall MIDIStatus_PutMIDIMessage (MIDIStatus* pMIDIStatus, unsigned char
 							break;
 						}
 						break;
-					case 0x08: /* XG MULTI PART {0xF0, 0x43, 0x1d, 0x4C, 0x08, ... , 0xF7} */
-						i = *(pMIDIMessage + 5) & 0x0F; /* AhXoCg */
-						if (0 <= i && i < pMIDIStatus->m_lNumMIDIPart) {
-							pMIDIPart = MIDIStatus_GetMIDIPart (pMIDIStatus, i);
-						}
-						else {
-							break;
-						}
-						switch (*(pMIDIMessage + 6)) { /* AhXoCg */
-						case 0x01: /* BANK SELECT MSB (=CC#0) {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x01, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_cControlChange[0] = *(pMIDIMessage + 7);
-									return 9;
-								}
-							}
-							break;
-						case 0x02: /* BANK SELECT LSB (=CC#32) {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x02, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_cControlChange[32] = *(pMIDIMessage + 7);
-									return 9;
-								}
-							}
-							break;
-						case 0x03: /* PROGRAM NUMBER (=PC) {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x03, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_lProgramChange = *(pMIDIMessage + 7);
-									return 9;
-								}
-							}
-							break;
-						case 0x04: /* Rcv CHANNEL {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x04, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x10 &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_lReceiveChannel = *(pMIDIMessage + 7);
-									return 9;
-								}
-							}
-							break;
-						case 0x07: /* PART MODE {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x07, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x10 &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_lPartMode = *(pMIDIMessage + 7);
-									return 9;
-								}
-							}
-							break;
-						case 0x08: /* NOTE SHIFT {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x08, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x28 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x58 &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_lChannelCoarseTuning = *(pMIDIMessage + 7);
-									return 9;
-								}
-							}
-							break;
-						case 0x0B: /* VOLUME (CC#7) {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x0B, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_cControlChange[7] = *(pMIDIMessage + 7);
-									return 9;
-								}
-							}
-							break;
-						case 0x0C: /* VELOCITY SENSE DEPTH {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x0C, 0xvv, 0xF0} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_lVelocitySenseDepth = *(pMIDIMessage + 7);
-									return 9;
-								}
-							}
-							break;
-						case 0x0D: /* VELOCITY SENSE OFFSET {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x0D, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_lVelocitySenseOffset = *(pMIDIMessage + 7);
-									return 9;
-								}
-							}
-							break;
-						case 0x0E: /* PAN (=CC#10) {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x0E, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_cControlChange[10] = *(pMIDIMessage + 7);
-									return 9;
-								}
-							}
-							break;
-						case 0x0F: /* NOTE LIMIT LOW {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x0F, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_lKeyboardRangeLow = *(pMIDIMessage + 7);
-									return 9;
-								}
-							}
-							break;
-						case 0x10: /* NOTE LIMIT HIGH {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x10, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_lKeyboardRangeHigh = *(pMIDIMessage + 7);
-									return 9;
-								}
-							}
-							break;
-						case 0x12: /* CHORUS SEND (=CC#93) {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x12, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_cControlChange[93] = *(pMIDIMessage + 7);
-									return 9;
-								}
-							}
-							break;
-						case 0x13: /* REVERB SEND (=CC#91) {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x13, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_cControlChange[91] = *(pMIDIMessage + 7);
-									return 9;
-								}
-							}
-							break;
-						case 0x14: /* VARIATION SEND (=CC#94) {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x14, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_cControlChange[94] = *(pMIDIMessage + 7);
-									return 9;
-								}
-							}
-							break;
-						case 0x15: /* VIBRATO RATE (=NRPN#8=CC#76) {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x15, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_cControlChange[76] = *(pMIDIMessage + 7);
-#ifdef MIDISTATUS_REMAINNRPN
-									pMIDIPart->m_cNRPNMSB[1][8] = *(pMIDIMessage + 7);
-#endif
-									return 9;
-								}
-							}
-							break;
-						case 0x16: /* VIBRATO DEPTH (=NRPN#9=CC#77) {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x16, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_cControlChange[77] = *(pMIDIMessage + 7);
-#ifdef MIDISTATUS_REMAINNRPN
-									pMIDIPart->m_cNRPNMSB[1][9] = *(pMIDIMessage + 7);
-#endif
-									return 9;
-								}
-							}
-							break;
-						case 0x17: /* VIBRATO DELAY (=NRPN#10=CC#78) {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x17, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_cControlChange[78] = *(pMIDIMessage + 7);
-#ifdef MIDISTATUS_REMAINNRPN
-									pMIDIPart->m_cNRPNMSB[1][10] = *(pMIDIMessage + 7);
-#endif
-									return 9;
-								}
-							}
-							break;
-						case 0x18: /* FILTER CUTOFF FREQ (=NRPN#32=CC#74) {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x18, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_cControlChange[74] = *(pMIDIMessage + 7);
-#ifdef MIDISTATUS_REMAINNRPN
-									pMIDIPart->m_cNRPNMSB[1][32] = *(pMIDIMessage + 7);
-#endif
-									return 9;
-								}
-							}
-							break;
-						case 0x19: /* FILTER RESONANCE (=NRPN#33=CC#71) {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x19, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_cControlChange[71] = *(pMIDIMessage + 7);
-#ifdef MIDISTATUS_REMAINNRPN
-									pMIDIPart->m_cNRPNMSB[1][33] = *(pMIDIMessage + 7);
-#endif
-									return 9;
-								}
-							}
-							break;
-						case 0x1A: /* EG ATTACK TIME (=NRPN#99=CC#73) {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x1A, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_cControlChange[73] = *(pMIDIMessage + 7);
-#ifdef MIDISTATUS_REMAINNRPN
-									pMIDIPart->m_cNRPNMSB[1][99] = *(pMIDIMessage + 7);
-#endif
-									return 9;
-								}
-							}
-							break;
-						case 0x1B: /* EG DECAY TIME (=NRPN#100=CC#75) {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x1B, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_cControlChange[75] = *(pMIDIMessage + 7);
-#ifdef MIDISTATUS_REMAINNRPN
-									pMIDIPart->m_cNRPNMSB[1][100] = *(pMIDIMessage + 7);
-#endif
-									return 9;
-								}
-							}
-							break;
-						case 0x1C: /* EG RELEASE TIME (=NRPN#102=CC#72) {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x1C, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_cControlChange[72] = *(pMIDIMessage + 7);
-#ifdef MIDISTATUS_REMAINNRPN
-									pMIDIPart->m_cNRPNMSB[1][102] = *(pMIDIMessage + 7);
-#endif
-									return 9;
-								}
-							}
-							break;
-						case 0x41: /* SCALE TUNING C  {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x41, 0xvv, 0xF7} */
-						case 0x42: /* SCALE TUNING C# {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x42, 0xvv, 0xF7} */
-						case 0x43: /* SCALE TUNING D  {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x43, 0xvv, 0xF7} */
-						case 0x44: /* SCALE TUNING D# {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x44, 0xvv, 0xF7} */
-						case 0x45: /* SCALE TUNING E  {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x45, 0xvv, 0xF7} */
-						case 0x46: /* SCALE TUNING F  {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x46, 0xvv, 0xF7} */
-						case 0x47: /* SCALE TUNING F# {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x47, 0xvv, 0xF7} */
-						case 0x48: /* SCALE TUNING G  {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x48, 0xvv, 0xF7} */
-						case 0x49: /* SCALE TUNING G# {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x49, 0xvv, 0xF7} */
-						case 0x4A: /* SCALE TUNING A  {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x4A, 0xvv, 0xF7} */
-						case 0x4B: /* SCALE TUNING A# {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x4B, 0xvv, 0xF7} */
-						case 0x4C: /* SCALE TUNING B  {0xF0, 0x43, 0x1d, 0x4C, 0x08, 0xnn, 0x4C, 0xvv, 0xF7} */
-							if (lLen >= 9) {
-								unsigned char cKey = *(pMIDIMessage + 6) - 0x41;
-								if (0x00 <= *(pMIDIMessage + 7) && *(pMIDIMessage + 7) <= 0x7F &&
-									*(pMIDIMessage + 8) == 0xF7) {
-									pMIDIPart->m_lScaleOctaveTuning[cKey] = *(pMIDIMessage + 7);
-									return 9;
-								}
-							}
-							break;
-						}
-						break;
 					}
 				}
 			}
@@ -4488,3 +4243,203 @@ MIDIStatus* __stdcall MIDIStatus_LoadW (const wchar_t* pszFileName) {
 	return pMIDIStatus;
 }
 	
+
+/******************************************************************************/
+/*                                                                            */
+/* MIDIStatusSet֐Q                                                        */
+/*                                                                            */
+/******************************************************************************/
+
+/* MIDIStatus̓e𓯂\̕ʂMIDIStatus֕ʂ(OB) */
+static long MIDIStatus_CopyParam (MIDIStatus* pDstStatus, MIDIStatus* pSrcStatus) {
+	MIDIPart* pDstMIDIPart[MIDISTATUS_MAXMIDIPART];
+	MIDIDrumSetup* pDstMIDIDrumSetup[MIDISTATUS_MAXMIDIDRUMSETUP];
+	long i;
+	assert (pDstStatus);
+	assert (pSrcStatus);
+	if (pDstStatus->m_lNumMIDIPart != pSrcStatus->m_lNumMIDIPart ||
+		pDstStatus->m_lNumMIDIDrumSetup != pSrcStatus->m_lNumMIDIDrumSetup) {
+		return 0;
+	}
+	/* qIuWFNgւ̃|C^͕ʐ̂̂ێ */
+	memcpy (pDstMIDIPart, pDstStatus->m_pMIDIPart, sizeof (pDstMIDIPart));
+	memcpy (pDstMIDIDrumSetup, pDstStatus->m_pMIDIDrumSetup, sizeof (pDstMIDIDrumSetup));
+	memcpy (pDstStatus, pSrcStatus, sizeof (MIDIStatus));
+	memcpy (pDstStatus->m_pMIDIPart, pDstMIDIPart, sizeof (pDstMIDIPart));
+	memcpy (pDstStatus->m_pMIDIDrumSetup, pDstMIDIDrumSetup, sizeof (pDstMIDIDrumSetup));
+	for (i = 0; i < pSrcStatus->m_lNumMIDIPart; i++) {
+		memcpy (pDstStatus->m_pMIDIPart[i], pSrcStatus->m_pMIDIPart[i], sizeof (MIDIPart));
+		pDstStatus->m_pMIDIPart[i]->m_pParent = pDstStatus;
+	}
+	for (i = 0; i < pSrcStatus->m_lNumMIDIDrumSetup; i++) {
+		memcpy (pDstStatus->m_pMIDIDrumSetup[i], pSrcStatus->m_pMIDIDrumSetup[i], sizeof (MIDIDrumSetup));
+		pDstStatus->m_pMIDIDrumSetup[i]->m_pParent = pDstStatus;
+	}
+	return 1;
+}
+
+/* MIDIStatusSetIuWFNg폜B */
+void __stdcall MIDIStatusSet_Delete (MIDIStatusSet* pMIDIStatusSet) {
+	long lPort;
+	if (pMIDIStatusSet == NULL) {
+		return;
+	}
+	for (lPort = 0; lPort < MIDISTATUSSET_MAXNUMPORT; lPort++) {
+		MIDIStatus_Delete (pMIDIStatusSet->m_pMIDIStatus[lPort]);
+	}
+	free (pMIDIStatusSet);
+}
+
+/* MIDIStatusSetIuWFNg𐶐B */
+/* e|[gMIDIStatuśÃ|[g߂ĎgꂽƂɐB */
+MIDIStatusSet* __stdcall MIDIStatusSet_Create (long lModuleMode, long lNumMIDIPart, long lNumMIDIDrumSetup) {
+	MIDIStatusSet* pMIDIStatusSet = NULL;
+	if (lNumMIDIPart < 0 || lNumMIDIPart > MIDISTATUS_MAXMIDIPART) {
+		return NULL;
+	}
+	if (lNumMIDIDrumSetup < 0 || lNumMIDIDrumSetup > MIDISTATUS_MAXMIDIDRUMSETUP) {
+		return NULL;
+	}
+	pMIDIStatusSet = calloc (1, sizeof (MIDIStatusSet));
+	if (pMIDIStatusSet == NULL) {
+		return NULL;
+	}
+	pMIDIStatusSet->m_lModuleMode = lModuleMode;
+	pMIDIStatusSet->m_lNumMIDIPart = lNumMIDIPart;
+	pMIDIStatusSet->m_lNumMIDIDrumSetup = lNumMIDIDrumSetup;
+	pMIDIStatusSet->m_lNumMIDIStatus = 0;
+	return pMIDIStatusSet;
+}
+
+/* w|[gMIDIStatusւ̃|C^擾(gp̃|[gNULL) */
+MIDIStatus* __stdcall MIDIStatusSet_GetMIDIStatus (MIDIStatusSet* pMIDIStatusSet, long lPort) {
+	assert (pMIDIStatusSet);
+	if (lPort < 0 || lPort >= MIDISTATUSSET_MAXNUMPORT) {
+		return NULL;
+	}
+	return pMIDIStatusSet->m_pMIDIStatus[lPort];
+}
+
+/* w|[gMIDIStatusւ̃|C^擾(gp̃|[g͐) */
+MIDIStatus* __stdcall MIDIStatusSet_GetMIDIStatusForce (MIDIStatusSet* pMIDIStatusSet, long lPort) {
+	MIDIStatus* pMIDIStatus = NULL;
+	assert (pMIDIStatusSet);
+	if (lPort < 0 || lPort >= MIDISTATUSSET_MAXNUMPORT) {
+		return NULL;
+	}
+	pMIDIStatus = pMIDIStatusSet->m_pMIDIStatus[lPort];
+	if (pMIDIStatus == NULL) {
+		pMIDIStatus = MIDIStatus_Create (pMIDIStatusSet->m_lModuleMode,
+			pMIDIStatusSet->m_lNumMIDIPart, pMIDIStatusSet->m_lNumMIDIDrumSetup);
+		if (pMIDIStatus == NULL) {
+			return NULL;
+		}
+		pMIDIStatusSet->m_pMIDIStatus[lPort] = pMIDIStatus;
+		pMIDIStatusSet->m_lNumMIDIStatus++;
+	}
+	return pMIDIStatus;
+}
+
+/* ς݂MIDIStatus̐擾 */
+long __stdcall MIDIStatusSet_GetNumMIDIStatus (MIDIStatusSet* pMIDIStatusSet) {
+	assert (pMIDIStatusSet);
+	return pMIDIStatusSet->m_lNumMIDIStatus;
+}
+
+/* W[[hݒ肵Aς݂̑S|[g̃p[^ftHglɖ߂B */
+/* Ȍ㐶|[g̃W[[hŐB */
+long __stdcall MIDIStatusSet_SetModuleMode (MIDIStatusSet* pMIDIStatusSet, long lModuleMode) {
+	long lPort;
+	assert (pMIDIStatusSet);
+	pMIDIStatusSet->m_lModuleMode = lModuleMode;
+	for (lPort = 0; lPort < MIDISTATUSSET_MAXNUMPORT; lPort++) {
+		if (pMIDIStatusSet->m_pMIDIStatus[lPort]) {
+			MIDIStatus_SetModuleMode (pMIDIStatusSet->m_pMIDIStatus[lPort], lModuleMode);
+		}
+	}
+	return 1;
+}
+
+/* ς݂̑S|[gZbg */
+long __stdcall MIDIStatusSet_PutReset (MIDIStatusSet* pMIDIStatusSet) {
+	long lPort;
+	assert (pMIDIStatusSet);
+	for (lPort = 0; lPort < MIDISTATUSSET_MAXNUMPORT; lPort++) {
+		if (pMIDIStatusSet->m_pMIDIStatus[lPort]) {
+			MIDIStatus_SetModuleMode (pMIDIStatusSet->m_pMIDIStatus[lPort],
+				pMIDIStatusSet->m_lModuleMode);
+		}
+	}
+	return 1;
+}
+
+/* w|[gMIDIbZ[W^邱Ƃɂp[^ύXB */
+/* |[gMIDIStatus̏ꍇ͂ŐB */
+long __stdcall MIDIStatusSet_PutMIDIMessage 
+(MIDIStatusSet* pMIDIStatusSet, long lPort, unsigned char* pMIDIMessage, long lLen) {
+	MIDIStatus* pMIDIStatus = NULL;
+	assert (pMIDIStatusSet);
+	assert (pMIDIMessage);
+	pMIDIStatus = MIDIStatusSet_GetMIDIStatusForce (pMIDIStatusSet, lPort);
+	if (pMIDIStatus == NULL) {
+		return 0;
+	}
+	return MIDIStatus_PutMIDIMessage (pMIDIStatus, pMIDIMessage, lLen);
+}
+
+/* MIDIStatusSet̓eʂMIDIStatusSet֕ʂB */
+/* ʌŖgp̃|[ǵAʐłꖢgpƂȂB */
+long __stdcall MIDIStatusSet_Copy (MIDIStatusSet* pDstSet, MIDIStatusSet* pSrcSet) {
+	long lPort;
+	assert (pDstSet);
+	assert (pSrcSet);
+	if (pDstSet == pSrcSet) {
+		return 1;
+	}
+	pDstSet->m_lModuleMode = pSrcSet->m_lModuleMode;
+	pDstSet->m_lNumMIDIPart = pSrcSet->m_lNumMIDIPart;
+	pDstSet->m_lNumMIDIDrumSetup = pSrcSet->m_lNumMIDIDrumSetup;
+	for (lPort = 0; lPort < MIDISTATUSSET_MAXNUMPORT; lPort++) {
+		MIDIStatus* pSrcStatus = pSrcSet->m_pMIDIStatus[lPort];
+		MIDIStatus* pDstStatus = pDstSet->m_pMIDIStatus[lPort];
+		/* \قȂꍇ╡ʌgp̏ꍇ͕ʐ */
+		if (pDstStatus && (pSrcStatus == NULL ||
+			pDstStatus->m_lNumMIDIPart != pSrcStatus->m_lNumMIDIPart ||
+			pDstStatus->m_lNumMIDIDrumSetup != pSrcStatus->m_lNumMIDIDrumSetup)) {
+			MIDIStatus_Delete (pDstStatus);
+			pDstSet->m_pMIDIStatus[lPort] = NULL;
+			pDstSet->m_lNumMIDIStatus--;
+			pDstStatus = NULL;
+		}
+		if (pSrcStatus == NULL) {
+			continue;
+		}
+		if (pDstStatus == NULL) {
+			pDstStatus = MIDIStatus_Create (pSrcStatus->m_lModuleMode,
+				pSrcStatus->m_lNumMIDIPart, pSrcStatus->m_lNumMIDIDrumSetup);
+			if (pDstStatus == NULL) {
+				return 0;
+			}
+			pDstSet->m_pMIDIStatus[lPort] = pDstStatus;
+			pDstSet->m_lNumMIDIStatus++;
+		}
+		MIDIStatus_CopyParam (pDstStatus, pSrcStatus);
+	}
+	return 1;
+}
+
+/* MIDIStatusSet̕(XibvVbg)𐶐B */
+MIDIStatusSet* __stdcall MIDIStatusSet_Duplicate (MIDIStatusSet* pSrcSet) {
+	MIDIStatusSet* pDstSet = NULL;
+	assert (pSrcSet);
+	pDstSet = MIDIStatusSet_Create (pSrcSet->m_lModuleMode,
+		pSrcSet->m_lNumMIDIPart, pSrcSet->m_lNumMIDIDrumSetup);
+	if (pDstSet == NULL) {
+		return NULL;
+	}
+	if (MIDIStatusSet_Copy (pDstSet, pSrcSet) == 0) {
+		MIDIStatusSet_Delete (pDstSet);
+		return NULL;
+	}
+	return pDstSet;
+}
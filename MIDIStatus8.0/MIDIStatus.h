@@ -152,6 +152,19 @@ typedef struct tagMIDIStatus {
 } MIDIStatus;
 
 
+#define MIDISTATUSSET_MAXNUMPORT 256 /* MIDIDATA_MAXNUMPORTƓ */
+
+/* MIDIStatusSet\ */
+/* o̓|[gƂ1MIDIStatusBMIDIStatus͏߂ĎgꂽƂɐB */
+typedef struct tagMIDIStatusSet {
+	long m_lModuleMode;           /* VɐMIDIStatus̃W[[h */
+	long m_lNumMIDIPart;          /* VɐMIDIStatusMIDIPart̐ */
+	long m_lNumMIDIDrumSetup;     /* VɐMIDIStatusMIDIDrumSetup̐ */
+	long m_lNumMIDIStatus;        /* ς݂MIDIStatus̐ */
+	MIDIStatus* m_pMIDIStatus[MIDISTATUSSET_MAXNUMPORT]; /* gp̃|[gNULL */
+} MIDIStatusSet;
+
+
 
 
 /******************************************************************************/
@@ -612,6 +625,45 @@ MIDIStatus* __stdcall MIDIStatus_LoadW (const wchar_t* pszFileName);
 #define MIDIStatus_Load MIDIStatus_LoadA
 #endif
 
+
+/******************************************************************************/
+/*                                                                            */
+/* MIDIStatusSet֐Q                                                        */
+/*                                                                            */
+/******************************************************************************/
+
+/* MIDIStatusSetIuWFNg폜B */
+void __stdcall MIDIStatusSet_Delete (MIDIStatusSet* pMIDIStatusSet);
+
+/* MIDIStatusSetIuWFNg𐶐B */
+/* e|[gMIDIStatuśÃ|[g߂ĎgꂽƂɐB */
+MIDIStatusSet* __stdcall MIDIStatusSet_Create (long lModuleMode, long lNumMIDIPart, long lNumMIDIDrumSetup);
+
+/* w|[gMIDIStatusւ̃|C^擾(gp̃|[gNULL) */
+MIDIStatus* __stdcall MIDIStatusSet_GetMIDIStatus (MIDIStatusSet* pMIDIStatusSet, long lPort);
+
+/* w|[gMIDIStatusւ̃|C^擾(gp̃|[g͐) */
+MIDIStatus* __stdcall MIDIStatusSet_GetMIDIStatusForce (MIDIStatusSet* pMIDIStatusSet, long lPort);
+
+/* ς݂MIDIStatus̐擾 */
+long __stdcall MIDIStatusSet_GetNumMIDIStatus (MIDIStatusSet* pMIDIStatusSet);
+
+/* W[[hݒ肵Aς݂̑S|[g̃p[^ftHglɖ߂B */
+long __stdcall MIDIStatusSet_SetModuleMode (MIDIStatusSet* pMIDIStatusSet, long lModuleMode);
+
+/* ς݂̑S|[gZbg */
+long __stdcall MIDIStatusSet_PutReset (MIDIStatusSet* pMIDIStatusSet);
+
+/* w|[gMIDIbZ[W^邱Ƃɂp[^ύXB */
+long __stdcall MIDIStatusSet_PutMIDIMessage 
+(MIDIStatusSet* pMIDIStatusSet, long lPort, unsigned char* pMIDIMessage, long lLen);
+
+/* MIDIStatusSet̓eʂMIDIStatusSet֕ʂB */
+long __stdcall MIDIStatusSet_Copy (MIDIStatusSet* pDstSet, MIDIStatusSet* pSrcSet);
+
+/* MIDIStatusSet̕(XibvVbg)𐶐B */
+MIDIStatusSet* __stdcall MIDIStatusSet_Duplicate (MIDIStatusSet* pSrcSet);
+
 #ifdef __cplusplus
 }
 #endif
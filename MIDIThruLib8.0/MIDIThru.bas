@@ -0,0 +1,95 @@
+'******************************************************************************
+'*                                                                            *
+'*@MIDIThru.bas - MIDIThruW[(VB4,5,6p)           (C)2026        *
+'*                                                                            *
+'******************************************************************************
+
+' MIDI͂MMIDIbZ[WAoHƂɃ`l̑IEڒE
+' xVeBϊ{Ȃ畡MIDIo͂֓](X[E}[W)(20261019ǉ)
+' ̃CúAGNU 򓙈ʌOp_(LGPL)ɊÂzz܂B
+' vWFNgz[y[WF"http://openmidiproject.sourceforge.jp/index.html"
+
+'This library is free software; you can redistribute it and/or
+'modify it under the terms of the GNU Lesser General Public
+'License as published by the Free Software Foundation; either
+'version 2.1 of the License, or (at your option) any later version.
+
+'This library is distributed in the hope that it will be useful,
+'but WITHOUT ANY WARRANTY; without even the implied warranty of
+'MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+'Lesser General Public License for more details.
+
+'You should have received a copy of the GNU Lesser General Public
+'License along with this library; if not, write to the Free Software
+'Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+
+Option Explicit
+
+Public Const MIDITHRU_MAXINNUM = 16
+Public Const MIDITHRU_MAXOUTNUM = 16
+Public Const MIDITHRU_MAXROUTENUM = 64
+
+' oHʉ߂`lbZ[WȊÕbZ[W
+Public Const MIDITHRU_SYSX = &H1
+Public Const MIDITHRU_COMMON = &H2
+Public Const MIDITHRU_REALTIME = &H4
+Public Const MIDITHRU_ALLCHANNEL = &HFFFF&
+Public Const MIDITHRU_ALLSYSTEM = &H7
+
+' MIDIThruRouteStats\(MIDIThru_GetRouteStatsŎgp)
+' Currency^̒l1/10000ƂȂ
+Type MIDIThruRouteStats
+    m_cyMessageNum As Currency          ' o͂MIDIbZ[W̐
+    m_cyAverageLatency As Currency      ' ϒx[}CNb]
+    m_cyMaxLatency As Currency          ' őx[}CNb]
+    m_lDroppedNum As Long               ' o͂łɎ̂ĂMIDIbZ[W̐
+    m_lReserved As Long
+End Type
+
+' MIDIX[IuWFNg̍폜(]̏ꍇ͒~)
+Declare Sub MIDIThru_Delete Lib "MIDIThru.dll" _
+    (ByVal pMIDIThru As Long)
+
+' MIDIX[IuWFNg̐
+Declare Function MIDIThru_Create Lib "MIDIThru.dll" () As Long
+
+' MIDI͂ǉA̔ԍ(0`)Ԃ(s-1)
+Declare Function MIDIThru_AddInput Lib "MIDIThru.dll" _
+    (ByVal pMIDIThru As Long, ByVal pMIDIIn As Long) As Long
+
+' MIDIo͂ǉA̔ԍ(0`)Ԃ(s-1)
+Declare Function MIDIThru_AddOutput Lib "MIDIThru.dll" _
+    (ByVal pMIDIThru As Long, ByVal pMIDIOut As Long) As Long
+
+' MIDI͂MIDIo͂ւ̌oHǉA̔ԍ(0`)Ԃ(s-1)
+Declare Function MIDIThru_AddRoute Lib "MIDIThru.dll" _
+    (ByVal pMIDIThru As Long, ByVal lInIndex As Long, ByVal lOutIndex As Long) As Long
+
+' oHʉ߂`lƃVXebZ[Wݒ肷
+Declare Function MIDIThru_SetRouteFilter Lib "MIDIThru.dll" _
+    (ByVal pMIDIThru As Long, ByVal lRoute As Long, _
+    ByVal lChannelMask As Long, ByVal lSystemMask As Long) As Long
+
+' oḦڒ[]ݒ肷
+Declare Function MIDIThru_SetRouteTranspose Lib "MIDIThru.dll" _
+    (ByVal pMIDIThru As Long, ByVal lRoute As Long, ByVal lTranspose As Long) As Long
+
+' oH̃xVeBϊ\(128oCg)ݒ肷
+Declare Function MIDIThru_SetRouteVelocityCurve Lib "MIDIThru.dll" _
+    (ByVal pMIDIThru As Long, ByVal lRoute As Long, ByRef pCurve As Byte) As Long
+
+' oH̓v擾
+Declare Function MIDIThru_GetRouteStats Lib "MIDIThru.dll" _
+    (ByVal pMIDIThru As Long, ByVal lRoute As Long, ByRef tagStats As MIDIThruRouteStats) As Long
+
+' ]Jn(]XbhN)
+Declare Function MIDIThru_Start Lib "MIDIThru.dll" _
+    (ByVal pMIDIThru As Long) As Long
+
+' ]~(]Xbh̏I҂Ãm[gɃm[gIt𑗂)
+Declare Function MIDIThru_Stop Lib "MIDIThru.dll" _
+    (ByVal pMIDIThru As Long) As Long
+
+' ]ׂ
+Declare Function MIDIThru_IsRunning Lib "MIDIThru.dll" _
+    (ByVal pMIDIThru As Long) As Long
@@ -0,0 +1,575 @@
+/******************************************************************************/
+/*                                                                            */
+/*  MIDIThru.c - MIDIスルー用モジュール(Win32用)           (C)2026 くず       */
+/*                                                                            */
+/******************************************************************************/
+
+/* このモジュールは普通のＣ言語で書かれている。 */
+/* このライブラリは、GNU 劣等一般公衆利用許諾契約書(LGPL)に基づき配布される。 */
+/* プロジェクトホームページ(仮)："http://openmidiproject.sourceforge.jp/index.html" */
+/* 複数のMIDI入力から受信したMIDIメッセージを、経路ごとにチャンネルの選択・移調・ */
+/* ベロシティ変換を施しながら複数のMIDI出力へ転送(スルー・マージ)する(20261019追加) */
+
+/* This library is free software; you can redistribute it and/or */
+/* modify it under the terms of the GNU Lesser General Public */
+/* License as published by the Free Software Foundation; either */
+/* version 2.1 of the License, or (at your option) any later version. */
+
+/* This library is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU */
+/* Lesser General Public License for more details. */
+
+/* You should have received a copy of the GNU Lesser General Public */
+/* License along with this library; if not, write to the Free Software */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <windows.h>
+#include <crtdbg.h>
+#include "MIDIThru.h"
+#include "MIDIClock.h"
+
+/* 汎用マクロ(最小、最大、挟み込み) ******************************************/
+#ifndef MIN
+#define MIN(A,B) ((A)>(B)?(B):(A))
+#endif
+#ifndef MAX
+#define MAX(A,B) ((A)>(B)?(A):(B))
+#endif
+#ifndef CLIP
+#define CLIP(A,B,C) ((A)>(B)?(A):((B)>(C)?(C):(B)))
+#endif
+
+/* 経路の排他制御を開始する(隠蔽) */
+/* 転送スレッドは経路の設定を読む間と統計を更新する間だけロックを保持し、 */
+/* MIDI出力への出力中は保持しない(SYSXの出力はSYSX送信バッファの空きを待つことがあるため) */
+/* (待つ側はクリティカルセクションで眠るため、CPUを回し続けることはない) */
+static void MIDIThru_Lock (MIDIThru* pMIDIThru) {
+	EnterCriticalSection ((CRITICAL_SECTION*)(pMIDIThru->m_pSection));
+}
+
+/* 経路の排他制御を終了する(隠蔽) */
+static void MIDIThru_Unlock (MIDIThru* pMIDIThru) {
+	LeaveCriticalSection ((CRITICAL_SECTION*)(pMIDIThru->m_pSection));
+}
+
+/* 経路の番号が有効か調べる(隠蔽) */
+static long MIDIThru_IsValidRoute (MIDIThru* pMIDIThru, long lRoute) {
+	return 0 <= lRoute && lRoute < pMIDIThru->m_lRouteNum;
+}
+
+/* 1つの経路へ出力するMIDIメッセージを作る(転送スレッド・ロック中)(隠蔽) */
+/* チャンネルの選択・移調・ベロシティ変換を行い、チャンネルメッセージはbyMessageへ格納する */
+/* (システムメッセージはpMessageをそのまま出力する)。戻り値：出力する=1、出力しない=0 */
+static long MIDIThru_PrepareRoute (MIDIThruRoute* pRoute,
+	const unsigned char* pMessage, long lLen, unsigned char* byMessage) {
+	unsigned char* pNoteMap;
+	unsigned char byStatus = pMessage[0];
+	long lKey;
+	/* システムメッセージ */
+	if (byStatus >= 0xF0) {
+		return byStatus == 0xF0 ? (pRoute->m_lSystemMask & MIDITHRU_SYSX) != 0 :
+			byStatus >= 0xF8 ? (pRoute->m_lSystemMask & MIDITHRU_REALTIME) != 0 :
+			(pRoute->m_lSystemMask & MIDITHRU_COMMON) != 0;
+	}
+	/* チャンネルメッセージ */
+	if ((pRoute->m_lChannelMask & (1 << (byStatus & 0x0F))) == 0) {
+		return 0;
+	}
+	memcpy (byMessage, pMessage, lLen);
+	/* ノートオフ・ノートオン・キーアフタータッチは移調する */
+	/* ノートオフは対応するノートオンと同じキーへ送る(移調量が途中で変わってもよい) */
+	if (byStatus < 0xB0) {
+		pNoteMap = &(pRoute->m_byNoteMap[byStatus & 0x0F][byMessage[1] & 0x7F]);
+		lKey = *pNoteMap ? *pNoteMap - 1 : byMessage[1] + pRoute->m_lTranspose;
+		if (lKey < 0 || lKey > 127) {
+			pRoute->m_lDroppedNum++;
+			return 0;
+		}
+		if ((byStatus & 0xF0) == 0x90 && byMessage[2] > 0) {
+			*pNoteMap = (unsigned char)(lKey + 1);
+			byMessage[2] = MAX (pRoute->m_byVelocityCurve[byMessage[2]], 1);
+		}
+		else if ((byStatus & 0xF0) != 0xA0) {
+			*pNoteMap = 0;
+		}
+		byMessage[1] = (unsigned char)lKey;
+	}
+	return 1;
+}
+
+/* 組み立てたMIDIメッセージを、そのMIDI入力を入力元とするすべての経路へ出力する(隠蔽) */
+/* ロック中に各経路へ出力する内容を作ってからロックを外して出力し、再びロックして統計を更新する */
+/* (経路は追加されるだけで削除されないので、ロックを外している間も経路の番号は変わらない) */
+static void MIDIThru_Dispatch (MIDIThru* pMIDIThru, long lInIndex,
+	const unsigned char* pMessage, long lLen, int64_t llMicrosec) {
+	unsigned char byMessage[MIDITHRU_MAXROUTENUM][3];
+	long lRoute[MIDITHRU_MAXROUTENUM];
+	long lRet[MIDITHRU_MAXROUTENUM];
+	int64_t llLatency[MIDITHRU_MAXROUTENUM];
+	MIDIOut* pMIDIOut[MIDITHRU_MAXROUTENUM];
+	MIDIThruRoute* pRoute;
+	long lRouteNum;
+	long lNum = 0;
+	long i;
+	/* 各経路へ出力する内容を作る */
+	MIDIThru_Lock (pMIDIThru);
+	lRouteNum = pMIDIThru->m_lRouteNum;
+	for (i = 0; i < lRouteNum; i++) {
+		pRoute = &(pMIDIThru->m_theRoute[i]);
+		if (pRoute->m_lInIndex == lInIndex &&
+			MIDIThru_PrepareRoute (pRoute, pMessage, lLen, byMessage[lNum])) {
+			pMIDIOut[lNum] = pMIDIThru->m_pMIDIOut[pRoute->m_lOutIndex];
+			lRoute[lNum++] = i;
+		}
+	}
+	MIDIThru_Unlock (pMIDIThru);
+	/* 出力する */
+	for (i = 0; i < lNum; i++) {
+		/* MIDIOut_PutMIDIMessageで出力できない長さのSYSXは分割して続けて出力する */
+		if (pMessage[0] == 0xF0 && lLen > MIDIIO_MAXSYSXSIZE) {
+			lRet[i] = MIDIOut_PutBytes (pMIDIOut[i], (unsigned char*)pMessage, lLen);
+		}
+		else {
+			lRet[i] = MIDIOut_PutMIDIMessage (pMIDIOut[i],
+				pMessage[0] >= 0xF0 ? (unsigned char*)pMessage : byMessage[i], lLen);
+		}
+		llLatency[i] = MIDIClock_GetMonotonicMicrosec () - llMicrosec;
+	}
+	/* 統計を更新する */
+	if (lNum == 0) {
+		return;
+	}
+	MIDIThru_Lock (pMIDIThru);
+	for (i = 0; i < lNum; i++) {
+		pRoute = &(pMIDIThru->m_theRoute[lRoute[i]]);
+		if (lRet[i] <= 0) {
+			pRoute->m_lDroppedNum++;
+			continue;
+		}
+		pRoute->m_llMessageNum++;
+		pRoute->m_llLatencySum += llLatency[i];
+		if (llLatency[i] > pRoute->m_llMaxLatency) {
+			pRoute->m_llMaxLatency = llLatency[i];
+		}
+	}
+	MIDIThru_Unlock (pMIDIThru);
+}
+
+/* 組み立て中のSYSXを捨て、そのMIDI入力の経路の捨てた数に数える(隠蔽) */
+static void MIDIThru_DropSysx (MIDIThru* pMIDIThru, long lInIndex) {
+	long i;
+	MIDIThru_Lock (pMIDIThru);
+	for (i = 0; i < pMIDIThru->m_lRouteNum; i++) {
+		if (pMIDIThru->m_theRoute[i].m_lInIndex == lInIndex &&
+			(pMIDIThru->m_theRoute[i].m_lSystemMask & MIDITHRU_SYSX)) {
+			pMIDIThru->m_theRoute[i].m_lDroppedNum++;
+		}
+	}
+	MIDIThru_Unlock (pMIDIThru);
+	pMIDIThru->m_theInput[lInIndex].m_lSysxLen = 0;
+	pMIDIThru->m_theInput[lInIndex].m_bSysxOverflow = 0;
+}
+
+/* SYSXの一部(先頭の0xF0又はその続き)を組み立て中のSYSXへ追加する(転送スレッド)(隠蔽) */
+/* 終端(0xF7)まで揃ったら出力する。途中のシステムリアルタイムメッセージは直ちに出力し、 */
+/* その他のステータスバイトが現れた場合はSYSXを捨ててそこで打ち切る。戻り値は消費したバイト数 */
+static long MIDIThru_PutSysx (MIDIThru* pMIDIThru, long lInIndex,
+	const unsigned char* pData, long lLen, int64_t llMicrosec) {
+	MIDIThruInput* pInput = &(pMIDIThru->m_theInput[lInIndex]);
+	unsigned char c;
+	long i;
+	if (pData[0] == 0xF0) {
+		if (pInput->m_lSysxLen > 0) {
+			MIDIThru_DropSysx (pMIDIThru, lInIndex);
+		}
+		pInput->m_llSysxMicrosec = llMicrosec;
+	}
+	/* 先頭を捨てたSYSXの続きは捨てる */
+	else if (pInput->m_lSysxLen == 0) {
+		return lLen;
+	}
+	for (i = 0; i < lLen; i++) {
+		c = pData[i];
+		if (c >= 0xF8) {
+			MIDIThru_Dispatch (pMIDIThru, lInIndex, &c, 1, llMicrosec);
+			continue;
+		}
+		if (c >= 0x80 && c != 0xF7 && (c != 0xF0 || i > 0)) {
+			MIDIThru_DropSysx (pMIDIThru, lInIndex);
+			return i;
+		}
+		if (pInput->m_lSysxLen < MIDITHRU_SYSXBUFSIZE) {
+			pInput->m_pSysx[pInput->m_lSysxLen++] = c;
+		}
+		else {
+			pInput->m_bSysxOverflow = 1;
+		}
+	}
+	if (pData[lLen - 1] == 0xF7) {
+		if (pInput->m_bSysxOverflow) {
+			MIDIThru_DropSysx (pMIDIThru, lInIndex);
+			return lLen;
+		}
+		MIDIThru_Dispatch (pMIDIThru, lInIndex,
+			pInput->m_pSysx, pInput->m_lSysxLen, pInput->m_llSysxMicrosec);
+		pInput->m_lSysxLen = 0;
+	}
+	return lLen;
+}
+
+/* MIDI入力から取り出したバイト列をMIDIメッセージに組み立てて出力する(転送スレッド)(隠蔽) */
+/* バイト列はMIDIメッセージの境界で区切られているとは限らない(SYSXの続き、ランニングステータス) */
+/* 切り出しはMIDIStream_Splitで行い、ランニングステータスはMIDI入力ごとにm_byRunningStatusに保持する */
+static void MIDIThru_Parse (MIDIThru* pMIDIThru, long lInIndex,
+	const unsigned char* pData, long lLen, int64_t llMicrosec) {
+	MIDIThruInput* pInput = &(pMIDIThru->m_theInput[lInIndex]);
+	const unsigned char* pEnd = pData + lLen;
+	const unsigned char* p;
+	unsigned char byPrevRunningStatus;
+	long lSplitLen, lOffset, lMessageLen, lSysxLen;
+	while (pData < pEnd) {
+		/* 前のバイト列の末尾で途切れたMIDIメッセージの残りのデータバイト */
+		if (pInput->m_lMessageLen > 0 && *pData < 0x80) {
+			pInput->m_byMessage[pInput->m_lMessageLen++] = *pData++;
+			if (pInput->m_lMessageLen >= MIDIStream_GetMessageLen (pInput->m_byMessage[0])) {
+				MIDIThru_Dispatch (pMIDIThru, lInIndex,
+					pInput->m_byMessage, pInput->m_lMessageLen, pInput->m_llMessageMicrosec);
+				pInput->m_lMessageLen = 0;
+			}
+			continue;
+		}
+		byPrevRunningStatus = pInput->m_byRunningStatus;
+		lSplitLen = MIDIStream_Split (pData, (long)(pEnd - pData),
+			&(pInput->m_byRunningStatus), &lOffset, &lMessageLen);
+		p = pData + lOffset;
+		pData += lSplitLen;
+		if (lMessageLen == 0) {
+			continue;
+		}
+		/* システムリアルタイムメッセージはSYSXの途中でも直ちに出力する */
+		if (*p >= 0xF8) {
+			MIDIThru_Dispatch (pMIDIThru, lInIndex, p, 1, llMicrosec);
+		}
+		/* SYSX又はその続き(バイト列の先頭に来た終端(0xF7)も続きとして扱う) */
+		else if (*p == 0xF0 || byPrevRunningStatus == 0xF0 && (*p < 0x80 || *p == 0xF7)) {
+			pInput->m_lMessageLen = 0;
+			lSysxLen = MIDIThru_PutSysx (pMIDIThru, lInIndex, p, lMessageLen, llMicrosec);
+			/* 途中のステータスバイトで打ち切られた場合は、そこから切り出し直す */
+			if (lSysxLen < lMessageLen) {
+				pInput->m_byRunningStatus = 0;
+				pData = p + lSysxLen;
+			}
+		}
+		/* ステータスバイトで始まるMIDIメッセージ(途中のSYSXは不完全なので捨てる) */
+		/* (ランニングステータスで省略されたものはステータスを補う) */
+		else {
+			if (pInput->m_lSysxLen > 0) {
+				MIDIThru_DropSysx (pMIDIThru, lInIndex);
+			}
+			pInput->m_lMessageLen = 0;
+			/* SYSXの外の0xF7は捨てる */
+			if (*p == 0xF7) {
+				continue;
+			}
+			if (*p < 0x80) {
+				pInput->m_byMessage[pInput->m_lMessageLen++] = byPrevRunningStatus;
+			}
+			memcpy (pInput->m_byMessage + pInput->m_lMessageLen, p, lMessageLen);
+			pInput->m_lMessageLen += lMessageLen;
+			pInput->m_llMessageMicrosec = llMicrosec;
+			/* バイト列の末尾で途切れた場合は、次のバイト列の先頭のデータバイトを待つ */
+			if (pInput->m_lMessageLen >= MIDIStream_GetMessageLen (pInput->m_byMessage[0])) {
+				MIDIThru_Dispatch (pMIDIThru, lInIndex,
+					pInput->m_byMessage, pInput->m_lMessageLen, pInput->m_llMessageMicrosec);
+				pInput->m_lMessageLen = 0;
+			}
+		}
+	}
+}
+
+/* 転送スレッド(隠蔽) */
+/* 各MIDI入力を空になるまで読んでから、いずれかの入力待ち用イベントを待つ */
+/* (入力待ち用イベントは入力バッファが空から空でなくなったときにのみシグナル状態となる) */
+static DWORD WINAPI MIDIThru_ThreadProc (LPVOID pParam) {
+	MIDIThru* pMIDIThru = (MIDIThru*)pParam;
+	HANDLE hWait[MIDITHRU_MAXINNUM + 1];
+	MIDIMsgRecord* pRecord;
+	long lInNum = pMIDIThru->m_lInNum;
+	long lNum, i, j;
+	for (i = 0; i < lInNum; i++) {
+		hWait[i] = (HANDLE)MIDIIn_GetWaitHandle (pMIDIThru->m_theInput[i].m_pMIDIIn);
+	}
+	hWait[lInNum] = (HANDLE)(pMIDIThru->m_hWakeEvent);
+	while (!pMIDIThru->m_bExit) {
+		for (i = 0; i < lInNum; i++) {
+			while ((lNum = MIDIIn_GetMIDIMessages (pMIDIThru->m_theInput[i].m_pMIDIIn,
+				pMIDIThru->m_pMsgRecord, MIDITHRU_MSGNUM, pMIDIThru->m_pSysxBuf, MIDIIO_BUFSIZE)) > 0) {
+				for (j = 0; j < lNum; j++) {
+					pRecord = pMIDIThru->m_pMsgRecord + j;
+					MIDIThru_Parse (pMIDIThru, i, pRecord->m_lSysxOffset >= 0 ?
+						pMIDIThru->m_pSysxBuf + pRecord->m_lSysxOffset : pRecord->m_byData,
+						pRecord->m_lLen, pRecord->m_llMicrosec);
+				}
+			}
+		}
+		WaitForMultipleObjects (lInNum + 1, hWait, FALSE, INFINITE);
+	}
+	return 0;
+}
+
+/* MIDIスルーオブジェクトの削除(転送中の場合は停止する) */
+void __stdcall MIDIThru_Delete (MIDIThru* pMIDIThru) {
+	long i;
+	if (pMIDIThru == NULL) {
+		return;
+	}
+	MIDIThru_Stop (pMIDIThru);
+	for (i = 0; i < pMIDIThru->m_lInNum; i++) {
+		free (pMIDIThru->m_theInput[i].m_pSysx);
+	}
+	if (pMIDIThru->m_hWakeEvent) {
+		CloseHandle ((HANDLE)(pMIDIThru->m_hWakeEvent));
+	}
+	if (pMIDIThru->m_pSection) {
+		DeleteCriticalSection ((CRITICAL_SECTION*)(pMIDIThru->m_pSection));
+		free (pMIDIThru->m_pSection);
+	}
+	free (pMIDIThru->m_pMsgRecord);
+	free (pMIDIThru->m_pSysxBuf);
+	free (pMIDIThru);
+}
+
+/* MIDIスルーオブジェクトの生成 */
+MIDIThru* __stdcall MIDIThru_Create () {
+	MIDIThru* pMIDIThru = (MIDIThru*)calloc (1, sizeof (MIDIThru));
+	if (pMIDIThru == NULL) {
+		_RPTF0 (_CRT_WARN, "エラー：MIDIThru_Create内でcallocがNULLを返しました。\r\n");
+		return NULL;
+	}
+	pMIDIThru->m_pMsgRecord = (MIDIMsgRecord*)calloc (MIDITHRU_MSGNUM, sizeof (MIDIMsgRecord));
+	pMIDIThru->m_pSysxBuf = (unsigned char*)malloc (MIDIIO_BUFSIZE);
+	pMIDIThru->m_hWakeEvent = CreateEvent (NULL, FALSE, FALSE, NULL);
+	if (pMIDIThru->m_pMsgRecord == NULL || pMIDIThru->m_pSysxBuf == NULL ||
+		pMIDIThru->m_hWakeEvent == NULL) {
+		MIDIThru_Delete (pMIDIThru);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIThru_Create内でメモリ確保に失敗しました。\r\n");
+		return NULL;
+	}
+	pMIDIThru->m_pSection = malloc (sizeof (CRITICAL_SECTION));
+	if (pMIDIThru->m_pSection == NULL) {
+		MIDIThru_Delete (pMIDIThru);
+		_RPTF0 (_CRT_WARN, "エラー：MIDIThru_Create内でmallocがNULLを返しました。\r\n");
+		return NULL;
+	}
+	InitializeCriticalSection ((CRITICAL_SECTION*)(pMIDIThru->m_pSection));
+	return pMIDIThru;
+}
+
+/* MIDI入力を追加し、その番号(0〜)を返す(失敗時-1) */
+long __stdcall MIDIThru_AddInput (MIDIThru* pMIDIThru, MIDIIn* pMIDIIn) {
+	MIDIThruInput* pInput;
+	_ASSERT (pMIDIThru);
+	_ASSERT (pMIDIIn);
+	if (pMIDIThru == NULL || pMIDIIn == NULL) {
+		return -1;
+	}
+	if (pMIDIIn->m_lMode != MIDIIO_MODEIN || pMIDIThru->m_hThread ||
+		pMIDIThru->m_lInNum >= MIDITHRU_MAXINNUM) {
+		return -1;
+	}
+	pInput = &(pMIDIThru->m_theInput[pMIDIThru->m_lInNum]);
+	memset (pInput, 0, sizeof (MIDIThruInput));
+	pInput->m_pSysx = (unsigned char*)malloc (MIDITHRU_SYSXBUFSIZE);
+	if (pInput->m_pSysx == NULL) {
+		_RPTF0 (_CRT_WARN, "エラー：MIDIThru_AddInput内でmallocがNULLを返しました。\r\n");
+		return -1;
+	}
+	pInput->m_pMIDIIn = pMIDIIn;
+	return pMIDIThru->m_lInNum++;
+}
+
+/* MIDI出力を追加し、その番号(0〜)を返す(失敗時-1) */
+long __stdcall MIDIThru_AddOutput (MIDIThru* pMIDIThru, MIDIOut* pMIDIOut) {
+	_ASSERT (pMIDIThru);
+	_ASSERT (pMIDIOut);
+	if (pMIDIThru == NULL || pMIDIOut == NULL) {
+		return -1;
+	}
+	if (pMIDIOut->m_lMode != MIDIIO_MODEOUT || pMIDIThru->m_hThread ||
+		pMIDIThru->m_lOutNum >= MIDITHRU_MAXOUTNUM) {
+		return -1;
+	}
+	pMIDIThru->m_pMIDIOut[pMIDIThru->m_lOutNum] = pMIDIOut;
+	return pMIDIThru->m_lOutNum++;
+}
+
+/* MIDI入力からMIDI出力への経路を追加し、その番号(0〜)を返す(失敗時-1) */
+long __stdcall MIDIThru_AddRoute (MIDIThru* pMIDIThru, long lInIndex, long lOutIndex) {
+	MIDIThruRoute* pRoute;
+	long i;
+	_ASSERT (pMIDIThru);
+	if (pMIDIThru == NULL) {
+		return -1;
+	}
+	if (lInIndex < 0 || lInIndex >= pMIDIThru->m_lInNum ||
+		lOutIndex < 0 || lOutIndex >= pMIDIThru->m_lOutNum ||
+		pMIDIThru->m_lRouteNum >= MIDITHRU_MAXROUTENUM) {
+		return -1;
+	}
+	/* 経路を初期化してから経路の数を増やす */
+	MIDIThru_Lock (pMIDIThru);
+	pRoute = &(pMIDIThru->m_theRoute[pMIDIThru->m_lRouteNum]);
+	memset (pRoute, 0, sizeof (MIDIThruRoute));
+	pRoute->m_lInIndex = lInIndex;
+	pRoute->m_lOutIndex = lOutIndex;
+	pRoute->m_lChannelMask = MIDITHRU_ALLCHANNEL;
+	pRoute->m_lSystemMask = MIDITHRU_ALLSYSTEM;
+	for (i = 0; i < 128; i++) {
+		pRoute->m_byVelocityCurve[i] = (unsigned char)i;
+	}
+	i = pMIDIThru->m_lRouteNum++;
+	MIDIThru_Unlock (pMIDIThru);
+	return i;
+}
+
+/* 経路が通過させるチャンネルとシステムメッセージを設定する */
+long __stdcall MIDIThru_SetRouteFilter
+(MIDIThru* pMIDIThru, long lRoute, long lChannelMask, long lSystemMask) {
+	_ASSERT (pMIDIThru);
+	if (pMIDIThru == NULL || !MIDIThru_IsValidRoute (pMIDIThru, lRoute)) {
+		return 0;
+	}
+	MIDIThru_Lock (pMIDIThru);
+	pMIDIThru->m_theRoute[lRoute].m_lChannelMask = lChannelMask & MIDITHRU_ALLCHANNEL;
+	pMIDIThru->m_theRoute[lRoute].m_lSystemMask = lSystemMask & MIDITHRU_ALLSYSTEM;
+	MIDIThru_Unlock (pMIDIThru);
+	return 1;
+}
+
+/* 経路の移調量[半音]を設定する */
+long __stdcall MIDIThru_SetRouteTranspose (MIDIThru* pMIDIThru, long lRoute, long lTranspose) {
+	_ASSERT (pMIDIThru);
+	if (pMIDIThru == NULL || !MIDIThru_IsValidRoute (pMIDIThru, lRoute)) {
+		return 0;
+	}
+	MIDIThru_Lock (pMIDIThru);
+	pMIDIThru->m_theRoute[lRoute].m_lTranspose = CLIP (-127, lTranspose, 127);
+	MIDIThru_Unlock (pMIDIThru);
+	return 1;
+}
+
+/* 経路のベロシティ変換表(128バイト)を設定する(NULLの場合は変換しない) */
+long __stdcall MIDIThru_SetRouteVelocityCurve
+(MIDIThru* pMIDIThru, long lRoute, const unsigned char* pCurve) {
+	MIDIThruRoute* pRoute;
+	long i;
+	_ASSERT (pMIDIThru);
+	if (pMIDIThru == NULL || !MIDIThru_IsValidRoute (pMIDIThru, lRoute)) {
+		return 0;
+	}
+	MIDIThru_Lock (pMIDIThru);
+	pRoute = &(pMIDIThru->m_theRoute[lRoute]);
+	for (i = 0; i < 128; i++) {
+		pRoute->m_byVelocityCurve[i] = pCurve ? (unsigned char)(pCurve[i] & 0x7F) : (unsigned char)i;
+	}
+	MIDIThru_Unlock (pMIDIThru);
+	return 1;
+}
+
+/* 経路の統計を取得する */
+long __stdcall MIDIThru_GetRouteStats
+(MIDIThru* pMIDIThru, long lRoute, MIDIThruRouteStats* pStats) {
+	MIDIThruRoute* pRoute;
+	_ASSERT (pMIDIThru);
+	_ASSERT (pStats);
+	if (pMIDIThru == NULL || pStats == NULL || !MIDIThru_IsValidRoute (pMIDIThru, lRoute)) {
+		return 0;
+	}
+	MIDIThru_Lock (pMIDIThru);
+	pRoute = &(pMIDIThru->m_theRoute[lRoute]);
+	memset (pStats, 0, sizeof (MIDIThruRouteStats));
+	pStats->m_llMessageNum = pRoute->m_llMessageNum;
+	pStats->m_llAverageLatency = pRoute->m_llMessageNum > 0 ?
+		pRoute->m_llLatencySum / pRoute->m_llMessageNum : 0;
+	pStats->m_llMaxLatency = pRoute->m_llMaxLatency;
+	pStats->m_lDroppedNum = pRoute->m_lDroppedNum;
+	MIDIThru_Unlock (pMIDIThru);
+	return 1;
+}
+
+/* 転送を開始する(転送スレッドを起動する) */
+long __stdcall MIDIThru_Start (MIDIThru* pMIDIThru) {
+	long i;
+	_ASSERT (pMIDIThru);
+	if (pMIDIThru == NULL) {
+		return 0;
+	}
+	/* 既に転送中 */
+	if (pMIDIThru->m_hThread) {
+		return 1;
+	}
+	/* 組み立て途中の状態は前回の転送のものなので捨てる */
+	for (i = 0; i < pMIDIThru->m_lInNum; i++) {
+		pMIDIThru->m_theInput[i].m_byRunningStatus = 0;
+		pMIDIThru->m_theInput[i].m_lMessageLen = 0;
+		pMIDIThru->m_theInput[i].m_lSysxLen = 0;
+		pMIDIThru->m_theInput[i].m_bSysxOverflow = 0;
+	}
+	pMIDIThru->m_bExit = 0;
+	pMIDIThru->m_hThread = CreateThread (NULL, 0, MIDIThru_ThreadProc, pMIDIThru, 0, NULL);
+	if (pMIDIThru->m_hThread == NULL) {
+		_RPTF0 (_CRT_WARN, "エラー：MIDIThru_Start内でCreateThreadがNULLを返しました。\r\n");
+		return 0;
+	}
+	SetThreadPriority ((HANDLE)(pMIDIThru->m_hThread), THREAD_PRIORITY_HIGHEST);
+	return 1;
+}
+
+/* 転送を停止する(転送スレッドの終了を待ち、発音中のノートにノートオフを送る) */
+long __stdcall MIDIThru_Stop (MIDIThru* pMIDIThru) {
+	MIDIThruRoute* pRoute;
+	unsigned char byMessage[3];
+	long i, lChannel, lKey;
+	_ASSERT (pMIDIThru);
+	if (pMIDIThru == NULL) {
+		return 0;
+	}
+	if (pMIDIThru->m_hThread == NULL) {
+		return 1;
+	}
+	MemoryBarrier ();
+	pMIDIThru->m_bExit = 1;
+	SetEvent ((HANDLE)(pMIDIThru->m_hWakeEvent));
+	WaitForSingleObject ((HANDLE)(pMIDIThru->m_hThread), INFINITE);
+	CloseHandle ((HANDLE)(pMIDIThru->m_hThread));
+	pMIDIThru->m_hThread = NULL;
+	/* 転送スレッドは停止しているので、ここからMIDI出力へ出力してよい */
+	for (i = 0; i < pMIDIThru->m_lRouteNum; i++) {
+		pRoute = &(pMIDIThru->m_theRoute[i]);
+		for (lChannel = 0; lChannel < 16; lChannel++) {
+			for (lKey = 0; lKey < 128; lKey++) {
+				if (pRoute->m_byNoteMap[lChannel][lKey]) {
+					byMessage[0] = (unsigned char)(0x80 | lChannel);
+					byMessage[1] = (unsigned char)(pRoute->m_byNoteMap[lChannel][lKey] - 1);
+					byMessage[2] = 0;
+					MIDIOut_PutMIDIMessage (pMIDIThru->m_pMIDIOut[pRoute->m_lOutIndex], byMessage, 3);
+					pRoute->m_byNoteMap[lChannel][lKey] = 0;
+				}
+			}
+		}
+	}
+	return 1;
+}
+
+/* 転送中か調べる */
+long __stdcall MIDIThru_IsRunning (MIDIThru* pMIDIThru) {
+	_ASSERT (pMIDIThru);
+	if (pMIDIThru == NULL) {
+		return 0;
+	}
+	return pMIDIThru->m_hThread ? 1 : 0;
+}
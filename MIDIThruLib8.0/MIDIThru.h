@@ -0,0 +1,159 @@
+/******************************************************************************/
+/*                                                                            */
+/*  MIDIThru.h - MIDIThruヘッダーファイル                  (C)2026 くず       */
+/*                                                                            */
+/******************************************************************************/
+
+/* このモジュールは普通のＣ言語で書かれている。 */
+/* このライブラリは、GNU 劣等一般公衆利用許諾契約書(LGPL)に基づき配布される。 */
+/* プロジェクトホームページ(仮)："http://openmidiproject.sourceforge.jp/index.html" */
+/* 複数のMIDI入力から受信したMIDIメッセージを、経路ごとにチャンネルの選択・移調・ */
+/* ベロシティ変換を施しながら複数のMIDI出力へ転送(スルー・マージ)する(20261019追加) */
+
+/* This library is free software; you can redistribute it and/or */
+/* modify it under the terms of the GNU Lesser General Public */
+/* License as published by the Free Software Foundation; either */
+/* version 2.1 of the License, or (at your option) any later version. */
+
+/* This library is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU */
+/* Lesser General Public License for more details. */
+
+/* You should have received a copy of the GNU Lesser General Public */
+/* License along with this library; if not, write to the Free Software */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+#if !defined _MIDITHRU_H_
+#define _MIDITHRU_H_
+
+#include "MIDIIO.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MIDITHRU_MAXINNUM 16 /* MIDI入力の最大数 */
+#define MIDITHRU_MAXOUTNUM 16 /* MIDI出力の最大数 */
+#define MIDITHRU_MAXROUTENUM 64 /* 経路の最大数 */
+#define MIDITHRU_MSGNUM 256 /* 転送スレッドが一度に取り出すMIDIメッセージの最大数 */
+#define MIDITHRU_SYSXBUFSIZE 65536 /* 組み立て中のSYSXの最大長[バイト] */
+
+/* 経路が通過させるチャンネルメッセージ以外のメッセージ(MIDIThru_SetRouteFilterで指定) */
+#define MIDITHRU_SYSX     0x0001 /* システムエクスクルーシヴ */
+#define MIDITHRU_COMMON   0x0002 /* システムコモン */
+#define MIDITHRU_REALTIME 0x0004 /* システムリアルタイム */
+#define MIDITHRU_ALLCHANNEL 0xFFFF /* すべてのチャンネル */
+#define MIDITHRU_ALLSYSTEM  0x0007 /* すべてのシステムメッセージ */
+
+/* 転送は専用の転送スレッドが行う。転送スレッドはすべてのMIDI入力の入力待ち用イベント */
+/* (MIDIIn_GetWaitHandle)で受信を待ち、MIDIIn_GetMIDIMessagesで取り出したバイト列を */
+/* MIDI入力ごとにMIDIメッセージへ組み立て直してから各経路へ送る。 */
+/* ランニングステータスで省略されたステータスは補い、分割されて届いたSYSXは終端(0xF7)まで */
+/* まとめてから1つのメッセージとして出力するため、複数のMIDI入力を1つのMIDI出力へ */
+/* 合流させても、メッセージが他の入力のメッセージと混ざることはない。 */
+/* SYSXの途中に届いたシステムリアルタイムメッセージは、SYSXの完成を待たずに出力する。 */
+/* MIDI出力への出力はすべて転送スレッドが行うので、転送中はMIDI出力へ他から出力しないこと。 */
+
+/* 経路の統計(MIDIThru_GetRouteStatsで取得) */
+/* 遅延は、MIDI入力の受信時刻からMIDI出力への出力を終えるまでの時間[マイクロ秒]である。 */
+typedef struct tagMIDIThruRouteStats {
+	int64_t m_llMessageNum; /* 出力したMIDIメッセージの数 */
+	int64_t m_llAverageLatency; /* 平均遅延[マイクロ秒] */
+	int64_t m_llMaxLatency; /* 最大遅延[マイクロ秒] */
+	long  m_lDroppedNum; /* 出力できずに捨てたMIDIメッセージの数 */
+	long  m_lReserved;
+} MIDIThruRouteStats;
+
+/* 経路 */
+typedef struct tagMIDIThruRoute {
+	long  m_lInIndex; /* 入力元のMIDI入力の番号 */
+	long  m_lOutIndex; /* 出力先のMIDI出力の番号 */
+	long  m_lChannelMask; /* 通過させるチャンネルのビットマスク(bit0=1ch〜bit15=16ch) */
+	long  m_lSystemMask; /* 通過させるシステムメッセージ(MIDITHRU_SYSX等の組み合わせ) */
+	long  m_lTranspose; /* 移調量[半音] */
+	unsigned char m_byVelocityCurve[128]; /* ノートオンのベロシティ変換表 */
+	unsigned char m_byNoteMap[16][128]; /* 発音中のノートの出力キー+1(0=発音していない) */
+	int64_t m_llMessageNum; /* 出力したMIDIメッセージの数 */
+	int64_t m_llLatencySum; /* 遅延の合計[マイクロ秒] */
+	int64_t m_llMaxLatency; /* 最大遅延[マイクロ秒] */
+	long  m_lDroppedNum; /* 出力できずに捨てたMIDIメッセージの数 */
+} MIDIThruRoute;
+
+/* MIDI入力ごとの組み立て状態 */
+typedef struct tagMIDIThruInput {
+	MIDIIn* m_pMIDIIn; /* MIDI入力オブジェクト */
+	unsigned char m_byRunningStatus; /* ランニングステータス(0=なし) */
+	unsigned char m_byMessage[3]; /* 組み立て中のMIDIメッセージ */
+	long  m_lMessageLen; /* 組み立て中のMIDIメッセージの長さ */
+	int64_t m_llMessageMicrosec; /* 組み立て中のMIDIメッセージの受信時刻[マイクロ秒] */
+	unsigned char* m_pSysx; /* 組み立て中のSYSX(MIDITHRU_SYSXBUFSIZE) */
+	long  m_lSysxLen; /* 組み立て中のSYSXの長さ(0=SYSXの外) */
+	long  m_bSysxOverflow; /* 組み立て中のSYSXがMIDITHRU_SYSXBUFSIZEを超えた */
+	int64_t m_llSysxMicrosec; /* 組み立て中のSYSXの受信時刻[マイクロ秒] */
+} MIDIThruInput;
+
+/* MIDIThru構造体 */
+typedef struct tagMIDIThru {
+	MIDIThruInput m_theInput[MIDITHRU_MAXINNUM]; /* MIDI入力 */
+	long  m_lInNum; /* MIDI入力の数 */
+	MIDIOut* m_pMIDIOut[MIDITHRU_MAXOUTNUM]; /* MIDI出力 */
+	long  m_lOutNum; /* MIDI出力の数 */
+	MIDIThruRoute m_theRoute[MIDITHRU_MAXROUTENUM]; /* 経路 */
+	volatile long m_lRouteNum; /* 経路の数 */
+	void* m_pSection; /* 経路の排他制御(mallocで確保したCRITICAL_SECTION) */
+	MIDIMsgRecord* m_pMsgRecord; /* 取り出し用バッファ(MIDITHRU_MSGNUM個) */
+	unsigned char* m_pSysxBuf; /* SYSX取り出し用バッファ(MIDIIO_BUFSIZE) */
+	volatile long m_bExit; /* 転送スレッドの終了要求 */
+	void* m_hWakeEvent; /* 転送スレッドを起こすイベント */
+	void* m_hThread; /* 転送スレッド(停止中はNULL) */
+} MIDIThru;
+
+/* MIDIスルーオブジェクトの削除(転送中の場合は停止する) */
+void __stdcall MIDIThru_Delete (MIDIThru* pMIDIThru);
+
+/* MIDIスルーオブジェクトの生成 */
+MIDIThru* __stdcall MIDIThru_Create ();
+
+/* MIDI入力を追加し、その番号(0〜)を返す(失敗時-1) */
+/* 停止中のみ追加できる。MIDI入力はMIDIスルーオブジェクトより後に閉じること */
+long __stdcall MIDIThru_AddInput (MIDIThru* pMIDIThru, MIDIIn* pMIDIIn);
+
+/* MIDI出力を追加し、その番号(0〜)を返す(失敗時-1) */
+/* 停止中のみ追加できる。MIDI出力はMIDIスルーオブジェクトより後に閉じること */
+long __stdcall MIDIThru_AddOutput (MIDIThru* pMIDIThru, MIDIOut* pMIDIOut);
+
+/* MIDI入力からMIDI出力への経路を追加し、その番号(0〜)を返す(失敗時-1) */
+/* 追加した経路はすべてのメッセージをそのまま通過させる。転送中でも追加できる */
+long __stdcall MIDIThru_AddRoute (MIDIThru* pMIDIThru, long lInIndex, long lOutIndex);
+
+/* 経路が通過させるチャンネルとシステムメッセージを設定する */
+long __stdcall MIDIThru_SetRouteFilter
+	(MIDIThru* pMIDIThru, long lRoute, long lChannelMask, long lSystemMask);
+
+/* 経路の移調量[半音]を設定する(移調後に0〜127を外れるノートは捨てる) */
+long __stdcall MIDIThru_SetRouteTranspose (MIDIThru* pMIDIThru, long lRoute, long lTranspose);
+
+/* 経路のベロシティ変換表(128バイト)を設定する(NULLの場合は変換しない) */
+/* ノートオンのベロシティvはpCurve[v]となる。ただし1以上のベロシティは1未満にしない */
+long __stdcall MIDIThru_SetRouteVelocityCurve
+	(MIDIThru* pMIDIThru, long lRoute, const unsigned char* pCurve);
+
+/* 経路の統計を取得する */
+long __stdcall MIDIThru_GetRouteStats
+	(MIDIThru* pMIDIThru, long lRoute, MIDIThruRouteStats* pStats);
+
+/* 転送を開始する(転送スレッドを起動する) */
+long __stdcall MIDIThru_Start (MIDIThru* pMIDIThru);
+
+/* 転送を停止する(転送スレッドの終了を待ち、発音中のノートにノートオフを送る) */
+long __stdcall MIDIThru_Stop (MIDIThru* pMIDIThru);
+
+/* 転送中か調べる */
+long __stdcall MIDIThru_IsRunning (MIDIThru* pMIDIThru);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,221 @@
+/******************************************************************************/
+/*                                                                            */
+/*  MIDIDataBench.c - SMF読み込み性能測定ツール            (C)2026 くず       */
+/*                                                                            */
+/******************************************************************************/
+
+/* このモジュールは普通のＣ言語で書かれている。 */
+/* このプログラムは、GNU 劣等一般公衆利用許諾契約書(LGPL)に基づき配布される。 */
+/* プロジェクトホームページ(仮)："http://openmidiproject.sourceforge.jp/index.html" */
+/* スタンダードMIDIファイル(指定したもの又は合成したもの)をMIDIData_LoadFromSMFMemoryExで */
+/* 繰り返し読み込み、緩い読み込みと厳密な読み込みの処理速度を測定する(20261019追加) */
+
+/* 基準値：範囲検査を加える前の読み込み処理(75aced1)と加えた後の読み込み処理(453400a)を */
+/* 同じ環境(Xeon 1コア・gcc 12.2 -O2)で測定した結果[MB/秒]。合成SMFは8回測定した中央値、 */
+/* 約44MB・320万イベントのSMFは3回測定した中央値であり、差はいずれも測定のばらつきの範囲内である。 */
+/*                          変更前(緩い/厳密)  変更後(緩い/厳密) */
+/*   合成SMF(約11MB)        19.7 / 20.5        19.7 / 20.7 */
+/*   約44MBのSMF            21.0 / 23.0        21.9 / 22.2 */
+/* 読み込み処理を変更した場合は、変更前後でこのツールを実行してこの表と比較すること。 */
+
+/* This library is free software; you can redistribute it and/or */
+/* modify it under the terms of the GNU Lesser General Public */
+/* License as published by the Free Software Foundation; either */
+/* version 2.1 of the License, or (at your option) any later version. */
+
+/* This library is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU */
+/* Lesser General Public License for more details. */
+
+/* You should have received a copy of the GNU Lesser General Public */
+/* License along with this library; if not, write to the Free Software */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+#include "MIDIData.h"
+
+/* 合成するSMFのトラック数と1トラックあたりのノート数 */
+#define MIDIDATABENCH_TRACKNUM 16
+#define MIDIDATABENCH_NOTENUM 100000
+
+/* 測定の繰り返し回数 */
+#define MIDIDATABENCH_REPEAT 5
+
+/* 経過時間の測定用に現在時刻[秒]を取得する */
+static double MIDIDataBench_GetSec () {
+	LARGE_INTEGER liFrequency;
+	LARGE_INTEGER liCount;
+	QueryPerformanceFrequency (&liFrequency);
+	QueryPerformanceCounter (&liCount);
+	return (double)liCount.QuadPart / (double)liFrequency.QuadPart;
+}
+
+/* 4バイトのビッグエンディアンで書き込む */
+static void MIDIDataBench_PutBig4 (unsigned char* p, unsigned long ulValue) {
+	p[0] = (unsigned char)(ulValue >> 24);
+	p[1] = (unsigned char)(ulValue >> 16);
+	p[2] = (unsigned char)(ulValue >> 8);
+	p[3] = (unsigned char)(ulValue);
+}
+
+/* フォーマット1のSMFを合成する。戻り値：SMFのデータ(失敗時NULL) */
+/* 各トラックはトラック名・コントロールチェンジの後、ランニングステータスの */
+/* ノートオン・ノートオフ(ベロシティ0)をMIDIDATABENCH_NOTENUM組並べ、EOTで終わる。 */
+static unsigned char* MIDIDataBench_Synthesize (long* pLen) {
+	long lMaxLen = 14 + MIDIDATABENCH_TRACKNUM * (8 + 16 + MIDIDATABENCH_NOTENUM * 9);
+	unsigned char* pData = (unsigned char*)malloc (lMaxLen);
+	unsigned char* p = pData;
+	unsigned char* pTrack = NULL;
+	unsigned char byKey;
+	long i, j;
+	if (pData == NULL) {
+		return NULL;
+	}
+	memcpy (p, "MThd", 4);
+	MIDIDataBench_PutBig4 (p + 4, 6);
+	p[8] = 0x00;
+	p[9] = 0x01;
+	p[10] = 0x00;
+	p[11] = (unsigned char)MIDIDATABENCH_TRACKNUM;
+	p[12] = 0x01;
+	p[13] = 0xE0;
+	p += 14;
+	for (i = 0; i < MIDIDATABENCH_TRACKNUM; i++) {
+		memcpy (p, "MTrk", 4);
+		p += 8;
+		pTrack = p;
+		/* トラック名 */
+		*p++ = 0x00; *p++ = 0xFF; *p++ = 0x03; *p++ = 0x02; *p++ = 'T'; *p++ = (unsigned char)('A' + i);
+		/* ボリューム */
+		*p++ = 0x00; *p++ = (unsigned char)(0xB0 | i); *p++ = 0x07; *p++ = 0x64;
+		/* ノートオン・ノートオフ(最初のノートオン以外はランニングステータス) */
+		*p++ = 0x00; *p++ = (unsigned char)(0x90 | i);
+		for (j = 0; j < MIDIDATABENCH_NOTENUM; j++) {
+			byKey = (unsigned char)(36 + (j * 7 + i) % 60);
+			if (j > 0) {
+				*p++ = 0x00;
+			}
+			*p++ = byKey;
+			*p++ = (unsigned char)(1 + j % 127);
+			*p++ = 0x81;
+			*p++ = 0x70;
+			*p++ = byKey;
+			*p++ = 0x00;
+		}
+		/* EOT */
+		*p++ = 0x00; *p++ = 0xFF; *p++ = 0x2F; *p++ = 0x00;
+		MIDIDataBench_PutBig4 (pTrack - 4, (unsigned long)(p - pTrack));
+	}
+	*pLen = (long)(p - pData);
+	return pData;
+}
+
+/* ファイルの内容をすべて読み込む。戻り値：読み込んだデータ(失敗時NULL) */
+static unsigned char* MIDIDataBench_LoadFile (const char* pszFileName, long* pLen) {
+	FILE* pFile = NULL;
+	unsigned char* pData = NULL;
+	long lLen = 0;
+	fopen_s (&pFile, pszFileName, "rb");
+	if (pFile == NULL) {
+		return NULL;
+	}
+	fseek (pFile, 0, SEEK_END);
+	lLen = ftell (pFile);
+	fseek (pFile, 0, SEEK_SET);
+	if (lLen > 0) {
+		pData = (unsigned char*)malloc (lLen);
+	}
+	if (pData == NULL || (long)fread (pData, 1, lLen, pFile) != lLen) {
+		free (pData);
+		fclose (pFile);
+		return NULL;
+	}
+	fclose (pFile);
+	*pLen = lLen;
+	return pData;
+}
+
+/* 読み込みオプションlLoadFlagsでMIDIDATABENCH_REPEAT回読み込み、最も速かった回の時間[秒]を返す */
+/* (失敗時は負の値を返す)。*pEventNumには全トラックのイベント数の合計を格納する。 */
+static double MIDIDataBench_Measure (const unsigned char* pData, long lLen, long lLoadFlags,
+	long* pEventNum) {
+	MIDIDataContext* pContext = NULL;
+	MIDIData* pMIDIData = NULL;
+	MIDITrack* pMIDITrack = NULL;
+	double dStart, dSec;
+	double dBest = -1.0;
+	long i;
+	pContext = MIDIDataContext_Create ();
+	if (pContext == NULL) {
+		return -1.0;
+	}
+	/* 読み込み後の自動設定は読み込みそのものの速度と関係ないので省く */
+	MIDIDataContext_SetLoadFlags (pContext, lLoadFlags | MIDIDATACONTEXT_NOAUTOSETTING);
+	for (i = 0; i < MIDIDATABENCH_REPEAT; i++) {
+		dStart = MIDIDataBench_GetSec ();
+		pMIDIData = MIDIData_LoadFromSMFMemoryEx (pData, lLen, pContext);
+		dSec = MIDIDataBench_GetSec () - dStart;
+		if (pMIDIData == NULL) {
+			MIDIDataContext_Delete (pContext);
+			return -1.0;
+		}
+		*pEventNum = 0;
+		forEachTrack (pMIDIData, pMIDITrack) {
+			*pEventNum += MIDITrack_GetNumEvent (pMIDITrack);
+		}
+		MIDIData_Delete (pMIDIData);
+		if (dBest < 0.0 || dSec < dBest) {
+			dBest = dSec;
+		}
+	}
+	MIDIDataContext_Delete (pContext);
+	return dBest > 0.0 ? dBest : 1e-9;
+}
+
+/* 使い方：mididatabench [SMF] */
+/* ファイルを省略した場合は、MIDIDATABENCH_TRACKNUMトラックのSMFを合成して測定する。 */
+int main (int argc, char* argv[]) {
+	unsigned char* pData = NULL;
+	long lLen = 0;
+	long lEventNum = 0;
+	double dLoose, dStrict;
+
+	if (argc >= 2) {
+		pData = MIDIDataBench_LoadFile (argv[1], &lLen);
+		if (pData == NULL) {
+			fprintf (stderr, "ファイルを読み込めません：%s\n", argv[1]);
+			return 1;
+		}
+	}
+	else {
+		pData = MIDIDataBench_Synthesize (&lLen);
+		if (pData == NULL) {
+			fprintf (stderr, "メモリが不足しています。\n");
+			return 1;
+		}
+	}
+
+	dLoose = MIDIDataBench_Measure (pData, lLen, 0, &lEventNum);
+	dStrict = MIDIDataBench_Measure (pData, lLen, MIDIDATACONTEXT_STRICT, &lEventNum);
+	if (dLoose < 0.0) {
+		fprintf (stderr, "読み込みに失敗しました。\n");
+		free (pData);
+		return 1;
+	}
+	printf ("%ld バイト, %ld イベント\n", lLen, lEventNum);
+	printf ("緩い読み込み   : %8.1f MB/秒  %8.2f Mイベント/秒\n",
+		lLen / dLoose / (1024.0 * 1024.0), lEventNum / dLoose / 1e6);
+	if (dStrict < 0.0) {
+		printf ("厳密な読み込み : 失敗(不正なデータを含む)\n");
+	}
+	else {
+		printf ("厳密な読み込み : %8.1f MB/秒  %8.2f Mイベント/秒\n",
+			lLen / dStrict / (1024.0 * 1024.0), lEventNum / dStrict / 1e6);
+	}
+	free (pData);
+	return 0;
+}
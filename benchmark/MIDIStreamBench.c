@@ -0,0 +1,216 @@
+/******************************************************************************/
+/*                                                                            */
+/*  MIDIStreamBench.c - MIDIStream_Split性能測定ツール     (C)2026 くず       */
+/*                                                                            */
+/******************************************************************************/
+
+/* このモジュールは普通のＣ言語で書かれている。 */
+/* このプログラムは、GNU 劣等一般公衆利用許諾契約書(LGPL)に基づき配布される。 */
+/* プロジェクトホームページ(仮)："http://openmidiproject.sourceforge.jp/index.html" */
+/* 生のMIDIバイト列(ダンプファイル又は合成したもの)について、MIDIStream_Splitによる切り出しと */
+/* "Null"デバイスへのMIDIOut_PutBytesの処理速度を測定する(20261019追加) */
+
+/* This library is free software; you can redistribute it and/or */
+/* modify it under the terms of the GNU Lesser General Public */
+/* License as published by the Free Software Foundation; either */
+/* version 2.1 of the License, or (at your option) any later version. */
+
+/* This library is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU */
+/* Lesser General Public License for more details. */
+
+/* You should have received a copy of the GNU Lesser General Public */
+/* License along with this library; if not, write to the Free Software */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+#include "MIDIIO.h"
+
+/* 合成するバイト列の大きさ[バイト] */
+#define MIDISTREAMBENCH_SYNTHSIZE (8 * 1024 * 1024)
+
+/* MIDIOut_PutBytesに一度に渡す大きさ[バイト](ドライバから届く程度の断片を想定) */
+#define MIDISTREAMBENCH_CHUNKSIZE 4096
+
+/* 測定の繰り返し回数 */
+#define MIDISTREAMBENCH_REPEAT 5
+
+/* 経過時間の測定用に現在時刻[秒]を取得する */
+static double MIDIStreamBench_GetSec () {
+	LARGE_INTEGER liFrequency;
+	LARGE_INTEGER liCount;
+	QueryPerformanceFrequency (&liFrequency);
+	QueryPerformanceCounter (&liCount);
+	return (double)liCount.QuadPart / (double)liFrequency.QuadPart;
+}
+
+/* 演奏データらしいバイト列を合成する */
+/* (ランニングステータスのノートオン・オフ、コントロールチェンジ、プログラムチェンジ、 */
+/* ピッチベンド、タイミングクロック、時々200〜2000バイトのSYSXを含む) */
+static unsigned char* MIDIStreamBench_Synthesize (long lLen) {
+	unsigned char* pData = (unsigned char*)malloc (lLen);
+	unsigned long ulSeed = 1;
+	long lPosition = 0;
+	long lSysxLen, i;
+	unsigned char cStatus = 0;
+	if (pData == NULL) {
+		return NULL;
+	}
+	while (lPosition + 2048 < lLen) {
+		ulSeed = ulSeed * 1103515245 + 12345;
+		switch ((ulSeed >> 16) % 64) {
+		case 0:
+			pData[lPosition++] = 0xF0;
+			lSysxLen = 200 + (long)((ulSeed >> 8) % 1800);
+			for (i = 0; i < lSysxLen; i++) {
+				pData[lPosition++] = (unsigned char)((i * 7 + ulSeed) & 0x7F);
+			}
+			pData[lPosition++] = 0xF7;
+			cStatus = 0;
+			break;
+		case 1: case 2: case 3:
+			pData[lPosition++] = 0xF8;
+			break;
+		case 4: case 5:
+			pData[lPosition++] = cStatus = (unsigned char)(0xB0 | (ulSeed & 0x0F));
+			pData[lPosition++] = (unsigned char)((ulSeed >> 4) & 0x7F);
+			pData[lPosition++] = (unsigned char)((ulSeed >> 11) & 0x7F);
+			break;
+		case 6:
+			pData[lPosition++] = cStatus = (unsigned char)(0xC0 | (ulSeed & 0x0F));
+			pData[lPosition++] = (unsigned char)((ulSeed >> 4) & 0x7F);
+			break;
+		case 7: case 8:
+			pData[lPosition++] = cStatus = (unsigned char)(0xE0 | (ulSeed & 0x0F));
+			pData[lPosition++] = (unsigned char)((ulSeed >> 4) & 0x7F);
+			pData[lPosition++] = (unsigned char)((ulSeed >> 11) & 0x7F);
+			break;
+		default:
+			/* 半分はランニングステータスで省略する */
+			if ((cStatus & 0xE0) != 0x80 || (ulSeed & 0x100)) {
+				pData[lPosition++] = cStatus = (unsigned char)(0x90 | (ulSeed & 0x0F));
+			}
+			pData[lPosition++] = (unsigned char)((ulSeed >> 4) & 0x7F);
+			pData[lPosition++] = (unsigned char)((ulSeed >> 11) & 0x7F);
+			break;
+		}
+	}
+	memset (pData + lPosition, 0xF8, lLen - lPosition);
+	return pData;
+}
+
+/* ファイルの内容をすべて読み込む。戻り値：読み込んだデータ(失敗時NULL) */
+static unsigned char* MIDIStreamBench_LoadFile (const char* pszFileName, long* pLen) {
+	FILE* pFile = NULL;
+	unsigned char* pData = NULL;
+	long lLen = 0;
+	fopen_s (&pFile, pszFileName, "rb");
+	if (pFile == NULL) {
+		return NULL;
+	}
+	fseek (pFile, 0, SEEK_END);
+	lLen = ftell (pFile);
+	fseek (pFile, 0, SEEK_SET);
+	if (lLen > 0) {
+		pData = (unsigned char*)malloc (lLen);
+	}
+	if (pData == NULL || (long)fread (pData, 1, lLen, pFile) != lLen) {
+		free (pData);
+		fclose (pFile);
+		return NULL;
+	}
+	fclose (pFile);
+	*pLen = lLen;
+	return pData;
+}
+
+/* MIDIStream_Splitで全体を切り出す。戻り値：切り出したMIDIメッセージの数 */
+static long MIDIStreamBench_Split (const unsigned char* pData, long lLen) {
+	unsigned char cRunningStatus = 0;
+	long lPosition = 0;
+	long lOffset, lMessageLen;
+	long lNum = 0;
+	while (lPosition < lLen) {
+		lPosition += MIDIStream_Split
+			(pData + lPosition, lLen - lPosition, &cRunningStatus, &lOffset, &lMessageLen);
+		if (lMessageLen > 0) {
+			lNum++;
+		}
+	}
+	return lNum;
+}
+
+/* 全体をMIDISTREAMBENCH_CHUNKSIZEずつMIDIOut_PutBytesに渡す */
+static void MIDIStreamBench_PutBytes (MIDIOut* pMIDIOut, unsigned char* pData, long lLen) {
+	long lPosition = 0;
+	long lChunkLen;
+	while (lPosition < lLen) {
+		lChunkLen = lLen - lPosition < MIDISTREAMBENCH_CHUNKSIZE ?
+			lLen - lPosition : MIDISTREAMBENCH_CHUNKSIZE;
+		MIDIOut_PutBytes (pMIDIOut, pData + lPosition, lChunkLen);
+		lPosition += lChunkLen;
+	}
+}
+
+/* 使い方：midistreambench [生のMIDIバイト列のファイル] */
+/* ファイルを省略した場合はMIDISTREAMBENCH_SYNTHSIZEバイトのバイト列を合成して測定する。 */
+int main (int argc, char* argv[]) {
+	unsigned char* pData = NULL;
+	long lLen = MIDISTREAMBENCH_SYNTHSIZE;
+	long lNum = 0;
+	MIDIOut* pMIDIOut = NULL;
+	double dStart, dSec, dBestSplit = 0.0, dBestPut = 0.0;
+	long i;
+
+	if (argc >= 2) {
+		pData = MIDIStreamBench_LoadFile (argv[1], &lLen);
+		if (pData == NULL) {
+			fprintf (stderr, "ファイルを読み込めません：%s\n", argv[1]);
+			return 1;
+		}
+	}
+	else {
+		pData = MIDIStreamBench_Synthesize (lLen);
+		if (pData == NULL) {
+			fprintf (stderr, "メモリが不足しています。\n");
+			return 1;
+		}
+	}
+	pMIDIOut = MIDIOut_OpenA (MIDIIO_NULL);
+	if (pMIDIOut == NULL) {
+		fprintf (stderr, "MIDI出力デバイス「%s」を開けません。\n", MIDIIO_NULL);
+		free (pData);
+		return 1;
+	}
+
+	/* 各測定は最も速かった回を採る */
+	for (i = 0; i < MIDISTREAMBENCH_REPEAT; i++) {
+		dStart = MIDIStreamBench_GetSec ();
+		lNum = MIDIStreamBench_Split (pData, lLen);
+		dSec = MIDIStreamBench_GetSec () - dStart;
+		if (i == 0 || dSec < dBestSplit) {
+			dBestSplit = dSec;
+		}
+		dStart = MIDIStreamBench_GetSec ();
+		MIDIStreamBench_PutBytes (pMIDIOut, pData, lLen);
+		dSec = MIDIStreamBench_GetSec () - dStart;
+		if (i == 0 || dSec < dBestPut) {
+			dBestPut = dSec;
+		}
+	}
+	dBestSplit = dBestSplit > 0.0 ? dBestSplit : 1e-9;
+	dBestPut = dBestPut > 0.0 ? dBestPut : 1e-9;
+	printf ("%ld バイト, %ld メッセージ\n", lLen, lNum);
+	printf ("MIDIStream_Split : %8.1f MB/秒  %8.2f Mメッセージ/秒\n",
+		lLen / dBestSplit / (1024.0 * 1024.0), lNum / dBestSplit / 1e6);
+	printf ("MIDIOut_PutBytes : %8.1f MB/秒  %8.2f Mメッセージ/秒\n",
+		lLen / dBestPut / (1024.0 * 1024.0), lNum / dBestPut / 1e6);
+
+	MIDIOut_Close (pMIDIOut);
+	free (pData);
+	return 0;
+}
@@ -0,0 +1,338 @@
+/******************************************************************************/
+/*                                                                            */
+/*  MIDIDataFuzz.c - SMF読み込みのファジング・回帰試験     (C)2026 くず       */
+/*                                                                            */
+/******************************************************************************/
+
+/* このモジュールは普通のＣ言語で書かれている。 */
+/* このプログラムは、GNU 劣等一般公衆利用許諾契約書(LGPL)に基づき配布される。 */
+/* プロジェクトホームページ(仮)："http://openmidiproject.sourceforge.jp/index.html" */
+/* 不正なスタンダードMIDIファイルをMIDIData_LoadFromSMFMemoryExに読み込ませ、 */
+/* チャンクの外を読まないこと・落ちないことを確かめる(20261019追加) */
+/* AddressSanitizerを有効にしてビルドすること。データは丁度の大きさでmallocした */
+/* メモリに複写してから渡すので、1バイトでもはみ出して読めば検出される。 */
+
+/* 使い方： */
+/* mididatafuzz                         回帰試験のみ行う */
+/* mididatafuzz 回数 種 SMF...           回帰試験の後、SMFを変異させて指定回数読み込ませる */
+/* MIDIDATAFUZZ_LIBFUZZERを定義してlibFuzzerとリンクした場合は、 */
+/* LLVMFuzzerTestOneInputのみを提供する(-fsanitize=fuzzer,address)。 */
+
+/* This library is free software; you can redistribute it and/or */
+/* modify it under the terms of the GNU Lesser General Public */
+/* License as published by the Free Software Foundation; either */
+/* version 2.1 of the License, or (at your option) any later version. */
+
+/* This library is distributed in the hope that it will be useful, */
+/* but WITHOUT ANY WARRANTY; without even the implied warranty of */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU */
+/* Lesser General Public License for more details. */
+
+/* You should have received a copy of the GNU Lesser General Public */
+/* License along with this library; if not, write to the Free Software */
+/* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "MIDIData.h"
+
+/* 変異させるSMFの最大長[バイト] */
+#define MIDIDATAFUZZ_MAXLEN 200000
+
+/* 解釈した結果の集計先(最適化で読み飛ばされないようにする) */
+static volatile long g_lMIDIDataFuzzSum = 0;
+
+/* 変異させたSMFを丁度の大きさのメモリに複写して読み込ませる。戻り値：読み込めた=1、失敗=0 */
+/* 読み込めた場合は全イベントをたどり、解釈した結果にも触れておく。 */
+static long MIDIDataFuzz_Load (const unsigned char* pData, long lLen, long lLoadFlags) {
+	MIDIDataContext* pContext = NULL;
+	MIDIData* pMIDIData = NULL;
+	MIDITrack* pMIDITrack = NULL;
+	MIDIEvent* pMIDIEvent = NULL;
+	unsigned char* pCopy = (unsigned char*)malloc (lLen > 0 ? lLen : 1);
+	if (pCopy == NULL) {
+		return 0;
+	}
+	memcpy (pCopy, pData, lLen);
+	pContext = MIDIDataContext_Create ();
+	if (pContext == NULL) {
+		free (pCopy);
+		return 0;
+	}
+	MIDIDataContext_SetLoadFlags (pContext, lLoadFlags);
+	pMIDIData = MIDIData_LoadFromSMFMemoryEx (pCopy, lLen, pContext);
+	if (pMIDIData) {
+		forEachTrack (pMIDIData, pMIDITrack) {
+			forEachEvent (pMIDITrack, pMIDIEvent) {
+				g_lMIDIDataFuzzSum += MIDIEvent_GetKind (pMIDIEvent) + MIDIEvent_GetLen (pMIDIEvent);
+			}
+		}
+		MIDIData_Delete (pMIDIData);
+	}
+	MIDIDataContext_Delete (pContext);
+	free (pCopy);
+	return pMIDIData ? 1 : 0;
+}
+
+#ifdef MIDIDATAFUZZ_LIBFUZZER
+
+/* libFuzzerの入口 */
+int LLVMFuzzerTestOneInput (const uint8_t* pData, size_t lLen) {
+	if (lLen > MIDIDATAFUZZ_MAXLEN) {
+		return 0;
+	}
+	MIDIDataFuzz_Load (pData, (long)lLen, 0);
+	MIDIDataFuzz_Load (pData, (long)lLen, MIDIDATACONTEXT_STRICT);
+	return 0;
+}
+
+#else
+
+/* 回帰試験の1項目 */
+/* トラックが1つのSMF(フォーマット0、480ティック/4分音符)のトラックデータと、 */
+/* MTrkチャンクに書く長さ(-1=実際の長さ、それ以外の負の値はそのまま書く)、緩い読み込みと厳密な読み込みの期待する結果を持つ */
+typedef struct tagMIDIDataFuzzCase {
+	const char* m_pszName;
+	const unsigned char* m_pTrackData;
+	long m_lTrackLen;
+	long m_lChunkLen;
+	long m_lLooseResult;
+	long m_lStrictResult;
+} MIDIDataFuzzCase;
+
+/* 正常なトラック(EOTのみ) */
+static const unsigned char g_byEOTOnly[] = {0x00, 0xFF, 0x2F, 0x00};
+
+/* デルタタイムの可変長数値がチャンクの末尾で途切れている */
+static const unsigned char g_byTruncatedVLQ[] = {0x00, 0x90, 0x3C, 0x40, 0x81, 0x80};
+
+/* 可変長数値だけのトラック(継続ビットが立ったまま終わる) */
+static const unsigned char g_byVLQOnly[] = {0xFF, 0xFF, 0xFF, 0xFF};
+
+/* メタイベントの長さがチャンクの末尾を越える */
+static const unsigned char g_byMetaPastEnd[] = {0x00, 0xFF, 0x01, 0x7F, 0x41, 0x42};
+
+/* メタイベントの長さの可変長数値が途切れている */
+static const unsigned char g_byMetaLenTruncated[] = {0x00, 0xFF, 0x01, 0x81};
+
+/* SYSXの長さがチャンクの末尾を越える */
+static const unsigned char g_bySysxPastEnd[] = {0x00, 0xF0, 0x7F, 0x01, 0x02};
+
+/* MIDIイベントのデータバイトが途切れている */
+static const unsigned char g_byNoteTruncated[] = {0x00, 0x90, 0x3C};
+
+/* ステータスが一度も現れないうちのランニングステータス */
+static const unsigned char g_byNoStatus[] = {0x00, 0x3C, 0x40, 0x00, 0xFF, 0x2F, 0x00};
+
+/* SMFに現れないステータス(0xF8)と種類が0x80以上のメタイベント */
+static const unsigned char g_byBadStatus[] =
+	{0x00, 0xF8, 0x00, 0xFF, 0x90, 0x01, 0x00, 0x00, 0xFF, 0x2F, 0x00};
+
+/* 回帰試験の一覧 */
+static const MIDIDataFuzzCase g_theMIDIDataFuzzCase[] = {
+	{"EOTのみ", g_byEOTOnly, sizeof (g_byEOTOnly), -1, 1, 1},
+	{"デルタタイムの途切れ", g_byTruncatedVLQ, sizeof (g_byTruncatedVLQ), -1, 1, 0},
+	{"可変長数値のみ", g_byVLQOnly, sizeof (g_byVLQOnly), -1, 1, 0},
+	{"メタイベントの長さ超過", g_byMetaPastEnd, sizeof (g_byMetaPastEnd), -1, 1, 0},
+	{"メタイベントの長さの途切れ", g_byMetaLenTruncated, sizeof (g_byMetaLenTruncated), -1, 1, 0},
+	{"SYSXの長さ超過", g_bySysxPastEnd, sizeof (g_bySysxPastEnd), -1, 1, 0},
+	{"ノートの途切れ", g_byNoteTruncated, sizeof (g_byNoteTruncated), -1, 1, 0},
+	{"ステータスなし", g_byNoStatus, sizeof (g_byNoStatus), -1, 1, 0},
+	{"不正なステータス", g_byBadStatus, sizeof (g_byBadStatus), -1, 1, 0},
+	{"チャンク長がファイルを越える", g_byEOTOnly, sizeof (g_byEOTOnly), 0x7FFFFFF0, 0, 0},
+	{"チャンク長が1バイト超過", g_byEOTOnly, sizeof (g_byEOTOnly), sizeof (g_byEOTOnly) + 1, 0, 0},
+	{"チャンク長が負", g_byEOTOnly, sizeof (g_byEOTOnly), -2, 0, 0},
+	{"チャンク長が0", g_byEOTOnly, 0, -1, 1, 0}
+};
+
+/* ヘッダーチャンクとトラックチャンク1つからなるSMFを組み立てる。戻り値：SMFの長さ */
+/* lChunkLenが-1の場合はMTrkチャンクの長さに実際のトラックデータの長さを書く。 */
+static long MIDIDataFuzz_MakeSMF (unsigned char* pBuf, const unsigned char* pTrackData,
+	long lTrackLen, long lChunkLen) {
+	static const unsigned char byHeader[] =
+		{'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00, 0x01, 0x01, 0xE0,
+		'M', 'T', 'r', 'k'};
+	unsigned long ulChunkLen = (unsigned long)(lChunkLen == -1 ? lTrackLen : lChunkLen);
+	memcpy (pBuf, byHeader, sizeof (byHeader));
+	pBuf[18] = (unsigned char)(ulChunkLen >> 24);
+	pBuf[19] = (unsigned char)(ulChunkLen >> 16);
+	pBuf[20] = (unsigned char)(ulChunkLen >> 8);
+	pBuf[21] = (unsigned char)(ulChunkLen);
+	memcpy (pBuf + 22, pTrackData, lTrackLen);
+	return 22 + lTrackLen;
+}
+
+/* 回帰試験を行う。戻り値：期待と異なった項目の数 */
+static long MIDIDataFuzz_RunCases () {
+	unsigned char byBuf[256];
+	const MIDIDataFuzzCase* pCase = NULL;
+	long lNumCase = sizeof (g_theMIDIDataFuzzCase) / sizeof (g_theMIDIDataFuzzCase[0]);
+	long lLen, lLoose, lStrict, i;
+	long lFailed = 0;
+	for (i = 0; i < lNumCase; i++) {
+		pCase = &g_theMIDIDataFuzzCase[i];
+		lLen = MIDIDataFuzz_MakeSMF (byBuf, pCase->m_pTrackData, pCase->m_lTrackLen, pCase->m_lChunkLen);
+		lLoose = MIDIDataFuzz_Load (byBuf, lLen, 0);
+		lStrict = MIDIDataFuzz_Load (byBuf, lLen, MIDIDATACONTEXT_STRICT);
+		if (lLoose != pCase->m_lLooseResult || lStrict != pCase->m_lStrictResult) {
+			printf ("失敗：%s (緩い読み込み=%ld 期待=%ld、厳密な読み込み=%ld 期待=%ld)\n", pCase->m_pszName,
+				lLoose, pCase->m_lLooseResult, lStrict, pCase->m_lStrictResult);
+			lFailed++;
+		}
+	}
+	/* トラックチャンクのヘッダーまでに途切れたファイル */
+	/* (ヘッダーチャンクが揃っていれば、緩い読み込みは欠けたトラックを許す) */
+	for (i = 0; i < 22; i++) {
+		if (MIDIDataFuzz_Load (byBuf, i, 0) != (i >= 14 ? 1 : 0) ||
+			MIDIDataFuzz_Load (byBuf, i, MIDIDATACONTEXT_STRICT) != 0) {
+			printf ("失敗：%ldバイトで途切れたファイル\n", i);
+			lFailed++;
+		}
+	}
+	printf ("回帰試験：%ld項目中%ld項目失敗\n", lNumCase + 22, lFailed);
+	return lFailed;
+}
+
+/* 乱数(線形合同法) */
+static unsigned long MIDIDataFuzz_Rand (unsigned long* pSeed) {
+	*pSeed = *pSeed * 1103515245UL + 12345UL;
+	return (*pSeed >> 16) & 0x7FFF;
+}
+
+/* ファイルの内容をすべて読み込む。戻り値：読み込んだデータ(失敗時NULL) */
+static unsigned char* MIDIDataFuzz_LoadFile (const char* pszFileName, long* pLen) {
+	FILE* pFile = NULL;
+	unsigned char* pData = NULL;
+	long lLen = 0;
+	pFile = fopen (pszFileName, "rb");
+	if (pFile == NULL) {
+		return NULL;
+	}
+	fseek (pFile, 0, SEEK_END);
+	lLen = ftell (pFile);
+	fseek (pFile, 0, SEEK_SET);
+	if (lLen > MIDIDATAFUZZ_MAXLEN) {
+		lLen = MIDIDATAFUZZ_MAXLEN;
+	}
+	pData = (unsigned char*)malloc (lLen > 0 ? lLen : 1);
+	if (pData == NULL || (long)fread (pData, 1, lLen, pFile) != lLen) {
+		free (pData);
+		fclose (pFile);
+		return NULL;
+	}
+	fclose (pFile);
+	*pLen = lLen;
+	return pData;
+}
+
+/* pDataを1〜8か所変異させる。戻り値：変異後の長さ */
+/* (ビット反転、特別なバイトの上書き、切り詰め、0xFFの上書き、削除、MTrkチャンク長の改竄) */
+static long MIDIDataFuzz_Mutate (unsigned char* pData, long lLen, unsigned long* pSeed) {
+	static const unsigned char bySpecial[] = {0x80, 0xFF, 0xF0, 0xF7, 0x7F, 0x00, 0x2F, 0xFE};
+	unsigned long ulChunkLen;
+	long lNum = 1 + MIDIDataFuzz_Rand (pSeed) % 8;
+	long lPosition, lCount, i;
+	for (i = 0; i < lNum && lLen > 0; i++) {
+		lPosition = MIDIDataFuzz_Rand (pSeed) * 32768 + MIDIDataFuzz_Rand (pSeed);
+		lPosition %= lLen;
+		switch (MIDIDataFuzz_Rand (pSeed) % 6) {
+		case 0:
+			pData[lPosition] ^= (unsigned char)(1 << (MIDIDataFuzz_Rand (pSeed) % 8));
+			break;
+		case 1:
+			pData[lPosition] = bySpecial[MIDIDataFuzz_Rand (pSeed) % sizeof (bySpecial)];
+			break;
+		case 2:
+			lLen = lPosition + 1;
+			break;
+		case 3:
+			lCount = MIDIDataFuzz_Rand (pSeed) % 8;
+			if (lPosition + lCount <= lLen) {
+				memset (pData + lPosition, 0xFF, lCount);
+			}
+			break;
+		case 4:
+			lCount = 1 + MIDIDataFuzz_Rand (pSeed) % 4;
+			if (lPosition + lCount < lLen) {
+				memmove (pData + lPosition, pData + lPosition + lCount, lLen - lPosition - lCount);
+				lLen -= lCount;
+			}
+			break;
+		case 5:
+			if (lLen >= 22) {
+				ulChunkLen = MIDIDataFuzz_Rand (pSeed) % 3 == 0 ? 0x7FFFFFF0UL :
+					(unsigned long)(MIDIDataFuzz_Rand (pSeed) % lLen);
+				pData[18] = (unsigned char)(ulChunkLen >> 24);
+				pData[19] = (unsigned char)(ulChunkLen >> 16);
+				pData[20] = (unsigned char)(ulChunkLen >> 8);
+				pData[21] = (unsigned char)(ulChunkLen);
+			}
+			break;
+		}
+	}
+	return lLen;
+}
+
+int main (int argc, char* argv[]) {
+	unsigned char** pSeedData = NULL;
+	long* pSeedLen = NULL;
+	unsigned char* pBuf = NULL;
+	unsigned long ulSeed = 1;
+	long lIteration = 0;
+	long lNumSeed = 0;
+	long lNumLoaded = 0;
+	long lLen, k, i;
+	long lRet = 0;
+
+	/* 回帰試験 */
+	if (MIDIDataFuzz_RunCases () > 0) {
+		return 1;
+	}
+	if (argc < 4) {
+		return 0;
+	}
+
+	/* 変異による試験 */
+	lIteration = atol (argv[1]);
+	ulSeed = (unsigned long)atol (argv[2]);
+	lNumSeed = argc - 3;
+	pSeedData = (unsigned char**)calloc (lNumSeed, sizeof (unsigned char*));
+	pSeedLen = (long*)calloc (lNumSeed, sizeof (long));
+	pBuf = (unsigned char*)malloc (MIDIDATAFUZZ_MAXLEN);
+	if (pSeedData == NULL || pSeedLen == NULL || pBuf == NULL) {
+		fprintf (stderr, "メモリが不足しています。\n");
+		lRet = 1;
+		goto exit;
+	}
+	for (k = 0; k < lNumSeed; k++) {
+		pSeedData[k] = MIDIDataFuzz_LoadFile (argv[3 + k], &pSeedLen[k]);
+		if (pSeedData[k] == NULL) {
+			fprintf (stderr, "ファイルを読み込めません：%s\n", argv[3 + k]);
+			lRet = 1;
+			goto exit;
+		}
+	}
+	for (i = 0; i < lIteration; i++) {
+		k = MIDIDataFuzz_Rand (&ulSeed) % lNumSeed;
+		memcpy (pBuf, pSeedData[k], pSeedLen[k]);
+		lLen = MIDIDataFuzz_Mutate (pBuf, pSeedLen[k], &ulSeed);
+		lNumLoaded += MIDIDataFuzz_Load (pBuf, lLen, 0);
+		lNumLoaded += MIDIDataFuzz_Load (pBuf, lLen, MIDIDATACONTEXT_STRICT);
+	}
+	printf ("変異による試験：%ld回中%ld回読み込み成功\n", lIteration * 2, lNumLoaded);
+
+	exit:
+	if (pSeedData) {
+		for (k = 0; k < lNumSeed; k++) {
+			free (pSeedData[k]);
+		}
+	}
+	free (pSeedData);
+	free (pSeedLen);
+	free (pBuf);
+	return lRet;
+}
+
+#endif